@@ -13,5 +13,6 @@ enum class MatrixMatrixMultiplyImplementation : int
 {
     SimpleForLoops = (int)ell::nodes::MatrixMatrixMultiplyImplementation::SimpleForLoops,
     Mlas_Loopnest_Value = (int)ell::nodes::MatrixMatrixMultiplyImplementation::Mlas_Loopnest_Value,
+    Packed_Loopnest_Value = (int)ell::nodes::MatrixMatrixMultiplyImplementation::Packed_Loopnest_Value,
     ImplementationCount = (int)ell::nodes::MatrixMatrixMultiplyImplementation::LAST
 };
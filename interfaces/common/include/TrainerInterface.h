@@ -70,6 +70,12 @@ struct ProtoNNTrainerParameters
 
     ///<summary>Whether to output diagnostic messages during the training process</summary>
     bool verbose = false;
+
+    ///<summary>The number of threads to compute kernels and gradients on (zero means one per hardware thread)</summary>
+    size_t numThreads = 1;
+
+    ///<summary>The number of examples in each stochastic gradient step (zero means full-batch gradient steps)</summary>
+    size_t batchSize = 256;
 };
 
 class ProtoNNPredictor
@@ -12,10 +12,12 @@
 class MatrixMatrixMultiplyImplementation:
     SimpleForLoops = MatrixMatrixMultiplyImplementation_SimpleForLoops
     Mlas_Loopnest_Value = MatrixMatrixMultiplyImplementation_Mlas_Loopnest_Value
+    Packed_Loopnest_Value = MatrixMatrixMultiplyImplementation_Packed_Loopnest_Value
     ImplementationCount = MatrixMatrixMultiplyImplementation_ImplementationCount
 
 del MatrixMatrixMultiplyImplementation_SimpleForLoops
 del MatrixMatrixMultiplyImplementation_Mlas_Loopnest_Value
+del MatrixMatrixMultiplyImplementation_Packed_Loopnest_Value
 del MatrixMatrixMultiplyImplementation_ImplementationCount
 
 # Python friendly class for PortType
@@ -108,7 +108,9 @@ ProtoNNTrainer::ProtoNNTrainer(const ProtoNNTrainerParameters& parameters) :
         static_cast<trainers::ProtoNNLossFunction>(parameters.lossFunction),
         parameters.numIterations,
         parameters.numInnerIterations,
-        parameters.verbose
+        parameters.verbose,
+        parameters.numThreads,
+        parameters.batchSize
     };
 
     if (parameters.numLabels == 0)
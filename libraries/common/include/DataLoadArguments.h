@@ -33,6 +33,9 @@ namespace common
         /// <summary> The number of elements in an input data vector. </summary>
         std::string dataDimension = "";
 
+        /// <summary> The number of threads that parse a text data file, zero means one per hardware thread. </summary>
+        size_t numParsingThreads = 1;
+
         // not exposed on the command line
         size_t parsedDataDimension = 0;
     };
@@ -55,8 +58,9 @@ namespace common
         , public utilities::ParsedArgSet
     {
         /// <summary> Constructor with default option names. </summary>
-        /// By default, the data filename option is "inputDataFilename" (with short option "idf"), and the
-        /// data dimension option is "dataDimension" (with short option "dd")
+        /// By default, the data filename option is "inputDataFilename" (with short option "idf"), the
+        /// data dimension option is "dataDimension" (with short option "dd"), and the number of parsing
+        /// threads option is "numParsingThreads" (with short option "npt")
         ParsedDataLoadArguments() = default;
 
         /// <summary> Constructor with custom option names. </summary>
@@ -64,7 +68,8 @@ namespace common
         /// <param name=filenameOption> The command-line option string for the filename. </param>
         /// <param name=directoryOption> The command-line option string for the directory. </param>
         /// <param name=dimensionOption> The command-line option string for the data dimension. </param>
-        ParsedDataLoadArguments(std::optional<OptionName> filenameOption, std::optional<OptionName> directoryOption, std::optional<OptionName> dimensionOption);
+        /// <param name=numParsingThreadsOption> The command-line option string for the number of parsing threads. </param>
+        ParsedDataLoadArguments(std::optional<OptionName> filenameOption, std::optional<OptionName> directoryOption, std::optional<OptionName> dimensionOption, std::optional<OptionName> numParsingThreadsOption = std::nullopt);
 
         /// <summary> Adds the arguments to the command line parser. </summary>
         ///
@@ -85,6 +90,8 @@ namespace common
         std::string _shortDirectoryOptionString = "idd";
         std::string _dimensionOptionString = "dataDimension";
         std::string _shortDimensionOptionString = "dd";
+        std::string _numParsingThreadsOptionString = "numParsingThreads";
+        std::string _shortNumParsingThreadsOptionString = "npt";
     };
 } // namespace common
 } // namespace ell
@@ -10,6 +10,7 @@
 
 #include "DataLoadArguments.h"
 
+#include <data/include/BinaryDataset.h>
 #include <data/include/Dataset.h>
 #include <data/include/ExampleIterator.h>
 
@@ -18,6 +19,7 @@
 #include <utilities/include/StringUtil.h>
 
 #include <istream>
+#include <memory>
 #include <string>
 
 namespace ell
@@ -35,6 +37,17 @@ namespace common
     template <typename TextLineIteratorType, typename MetadataParserType, typename DataVectorParserType>
     auto GetExampleIterator(std::istream& stream);
 
+    /// <summary> Gets an ExampleIterator that parses an input stream on multiple threads, preserving the order of the examples. </summary>
+    ///
+    /// <typeparam name="MetadataParserType"> Metadata parser type. </typeparam>
+    /// <typeparam name="DataVectorParserType"> DataVector parser type. </typeparam>
+    /// <param name="stream"> Input stream to load data from. </param>
+    /// <param name="numThreads"> The number of parsing threads, zero means one per hardware thread. </param>
+    ///
+    /// <returns> The data iterator. </returns>
+    template <typename MetadataParserType, typename DataVectorParserType>
+    auto GetParallelExampleIterator(std::istream& stream, size_t numThreads = 0);
+
     /// <summary> Gets an AutoSupervisedExampleIterator iterator from an input stream. </summary>
     ///
     /// <param name="stream"> Input stream to load data from. </param>
@@ -49,19 +62,56 @@ namespace common
     /// <returns> The data iterator. </returns>
     data::AutoSupervisedMultiClassExampleIterator GetAutoSupervisedMultiClassExampleIterator(std::istream& stream);
 
-    /// <summary> Gets an AutoSupervisedDataset dataset from data load arguments. </summary>
+    /// <summary> Gets an AutoSupervisedDataset dataset from an input stream, which is parsed on multiple threads. </summary>
     ///
     /// <param name="stream"> Input stream to load data from. </param>
+    /// <param name="numThreads"> The number of parsing threads, zero means one per hardware thread. </param>
     ///
     /// <returns> The dataset. </returns>
-    data::AutoSupervisedDataset GetDataset(std::istream& stream);
+    data::AutoSupervisedDataset GetDataset(std::istream& stream, size_t numThreads = 1);
 
-    /// <summary> Gets a dataset from data load arguments. </summary>
+    /// <summary>
+    /// A dataset loaded from a file. Binary dataset files (.ellbd) are memory-mapped, and their examples are
+    /// materialized as trainers and evaluators iterate them; text files are parsed into memory.
+    /// </summary>
+    class FileDataset
+    {
+    public:
+        /// <summary> Loads a dataset from a file, which is either a text file or a binary dataset file. </summary>
+        ///
+        /// <param name="filename"> The name of the file to load data from. </param>
+        /// <param name="numThreads"> The number of threads that parse a text file, zero means one per hardware thread. </param>
+        FileDataset(const std::string& filename, size_t numThreads = 1);
+
+        /// <summary> Returns true if the dataset is a memory-mapped binary dataset. </summary>
+        bool IsMapped() const { return _mappedDataset != nullptr; }
+
+        /// <summary> Returns the number of examples in the dataset. </summary>
+        size_t NumExamples() const;
+
+        /// <summary> Returns the maximal size of any example. </summary>
+        size_t NumFeatures() const;
+
+        /// <summary> Returns an AnyDataset that represents an interval of examples from this dataset. </summary>
+        ///
+        /// <param name="fromIndex"> Zero-based index of the first example in the AnyDataset. </param>
+        /// <param name="size"> The number of examples to include, a value of zero means all the way to the end. </param>
+        ///
+        /// <returns> The dataset. </returns>
+        data::AnyDataset GetAnyDataset(size_t fromIndex = 0, size_t size = 0) const;
+
+    private:
+        std::unique_ptr<data::MappedDataset> _mappedDataset;
+        data::AutoSupervisedDataset _parsedDataset;
+    };
+
+    /// <summary> Gets a multiclass dataset from an input stream, which is parsed on multiple threads. </summary>
     ///
     /// <param name="stream"> Input stream to load data from. </param>
+    /// <param name="numThreads"> The number of parsing threads, zero means one per hardware thread. </param>
     ///
     /// <returns> The dataset. </returns>
-    data::AutoSupervisedMultiClassDataset GetMultiClassDataset(std::istream& stream);
+    data::AutoSupervisedMultiClassDataset GetMultiClassDataset(std::istream& stream, size_t numThreads = 1);
 
     /// <summary>
     /// Gets a new dataset by running an existing dataset through a map.
@@ -76,6 +126,19 @@ namespace common
     template <typename ExampleType, typename MapType>
     auto TransformDataset(data::Dataset<ExampleType>& input, const MapType& map);
 
+    /// <summary>
+    /// Gets a new dataset by running the examples of an AnyDataset through a map. The input examples are
+    /// read one at a time, so a memory-mapped dataset is never copied as a whole.
+    /// </summary>
+    ///
+    /// <typeparam name="MapType"> Map type. </typeparam>
+    /// <param name="input"> Input dataset. </param>
+    /// <param name="map"> Map to run input dataset on. </param>
+    ///
+    /// <returns> The transformed dataset. </returns>
+    template <typename MapType>
+    data::AutoSupervisedDataset TransformDataset(const data::AnyDataset& input, MapType& map);
+
     /// <summary>
     /// The map is first compiled, then a new dataset is returned
     /// by running an existing dataset through the compiled map.
@@ -95,6 +158,7 @@ namespace common
 
 #pragma region implementation
 
+#include <data/include/ParallelParsingExampleIterator.h>
 #include <data/include/SingleLineParsingExampleIterator.h>
 
 #include <model/include/IRCompiledMap.h>
@@ -118,6 +182,12 @@ namespace common
         return data::MakeSingleLineParsingExampleIterator(std::move(textLineIterator), std::move(metadataParser), std::move(dataVectorParser));
     }
 
+    template <typename MetadataParserType, typename DataVectorParserType>
+    auto GetParallelExampleIterator(std::istream& stream, size_t numThreads)
+    {
+        return data::MakeParallelParsingExampleIterator(stream, MetadataParserType(), DataVectorParserType(), numThreads);
+    }
+
     template <typename ExampleType, typename MapType>
     auto TransformDataset(data::Dataset<ExampleType>& input, MapType& map)
     {
@@ -127,6 +197,21 @@ namespace common
         });
     }
 
+    template <typename MapType>
+    data::AutoSupervisedDataset TransformDataset(const data::AnyDataset& input, MapType& map)
+    {
+        data::AutoSupervisedDataset output;
+        auto exampleIterator = input.GetExampleIterator<data::AutoSupervisedExample>();
+        while (exampleIterator.IsValid())
+        {
+            auto example = exampleIterator.Get();
+            auto transformedDataVector = map.template Compute<data::DoubleDataVector>(example.GetDataVector());
+            output.AddExample(data::AutoSupervisedExample(std::move(transformedDataVector), example.GetMetadata()));
+            exampleIterator.Next();
+        }
+        return output;
+    }
+
     namespace detail
     {
         // Context used by callback functions
@@ -19,13 +19,28 @@ namespace ell
 {
 namespace common
 {
-    /// <summary> Loads a model from a file, or creates a new one if given an empty filename. </summary>
+    /// <summary> The formats models and maps can be archived in. </summary>
+    enum class ArchiveFormat
+    {
+        /// <summary> JSON text, the default. </summary>
+        json,
+        /// <summary> The binary format of `utilities::BinaryArchiver`, which stores weights as raw aligned arrays. </summary>
+        binary
+    };
+
+    /// <summary> Gets the archive format to use for a file from its extension: ".ellb" files are binary, everything else is JSON. </summary>
+    ///
+    /// <param name="filename"> The filename. </param>
+    /// <returns> The archive format. </returns>
+    ArchiveFormat GetArchiveFormat(const std::string& filename);
+
+    /// <summary> Loads a model from a file, or creates a new one if given an empty filename. The archive format is chosen by `GetArchiveFormat`. </summary>
     ///
     /// <param name="filename"> The filename. </param>
     /// <returns> The loaded model. </returns>
     model::Model LoadModel(const std::string& filename);
 
-    /// <summary> Saves a model to a file. </summary>
+    /// <summary> Saves a model to a file. The archive format is chosen by `GetArchiveFormat`. </summary>
     ///
     /// <param name="model"> The model. </param>
     /// <param name="filename"> The filename. </param>
@@ -34,8 +49,9 @@ namespace common
     /// <summary> Saves a model to a stream. </summary>
     ///
     /// <param name="model"> The model. </param>
-    /// <param name="outStream"> The stream. </param>
-    void SaveModel(const model::Model& model, std::ostream& outStream);
+    /// <param name="outStream"> The stream. Must be opened in binary mode for the binary format. </param>
+    /// <param name="format"> The archive format. </param>
+    void SaveModel(const model::Model& model, std::ostream& outStream, ArchiveFormat format = ArchiveFormat::json);
 
     /// <summary> Register known node types to a serialization context </summary>
     ///
@@ -47,7 +63,7 @@ namespace common
     /// <param name="context"> The `SerializationContext` </param>
     void RegisterMapTypes(utilities::SerializationContext& context);
 
-    /// <summary> Loads a map from a file, or creates a new one if given an empty filename. </summary>
+    /// <summary> Loads a map from a file, or creates a new one if given an empty filename. The archive format is chosen by `GetArchiveFormat`. </summary>
     ///
     /// <param name="filename"> The filename. </param>
     /// <returns> The loaded map. </returns>
@@ -59,7 +75,7 @@ namespace common
     /// <returns> The loaded map. </returns>
     model::Map LoadMap(const MapLoadArguments& mapLoadArguments);
 
-    /// <summary> Saves a map to a file. </summary>
+    /// <summary> Saves a map to a file. The archive format is chosen by `GetArchiveFormat`. </summary>
     ///
     /// <param name="map"> The map. </param>
     /// <param name="filename"> The filename. </param>
@@ -68,8 +84,9 @@ namespace common
     /// <summary> Saves a map to a stream. </summary>
     ///
     /// <param name="map"> The map. </param>
-    /// <param name="outStream"> The stream. </param>
-    void SaveMap(const model::Map& map, std::ostream& outStream);
+    /// <param name="outStream"> The stream. Must be opened in binary mode for the binary format. </param>
+    /// <param name="format"> The archive format. </param>
+    void SaveMap(const model::Map& map, std::ostream& outStream, ArchiveFormat format = ArchiveFormat::json);
 
     using CustomTypeFactoryFunction = std::function<void(utilities::SerializationContext&)>;
 
@@ -97,14 +114,14 @@ namespace ell
 namespace common
 {
     // STYLE internal use only from implementation, so not declared in main part of header file
-    template <typename UnarchiverType>
-    model::Map LoadArchivedMap(std::istream& stream)
+    template <typename UnarchiverType, typename SourceType>
+    model::Map LoadArchivedMap(SourceType& source)
     {
         utilities::SerializationContext context;
         RegisterNodeTypes(context);
         RegisterMapTypes(context);
         AddCustomTypes(context);
-        UnarchiverType unarchiver(stream, context);
+        UnarchiverType unarchiver(source, context);
         model::Map map;
         unarchiver.Unarchive(map);
         return map;
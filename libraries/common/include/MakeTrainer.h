@@ -15,6 +15,7 @@
 #include <predictors/include/LinearPredictor.h>
 #include <predictors/include/ProtoNNPredictor.h>
 
+#include <trainers/include/HogwildSGDTrainer.h>
 #include <trainers/include/ITrainer.h>
 #include <trainers/include/SDCATrainer.h>
 #include <trainers/include/SGDTrainer.h>
@@ -50,6 +51,14 @@ namespace common
     /// <returns> A unique_ptr to a stochastic gradient descent trainer. </returns>
     std::unique_ptr<trainers::ITrainer<predictors::LinearPredictor<double>>> MakeSparseDataCenteredSGDTrainer(const LossFunctionArguments& lossFunctionArguments, math::RowVector<double> center, const trainers::SGDTrainerParameters& trainerParameters);
 
+    /// <summary> Makes a Hogwild (lock-free multithreaded) stochastic gradient descent trainer for sparse data. </summary>
+    ///
+    /// <param name="lossFunctionArguments"> loss arguments. </param>
+    /// <param name="trainerParameters"> trainer parameters. </param>
+    ///
+    /// <returns> A unique_ptr to a stochastic gradient descent trainer. </returns>
+    std::unique_ptr<trainers::ITrainer<predictors::LinearPredictor<double>>> MakeHogwildSGDTrainer(const LossFunctionArguments& lossFunctionArguments, const trainers::HogwildSGDTrainerParameters& trainerParameters);
+
     /// <summary> Makes a stochastic dual coordinate ascent trainer. </summary>
     ///
     /// <param name="lossFunctionArguments"> loss arguments. </param>
@@ -39,6 +39,10 @@ namespace common
         bool optimize = true;
         bool useBlas = false;
         bool debug = false;
+        bool reentrant = false;
+        bool planMemory = false;
+        bool parallelizeSubgraphs = false;
+        int batchSize = 1;
         utilities::Optional<bool> positionIndependentCode = false; // for generating -fPIC object code
         int globalValueAlignment = 32;
 
@@ -48,11 +52,13 @@ namespace common
         bool parallelize = true;
         bool useThreadPool = true;
         int maxThreads = 4;
+        bool useWorkStealing = true;
+        int tasksPerThread = 1;
 
         // optimization options (configurable per-node)
         bool fuseLinearOperations = true;
         bool optimizeReorderDataNodes = true;
-        PreferredConvolutionMethod convolutionMethod = PreferredConvolutionMethod::automatic; // known methods: auto, unrolled, simple, diagonal, winograd
+        PreferredConvolutionMethod convolutionMethod = PreferredConvolutionMethod::automatic; // known methods: auto, autotune, unrolled, simple, diagonal, winograd
 
         // raw options to store in metadata
         std::vector<std::string> modelOptions; // in format "<option-name>,<option-value-string>"
@@ -55,9 +55,19 @@ namespace common
                 "Number of elements to read from each data vector",
                 "");
         }
+
+        if (!_numParsingThreadsOptionString.empty())
+        {
+            parser.AddOption(
+                numParsingThreads,
+                _numParsingThreadsOptionString,
+                _shortNumParsingThreadsOptionString,
+                "The number of threads that parse a text data file (0 = one per hardware thread)",
+                1);
+        }
     }
 
-    ParsedDataLoadArguments::ParsedDataLoadArguments(std::optional<OptionName> filenameOption, std::optional<OptionName> directoryOption, std::optional<OptionName> dimensionOption)
+    ParsedDataLoadArguments::ParsedDataLoadArguments(std::optional<OptionName> filenameOption, std::optional<OptionName> directoryOption, std::optional<OptionName> dimensionOption, std::optional<OptionName> numParsingThreadsOption)
     {
         if (filenameOption)
         {
@@ -76,6 +86,12 @@ namespace common
             _dimensionOptionString = dimensionOption->longName;
             _shortDimensionOptionString = dimensionOption->shortName;
         }
+
+        if (numParsingThreadsOption)
+        {
+            _numParsingThreadsOptionString = numParsingThreadsOption->longName;
+            _shortNumParsingThreadsOptionString = numParsingThreadsOption->shortName;
+        }
     }
 
     utilities::CommandLineParseResult ParsedDataLoadArguments::PostProcess(const utilities::CommandLineParser& parser)
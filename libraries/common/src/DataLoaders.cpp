@@ -36,14 +36,42 @@ namespace common
         return GetExampleIterator<data::SequentialLineIterator, data::ClassIndexParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream);
     }
 
-    data::AutoSupervisedDataset GetDataset(std::istream& stream)
+    data::AutoSupervisedDataset GetDataset(std::istream& stream, size_t numThreads)
     {
-        return data::MakeDataset(GetExampleIterator<data::SequentialLineIterator, data::LabelParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream));
+        return data::MakeDataset(GetParallelExampleIterator<data::LabelParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream, numThreads));
     }
 
-    data::AutoSupervisedMultiClassDataset GetMultiClassDataset(std::istream& stream)
+    FileDataset::FileDataset(const std::string& filename, size_t numThreads)
     {
-        return data::MakeDataset(GetExampleIterator<data::SequentialLineIterator, data::ClassIndexParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream));
+        if (data::IsBinaryDatasetFile(filename))
+        {
+            _mappedDataset = std::make_unique<data::MappedDataset>(filename);
+        }
+        else
+        {
+            auto stream = utilities::OpenIfstream(filename);
+            _parsedDataset = GetDataset(stream, numThreads);
+        }
+    }
+
+    size_t FileDataset::NumExamples() const
+    {
+        return IsMapped() ? _mappedDataset->NumExamples() : _parsedDataset.NumExamples();
+    }
+
+    size_t FileDataset::NumFeatures() const
+    {
+        return IsMapped() ? _mappedDataset->NumFeatures() : _parsedDataset.NumFeatures();
+    }
+
+    data::AnyDataset FileDataset::GetAnyDataset(size_t fromIndex, size_t size) const
+    {
+        return IsMapped() ? _mappedDataset->GetAnyDataset(fromIndex, size) : _parsedDataset.GetAnyDataset(fromIndex, size);
+    }
+
+    data::AutoSupervisedMultiClassDataset GetMultiClassDataset(std::istream& stream, size_t numThreads)
+    {
+        return data::MakeDataset(GetParallelExampleIterator<data::ClassIndexParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream, numThreads));
     }
 } // namespace common
 } // namespace ell
@@ -27,6 +27,13 @@ namespace common
             "aze",
             "Add an evaluation using the constant zero predictor",
             true);
+
+        parser.AddOption(
+            numThreads,
+            "evaluationThreads",
+            "et",
+            "The number of threads to evaluate on (0 = one per hardware thread)",
+            1);
     }
 } // namespace common
 } // namespace ell
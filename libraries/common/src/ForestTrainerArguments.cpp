@@ -55,6 +55,24 @@ namespace common
                          "st",
                          "Use the sorting trainer instead of the histogram trainer",
                          false);
+
+        parser.AddOption(binnedTrainer,
+                         "binnedTrainer",
+                         "bt",
+                         "Use the binned trainer, which quantizes each feature once and finds splits from per-node histograms, instead of the histogram trainer",
+                         false);
+
+        parser.AddOption(maxBinsPerFeature,
+                         "maxBinsPerFeature",
+                         "mbpf",
+                         "The maximum number of bins per feature used by the binned trainer (up to 256 uses 8-bit bins, up to 65536 uses 16-bit bins)",
+                         255);
+
+        parser.AddOption(numThreads,
+                         "numThreads",
+                         "nt",
+                         "The number of threads to use when searching for splits (0 = one per hardware thread)",
+                         0);
     }
 } // namespace common
 } // namespace ell
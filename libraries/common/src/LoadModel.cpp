@@ -17,6 +17,7 @@
 
 #include <nodes/include/AccumulatorNode.h>
 #include <nodes/include/ActivationFunctions.h>
+#include <nodes/include/BiasActivationNode.h>
 #include <nodes/include/BinaryOperationNode.h>
 #include <nodes/include/BinaryPredicateNode.h>
 #include <nodes/include/BroadcastFunctionNode.h>
@@ -50,6 +51,7 @@
 #include <nodes/include/MultiplexerNode.h>
 #include <nodes/include/NeuralNetworkPredictorNode.h>
 #include <nodes/include/ProtoNNPredictorNode.h>
+#include <nodes/include/QuantizedConvolutionNode.h>
 #include <nodes/include/RNNNode.h>
 #include <nodes/include/ReceptiveFieldMatrixNode.h>
 #include <nodes/include/ReinterpretLayoutNode.h>
@@ -79,6 +81,7 @@
 #include <predictors/neural/include/TanhActivation.h>
 
 #include <utilities/include/Archiver.h>
+#include <utilities/include/BinaryArchiver.h>
 #include <utilities/include/Files.h>
 #include <utilities/include/JsonArchiver.h>
 
@@ -103,6 +106,12 @@ namespace common
         context.GetTypeFactory().AddType<model::Node, nodes::AccumulatorNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::ArgMaxNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::ArgMinNode<ElementType>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::BiasActivationNode<ElementType, nodes::HardSigmoidActivationFunction<ElementType>>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::BiasActivationNode<ElementType, nodes::HardTanhActivationFunction<ElementType>>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::BiasActivationNode<ElementType, nodes::LeakyReLUActivationFunction<ElementType>>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::BiasActivationNode<ElementType, nodes::ReLUActivationFunction<ElementType>>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::BiasActivationNode<ElementType, nodes::SigmoidActivationFunction<ElementType>>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::BiasActivationNode<ElementType, nodes::TanhActivationFunction<ElementType>>>();
         context.GetTypeFactory().AddType<model::Node, nodes::BinaryOperationNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::BroadcastUnaryFunctionNode<ElementType, nodes::HardSigmoidActivationFunction<ElementType>>>();
         context.GetTypeFactory().AddType<model::Node, nodes::BroadcastUnaryFunctionNode<ElementType, nodes::HardTanhActivationFunction<ElementType>>>();
@@ -140,6 +149,10 @@ namespace common
         context.GetTypeFactory().AddType<model::Node, nodes::MovingAverageNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::MovingVarianceNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::NeuralNetworkPredictorNode<ElementType>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::QuantizedConvolutionNode<ElementType, ElementType, ElementType>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::QuantizedConvolutionNode<ElementType, ElementType, int8_t>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::QuantizedConvolutionNode<ElementType, int8_t, ElementType>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::QuantizedConvolutionNode<ElementType, int8_t, int8_t>>();
         context.GetTypeFactory().AddType<model::Node, nodes::ReceptiveFieldMatrixNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::ReorderDataCodeNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::ReorderDataNode<ElementType>>();
@@ -302,12 +315,18 @@ namespace common
         context.GetTypeFactory().AddType<model::Map, model::Map>();
     }
 
-    template <typename UnarchiverType>
-    model::Model LoadArchivedModel(std::istream& stream)
+    ArchiveFormat GetArchiveFormat(const std::string& filename)
+    {
+        auto extension = GetFileExtension(filename, true);
+        return extension == "ellb" ? ArchiveFormat::binary : ArchiveFormat::json;
+    }
+
+    template <typename UnarchiverType, typename SourceType>
+    model::Model LoadArchivedModel(SourceType& source)
     {
         SerializationContext context;
         RegisterNodeTypes(context);
-        UnarchiverType unarchiver(stream, context);
+        UnarchiverType unarchiver(source, context);
         model::Model model;
         unarchiver.Unarchive(model);
         return model;
@@ -327,6 +346,11 @@ namespace common
             throw SystemException(SystemExceptionErrors::fileNotFound);
         }
 
+        if (GetArchiveFormat(filename) == ArchiveFormat::binary)
+        {
+            return LoadArchivedModel<BinaryUnarchiver>(filename);
+        }
+
         auto filestream = OpenIfstream(filename);
         return LoadArchivedModel<JsonUnarchiver>(filestream);
     }
@@ -337,13 +361,21 @@ namespace common
         {
             throw SystemException(SystemExceptionErrors::fileNotWritable);
         }
-        auto filestream = OpenOfstream(filename);
-        SaveModel(model, filestream);
+        auto format = GetArchiveFormat(filename);
+        auto filestream = format == ArchiveFormat::binary ? OpenBinaryOfstream(filename) : OpenOfstream(filename);
+        SaveModel(model, filestream, format);
     }
 
-    void SaveModel(const model::Model& model, std::ostream& outStream)
+    void SaveModel(const model::Model& model, std::ostream& outStream, ArchiveFormat format)
     {
-        SaveArchivedObject<JsonArchiver>(model, outStream);
+        if (format == ArchiveFormat::binary)
+        {
+            SaveArchivedObject<BinaryArchiver>(model, outStream);
+        }
+        else
+        {
+            SaveArchivedObject<JsonArchiver>(model, outStream);
+        }
     }
 
     //
@@ -422,10 +454,14 @@ namespace common
             throw SystemException(SystemExceptionErrors::fileNotFound, "File not found '" + filename + "'");
         }
 
-        auto filestream = OpenIfstream(filename);
-
         try
         {
+            if (GetArchiveFormat(filename) == ArchiveFormat::binary)
+            {
+                return LoadArchivedMap<BinaryUnarchiver>(filename);
+            }
+
+            auto filestream = OpenIfstream(filename);
             return LoadArchivedMap<JsonUnarchiver>(filestream);
         }
         catch (const std::exception& ex)
@@ -440,13 +476,21 @@ namespace common
         {
             throw SystemException(SystemExceptionErrors::fileNotWritable);
         }
-        auto filestream = OpenOfstream(filename);
-        SaveMap(map, filestream);
+        auto format = GetArchiveFormat(filename);
+        auto filestream = format == ArchiveFormat::binary ? OpenBinaryOfstream(filename) : OpenOfstream(filename);
+        SaveMap(map, filestream, format);
     }
 
-    void SaveMap(const model::Map& map, std::ostream& outStream)
+    void SaveMap(const model::Map& map, std::ostream& outStream, ArchiveFormat format)
     {
-        SaveArchivedObject<JsonArchiver>(map, outStream);
+        if (format == ArchiveFormat::binary)
+        {
+            SaveArchivedObject<BinaryArchiver>(map, outStream);
+        }
+        else
+        {
+            SaveArchivedObject<JsonArchiver>(map, outStream);
+        }
     }
 
     CustomTypeFactoryFunction _func;
@@ -16,6 +16,7 @@
 
 #include <utilities/include/CommandLineParser.h>
 
+#include <trainers/include/BinnedForestTrainer.h>
 #include <trainers/include/HistogramForestTrainer.h>
 #include <trainers/include/LogitBooster.h>
 #include <trainers/include/ProtoNNTrainer.h>
@@ -95,6 +96,29 @@ namespace common
         }
     }
 
+    std::unique_ptr<trainers::ITrainer<predictors::LinearPredictor<double>>> MakeHogwildSGDTrainer(const LossFunctionArguments& lossFunctionArguments, const trainers::HogwildSGDTrainerParameters& trainerParameters)
+    {
+        using LossFunctionEnum = common::LossFunctionArguments::LossFunction;
+
+        switch (lossFunctionArguments.lossFunction)
+        {
+        case LossFunctionEnum::squared:
+            return trainers::MakeHogwildSGDTrainer(functions::SquaredLoss(), trainerParameters);
+
+        case LossFunctionEnum::log:
+            return trainers::MakeHogwildSGDTrainer(functions::LogLoss(), trainerParameters);
+
+        case LossFunctionEnum::hinge:
+            return trainers::MakeHogwildSGDTrainer(functions::HingeLoss(), trainerParameters);
+
+        case LossFunctionEnum::smoothHinge:
+            return trainers::MakeHogwildSGDTrainer(functions::SmoothHingeLoss(), trainerParameters);
+
+        default:
+            throw utilities::CommandLineParserErrorException("chosen loss function is not supported by this trainer");
+        }
+    }
+
     std::unique_ptr<trainers::ITrainer<predictors::LinearPredictor<double>>> MakeSDCATrainer(const LossFunctionArguments& lossFunctionArguments, const trainers::SDCATrainerParameters& trainerParameters)
     {
         using LossFunctionEnum = common::LossFunctionArguments::LossFunction;
@@ -127,6 +151,10 @@ namespace common
             {
                 return trainers::MakeSortingForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainerArguments);
             }
+            else if (trainerArguments.binnedTrainer)
+            {
+                return trainers::MakeBinnedForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainerArguments);
+            }
             else
             {
                 return trainers::MakeHistogramForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainers::ExhaustiveThresholdFinder(), trainerArguments);
@@ -73,12 +73,13 @@ namespace common
             convolutionMethod,
             "convolutionMethod",
             "",
-            "Set the preferred convolution method",
+            "Set the preferred convolution method ('autotune' times each method on the host and picks the fastest per layer)",
             { { "unrolled", PreferredConvolutionMethod::unrolled },
               { "simple", PreferredConvolutionMethod::simple },
               { "diagonal", PreferredConvolutionMethod::diagonal },
               { "winograd", PreferredConvolutionMethod::winograd },
-              { "auto", PreferredConvolutionMethod::automatic } },
+              { "auto", PreferredConvolutionMethod::automatic },
+              { "autotune", PreferredConvolutionMethod::autotune } },
             "auto");
 
         parser.AddOption(
@@ -130,6 +131,20 @@ namespace common
             "Maximum num of parallel threads",
             4);
 
+        parser.AddOption(
+            useWorkStealing,
+            "workStealing",
+            "",
+            "Let idle thread pool workers steal tasks from each other's ranges, instead of taking every task from one shared queue",
+            true);
+
+        parser.AddOption(
+            tasksPerThread,
+            "tasksPerThread",
+            "",
+            "Number of tasks to split each parallel loop into per thread (values above 1 help balance uneven loops when using the thread pool)",
+            1);
+
         parser.AddOption(
             debug,
             "debug",
@@ -137,6 +152,34 @@ namespace common
             "Emit debug code",
             false);
 
+        parser.AddOption(
+            reentrant,
+            "reentrant",
+            "",
+            "Keep model state per thread and emit functions to save and restore it, so one compiled model can serve several threads",
+            false);
+
+        parser.AddOption(
+            planMemory,
+            "planMemory",
+            "",
+            "Share one scratch buffer between intermediate node outputs that are never live at the same time",
+            false);
+
+        parser.AddOption(
+            parallelizeSubgraphs,
+            "parallelizeSubgraphs",
+            "",
+            "Run independent branches of the model in parallel with each other",
+            false);
+
+        parser.AddOption(
+            batchSize,
+            "batchSize",
+            "",
+            "The number of inputs that predict_loop computes at once, with the fully connected layers' matrix-vector products fused into matrix-matrix products",
+            1);
+
         parser.AddDocumentationString("");
         parser.AddDocumentationString("Target device options");
         parser.AddOption(
@@ -241,8 +284,16 @@ namespace common
         settings.compilerSettings.useBlas = useBlas;
         settings.compilerSettings.allowVectorInstructions = enableVectorization;
         settings.compilerSettings.parallelize = parallelize;
+        settings.compilerSettings.useThreadPool = useThreadPool;
+        settings.compilerSettings.maxThreads = maxThreads;
+        settings.compilerSettings.useWorkStealing = useWorkStealing;
+        settings.compilerSettings.tasksPerThread = tasksPerThread;
         settings.compilerSettings.vectorWidth = vectorWidth;
         settings.profile = profile;
+        settings.reentrant = reentrant;
+        settings.planMemory = planMemory;
+        settings.parallelizeSubgraphs = parallelizeSubgraphs;
+        settings.batchSize = batchSize;
         settings.compilerSettings.profile = profile;
         settings.compilerSettings.positionIndependentCode = positionIndependentCode;
         settings.compilerSettings.globalValueAlignment = globalValueAlignment;
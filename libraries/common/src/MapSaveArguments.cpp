@@ -18,7 +18,7 @@ namespace common
             outputMapFilename,
             "outputMapFilename",
             "omf",
-            "Path to the output map file (empty for standard out, 'null' for no output)",
+            "Path to the output map file (empty for standard out, 'null' for no output, a .ellb extension for the binary format)",
             "");
     }
 
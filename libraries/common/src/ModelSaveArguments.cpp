@@ -18,7 +18,7 @@ namespace common
             outputModelFilename,
             "outputModelFilename",
             "omf",
-            "Path to the output model file",
+            "Path to the output model file (a .ellb extension for the binary format)",
             "");
     }
 
@@ -74,6 +74,18 @@ namespace common
                          "nInnerIter",
                          "Number of inner iterations",
                          1);
+
+        parser.AddOption(numThreads,
+                         "protonnNumThreads",
+                         "pnt",
+                         "Number of threads to compute kernels and gradients on (0 = one per hardware thread)",
+                         1);
+
+        parser.AddOption(batchSize,
+                         "protonnBatchSize",
+                         "pbs",
+                         "Number of examples in each stochastic gradient step (0 = full-batch gradient steps)",
+                         256);
     }
 } // namespace common
 } // namespace ell
@@ -8,5 +8,6 @@
 namespace ell
 {
 void TestLoadDataset(const std::string& examplePath);
+void TestLoadFileDataset(const std::string& examplePath);
 void TestLoadMappedDataset(const std::string& examplePath);
 } // namespace ell
\ No newline at end of file
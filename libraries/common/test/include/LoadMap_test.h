@@ -8,4 +8,5 @@ namespace ell
 {
 void TestLoadMapWithDefaultArgs(const std::string& examplePath);
 void TestLoadMapWithPorts(const std::string& examplePath);
+void TestSaveAndLoadMap(const std::string& examplePath, const std::string& ext);
 } // namespace ell
\ No newline at end of file
@@ -10,5 +10,6 @@ namespace ell
 void TestLoadSampleModels();
 void TestLoadTreeModels();
 void TestLoadSavedModels(const std::string& examplePath);
-void TestSaveModels();
+void TestSaveModels(const std::string& ext);
+void TestGetArchiveFormat();
 } // namespace ell
\ No newline at end of file
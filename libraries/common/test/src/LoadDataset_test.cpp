@@ -10,6 +10,8 @@
 #include <common/include/LoadModel.h>
 #include <common/include/MapLoadArguments.h>
 
+#include <data/include/BinaryDataset.h>
+
 #include <testing/include/testing.h>
 
 #include <utilities/include/Files.h>
@@ -25,6 +27,18 @@ void TestLoadDataset(const std::string& examplePath)
     auto dataset = common::GetDataset(stream);
 }
 
+void TestLoadFileDataset(const std::string& examplePath)
+{
+    auto textFilename = utilities::JoinPaths(examplePath, { "data", "testData.txt" });
+    common::FileDataset textDataset(textFilename);
+    testing::ProcessTest("TestLoadFileDataset text file", !textDataset.IsMapped() && textDataset.NumExamples() > 0);
+
+    const std::string binaryFilename("testData.ellbd");
+    data::WriteBinaryDataset(textDataset.GetAnyDataset(0, textDataset.NumExamples()), binaryFilename);
+    common::FileDataset binaryDataset(binaryFilename);
+    testing::ProcessTest("TestLoadFileDataset binary file", binaryDataset.IsMapped() && binaryDataset.NumExamples() == textDataset.NumExamples() && binaryDataset.NumFeatures() == textDataset.NumFeatures());
+}
+
 void TestLoadMappedDataset(const std::string& examplePath)
 {
     common::MapLoadArguments args;
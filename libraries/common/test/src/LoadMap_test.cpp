@@ -15,6 +15,8 @@
 #include <testing/include/testing.h>
 
 #include <iostream>
+#include <sstream>
+#include <vector>
 
 namespace ell
 {
@@ -47,4 +49,30 @@ void TestLoadMapWithPorts(const std::string& examplePath)
     // check stuff out
     testing::ProcessTest("Testing Map constructor supports multiple output ranges", map.GetOutput().Size() == 4);
 }
+
+void TestSaveAndLoadMap(const std::string& examplePath, const std::string& ext)
+{
+    common::MapLoadArguments args;
+    args.inputModelFilename = utilities::JoinPaths(examplePath, { "models", "model_1.model" });
+    args.modelInputsString = "";
+    args.modelOutputsString = "1031.output"; // the LinearPredictorNode
+    auto map = common::LoadMap(args);
+
+    auto filename = "map_1." + ext;
+    common::SaveMap(map, filename);
+    auto newMap = common::LoadMap(filename);
+
+    std::vector<double> input = { 1.0, -2.0, 0.5 };
+    auto output = map.Compute<double>(input);
+    auto newOutput = newMap.Compute<double>(input);
+    testing::ProcessTest("Testing saved map (" + ext + ") size", newMap.GetInput(0)->Size() == 3 && newMap.GetOutput(0).Size() == 1 && newMap.GetModel().Size() == map.GetModel().Size());
+    testing::ProcessTest("Testing saved map (" + ext + ") output", testing::IsEqual(output, newOutput));
+
+    // a reloaded map archives to the same JSON as the original, whatever format it went through
+    std::stringstream originalJson;
+    std::stringstream newJson;
+    common::SaveMap(map, originalJson);
+    common::SaveMap(newMap, newJson);
+    testing::ProcessTest("Testing saved map (" + ext + ") contents", originalJson.str() == newJson.str());
+}
 } // namespace ell
@@ -14,6 +14,7 @@
 #include <testing/include/testing.h>
 
 #include <iostream>
+#include <sstream>
 
 namespace ell
 {
@@ -61,9 +62,8 @@ void TestLoadSavedModels(const std::string& examplePath)
     testing::ProcessTest("Testing saved model 1 size", model1.Size() == expectedModel1Size);
 }
 
-void TestSaveModels()
+void TestSaveModels(const std::string& ext)
 {
-    std::string ext = "model";
     auto model1 = common::LoadTestModel("[1]");
     auto model2 = common::LoadTestModel("[2]");
     auto model3 = common::LoadTestModel("[3]");
@@ -95,5 +95,20 @@ void TestSaveModels()
     testing::ProcessTest("Testing tree model 1 size", newTree1.Size() == expectedTreeModel1Size);
     testing::ProcessTest("Testing tree model 2 size", newTree2.Size() == expectedTreeModel2Size);
     testing::ProcessTest("Testing tree model 3 size", newTree3.Size() == expectedTreeModel3Size);
+
+    // a reloaded model archives to the same JSON as the original, whatever format it went through
+    std::stringstream originalJson;
+    std::stringstream newJson;
+    common::SaveModel(tree3, originalJson);
+    common::SaveModel(newTree3, newJson);
+    testing::ProcessTest("Testing saved tree model 3 contents (" + ext + ")", originalJson.str() == newJson.str());
+}
+
+void TestGetArchiveFormat()
+{
+    testing::ProcessTest("Testing GetArchiveFormat", common::GetArchiveFormat("model_1.model") == common::ArchiveFormat::json);
+    testing::ProcessTest("Testing GetArchiveFormat", common::GetArchiveFormat("model_1.ell") == common::ArchiveFormat::json);
+    testing::ProcessTest("Testing GetArchiveFormat", common::GetArchiveFormat("model_1.ellb") == common::ArchiveFormat::binary);
+    testing::ProcessTest("Testing GetArchiveFormat", common::GetArchiveFormat("MODEL_1.ELLB") == common::ArchiveFormat::binary);
 }
 } // namespace ell
@@ -36,12 +36,17 @@ int main(int argc, char* argv[])
         TestLoadTreeModels();
         TestLoadSavedModels(examplePath);
 
-        TestSaveModels();
+        TestSaveModels("model");
+        TestSaveModels("ellb");
+        TestGetArchiveFormat();
 
         TestLoadMapWithDefaultArgs(examplePath);
         TestLoadMapWithPorts(examplePath);
+        TestSaveAndLoadMap(examplePath, "map");
+        TestSaveAndLoadMap(examplePath, "ellb");
 
         TestLoadDataset(examplePath);
+        TestLoadFileDataset(examplePath);
         TestLoadMappedDataset(examplePath);
     }
     catch (const utilities::Exception& exception)
@@ -130,6 +130,14 @@ namespace data
         template <IterationPolicy policy, typename TransformationType>
         void AddTransformedTo(math::RowVectorReference<double> vector, TransformationType transformation) const;
 
+        /// <summary> Calls a function on each element of this data vector. </summary>
+        ///
+        /// <typeparam name="policy"> The iteration policy. </typeparam>
+        /// <typeparam name="FunctionType"> A functor that takes an IndexValue. </typeparam>
+        /// <param name="function"> The function. </param>
+        template <IterationPolicy policy, typename FunctionType>
+        void ForEach(FunctionType function) const;
+
         /// <summary> Copies the contents of this DataVector into a double array of size PrefixLength(). </summary>
         ///
         /// <returns> The array. </returns>
@@ -299,6 +307,13 @@ namespace data
         _pInternal->AddTransformedTo<policy>(vector, transformation);
     }
 
+    template <typename DefaultDataVectorType>
+    template <IterationPolicy policy, typename FunctionType>
+    void AutoDataVectorBase<DefaultDataVectorType>::ForEach(FunctionType function) const
+    {
+        _pInternal->ForEach<policy>(function);
+    }
+
     template <typename DefaultDataVectorType>
     template <typename ReturnType, typename... ArgTypes>
     ReturnType AutoDataVectorBase<DefaultDataVectorType>::CopyAs(ArgTypes... args) const
@@ -0,0 +1,283 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryDataset.h (data)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Dataset.h"
+#include "Example.h"
+#include "ExampleIterator.h"
+#include "IndexValue.h"
+#include "WeightLabel.h"
+
+#include <utilities/include/MemoryMappedFile.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary>
+    /// Layout of the binary dataset format. A file consists of a header followed by three arrays, each starting
+    /// on an 8-byte boundary: a block of 4-byte words holding the rows' values, the metadata of each example, and
+    /// a row descriptor for each example. Every row is stored either densely (all entries up to its prefix length,
+    /// as floats) or sparsely (the column indices of its nonzeros, followed by their float values), whichever is
+    /// smaller. The rows come first so that a writer can stream them out as it reads the examples, and only keep
+    /// the small per-example arrays in memory.
+    /// </summary>
+    namespace binaryDataset
+    {
+        /// <summary> The first 8 bytes of a binary dataset file. </summary>
+        constexpr char magic[8] = { 'E', 'L', 'L', 'D', 'A', 'T', 'A', '\0' };
+
+        /// <summary> The current format version. </summary>
+        constexpr uint32_t version = 2;
+
+        /// <summary> The file header. </summary>
+        struct Header
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t reserved;
+            uint64_t numExamples;
+            uint64_t numFeatures;
+            uint64_t numValueWords;
+        };
+
+        /// <summary> Describes where a row is stored. </summary>
+        struct RowDescriptor
+        {
+            /// <summary> Offset of the row in the block of values, in 4-byte words. </summary>
+            uint64_t offset;
+
+            /// <summary> The number of stored values. </summary>
+            uint32_t size;
+
+            /// <summary> Nonzero if the row is stored sparsely, as column indices followed by values. </summary>
+            uint32_t isSparse;
+        };
+    } // namespace binaryDataset
+
+    /// <summary>
+    /// Writes examples to a stream in the binary dataset format. Each row is written as soon as it is read, and
+    /// the header is filled in at the end, so the stream must be seekable.
+    /// </summary>
+    ///
+    /// <param name="exampleIterator"> An iterator over the examples to write. </param>
+    /// <param name="stream"> The output stream, which should be opened in binary mode. </param>
+    void WriteBinaryDataset(AutoSupervisedExampleIterator exampleIterator, std::ostream& stream);
+
+    /// <summary> Writes a dataset to a file in the binary dataset format. </summary>
+    ///
+    /// <param name="dataset"> The dataset. </param>
+    /// <param name="filename"> The output filename. </param>
+    void WriteBinaryDataset(const AnyDataset& dataset, const std::string& filename);
+
+    /// <summary> Returns true if a file starts with the binary dataset magic number. </summary>
+    ///
+    /// <param name="filename"> The filename. </param>
+    ///
+    /// <returns> True if the file is a binary dataset. </returns>
+    bool IsBinaryDatasetFile(const std::string& filename);
+
+    /// <summary>
+    /// A read-only dataset backed by a memory-mapped binary dataset file. The example values stay in the
+    /// OS page cache; rows can be read in place with GetRow, and data vectors are only materialized when
+    /// examples are requested through an example iterator.
+    /// </summary>
+    class MappedDataset : public ExternalDatasetBase
+    {
+    public:
+        /// <summary> A view of the values of one row, pointing into the mapped file. </summary>
+        struct RowView
+        {
+            /// <summary> The stored values. </summary>
+            const float* values;
+
+            /// <summary> The column index of each stored value, or nullptr if the row is dense. </summary>
+            const uint32_t* indices;
+
+            /// <summary> The number of stored values. </summary>
+            size_t size;
+
+            /// <summary> Returns true if the row is stored sparsely. </summary>
+            bool IsSparse() const { return indices != nullptr; }
+        };
+
+        /// <summary> An index-value iterator over the nonzeros of a row. </summary>
+        class RowIterator : public IIndexValueIterator
+        {
+        public:
+            /// <summary> Constructs an iterator over a row. </summary>
+            ///
+            /// <param name="row"> The row. </param>
+            RowIterator(const RowView& row);
+
+            /// <summary> Returns true if the iterator is currently pointing to a valid iterate. </summary>
+            bool IsValid() const { return _position < _row.size; }
+
+            /// <summary> Proceeds to the next nonzero. </summary>
+            void Next();
+
+            /// <summary> Returns the current index-value pair. </summary>
+            IndexValue Get() const;
+
+        private:
+            void SkipZeros();
+
+            RowView _row;
+            size_t _position = 0;
+        };
+
+        /// <summary> An example iterator that materializes examples from the mapped rows. </summary>
+        template <typename IteratorExampleType>
+        class MappedDatasetExampleIterator : public IExampleIterator<IteratorExampleType>
+        {
+        public:
+            /// <summary> Constructs an iterator over an interval of examples. </summary>
+            MappedDatasetExampleIterator(const MappedDataset& dataset, size_t fromIndex, size_t size);
+
+            /// <summary> Returns true if the iterator is currently pointing to a valid iterate. </summary>
+            bool IsValid() const override { return _current < _end; }
+
+            /// <summary> Proceeds to the Next iterate. </summary>
+            void Next() override { ++_current; }
+
+            /// <summary> Gets the current example. </summary>
+            IteratorExampleType Get() const override { return _dataset.template GetExample<IteratorExampleType>(_current); }
+
+        private:
+            const MappedDataset& _dataset;
+            size_t _current;
+            size_t _end;
+        };
+
+        /// <summary> Maps a binary dataset file. Throws an InputException if the file is not a valid binary dataset. </summary>
+        ///
+        /// <param name="filename"> The filename. </param>
+        MappedDataset(const std::string& filename);
+
+        MappedDataset(MappedDataset&&) = default;
+
+        MappedDataset(const MappedDataset&) = delete;
+
+        /// <summary> Returns the number of examples in the data set. </summary>
+        ///
+        /// <returns> The number of examples. </returns>
+        size_t NumExamples() const { return _header->numExamples; }
+
+        /// <summary> Returns the maximal size of any example. </summary>
+        ///
+        /// <returns> The maximal size of any example. </returns>
+        size_t NumFeatures() const { return _header->numFeatures; }
+
+        /// <summary> Gets the metadata of an example. </summary>
+        ///
+        /// <param name="index"> Zero-based index of the example. </param>
+        ///
+        /// <returns> The weight and label of the example. </returns>
+        const WeightLabel& GetMetadata(size_t index) const { return _metadata[index]; }
+
+        /// <summary> Gets an in-place view of the values of an example. </summary>
+        ///
+        /// <param name="index"> Zero-based index of the example. </param>
+        ///
+        /// <returns> The row view. </returns>
+        RowView GetRow(size_t index) const;
+
+        /// <summary> Materializes an example. </summary>
+        ///
+        /// <typeparam name="ExampleType"> The example type to create. </typeparam>
+        /// <param name="index"> Zero-based index of the example. </param>
+        ///
+        /// <returns> The example. </returns>
+        template <typename ExampleType = AutoSupervisedExample>
+        ExampleType GetExample(size_t index) const;
+
+        /// <summary> Returns an iterator that traverses the examples. </summary>
+        ///
+        /// <param name="fromIndex"> Zero-based index of the first example to iterate over. </param>
+        /// <param name="size"> The number of examples to iterate over, a value of zero means all
+        /// the way to the end. </param>
+        ///
+        /// <returns> The iterator. </returns>
+        template <typename IteratorExampleType = AutoSupervisedExample>
+        ExampleIterator<IteratorExampleType> GetExampleIterator(size_t fromIndex = 0, size_t size = 0) const;
+
+        /// <summary> Returns an iterator that traverses an interval of examples, as AutoSupervisedExamples. </summary>
+        ///
+        /// <param name="fromIndex"> Zero-based index of the first example to iterate over. </param>
+        /// <param name="size"> The number of examples to iterate over, a value of zero means all
+        /// the way to the end. </param>
+        ///
+        /// <returns> The iterator. </returns>
+        AutoSupervisedExampleIterator GetAutoSupervisedExampleIterator(size_t fromIndex, size_t size) const override;
+
+        /// <summary> Materializes an example as an AutoSupervisedExample. </summary>
+        ///
+        /// <param name="index"> Zero-based index of the example. </param>
+        ///
+        /// <returns> The example. </returns>
+        AutoSupervisedExample GetAutoSupervisedExample(size_t index) const override { return GetExample<AutoSupervisedExample>(index); }
+
+        /// <summary> Returns an AnyDataset that represents an interval of examples from this dataset. </summary>
+        ///
+        /// <param name="fromIndex"> Zero-based index of the first example in the AnyDataset. </param>
+        /// <param name="size"> The number of examples to include, a value of zero means all
+        /// the way to the end. </param>
+        ///
+        /// <returns> The dataset. </returns>
+        AnyDataset GetAnyDataset(size_t fromIndex = 0, size_t size = 0) const { return AnyDataset(this, fromIndex, CorrectRangeSize(fromIndex, size)); }
+
+    private:
+        size_t CorrectRangeSize(size_t fromIndex, size_t size) const;
+
+        utilities::MemoryMappedFile _file;
+        const binaryDataset::Header* _header = nullptr;
+        const WeightLabel* _metadata = nullptr;
+        const binaryDataset::RowDescriptor* _rows = nullptr;
+        const float* _values = nullptr; // the block of values, as floats
+        const uint32_t* _indices = nullptr; // the same block, as column indices
+    };
+} // namespace data
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace data
+{
+    template <typename IteratorExampleType>
+    MappedDataset::MappedDatasetExampleIterator<IteratorExampleType>::MappedDatasetExampleIterator(const MappedDataset& dataset, size_t fromIndex, size_t size) :
+        _dataset(dataset),
+        _current(fromIndex),
+        _end(fromIndex + size)
+    {
+    }
+
+    template <typename ExampleType>
+    ExampleType MappedDataset::GetExample(size_t index) const
+    {
+        using DataVectorType = typename ExampleType::DataVectorType;
+        using MetadataType = typename ExampleType::MetadataType;
+        return ExampleType(DataVectorType(RowIterator(GetRow(index))), MetadataType(GetMetadata(index)));
+    }
+
+    template <typename IteratorExampleType>
+    ExampleIterator<IteratorExampleType> MappedDataset::GetExampleIterator(size_t fromIndex, size_t size) const
+    {
+        size = CorrectRangeSize(fromIndex, size);
+        return ExampleIterator<IteratorExampleType>(std::make_unique<MappedDatasetExampleIterator<IteratorExampleType>>(*this, fromIndex, size));
+    }
+} // namespace data
+} // namespace ell
+
+#pragma endregion implementation
@@ -100,6 +100,14 @@ namespace data
         template <IterationPolicy policy, typename TransformationType>
         void AddTransformedTo(math::RowVectorReference<double> vector, TransformationType transformation) const;
 
+        /// <summary> Calls a function on each element of this data vector. </summary>
+        ///
+        /// <typeparam name="policy"> The iteration policy. </typeparam>
+        /// <typeparam name="FunctionType"> A functor that takes an IndexValue. </typeparam>
+        /// <param name="function"> The function. </param>
+        template <IterationPolicy policy, typename FunctionType>
+        void ForEach(FunctionType function) const;
+
         /// <summary> Copies the contents of this DataVector into a double array of size PrefixLength(). </summary>
         ///
         /// <returns> The array. </returns>
@@ -157,6 +165,14 @@ namespace data
         ReturnType InvokeWithThis(GenericLambdaType lambda) const;
     };
 
+    /// <summary> A transformation that multiplies each element by a scalar. Data vectors can recognize it and use faster code paths than they can for an arbitrary transformation. </summary>
+    struct ScaleTransformation
+    {
+        double scale;
+
+        double operator()(IndexValue indexValue) const { return scale * indexValue.value; }
+    };
+
     /// <summary> A helper definition used to define the IsDataVector SFINAE concept. </summary>
     template <typename T>
     using IsDataVector = typename std::enable_if_t<std::is_base_of<IDataVector, T>::value, bool>;
@@ -490,6 +506,19 @@ namespace data
         });
     }
 
+    template <IterationPolicy policy, typename FunctionType>
+    void IDataVector::ForEach(FunctionType function) const
+    {
+        InvokeWithThis<void>([&function](const auto* pThis) {
+            auto iterator = pThis->template GetIterator<policy>();
+            while (iterator.IsValid())
+            {
+                function(iterator.Get());
+                iterator.Next();
+            }
+        });
+    }
+
     template <typename ReturnType>
     ReturnType IDataVector::CopyAs() const
     {
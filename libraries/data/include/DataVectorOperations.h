@@ -98,7 +98,7 @@ namespace data
     template <typename DataVectorType, IsDataVector<DataVectorType> Concept>
     auto operator*(double scalar, const DataVectorType& vector)
     {
-        return MakeTransformedDataVector<IterationPolicy::skipZeros>(vector, [scalar](IndexValue x) { return scalar * x.value; });
+        return MakeTransformedDataVector<IterationPolicy::skipZeros>(vector, ScaleTransformation{ scalar });
     }
 
     template <typename DataVectorType, IsDataVector<DataVectorType> Concept>
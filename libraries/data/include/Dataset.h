@@ -17,8 +17,10 @@
 #include <utilities/include/TypeTraits.h>
 
 #include <functional>
+#include <memory>
 #include <ostream>
 #include <random>
+#include <type_traits>
 #include <vector>
 
 namespace ell
@@ -35,6 +37,29 @@ namespace data
         virtual ~DatasetBase() = default;
     };
 
+    /// <summary>
+    /// Base class for datasets that keep their examples outside of memory (for example, in a mapped file) and
+    /// materialize them as they are iterated. AnyDataset reads these datasets through this interface, so it
+    /// doesn't depend on their concrete types.
+    /// </summary>
+    struct ExternalDatasetBase : public DatasetBase
+    {
+        /// <summary> Returns an iterator that materializes an interval of examples. </summary>
+        ///
+        /// <param name="fromIndex"> Zero-based index of the first example to iterate over. </param>
+        /// <param name="size"> The number of examples to iterate over. </param>
+        ///
+        /// <returns> The iterator. </returns>
+        virtual AutoSupervisedExampleIterator GetAutoSupervisedExampleIterator(size_t fromIndex, size_t size) const = 0;
+
+        /// <summary> Materializes a single example. </summary>
+        ///
+        /// <param name="index"> Zero-based index of the example. </param>
+        ///
+        /// <returns> The example. </returns>
+        virtual AutoSupervisedExample GetAutoSupervisedExample(size_t index) const = 0;
+    };
+
     /// <summary> Implements an untyped data set. This class is used to send data to trainers and evaluators </summary>
     class AnyDataset
     {
@@ -59,6 +84,16 @@ namespace data
         /// <returns> Number of examples. </returns>
         size_t NumExamples() const { return _size; }
 
+        /// <summary> Returns the zero-based index of the first example in the underlying dataset. </summary>
+        ///
+        /// <returns> The index of the first example. </returns>
+        size_t GetFromIndex() const { return _fromIndex; }
+
+        /// <summary> Returns the underlying dataset if it keeps its examples outside of memory, else nullptr. </summary>
+        ///
+        /// <returns> Pointer to the external dataset, or nullptr. </returns>
+        const ExternalDatasetBase* GetExternalDataset() const { return dynamic_cast<const ExternalDatasetBase*>(_pDataset); }
+
     private:
         const DatasetBase* _pDataset;
         size_t _fromIndex;
@@ -305,11 +340,48 @@ namespace data
 {
     using namespace logging;
 
+    namespace detail
+    {
+        // an example iterator that converts the examples of another iterator to a different example type
+        template <typename IteratorExampleType, typename SourceExampleType>
+        class ConvertingExampleIterator : public IExampleIterator<IteratorExampleType>
+        {
+        public:
+            ConvertingExampleIterator(ExampleIterator<SourceExampleType> iterator) :
+                _iterator(std::move(iterator))
+            {
+            }
+
+            bool IsValid() const override { return _iterator.IsValid(); }
+
+            void Next() override { _iterator.Next(); }
+
+            IteratorExampleType Get() const override { return _iterator.Get().template CopyAs<IteratorExampleType>(); }
+
+        private:
+            ExampleIterator<SourceExampleType> _iterator;
+        };
+    } // namespace detail
+
     template <typename ExampleType>
     ExampleIterator<ExampleType> AnyDataset::GetExampleIterator() const
     {
         auto fromIndex = _fromIndex;
         auto size = _size;
+
+        if (auto pExternalDataset = dynamic_cast<const ExternalDatasetBase*>(_pDataset))
+        {
+            auto exampleIterator = pExternalDataset->GetAutoSupervisedExampleIterator(fromIndex, size);
+            if constexpr (std::is_same_v<ExampleType, AutoSupervisedExample>)
+            {
+                return exampleIterator;
+            }
+            else
+            {
+                return ExampleIterator<ExampleType>(std::make_unique<detail::ConvertingExampleIterator<ExampleType, AutoSupervisedExample>>(std::move(exampleIterator)));
+            }
+        }
+
         auto getExampleIterator = [fromIndex, size](const auto* pDataset) { return pDataset->template GetExampleIterator<ExampleType>(fromIndex, size); };
 
         // all Dataset types for which GetAnyDataset() is called must be listed below, in the variadic template argument.
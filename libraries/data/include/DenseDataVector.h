@@ -116,6 +116,11 @@ namespace data
         /// <returns> The first index of the suffix of zeros at the end of this vector. </returns>
         size_t PrefixLength() const override { return _data.size(); }
 
+        /// <summary> Gets a pointer to the PrefixLength() stored elements. </summary>
+        ///
+        /// <returns> Pointer to the first element. </returns>
+        const ElementType* GetDataPointer() const { return _data.data(); }
+
         /// <summary> Gets the data vector type (implemented by template specialization). </summary>
         ///
         /// <returns> The data vector type. </returns>
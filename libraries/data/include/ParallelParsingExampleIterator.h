@@ -0,0 +1,248 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ParallelParsingExampleIterator.h (data)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Example.h"
+#include "ExampleIterator.h"
+#include "SequentialLineIterator.h"
+#include "SingleLineParsingExampleIterator.h"
+#include "TextLine.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <future>
+#include <istream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary>
+    /// An Example iterator that parses text on a thread pool. The stream is read in chunks that end on line
+    /// boundaries; a batch of chunks is parsed in parallel, one chunk per task, while the caller consumes the
+    /// previous batch. Each line is parsed exactly as SingleLineParsingExampleIterator would parse it, and
+    /// examples are returned in the order in which they appear in the stream. Parse errors are rethrown with
+    /// the number of the offending line in the stream.
+    /// </summary>
+    ///
+    /// <typeparam name="MetadataParserType"> Metadata parser type. </typeparam>
+    /// <typeparam name="DataVectorParserType"> DataVector parser type. </typeparam>
+    template <typename MetadataParserType, typename DataVectorParserType>
+    class ParallelParsingExampleIterator : public IExampleIterator<ParserExample<DataVectorParserType, MetadataParserType>>
+    {
+    public:
+        using ExampleType = ParserExample<DataVectorParserType, MetadataParserType>;
+
+        /// <summary> The default number of bytes in a chunk. </summary>
+        static constexpr size_t defaultChunkSize = 1 << 20;
+
+        /// <summary> Constructs a ParallelParsingExampleIterator. </summary>
+        ///
+        /// <param name="stream"> The input stream, which must outlive the iterator. </param>
+        /// <param name="metadataParser"> The metadata parser. </param>
+        /// <param name="dataVectorParser"> The data vector parser. </param>
+        /// <param name="numThreads"> The number of parsing threads, zero means one per hardware thread. </param>
+        /// <param name="chunkSize"> The approximate number of bytes parsed by each task. </param>
+        ParallelParsingExampleIterator(std::istream& stream, MetadataParserType metadataParser, DataVectorParserType dataVectorParser, size_t numThreads = 0, size_t chunkSize = defaultChunkSize);
+
+        ParallelParsingExampleIterator(const ParallelParsingExampleIterator&) = delete;
+
+        /// <summary> Returns true if the iterator is currently pointing to a valid iterate. </summary>
+        ///
+        /// <returns> true if the iterator is valid, false otherwise. </returns>
+        bool IsValid() const override { return _currentIndex < _examples.size(); }
+
+        /// <summary> Proceeds to the next example. </summary>
+        void Next() override;
+
+        /// <summary> Gets the current example. </summary>
+        ///
+        /// <returns> A SupervisedExample. </returns>
+        ExampleType Get() const override { return _examples[_currentIndex]; }
+
+    private:
+        std::vector<ExampleType> ReadAndParseBatch();
+        std::vector<ExampleType> ParseChunk(const std::string& chunk, size_t firstLineNumber) const;
+        void TakeNextBatch();
+
+        std::istream& _stream;
+        MetadataParserType _metadataParser;
+        DataVectorParserType _dataVectorParser;
+        size_t _chunkSize;
+        utilities::ThreadPool _threadPool;
+        size_t _nextLineNumber = 1;
+
+        std::vector<ExampleType> _examples;
+        size_t _currentIndex = 0;
+
+        // declared last, so that a pending batch finishes before anything it uses is destroyed
+        std::future<std::vector<ExampleType>> _nextBatch;
+    };
+
+    /// <summary>
+    /// Helper function that creates a ParallelParsingExampleIterator from a stream, a metadata parser, and a
+    /// datavector parser.
+    /// </summary>
+    ///
+    /// <typeparam name="MetadataParserType"> Metadata parser type. </typeparam>
+    /// <typeparam name="DataVectorParserType"> Data vector parser type. </typeparam>
+    /// <param name="stream"> The input stream, which must outlive the iterator. </param>
+    /// <param name="metadataParser"> The metadata parser. </param>
+    /// <param name="dataVectorParser"> The data vector parser. </param>
+    /// <param name="numThreads"> The number of parsing threads, zero means one per hardware thread. </param>
+    ///
+    /// <returns> The parallel parsing example iterator. </returns>
+    template <typename MetadataParserType, typename DataVectorParserType>
+    auto MakeParallelParsingExampleIterator(std::istream& stream, MetadataParserType metadataParser, DataVectorParserType dataVectorParser, size_t numThreads = 0);
+} // namespace data
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace data
+{
+    template <typename MetadataParserType, typename DataVectorParserType>
+    ParallelParsingExampleIterator<MetadataParserType, DataVectorParserType>::ParallelParsingExampleIterator(std::istream& stream, MetadataParserType metadataParser, DataVectorParserType dataVectorParser, size_t numThreads, size_t chunkSize) :
+        _stream(stream),
+        _metadataParser(std::move(metadataParser)),
+        _dataVectorParser(std::move(dataVectorParser)),
+        _chunkSize(chunkSize == 0 ? defaultChunkSize : chunkSize),
+        _threadPool(numThreads)
+    {
+        _nextBatch = std::async(std::launch::async, [this] { return ReadAndParseBatch(); });
+        TakeNextBatch();
+    }
+
+    template <typename MetadataParserType, typename DataVectorParserType>
+    void ParallelParsingExampleIterator<MetadataParserType, DataVectorParserType>::Next()
+    {
+        ++_currentIndex;
+        if (_currentIndex >= _examples.size())
+        {
+            TakeNextBatch();
+        }
+    }
+
+    template <typename MetadataParserType, typename DataVectorParserType>
+    void ParallelParsingExampleIterator<MetadataParserType, DataVectorParserType>::TakeNextBatch()
+    {
+        _examples.clear();
+        _currentIndex = 0;
+
+        // batches made entirely of blank and comment lines are empty, so keep going until examples show up or the stream ends
+        while (_examples.empty() && _nextBatch.valid())
+        {
+            _examples = _nextBatch.get(); // rethrows parse errors
+            if (_stream)
+            {
+                _nextBatch = std::async(std::launch::async, [this] { return ReadAndParseBatch(); });
+            }
+        }
+    }
+
+    template <typename MetadataParserType, typename DataVectorParserType>
+    auto ParallelParsingExampleIterator<MetadataParserType, DataVectorParserType>::ReadAndParseBatch() -> std::vector<ExampleType>
+    {
+        // read one chunk per thread, extending each one to the end of its last line
+        std::vector<std::string> chunks;
+        std::vector<size_t> firstLineNumbers;
+        while (chunks.size() < _threadPool.NumThreads() && _stream)
+        {
+            std::string chunk(_chunkSize, '\0');
+            _stream.read(&chunk[0], _chunkSize);
+            chunk.resize(static_cast<size_t>(_stream.gcount()));
+
+            std::string restOfLine;
+            if (_stream && std::getline(_stream, restOfLine))
+            {
+                chunk += restOfLine;
+                chunk += '\n';
+            }
+
+            if (!chunk.empty())
+            {
+                firstLineNumbers.push_back(_nextLineNumber);
+                _nextLineNumber += static_cast<size_t>(std::count(chunk.begin(), chunk.end(), '\n'));
+                chunks.push_back(std::move(chunk));
+            }
+        }
+
+        std::vector<std::vector<ExampleType>> chunkExamples(chunks.size());
+        _threadPool.ParallelFor(chunks.size(), [&](size_t chunkIndex) {
+            chunkExamples[chunkIndex] = ParseChunk(chunks[chunkIndex], firstLineNumbers[chunkIndex]);
+        });
+
+        std::vector<ExampleType> examples;
+        for (auto& chunk : chunkExamples)
+        {
+            for (auto& example : chunk)
+            {
+                examples.push_back(std::move(example));
+            }
+        }
+        return examples;
+    }
+
+    template <typename MetadataParserType, typename DataVectorParserType>
+    auto ParallelParsingExampleIterator<MetadataParserType, DataVectorParserType>::ParseChunk(const std::string& chunk, size_t firstLineNumber) const -> std::vector<ExampleType>
+    {
+        // each task parses with its own copy of the parsers
+        auto metadataParser = _metadataParser;
+        auto dataVectorParser = _dataVectorParser;
+
+        std::istringstream chunkStream(chunk);
+        SequentialLineIterator lineIterator(chunkStream);
+        std::vector<ExampleType> examples;
+        for (auto lineNumber = firstLineNumber; lineIterator.IsValid(); lineIterator.Next(), ++lineNumber)
+        {
+            // skip lines that contain just whitespace or just a comment
+            TextLine line = lineIterator.GetTextLine();
+            line.TrimLeadingWhitespace();
+            if (line.IsEndOfContent())
+            {
+                continue;
+            }
+
+            try
+            {
+                auto metaData = metadataParser.Parse(line);
+                auto dataVector = dataVectorParser.Parse(line);
+                examples.push_back(ExampleType(std::move(dataVector), std::move(metaData)));
+            }
+            catch (const utilities::DataFormatException& exception)
+            {
+                throw utilities::DataFormatException(exception.GetErrorCode(), "line " + std::to_string(lineNumber) + ": " + exception.GetMessage());
+            }
+            catch (const utilities::InputException& exception)
+            {
+                throw utilities::InputException(exception.GetErrorCode(), "line " + std::to_string(lineNumber) + ": " + exception.GetMessage());
+            }
+        }
+        return examples;
+    }
+
+    template <typename MetadataParserType, typename DataVectorParserType>
+    auto MakeParallelParsingExampleIterator(std::istream& stream, MetadataParserType metadataParser, DataVectorParserType dataVectorParser, size_t numThreads)
+    {
+        using ExampleType = ParserExample<DataVectorParserType, MetadataParserType>;
+        using IteratorType = ParallelParsingExampleIterator<MetadataParserType, DataVectorParserType>;
+        auto iterator = std::make_unique<IteratorType>(stream, std::move(metadataParser), std::move(dataVectorParser), numThreads);
+        return ExampleIterator<ExampleType>(std::move(iterator));
+    }
+} // namespace data
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,93 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PermutedDataset.h (data)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Dataset.h"
+#include "Example.h"
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary>
+    /// Gives trainers random access to the examples of an AnyDataset, in an order that can be randomly permuted.
+    /// Only the order is permuted, as a vector of example indices. Examples of an external dataset (such as a
+    /// MappedDataset) are not copied: each is materialized from the external dataset when it is visited, so the
+    /// external dataset must outlive this object. Examples of in-memory datasets are copied.
+    /// </summary>
+    class PermutedDataset
+    {
+    public:
+        PermutedDataset() = default;
+
+        /// <summary> Constructs a PermutedDataset, with its examples in their original order. </summary>
+        ///
+        /// <param name="anyDataset"> The dataset. </param>
+        PermutedDataset(const AnyDataset& anyDataset);
+
+        /// <summary> Returns the number of examples in the dataset. </summary>
+        ///
+        /// <returns> The number of examples. </returns>
+        size_t NumExamples() const { return _order.size(); }
+
+        /// <summary> Returns the index of the example at a position, in the original order of the dataset. </summary>
+        ///
+        /// <param name="position"> Zero-based position of the example in the current order. </param>
+        ///
+        /// <returns> The index of the example. </returns>
+        size_t GetExampleIndex(size_t position) const { return _order[position]; }
+
+        /// <summary> Randomly permutes the order of the examples. </summary>
+        ///
+        /// <param name="rng"> [in,out] The random number generator. </param>
+        void RandomPermute(std::default_random_engine& rng);
+
+        /// <summary> Calls a function on the example at a position. </summary>
+        ///
+        /// <typeparam name="FunctionType"> A function type that takes a const AutoSupervisedExample&amp;. </typeparam>
+        /// <param name="position"> Zero-based position of the example in the current order. </param>
+        /// <param name="function"> The function. </param>
+        template <typename FunctionType>
+        void VisitExample(size_t position, FunctionType&& function) const;
+
+    private:
+        const ExternalDatasetBase* _pExternalDataset = nullptr;
+        size_t _fromIndex = 0;
+        AutoSupervisedDataset _dataset;
+        std::vector<size_t> _order;
+    };
+} // namespace data
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace data
+{
+    template <typename FunctionType>
+    void PermutedDataset::VisitExample(size_t position, FunctionType&& function) const
+    {
+        auto index = _order[position];
+        if (_pExternalDataset != nullptr)
+        {
+            function(_pExternalDataset->GetAutoSupervisedExample(_fromIndex + index));
+        }
+        else
+        {
+            function(_dataset[index]);
+        }
+    }
+} // namespace data
+} // namespace ell
+
+#pragma endregion implementation
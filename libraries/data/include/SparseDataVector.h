@@ -190,6 +190,31 @@ namespace data
         /// <returns> The first index of the suffix of zeros at the end of this vector. </returns>
         size_t PrefixLength() const override;
 
+        /// <summary> Computes the dot product with another vector. </summary>
+        ///
+        /// <param name="vector"> The other vector. </param>
+        ///
+        /// <returns> A dot product. </returns>
+        double Dot(math::UnorientedConstVectorBase<double> vector) const override;
+
+        /// <summary> Computes the dot product with another vector. </summary>
+        ///
+        /// <param name="vector"> The other vector. </param>
+        ///
+        /// <returns> A dot product. </returns>
+        float Dot(math::UnorientedConstVectorBase<float> vector) const override;
+
+        /// <summary> Adds a transformed version of this data vector to a math::RowVector. Scaling
+        /// (ScaleTransformation) of the nonzeros is done with the sparse kernels. </summary>
+        ///
+        /// <typeparam name="policy"> The iteration policy. </typeparam>
+        /// <typeparam name="TransformationType"> Non zero transformation type, which is a functor that
+        /// takes an IndexValue and returns a double, and is applied to each element of the vector. </typeparam>
+        /// <param name="vector"> The vector. </param>
+        /// <param name="transformation"> The transformation. </param>
+        template <IterationPolicy policy, typename TransformationType>
+        void AddTransformedTo(math::RowVectorReference<double> vector, TransformationType transformation) const;
+
         /// <summary> Gets the data vector type (implemented by template specialization). </summary>
         ///
         /// <returns> The data vector type. </returns>
@@ -202,6 +227,12 @@ namespace data
 
     private:
         using DataVectorBase<SparseDataVector<ElementType, IndexListType>>::AppendElements;
+
+        // calls blockFunction(indices, values, count) on consecutive blocks of the nonzeros whose index is less
+        // than size, with the indices multiplied by increment and the values converted to ValueType
+        template <typename ValueType, typename BlockFunctionType>
+        void ForEachBlock(size_t size, size_t increment, BlockFunctionType blockFunction) const;
+
         IndexListType _indexList;
         std::vector<ElementType> _values;
     };
@@ -222,8 +253,12 @@ namespace data
 
 #pragma region implementation
 
+#include "SparseKernels.h"
+
 #include <utilities/include/Exception.h>
 
+#include <algorithm>
+
 namespace ell
 {
 namespace data
@@ -357,6 +392,91 @@ namespace data
         _values.push_back(storedValue);
     }
 
+    template <typename ElementType, typename IndexListType>
+    double SparseDataVector<ElementType, IndexListType>::Dot(math::UnorientedConstVectorBase<double> vector) const
+    {
+        double result = 0.0;
+        ForEachBlock<double>(vector.Size(), vector.GetIncrement(), [&](const size_t* indices, const double* values, size_t count) {
+            result += kernels::SparseDot(indices, values, count, vector.GetConstDataPointer());
+        });
+        return result;
+    }
+
+    template <typename ElementType, typename IndexListType>
+    float SparseDataVector<ElementType, IndexListType>::Dot(math::UnorientedConstVectorBase<float> vector) const
+    {
+        float result = 0.0;
+        ForEachBlock<float>(vector.Size(), vector.GetIncrement(), [&](const size_t* indices, const float* values, size_t count) {
+            result += kernels::SparseDot(indices, values, count, vector.GetConstDataPointer());
+        });
+        return result;
+    }
+
+    template <typename ElementType, typename IndexListType>
+    template <IterationPolicy policy, typename TransformationType>
+    void SparseDataVector<ElementType, IndexListType>::AddTransformedTo(math::RowVectorReference<double> vector, TransformationType transformation) const
+    {
+        if constexpr (policy == IterationPolicy::skipZeros && std::is_same_v<TransformationType, ScaleTransformation>)
+        {
+            ForEachBlock<double>(vector.Size(), vector.GetIncrement(), [&](const size_t* indices, const double* values, size_t count) {
+                kernels::SparseScaleAdd(transformation.scale, indices, values, count, vector.GetDataPointer());
+            });
+        }
+        else
+        {
+            DataVectorBase<SparseDataVector<ElementType, IndexListType>>::template AddTransformedTo<policy>(vector, transformation);
+        }
+    }
+
+    template <typename ElementType, typename IndexListType>
+    template <typename ValueType, typename BlockFunctionType>
+    void SparseDataVector<ElementType, IndexListType>::ForEachBlock(size_t size, size_t increment, BlockFunctionType blockFunction) const
+    {
+        constexpr size_t blockSize = 64;
+        size_t indices[blockSize];
+        ValueType convertedValues[blockSize];
+
+        auto indexIterator = _indexList.GetIterator();
+        size_t position = 0;
+        while (true)
+        {
+            auto count = indexIterator.GetBlock(indices, blockSize);
+
+            // indices are increasing, so only the last block can run past the end of the vector
+            count = static_cast<size_t>(std::lower_bound(indices, indices + count, size) - indices);
+            if (count == 0)
+            {
+                return;
+            }
+
+            if (increment != 1)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    indices[i] *= increment;
+                }
+            }
+
+            const ValueType* values;
+            if constexpr (std::is_same_v<ElementType, ValueType>)
+            {
+                values = _values.data() + position;
+            }
+            else
+            {
+                std::copy(_values.begin() + position, _values.begin() + position + count, convertedValues);
+                values = convertedValues;
+            }
+
+            blockFunction(indices, values, count);
+            position += count;
+            if (count < blockSize)
+            {
+                return;
+            }
+        }
+    }
+
     template <typename ElementType, typename IndexListType>
     size_t SparseDataVector<ElementType, IndexListType>::PrefixLength() const
     {
@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SparseKernels.h (data)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary>
+    /// Inner loops of sparse-times-dense vector operations, which work on blocks of decoded indices and values.
+    /// On x86-64, the gathers and multiply-adds use AVX2 or AVX-512 when the CPU supports them; the choice is
+    /// made at runtime, so the library doesn't need to be built for a specific CPU.
+    /// </summary>
+    namespace kernels
+    {
+        /// <summary> The instruction sets that the kernels can use. </summary>
+        enum class InstructionSet
+        {
+            scalar,
+            avx2,
+            avx512
+        };
+
+        /// <summary> Gets the best instruction set supported by the CPU. </summary>
+        ///
+        /// <returns> The instruction set. </returns>
+        InstructionSet GetSupportedInstructionSet();
+
+        /// <summary> Gets the instruction set that the kernels currently use. </summary>
+        ///
+        /// <returns> The instruction set. </returns>
+        InstructionSet GetInstructionSet();
+
+        /// <summary> Restricts the kernels to an instruction set, for testing and benchmarking. Requests for an instruction set that the CPU doesn't support fall back to the best supported one. </summary>
+        ///
+        /// <param name="instructionSet"> The instruction set. </param>
+        void SetInstructionSet(InstructionSet instructionSet);
+
+        /// <summary> Computes the sum of values[i] * vector[indices[i]]. </summary>
+        ///
+        /// <param name="indices"> The indices (already multiplied by the vector's increment). </param>
+        /// <param name="values"> The values. </param>
+        /// <param name="count"> The number of indices and values. </param>
+        /// <param name="vector"> The dense vector. </param>
+        ///
+        /// <returns> The dot product. </returns>
+        double SparseDot(const size_t* indices, const double* values, size_t count, const double* vector);
+
+        /// <summary> Computes the sum of values[i] * vector[indices[i]]. </summary>
+        ///
+        /// <param name="indices"> The indices (already multiplied by the vector's increment). </param>
+        /// <param name="values"> The values. </param>
+        /// <param name="count"> The number of indices and values. </param>
+        /// <param name="vector"> The dense vector. </param>
+        ///
+        /// <returns> The dot product. </returns>
+        float SparseDot(const size_t* indices, const float* values, size_t count, const float* vector);
+
+        /// <summary> Adds scale * values[i] to vector[indices[i]]. </summary>
+        ///
+        /// <param name="scale"> The scale. </param>
+        /// <param name="indices"> The indices (already multiplied by the vector's increment), which must be distinct. </param>
+        /// <param name="values"> The values. </param>
+        /// <param name="count"> The number of indices and values. </param>
+        /// <param name="vector"> The dense vector. </param>
+        void SparseScaleAdd(double scale, const size_t* indices, const double* values, size_t count, double* vector);
+    } // namespace kernels
+} // namespace data
+} // namespace ell
@@ -0,0 +1,263 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryDataset.cpp (data)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BinaryDataset.h"
+#include "SparseDataVector.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    namespace
+    {
+        constexpr size_t alignment = 8;
+
+        size_t AlignUp(size_t size)
+        {
+            return (size + alignment - 1) / alignment * alignment;
+        }
+
+        template <typename ValueType>
+        void WriteArray(std::ostream& stream, const ValueType* values, size_t count)
+        {
+            static const char padding[alignment] = {};
+            auto numBytes = count * sizeof(ValueType);
+            stream.write(reinterpret_cast<const char*>(values), numBytes);
+            stream.write(padding, AlignUp(numBytes) - numBytes);
+        }
+
+        template <typename ValueType>
+        const ValueType* GetArray(const char*& position, size_t count)
+        {
+            auto array = reinterpret_cast<const ValueType*>(position);
+            position += AlignUp(count * sizeof(ValueType));
+            return array;
+        }
+    } // namespace
+
+    void WriteBinaryDataset(AutoSupervisedExampleIterator exampleIterator, std::ostream& stream)
+    {
+        // write a placeholder header, which is filled in once the number of examples is known
+        auto headerPosition = stream.tellp();
+        binaryDataset::Header header = {};
+        WriteArray(stream, &header, 1);
+
+        std::vector<WeightLabel> metadata;
+        std::vector<binaryDataset::RowDescriptor> rows;
+        size_t numFeatures = 0;
+        size_t numValueWords = 0;
+
+        std::vector<IndexValue> nonzeros;
+        std::vector<uint32_t> indices;
+        std::vector<float> values;
+        while (exampleIterator.IsValid())
+        {
+            auto example = exampleIterator.Get();
+            const auto& dataVector = example.GetDataVector();
+            auto prefixLength = dataVector.PrefixLength();
+            if (prefixLength > std::numeric_limits<uint32_t>::max())
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::badData, "example is too long for the binary dataset format");
+            }
+            numFeatures = std::max(numFeatures, prefixLength);
+
+            nonzeros.clear();
+            auto sparseVector = dataVector.CopyAs<SparseFloatDataVector>();
+            auto iterator = sparseVector.GetIterator<IterationPolicy::skipZeros>();
+            while (iterator.IsValid())
+            {
+                nonzeros.push_back(iterator.Get());
+                iterator.Next();
+            }
+
+            // a sparse entry takes twice the space of a dense one
+            indices.clear();
+            if (2 * nonzeros.size() < prefixLength)
+            {
+                values.clear();
+                for (const auto& entry : nonzeros)
+                {
+                    indices.push_back(static_cast<uint32_t>(entry.index));
+                    values.push_back(static_cast<float>(entry.value));
+                }
+                rows.push_back({ numValueWords, static_cast<uint32_t>(nonzeros.size()), 1 });
+            }
+            else
+            {
+                values.assign(prefixLength, 0.0f);
+                for (const auto& entry : nonzeros)
+                {
+                    values[entry.index] = static_cast<float>(entry.value);
+                }
+                rows.push_back({ numValueWords, static_cast<uint32_t>(prefixLength), 0 });
+            }
+            stream.write(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(uint32_t));
+            stream.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+            numValueWords += indices.size() + values.size();
+
+            metadata.push_back(example.GetMetadata());
+            exampleIterator.Next();
+        }
+
+        // pad the block of values to an 8-byte boundary, and write the per-example arrays after it
+        if (numValueWords % 2 != 0)
+        {
+            uint32_t padding = 0;
+            stream.write(reinterpret_cast<const char*>(&padding), sizeof(padding));
+        }
+        WriteArray(stream, metadata.data(), metadata.size());
+        WriteArray(stream, rows.data(), rows.size());
+        auto endPosition = stream.tellp();
+
+        std::memcpy(header.magic, binaryDataset::magic, sizeof(header.magic));
+        header.version = binaryDataset::version;
+        header.numExamples = metadata.size();
+        header.numFeatures = numFeatures;
+        header.numValueWords = numValueWords;
+        stream.seekp(headerPosition);
+        WriteArray(stream, &header, 1);
+        stream.seekp(endPosition);
+        if (!stream)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "error writing binary dataset");
+        }
+    }
+
+    void WriteBinaryDataset(const AnyDataset& dataset, const std::string& filename)
+    {
+        auto stream = utilities::OpenBinaryOfstream(filename);
+        WriteBinaryDataset(dataset.GetExampleIterator<AutoSupervisedExample>(), stream);
+    }
+
+    bool IsBinaryDatasetFile(const std::string& filename)
+    {
+        auto stream = utilities::OpenBinaryIfstream(filename);
+        char fileMagic[sizeof(binaryDataset::magic)] = {};
+        stream.read(fileMagic, sizeof(fileMagic));
+        return stream && std::memcmp(fileMagic, binaryDataset::magic, sizeof(fileMagic)) == 0;
+    }
+
+    //
+    // MappedDataset::RowIterator
+    //
+
+    MappedDataset::RowIterator::RowIterator(const RowView& row) :
+        _row(row)
+    {
+        SkipZeros();
+    }
+
+    void MappedDataset::RowIterator::Next()
+    {
+        ++_position;
+        SkipZeros();
+    }
+
+    IndexValue MappedDataset::RowIterator::Get() const
+    {
+        auto index = _row.IsSparse() ? static_cast<size_t>(_row.indices[_position]) : _position;
+        return { index, static_cast<double>(_row.values[_position]) };
+    }
+
+    void MappedDataset::RowIterator::SkipZeros()
+    {
+        while (_position < _row.size && _row.values[_position] == 0.0f)
+        {
+            ++_position;
+        }
+    }
+
+    //
+    // MappedDataset
+    //
+
+    MappedDataset::MappedDataset(const std::string& filename) :
+        _file(filename)
+    {
+        auto badFile = [&filename](const std::string& reason) {
+            return utilities::InputException(utilities::InputExceptionErrors::badData, filename + " is not a valid binary dataset: " + reason);
+        };
+
+        if (_file.GetSize() < sizeof(binaryDataset::Header))
+        {
+            throw badFile("file is too small");
+        }
+
+        _header = reinterpret_cast<const binaryDataset::Header*>(_file.GetData());
+        if (std::memcmp(_header->magic, binaryDataset::magic, sizeof(_header->magic)) != 0)
+        {
+            throw badFile("bad magic number");
+        }
+        if (_header->version != binaryDataset::version)
+        {
+            throw badFile("unsupported version " + std::to_string(_header->version));
+        }
+
+        auto expectedSize = AlignUp(sizeof(binaryDataset::Header)) +
+                            AlignUp(_header->numValueWords * sizeof(uint32_t)) +
+                            AlignUp(_header->numExamples * sizeof(WeightLabel)) +
+                            AlignUp(_header->numExamples * sizeof(binaryDataset::RowDescriptor));
+        if (_file.GetSize() != expectedSize)
+        {
+            throw badFile("file size doesn't match its header");
+        }
+
+        auto position = _file.GetData() + AlignUp(sizeof(binaryDataset::Header));
+        _values = reinterpret_cast<const float*>(position);
+        _indices = GetArray<uint32_t>(position, _header->numValueWords);
+        _metadata = GetArray<WeightLabel>(position, _header->numExamples);
+        _rows = GetArray<binaryDataset::RowDescriptor>(position, _header->numExamples);
+
+        for (size_t index = 0; index < _header->numExamples; ++index)
+        {
+            const auto& row = _rows[index];
+            auto rowWords = row.isSparse ? 2 * static_cast<uint64_t>(row.size) : row.size;
+            if (row.offset > _header->numValueWords || rowWords > _header->numValueWords - row.offset)
+            {
+                throw badFile("row " + std::to_string(index) + " is out of bounds");
+            }
+        }
+    }
+
+    MappedDataset::RowView MappedDataset::GetRow(size_t index) const
+    {
+        if (index >= NumExamples())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange);
+        }
+
+        const auto& row = _rows[index];
+        if (row.isSparse)
+        {
+            return { _values + row.offset + row.size, _indices + row.offset, row.size };
+        }
+        return { _values + row.offset, nullptr, row.size };
+    }
+
+    AutoSupervisedExampleIterator MappedDataset::GetAutoSupervisedExampleIterator(size_t fromIndex, size_t size) const
+    {
+        return GetExampleIterator<AutoSupervisedExample>(fromIndex, size);
+    }
+
+    size_t MappedDataset::CorrectRangeSize(size_t fromIndex, size_t size) const
+    {
+        if (size == 0 || fromIndex + size > NumExamples())
+        {
+            return NumExamples() - fromIndex;
+        }
+        return size;
+    }
+} // namespace data
+} // namespace ell
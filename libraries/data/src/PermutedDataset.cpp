@@ -0,0 +1,45 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PermutedDataset.cpp (data)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PermutedDataset.h"
+
+#include <numeric>
+#include <utility>
+
+namespace ell
+{
+namespace data
+{
+    PermutedDataset::PermutedDataset(const AnyDataset& anyDataset) :
+        _pExternalDataset(anyDataset.GetExternalDataset()),
+        _fromIndex(anyDataset.GetFromIndex())
+    {
+        auto numExamples = anyDataset.NumExamples();
+        if (_pExternalDataset == nullptr)
+        {
+            // the size of an AnyDataset of an in-memory dataset can be zero, meaning all the way to the end
+            _dataset = AutoSupervisedDataset(anyDataset);
+            numExamples = _dataset.NumExamples();
+        }
+
+        _order.resize(numExamples);
+        std::iota(_order.begin(), _order.end(), 0);
+    }
+
+    void PermutedDataset::RandomPermute(std::default_random_engine& rng)
+    {
+        // the same sequence of swaps as Dataset::RandomPermute, so both produce the same order
+        using std::swap;
+        auto size = _order.size();
+        for (size_t i = 0; i < size; ++i)
+        {
+            std::uniform_int_distribution<size_t> dist(i, size - 1);
+            swap(_order[i], _order[dist(rng)]);
+        }
+    }
+} // namespace data
+} // namespace ell
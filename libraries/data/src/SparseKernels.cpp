@@ -0,0 +1,279 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SparseKernels.cpp (data)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SparseKernels.h"
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define ELL_SPARSE_KERNELS_X64
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define ELL_TARGET(features)
+#else
+#define ELL_TARGET(features) __attribute__((target(features)))
+#endif
+#endif
+
+namespace ell
+{
+namespace data
+{
+namespace kernels
+{
+    namespace
+    {
+        InstructionSet DetectInstructionSet()
+        {
+#if defined(ELL_SPARSE_KERNELS_X64)
+#if defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 1);
+            bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+            bool hasFma = (info[2] & (1 << 12)) != 0;
+            if (!hasOsxsave)
+            {
+                return InstructionSet::scalar;
+            }
+
+            auto xcr0 = _xgetbv(0);
+            bool osSavesAvx = (xcr0 & 0x6) == 0x6;
+            bool osSavesAvx512 = (xcr0 & 0xe6) == 0xe6;
+
+            __cpuidex(info, 7, 0);
+            bool hasAvx2 = (info[1] & (1 << 5)) != 0;
+            bool hasAvx512 = (info[1] & (1 << 16)) != 0;
+
+            if (hasAvx512 && osSavesAvx512)
+            {
+                return InstructionSet::avx512;
+            }
+            if (hasAvx2 && hasFma && osSavesAvx)
+            {
+                return InstructionSet::avx2;
+            }
+#else
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f"))
+            {
+                return InstructionSet::avx512;
+            }
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            {
+                return InstructionSet::avx2;
+            }
+#endif
+#endif
+            return InstructionSet::scalar;
+        }
+
+        const InstructionSet supportedInstructionSet = DetectInstructionSet();
+        std::atomic<InstructionSet> currentInstructionSet{ supportedInstructionSet };
+
+        //
+        // portable kernels
+        //
+
+        template <typename ValueType>
+        ValueType ScalarSparseDot(const size_t* indices, const ValueType* values, size_t count, const ValueType* vector)
+        {
+            ValueType result = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                result += values[i] * vector[indices[i]];
+            }
+            return result;
+        }
+
+        void ScalarSparseScaleAdd(double scale, const size_t* indices, const double* values, size_t count, double* vector)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                vector[indices[i]] += scale * values[i];
+            }
+        }
+
+#if defined(ELL_SPARSE_KERNELS_X64)
+        static_assert(sizeof(size_t) == sizeof(long long), "the AVX-512 kernels gather with 64-bit indices");
+
+        //
+        // AVX2 kernels, 4 elements at a time. The lanes are loaded one by one rather than with vgather, which
+        // is microcoded and slower than scalar loads on many CPUs that support AVX2.
+        //
+
+        ELL_TARGET("avx2,fma")
+        double Avx2SparseDot(const size_t* indices, const double* values, size_t count, const double* vector)
+        {
+            __m256d sum = _mm256_setzero_pd();
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m256d gathered = _mm256_set_pd(vector[indices[i + 3]], vector[indices[i + 2]], vector[indices[i + 1]], vector[indices[i]]);
+                sum = _mm256_fmadd_pd(_mm256_loadu_pd(values + i), gathered, sum);
+            }
+
+            __m128d half = _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+            double result = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+            return result + ScalarSparseDot(indices + i, values + i, count - i, vector);
+        }
+
+        ELL_TARGET("avx2,fma")
+        float Avx2SparseDot(const size_t* indices, const float* values, size_t count, const float* vector)
+        {
+            __m128 sum = _mm_setzero_ps();
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 gathered = _mm_set_ps(vector[indices[i + 3]], vector[indices[i + 2]], vector[indices[i + 1]], vector[indices[i]]);
+                sum = _mm_fmadd_ps(_mm_loadu_ps(values + i), gathered, sum);
+            }
+
+            __m128 pairs = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+            float result = _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+            return result + ScalarSparseDot(indices + i, values + i, count - i, vector);
+        }
+
+        ELL_TARGET("avx2,fma")
+        void Avx2SparseScaleAdd(double scale, const size_t* indices, const double* values, size_t count, double* vector)
+        {
+            // AVX2 has no scatter, so the updated lanes are written back one by one
+            __m256d scales = _mm256_set1_pd(scale);
+            alignas(32) double updated[4];
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m256d gathered = _mm256_set_pd(vector[indices[i + 3]], vector[indices[i + 2]], vector[indices[i + 1]], vector[indices[i]]);
+                _mm256_store_pd(updated, _mm256_fmadd_pd(scales, _mm256_loadu_pd(values + i), gathered));
+                vector[indices[i]] = updated[0];
+                vector[indices[i + 1]] = updated[1];
+                vector[indices[i + 2]] = updated[2];
+                vector[indices[i + 3]] = updated[3];
+            }
+            ScalarSparseScaleAdd(scale, indices + i, values + i, count - i, vector);
+        }
+
+        //
+        // AVX-512 kernels, 8 elements at a time
+        //
+
+        ELL_TARGET("avx512f,avx2,fma")
+        double Avx512SparseDot(const size_t* indices, const double* values, size_t count, const double* vector)
+        {
+            __m512d sum = _mm512_setzero_pd();
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m512i index = _mm512_loadu_si512(indices + i);
+                __m512d gathered = _mm512_i64gather_pd(index, vector, 8);
+                sum = _mm512_fmadd_pd(_mm512_loadu_pd(values + i), gathered, sum);
+            }
+            return _mm512_reduce_add_pd(sum) + ScalarSparseDot(indices + i, values + i, count - i, vector);
+        }
+
+        ELL_TARGET("avx512f,avx2,fma")
+        float Avx512SparseDot(const size_t* indices, const float* values, size_t count, const float* vector)
+        {
+            __m256 sum = _mm256_setzero_ps();
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m512i index = _mm512_loadu_si512(indices + i);
+                __m256 gathered = _mm512_i64gather_ps(index, vector, 4);
+                sum = _mm256_fmadd_ps(_mm256_loadu_ps(values + i), gathered, sum);
+            }
+
+            __m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+            __m128 pairs = _mm_add_ps(half, _mm_movehl_ps(half, half));
+            float result = _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+            return result + ScalarSparseDot(indices + i, values + i, count - i, vector);
+        }
+
+        ELL_TARGET("avx512f,avx2,fma")
+        void Avx512SparseScaleAdd(double scale, const size_t* indices, const double* values, size_t count, double* vector)
+        {
+            // the indices are distinct, so the scatter has no conflicts
+            __m512d scales = _mm512_set1_pd(scale);
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m512i index = _mm512_loadu_si512(indices + i);
+                __m512d gathered = _mm512_i64gather_pd(index, vector, 8);
+                _mm512_i64scatter_pd(vector, index, _mm512_fmadd_pd(scales, _mm512_loadu_pd(values + i), gathered), 8);
+            }
+            ScalarSparseScaleAdd(scale, indices + i, values + i, count - i, vector);
+        }
+#endif // ELL_SPARSE_KERNELS_X64
+    } // namespace
+
+    InstructionSet GetSupportedInstructionSet()
+    {
+        return supportedInstructionSet;
+    }
+
+    InstructionSet GetInstructionSet()
+    {
+        return currentInstructionSet;
+    }
+
+    void SetInstructionSet(InstructionSet instructionSet)
+    {
+        currentInstructionSet = instructionSet < supportedInstructionSet ? instructionSet : supportedInstructionSet;
+    }
+
+    double SparseDot(const size_t* indices, const double* values, size_t count, const double* vector)
+    {
+#if defined(ELL_SPARSE_KERNELS_X64)
+        switch (currentInstructionSet.load(std::memory_order_relaxed))
+        {
+        case InstructionSet::avx512:
+            return Avx512SparseDot(indices, values, count, vector);
+        case InstructionSet::avx2:
+            return Avx2SparseDot(indices, values, count, vector);
+        default:
+            break;
+        }
+#endif
+        return ScalarSparseDot(indices, values, count, vector);
+    }
+
+    float SparseDot(const size_t* indices, const float* values, size_t count, const float* vector)
+    {
+#if defined(ELL_SPARSE_KERNELS_X64)
+        switch (currentInstructionSet.load(std::memory_order_relaxed))
+        {
+        case InstructionSet::avx512:
+            return Avx512SparseDot(indices, values, count, vector);
+        case InstructionSet::avx2:
+            return Avx2SparseDot(indices, values, count, vector);
+        default:
+            break;
+        }
+#endif
+        return ScalarSparseDot(indices, values, count, vector);
+    }
+
+    void SparseScaleAdd(double scale, const size_t* indices, const double* values, size_t count, double* vector)
+    {
+#if defined(ELL_SPARSE_KERNELS_X64)
+        switch (currentInstructionSet.load(std::memory_order_relaxed))
+        {
+        case InstructionSet::avx512:
+            Avx512SparseScaleAdd(scale, indices, values, count, vector);
+            return;
+        case InstructionSet::avx2:
+            Avx2SparseScaleAdd(scale, indices, values, count, vector);
+            return;
+        default:
+            break;
+        }
+#endif
+        ScalarSparseScaleAdd(scale, indices, values, count, vector);
+    }
+} // namespace kernels
+} // namespace data
+} // namespace ell
@@ -15,4 +15,5 @@ void DataVectorCopyAsTests();
 void AutoDataVectorTest();
 void TransformedDataVectorTest();
 void IteratorTests();
+void SparseKernelsTests();
 } // namespace ell
\ No newline at end of file
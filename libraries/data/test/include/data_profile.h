@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     data_profile.h (data_test)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <data/include/DataVectorOperations.h>
+#include <data/include/SparseDataVector.h>
+#include <data/include/SparseKernels.h>
+
+#include <math/include/Vector.h>
+
+#include <string>
+
+using namespace ell;
+
+template <typename DataVectorType>
+void ProfileSparseDot(size_t size, size_t numNonzeros, size_t repetitions);
+
+template <typename DataVectorType>
+void ProfileSparseScaleAdd(size_t size, size_t numNonzeros, size_t repetitions);
+
+#pragma region implementation
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <typeinfo>
+
+template <typename Function>
+double GetTime(Function function, size_t repetitions)
+{
+    // warm up
+    function();
+    function();
+    function();
+
+    // timed reps
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t t = 0; t < repetitions; ++t)
+    {
+        function();
+    }
+    auto finish = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(finish - start).count();
+    return static_cast<double>(duration);
+}
+
+// times function with each instruction set and prints the speedups over the iterator-based loop
+template <typename Function>
+void PrintSpeedups(std::string description, double iterator, Function function, size_t repetitions)
+{
+    std::cout << description << "\titerator:1.0";
+    for (auto instructionSet : { data::kernels::InstructionSet::scalar, data::kernels::InstructionSet::avx2, data::kernels::InstructionSet::avx512 })
+    {
+        data::kernels::SetInstructionSet(instructionSet);
+        if (data::kernels::GetInstructionSet() != instructionSet)
+        {
+            continue;
+        }
+
+        const char* names[] = { "scalar", "avx2", "avx512" };
+        double time = GetTime(function, repetitions);
+        std::cout << "\t" << names[static_cast<int>(instructionSet)] << ":" << iterator / time;
+    }
+    data::kernels::SetInstructionSet(data::kernels::GetSupportedInstructionSet());
+    std::cout << std::endl;
+}
+
+template <typename DataVectorType>
+DataVectorType GetRandomSparseDataVector(size_t size, size_t numNonzeros)
+{
+    std::default_random_engine engine(123);
+    std::uniform_real_distribution<double> valueDistribution(-1.0, 1.0);
+    std::bernoulli_distribution isNonzero(static_cast<double>(numNonzeros) / static_cast<double>(size));
+
+    std::vector<data::IndexValue> entries;
+    for (size_t index = 0; index < size; ++index)
+    {
+        if (isNonzero(engine))
+        {
+            entries.push_back({ index, valueDistribution(engine) });
+        }
+    }
+    return DataVectorType(entries);
+}
+
+template <typename DataVectorType>
+void ProfileSparseDot(size_t size, size_t numNonzeros, size_t repetitions)
+{
+    auto u = GetRandomSparseDataVector<DataVectorType>(size, numNonzeros);
+    math::RowVector<double> w(size);
+    w.Fill(0.5);
+
+    volatile double result = 0;
+    double iterator = GetTime([&]() {
+        double sum = 0;
+        auto iter = u.template GetIterator<data::IterationPolicy::skipZeros>();
+        while (iter.IsValid())
+        {
+            auto entry = iter.Get();
+            sum += entry.value * w[entry.index];
+            iter.Next();
+        }
+        result = sum;
+    },
+                              repetitions);
+
+    std::string description = "SparseDot<" + std::string(typeid(DataVectorType).name()) + ">(" + std::to_string(size) + ", " + std::to_string(numNonzeros) + ")";
+    PrintSpeedups(description, iterator, [&]() { result = u.Dot(w); }, repetitions);
+}
+
+template <typename DataVectorType>
+void ProfileSparseScaleAdd(size_t size, size_t numNonzeros, size_t repetitions)
+{
+    auto u = GetRandomSparseDataVector<DataVectorType>(size, numNonzeros);
+    math::RowVector<double> w(size);
+
+    double iterator = GetTime([&]() {
+        auto iter = u.template GetIterator<data::IterationPolicy::skipZeros>();
+        while (iter.IsValid())
+        {
+            auto entry = iter.Get();
+            w[entry.index] += 0.001 * entry.value;
+            iter.Next();
+        }
+    },
+                              repetitions);
+
+    std::string description = "SparseScaleAdd<" + std::string(typeid(DataVectorType).name()) + ">(" + std::to_string(size) + ", " + std::to_string(numNonzeros) + ")";
+    PrintSpeedups(description, iterator, [&]() { w += 0.001 * u; }, repetitions);
+}
+
+#pragma endregion implementation
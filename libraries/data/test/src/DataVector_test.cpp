@@ -14,7 +14,9 @@
 #include <data/include/DenseDataVector.h>
 #include <data/include/SparseBinaryDataVector.h>
 #include <data/include/SparseDataVector.h>
+#include <data/include/SparseKernels.h>
 
+#include <math/include/Matrix.h>
 #include <math/include/Vector.h>
 
 #include <testing/include/testing.h>
@@ -22,6 +24,7 @@
 #include <algorithm> // for std::transform
 #include <cmath>
 #include <iostream>
+#include <random>
 #include <sstream>
 #include <string>
 
@@ -266,4 +269,87 @@ void IteratorTests()
     IteratorTest<data::SparseByteDataVector>();
     IteratorTest<data::SparseBinaryDataVector>();
 }
-} // namespace ell
\ No newline at end of file
+
+template <typename DataVectorType>
+void SparseKernelsTest(data::kernels::InstructionSet instructionSet)
+{
+    // a few hundred nonzeros, with index gaps of one, two, and three bytes
+    std::default_random_engine engine(17);
+    std::uniform_int_distribution<int> valueDistribution(-9, 9);
+    std::vector<data::IndexValue> entries;
+    size_t index = 0;
+    for (size_t i = 0; i < 300; ++i)
+    {
+        index += (i % 50 == 49) ? 70000 : (i % 10 == 9) ? 300 : 1 + i % 3;
+        entries.push_back({ index, static_cast<double>(valueDistribution(engine)) });
+    }
+    DataVectorType u(entries);
+    auto size = u.PrefixLength();
+    auto a = u.ToArray(size);
+
+    math::RowVector<double> w(size);
+    math::RowVector<float> z(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        w[i] = static_cast<double>(i % 7) - 3.0;
+        z[i] = static_cast<float>(i % 5) - 2.0f;
+    }
+
+    data::kernels::SetInstructionSet(instructionSet);
+    std::string name = "SparseKernelsTest<" + std::string(typeid(DataVectorType).name()) + ">(" + std::to_string(static_cast<int>(data::kernels::GetInstructionSet())) + ")";
+
+    double expectedDot = 0;
+    float expectedFloatDot = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        expectedDot += a[i] * w[i];
+        expectedFloatDot += static_cast<float>(a[i]) * z[i];
+    }
+    testing::ProcessTest(name + ": Dot()", testing::IsEqual(u.Dot(w), expectedDot));
+    testing::ProcessTest(name + ": Dot() with float", testing::IsEqual(u.Dot(z), expectedFloatDot, 1.0e-3f));
+
+    // a vector shorter than the data vector truncates it
+    auto prefix = w.GetSubVector(0, size / 2);
+    double expectedPrefixDot = 0;
+    for (size_t i = 0; i < size / 2; ++i)
+    {
+        expectedPrefixDot += a[i] * w[i];
+    }
+    testing::ProcessTest(name + ": Dot() with shorter vector", testing::IsEqual(u.Dot(prefix), expectedPrefixDot));
+
+    // v += s * u
+    math::RowVector<double> v(w);
+    v += 2.5 * u;
+    bool isAddCorrect = true;
+    for (size_t i = 0; i < size; ++i)
+    {
+        isAddCorrect = isAddCorrect && testing::IsEqual(v[i], w[i] + 2.5 * a[i]);
+    }
+    testing::ProcessTest(name + ": operator += scaled vector", isAddCorrect);
+
+    // a row of a column-major matrix has an increment greater than one
+    math::ColumnMatrix<double> m(3, size);
+    auto row = m.GetRow(1);
+    row.CopyFrom(w);
+    testing::ProcessTest(name + ": Dot() with strided vector", testing::IsEqual(u.Dot(row), expectedDot));
+    row += -1.0 * u;
+    bool isStridedAddCorrect = true;
+    for (size_t i = 0; i < size; ++i)
+    {
+        isStridedAddCorrect = isStridedAddCorrect && testing::IsEqual(m(1, i), w[i] - a[i]) && m(0, i) == 0 && m(2, i) == 0;
+    }
+    testing::ProcessTest(name + ": operator += scaled vector with strided vector", isStridedAddCorrect);
+
+    data::kernels::SetInstructionSet(data::kernels::GetSupportedInstructionSet());
+}
+
+void SparseKernelsTests()
+{
+    for (auto instructionSet : { data::kernels::InstructionSet::scalar, data::kernels::InstructionSet::avx2, data::kernels::InstructionSet::avx512 })
+    {
+        SparseKernelsTest<data::SparseDoubleDataVector>(instructionSet);
+        SparseKernelsTest<data::SparseFloatDataVector>(instructionSet);
+        SparseKernelsTest<data::SparseShortDataVector>(instructionSet);
+    }
+}
+} // namespace ell
@@ -10,13 +10,16 @@
 
 #include <common/include/DataLoaders.h>
 
+#include <data/include/BinaryDataset.h>
 #include <data/include/Dataset.h>
+#include <data/include/PermutedDataset.h>
 
 #include <utilities/include/Files.h>
 #include <utilities/include/StringUtil.h>
 
 #include <testing/include/testing.h>
 
+#include <random>
 #include <sstream>
 
 namespace ell
@@ -119,4 +122,107 @@ void DatasetSerializationTests()
     }
     testing::ProcessTest(utilities::FormatString("DatasetSerializationTest data %d errors", errors), errors == 0);
 }
+
+void BinaryDatasetTests()
+{
+    // a mix of dense rows, sparse rows, and an empty row
+    data::AutoSupervisedDataset dataset1;
+    dataset1.AddExample(data::AutoSupervisedExample(data::AutoDataVector{ 1, 2, 0, 3.5, 4 }, data::WeightLabel{ 1, 1 }));
+    dataset1.AddExample(data::AutoSupervisedExample(data::AutoDataVector{ { 3, 0.5 }, { 40, -2 } }, data::WeightLabel{ 2, -1 }));
+    dataset1.AddExample(data::AutoSupervisedExample(data::AutoDataVector(std::vector<double>{}), data::WeightLabel{ 0.5, 1 }));
+    dataset1.AddExample(data::AutoSupervisedExample(data::AutoDataVector{ 0, 0, 7 }, data::WeightLabel{ 1, -1 }));
+
+    const std::string filename("dataset1.ellbd");
+    data::WriteBinaryDataset(dataset1.GetAnyDataset(0, dataset1.NumExamples()), filename);
+    testing::ProcessTest("BinaryDatasetTest IsBinaryDatasetFile", data::IsBinaryDatasetFile(filename));
+
+    data::MappedDataset dataset2(filename);
+    testing::ProcessTest("BinaryDatasetTest size", dataset1.NumExamples() == dataset2.NumExamples());
+    testing::ProcessTest("BinaryDatasetTest features", dataset1.NumFeatures() == dataset2.NumFeatures());
+    testing::ProcessTest("BinaryDatasetTest row layout", !dataset2.GetRow(0).IsSparse() && dataset2.GetRow(1).IsSparse() && dataset2.GetRow(1).size == 2);
+
+    // read the mapped dataset back through AnyDataset, as a trainer would
+    data::AutoSupervisedDataset dataset3(dataset2.GetAnyDataset());
+    int errors = 0;
+    if (dataset1.NumExamples() == dataset3.NumExamples())
+    {
+        for (size_t i = 0; i < dataset1.NumExamples(); i++)
+        {
+            const auto& e1 = dataset1.GetExample(i);
+            const auto& e3 = dataset3.GetExample(i);
+
+            auto sameVector = testing::IsEqual(e1.GetDataVector().ToArray(), e3.GetDataVector().ToArray());
+            auto sameLabel = e1.GetMetadata().label == e3.GetMetadata().label;
+            auto sameWeight = e1.GetMetadata().weight == e3.GetMetadata().weight;
+            if (!(sameVector && sameLabel && sameWeight))
+            {
+                errors++;
+            }
+        }
+    }
+    testing::ProcessTest(utilities::FormatString("BinaryDatasetTest data %d errors", errors), errors == 0 && dataset1.NumExamples() == dataset3.NumExamples());
+
+    // trainers that need another example type get converted examples
+    data::DenseSupervisedDataset dataset4(dataset2.GetAnyDataset(1, 2));
+    auto sameDenseRows = dataset4.NumExamples() == 2 && testing::IsEqual(dataset4.GetExample(0).GetDataVector().ToArray(), dataset1.GetExample(1).GetDataVector().ToArray()) && dataset4.GetExample(1).GetMetadata().weight == 0.5;
+    testing::ProcessTest("BinaryDatasetTest dense examples", sameDenseRows);
+
+    // text files are not binary datasets, and can't be mapped as such
+    const std::string textFilename("dataset1.txt");
+    auto stream = utilities::OpenOfstream(textFilename);
+    dataset1.Print(stream);
+    stream.close();
+    testing::ProcessTest("BinaryDatasetTest text file", !data::IsBinaryDatasetFile(textFilename));
+
+    bool threw = false;
+    try
+    {
+        data::MappedDataset badDataset(textFilename);
+    }
+    catch (const utilities::InputException&)
+    {
+        threw = true;
+    }
+    testing::ProcessTest("BinaryDatasetTest bad file", threw);
+}
+
+void PermutedDatasetTests()
+{
+    data::AutoSupervisedDataset dataset1;
+    for (int i = 0; i < 20; ++i)
+    {
+        dataset1.AddExample(data::AutoSupervisedExample(data::AutoDataVector{ static_cast<double>(i), 0, 1 }, data::WeightLabel{ 1, static_cast<double>(i) }));
+    }
+
+    const std::string filename("permuted.ellbd");
+    data::WriteBinaryDataset(dataset1.GetAnyDataset(0, dataset1.NumExamples()), filename);
+    data::MappedDataset mappedDataset(filename);
+
+    // permuting the mapped examples' indices gives the same order as permuting a copy of the examples
+    data::PermutedDataset dataset2(mappedDataset.GetAnyDataset(5, 10));
+    data::AutoSupervisedDataset dataset3(dataset1.GetAnyDataset(5, 10));
+    std::default_random_engine rng2(17);
+    std::default_random_engine rng3(17);
+    int errors = 0;
+    for (int epoch = 0; epoch < 2; ++epoch)
+    {
+        dataset2.RandomPermute(rng2);
+        dataset3.RandomPermute(rng3);
+        for (size_t i = 0; i < dataset2.NumExamples(); ++i)
+        {
+            const auto& e3 = dataset3.GetExample(i);
+            dataset2.VisitExample(i, [&](const data::AutoSupervisedExample& e2) {
+                if (!testing::IsEqual(e2.GetDataVector().ToArray(), e3.GetDataVector().ToArray()) || e2.GetMetadata().label != e3.GetMetadata().label)
+                {
+                    errors++;
+                }
+            });
+            if (dataset2.GetExampleIndex(i) + 5 != static_cast<size_t>(e3.GetMetadata().label))
+            {
+                errors++;
+            }
+        }
+    }
+    testing::ProcessTest(utilities::FormatString("PermutedDatasetTest %d errors", errors), errors == 0 && dataset2.NumExamples() == dataset3.NumExamples());
+}
 } // namespace ell
@@ -11,6 +11,7 @@
 #include <data/include/AutoDataVector.h>
 #include <data/include/Dataset.h>
 #include <data/include/GeneralizedSparseParsingIterator.h>
+#include <data/include/ParallelParsingExampleIterator.h>
 #include <data/include/SequentialLineIterator.h>
 #include <data/include/SingleLineParsingExampleIterator.h>
 #include <data/include/TextLine.h>
@@ -142,4 +143,54 @@ void SingleFileParseTest()
     testing::ProcessTest("SingleFileParse test2", dataset[1].GetMetadata().label == -1 && testing::IsEqual(dataset[1].GetDataVector().ToArray(), { 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 3 }));
     testing::ProcessTest("SingleFileParse test3", dataset[2].GetMetadata().label == 1 && testing::IsEqual(dataset[2].GetDataVector().ToArray(), { 2.7, 0, 0, 0, -0.3, 0, 0, 0, 0, 0, 3.14 }));
 }
-} // namespace ell
\ No newline at end of file
+
+void ParallelParseTest()
+{
+    // many short lines, mixed with blank lines and comments, so that lines straddle chunk boundaries
+    std::string string;
+    for (int index = 0; index < 500; ++index)
+    {
+        string += std::to_string(index % 2 == 0 ? 1 : -1) + "\t" + std::to_string(index % 7) + ":" + std::to_string(index) + " 12:1.5\n";
+        if (index % 13 == 0)
+        {
+            string += "\n    // comment\n";
+        }
+    }
+    string += "1\t3:7"; // no newline at the end
+
+    using MetadataParserType = data::LabelParser;
+    using DataVectorParserType = data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>;
+
+    std::stringstream sequentialStream(string);
+    auto sequentialDataset = data::MakeDataset(data::MakeSingleLineParsingExampleIterator(data::SequentialLineIterator(sequentialStream), MetadataParserType(), DataVectorParserType()));
+
+    for (size_t numThreads : { 1, 3 })
+    {
+        std::stringstream parallelStream(string);
+        auto iterator = std::make_unique<data::ParallelParsingExampleIterator<MetadataParserType, DataVectorParserType>>(parallelStream, MetadataParserType(), DataVectorParserType(), numThreads, 64);
+        auto parallelDataset = data::MakeDataset(data::AutoSupervisedExampleIterator(std::move(iterator)));
+
+        bool isSame = sequentialDataset.NumExamples() == 501 && parallelDataset.NumExamples() == sequentialDataset.NumExamples();
+        for (size_t index = 0; isSame && index < sequentialDataset.NumExamples(); ++index)
+        {
+            isSame = sequentialDataset[index].GetMetadata().label == parallelDataset[index].GetMetadata().label &&
+                     testing::IsEqual(sequentialDataset[index].GetDataVector().ToArray(), parallelDataset[index].GetDataVector().ToArray());
+        }
+        testing::ProcessTest("ParallelParse test with " + std::to_string(numThreads) + " threads", isSame);
+    }
+
+    // parse errors surface on the consuming thread, with the line number in the stream rather than in the chunk
+    std::stringstream badStream("1 0:1\n\n// comment\n1 0:1\n1 0:1\n1 0:x\n1 0:1\n");
+    std::string message;
+    try
+    {
+        auto iterator = std::make_unique<data::ParallelParsingExampleIterator<MetadataParserType, DataVectorParserType>>(badStream, MetadataParserType(), DataVectorParserType(), 2, 4);
+        data::MakeDataset(data::AutoSupervisedExampleIterator(std::move(iterator)));
+    }
+    catch (const utilities::Exception& exception)
+    {
+        message = exception.GetMessage();
+    }
+    testing::ProcessTest("ParallelParse error test", message.find("line 6:") == 0);
+}
+} // namespace ell
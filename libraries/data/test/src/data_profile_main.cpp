@@ -0,0 +1,32 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     data_profile_main.cpp (data)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "data_profile.h"
+
+using namespace ell;
+
+template <typename DataVectorType>
+void RunProfile()
+{
+    const size_t repetitions = 10;
+
+    ProfileSparseDot<DataVectorType>(1000, 100, 1000 * repetitions);
+    ProfileSparseDot<DataVectorType>(100000, 1000, 100 * repetitions);
+    ProfileSparseDot<DataVectorType>(1000000, 100000, repetitions);
+
+    ProfileSparseScaleAdd<DataVectorType>(1000, 100, 1000 * repetitions);
+    ProfileSparseScaleAdd<DataVectorType>(100000, 1000, 100 * repetitions);
+    ProfileSparseScaleAdd<DataVectorType>(1000000, 100000, repetitions);
+}
+
+int main()
+{
+    RunProfile<data::SparseDoubleDataVector>();
+    RunProfile<data::SparseFloatDataVector>();
+
+    return 0;
+}
@@ -24,12 +24,16 @@ int main()
     AutoDataVectorTest();
     TransformedDataVectorTest();
     IteratorTests();
+    SparseKernelsTests();
     ExampleCopyAsTests();
     DatasetCastingTests();
     DatasetSerializationTests();
+    BinaryDatasetTests();
+    PermutedDatasetTests();
     DataVectorParseTest();
     AutoDataVectorParseTest();
     SingleFileParseTest();
+    ParallelParseTest();
 
     if (testing::DidTestFail())
     {
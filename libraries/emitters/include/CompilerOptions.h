@@ -61,6 +61,15 @@ namespace emitters
         /// <summary> Maximum num of parallel threads. </summary>
         int maxThreads = 4;
 
+        /// <summary> Give each thread pool worker its own range of each task array's tasks, which idle workers steal from, instead of handing out every task from one locked queue. </summary>
+        bool useWorkStealing = true;
+
+        /// <summary> Number of tasks to split each parallel loop into per thread. Values above 1 let idle thread pool workers pick up remaining work when iterations are uneven. </summary>
+        int tasksPerThread = 1;
+
+        /// <summary> Number of threads to optimize and JIT the emitted module on. Values above 1 split the module into that many partitions, which are only inlined into each other after optimization. </summary>
+        int compileThreads = 1;
+
         /// <summary> Allow emitting more efficient code that isn't necessarily IEEE-754 compatible. </summary>
         bool useFastMath = true;
 
@@ -13,10 +13,14 @@
 #include <utilities/include/Exception.h>
 
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
 #include <llvm/IR/Module.h>
+#include <llvm/Object/ObjectFile.h>
+#include <llvm/Support/MemoryBuffer.h>
 
 #include <functional>
 #include <type_traits>
+#include <vector>
 
 namespace ell
 {
@@ -43,7 +47,9 @@ namespace emitters
         ///
         /// <param name="pModule"> The module. </param>
         /// <param name="verify"> Indicates if the execution engine should run a verification pass before running the code. </param>
-        IRExecutionEngine(std::unique_ptr<llvm::Module> pModule, bool verify = false, llvm::CodeGenOpt::Level optLevel = llvm::CodeGenOpt::Level::Default);
+        /// <param name="pObjectCache"> An optional cache to look up the compiled code for modules in before generating it. It must outlive the execution engine. </param>
+        /// <param name="codegenThreads"> The number of threads to generate code on. Values above 1 split the module into partitions that are compiled to objects concurrently, and cached separately. </param>
+        IRExecutionEngine(std::unique_ptr<llvm::Module> pModule, bool verify = false, llvm::CodeGenOpt::Level optLevel = llvm::CodeGenOpt::Level::Default, llvm::ObjectCache* pObjectCache = nullptr, int codegenThreads = 1);
 
         /// <summary> Destructor </summary>
         ~IRExecutionEngine();
@@ -53,6 +59,11 @@ namespace emitters
         /// <param name="pModule"> The module to add. </param>
         void AddModule(std::unique_ptr<llvm::Module> pModule);
 
+        /// <summary> Add object code that was compiled ahead of time, such as a module loaded from an object cache, to the execution engine. </summary>
+        ///
+        /// <param name="object"> The object code. </param>
+        void AddObject(std::unique_ptr<llvm::MemoryBuffer> object);
+
         /// <summary>
         /// Return the address of a named function, JITTing code as needed. Returns 0 if not found.
         /// </summary>
@@ -132,6 +143,8 @@ namespace emitters
 
         std::unique_ptr<llvm::EngineBuilder> _pBuilder;
         std::unique_ptr<llvm::ExecutionEngine> _pEngine;
+        llvm::ObjectCache* _pObjectCache = nullptr;
+        std::vector<llvm::object::OwningBinary<llvm::object::ObjectFile>> _objectFiles; // object code compiled ahead of time, added when the engine is created
     };
 } // namespace emitters
 } // namespace ell
@@ -1359,6 +1359,16 @@ namespace emitters
         /// <returns> A task array object representing the running tasks. </param>
         IRTaskArray StartTasks(LLVMFunction taskFunction, const std::vector<std::vector<LLVMValue>>& arguments);
 
+        /// <summary>
+        /// Sets whether tasks started on the thread pool from the current thread run on it instead, one after another. Set this
+        /// while the current thread does its own share of the work alongside tasks it started, until it waits for them.
+        /// </summary>
+        ///
+        /// <param name="runInline"> A boolean value: whether to run tasks started from the current thread inline. </param>
+        ///
+        /// <returns> The previous value of the setting, for restoring it. </returns>
+        LLVMValue SetRunTasksInline(LLVMValue runInline);
+
         //
         // Standard C library function calls
         //
@@ -204,6 +204,12 @@ namespace emitters
         /// <summary> Ensure that the given variable is loaded into a register. </summary>
         LLVMValue LoadVariable(Variable& var);
 
+        /// <summary> Binds a global variable to a value that was emitted by other means, so that EnsureEmitted returns it. </summary>
+        ///
+        /// <param name="var"> The variable, which must be a named global that hasn't been emitted yet. </param>
+        /// <param name="pValue"> The value to use for the variable, typically a constant pointer into another global. </param>
+        void SetEmittedVariable(Variable& var, LLVMValue pValue);
+
         //
         // Variable and Constant creation
         //
@@ -580,6 +586,11 @@ namespace emitters
         /// <param name="optimizer"> The optimizer. </param>
         void Optimize(IROptimizer& optimizer);
 
+        /// <summary> Get the number of partitions the module's functions were optimized in, or 1 if it wasn't partitioned. </summary>
+        ///
+        /// <returns> The number of optimization partitions. </returns>
+        int GetNumOptimizationPartitions() const { return _numOptimizationPartitions; }
+
         /// <summary>
         /// Get the target machine and arch for this module. The target machine aids the system in optimizations and
         /// Jitting etc.
@@ -655,6 +666,11 @@ namespace emitters
         /// <summary> Gets the LLVM data layout object for the current module. </summary>
         const llvm::DataLayout& GetTargetDataLayout() const;
 
+        /// <summary> Gets the mutable globals that the thread pool has added to the module, which hold the state of the pool rather than of a model. </summary>
+        ///
+        /// <returns> The thread pool's global variables, or an empty vector if the thread pool hasn't been used. </returns>
+        std::vector<llvm::GlobalVariable*> GetThreadPoolGlobalVariables() const;
+
         /// <summary> Can this module emitter still be used to add functions to the module? </summary>
         ///
         /// <returns> true if active, false if not. </returns>
@@ -723,6 +739,7 @@ namespace emitters
 
     private:
         friend class IRFunctionEmitter;
+        friend class IRParallelForLoopEmitter;
 
         //
         // Internal variable and function creation implementation
@@ -825,6 +842,7 @@ namespace emitters
         std::unique_ptr<IRThreadPool> _threadPool; // A pool of worker threads -- gets initialized the first time it's used (?)
         std::unique_ptr<IRProfiler> _profiler;
         int _globalStringIndex = 0;
+        int _numOptimizationPartitions = 1;
 
         // Info to modify how code is written out
         std::vector<std::pair<std::string, std::string>> _preprocessorDefinitions;
@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRObjectCache.h (emitters)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace emitters
+{
+    /// <summary>
+    /// A persistent, content-addressed cache of the object code the JIT produces. Each module that should be cached
+    /// is given a key (typically a hash of everything that determines its code), and its object code is stored in a
+    /// file named after the key in the cache directory. When a module with a known key is JIT-compiled again, even in
+    /// another process, the object code is loaded from the file instead of running the LLVM code generator.
+    /// A module that is compiled in partitions is stored as one object file per partition, named after the key and
+    /// the partition (see `GetPartitionModuleIdentifier`). When the files in the directory grow beyond the size
+    /// limit, the least recently used ones are deleted.
+    /// </summary>
+    class IRObjectCache : public llvm::ObjectCache
+    {
+    public:
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="directory"> The directory to keep the object files in. It is created if it doesn't exist. </param>
+        /// <param name="maxSizeInBytes"> The size that the object files in the directory are trimmed to after a new one is added. </param>
+        IRObjectCache(const std::string& directory, size_t maxSizeInBytes);
+
+        /// <summary> Sets the key to cache a module's object code under. Modules without a key aren't cached. </summary>
+        ///
+        /// <param name="module"> The module. Only its identifier is used, so it may be a clone of the module that is compiled. </param>
+        /// <param name="key"> The key, which must be a valid file name, such as one returned from `GetKey`. </param>
+        void SetModuleKey(const llvm::Module& module, const std::string& key);
+
+        /// <summary> Indicates if the cache has object code for a key, either for the whole module or for all of its partitions. </summary>
+        ///
+        /// <param name="key"> The key. </param>
+        ///
+        /// <returns> `true` if there is cached object code for the key, else `false`. </returns>
+        bool HasObject(const std::string& key) const;
+
+        /// <summary> Loads the object code cached for a key, so it can be added to a JIT without the module it was compiled from. </summary>
+        ///
+        /// <param name="key"> The key. </param>
+        ///
+        /// <returns> The object code of the whole module, or of each of its partitions, or an empty vector if it isn't in the cache. </returns>
+        std::vector<std::unique_ptr<llvm::MemoryBuffer>> GetObjects(const std::string& key);
+
+        /// <summary> Deletes the least recently used object files until the rest fit in the size limit. </summary>
+        void Trim();
+
+        /// <summary> Gets a cache key for the given content: the hex digits of its SHA-1 hash. </summary>
+        ///
+        /// <param name="content"> A description of everything that determines the object code. </param>
+        ///
+        /// <returns> The key. </returns>
+        static std::string GetKey(const std::string& content);
+
+        /// <summary> Gets the identifier to give a partition of a module, so that it is cached under the module's key. </summary>
+        ///
+        /// <param name="moduleIdentifier"> The identifier of the module that was partitioned. </param>
+        /// <param name="index"> The index of the partition. </param>
+        /// <param name="numPartitions"> The number of partitions the module was split into. </param>
+        ///
+        /// <returns> The partition's module identifier. </returns>
+        static std::string GetPartitionModuleIdentifier(const std::string& moduleIdentifier, int index, int numPartitions);
+
+        /// <summary> Called by the JIT after it has compiled a module. </summary>
+        void notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef object) override;
+
+        /// <summary> Called by the JIT before it compiles a module. Returns the cached object code, or `nullptr` to have it compiled. </summary>
+        std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) override;
+
+    private:
+        bool TryGetModuleKey(const llvm::Module* module, std::string& key) const;
+        std::string GetObjectPath(const std::string& key) const;
+        std::vector<std::string> GetObjectPaths(const std::string& key) const;
+        std::unique_ptr<llvm::MemoryBuffer> LoadObject(const std::string& path) const;
+
+        std::string _directory;
+        size_t _maxSizeInBytes;
+        std::map<std::string, std::string> _moduleKeys;
+        mutable std::mutex _mutex;
+    };
+} // namespace emitters
+} // namespace ell
@@ -41,6 +41,19 @@ namespace emitters
         /// <summary> Optimize the module. </summary>
         void OptimizeModule(llvm::Module* pModule);
 
+        /// <summary>
+        /// Optimize the module by splitting it into partitions that are optimized concurrently, each in its own
+        /// LLVM context, and then linking the optimized partitions back into the module. Calls across partitions are
+        /// inlined by a final pass over the linked module, which doesn't revisit the loop optimizations. The definitions in the module are replaced, so any `llvm::Function` or
+        /// `llvm::GlobalVariable` pointers into it obtained before the call are invalid afterwards.
+        /// </summary>
+        ///
+        /// <param name="pModule"> The module. </param>
+        /// <param name="numPartitions"> The number of partitions (and threads) to use. </param>
+        ///
+        /// <returns> The number of partitions that had functions to optimize. </returns>
+        int OptimizeModuleInPartitions(llvm::Module* pModule, int numPartitions);
+
     private:
         IRModuleEmitter& _module;
         llvm::legacy::PassManager _modulePasses;
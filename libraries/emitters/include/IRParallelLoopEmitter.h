@@ -52,6 +52,7 @@ namespace emitters
 
         void EmitLoop(int begin, int end, int increment, const ParallelLoopOptions& options, const std::vector<LLVMValue>& capturedValues, BodyFunction body);
         void EmitLoop(IRLocalScalar begin, IRLocalScalar end, IRLocalScalar increment, const ParallelLoopOptions& options, const std::vector<LLVMValue>& capturedValues, BodyFunction body);
+        void EmitThreadPoolLoop(IRLocalScalar begin, IRLocalScalar end, IRLocalScalar increment, const std::vector<LLVMValue>& capturedValues, BodyFunction body);
 
         IRFunctionEmitter GetTaskFunction(const std::vector<LLVMValue>& capturedValues, BodyFunction body);
 
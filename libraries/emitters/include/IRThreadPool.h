@@ -13,6 +13,7 @@
 
 #include <llvm/IR/GlobalVariable.h>
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -26,6 +27,9 @@ namespace emitters
     class IRThreadPoolTaskQueue;
     class IRThreadPoolTaskArray;
 
+    /// <summary> Type of function that emits the arguments for one of a runtime number of tasks, given the task's index. </summary>
+    using TaskArgumentsFunction = std::function<std::vector<LLVMValue>(IRFunctionEmitter& function, LLVMValue taskIndex)>;
+
     //
     // IRThreadPool: Simple thread pool class that schedules tasks in blocks, and associated classes:
     //
@@ -99,10 +103,13 @@ namespace emitters
         IRThreadPoolTask GetTask(IRFunctionEmitter& function, LLVMValue taskIndex);
 
     private:
+        friend class IRThreadPool;
         friend class IRThreadPoolTaskQueue;
         IRThreadPoolTaskArray(IRThreadPoolTaskQueue& taskQueue);
         void Initialize(IRFunctionEmitter& function);
         void SetTasks(IRFunctionEmitter& function, LLVMFunction taskFunction, const std::vector<std::vector<LLVMValue>>& taskArgs);
+        void SetTasks(IRFunctionEmitter& function, LLVMFunction taskFunction, LLVMValue numTasks, TaskArgumentsFunction getArguments);
+        void FreeHeapStorage(IRFunctionEmitter& function);
         llvm::StructType* GetTaskArrayDataType(IRModuleEmitter& module);
         LLVMValue GetTaskFunctionPointer(IRFunctionEmitter& function);
         LLVMValue GetReturnValuesStoragePointer(IRFunctionEmitter& function);
@@ -116,6 +123,8 @@ namespace emitters
             returnValues,
             argStorage,
             argStructSize,
+            heapStorage, // buffer for tasks whose number is only known at runtime, reused while it is big enough
+            heapStorageSize,
             // nextArray
         };
         LLVMValue _taskArrayData = nullptr;
@@ -140,6 +149,16 @@ namespace emitters
         /// <returns> A task array object representing the running tasks. </param>
         IRThreadPoolTaskArray& StartTasks(IRFunctionEmitter& function, LLVMFunction taskFunction, const std::vector<std::vector<LLVMValue>>& arguments);
 
+        /// <summary> Starts a number of tasks, only known at runtime, in the thread pool. </summary>
+        ///
+        /// <param name="function"> The function currently being emitted into. </param>
+        /// <param name="taskFunction"> The function to run asynchronously with many different arguments. </param>
+        /// <param name="numTasks"> The number of tasks to start. </param>
+        /// <param name="getArguments"> Emits the arguments for the task with the given index. </param>
+        ///
+        /// <returns> A task array object representing the running tasks. </param>
+        IRThreadPoolTaskArray& StartTasks(IRFunctionEmitter& function, LLVMFunction taskFunction, LLVMValue numTasks, TaskArgumentsFunction getArguments);
+
         /// <summary> Pop a task off the task queue, waiting for one to become available if necessary. </summary>
         ///
         /// <param name="function"> The function currently being emitted into. </param>
@@ -160,8 +179,9 @@ namespace emitters
     private:
         friend class IRThreadPool;
         IRThreadPoolTaskQueue(); // create an empty queue
-        void Initialize(IRFunctionEmitter& function); // initializes the task array
+        void Initialize(IRFunctionEmitter& function, LLVMValue numThreads); // initializes the task array, and a task range per thread when work stealing
         LLVMValue GetDataStruct() { return _queueData; }
+        void PublishTasks(IRFunctionEmitter& function, LLVMValue numTasks); // called with the queue mutex held, after the task array is set
         LLVMValue DecrementCountField(IRFunctionEmitter& function, LLVMValue fieldPtr);
         llvm::StructType* GetTaskQueueDataType(IRModuleEmitter& module) const;
 
@@ -181,6 +201,15 @@ namespace emitters
 
         bool IsInitialized() const;
         void NotifyWaitingClients(IRFunctionEmitter& function);
+
+        // Work stealing
+        void DistributeTasks(IRFunctionEmitter& function, LLVMValue numTasks);
+        LLVMFunction GetClaimTaskFunction(IRModuleEmitter& module);
+        IRThreadPoolTask ClaimTask(IRFunctionEmitter& function, LLVMValue workerIndex);
+        void FinishTask(IRFunctionEmitter& function);
+        LLVMValue WaitForNewTasks(IRFunctionEmitter& function, LLVMValue seenGenerationPointer);
+        void FreeTaskRanges(IRFunctionEmitter& function);
+
         void LockQueueMutex(IRFunctionEmitter& function);
         void UnlockQueueMutex(IRFunctionEmitter& function);
         void ShutDown(IRFunctionEmitter& function);
@@ -192,9 +221,15 @@ namespace emitters
             workFinishedCondVar,
             unscheduledCount,
             unfinishedCount,
-            shutdownFlag
+            shutdownFlag,
+            generation, // incremented each time tasks are started, so idle workers know when to look for more
+            taskRanges, // heap array with a packed (begin, end) range of task indices for each worker, when work stealing
+            numTaskRanges
         };
         LLVMValue _queueData = nullptr; // a struct with the above fields
+        bool _useWorkStealing = false;
+        LLVMFunction _claimTaskFunction = nullptr;
+        llvm::GlobalVariable* _runTasksInline = nullptr; // thread-local bool owned by the IRThreadPool: tasks submitted from this thread run on it
         IRThreadPoolTaskArray _tasks;
     };
 
@@ -211,7 +246,7 @@ namespace emitters
         /// <param name="module"> The module being emitted. </param>
         IRThreadPool(IRModuleEmitter& module);
 
-        /// <summary> Starts an array of tasks in the thread pool. </summary>
+        /// <summary> Starts an array of tasks in the thread pool, starting the worker threads first if necessary. </summary>
         ///
         /// <param name="function"> The function currently being emitted into. </param>
         /// <param name="taskFunction"> The function to run asynchronously with many different arguments. </param>
@@ -220,19 +255,59 @@ namespace emitters
         /// <returns> A task array object representing the running tasks. </param>
         IRThreadPoolTaskArray& AddTasks(IRFunctionEmitter& function, LLVMFunction taskFunction, const std::vector<std::vector<LLVMValue>>& arguments);
 
+        /// <summary> Starts a number of tasks, only known at runtime, in the thread pool, starting the worker threads first if necessary. </summary>
+        ///
+        /// <param name="function"> The function currently being emitted into. </param>
+        /// <param name="taskFunction"> The function to run asynchronously with many different arguments. </param>
+        /// <param name="numTasks"> The number of tasks to start. </param>
+        /// <param name="getArguments"> Emits the arguments for the task with the given index. </param>
+        ///
+        /// <returns> A task array object representing the running tasks. </param>
+        IRThreadPoolTaskArray& AddTasks(IRFunctionEmitter& function, LLVMFunction taskFunction, LLVMValue numTasks, TaskArgumentsFunction getArguments);
+
+        /// <summary> Gets the number of worker threads in the pool, which can be changed at runtime until the pool starts. </summary>
+        ///
+        /// <param name="function"> The function currently being emitted into. </param>
+        ///
+        /// <returns> The number of threads, as an int32 value. </returns>
+        LLVMValue GetNumThreads(IRFunctionEmitter& function);
+
+        /// <summary>
+        /// Sets whether tasks submitted from the current thread are run on it, one after another, instead of on the pool.
+        /// The pool has a single task array, so this is always the case on the worker threads. A thread that runs its own
+        /// share of the work while tasks it started are running on the pool must set it too, until it waits for them.
+        /// The return values of tasks that are run inline aren't kept, so only tasks with no return value should be nested.
+        /// </summary>
+        ///
+        /// <param name="function"> The function currently being emitted into. </param>
+        /// <param name="runInline"> A boolean value: whether to run tasks submitted from the current thread inline. </param>
+        ///
+        /// <returns> The previous value of the setting, for restoring it. </returns>
+        LLVMValue SetRunTasksInline(IRFunctionEmitter& function, LLVMValue runInline);
+
         /// <summary> Tell the thread pool to finish and kill the treads. </summary>
         void ShutDown(IRFunctionEmitter& function);
 
+        /// <summary> Gets the mutable globals that the pool has added to the module, which hold the state of the pool rather than of a model. </summary>
+        ///
+        /// <returns> The pool's global variables, or an empty vector if the pool hasn't been used. </returns>
+        std::vector<llvm::GlobalVariable*> GetGlobalVariables() const;
+
     private:
-        void Initialize(); // Allocates threads and adds global initializer and finalizer functions
+        void Initialize(); // Adds the pool's globals, the lazy initializer and the finalizer function
         bool IsInitialized() const;
-        void AddGlobalInitializer();
+        void AddInitializer();
         void AddGlobalFinalizer();
+        void AddSetMaxThreadsFunction();
         LLVMFunction GetWorkerThreadFunction();
 
         IRModuleEmitter& _module;
-        size_t _maxThreads = 0;
-        llvm::GlobalVariable* _threads = nullptr; // global array of pthread_t
+        int _maxThreads = 0; // default number of threads, from the compiler options
+        llvm::GlobalVariable* _numThreads = nullptr; // global int: number of threads to start, settable at runtime
+        llvm::GlobalVariable* _state = nullptr; // global int: not started, starting or started, changed atomically so only one caller starts the threads
+        llvm::GlobalVariable* _threads = nullptr; // global pointer to a heap-allocated array of pthread_t
+        llvm::GlobalVariable* _runTasksInline = nullptr; // thread-local bool: true on the worker threads, and on threads running their share of a parallel region
+        LLVMFunction _initFunction = nullptr;
 
         // task queue
         IRThreadPoolTaskQueue _taskQueue;
@@ -9,11 +9,16 @@
 
 #include "EmitterTypes.h"
 
+#include <memory>
+#include <string>
+
 namespace llvm
 {
 class Function;
 class FunctionType;
 class GlobalVariable;
+class LLVMContext;
+class Module;
 class StructType;
 class Type;
 class Value;
@@ -77,6 +82,21 @@ namespace emitters
     /// <returns> The VariableType or VariableType::Custom for anything that doesn't map. </returns>
     VariableType ToVariableType(LLVMType type);
 
+    /// <summary> Serialize a module to bitcode, e.g. to hand it to a thread with an LLVM context of its own. </summary>
+    ///
+    /// <param name="module"> The module. </param>
+    ///
+    /// <returns> The module's bitcode. </returns>
+    std::string WriteModuleToBitcode(const llvm::Module& module);
+
+    /// <summary> Deserialize a module written by WriteModuleToBitcode into the given context. </summary>
+    ///
+    /// <param name="bitcode"> The module's bitcode. </param>
+    /// <param name="context"> The context to create the module in. </param>
+    ///
+    /// <returns> The module. </returns>
+    std::unique_ptr<llvm::Module> ReadModuleFromBitcode(const std::string& bitcode, llvm::LLVMContext& context);
+
     /// <summary> Initializes LLVM </summary>
     void InitializeLLVM();
 
@@ -25,6 +25,15 @@ namespace emitters
         std::string features = "";
         size_t numBits = 0;
 
+        /// <summary> The size of the L1 data cache in bytes, or 0 if it isn't known. </summary>
+        size_t l1CacheSize = 0;
+
+        /// <summary> The size of the L2 cache in bytes, or 0 if it isn't known. </summary>
+        size_t l2CacheSize = 0;
+
+        /// <summary> The size of the L3 cache in bytes, or 0 if it isn't known (or there is none). </summary>
+        size_t l3CacheSize = 0;
+
         /// <summary> Helper function to test whether the TargetDevice has a particular feature </summary>
         /// <remarks> If this is filled in by LLVM for the host target, the possible features are target dependent
         /// and include, but are not limited to, the following:
@@ -70,6 +70,9 @@ namespace emitters
         parallelize = properties.GetOrParseEntry<bool>("parallelize", parallelize);
         useThreadPool = properties.GetOrParseEntry<bool>("useThreadPool", useThreadPool);
         maxThreads = properties.GetOrParseEntry<int>("maxThreads", maxThreads);
+        useWorkStealing = properties.GetOrParseEntry<bool>("useWorkStealing", useWorkStealing);
+        tasksPerThread = properties.GetOrParseEntry<int>("tasksPerThread", tasksPerThread);
+        compileThreads = properties.GetOrParseEntry<int>("compileThreads", compileThreads);
         useFastMath = properties.GetOrParseEntry<bool>("useFastMath", useFastMath);
         debug = properties.GetOrParseEntry<bool>("debug", debug);
         globalValueAlignment = properties.GetOrParseEntry<int>("globalValueAlignment", globalValueAlignment);
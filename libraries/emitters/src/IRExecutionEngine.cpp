@@ -8,11 +8,19 @@
 
 #include "IRExecutionEngine.h"
 #include "IRModuleEmitter.h"
+#include "IRObjectCache.h"
 
+#include <utilities/include/ThreadPool.h>
 #include <utilities/include/TypeAliases.h>
 
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/Support/SmallVectorMemoryBuffer.h>
 #include <llvm/Support/TargetSelect.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/SplitModule.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <iostream>
@@ -40,18 +48,159 @@ namespace emitters
         throw emitters::EmitterException(emitters::EmitterError::unexpected, msg);
     }
 
+    namespace
+    {
+        bool IsStaticConstructorTable(const llvm::GlobalValue* global)
+        {
+            return global->getName() == "llvm.global_ctors" || global->getName() == "llvm.global_dtors";
+        }
+
+        llvm::object::OwningBinary<llvm::object::ObjectFile> LoadObjectFile(std::unique_ptr<llvm::MemoryBuffer> memoryBuffer)
+        {
+            auto objectFile = llvm::object::ObjectFile::createObjectFile(memoryBuffer->getMemBufferRef());
+            if (!objectFile)
+            {
+                throw EmitterException(EmitterError::unexpected, "Unable to load object code: " + llvm::toString(objectFile.takeError()));
+            }
+            return { std::move(objectFile.get()), std::move(memoryBuffer) };
+        }
+
+        // Compiles a module partition to an object file in a context of its own, with the target machine MCJIT would use
+        llvm::object::OwningBinary<llvm::object::ObjectFile> CompilePartition(const std::string& bitcode, bool verify, llvm::CodeGenOpt::Level optLevel)
+        {
+            llvm::LLVMContext context;
+            auto module = ReadModuleFromBitcode(bitcode, context);
+
+            llvm::EngineBuilder builder;
+            builder.setEngineKind(llvm::EngineKind::JIT).setOptLevel(optLevel).setEmulatedTLS(true);
+            std::unique_ptr<llvm::TargetMachine> targetMachine(builder.selectTarget(llvm::Triple(module->getTargetTriple()), "", "", llvm::SmallVector<std::string, 1>()));
+            if (!targetMachine)
+            {
+                throw EmitterException(EmitterError::unexpected, "Unable to allocate target machine");
+            }
+            module->setDataLayout(targetMachine->createDataLayout());
+
+            llvm::SmallVector<char, 0> objectBuffer;
+            llvm::raw_svector_ostream objectStream(objectBuffer);
+            llvm::legacy::PassManager codegenPasses;
+            llvm::MCContext* machineCodeContext;
+            if (targetMachine->addPassesToEmitMC(codegenPasses, machineCodeContext, objectStream, !verify))
+            {
+                throw EmitterException(EmitterError::unexpected, "Target doesn't support emitting machine code");
+            }
+            codegenPasses.run(*module);
+
+            return LoadObjectFile(std::make_unique<llvm::SmallVectorMemoryBuffer>(std::move(objectBuffer)));
+        }
+
+        bool HasStaticConstructors(const llvm::Module& module)
+        {
+            return std::any_of(module.global_begin(), module.global_end(), [](const llvm::GlobalVariable& global) { return IsStaticConstructorTable(&global); });
+        }
+
+        // Splits the module into partitions that are compiled to objects concurrently, or loaded from the object
+        // cache if it has them. What's left of the module declares everything and defines only the static
+        // constructor and destructor tables, since MCJIT runs those from the IR of its modules.
+        std::unique_ptr<llvm::Module> CompileInPartitions(std::unique_ptr<llvm::Module> pModule, int numPartitions, bool verify, llvm::CodeGenOpt::Level optLevel, llvm::ObjectCache* pObjectCache, std::vector<llvm::object::OwningBinary<llvm::object::ObjectFile>>& objectFiles)
+        {
+            // Partitions refer to each other's definitions by name, so everything needs one
+            for (auto& global : pModule->global_values())
+            {
+                if (!global.hasName())
+                {
+                    global.setName("ell_unnamed");
+                }
+            }
+
+            std::vector<std::unique_ptr<llvm::Module>> partitions;
+            llvm::SplitModule(llvm::CloneModule(*pModule), static_cast<unsigned>(numPartitions), [&partitions](std::unique_ptr<llvm::Module> partition) {
+                std::vector<llvm::GlobalVariable*> staticConstructorTables;
+                for (auto& global : partition->globals())
+                {
+                    if (IsStaticConstructorTable(&global))
+                    {
+                        staticConstructorTables.push_back(&global);
+                    }
+                }
+                for (auto table : staticConstructorTables)
+                {
+                    table->eraseFromParent();
+                }
+                partitions.push_back(std::move(partition));
+            });
+
+            const auto numSplitPartitions = static_cast<int>(partitions.size());
+            objectFiles.resize(partitions.size());
+            std::vector<size_t> uncachedPartitions;
+            std::vector<std::string> bitcode(partitions.size());
+            for (int index = 0; index < numSplitPartitions; ++index)
+            {
+                auto& partition = partitions[index];
+                partition->setModuleIdentifier(IRObjectCache::GetPartitionModuleIdentifier(pModule->getModuleIdentifier(), index, numSplitPartitions));
+                if (auto cachedObject = pObjectCache ? pObjectCache->getObject(partition.get()) : nullptr)
+                {
+                    objectFiles[index] = LoadObjectFile(std::move(cachedObject));
+                }
+                else
+                {
+                    bitcode[index] = WriteModuleToBitcode(*partition);
+                    uncachedPartitions.push_back(index);
+                }
+            }
+
+            if (!uncachedPartitions.empty())
+            {
+                utilities::ThreadPool threadPool(uncachedPartitions.size());
+                threadPool.ParallelFor(uncachedPartitions.size(), [&](size_t task) {
+                    auto index = uncachedPartitions[task];
+                    objectFiles[index] = CompilePartition(bitcode[index], verify, optLevel);
+                });
+            }
+
+            if (pObjectCache)
+            {
+                for (auto index : uncachedPartitions)
+                {
+                    pObjectCache->notifyObjectCompiled(partitions[index].get(), objectFiles[index].getBinary()->getMemoryBufferRef());
+                }
+            }
+
+            llvm::ValueToValueMapTy valueMap;
+            return llvm::CloneModule(*pModule, valueMap, IsStaticConstructorTable);
+        }
+    } // namespace
+
     IRExecutionEngine::IRExecutionEngine(IRModuleEmitter&& module, bool verify, llvm::CodeGenOpt::Level optLevel) :
         IRExecutionEngine(module.TransferOwnership(), verify, optLevel)
     {
     }
 
-    IRExecutionEngine::IRExecutionEngine(std::unique_ptr<llvm::Module> pModule, bool verify, llvm::CodeGenOpt::Level optLevel)
+    IRExecutionEngine::IRExecutionEngine(std::unique_ptr<llvm::Module> pModule, bool verify, llvm::CodeGenOpt::Level optLevel, llvm::ObjectCache* pObjectCache, int codegenThreads)
     {
-        auto debugPrintFunction = pModule->getFunction("DebugPrint");
-
         llvm::InitializeNativeTarget();
         llvm::InitializeNativeTargetAsmPrinter();
 
+        // Cached object code may be loaded without the IR it was compiled from, and then there's nothing
+        // to run static constructors from, so modules that have them aren't cached
+        if (HasStaticConstructors(*pModule))
+        {
+            pObjectCache = nullptr;
+        }
+
+        auto numDefinedFunctions = std::count_if(pModule->begin(), pModule->end(), [](const llvm::Function& function) { return !function.isDeclaration(); });
+        auto numPartitions = std::min<int>(codegenThreads, static_cast<int>(numDefinedFunctions));
+        if (numPartitions > 1)
+        {
+            // Each partition is cached on its own, and what's left of the module isn't cached at all
+            pModule = CompileInPartitions(std::move(pModule), numPartitions, verify, optLevel, pObjectCache, _objectFiles);
+        }
+        else
+        {
+            _pObjectCache = pObjectCache;
+        }
+
+        auto debugPrintFunction = pModule->getFunction("DebugPrint");
+
         _pBuilder = std::make_unique<llvm::EngineBuilder>(std::move(pModule));
         _pBuilder->setEngineKind(llvm::EngineKind::JIT).setVerifyModules(verify).setOptLevel(optLevel).setEmulatedTLS(true);
 
@@ -85,6 +234,19 @@ namespace emitters
         _pEngine->addModule(std::move(pModule));
     }
 
+    void IRExecutionEngine::AddObject(std::unique_ptr<llvm::MemoryBuffer> object)
+    {
+        auto objectFile = LoadObjectFile(std::move(object));
+        if (_pEngine)
+        {
+            _pEngine->addObjectFile(std::move(objectFile));
+        }
+        else
+        {
+            _objectFiles.push_back(std::move(objectFile));
+        }
+    }
+
     void IRExecutionEngine::PerformInitialization()
     {
         _pEngine->runStaticConstructorsDestructors(false);
@@ -157,6 +319,19 @@ namespace emitters
         {
             auto pEngine = _pBuilder->create();
             _pEngine.reset(pEngine);
+
+            // The cache has to be in place before the static constructors are run, since that compiles the module
+            if (_pObjectCache)
+            {
+                _pEngine->setObjectCache(_pObjectCache);
+            }
+
+            // The static constructors live in the module's partitions, so those have to be loaded before they run
+            for (auto& objectFile : _objectFiles)
+            {
+                _pEngine->addObjectFile(std::move(objectFile));
+            }
+            _objectFiles.clear();
             PerformInitialization();
         }
     }
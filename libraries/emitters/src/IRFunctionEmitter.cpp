@@ -1387,6 +1387,11 @@ namespace emitters
         }
     }
 
+    LLVMValue IRFunctionEmitter::SetRunTasksInline(LLVMValue runInline)
+    {
+        return GetModule().GetThreadPool().SetRunTasksInline(*this, runInline);
+    }
+
     LLVMValue IRFunctionEmitter::Malloc(VariableType type, int64_t size)
     {
         _pModuleEmitter->DeclareMalloc();
@@ -428,6 +428,15 @@ namespace emitters
         return pVal;
     }
 
+    void IRModuleEmitter::SetEmittedVariable(Variable& var, LLVMValue pValue)
+    {
+        if (var.Scope() != VariableScope::global || !var.HasEmittedName())
+        {
+            throw EmitterException(EmitterError::variableScopeNotSupported);
+        }
+        _globals.Add(var.EmittedName(), pValue);
+    }
+
     LLVMValue IRModuleEmitter::LoadVariable(Variable& var)
     {
         LLVMValue pVal = EnsureEmitted(var);
@@ -920,8 +929,17 @@ namespace emitters
                 throw EmitterException(EmitterError::unexpected, "Module verification failed.\n\n" + errorString);
             }
 
-            optimizer.BeginOptimizeFunctions();
             auto module = GetLLVMModule();
+            auto numDefinedFunctions = std::count_if(module->begin(), module->end(), [](const llvm::Function& function) { return !function.isDeclaration(); });
+            auto numPartitions = std::min<int>(compilerOptions.compileThreads, static_cast<int>(numDefinedFunctions));
+            if (numPartitions > 1)
+            {
+                _numOptimizationPartitions = optimizer.OptimizeModuleInPartitions(module, numPartitions);
+                Log() << "Optimized module in " << _numOptimizationPartitions << " partitions" << EOL;
+                return;
+            }
+
+            optimizer.BeginOptimizeFunctions();
             for (auto& function : *module)
             {
                 optimizer.OptimizeFunction(&function);
@@ -1072,6 +1090,11 @@ namespace emitters
         return GetLLVMModule()->getDataLayout();
     }
 
+    std::vector<llvm::GlobalVariable*> IRModuleEmitter::GetThreadPoolGlobalVariables() const
+    {
+        return _threadPool->GetGlobalVariables();
+    }
+
     void IRModuleEmitter::AddPreprocessorDefinition(const std::string& name, const std::string& value)
     {
         _preprocessorDefinitions.emplace_back(name, value);
@@ -0,0 +1,286 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRObjectCache.cpp (emitters)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRObjectCache.h"
+#include "EmitterException.h"
+
+#include <utilities/include/Logger.h>
+
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Support/SHA1.h>
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace ell
+{
+namespace emitters
+{
+    using namespace utilities::logging;
+    using utilities::logging::Log;
+
+    namespace
+    {
+        const char* objectFileExtension = ".o";
+        const char* partitionSeparator = "-of-";
+
+        std::string GetPartitionSuffix(int index, int numPartitions)
+        {
+            return "." + std::to_string(index) + partitionSeparator + std::to_string(numPartitions);
+        }
+
+        struct CachedObjectFile
+        {
+            fs::path path;
+            fs::file_time_type lastUsed;
+            uintmax_t size;
+        };
+
+        std::vector<CachedObjectFile> GetCachedObjectFiles(const std::string& directory)
+        {
+            std::vector<CachedObjectFile> result;
+            std::error_code ec;
+            for (fs::directory_iterator it(fs::u8path(directory), ec), end; !ec && it != end; it.increment(ec))
+            {
+                std::error_code entryError;
+                const auto& path = it->path();
+                if (path.extension() != objectFileExtension || !fs::is_regular_file(path, entryError))
+                {
+                    continue;
+                }
+
+                auto size = fs::file_size(path, entryError);
+                auto lastUsed = fs::last_write_time(path, entryError);
+                if (!entryError)
+                {
+                    result.push_back({ path, lastUsed, size });
+                }
+            }
+            return result;
+        }
+    } // namespace
+
+    IRObjectCache::IRObjectCache(const std::string& directory, size_t maxSizeInBytes) :
+        _directory(directory),
+        _maxSizeInBytes(maxSizeInBytes)
+    {
+        std::error_code ec;
+        fs::create_directories(fs::u8path(_directory), ec);
+        if (ec)
+        {
+            throw EmitterException(EmitterError::unexpected, "Unable to create the JIT cache directory " + _directory);
+        }
+    }
+
+    void IRObjectCache::SetModuleKey(const llvm::Module& module, const std::string& key)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _moduleKeys[module.getModuleIdentifier()] = key;
+    }
+
+    bool IRObjectCache::HasObject(const std::string& key) const
+    {
+        return !GetObjectPaths(key).empty();
+    }
+
+    std::vector<std::unique_ptr<llvm::MemoryBuffer>> IRObjectCache::GetObjects(const std::string& key)
+    {
+        std::vector<std::unique_ptr<llvm::MemoryBuffer>> objects;
+        for (const auto& path : GetObjectPaths(key))
+        {
+            auto object = LoadObject(path);
+            if (!object)
+            {
+                return {};
+            }
+            objects.push_back(std::move(object));
+        }
+        return objects;
+    }
+
+    void IRObjectCache::Trim()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto files = GetCachedObjectFiles(_directory);
+        uintmax_t totalSize = 0;
+        for (const auto& file : files)
+        {
+            totalSize += file.size;
+        }
+
+        // oldest first
+        std::sort(files.begin(), files.end(), [](const CachedObjectFile& a, const CachedObjectFile& b) { return a.lastUsed < b.lastUsed; });
+        for (const auto& file : files)
+        {
+            if (totalSize <= _maxSizeInBytes)
+            {
+                break;
+            }
+
+            std::error_code ec;
+            if (fs::remove(file.path, ec))
+            {
+                Log() << "Evicting " << file.path.u8string() << " from the JIT cache" << EOL;
+                totalSize -= file.size;
+            }
+        }
+    }
+
+    std::string IRObjectCache::GetKey(const std::string& content)
+    {
+        llvm::SHA1 hasher;
+        hasher.update(content);
+        return llvm::toHex(hasher.result(), true);
+    }
+
+    std::string IRObjectCache::GetPartitionModuleIdentifier(const std::string& moduleIdentifier, int index, int numPartitions)
+    {
+        return moduleIdentifier + GetPartitionSuffix(index, numPartitions);
+    }
+
+    void IRObjectCache::notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef object)
+    {
+        std::string key;
+        if (!TryGetModuleKey(module, key))
+        {
+            return;
+        }
+
+        // Write to a temporary file first, so another process never sees a partially-written object file
+        auto path = fs::u8path(GetObjectPath(key));
+        auto tempPath = path;
+        tempPath += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::binary);
+            out.write(object.getBufferStart(), object.getBufferSize());
+            if (!out)
+            {
+                Log() << "Unable to write " << tempPath.u8string() << " to the JIT cache" << EOL;
+                return;
+            }
+        }
+
+        std::error_code ec;
+        fs::rename(tempPath, path, ec);
+        if (ec)
+        {
+            fs::remove(tempPath, ec);
+            return;
+        }
+
+        Log() << "Added " << path.u8string() << " to the JIT cache" << EOL;
+        Trim();
+    }
+
+    std::unique_ptr<llvm::MemoryBuffer> IRObjectCache::getObject(const llvm::Module* module)
+    {
+        std::string key;
+        if (!TryGetModuleKey(module, key))
+        {
+            return nullptr;
+        }
+
+        return LoadObject(GetObjectPath(key));
+    }
+
+    bool IRObjectCache::TryGetModuleKey(const llvm::Module* module, std::string& key) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto& identifier = module->getModuleIdentifier();
+        auto it = _moduleKeys.find(identifier);
+        if (it != _moduleKeys.end())
+        {
+            key = it->second;
+            return true;
+        }
+
+        // A partition of a module with a key is cached under that key, followed by the partition suffix
+        auto suffixPos = identifier.rfind('.');
+        if (suffixPos == std::string::npos)
+        {
+            return false;
+        }
+        it = _moduleKeys.find(identifier.substr(0, suffixPos));
+        if (it == _moduleKeys.end())
+        {
+            return false;
+        }
+        key = it->second + identifier.substr(suffixPos);
+        return true;
+    }
+
+    std::string IRObjectCache::GetObjectPath(const std::string& key) const
+    {
+        return (fs::u8path(_directory) / (key + objectFileExtension)).u8string();
+    }
+
+    std::vector<std::string> IRObjectCache::GetObjectPaths(const std::string& key) const
+    {
+        std::error_code ec;
+        auto wholeModulePath = GetObjectPath(key);
+        if (fs::is_regular_file(fs::u8path(wholeModulePath), ec))
+        {
+            return { wholeModulePath };
+        }
+
+        // The name of the first partition's file holds the number of partitions
+        const auto firstPartitionPrefix = key + ".0" + partitionSeparator;
+        int numPartitions = 0;
+        for (fs::directory_iterator it(fs::u8path(_directory), ec), end; !ec && it != end; it.increment(ec))
+        {
+            auto fileName = it->path().filename().u8string();
+            if (it->path().extension() != objectFileExtension || fileName.compare(0, firstPartitionPrefix.size(), firstPartitionPrefix) != 0)
+            {
+                continue;
+            }
+
+            auto count = fileName.substr(firstPartitionPrefix.size(), fileName.size() - firstPartitionPrefix.size() - std::string(objectFileExtension).size());
+            if (!count.empty() && std::all_of(count.begin(), count.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; }))
+            {
+                numPartitions = std::stoi(count);
+                break;
+            }
+        }
+
+        // Partitions may have been evicted separately, and object code is only usable if none are missing
+        std::vector<std::string> paths;
+        for (int index = 0; index < numPartitions; ++index)
+        {
+            auto path = GetObjectPath(key + GetPartitionSuffix(index, numPartitions));
+            if (!fs::is_regular_file(fs::u8path(path), ec))
+            {
+                return {};
+            }
+            paths.push_back(path);
+        }
+        return paths;
+    }
+
+    std::unique_ptr<llvm::MemoryBuffer> IRObjectCache::LoadObject(const std::string& path) const
+    {
+        auto buffer = llvm::MemoryBuffer::getFile(path);
+        if (!buffer)
+        {
+            return nullptr;
+        }
+
+        // Touch the file, so that eviction drops the least recently used entries
+        std::error_code ec;
+        fs::last_write_time(fs::u8path(path), fs::file_time_type::clock::now(), ec);
+
+        Log() << "Loaded " << path << " from the JIT cache" << EOL;
+        return std::move(buffer.get());
+    }
+} // namespace emitters
+} // namespace ell
@@ -9,19 +9,31 @@
 #include "IROptimizer.h"
 #include "IRModuleEmitter.h"
 #include "LLVMInclude.h"
+#include "LLVMUtilities.h"
+
+#include <utilities/include/ThreadPool.h>
 
 #include <llvm/Analysis/TargetLibraryInfo.h>
 #include <llvm/Analysis/TargetTransformInfo.h>
 #include <llvm/CodeGen/TargetPassConfig.h>
 #include <llvm/IR/IRPrintingPasses.h>
 #include <llvm/IR/Module.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Support/raw_ostream.h>
 #include <llvm/Target/TargetMachine.h>
+#include <llvm/Transforms/InstCombine/InstCombine.h>
 #include <llvm/Transforms/IPO.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 #include <llvm/Transforms/Scalar.h>
 #include <llvm/Transforms/Scalar/GVN.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/SplitModule.h>
 
+#include <algorithm>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace ell
 {
@@ -40,45 +52,91 @@ namespace emitters
         (void)_functionPasses.doFinalization();
     }
 
-    void IROptimizer::AddStandardPasses()
+    namespace
     {
-        auto targetMachine = _module.GetTargetMachine();
-        if (!targetMachine)
+        void AddStandardPasses(llvm::TargetMachine* targetMachine, const llvm::Module& module, llvm::legacy::PassManager& modulePasses, llvm::legacy::FunctionPassManager& functionPasses)
         {
-            throw EmitterException(EmitterError::unexpected, "Unable to allocate target machine");
-        }
-        
-        auto& llvmTargetMachine = static_cast<LLVMTargetMachine&>(*targetMachine);
-        auto config = static_cast<llvm::Pass*>(llvmTargetMachine.createPassConfig(_modulePasses));
-        _modulePasses.add(config);
+            if (!targetMachine)
+            {
+                throw EmitterException(EmitterError::unexpected, "Unable to allocate target machine");
+            }
 
-        llvm::TargetLibraryInfoImpl targetLibraryInfo(llvm::Triple(_module.GetLLVMModule()->getTargetTriple()));
-        _modulePasses.add(new llvm::TargetLibraryInfoWrapperPass(targetLibraryInfo));
+            auto& llvmTargetMachine = static_cast<LLVMTargetMachine&>(*targetMachine);
+            auto config = static_cast<llvm::Pass*>(llvmTargetMachine.createPassConfig(modulePasses));
+            modulePasses.add(config);
 
-        // Add internal analysis passes from the target machine.
-        _modulePasses.add(llvm::createTargetTransformInfoWrapperPass(targetMachine ? targetMachine->getTargetIRAnalysis()
-                                                                                   : llvm::TargetIRAnalysis()));
+            llvm::TargetLibraryInfoImpl targetLibraryInfo(llvm::Triple(module.getTargetTriple()));
+            modulePasses.add(new llvm::TargetLibraryInfoWrapperPass(targetLibraryInfo));
 
-        _functionPasses.add(llvm::createTargetTransformInfoWrapperPass(
-            targetMachine ? targetMachine->getTargetIRAnalysis() : llvm::TargetIRAnalysis()));
+            // Add internal analysis passes from the target machine.
+            modulePasses.add(llvm::createTargetTransformInfoWrapperPass(targetMachine->getTargetIRAnalysis()));
 
-        _functionPasses.add(llvm::createVerifierPass());
+            functionPasses.add(llvm::createTargetTransformInfoWrapperPass(targetMachine->getTargetIRAnalysis()));
 
-        llvm::PassManagerBuilder builder;
-        builder.OptLevel = 3;
-        builder.SizeLevel = 0;
-        builder.Inliner = llvm::createFunctionInliningPass(builder.OptLevel, builder.SizeLevel, false);
-        builder.LoopVectorize = true;
-        builder.SLPVectorize = true;
-        builder.DisableUnrollLoops = false;
+            functionPasses.add(llvm::createVerifierPass());
+
+            llvm::PassManagerBuilder builder;
+            builder.OptLevel = 3;
+            builder.SizeLevel = 0;
+            builder.Inliner = llvm::createFunctionInliningPass(builder.OptLevel, builder.SizeLevel, false);
+            builder.LoopVectorize = true;
+            builder.SLPVectorize = true;
+            builder.DisableUnrollLoops = false;
 
-        if (targetMachine)
-        {
             targetMachine->adjustPassManager(builder);
+
+            builder.populateFunctionPassManager(functionPasses);
+            builder.populateModulePassManager(modulePasses);
+        }
+
+        // Runs the standard optimization passes over a module partition in a context of its own
+        std::string OptimizePartition(const std::string& bitcode, llvm::TargetMachine* targetMachine)
+        {
+            llvm::LLVMContext context;
+            auto module = ReadModuleFromBitcode(bitcode, context);
+
+            llvm::legacy::PassManager modulePasses;
+            llvm::legacy::FunctionPassManager functionPasses(module.get());
+            AddStandardPasses(targetMachine, *module, modulePasses, functionPasses);
+
+            (void)functionPasses.doInitialization();
+            for (auto& function : *module)
+            {
+                functionPasses.run(function);
+            }
+            (void)functionPasses.doFinalization();
+            modulePasses.run(*module);
+
+            return WriteModuleToBitcode(*module);
         }
 
-        builder.populateFunctionPassManager(_functionPasses);
-        builder.populateModulePassManager(_modulePasses);
+        // Inlines the calls that crossed partition boundaries, now that the callees are visible, and cleans up after it
+        void RunPostLinkPasses(llvm::Module& module, llvm::TargetMachine* targetMachine)
+        {
+            llvm::legacy::PassManager postLinkPasses;
+            llvm::TargetLibraryInfoImpl targetLibraryInfo(llvm::Triple(module.getTargetTriple()));
+            postLinkPasses.add(new llvm::TargetLibraryInfoWrapperPass(targetLibraryInfo));
+            if (targetMachine)
+            {
+                postLinkPasses.add(llvm::createTargetTransformInfoWrapperPass(targetMachine->getTargetIRAnalysis()));
+            }
+
+            postLinkPasses.add(llvm::createFunctionInliningPass(3, 0, false));
+            postLinkPasses.add(llvm::createSROAPass());
+            postLinkPasses.add(llvm::createEarlyCSEPass());
+            postLinkPasses.add(llvm::createInstructionCombiningPass());
+            postLinkPasses.add(llvm::createCFGSimplificationPass());
+
+            // Remove local definitions that are no longer called after inlining
+            postLinkPasses.add(llvm::createGlobalDCEPass());
+            postLinkPasses.run(module);
+        }
+    } // namespace
+
+    void IROptimizer::AddStandardPasses()
+    {
+        auto module = _module.GetLLVMModule();
+        emitters::AddStandardPasses(_module.GetTargetMachine(), *module, _modulePasses, _functionPasses);
     }
 
     void IROptimizer::BeginOptimizeFunctions()
@@ -101,5 +159,106 @@ namespace emitters
     {
         _modulePasses.run(*pModule);
     }
+
+    int IROptimizer::OptimizeModuleInPartitions(llvm::Module* pModule, int numPartitions)
+    {
+        assert(pModule != nullptr);
+
+        // Partitions refer to each other's definitions by name, so everything needs one
+        for (auto& global : pModule->global_values())
+        {
+            if (!global.hasName())
+            {
+                global.setName("ell_unnamed");
+            }
+        }
+
+        // Splitting externalizes the local definitions, so remember which ones to make local again afterwards
+        std::vector<std::pair<std::string, llvm::GlobalValue::LinkageTypes>> localDefinitions;
+        for (const auto& global : pModule->global_values())
+        {
+            if (global.hasLocalLinkage() && !global.isDeclaration())
+            {
+                localDefinitions.emplace_back(global.getName().str(), global.getLinkage());
+            }
+        }
+
+        // Partitions without any function definitions have nothing to optimize and are linked back as they are
+        std::vector<std::string> partitions;
+        std::vector<std::string> dataPartitions;
+        llvm::SplitModule(llvm::CloneModule(*pModule), static_cast<unsigned>(numPartitions), [&](std::unique_ptr<llvm::Module> partition) {
+            auto hasDefinitions = std::any_of(partition->begin(), partition->end(), [](const llvm::Function& function) { return !function.isDeclaration(); });
+            (hasDefinitions ? partitions : dataPartitions).push_back(WriteModuleToBitcode(*partition));
+        });
+
+        // Each thread needs a target machine of its own
+        std::vector<std::unique_ptr<llvm::TargetMachine>> targetMachines;
+        for (size_t index = 0; index < partitions.size(); ++index)
+        {
+            targetMachines.emplace_back(_module.GetTargetMachine());
+        }
+
+        utilities::ThreadPool threadPool(partitions.size());
+        threadPool.ParallelFor(partitions.size(), [&](size_t index) {
+            partitions[index] = OptimizePartition(partitions[index], targetMachines[index].get());
+        });
+
+        // Turn the module's definitions into declarations, so that the optimized ones get linked in their place
+        for (auto& function : *pModule)
+        {
+            if (!function.isDeclaration())
+            {
+                function.deleteBody();
+            }
+        }
+        for (auto& variable : pModule->globals())
+        {
+            if (!variable.isDeclaration())
+            {
+                variable.setInitializer(nullptr);
+                variable.setLinkage(llvm::GlobalValue::ExternalLinkage);
+            }
+        }
+
+        auto numOptimizedPartitions = static_cast<int>(partitions.size());
+        partitions.insert(partitions.end(), dataPartitions.begin(), dataPartitions.end());
+        for (const auto& bitcode : partitions)
+        {
+            auto partition = ReadModuleFromBitcode(bitcode, pModule->getContext());
+
+            // Every partition has a copy of the module's named metadata, which the module still has
+            std::vector<llvm::NamedMDNode*> namedMetadata;
+            for (auto& node : partition->named_metadata())
+            {
+                if (node.getName() != "llvm.module.flags")
+                {
+                    namedMetadata.push_back(&node);
+                }
+            }
+            for (auto node : namedMetadata)
+            {
+                partition->eraseNamedMetadata(node);
+            }
+
+            if (llvm::Linker::linkModules(*pModule, std::move(partition)))
+            {
+                throw EmitterException(EmitterError::unexpected, "Unable to link optimized module partitions");
+            }
+        }
+
+        for (const auto& definition : localDefinitions)
+        {
+            if (auto global = pModule->getNamedValue(definition.first))
+            {
+                global->setVisibility(llvm::GlobalValue::DefaultVisibility);
+                global->setLinkage(definition.second);
+            }
+        }
+
+        std::unique_ptr<llvm::TargetMachine> targetMachine(_module.GetTargetMachine());
+        RunPostLinkPasses(*pModule, targetMachine.get());
+
+        return numOptimizedPartitions;
+    }
 } // namespace emitters
 } // namespace ell
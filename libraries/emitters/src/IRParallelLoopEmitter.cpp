@@ -11,13 +11,32 @@
 #include "IRFunctionEmitter.h"
 #include "IRMath.h"
 #include "IRModuleEmitter.h"
+#include "IRThreadPool.h"
 
+#include <algorithm>
 #include <vector>
 
 namespace ell
 {
 namespace emitters
 {
+    namespace
+    {
+        // Loops on the thread pool whose number of tasks isn't given are split according to the number of
+        // threads the pool actually runs, which the host can change at runtime with <module>_SetMaxThreads
+        bool UseRuntimeNumTasks(const CompilerOptions& compilerSettings, const ParallelLoopOptions& options)
+        {
+            return options.numTasks == 0 && compilerSettings.parallelize && compilerSettings.useThreadPool && !compilerSettings.targetDevice.IsWindows();
+        }
+
+        // With the thread pool, splitting the loop into more tasks than threads lets workers that finish early
+        // take the remaining tasks off the queue, which balances loops whose iterations differ in cost
+        int GetTasksPerThread(const CompilerOptions& compilerSettings)
+        {
+            return compilerSettings.useThreadPool ? std::max(compilerSettings.tasksPerThread, 1) : 1;
+        }
+    } // namespace
+
     IRParallelForLoopEmitter::IRParallelForLoopEmitter(IRFunctionEmitter& functionEmitter) :
         _functionEmitter(functionEmitter) {}
 
@@ -29,9 +48,9 @@ namespace emitters
 
         auto compilerSettings = _functionEmitter.GetCompilerOptions();
         ParallelLoopOptions newOptions = options;
-        if (newOptions.numTasks == 0)
+        if (newOptions.numTasks == 0 && !UseRuntimeNumTasks(compilerSettings, options))
         {
-            newOptions.numTasks = std::min(numIterations, compilerSettings.maxThreads);
+            newOptions.numTasks = std::min(numIterations, compilerSettings.maxThreads * GetTasksPerThread(compilerSettings));
         }
         EmitLoop(_functionEmitter.LocalScalar<int32_t>(begin), _functionEmitter.LocalScalar<int32_t>(end), _functionEmitter.LocalScalar<int32_t>(increment), newOptions, capturedValues, body);
     }
@@ -39,6 +58,12 @@ namespace emitters
     void IRParallelForLoopEmitter::EmitLoop(IRLocalScalar begin, IRLocalScalar end, IRLocalScalar increment, const ParallelLoopOptions& options, const std::vector<LLVMValue>& capturedValues, BodyFunction body)
     {
         auto compilerSettings = _functionEmitter.GetCompilerOptions();
+        if (UseRuntimeNumTasks(compilerSettings, options))
+        {
+            EmitThreadPoolLoop(begin, end, increment, capturedValues, body);
+            return;
+        }
+
         const int numTasks = options.numTasks == 0 ? compilerSettings.maxThreads : options.numTasks;
         auto span = end - begin;
         auto numIterations = (span - 1) / increment + 1;
@@ -70,6 +95,48 @@ namespace emitters
         }
     }
 
+    void IRParallelForLoopEmitter::EmitThreadPoolLoop(IRLocalScalar begin, IRLocalScalar end, IRLocalScalar increment, const std::vector<LLVMValue>& capturedValues, BodyFunction body)
+    {
+        // This is the type of code we are trying to generate:
+        //
+        // int numTasks = min(numIterations, threadPoolNumThreads * tasksPerThread);
+        // int taskSize = (numIterations - 1) / numTasks + 1;
+        // if (numTasks > 1)
+        // {
+        //     <start numTasks tasks on the pool, task i running parForTask(begin + i * taskSize * increment, ...)>
+        //     <wait for the tasks>
+        // }
+        // else
+        // {
+        //     parForTask(begin, end, increment, ...);
+        // }
+        //
+        auto& threadPool = _functionEmitter.GetModule().GetThreadPool();
+        auto tasksPerThread = GetTasksPerThread(_functionEmitter.GetCompilerOptions());
+        auto span = end - begin;
+        auto numIterations = (span - 1) / increment + 1;
+        auto numThreads = _functionEmitter.LocalScalar(threadPool.GetNumThreads(_functionEmitter));
+        auto numTasks = Max(Min(numIterations, numThreads * tasksPerThread), 1);
+        auto taskSize = (numIterations - 1) / numTasks + 1;
+        auto taskFunction = GetTaskFunction(capturedValues, body).GetFunction();
+
+        _functionEmitter.If(numTasks > 1, [&threadPool, taskFunction, begin, end, increment, numTasks, taskSize, capturedValues](IRFunctionEmitter& function) {
+                            auto& tasks = threadPool.AddTasks(function, taskFunction, numTasks, [begin, end, increment, taskSize, capturedValues](IRFunctionEmitter& function, LLVMValue taskIndex) {
+                                auto blockStart = begin + function.LocalScalar(taskIndex) * taskSize * increment;
+                                auto blockEnd = Min(blockStart + taskSize * increment, end);
+                                std::vector<LLVMValue> args{ blockStart, blockEnd, increment };
+                                std::copy(capturedValues.begin(), capturedValues.end(), std::back_inserter(args));
+                                return args;
+                            });
+                            tasks.WaitAll(function);
+                        })
+            .Else([taskFunction, begin, end, increment, capturedValues](IRFunctionEmitter& function) {
+                std::vector<LLVMValue> args{ begin, end, increment };
+                std::copy(capturedValues.begin(), capturedValues.end(), std::back_inserter(args));
+                function.Call(taskFunction, args);
+            });
+    }
+
     IRFunctionEmitter IRParallelForLoopEmitter::GetTaskFunction(const std::vector<LLVMValue>& capturedValues, BodyFunction body)
     {
         std::string name = "parForTask";
@@ -17,12 +17,99 @@
 #include <utilities/include/Exception.h>
 #include <utilities/include/Unused.h>
 
+#include <llvm/IR/Instructions.h>
+
 #include <vector>
 
 namespace ell
 {
 namespace emitters
 {
+    namespace
+    {
+        // Values of the thread pool's state variable
+        enum class PoolState
+        {
+            notStarted = 0,
+            starting,
+            started
+        };
+
+        LLVMValue PoolStateLiteral(IRFunctionEmitter& function, PoolState state)
+        {
+            return function.Literal<int>(static_cast<int>(state));
+        }
+
+        // Size of a worker's slot in the array of task ranges, so that workers don't share cache lines
+        constexpr int taskRangeStride = 64 / sizeof(int64_t);
+
+        LLVMValue AtomicLoad(IRFunctionEmitter& function, LLVMValue pointer, unsigned alignment)
+        {
+            auto load = function.GetEmitter().GetIRBuilder().CreateLoad(pointer);
+            load->setAtomic(llvm::AtomicOrdering::Acquire);
+            load->setAlignment(alignment);
+            return load;
+        }
+
+        LLVMValue AtomicLoad(IRFunctionEmitter& function, llvm::GlobalVariable* variable)
+        {
+            return AtomicLoad(function, variable, variable->getAlignment());
+        }
+
+        void AtomicStore(IRFunctionEmitter& function, LLVMValue pointer, LLVMValue value, unsigned alignment)
+        {
+            auto store = function.GetEmitter().GetIRBuilder().CreateStore(value, pointer);
+            store->setAtomic(llvm::AtomicOrdering::Release);
+            store->setAlignment(alignment);
+        }
+
+        void AtomicStore(IRFunctionEmitter& function, llvm::GlobalVariable* variable, LLVMValue value)
+        {
+            AtomicStore(function, variable, value, variable->getAlignment());
+        }
+
+        // Returns the { previous value, success } pair: the pointer is only set to `desired` if it held `expected`
+        LLVMValue AtomicCompareExchange(IRFunctionEmitter& function, LLVMValue pointer, LLVMValue expected, LLVMValue desired)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            return irBuilder.CreateAtomicCmpXchg(pointer, expected, desired, llvm::AtomicOrdering::AcquireRelease, llvm::AtomicOrdering::Acquire);
+        }
+
+        // Returns true if the variable held `expected` and was set to `desired`
+        LLVMValue CompareExchange(IRFunctionEmitter& function, llvm::GlobalVariable* variable, LLVMValue expected, LLVMValue desired)
+        {
+            auto result = AtomicCompareExchange(function, variable, expected, desired);
+            return function.GetEmitter().GetIRBuilder().CreateExtractValue(result, 1);
+        }
+
+        // Returns the value before the decrement
+        LLVMValue AtomicDecrement(IRFunctionEmitter& function, LLVMValue pointer)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            return irBuilder.CreateAtomicRMW(llvm::AtomicRMWInst::Sub, pointer, function.Literal<int>(1), llvm::AtomicOrdering::AcquireRelease);
+        }
+
+        // A worker's range of task indices is packed into an int64 as (end << 32) | begin, so both ends change in one atomic operation
+        LLVMValue PackTaskRange(IRFunctionEmitter& function, LLVMValue begin, LLVMValue end)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            auto int64Type = irBuilder.getInt64Ty();
+            return irBuilder.CreateOr(irBuilder.CreateShl(irBuilder.CreateZExt(end, int64Type), 32), irBuilder.CreateZExt(begin, int64Type));
+        }
+
+        LLVMValue GetTaskRangeBegin(IRFunctionEmitter& function, LLVMValue range)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            return irBuilder.CreateTrunc(range, irBuilder.getInt32Ty());
+        }
+
+        LLVMValue GetTaskRangeEnd(IRFunctionEmitter& function, LLVMValue range)
+        {
+            auto& irBuilder = function.GetEmitter().GetIRBuilder();
+            return irBuilder.CreateTrunc(irBuilder.CreateLShr(range, 32), irBuilder.getInt32Ty());
+        }
+    } // namespace
+
     //
     // IRThreadPool
     //
@@ -37,61 +124,191 @@ namespace emitters
         _maxThreads = _module.GetCompilerOptions().maxThreads;
         auto pthreadType = _module.GetRuntime().GetPosixEmitter().GetPthreadType();
 
-        // Create global array to hold pthread objects
-        _threads = _module.GlobalArray("taskThreads", pthreadType, _maxThreads);
+        // The number of threads is only read when the pool starts, so it can be changed at runtime
+        _numThreads = _module.Global("threadPoolNumThreads", _maxThreads);
 
-        AddGlobalInitializer();
+        // Create a global pointer to hold the array of pthread objects (allocated when the pool starts)
+        _threads = _module.Global(pthreadType->getPointerTo(), "taskThreads");
+
+        auto boolType = llvm::Type::getInt1Ty(_module.GetLLVMContext());
+        _runTasksInline = _module.Global(boolType, "threadPoolRunTasksInline", true);
+        _taskQueue._runTasksInline = _runTasksInline;
+        _taskQueue._useWorkStealing = _module.GetCompilerOptions().useWorkStealing;
+
+        AddInitializer();
         AddGlobalFinalizer();
+        AddSetMaxThreadsFunction();
     }
 
-    void IRThreadPool::AddGlobalInitializer()
+    void IRThreadPool::AddInitializer()
     {
-        // Create individual threads (in a global_ctors function)
+        // Create individual threads the first time any tasks are submitted. This isn't a global_ctors function,
+        // so that clients get a chance to call <module>_SetMaxThreads before the threads are started.
+        //
+        // Several threads can submit their first tasks at the same time, so the one that moves the state from
+        // "not started" to "starting" starts the pool, and the others wait until it is done:
+        //
+        // void initThreadPool()
+        // {
+        //     if (atomic_load(&threadPoolState) != started)
+        //     {
+        //         if (compare_exchange(&threadPoolState, notStarted, starting))
+        //         {
+        //             <initialize the task queue and start the threads>
+        //             atomic_store(&threadPoolState, started);
+        //         }
+        //         else
+        //         {
+        //             while (atomic_load(&threadPoolState) != started) {}
+        //         }
+        //     }
+        // }
+        //
         auto& context = _module.GetLLVMContext();
-        auto boolType = llvm::Type::getInt1Ty(context);
         auto int8PtrType = llvm::Type::getInt8PtrTy(context);
-        auto isInitedVar = _module.Global(boolType, "isInitialized"); // initialized to false
+        auto pthreadType = _module.GetRuntime().GetPosixEmitter().GetPthreadType();
+        auto pthreadSize = static_cast<int64_t>(_module.GetIREmitter().SizeOf(pthreadType));
+        _state = _module.Global("threadPoolState", static_cast<int>(PoolState::notStarted));
+        _state->setAlignment(sizeof(int));
 
         auto initThreadPoolFunction = _module.BeginFunction("initThreadPool", VariableType::Void);
         {
-            // Check if task not initialized
-            auto notInited = initThreadPoolFunction.LogicalNot(initThreadPoolFunction.Load(isInitedVar));
-            initThreadPoolFunction.If(notInited, [this, int8PtrType, &isInitedVar](auto& initThreadPoolFunction) {
-                initThreadPoolFunction.Store(isInitedVar, initThreadPoolFunction.TrueBit());
-                _taskQueue.Initialize(initThreadPoolFunction);
-
-                auto workerThreadFunction = this->GetWorkerThreadFunction(); // STYLE gcc bug requires `this->` inside generic lambda (https://gcc.gnu.org/bugzilla/show_bug.cgi?id=67274)
-                llvm::ConstantPointerNull* nullAttr = initThreadPoolFunction.NullPointer(int8PtrType);
-                initThreadPoolFunction.For(_maxThreads, [this, int8PtrType, nullAttr, workerThreadFunction](auto& initThreadPoolFunction, LLVMValue index) {
-                    auto threadPtr = initThreadPoolFunction.PointerOffset(_threads, index);
-                    initThreadPoolFunction.PthreadCreate(threadPtr, nullAttr, workerThreadFunction, initThreadPoolFunction.CastPointer(_taskQueue.GetDataStruct(), int8PtrType));
-                });
+            auto isNotStarted = initThreadPoolFunction.Comparison(TypedComparison::notEquals, AtomicLoad(initThreadPoolFunction, _state), PoolStateLiteral(initThreadPoolFunction, PoolState::started));
+            initThreadPoolFunction.If(isNotStarted, [this, int8PtrType, pthreadType, pthreadSize](auto& initThreadPoolFunction) {
+                auto claimed = CompareExchange(initThreadPoolFunction, this->_state, PoolStateLiteral(initThreadPoolFunction, PoolState::notStarted), PoolStateLiteral(initThreadPoolFunction, PoolState::starting)); // STYLE gcc bug requires `this->` inside generic lambda (https://gcc.gnu.org/bugzilla/show_bug.cgi?id=67274)
+                initThreadPoolFunction.If(claimed, [this, int8PtrType, pthreadType, pthreadSize](auto& initThreadPoolFunction) {
+                                          auto numThreads = initThreadPoolFunction.Load(this->_numThreads);
+                                          this->_taskQueue.Initialize(initThreadPoolFunction, numThreads);
+
+                                          auto threadsSize = initThreadPoolFunction.Operator(TypedOperator::multiply, initThreadPoolFunction.CastValue(numThreads, VariableType::Int64), initThreadPoolFunction.template Literal<int64_t>(pthreadSize));
+                                          initThreadPoolFunction.Store(this->_threads, initThreadPoolFunction.Malloc(pthreadType->getPointerTo(), threadsSize));
+
+                                          auto workerThreadFunction = this->GetWorkerThreadFunction(); // STYLE gcc bug requires `this->` inside generic lambda (https://gcc.gnu.org/bugzilla/show_bug.cgi?id=67274)
+                                          auto threads = initThreadPoolFunction.Load(this->_threads);
+                                          llvm::ConstantPointerNull* nullAttr = initThreadPoolFunction.NullPointer(int8PtrType);
+                                          initThreadPoolFunction.For(numThreads, [int8PtrType, nullAttr, workerThreadFunction, threads](auto& initThreadPoolFunction, LLVMValue index) {
+                                              // Each worker gets its index, which selects its range of tasks when work stealing
+                                              auto threadPtr = initThreadPoolFunction.PointerOffset(threads, index);
+                                              initThreadPoolFunction.PthreadCreate(threadPtr, nullAttr, workerThreadFunction, initThreadPoolFunction.CastIntToPointer(index, int8PtrType));
+                                          });
+
+                                          AtomicStore(initThreadPoolFunction, this->_state, PoolStateLiteral(initThreadPoolFunction, PoolState::started));
+                                      })
+                    .Else([this](auto& initThreadPoolFunction) {
+                        // Another thread is starting the pool
+                        initThreadPoolFunction.While([this](IRFunctionEmitter& function) { return function.Comparison(TypedComparison::notEquals, AtomicLoad(function, this->_state), PoolStateLiteral(function, PoolState::started)); },
+                                                     [](IRFunctionEmitter&) {});
+                    });
             });
         }
         _module.EndFunction();
-        _module.AddInitializationFunction(initThreadPoolFunction);
+        _initFunction = initThreadPoolFunction.GetFunction();
     }
 
     void IRThreadPool::AddGlobalFinalizer()
     {
-        // Create individual threads (in a global_ctors function)
+        // Stop the threads (in a global_dtors function), if they were ever started
         auto shutDownThreadPoolFunction = _module.BeginFunction("shutDownThreadPool", VariableType::Void);
         {
-            ShutDown(shutDownThreadPoolFunction);
+            auto isStarted = shutDownThreadPoolFunction.Comparison(TypedComparison::equals, AtomicLoad(shutDownThreadPoolFunction, _state), PoolStateLiteral(shutDownThreadPoolFunction, PoolState::started));
+            shutDownThreadPoolFunction.If(isStarted, [this](auto& shutDownThreadPoolFunction) {
+                this->ShutDown(shutDownThreadPoolFunction); // STYLE gcc bug requires `this->` inside generic lambda (https://gcc.gnu.org/bugzilla/show_bug.cgi?id=67274)
+            });
         }
         _module.EndFunction();
         _module.AddFinalizationFunction(shutDownThreadPoolFunction);
     }
 
+    void IRThreadPool::AddSetMaxThreadsFunction()
+    {
+        // This is the type of code we are trying to generate:
+        //
+        // void model_SetMaxThreads(int numThreads)
+        // {
+        //     if (threadPoolState == notStarted && numThreads > 0)
+        //     {
+        //         threadPoolNumThreads = numThreads;
+        //     }
+        // }
+        //
+        const NamedVariableTypeList parameters = { { "numThreads", VariableType::Int32 } };
+        auto function = _module.BeginFunction(_module.GetModuleName() + "_SetMaxThreads", VariableType::Void, parameters);
+        function.IncludeInHeader();
+        function.GetFunction()->setLinkage(llvm::GlobalValue::LinkageTypes::ExternalLinkage);
+        {
+            auto numThreads = function.GetFunctionArgument("numThreads");
+            auto notInited = function.Comparison(TypedComparison::equals, AtomicLoad(function, _state), PoolStateLiteral(function, PoolState::notStarted));
+            auto isPositive = function.Comparison(TypedComparison::greaterThan, numThreads, function.Literal<int>(0));
+            function.If(function.Operator(TypedOperator::logicalAnd, notInited, isPositive), [this, numThreads](auto& function) {
+                function.Store(this->_numThreads, numThreads); // STYLE gcc bug requires `this->` inside generic lambda (https://gcc.gnu.org/bugzilla/show_bug.cgi?id=67274)
+            });
+        }
+        _module.EndFunction();
+    }
+
     IRThreadPoolTaskArray& IRThreadPool::AddTasks(IRFunctionEmitter& function, LLVMFunction taskFunction, const std::vector<std::vector<LLVMValue>>& arguments)
     {
-        // Call Initialize() the first time we're called --- this adds global init code to the module
+        // Call Initialize() the first time we're called --- this adds the thread pool functions to the module
         if (!IsInitialized())
         {
             Initialize();
         }
 
-        return _taskQueue.StartTasks(function, taskFunction, arguments);
+        // Tasks submitted from a worker thread (e.g., a parallel loop inside a task) can't be added to the task array
+        // that is running, so they run on the submitting thread
+        function.If(function.Load(_runTasksInline), [taskFunction, &arguments](IRFunctionEmitter& function) {
+                    for (const auto& taskArguments : arguments)
+                    {
+                        function.Call(taskFunction, taskArguments);
+                    }
+                })
+            .Else([this, taskFunction, &arguments](IRFunctionEmitter& function) {
+                // Start the worker threads if this is the first time tasks are submitted at runtime
+                function.Call(_initFunction, IRValueList{});
+                _taskQueue.StartTasks(function, taskFunction, arguments);
+            });
+        return _taskQueue.GetTaskArray();
+    }
+
+    IRThreadPoolTaskArray& IRThreadPool::AddTasks(IRFunctionEmitter& function, LLVMFunction taskFunction, LLVMValue numTasks, TaskArgumentsFunction getArguments)
+    {
+        if (!IsInitialized())
+        {
+            Initialize();
+        }
+
+        function.If(function.Load(_runTasksInline), [taskFunction, numTasks, getArguments](IRFunctionEmitter& function) {
+                    function.For(numTasks, [taskFunction, getArguments](IRFunctionEmitter& function, LLVMValue taskIndex) {
+                        function.Call(taskFunction, getArguments(function, taskIndex));
+                    });
+                })
+            .Else([this, taskFunction, numTasks, getArguments](IRFunctionEmitter& function) {
+                function.Call(_initFunction, IRValueList{});
+                _taskQueue.StartTasks(function, taskFunction, numTasks, getArguments);
+            });
+        return _taskQueue.GetTaskArray();
+    }
+
+    LLVMValue IRThreadPool::GetNumThreads(IRFunctionEmitter& function)
+    {
+        if (!IsInitialized())
+        {
+            Initialize();
+        }
+
+        return function.Load(_numThreads);
+    }
+
+    LLVMValue IRThreadPool::SetRunTasksInline(IRFunctionEmitter& function, LLVMValue runInline)
+    {
+        if (!IsInitialized())
+        {
+            Initialize();
+        }
+
+        auto previous = function.Load(_runTasksInline);
+        function.Store(_runTasksInline, runInline);
+        return previous;
     }
 
     void IRThreadPool::ShutDown(IRFunctionEmitter& function)
@@ -102,10 +319,28 @@ namespace emitters
         _taskQueue.ShutDown(function);
 
         // Now wait for the worker threads to finish
-        function.For(_maxThreads, [=](auto& function, auto index) {
-            auto threadPtr = function.PointerOffset(_threads, index);
+        auto threads = function.Load(_threads);
+        function.For(function.Load(_numThreads), [=](auto& function, auto index) {
+            auto threadPtr = function.PointerOffset(threads, index);
             function.PthreadJoin(function.Load(threadPtr), function.NullPointer(int8PtrType->getPointerTo()));
         });
+        function.Free(threads);
+        _taskQueue.GetTaskArray().FreeHeapStorage(function);
+        _taskQueue.FreeTaskRanges(function);
+    }
+
+    std::vector<llvm::GlobalVariable*> IRThreadPool::GetGlobalVariables() const
+    {
+        std::vector<llvm::GlobalVariable*> result;
+        const LLVMValue globals[] = { _numThreads, _state, _threads, _runTasksInline, _taskQueue._queueData, _taskQueue._tasks._taskArrayData };
+        for (auto value : globals)
+        {
+            if (auto global = llvm::dyn_cast_or_null<llvm::GlobalVariable>(value))
+            {
+                result.push_back(global);
+            }
+        }
+        return result;
     }
 
     LLVMFunction IRThreadPool::GetWorkerThreadFunction()
@@ -118,8 +353,46 @@ namespace emitters
 
         auto workerThreadFunction = _module.BeginFunction("WorkerThreadFunction", int8PtrType, { int8PtrType });
         {
+            workerThreadFunction.Store(_runTasksInline, workerThreadFunction.TrueBit());
             auto notDoneVar = workerThreadFunction.Variable(boolType, "notDone");
             workerThreadFunction.Store(notDoneVar, workerThreadFunction.TrueBit());
+            if (_taskQueue._useWorkStealing)
+            {
+                // void* WorkerThreadFunction(void* workerIndex)
+                // {
+                //     while (true)
+                //     {
+                //         <claim a task from this worker's range, or steal one from another worker's range>
+                //         if (<no task>)
+                //         {
+                //             <sleep until new tasks are started, or exit if the pool is shutting down>
+                //         }
+                //         else
+                //         {
+                //             <run the task, and wake up the client waiting for the tasks if it was the last one>
+                //         }
+                //     }
+                // }
+                auto workerIndex = workerThreadFunction.CastPointerToInt(&(*workerThreadFunction.Arguments().begin()), VariableType::Int32);
+                auto seenGenerationVar = workerThreadFunction.Variable(VariableType::Int32, "seenGeneration");
+                workerThreadFunction.Store(seenGenerationVar, workerThreadFunction.Literal<int>(0));
+                workerThreadFunction.While(notDoneVar, [this, notDoneVar, workerIndex, seenGenerationVar](IRFunctionEmitter& workerThreadFunction) {
+                    auto task = _taskQueue.ClaimTask(workerThreadFunction, workerIndex);
+                    workerThreadFunction.If(task.IsNull(workerThreadFunction), [this, notDoneVar, seenGenerationVar](IRFunctionEmitter& workerThreadFunction) {
+                                            auto isShutDown = _taskQueue.WaitForNewTasks(workerThreadFunction, seenGenerationVar);
+                                            workerThreadFunction.Store(notDoneVar, workerThreadFunction.LogicalNot(isShutDown));
+                                        })
+                        .Else([this, &task](IRFunctionEmitter& workerThreadFunction) {
+                            task.Run(workerThreadFunction);
+                            _taskQueue.FinishTask(workerThreadFunction);
+                        });
+                });
+
+                workerThreadFunction.Return(workerThreadFunction.NullPointer(int8PtrType));
+                _module.EndFunction();
+                return workerThreadFunction.GetFunction();
+            }
+
             workerThreadFunction.While(notDoneVar, [this, notDoneVar](IRFunctionEmitter& workerThreadFunction) {
                 auto task = _taskQueue.PopNextTask(workerThreadFunction);
                 // check for a poison "null" task, indicating we should break out of the loop and terminate the thread
@@ -164,7 +437,7 @@ namespace emitters
         // Note: we can't initialize ourselves here, for ordering reasons.
     }
 
-    void IRThreadPoolTaskQueue::Initialize(IRFunctionEmitter& function)
+    void IRThreadPoolTaskQueue::Initialize(IRFunctionEmitter& function, LLVMValue numThreads)
     {
         if (_queueData != nullptr)
         {
@@ -187,6 +460,9 @@ namespace emitters
         auto count = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unscheduledCount));
         auto unfinishedCount = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unfinishedCount));
         auto shutdownFlag = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::shutdownFlag));
+        auto generation = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::generation));
+        auto taskRanges = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::taskRanges));
+        auto numTaskRanges = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::numTaskRanges));
 
         // Initialize the fields
         llvm::ConstantPointerNull* nullAttr = function.NullPointer(int8PtrType);
@@ -197,6 +473,24 @@ namespace emitters
         function.Store(count, function.Literal<int>(0));
         function.Store(unfinishedCount, function.Literal<int>(0));
         function.Store(shutdownFlag, function.FalseBit());
+        function.Store(generation, function.Literal<int>(0));
+        function.Store(numTaskRanges, numThreads);
+        if (_useWorkStealing)
+        {
+            // Every worker starts with an empty range
+            auto int64Type = llvm::Type::getInt64Ty(context);
+            auto taskRangesSize = function.Operator(TypedOperator::multiply, function.CastValue(numThreads, VariableType::Int64), function.Literal<int64_t>(taskRangeStride * sizeof(int64_t)));
+            auto taskRangesStorage = function.Malloc(int64Type->getPointerTo(), taskRangesSize);
+            function.For(numThreads, [taskRangesStorage](IRFunctionEmitter& function, LLVMValue index) {
+                auto offset = function.Operator(TypedOperator::multiply, index, function.Literal<int>(taskRangeStride));
+                function.Store(function.PointerOffset(taskRangesStorage, offset), function.Literal<int64_t>(0));
+            });
+            function.Store(taskRanges, taskRangesStorage);
+        }
+        else
+        {
+            function.Store(taskRanges, function.NullPointer(llvm::Type::getInt64Ty(context)->getPointerTo()));
+        }
 
         _tasks.Initialize(function);
     }
@@ -211,12 +505,213 @@ namespace emitters
 
         LockQueueMutex(function);
         _tasks.SetTasks(function, taskFunction, arguments);
-        SetInitialCount(function, function.Literal<int>(numTasks));
-        function.PthreadCondBroadcast(GetWorkAvailableConditionVariablePointer(function));
+        PublishTasks(function, function.Literal<int>(numTasks));
         UnlockQueueMutex(function);
         return GetTaskArray();
     }
 
+    IRThreadPoolTaskArray& IRThreadPoolTaskQueue::StartTasks(IRFunctionEmitter& function, LLVMFunction taskFunction, LLVMValue numTasks, TaskArgumentsFunction getArguments)
+    {
+        assert(IsInitialized());
+
+        LockQueueMutex(function);
+        _tasks.SetTasks(function, taskFunction, numTasks, getArguments);
+        PublishTasks(function, numTasks);
+        UnlockQueueMutex(function);
+        return GetTaskArray();
+    }
+
+    void IRThreadPoolTaskQueue::PublishTasks(IRFunctionEmitter& function, LLVMValue numTasks)
+    {
+        SetInitialCount(function, numTasks);
+        if (_useWorkStealing)
+        {
+            // The ranges are stored last, so a worker that is still looking for tasks from the previous
+            // task array sees the new task array once it claims a task from them
+            auto generationPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::generation));
+            function.Store(generationPtr, function.Operator(TypedOperator::add, function.Load(generationPtr), function.Literal<int>(1)));
+            DistributeTasks(function, numTasks);
+        }
+        function.PthreadCondBroadcast(GetWorkAvailableConditionVariablePointer(function));
+    }
+
+    void IRThreadPoolTaskQueue::DistributeTasks(IRFunctionEmitter& function, LLVMValue numTasks)
+    {
+        // Split the tasks into one contiguous range per worker:
+        //
+        // for (int w = 0; w < numTaskRanges; ++w)
+        // {
+        //     atomic_store(&taskRanges[w * taskRangeStride], pack(w * numTasks / numTaskRanges, (w + 1) * numTasks / numTaskRanges));
+        // }
+        //
+        auto taskRanges = function.Load(function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::taskRanges)));
+        auto numTaskRanges = function.LocalScalar(function.Load(function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::numTaskRanges))));
+        function.For(numTaskRanges, [taskRanges, numTaskRanges, numTasks](IRFunctionEmitter& function, LLVMValue index) {
+            auto worker = function.LocalScalar(index);
+            auto begin = worker * numTasks / numTaskRanges;
+            auto end = (worker + 1) * numTasks / numTaskRanges;
+            auto taskRange = function.PointerOffset(taskRanges, worker * taskRangeStride);
+            AtomicStore(function, taskRange, PackTaskRange(function, begin, end), sizeof(int64_t));
+        });
+    }
+
+    LLVMFunction IRThreadPoolTaskQueue::GetClaimTaskFunction(IRModuleEmitter& module)
+    {
+        // Workers take tasks from the front of their own range, and steal the back half of another worker's range when
+        // theirs is empty. Both ends of a range change in one compare-exchange, so every task is claimed exactly once:
+        //
+        // int claimTask(int workerIndex)
+        // {
+        //     int taskIndex = -1;
+        //     for (int offset = 0; offset < numTaskRanges && taskIndex < 0; ++offset)
+        //     {
+        //         int64_t* taskRange = &taskRanges[(workerIndex + offset) % numTaskRanges * taskRangeStride];
+        //         int64_t range = atomic_load(taskRange);
+        //         while (begin(range) < end(range) && taskIndex < 0)
+        //         {
+        //             if (offset == 0)
+        //             {
+        //                 if (compare_exchange(taskRange, &range, pack(begin(range) + 1, end(range)))) taskIndex = begin(range);
+        //             }
+        //             else
+        //             {
+        //                 int middle = begin(range) + (end(range) - begin(range)) / 2;
+        //                 if (compare_exchange(taskRange, &range, pack(begin(range), middle)))
+        //                 {
+        //                     atomic_store(&taskRanges[workerIndex * taskRangeStride], pack(middle + 1, end(range)));
+        //                     taskIndex = middle;
+        //                 }
+        //             }
+        //         }
+        //     }
+        //     return taskIndex;
+        // }
+        //
+        if (_claimTaskFunction != nullptr)
+        {
+            return _claimTaskFunction;
+        }
+
+        auto int64Type = llvm::Type::getInt64Ty(module.GetLLVMContext());
+        const NamedVariableTypeList parameters = { { "workerIndex", VariableType::Int32 } };
+        auto function = module.BeginFunction("claimTask", VariableType::Int32, parameters);
+        {
+            auto workerIndex = function.LocalScalar(function.GetFunctionArgument("workerIndex"));
+            auto taskRanges = function.Load(function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::taskRanges)));
+            auto numTaskRanges = function.LocalScalar(function.Load(function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::numTaskRanges))));
+            auto ownTaskRange = function.PointerOffset(taskRanges, workerIndex * taskRangeStride);
+
+            auto taskIndexVar = function.Variable(VariableType::Int32, "taskIndex");
+            auto offsetVar = function.Variable(VariableType::Int32, "offset");
+            auto rangeVar = function.Variable(int64Type, "range");
+            function.Store(taskIndexVar, function.Literal<int>(-1));
+            function.Store(offsetVar, function.Literal<int>(0));
+            auto isUnclaimed = [taskIndexVar](IRFunctionEmitter& function) {
+                return function.LocalScalar(function.Load(taskIndexVar)) < 0;
+            };
+
+            function.While([=](IRFunctionEmitter& function) { return (function.LocalScalar(function.Load(offsetVar)) < numTaskRanges) && isUnclaimed(function); }, [=](IRFunctionEmitter& function) {
+                auto offset = function.LocalScalar(function.Load(offsetVar));
+                auto taskRange = function.PointerOffset(taskRanges, ((workerIndex + offset) % numTaskRanges) * taskRangeStride);
+                function.Store(rangeVar, AtomicLoad(function, taskRange, sizeof(int64_t)));
+                function.While([=](IRFunctionEmitter& function) {
+                    auto range = function.Load(rangeVar);
+                    return (function.LocalScalar(GetTaskRangeBegin(function, range)) < GetTaskRangeEnd(function, range)) && isUnclaimed(function); }, [=](IRFunctionEmitter& function) {
+                    auto& irBuilder = function.GetEmitter().GetIRBuilder();
+                    auto range = function.Load(rangeVar);
+                    auto begin = function.LocalScalar(GetTaskRangeBegin(function, range));
+                    auto end = function.LocalScalar(GetTaskRangeEnd(function, range));
+                    function.If(offset == 0, [&](IRFunctionEmitter& function) {
+                                auto exchange = AtomicCompareExchange(function, taskRange, range, PackTaskRange(function, begin + 1, end));
+                                function.Store(rangeVar, irBuilder.CreateExtractValue(exchange, 0));
+                                function.If(irBuilder.CreateExtractValue(exchange, 1), [=](IRFunctionEmitter& function) {
+                                    function.Store(taskIndexVar, begin);
+                                });
+                            })
+                        .Else([&](IRFunctionEmitter& function) {
+                            auto middle = begin + (end - begin) / 2;
+                            auto exchange = AtomicCompareExchange(function, taskRange, range, PackTaskRange(function, begin, middle));
+                            function.Store(rangeVar, irBuilder.CreateExtractValue(exchange, 0));
+                            function.If(irBuilder.CreateExtractValue(exchange, 1), [=](IRFunctionEmitter& function) {
+                                // This worker's range is empty, so no other worker changes it until it is set
+                                AtomicStore(function, ownTaskRange, PackTaskRange(function, middle + 1, end), sizeof(int64_t));
+                                function.Store(taskIndexVar, middle);
+                            });
+                        });
+                });
+                function.Store(offsetVar, offset + 1);
+            });
+            function.Return(function.Load(taskIndexVar));
+        }
+        module.EndFunction();
+        _claimTaskFunction = function.GetFunction();
+        return _claimTaskFunction;
+    }
+
+    IRThreadPoolTask IRThreadPoolTaskQueue::ClaimTask(IRFunctionEmitter& function, LLVMValue workerIndex)
+    {
+        assert(IsInitialized());
+
+        // A negative index, if every range is empty, gets a null task
+        auto taskIndex = function.Call(GetClaimTaskFunction(function.GetModule()), { workerIndex });
+        return _tasks.GetTask(function, taskIndex);
+    }
+
+    void IRThreadPoolTaskQueue::FinishTask(IRFunctionEmitter& function)
+    {
+        // Only the last task to finish takes the mutex, to wake up the client waiting for the tasks
+        auto unfinishedCountPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unfinishedCount));
+        auto previousCount = AtomicDecrement(function, unfinishedCountPtr);
+        function.If(TypedComparison::equals, previousCount, function.Literal<int>(1), [this](IRFunctionEmitter& function) {
+            LockQueueMutex(function);
+            NotifyWaitingClients(function);
+            UnlockQueueMutex(function);
+        });
+    }
+
+    LLVMValue IRThreadPoolTaskQueue::WaitForNewTasks(IRFunctionEmitter& function, LLVMValue seenGenerationPointer)
+    {
+        // Returns the shutdown flag:
+        //
+        // lock(queueMutex);
+        // while (generation == seenGeneration && !shutdownFlag)
+        // {
+        //     wait(workAvailableCondVar, queueMutex);
+        // }
+        // seenGeneration = generation;
+        // unlock(queueMutex);
+        //
+        auto& context = function.GetLLVMContext();
+        auto boolType = llvm::Type::getInt1Ty(context);
+        auto isWaitingVar = function.Variable(boolType, "isWaiting");
+        auto queueMutex = GetQueueMutexPointer(function);
+        auto workAvailableCondVar = GetWorkAvailableConditionVariablePointer(function);
+        auto generationPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::generation));
+        auto isWaiting = [this, generationPtr, seenGenerationPointer](IRFunctionEmitter& function) {
+            auto isSameGeneration = function.Comparison(TypedComparison::equals, function.Load(generationPtr), function.Load(seenGenerationPointer));
+            return function.Operator(TypedOperator::logicalAnd, isSameGeneration, function.LogicalNot(GetShutdownFlag(function)));
+        };
+
+        LockQueueMutex(function);
+        function.Store(isWaitingVar, isWaiting(function));
+        function.While(isWaitingVar, [=](IRFunctionEmitter& function) {
+            function.PthreadCondWait(workAvailableCondVar, queueMutex);
+            function.Store(isWaitingVar, isWaiting(function));
+        });
+        function.Store(seenGenerationPointer, function.Load(generationPtr));
+        auto isShutDown = GetShutdownFlag(function);
+        UnlockQueueMutex(function);
+        return isShutDown;
+    }
+
+    void IRThreadPoolTaskQueue::FreeTaskRanges(IRFunctionEmitter& function)
+    {
+        if (_useWorkStealing)
+        {
+            function.Free(function.Load(function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::taskRanges))));
+        }
+    }
+
     void IRThreadPoolTaskQueue::NotifyWaitingClients(IRFunctionEmitter& function)
     {
         function.PthreadCondBroadcast(GetWorkFinishedConditionVariablePointer(function));
@@ -271,10 +766,13 @@ namespace emitters
 
     void IRThreadPoolTaskQueue::ShutDown(IRFunctionEmitter& function)
     {
+        // Set the flag with the mutex held, so a worker can't miss the wakeup between checking the flag and waiting
+        LockQueueMutex(function);
         SetShutdownFlag(function);
 
         // Now wake up the threads so they see it is time to shutdown.
         function.PthreadCondBroadcast(GetWorkAvailableConditionVariablePointer(function));
+        UnlockQueueMutex(function);
         // Now PopNextTask will emit null tasks
     }
 
@@ -285,16 +783,20 @@ namespace emitters
         auto boolType = llvm::Type::getInt1Ty(context);
 
         auto isNotDoneVar = function.Variable(boolType, "isNotDone");
-        auto mutex = GetQueueMutexPointer(function);
-        auto workFinishedCondVar = GetWorkFinishedConditionVariablePointer(function);
 
-        LockQueueMutex(function);
-        function.Store(isNotDoneVar, function.Operator(UnaryOperatorType::logicalNot, IsFinished(function)));
-        function.While(isNotDoneVar, [=](auto& function) {
-            function.PthreadCondWait(workFinishedCondVar, mutex);
-            function.Store(isNotDoneVar, function.Operator(UnaryOperatorType::logicalNot, this->IsFinished(function))); // STYLE gcc bug requires `this->` inside generic lambda (https://gcc.gnu.org/bugzilla/show_bug.cgi?id=67274)
+        // Tasks that were run inline have already finished
+        function.If(function.LogicalNot(function.Load(_runTasksInline)), [this, isNotDoneVar](IRFunctionEmitter& function) {
+            auto mutex = GetQueueMutexPointer(function);
+            auto workFinishedCondVar = GetWorkFinishedConditionVariablePointer(function);
+
+            LockQueueMutex(function);
+            function.Store(isNotDoneVar, function.Operator(UnaryOperatorType::logicalNot, IsFinished(function)));
+            function.While(isNotDoneVar, [=](auto& function) {
+                function.PthreadCondWait(workFinishedCondVar, mutex);
+                function.Store(isNotDoneVar, function.Operator(UnaryOperatorType::logicalNot, this->IsFinished(function))); // STYLE gcc bug requires `this->` inside generic lambda (https://gcc.gnu.org/bugzilla/show_bug.cgi?id=67274)
+            });
+            UnlockQueueMutex(function);
         });
-        UnlockQueueMutex(function);
     }
 
     llvm::StructType* IRThreadPoolTaskQueue::GetTaskQueueDataType(IRModuleEmitter& module) const // TODO: come up with a naming convention for "class" structs like this
@@ -304,8 +806,9 @@ namespace emitters
         auto conditionVarType = module.GetRuntime().GetPosixEmitter().GetPthreadCondType();
         auto boolType = llvm::Type::getInt1Ty(context);
         auto int32Type = llvm::Type::getInt32Ty(context);
+        auto int64PtrType = llvm::Type::getInt64PtrTy(context);
 
-        std::vector<LLVMType> fieldTypes = { mutexType, conditionVarType, conditionVarType, int32Type, int32Type, boolType };
+        std::vector<LLVMType> fieldTypes = { mutexType, conditionVarType, conditionVarType, int32Type, int32Type, boolType, int32Type, int64PtrType, int32Type };
         return module.GetAnonymousStructType(fieldTypes);
     }
 
@@ -336,9 +839,10 @@ namespace emitters
 
     LLVMValue IRThreadPoolTaskQueue::GetUnfinishedCount(IRFunctionEmitter& function) const
     {
+        // Workers that steal tasks decrement the count without holding the mutex
         assert(IsInitialized());
         auto fieldPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unfinishedCount));
-        return function.Load(fieldPtr);
+        return AtomicLoad(function, fieldPtr, sizeof(int));
     }
 
     void IRThreadPoolTaskQueue::SetInitialCount(IRFunctionEmitter& function, LLVMValue numTasks)
@@ -476,7 +980,7 @@ namespace emitters
         auto int8PtrPtrType = int8PtrType->getPointerTo();
         auto int32Type = llvm::Type::getInt32Ty(context);
 
-        std::vector<LLVMType> fieldTypes = { int8PtrType, int8PtrPtrType, int8PtrType, int32Type };
+        std::vector<LLVMType> fieldTypes = { int8PtrType, int8PtrPtrType, int8PtrType, int32Type, int8PtrType, int32Type };
         return module.GetAnonymousStructType(fieldTypes);
     }
 
@@ -560,6 +1064,67 @@ namespace emitters
         }
     }
 
+    void IRThreadPoolTaskArray::SetTasks(IRFunctionEmitter& function, LLVMFunction taskFunction, LLVMValue numTasks, TaskArgumentsFunction getArguments)
+    {
+        // The argument structs and return values can't live on the stack when the number of tasks isn't known
+        // at compile time, so they go in a heap buffer that is kept between calls and only grows:
+        //
+        // int size = numTasks * (argStructSize + sizeof(void*));
+        // if (size > heapStorageSize)
+        // {
+        //     free(heapStorage);
+        //     heapStorage = malloc(size);
+        //     heapStorageSize = size;
+        // }
+        // argStorage = heapStorage;
+        // returnValues = heapStorage + numTasks * argStructSize;
+        //
+        assert(_taskArrayData != nullptr);
+
+        auto& module = function.GetModule();
+        auto& context = function.GetLLVMContext();
+        auto int8PtrType = llvm::Type::getInt8PtrTy(context);
+        auto int8PtrPtrType = int8PtrType->getPointerTo();
+
+        auto argStructType = GetTaskArgStructType(module, taskFunction);
+        auto wrappedTaskFunction = GetTaskWrapperFunction(module, taskFunction);
+        function.Store(GetTaskFunctionPointer(function), function.BitCast(wrappedTaskFunction, int8PtrType));
+
+        // Round the struct size up so the return values that follow the structs are aligned
+        const auto& dataLayout = module.GetTargetDataLayout();
+        const int pointerSize = static_cast<int>(dataLayout.getPointerSize());
+        const int argStructSize = ((static_cast<int>(dataLayout.getTypeAllocSize(argStructType)) + pointerSize - 1) / pointerSize) * pointerSize;
+        SetTaskArgsStructSize(function, function.Literal<int>(argStructSize));
+
+        auto heapStoragePtr = function.GetStructFieldPointer(_taskArrayData, static_cast<int>(Fields::heapStorage));
+        auto heapStorageSizePtr = function.GetStructFieldPointer(_taskArrayData, static_cast<int>(Fields::heapStorageSize));
+        auto argsSize = function.Operator(TypedOperator::multiply, numTasks, function.Literal<int>(argStructSize));
+        auto size = function.Operator(TypedOperator::add, argsSize, function.Operator(TypedOperator::multiply, numTasks, function.Literal<int>(pointerSize)));
+        function.If(TypedComparison::greaterThan, size, function.Load(heapStorageSizePtr), [heapStoragePtr, heapStorageSizePtr, size, int8PtrType](IRFunctionEmitter& function) {
+            function.Free(function.Load(heapStoragePtr));
+            function.Store(heapStoragePtr, function.Malloc(int8PtrType, function.CastValue(size, VariableType::Int64)));
+            function.Store(heapStorageSizePtr, size);
+        });
+
+        auto heapStorage = function.Load(heapStoragePtr);
+        function.Store(GetTaskArgsStoragePointer(function), heapStorage);
+        function.Store(GetReturnValuesStoragePointer(function), function.CastPointer(function.PointerOffset(heapStorage, argsSize), int8PtrPtrType));
+
+        auto argStructPtrType = argStructType->getPointerTo();
+        function.For(numTasks, [heapStorage, argStructSize, argStructPtrType, getArguments](IRFunctionEmitter& function, LLVMValue taskIndex) {
+            auto offset = function.Operator(TypedOperator::multiply, taskIndex, function.Literal<int>(argStructSize));
+            auto taskData = function.CastPointer(function.PointerOffset(heapStorage, offset), argStructPtrType);
+            function.FillStruct(taskData, getArguments(function, taskIndex));
+        });
+    }
+
+    void IRThreadPoolTaskArray::FreeHeapStorage(IRFunctionEmitter& function)
+    {
+        assert(_taskArrayData != nullptr);
+        auto heapStoragePtr = function.GetStructFieldPointer(_taskArrayData, static_cast<int>(Fields::heapStorage));
+        function.Free(function.Load(heapStoragePtr));
+    }
+
     void IRThreadPoolTaskArray::WaitAll(IRFunctionEmitter& function)
     {
         // Wait for all the tasks to finish
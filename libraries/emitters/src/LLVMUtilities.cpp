@@ -11,7 +11,11 @@
 
 #include "build/LLVMEmitterTargets.h"
 
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/IR/Module.h>
 #include <llvm/IR/Value.h>
+#include <llvm/Support/raw_ostream.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Target/TargetMachine.h>
 
@@ -186,6 +190,25 @@ namespace emitters
         }
     } // namespace
 
+    std::string WriteModuleToBitcode(const llvm::Module& module)
+    {
+        std::string bitcode;
+        llvm::raw_string_ostream stream(bitcode);
+        llvm::WriteBitcodeToFile(module, stream);
+        stream.flush();
+        return bitcode;
+    }
+
+    std::unique_ptr<llvm::Module> ReadModuleFromBitcode(const std::string& bitcode, llvm::LLVMContext& context)
+    {
+        auto module = llvm::parseBitcodeFile(llvm::MemoryBufferRef(bitcode, "partition"), context);
+        if (!module)
+        {
+            throw EmitterException(EmitterError::unexpected, "Unable to read module partition: " + llvm::toString(module.takeError()));
+        }
+        return std::move(module.get());
+    }
+
     void InitializeLLVM()
     {
         InitializeLLVMTargets();
@@ -17,7 +17,9 @@
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Target/TargetMachine.h>
 
+#include <fstream>
 #include <map>
+#include <string>
 
 namespace ell
 {
@@ -69,18 +71,24 @@ namespace emitters
                  targetDevice.dataLayout = c_armDataLayout;
                  targetDevice.numBits = 32;
                  targetDevice.cpu = c_pi0Cpu; // maybe not necessary
+                 targetDevice.l1CacheSize = 16 * 1024;
+                 targetDevice.l2CacheSize = 128 * 1024;
              } },
             { "pi3", [](TargetDevice& targetDevice) {
                  targetDevice.triple = c_armv7Triple;
                  targetDevice.dataLayout = c_armDataLayout;
                  targetDevice.numBits = 32;
                  targetDevice.cpu = c_pi3Cpu; // maybe not necessary
+                 targetDevice.l1CacheSize = 32 * 1024;
+                 targetDevice.l2CacheSize = 512 * 1024;
              } },
             { "orangepi0" /* orangepi (Raspbian) */, [](TargetDevice& targetDevice) {
                  targetDevice.triple = c_armv7Triple;
                  targetDevice.dataLayout = c_armDataLayout;
                  targetDevice.numBits = 32;
                  targetDevice.cpu = c_orangePi0Cpu; // maybe not necessary
+                 targetDevice.l1CacheSize = 32 * 1024;
+                 targetDevice.l2CacheSize = 512 * 1024;
              } },
             { "pi3_64" /* pi3 (openSUSE) */, [](TargetDevice& targetDevice) {
                  // need to set arch to aarch64?
@@ -88,6 +96,8 @@ namespace emitters
                  targetDevice.dataLayout = c_arm64DataLayout;
                  targetDevice.numBits = 64;
                  targetDevice.cpu = c_pi3Cpu;
+                 targetDevice.l1CacheSize = 32 * 1024;
+                 targetDevice.l2CacheSize = 512 * 1024;
              } },
             { "aarch64" /* arm64 linux (DragonBoard) */, [](TargetDevice& targetDevice) {
                  // need to set arch to aarch64?
@@ -125,6 +135,7 @@ namespace emitters
 
         // Function prototypes used internally
         void SetHostTargetProperties(TargetDevice& targetDevice);
+        void SetHostCacheSizes(TargetDevice& targetDevice);
         bool HasKnownDeviceName(TargetDevice& targetDevice);
         void SetTargetPropertiesFromName(TargetDevice& targetDevice);
         void VerifyCustomTargetProperties(TargetDevice& targetDevice);
@@ -244,6 +255,65 @@ namespace emitters
             }
 
             SetTargetDataLayout(targetDevice);
+            SetHostCacheSizes(targetDevice);
+        }
+
+        void SetHostCacheSizes(TargetDevice& targetDevice)
+        {
+            // Linux describes the caches of each CPU in sysfs; elsewhere, the sizes stay unknown
+            const std::string cacheDirectory = "/sys/devices/system/cpu/cpu0/cache/index";
+            for (int index = 0;; ++index)
+            {
+                auto readEntry = [&](const std::string& name) {
+                    std::ifstream file(cacheDirectory + std::to_string(index) + "/" + name);
+                    std::string value;
+                    std::getline(file, value);
+                    return value;
+                };
+
+                auto level = readEntry("level");
+                if (level.empty())
+                {
+                    break;
+                }
+                if (readEntry("type") == "Instruction")
+                {
+                    continue;
+                }
+
+                // e.g., "32K" or "8192K"
+                auto sizeString = readEntry("size");
+                size_t size = 0;
+                try
+                {
+                    size = std::stoul(sizeString);
+                }
+                catch (const std::exception&)
+                {
+                    continue;
+                }
+                if (!sizeString.empty() && sizeString.back() == 'K')
+                {
+                    size *= 1024;
+                }
+                else if (!sizeString.empty() && sizeString.back() == 'M')
+                {
+                    size *= 1024 * 1024;
+                }
+
+                if (level == "1")
+                {
+                    targetDevice.l1CacheSize = size;
+                }
+                else if (level == "2")
+                {
+                    targetDevice.l2CacheSize = size;
+                }
+                else if (level == "3")
+                {
+                    targetDevice.l3CacheSize = size;
+                }
+            }
         }
 
         bool HasKnownDeviceName(TargetDevice& targetDevice)
@@ -11,4 +11,4 @@ void TestIRAsyncTask(bool parallel);
 
 void TestParallelTasks(bool parallel, bool useThreadPool);
 
-void TestParallelFor(int start, int end, int increment, bool parallel);
+void TestParallelFor(int start, int end, int increment, bool parallel, bool useWorkStealing = true);
@@ -212,13 +212,14 @@ void TestParallelTasks(bool parallel, bool useThreadPool)
 //
 // TestParallelFor
 //
-void TestParallelFor(int begin, int end, int increment, bool parallel)
+void TestParallelFor(int begin, int end, int increment, bool parallel, bool useWorkStealing)
 {
     CompilerOptions options;
     options.optimize = false;
     options.targetDevice.deviceName = "host";
     options.parallelize = parallel;
     options.useThreadPool = true;
+    options.useWorkStealing = useWorkStealing;
     IRModuleEmitter module("ParallelForTest", options);
 
     // Function to run test
@@ -258,7 +259,7 @@ void TestParallelFor(int begin, int end, int increment, bool parallel)
         // Call the function
         auto functionPtr = (IntFunction)executionEngine.ResolveFunctionAddress(functionName);
         auto result = functionPtr();
-        testing::ProcessTest("Testing compilable parallel for loop", testing::IsEqual(result, 0));
+        testing::ProcessTest(std::string("Testing compilable parallel for loop") + (useWorkStealing ? "" : " with a shared task queue"), testing::IsEqual(result, 0));
     }
     catch (utilities::Exception& exception)
     {
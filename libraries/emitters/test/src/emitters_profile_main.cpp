@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     emitters_profile_main.cpp (emitters)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <emitters/include/CompilerOptions.h>
+#include <emitters/include/EmitterTypes.h>
+#include <emitters/include/IRExecutionEngine.h>
+#include <emitters/include/IRFunctionEmitter.h>
+#include <emitters/include/IRLocalScalar.h>
+#include <emitters/include/IRModuleEmitter.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/MillisecondTimer.h>
+
+#include <iostream>
+#include <string>
+
+using namespace ell;
+using namespace ell::emitters;
+
+using VoidFunction = void (*)();
+using SetMaxThreadsFunction = void (*)(int);
+
+// Times a parallel loop whose iterations get more expensive as the index grows (iteration i does i units of work),
+// so splitting it into one contiguous block per thread leaves most threads idle while the last one finishes.
+// `compiledThreads` is the maxThreads compiler option, and `numThreads` is the pool size set at runtime.
+// `useWorkStealing` picks between the pool's per-worker task ranges and its single shared queue.
+// Returns the time per call, in milliseconds.
+double ProfileParallelFor(int numIterations, int compiledThreads, int numThreads, bool useThreadPool, bool useWorkStealing, int tasksPerThread, int repetitions)
+{
+    CompilerOptions options;
+    options.optimize = true;
+    options.targetDevice.deviceName = "host";
+    options.parallelize = true;
+    options.useThreadPool = useThreadPool;
+    options.maxThreads = compiledThreads;
+    options.tasksPerThread = tasksPerThread;
+    options.useWorkStealing = useWorkStealing;
+    const std::string moduleName = "ParallelForProfile";
+    IRModuleEmitter module(moduleName, options);
+
+    const std::string functionName = "ProfileParallelFor";
+    auto function = module.BeginFunction(functionName, VariableType::Void);
+    {
+        auto data = module.GlobalArray(VariableType::Double, "data", numIterations);
+        function.ParallelFor(0, numIterations, 1, {}, { data }, [](IRFunctionEmitter& function, LLVMValue i, std::vector<LLVMValue> capturedValues) {
+            auto data = capturedValues[0];
+            auto sum = function.Variable(VariableType::Double, "sum");
+            function.Store(sum, function.Literal<double>(0.0));
+            function.For(i, [sum](IRFunctionEmitter& function, LLVMValue j) {
+                auto x = function.LocalScalar(function.CastValue<double>(j));
+                function.Store(sum, function.LocalScalar(function.Load(sum)) + x * x);
+            });
+            function.SetValueAt(data, i, function.Load(sum));
+        });
+    }
+    module.EndFunction();
+
+    IRExecutionEngine executionEngine(std::move(module));
+    auto functionPtr = (VoidFunction)executionEngine.ResolveFunctionAddress(functionName);
+    if (useThreadPool)
+    {
+        // The thread pool's size can be changed at runtime, up until the first time tasks are run
+        auto setMaxThreads = (SetMaxThreadsFunction)executionEngine.ResolveFunctionAddress(moduleName + "_SetMaxThreads");
+        setMaxThreads(numThreads);
+    }
+
+    functionPtr(); // warm-up, and starts the thread pool
+    utilities::MillisecondTimer timer;
+    for (int index = 0; index < repetitions; ++index)
+    {
+        functionPtr();
+    }
+    return static_cast<double>(timer.Elapsed()) / repetitions;
+}
+
+void PrintResult(const std::string& name, int numThreads, double time, double baselineTime)
+{
+    std::cout << "ParallelFor, " << numThreads << " threads, " << name << ": " << time << " ms per call, "
+              << (baselineTime / time) << "x the previous pool" << std::endl;
+}
+
+int main()
+{
+    try
+    {
+        const int numIterations = 4000;
+        const int repetitions = 20;
+        for (int numThreads : { 1, 2, 4, 8, 16 })
+        {
+            // The previous pool split each loop into one task per thread, with the count fixed at compile time, and
+            // handed the tasks out from one shared queue, which is what the pool still does without work stealing
+            auto baseline = ProfileParallelFor(numIterations, numThreads, numThreads, true, false, 1, repetitions);
+            PrintResult("previous pool (one task per thread)", numThreads, baseline, baseline);
+            PrintResult("thread per task", numThreads, ProfileParallelFor(numIterations, numThreads, numThreads, false, false, 1, repetitions), baseline);
+            for (int tasksPerThread : { 1, 4, 16 })
+            {
+                auto tasks = std::to_string(tasksPerThread) + " tasks per thread";
+                if (tasksPerThread != 1)
+                {
+                    PrintResult("shared queue, " + tasks, numThreads, ProfileParallelFor(numIterations, numThreads, numThreads, true, false, tasksPerThread, repetitions), baseline);
+                }
+                PrintResult("work stealing, " + tasks, numThreads, ProfileParallelFor(numIterations, numThreads, numThreads, true, true, tasksPerThread, repetitions), baseline);
+            }
+
+            // Compiled for one thread, but sized at runtime: loops are split by the runtime thread count
+            PrintResult("work stealing, 4 tasks per thread, sized at runtime", numThreads, ProfileParallelFor(numIterations, 1, numThreads, true, true, 4, repetitions), baseline);
+        }
+    }
+    catch (const utilities::Exception& exception)
+    {
+        std::cerr << "ERROR, got ELL exception. Message: " << exception.GetMessage() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -86,6 +86,9 @@ void TestAsyncEmitter()
     TestParallelFor(10, 90, 2, true);
     TestParallelFor(10, 90, 3, true);
     TestParallelFor(30, 40, 11, true);
+    TestParallelFor(0, 100, 1, true, false);
+    TestParallelFor(10, 90, 3, true, false);
+    TestParallelFor(30, 40, 11, true, false);
 }
 
 void TestPosixEmitter()
@@ -34,6 +34,11 @@ namespace evaluators
         /// <summary> Resets the aggregator to its initial state. </summary>
         void Reset();
 
+        /// <summary> Adds the examples seen by another aggregator to this one. Used to combine the aggregators of parallel shards of a dataset. </summary>
+        ///
+        /// <param name="other"> The aggregator to merge into this one. </param>
+        void Merge(const BinaryErrorAggregator& other);
+
         /// <summary> Gets a header that describes the values of this aggregator. </summary>
         ///
         /// <returns> The header string vector. </returns>
@@ -14,10 +14,13 @@
 #include <data/include/Example.h>
 
 #include <utilities/include/FunctionUtils.h>
+#include <utilities/include/ThreadPool.h>
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
 namespace ell
@@ -54,9 +57,28 @@ namespace evaluators
     {
         size_t evaluationFrequency;
         bool addZeroEvaluation;
+        size_t numThreads = 1; // zero means one thread per hardware thread
     };
 
-    /// <summary> Implements an evaluator that holds a data set and a set of evaluation aggregators. </summary>
+    /// <summary>
+    /// Computes the outputs of a predictor on a contiguous block of examples from a dataset. Predictors that have a
+    /// `PredictBatch(const std::vector<const DataVectorType*>&)` member get the whole block in one call (for example,
+    /// so a linear predictor can use a matrix-vector product); other predictors are called once per example.
+    /// </summary>
+    ///
+    /// <param name="predictor"> The predictor. </param>
+    /// <param name="dataset"> The dataset. </param>
+    /// <param name="begin"> The index of the first example in the block. </param>
+    /// <param name="end"> One past the index of the last example in the block. </param>
+    /// <param name="predictions"> [out] The predictions, one per example in the block. </param>
+    template <typename PredictorType, typename DatasetType>
+    void PredictBlock(const PredictorType& predictor, const DatasetType& dataset, size_t begin, size_t end, std::vector<double>& predictions);
+
+    /// <summary>
+    /// Implements an evaluator that holds a data set and a set of evaluation aggregators. Evaluation splits the data
+    /// set into one contiguous shard per thread; each shard updates its own copy of the aggregators, and the copies
+    /// are merged in shard order at the end.
+    /// </summary>
     ///
     /// <typeparam name="PredictorType"> The predictor type. </typeparam>
     /// <typeparam name="AggregatorTypes"> The aggregator types. </typeparam>
@@ -104,6 +126,7 @@ namespace evaluators
 
         template <size_t Index>
         using AggregatorType = typename std::tuple_element<Index, std::tuple<AggregatorTypes...>>::type;
+        using AggregatorTupleType = std::tuple<AggregatorTypes...>;
 
         struct ElementUpdaterParameters
         {
@@ -137,7 +160,7 @@ namespace evaluators
         };
 
         template <std::size_t Index>
-        auto GetElementUpdateFunction(const ElementUpdaterParameters& params) -> ElementUpdater<AggregatorType<Index>>;
+        auto GetElementUpdateFunction(AggregatorTupleType& aggregators, const ElementUpdaterParameters& params) -> ElementUpdater<AggregatorType<Index>>;
 
         template <std::size_t Index>
         auto GetElementResetFunction() -> ElementResetter<AggregatorType<Index>>;
@@ -145,6 +168,16 @@ namespace evaluators
         template <std::size_t... Sequence>
         void DispatchUpdate(double prediction, double label, double weight, std::index_sequence<Sequence...>);
 
+        template <std::size_t... Sequence>
+        void DispatchUpdate(AggregatorTupleType& aggregators, double prediction, double label, double weight, std::index_sequence<Sequence...>);
+
+        template <std::size_t... Sequence>
+        void MergeAggregators(const AggregatorTupleType& aggregators, std::index_sequence<Sequence...>);
+
+        // Calls processBlock(begin, end, aggregators) for consecutive blocks of each shard, in parallel, then merges the shards' aggregators
+        template <typename BlockFunction>
+        void ProcessBlocks(BlockFunction&& processBlock);
+
         template <std::size_t... Sequence>
         void Aggregate(std::index_sequence<Sequence...>);
 
@@ -160,6 +193,9 @@ namespace evaluators
         size_t _evaluateCounter = 0;
         typename std::tuple<AggregatorTypes...> _aggregatorTuple;
         std::vector<std::vector<std::vector<double>>> _values;
+        utilities::ThreadPool _threadPool;
+
+        static constexpr size_t blockSize = 64;
     };
 
     /// <summary> Makes an evaluator. </summary>
@@ -185,7 +221,8 @@ namespace evaluators
     Evaluator<PredictorType, AggregatorTypes...>::Evaluator(const data::AnyDataset& anyDataset, const EvaluatorParameters& evaluatorParameters, AggregatorTypes... aggregators) :
         _dataset(anyDataset),
         _evaluatorParameters(evaluatorParameters),
-        _aggregatorTuple(std::make_tuple(aggregators...))
+        _aggregatorTuple(std::make_tuple(aggregators...)),
+        _threadPool(evaluatorParameters.numThreads)
     {
         static_assert(sizeof...(AggregatorTypes) > 0, "Evaluator must contains at least one aggregator");
 
@@ -204,19 +241,15 @@ namespace evaluators
             return;
         }
 
-        auto iterator = _dataset.GetExampleReferenceIterator();
-
-        while (iterator.IsValid())
-        {
-            const auto& example = iterator.Get();
-
-            double weight = example.GetMetadata().weight;
-            double label = example.GetMetadata().label;
-            double prediction = predictor.Predict(example.GetDataVector());
-
-            DispatchUpdate(prediction, label, weight, std::make_index_sequence<sizeof...(AggregatorTypes)>());
-            iterator.Next();
-        }
+        ProcessBlocks([&](size_t begin, size_t end, AggregatorTupleType& aggregators) {
+            std::vector<double> predictions;
+            PredictBlock(predictor, _dataset, begin, end, predictions);
+            for (size_t index = begin; index < end; ++index)
+            {
+                const auto& metadata = _dataset[index].GetMetadata();
+                DispatchUpdate(aggregators, predictions[index - begin], metadata.label, metadata.weight, std::make_index_sequence<sizeof...(AggregatorTypes)>());
+            }
+        });
         Aggregate(std::make_index_sequence<sizeof...(AggregatorTypes)>());
     }
 
@@ -323,9 +356,9 @@ namespace evaluators
 
     template <typename PredictorType, typename... AggregatorTypes>
     template <std::size_t Index>
-    auto Evaluator<PredictorType, AggregatorTypes...>::GetElementUpdateFunction(const ElementUpdaterParameters& params) -> ElementUpdater<AggregatorType<Index>>
+    auto Evaluator<PredictorType, AggregatorTypes...>::GetElementUpdateFunction(AggregatorTupleType& aggregators, const ElementUpdaterParameters& params) -> ElementUpdater<AggregatorType<Index>>
     {
-        return { std::get<Index>(_aggregatorTuple), params };
+        return { std::get<Index>(aggregators), params };
     }
 
     template <typename PredictorType, typename... AggregatorTypes>
@@ -337,12 +370,51 @@ namespace evaluators
 
     template <typename PredictorType, typename... AggregatorTypes>
     template <std::size_t... Sequence>
-    void Evaluator<PredictorType, AggregatorTypes...>::DispatchUpdate(double prediction, double label, double weight, std::index_sequence<Sequence...>)
+    void Evaluator<PredictorType, AggregatorTypes...>::DispatchUpdate(double prediction, double label, double weight, std::index_sequence<Sequence...> sequence)
+    {
+        DispatchUpdate(_aggregatorTuple, prediction, label, weight, sequence);
+    }
+
+    template <typename PredictorType, typename... AggregatorTypes>
+    template <std::size_t... Sequence>
+    void Evaluator<PredictorType, AggregatorTypes...>::DispatchUpdate(AggregatorTupleType& aggregators, double prediction, double label, double weight, std::index_sequence<Sequence...>)
     {
-        // Call (X.Update(), 0) for each X in _aggregatorTuple
+        // Call (X.Update(), 0) for each X in aggregators
         ElementUpdaterParameters params{ prediction, label, weight };
-        utilities::InOrderFunctionEvaluator(GetElementUpdateFunction<Sequence>(params)...);
-        // [this, prediction, label, weight]() { std::get<Sequence>(_aggregatorTuple).Update(prediction, label, weight); }...); // GCC bug prevents compilation
+        utilities::InOrderFunctionEvaluator(GetElementUpdateFunction<Sequence>(aggregators, params)...);
+        // [this, prediction, label, weight]() { std::get<Sequence>(aggregators).Update(prediction, label, weight); }...); // GCC bug prevents compilation
+    }
+
+    template <typename PredictorType, typename... AggregatorTypes>
+    template <std::size_t... Sequence>
+    void Evaluator<PredictorType, AggregatorTypes...>::MergeAggregators(const AggregatorTupleType& aggregators, std::index_sequence<Sequence...>)
+    {
+        // Call X.Merge(Y) for each X in _aggregatorTuple and corresponding Y in aggregators
+        (std::get<Sequence>(_aggregatorTuple).Merge(std::get<Sequence>(aggregators)), ...);
+    }
+
+    template <typename PredictorType, typename... AggregatorTypes>
+    template <typename BlockFunction>
+    void Evaluator<PredictorType, AggregatorTypes...>::ProcessBlocks(BlockFunction&& processBlock)
+    {
+        // the shards are contiguous and merged in order, so the results only depend on the number of shards
+        auto numExamples = _dataset.NumExamples();
+        auto numShards = std::max<size_t>(1, std::min(_threadPool.NumThreads(), (numExamples + blockSize - 1) / blockSize));
+        std::vector<AggregatorTupleType> shardAggregators(numShards, _aggregatorTuple);
+        _threadPool.ParallelFor(numShards, [&](size_t shardIndex) {
+            auto shardBegin = numExamples * shardIndex / numShards;
+            auto shardEnd = numExamples * (shardIndex + 1) / numShards;
+            for (auto begin = shardBegin; begin < shardEnd; begin += blockSize)
+            {
+                processBlock(begin, std::min(begin + blockSize, shardEnd), shardAggregators[shardIndex]);
+            }
+        });
+
+        _aggregatorTuple = std::move(shardAggregators[0]);
+        for (size_t shardIndex = 1; shardIndex < numShards; ++shardIndex)
+        {
+            MergeAggregators(shardAggregators[shardIndex], std::make_index_sequence<sizeof...(AggregatorTypes)>());
+        }
     }
 
     template <typename PredictorType, typename... AggregatorTypes>
@@ -370,6 +442,41 @@ namespace evaluators
         return { std::get<Sequence>(_aggregatorTuple).GetValueNames()... };
     }
 
+    namespace detail
+    {
+        template <typename PredictorType, typename = void>
+        struct HasPredictBatch : std::false_type
+        {};
+
+        template <typename PredictorType>
+        struct HasPredictBatch<PredictorType, std::void_t<decltype(std::declval<const PredictorType&>().PredictBatch(std::declval<const std::vector<const typename PredictorType::DataVectorType*>&>()))>> : std::true_type
+        {};
+    } // namespace detail
+
+    template <typename PredictorType, typename DatasetType>
+    void PredictBlock(const PredictorType& predictor, const DatasetType& dataset, size_t begin, size_t end, std::vector<double>& predictions)
+    {
+        predictions.resize(end - begin);
+        if constexpr (detail::HasPredictBatch<PredictorType>::value)
+        {
+            std::vector<const typename PredictorType::DataVectorType*> dataVectors;
+            dataVectors.reserve(end - begin);
+            for (size_t index = begin; index < end; ++index)
+            {
+                dataVectors.push_back(&dataset[index].GetDataVector());
+            }
+            auto batchPredictions = predictor.PredictBatch(dataVectors);
+            std::copy(batchPredictions.begin(), batchPredictions.end(), predictions.begin());
+        }
+        else
+        {
+            for (size_t index = begin; index < end; ++index)
+            {
+                predictions[index - begin] = predictor.Predict(dataset[index].GetDataVector());
+            }
+        }
+    }
+
     template <typename PredictorType, typename... AggregatorTypes>
     std::shared_ptr<IEvaluator<PredictorType>> MakeEvaluator(const data::AnyDataset& anyDataset, const EvaluatorParameters& evaluatorParameters, AggregatorTypes... aggregators)
     {
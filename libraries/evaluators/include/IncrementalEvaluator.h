@@ -117,25 +117,21 @@ namespace evaluators
         ++BaseClassType::_evaluateCounter;
         bool evaluate = BaseClassType::_evaluateCounter % BaseClassType::_evaluatorParameters.evaluationFrequency == 0 ? true : false;
 
-        auto iterator = BaseClassType::_dataset.GetExampleIterator();
-        size_t index = 0;
-
-        while (iterator.IsValid())
-        {
-            const auto& example = iterator.Get();
-
-            double exampleWeight = example.GetMetadata().weight;
-            double label = example.GetMetadata().label;
-            _predictions[index] += basePredictorWeight * basePredictor.Predict(example.GetDataVector());
-
-            if (evaluate)
+        // each shard only touches the cached predictions of its own examples
+        BaseClassType::ProcessBlocks([&](size_t begin, size_t end, auto& aggregators) {
+            std::vector<double> basePredictions;
+            PredictBlock(basePredictor, BaseClassType::_dataset, begin, end, basePredictions);
+            for (size_t index = begin; index < end; ++index)
             {
-                BaseClassType::DispatchUpdate(_predictions[index] * evaluationRescale, label, exampleWeight, std::make_index_sequence<sizeof...(AggregatorTypes)>());
-            }
+                _predictions[index] += basePredictorWeight * basePredictions[index - begin];
 
-            iterator.Next();
-            ++index;
-        }
+                if (evaluate)
+                {
+                    const auto& metadata = BaseClassType::_dataset[index].GetMetadata();
+                    BaseClassType::DispatchUpdate(aggregators, _predictions[index] * evaluationRescale, metadata.label, metadata.weight, std::make_index_sequence<sizeof...(AggregatorTypes)>());
+                }
+            }
+        });
         if (evaluate)
         {
             BaseClassType::Aggregate(std::make_index_sequence<sizeof...(AggregatorTypes)>());
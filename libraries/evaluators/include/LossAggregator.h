@@ -42,6 +42,11 @@ namespace evaluators
         /// <summary> Resets the aggregator to its initial state. </summary>
         void Reset();
 
+        /// <summary> Adds the examples seen by another aggregator to this one. Used to combine the aggregators of parallel shards of a dataset. </summary>
+        ///
+        /// <param name="other"> The aggregator to merge into this one. </param>
+        void Merge(const LossAggregator& other);
+
         /// <summary> Gets a header that describes the values of this aggregator. </summary>
         ///
         /// <returns> The header string vector. </returns>
@@ -78,6 +83,13 @@ namespace evaluators
         _sumWeightedLosses += weight * loss;
     }
 
+    template <typename LossFunctionType>
+    void LossAggregator<LossFunctionType>::Merge(const LossAggregator& other)
+    {
+        _sumWeights += other._sumWeights;
+        _sumWeightedLosses += other._sumWeightedLosses;
+    }
+
     template <typename LossFunctionType>
     std::vector<double> LossAggregator<LossFunctionType>::GetResult() const
     {
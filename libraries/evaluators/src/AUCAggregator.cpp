@@ -19,6 +19,11 @@ namespace evaluators
         _aggregates.push_back(Aggregate{ prediction, label, weight });
     }
 
+    void AUCAggregator::Merge(const AUCAggregator& other)
+    {
+        _aggregates.insert(_aggregates.end(), other._aggregates.begin(), other._aggregates.end());
+    }
+
     std::vector<double> AUCAggregator::GetResult() const
     {
         // sort aggregates by prediction
@@ -10,4 +10,5 @@
 namespace ell
 {
 void TestEvaluators();
+void TestParallelEvaluators();
 }
\ No newline at end of file
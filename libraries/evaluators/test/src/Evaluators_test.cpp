@@ -14,6 +14,7 @@
 
 #include <evaluators/include/AUCAggregator.h>
 #include <evaluators/include/Evaluator.h>
+#include <evaluators/include/IncrementalEvaluator.h>
 #include <evaluators/include/LossAggregator.h>
 
 #include <functions/include/SquaredLoss.h>
@@ -45,4 +46,68 @@ void TestEvaluators()
     std::cout << "Goodness: " << evaluator->GetGoodness() << std::endl;
     testing::ProcessTest("Evaluator sanity check", !testing::IsEqual(evaluator->GetGoodness(), 0.0, 1e-8));
 }
+
+namespace
+{
+    std::vector<double> FlattenValues(const std::vector<std::vector<std::vector<double>>>& values)
+    {
+        std::vector<double> result;
+        for (const auto& evaluation : values)
+        {
+            for (const auto& aggregatorValues : evaluation)
+            {
+                result.insert(result.end(), aggregatorValues.begin(), aggregatorValues.end());
+            }
+        }
+        return result;
+    }
+} // namespace
+
+void TestParallelEvaluators()
+{
+    using PredictorType = predictors::LinearPredictor<double>;
+    using LossAggregatorType = evaluators::LossAggregator<functions::SquaredLoss>;
+    using EvaluatorType = evaluators::Evaluator<PredictorType, evaluators::BinaryErrorAggregator, evaluators::AUCAggregator, LossAggregatorType>;
+    using IncrementalEvaluatorType = evaluators::IncrementalEvaluator<PredictorType, evaluators::BinaryErrorAggregator, evaluators::AUCAggregator, LossAggregatorType>;
+
+    // enough examples for several blocks per thread, and a partial block at the end
+    using ExampleType = data::DenseSupervisedDataset::DatasetExampleType;
+    data::DenseSupervisedDataset dataset;
+    for (int i = 0; i < 1000; ++i)
+    {
+        double x = (i % 17) - 8.0;
+        double y = (i % 5) - 2.0;
+        dataset.AddExample(ExampleType{ { x, y, 1.0 }, data::WeightLabel{ 1.0 + (i % 3), (i % 7) < 3 ? 1.0 : -1.0 } });
+    }
+
+    PredictorType predictor({ 0.5, -1.0, 0.25 }, 0.125);
+    PredictorType basePredictor({ 0.25, 0.5, -0.5 }, 0.0);
+    auto aggregators = std::make_tuple(evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(), evaluators::MakeLossAggregator(functions::SquaredLoss()));
+
+    EvaluatorType serialEvaluator(dataset.GetAnyDataset(), { 1, true, 1 }, std::get<0>(aggregators), std::get<1>(aggregators), std::get<2>(aggregators));
+    EvaluatorType parallelEvaluator(dataset.GetAnyDataset(), { 1, true, 4 }, std::get<0>(aggregators), std::get<1>(aggregators), std::get<2>(aggregators));
+    serialEvaluator.Evaluate(predictor);
+    parallelEvaluator.Evaluate(predictor);
+    testing::ProcessTest("Parallel Evaluator", testing::IsEqual(FlattenValues(serialEvaluator.GetValues()), FlattenValues(parallelEvaluator.GetValues()), 1e-12));
+
+    IncrementalEvaluatorType serialIncrementalEvaluator(dataset.GetAnyDataset(), { 1, false, 1 }, std::get<0>(aggregators), std::get<1>(aggregators), std::get<2>(aggregators));
+    IncrementalEvaluatorType parallelIncrementalEvaluator(dataset.GetAnyDataset(), { 1, false, 4 }, std::get<0>(aggregators), std::get<1>(aggregators), std::get<2>(aggregators));
+    for (int round = 0; round < 3; ++round)
+    {
+        serialIncrementalEvaluator.IncrementalEvaluate(basePredictor, 0.5, 2.0);
+        parallelIncrementalEvaluator.IncrementalEvaluate(basePredictor, 0.5, 2.0);
+    }
+    testing::ProcessTest("Parallel IncrementalEvaluator", testing::IsEqual(FlattenValues(serialIncrementalEvaluator.GetValues()), FlattenValues(parallelIncrementalEvaluator.GetValues()), 1e-12));
+
+    // the batched predictions of a linear predictor match its per-example predictions
+    data::AutoSupervisedDataset autoDataset(dataset.GetAnyDataset());
+    std::vector<double> batchPredictions;
+    evaluators::PredictBlock(predictor, autoDataset, 0, 100, batchPredictions);
+    std::vector<double> examplePredictions;
+    for (size_t index = 0; index < 100; ++index)
+    {
+        examplePredictions.push_back(predictor.Predict(autoDataset[index].GetDataVector()));
+    }
+    testing::ProcessTest("Linear predictor PredictBatch", testing::IsEqual(batchPredictions, examplePredictions, 1e-12));
+}
 } // namespace ell
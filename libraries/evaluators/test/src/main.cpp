@@ -24,6 +24,7 @@ int main()
     try
     {
         TestEvaluators();
+        TestParallelEvaluators();
     }
     catch (const utilities::Exception& exception)
     {
@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BatchedMap.h (model)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Map.h"
+
+namespace ell
+{
+namespace model
+{
+    /// <summary>
+    /// Indicates if `CreateBatchedMap` can batch a map: it must have a single input and a single output,
+    /// no source or sink nodes, and no padding on its input or output.
+    /// </summary>
+    ///
+    /// <param name="map"> The map to check. </param>
+    ///
+    /// <returns> If the map can be batched, true, else false. </returns>
+    bool CanBatchMap(const Map& map);
+
+    /// <summary>
+    /// Creates a map that computes a stateless map on a batch of samples at once. The batched map's input and output
+    /// hold the samples' inputs and outputs one after another. Nodes that only depend on constants compute the same values
+    /// for every sample, so they're copied once and shared by all the samples. Nodes that can compute the whole batch
+    /// at once (see `Node::TryCopyBatched`, e.g., a matrix-vector product becomes one matrix-matrix product) do so, and
+    /// all other nodes are copied once per sample.
+    /// </summary>
+    ///
+    /// <param name="map"> The map to batch. Nodes in it are copied, not refined, so it should already be refined. </param>
+    /// <param name="batchSize"> The number of samples in a batch. </param>
+    ///
+    /// <returns> The batched map. </returns>
+    Map CreateBatchedMap(const Map& map, int batchSize);
+} // namespace model
+} // namespace ell
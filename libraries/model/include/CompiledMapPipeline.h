@@ -0,0 +1,534 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     CompiledMapPipeline.h (model)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "IRCompiledMap.h"
+#include "InputNodeBase.h"
+#include "OutputNodeBase.h"
+#include "Port.h"
+
+#include <utilities/include/CallbackRegistry.h>
+#include <utilities/include/Exception.h>
+#include <utilities/include/RingBuffer.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    /// <summary> Options for running a compiled map in a `CompiledMapPipeline`. </summary>
+    struct CompiledMapPipelineOptions
+    {
+        /// <summary> The number of frames that can wait between each source and the compute thread, and between the compute thread and each sink. </summary>
+        size_t queueDepth = 4;
+
+        /// <summary> If `true`, a frame that finds its queue full is dropped, so that a slow stage never holds up the stage
+        /// before it. If `false`, the stage that produced the frame waits until there is room for it. </summary>
+        bool dropFramesWhenFull = true;
+
+        /// <summary> How long a capture thread waits before calling a source callback again after it returned no frame. </summary>
+        std::chrono::microseconds sourcePollInterval{ 1000 };
+    };
+
+    /// <summary> Counters for the frames that have gone through a `CompiledMapPipeline`. </summary>
+    struct CompiledMapPipelineStatistics
+    {
+        size_t framesCaptured = 0; // frames returned by the source callbacks
+        size_t framesComputed = 0; // calls to the compute function
+        size_t framesDelivered = 0; // frames passed to the sink callbacks
+        size_t sourceFramesDropped = 0; // captured frames dropped because a source queue was full
+        size_t sinkFramesDropped = 0; // computed frames dropped because a sink queue was full
+        size_t sourceQueueDepth = 0; // frames currently waiting in the source queues
+        size_t sinkQueueDepth = 0; // frames currently waiting in the sink queues
+    };
+
+    /// <summary>
+    /// Runs a compiled map whose `SourceNode`s and `SinkNode`s have `std::function` callbacks as a three-stage pipeline.
+    /// Each source callback is called on its own capture thread, the map is computed on a compute thread, and each sink
+    /// callback is called on its own delivery thread. The stages are connected by lock-free `ConcurrentRingBuffer` queues,
+    /// so the next frame is captured while the current one is computed, and the previous result is delivered at the same time.
+    /// A stage that finds its queue empty (or full, if frames aren't dropped) sleeps on a condition variable until the other
+    /// end of the queue pops or pushes a frame. Frame buffers are swapped through the queues rather than copied, so once every
+    /// slot has been filled, running the pipeline doesn't allocate. If a source has no frame for the map because the pipeline
+    /// is stopping, the sinks skip the result of that call to the map. While the pipeline runs, the source and sink callbacks of the map are replaced with ones that read from and write to
+    /// the queues; the original callbacks are restored when it stops.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type of the source and sink nodes to run asynchronously. </typeparam>
+    template <typename ElementType>
+    class CompiledMapPipeline
+    {
+    public:
+        /// <summary> A function that is called repeatedly on the compute thread, typically to call `Compute` on the map with the current time. </summary>
+        using ComputeFunction = std::function<void(IRCompiledMap&)>;
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="map"> The compiled map, which must outlive the pipeline. </param>
+        /// <param name="options"> The pipeline options. </param>
+        CompiledMapPipeline(IRCompiledMap& map, const CompiledMapPipelineOptions& options = {});
+
+        CompiledMapPipeline(const CompiledMapPipeline&) = delete;
+        CompiledMapPipeline& operator=(const CompiledMapPipeline&) = delete;
+
+        /// <summary> Destructor. Stops the pipeline if it is running, discarding any exception thrown by a callback. </summary>
+        ~CompiledMapPipeline();
+
+        /// <summary> Start the capture, compute and delivery threads. </summary>
+        ///
+        /// <param name="compute"> The function that computes one frame. </param>
+        void Start(ComputeFunction compute);
+
+        /// <summary> Stop capturing and computing frames, deliver the frames already computed, join the threads and restore
+        /// the map's callbacks. If a callback threw an exception, it is rethrown here. </summary>
+        void Stop();
+
+        /// <summary> Indicates if the pipeline is running. </summary>
+        bool IsRunning() const { return _running; }
+
+        /// <summary> Get the frame counters and queue depths. </summary>
+        CompiledMapPipelineStatistics GetStatistics() const;
+
+    private:
+        using Frame = std::vector<ElementType>;
+
+        struct FrameChannel
+        {
+            explicit FrameChannel(size_t queueDepth) :
+                queue(queueDepth) {}
+
+            utilities::ConcurrentRingBuffer<Frame> queue;
+            std::mutex mutex;
+            std::condition_variable changed; // notified when a frame is pushed or popped, and when the pipeline stops
+            std::atomic<int> waiters{ 0 }; // threads waiting on `changed`, so that pushes and pops only lock and notify when someone waits
+        };
+
+        struct SourceStage
+        {
+            int callbackIndex;
+            size_t frameSize;
+            std::function<bool(Frame&)> callback;
+            std::unique_ptr<FrameChannel> channel;
+            std::thread thread;
+        };
+
+        struct SinkStage
+        {
+            int callbackIndex;
+            std::function<void(const Frame&)> callback;
+            std::unique_ptr<FrameChannel> channel;
+            Frame frame;
+            std::thread thread;
+        };
+
+        void CaptureFrames(SourceStage& stage);
+        void ComputeFrames(const ComputeFunction& compute);
+        void DeliverFrames(SinkStage& stage);
+        bool ReceiveFrame(SourceStage& stage, Frame& data);
+        void SendFrame(SinkStage& stage, const Frame& data);
+        void PushFrame(FrameChannel& channel, Frame& frame, std::atomic<size_t>& framesDropped);
+        bool PopFrame(FrameChannel& channel, Frame& frame, const std::atomic<bool>& keepWaiting);
+        void Notify(FrameChannel& channel);
+        void NotifyAll();
+        void SetError(std::exception_ptr error);
+
+        IRCompiledMap& _map;
+        CompiledMapPipelineOptions _options;
+        std::vector<SourceStage> _sources;
+        std::vector<SinkStage> _sinks;
+        std::thread _computeThread;
+
+        std::atomic<bool> _running; // the capture and compute threads run while this is set
+        std::atomic<bool> _delivering; // the delivery threads run while this is set
+        bool _sourceFrameMissing = false; // set on the compute thread when a source had no frame for the current call to the map
+        std::atomic<size_t> _framesCaptured;
+        std::atomic<size_t> _framesComputed;
+        std::atomic<size_t> _framesDelivered;
+        std::atomic<size_t> _sourceFramesDropped;
+        std::atomic<size_t> _sinkFramesDropped;
+
+        std::mutex _errorMutex;
+        std::exception_ptr _error;
+    };
+} // namespace model
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace model
+{
+    template <typename ElementType>
+    CompiledMapPipeline<ElementType>::CompiledMapPipeline(IRCompiledMap& map, const CompiledMapPipelineOptions& options) :
+        _map(map),
+        _options(options),
+        _running(false),
+        _delivering(false),
+        _framesCaptured(0),
+        _framesComputed(0),
+        _framesDelivered(0),
+        _sourceFramesDropped(0),
+        _sinkFramesDropped(0)
+    {
+        if (_options.queueDepth == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The pipeline queue depth must be at least 1");
+        }
+
+        auto& registry = _map.GetCallbackRegistry<ElementType>();
+        auto elementType = Port::GetPortType<ElementType>();
+
+        std::set<int> sourceIndices;
+        for (auto node : _map.GetSourceNodes())
+        {
+            auto name = node->GetCallbackName();
+            if (node->GetOutputType() != elementType || !registry.HasSourceCallback(name))
+            {
+                continue;
+            }
+
+            auto index = registry.GetSourceCallbackIndex(name);
+            if (sourceIndices.insert(index).second)
+            {
+                _sources.push_back({ index, node->Size(), registry.GetSourceCallback(index), std::make_unique<FrameChannel>(_options.queueDepth), {} });
+            }
+        }
+
+        std::set<int> sinkIndices;
+        for (auto node : _map.GetSinkNodes())
+        {
+            auto sinkNode = dynamic_cast<const SinkNodeBase*>(node);
+            if (sinkNode == nullptr || !registry.HasSinkCallback(sinkNode->GetCallbackName()))
+            {
+                continue;
+            }
+
+            auto index = registry.GetSinkCallbackIndex(sinkNode->GetCallbackName());
+            if (sinkIndices.insert(index).second)
+            {
+                _sinks.push_back({ index, registry.GetSinkCallback(index), std::make_unique<FrameChannel>(_options.queueDepth), {}, {} });
+            }
+        }
+
+        if (_sources.empty() && _sinks.empty())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The map has no source or sink callbacks of the pipeline's element type");
+        }
+    }
+
+    template <typename ElementType>
+    CompiledMapPipeline<ElementType>::~CompiledMapPipeline()
+    {
+        try
+        {
+            Stop();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    template <typename ElementType>
+    void CompiledMapPipeline<ElementType>::Start(ComputeFunction compute)
+    {
+        if (_running || _computeThread.joinable())
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "The pipeline is already running");
+        }
+
+        _error = nullptr;
+        auto& registry = _map.GetCallbackRegistry<ElementType>();
+        for (auto& stage : _sources)
+        {
+            registry.SetSourceCallback(stage.callbackIndex, [this, &stage](Frame& data) { return ReceiveFrame(stage, data); });
+        }
+        for (auto& stage : _sinks)
+        {
+            registry.SetSinkCallback(stage.callbackIndex, [this, &stage](const Frame& data) { SendFrame(stage, data); });
+        }
+
+        // Start the stages back to front, so that each one has a consumer when it starts producing frames
+        _running = true;
+        _delivering = true;
+        for (auto& stage : _sinks)
+        {
+            stage.thread = std::thread([this, &stage]() { DeliverFrames(stage); });
+        }
+        _computeThread = std::thread([this, compute]() { ComputeFrames(compute); });
+        for (auto& stage : _sources)
+        {
+            stage.thread = std::thread([this, &stage]() { CaptureFrames(stage); });
+        }
+    }
+
+    template <typename ElementType>
+    void CompiledMapPipeline<ElementType>::Stop()
+    {
+        _running = false;
+        NotifyAll();
+        for (auto& stage : _sources)
+        {
+            if (stage.thread.joinable())
+            {
+                stage.thread.join();
+            }
+        }
+        if (_computeThread.joinable())
+        {
+            _computeThread.join();
+        }
+
+        // Let the delivery threads drain their queues
+        _delivering = false;
+        NotifyAll();
+        for (auto& stage : _sinks)
+        {
+            if (stage.thread.joinable())
+            {
+                stage.thread.join();
+            }
+        }
+
+        auto& registry = _map.GetCallbackRegistry<ElementType>();
+        for (auto& stage : _sources)
+        {
+            registry.SetSourceCallback(stage.callbackIndex, stage.callback);
+        }
+        for (auto& stage : _sinks)
+        {
+            registry.SetSinkCallback(stage.callbackIndex, stage.callback);
+        }
+
+        std::exception_ptr error;
+        std::swap(error, _error);
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    template <typename ElementType>
+    CompiledMapPipelineStatistics CompiledMapPipeline<ElementType>::GetStatistics() const
+    {
+        CompiledMapPipelineStatistics result;
+        result.framesCaptured = _framesCaptured;
+        result.framesComputed = _framesComputed;
+        result.framesDelivered = _framesDelivered;
+        result.sourceFramesDropped = _sourceFramesDropped;
+        result.sinkFramesDropped = _sinkFramesDropped;
+        for (const auto& stage : _sources)
+        {
+            result.sourceQueueDepth += stage.channel->queue.Size();
+        }
+        for (const auto& stage : _sinks)
+        {
+            result.sinkQueueDepth += stage.channel->queue.Size();
+        }
+        return result;
+    }
+
+    template <typename ElementType>
+    void CompiledMapPipeline<ElementType>::CaptureFrames(SourceStage& stage)
+    {
+        try
+        {
+            Frame frame;
+            while (_running)
+            {
+                frame.resize(stage.frameSize);
+                if (!stage.callback(frame))
+                {
+                    // No new sample is available yet, so try again after a while, or as soon as the pipeline stops
+                    std::unique_lock<std::mutex> lock(stage.channel->mutex);
+                    ++stage.channel->waiters;
+                    stage.channel->changed.wait_for(lock, _options.sourcePollInterval, [this]() { return !_running; });
+                    --stage.channel->waiters;
+                    continue;
+                }
+
+                ++_framesCaptured;
+                PushFrame(*stage.channel, frame, _sourceFramesDropped);
+            }
+        }
+        catch (...)
+        {
+            SetError(std::current_exception());
+        }
+    }
+
+    template <typename ElementType>
+    void CompiledMapPipeline<ElementType>::ComputeFrames(const ComputeFunction& compute)
+    {
+        try
+        {
+            while (_running)
+            {
+                _sourceFrameMissing = false;
+                compute(_map);
+                ++_framesComputed;
+            }
+        }
+        catch (...)
+        {
+            SetError(std::current_exception());
+        }
+    }
+
+    template <typename ElementType>
+    void CompiledMapPipeline<ElementType>::DeliverFrames(SinkStage& stage)
+    {
+        try
+        {
+            // Once the compute thread has finished, this drains the frames left in the queue and stops
+            Frame frame;
+            while (PopFrame(*stage.channel, frame, _delivering))
+            {
+                stage.callback(frame);
+                ++_framesDelivered;
+            }
+        }
+        catch (...)
+        {
+            SetError(std::current_exception());
+        }
+    }
+
+    template <typename ElementType>
+    bool CompiledMapPipeline<ElementType>::ReceiveFrame(SourceStage& stage, Frame& data)
+    {
+        // Called by the compiled map on the compute thread. The frame is swapped into `data`, and the buffer `data` held goes back to the capture thread.
+        if (!PopFrame(*stage.channel, data, _running))
+        {
+            // The pipeline is stopping, so the map computes on the previous input, and its result mustn't be delivered
+            _sourceFrameMissing = true;
+            return false;
+        }
+        return true;
+    }
+
+    template <typename ElementType>
+    void CompiledMapPipeline<ElementType>::SendFrame(SinkStage& stage, const Frame& data)
+    {
+        // Called by the compiled map on the compute thread
+        if (_sourceFrameMissing)
+        {
+            return;
+        }
+
+        stage.frame.assign(data.begin(), data.end());
+        PushFrame(*stage.channel, stage.frame, _sinkFramesDropped);
+    }
+
+    template <typename ElementType>
+    void CompiledMapPipeline<ElementType>::PushFrame(FrameChannel& channel, Frame& frame, std::atomic<size_t>& framesDropped)
+    {
+        // The frame is swapped into the queue, and `frame` gets back a buffer the consumer is done with
+        bool pushed = channel.queue.TryPush(frame);
+        if (!pushed && !_options.dropFramesWhenFull)
+        {
+            std::unique_lock<std::mutex> lock(channel.mutex);
+            ++channel.waiters;
+            channel.changed.wait(lock, [&]() {
+                pushed = channel.queue.TryPush(frame);
+                return pushed || !_running;
+            });
+            --channel.waiters;
+        }
+
+        if (pushed)
+        {
+            Notify(channel);
+        }
+        else
+        {
+            ++framesDropped;
+        }
+    }
+
+    template <typename ElementType>
+    bool CompiledMapPipeline<ElementType>::PopFrame(FrameChannel& channel, Frame& frame, const std::atomic<bool>& keepWaiting)
+    {
+        bool popped = channel.queue.TryPop(frame);
+        if (!popped)
+        {
+            std::unique_lock<std::mutex> lock(channel.mutex);
+            ++channel.waiters;
+            channel.changed.wait(lock, [&]() {
+                popped = channel.queue.TryPop(frame);
+                return popped || !keepWaiting;
+            });
+            --channel.waiters;
+        }
+
+        if (popped)
+        {
+            Notify(channel);
+        }
+        return popped;
+    }
+
+    template <typename ElementType>
+    void CompiledMapPipeline<ElementType>::Notify(FrameChannel& channel)
+    {
+        // A waiter registers itself before it checks the queue (or the running flags), and this checks for waiters
+        // after the change. So either the waiter sees the change and doesn't sleep, or this sees the waiter. In the
+        // common case, where nobody waits, a push or pop doesn't touch the mutex at all.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (channel.waiters == 0)
+        {
+            return;
+        }
+
+        // Taking the lock orders this with a waiter that has just found the queue empty or full, so the wakeup isn't lost
+        {
+            std::lock_guard<std::mutex> lock(channel.mutex);
+        }
+        channel.changed.notify_all();
+    }
+
+    template <typename ElementType>
+    void CompiledMapPipeline<ElementType>::NotifyAll()
+    {
+        for (auto& stage : _sources)
+        {
+            Notify(*stage.channel);
+        }
+        for (auto& stage : _sinks)
+        {
+            Notify(*stage.channel);
+        }
+    }
+
+    template <typename ElementType>
+    void CompiledMapPipeline<ElementType>::SetError(std::exception_ptr error)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_errorMutex);
+            if (!_error)
+            {
+                _error = error;
+            }
+        }
+        _running = false;
+        NotifyAll();
+    }
+} // namespace model
+} // namespace ell
+
+#pragma endregion implementation
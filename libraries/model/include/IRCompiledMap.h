@@ -18,6 +18,7 @@
 
 #include <emitters/include/IRExecutionEngine.h>
 #include <emitters/include/IRModuleEmitter.h>
+#include <emitters/include/IRObjectCache.h>
 #include <emitters/include/ModuleEmitter.h>
 
 #include <utilities/include/Boolean.h>
@@ -106,6 +107,19 @@ namespace model
         /// <returns> The jitter. </returns>
         emitters::IRExecutionEngine& GetJitter();
 
+        /// <summary> Gets the key the map's object code is stored under in the JIT cache. </summary>
+        ///
+        /// <returns> The key, or an empty string if the map was compiled without a JIT cache directory. </returns>
+        const std::string& GetJitCacheKey() const { return _jitCacheKey; }
+
+        /// <summary>
+        /// Indicates if the map's object code was found in the JIT cache when it was compiled, in which case the map
+        /// wasn't refined or emitted, and its module is empty.
+        /// </summary>
+        ///
+        /// <returns> `true` if the map was loaded from the JIT cache, else `false`. </returns>
+        bool IsLoadedFromJitCache() const { return _loadedFromJitCache; }
+
         //
         // Node profiling support
         //
@@ -200,9 +214,45 @@ namespace model
         /// <param name="outputs"> A vector containing all the output buffers. </param>
         void ComputeMultiple(const std::vector<void*>& inputs, const std::vector<void*>& outputs) override;
 
+        /// <summary> Compute the map on a sequence of inputs with a single call into the compiled `predict_loop` function.
+        /// If the map was compiled with a `batchSize` option, full batches of inputs are computed at once, with the
+        /// matrix-vector products of fully connected layers done as matrix-matrix products; otherwise `predict` is
+        /// called once per input. Only valid for maps with a single input and a single output. The buffers must point to `count` contiguous
+        /// input and output vectors of the right type (float*, double*, etc) and size. </summary>
+        ///
+        /// <param name="inputs"> A buffer containing `count` consecutive input vectors. </param>
+        /// <param name="outputs"> A buffer that receives `count` consecutive output vectors. </param>
+        /// <param name="count"> The number of inputs. </param>
+        void ComputeLoop(const void* inputs, void* outputs, int count);
+
         /// <summary> Reset any model state. </summary>
         void Reset() override;
 
+        //
+        // Reentrant state support (only available if the map was compiled with `MapCompilerOptions::reentrant` set)
+        //
+
+        /// <summary> Get the size in bytes of a buffer that can hold the model state. </summary>
+        int GetStateSize();
+
+        /// <summary> Fill a state buffer with the initial model state. </summary>
+        ///
+        /// <param name="state"> A buffer of at least `GetStateSize()` bytes. </param>
+        void InitState(void* state);
+
+        /// <summary> Make the given state buffer the model state for the calling thread. </summary>
+        ///
+        /// <param name="state"> A buffer previously filled by `InitState` or `SaveState`. </param>
+        void LoadState(const void* state);
+
+        /// <summary> Copy the model state of the calling thread into a state buffer. </summary>
+        ///
+        /// <param name="state"> A buffer of at least `GetStateSize()` bytes. </param>
+        void SaveState(void* state);
+
+        /// <summary> Get the size in bytes of the scratch memory shared by the intermediate port buffers (only available if the map was compiled with `MapCompilerOptions::planMemory` set). </summary>
+        int GetScratchSize();
+
     protected:
         void WriteCode(const std::string& filePath, emitters::ModuleOutputFormat format, emitters::MachineCodeOutputOptions options) const;
         void WriteCode(std::ostream& stream, emitters::ModuleOutputFormat format, emitters::MachineCodeOutputOptions options) const;
@@ -222,7 +272,7 @@ namespace model
     private:
         friend class IRMapCompiler;
 
-        IRCompiledMap(Map map, const std::string& functionName, const MapCompilerOptions& options, emitters::IRModuleEmitter& module, bool verifyJittedModule);
+        IRCompiledMap(Map map, const std::string& functionName, const MapCompilerOptions& options, emitters::IRModuleEmitter& module, bool verifyJittedModule, const std::string& jitCacheKey = "", bool loadedFromJitCache = false);
 
         void EnsureExecutionEngine();
         void SetComputeFunction();
@@ -235,6 +285,9 @@ namespace model
         emitters::IRModuleEmitter& _module;
         std::string _moduleName;
 
+        std::string _jitCacheKey;
+        bool _loadedFromJitCache = false;
+        std::unique_ptr<emitters::IRObjectCache> _objectCache; // must outlive _executionEngine
         std::unique_ptr<emitters::IRExecutionEngine> _executionEngine;
         bool _verifyJittedModule = true;
         void* _context = nullptr;
@@ -249,6 +302,7 @@ namespace model
         std::variant<ComputeFunction<bool>, ComputeFunction<int>, ComputeFunction<int64_t>, ComputeFunction<float>, ComputeFunction<double>> _computeInputFunction;
         std::variant<Vector<bool>, Vector<int>, Vector<int64_t>, Vector<float>, Vector<double>> _cachedOutput;
         std::function<void(void*, void* const*, void* const*)> _computeDispatchFunction;
+        std::function<void(void*, const void*, void*, int)> _computeLoopFunction;
         std::function<void()> _resetFunction;
     };
 } // namespace model
@@ -14,6 +14,8 @@
 #include "Node.h"
 #include "NodeMap.h"
 #include "OutputPort.h"
+#include "ScratchMemoryPlanner.h"
+#include "SubgraphScheduler.h"
 
 #include <emitters/include/IRModuleEmitter.h>
 #include <emitters/include/LLVMUtilities.h>
@@ -21,6 +23,8 @@
 #include <utilities/include/Logger.h>
 
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace ell
@@ -152,10 +156,13 @@ namespace model
         void OnEndCompileModel(const Model& model) override;
         void OnBeginCompileNode(const Node& node) override;
         void OnEndCompileNode(const Node& node) override;
+        void OnAllocatePortVariable(const OutputPortBase& port, emitters::Variable& var) override;
         void PushScope() override;
         void PopScope() override;
+        void CompileNodes(Model& model) override;
         emitters::ModuleEmitter* GetModuleEmitter() override { return &_moduleEmitter; }
         virtual std::string GetPredictFunctionName() const;
+        std::string GetBatchedPredictFunctionName() const;
         virtual void EmitModelAPIFunctions(const Map& map);
 
         emitters::IRModuleEmitter _moduleEmitter;
@@ -165,9 +172,15 @@ namespace model
         NodeMap<emitters::IRBlockRegion*>& GetCurrentNodeBlocks();
         const Node* GetUniqueParent(const Node& node);
         void RefineAndOptimize(Map& map);
+        bool HasRuntimeState(const std::vector<llvm::GlobalVariable*>& globalsBeforeCompile) const;
+        void CompileBatchedMap(const Map& map, int batchSize);
         bool TryMergeNodeIntoRegion(emitters::IRBlockRegion* pDestination, const Node& src);
 
         void EmitPredictDispatchFunction(const Map& map);
+        void EmitPredictLoopFunction(const Map& map);
+        void EmitStateFunctions(const std::vector<llvm::GlobalVariable*>& stateVariables);
+        emitters::LLVMValue EnsurePortVariableEmitted(emitters::Variable& variable);
+        std::vector<llvm::GlobalVariable*> GetMutableGlobals() const;
         void EmitGetInputSizeFunction(const Map& map);
         void EmitGetOutputSizeFunction(const Map& map);
         void EmitGetSinkOutputSizeFunction(const Map& map);
@@ -183,8 +196,32 @@ namespace model
         void EmitGetMetadataFunction(const Map& map);
         void EmitStringConditionals(emitters::IRFunctionEmitter& fn, std::vector<std::pair<std::string, std::string>> keyValuePairs);
 
+        void EmitParallelStage(const SubgraphStage& stage);
+
+        void PlanPortLifetimes(const Model& model);
+        void EmitScratchMemory();
+        void EmitGetScratchSizeFunction();
+
         // stack of node regions
         std::vector<NodeMap<emitters::IRBlockRegion*>> _nodeRegions;
+
+        // scratch memory planning state, used when planMemory is set
+        ScratchMemoryPlanner _scratchPlanner;
+        std::unordered_map<const Node*, size_t> _nodeSteps;
+        std::unordered_map<const OutputPortBase*, size_t> _portLastUses;
+        std::unordered_map<const emitters::Variable*, size_t> _scratchOffsets;
+        std::unordered_set<const Node*> _nodesWithScratch;
+        const Node* _currentNode = nullptr;
+        llvm::GlobalVariable* _scratchPlaceholder = nullptr;
+        size_t _scratchSize = 0;
+
+        // globals that hold port values, which reentrant maps keep per thread but don't treat as state
+        std::unordered_set<const llvm::GlobalVariable*> _portGlobals;
+
+        int _numSubgraphFunctions = 0;
+
+        // the number of inputs the batched predict function computes at once, or 1 if there isn't one
+        int _predictBatchSize = 1;
     };
 } // namespace model
 } // namespace ell
@@ -202,7 +239,7 @@ namespace model
 
         Log() << "EnsurePortEmitted called for port " << port.GetRuntimeTypeName() << EOL;
         auto pVar = GetOrAllocatePortVariable(port, initialValue);
-        return GetModule().EnsureEmitted(*pVar);
+        return EnsurePortVariableEmitted(*pVar);
     }
 } // namespace model
 } // namespace ell
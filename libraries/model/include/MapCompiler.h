@@ -135,15 +135,28 @@ namespace model
         virtual void OnEndCompileModel(const Model& /*model*/) {}
         virtual void OnBeginCompileNode(const Node& /*node*/) {}
         virtual void OnEndCompileNode(const Node& /*node*/) {}
+
+        // called for zero-initialized port variables allocated in the outermost scope, after the variable has a name
+        virtual void OnAllocatePortVariable(const OutputPortBase& /*port*/, emitters::Variable& /*var*/) {}
+        bool IsInOutermostScope() const { return _portToVarMaps.size() == 1; }
         virtual void PushScope();
         virtual void PopScope();
         virtual emitters::ModuleEmitter* GetModuleEmitter() = 0;
 
+        /// <summary> Compiles the nodes of a model into the current function, in the order they are visited. </summary>
+        ///
+        /// <param name="model"> The model to compile. </param>
+        virtual void CompileNodes(Model& model);
+
+        /// <summary> Compiles a single node into the current function. The nodes it reads from must already be compiled. </summary>
+        ///
+        /// <param name="node"> The node to compile. </param>
+        void CompileNode(const Node& node);
+
     private:
 
         friend class CompilableNode;
 
-        void CompileNodes(Model& model);
         emitters::Variable* AllocatePortFunctionArgument(emitters::ModuleEmitter& emitter, const OutputPortBase& port, emitters::ArgumentFlags argDirection, ell::utilities::UniqueNameList& uniqueNameScope);
         emitters::Variable* AllocatePortFunctionArgument(emitters::ModuleEmitter& emitter, const PortElementBase& element, emitters::ArgumentFlags argDirection, ell::utilities::UniqueNameList& uniqueNameScope);
 
@@ -181,6 +194,10 @@ namespace model
         }
 
         pModuleEmitter->AllocateVariable(*pVar);
+        if (initialValue == 0 && IsInOutermostScope())
+        {
+            OnAllocatePortVariable(port, *pVar);
+        }
         SetVariableForPort(port, pVar);
         return pVar;
     }
@@ -37,6 +37,24 @@ namespace model
         bool verifyJittedModule = true;
         bool profile = false;
 
+        /// <summary> Keep port buffers and recurrent node state per thread, so one compiled module can serve several threads. Only the recurrent state is saved and restored by the state functions. </summary>
+        bool reentrant = false;
+
+        /// <summary> Place intermediate port buffers that are never live at the same time in one shared scratch arena. </summary>
+        bool planMemory = false;
+
+        /// <summary> Run the independent subgraphs of the model (e.g., the branches of a multi-branch network) in parallel with each other. </summary>
+        bool parallelizeSubgraphs = false;
+
+        /// <summary> The number of inputs that `predict_loop` computes at once, by running a copy of the map that fuses the samples' matrix-vector products into matrix-matrix products. Only stateless maps with a single input and output are batched. </summary>
+        int batchSize = 1;
+
+        /// <summary> Directory of the persistent JIT cache, which keeps the object code of JIT-compiled maps between runs. Empty to turn the cache off. </summary>
+        std::string jitCacheDirectory;
+
+        /// <summary> The size, in bytes, that the JIT cache directory is trimmed to by evicting the least recently used entries. </summary>
+        size_t jitCacheMaxSize = 256 * 1024 * 1024;
+
         // per-node options
         bool inlineNodes = false;
 
@@ -24,7 +24,8 @@ namespace model
         diagonal,
         simple,
         winograd,
-        unrolled
+        unrolled,
+        autotune
     };
 
     // Interchange format:
@@ -129,6 +129,14 @@ namespace model
         /// <returns> If the node supports the output memory layout order, true, else false </returns>
         virtual bool TrySetOutputLayout(const utilities::DimensionOrder& order);
 
+        /// <summary> Attempts to add nodes to the transformer's model that compute this node for a whole batch of samples at once </summary>
+        ///
+        /// <param name="transformer"> The transformer to add the new nodes with. </param>
+        /// <param name="sampleInputs"> For each sample, the new ports that this node's input ports read from, in the order of `GetInputPorts()`. </param>
+        /// <param name="sampleOutputs"> [out] For each sample, the new ports that hold this node's outputs, in the order of `GetOutputPorts()`. </param>
+        /// <returns> If the node added a batched computation, true, else false (and the node gets copied once per sample) </returns>
+        virtual bool TryCopyBatched(ModelTransformer& transformer, const std::vector<std::vector<const OutputPortBase*>>& sampleInputs, std::vector<std::vector<const OutputPortBase*>>& sampleOutputs) const;
+
         /// <summary> Returns the named port </summary>
         ///
         /// <param name="portName"> The name of the port </param>
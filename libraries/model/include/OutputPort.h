@@ -159,6 +159,7 @@ namespace model
                              std::vector<float>,
                              std::vector<int64_t>,
                              std::vector<int32_t>,
+                             std::vector<int8_t>,
                              std::vector<bool>>
             _cachedOutput;
     };
@@ -13,6 +13,7 @@
 #include <utilities/include/IArchivable.h>
 #include <utilities/include/PropertyBag.h>
 
+#include <cstdint>
 #include <string>
 
 namespace ell
@@ -34,7 +35,8 @@ namespace model
             integer, // == int32
             bigInt, // == int64
             categorical,
-            boolean
+            boolean,
+            smallInt // == int8
         };
 
         Port() = default;
@@ -185,6 +187,12 @@ namespace model
     {
         typedef bool value_type;
     };
+
+    template <>
+    struct PortTypeToValueType<Port::PortType::smallInt>
+    {
+        typedef int8_t value_type;
+    };
 } // namespace model
 } // namespace ell
 
@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ScratchMemoryPlanner.h (model)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    /// <summary>
+    /// Assigns offsets in a single scratch arena to buffers with known lifetimes, so that buffers that are never
+    /// live at the same time share memory. Lifetimes are measured in steps (the position of a node in the order in
+    /// which the model is compiled). Buffers are placed as they are requested, in the smallest free gap that fits,
+    /// and their memory becomes reusable once the step at which they were last used has been released.
+    /// </summary>
+    class ScratchMemoryPlanner
+    {
+    public:
+        /// <summary> Constructs a planner. </summary>
+        ///
+        /// <param name="alignment"> The alignment, in bytes, of every buffer offset. </param>
+        explicit ScratchMemoryPlanner(size_t alignment = 1);
+
+        /// <summary> Places a buffer in the arena. </summary>
+        ///
+        /// <param name="size"> The size of the buffer in bytes. </param>
+        /// <param name="lastUse"> The last step at which the buffer is used. </param>
+        ///
+        /// <returns> The offset of the buffer. </returns>
+        size_t Allocate(size_t size, size_t lastUse);
+
+        /// <summary> Keeps the buffer at a given offset live until at least a given step. </summary>
+        ///
+        /// <param name="offset"> The offset of a live buffer. </param>
+        /// <param name="lastUse"> The new last step at which the buffer is used. </param>
+        void ExtendLifetime(size_t offset, size_t lastUse);
+
+        /// <summary> Frees the memory of the buffers whose last use is at or before a given step. </summary>
+        ///
+        /// <param name="step"> The step that has finished. </param>
+        void Release(size_t step);
+
+        /// <summary> Gets the size of the arena, which is the largest extent of the buffers that were live at the same time. </summary>
+        ///
+        /// <returns> The size of the arena in bytes. </returns>
+        size_t GetSize() const { return _size; }
+
+        /// <summary> Gets the total size of all the buffers ever allocated, which is what they would take without sharing. </summary>
+        ///
+        /// <returns> The total size in bytes. </returns>
+        size_t GetTotalAllocatedSize() const { return _totalAllocatedSize; }
+
+    private:
+        struct Buffer
+        {
+            size_t offset;
+            size_t size;
+            size_t lastUse;
+        };
+
+        size_t _alignment;
+        std::vector<Buffer> _liveBuffers; // sorted by offset
+        size_t _size = 0;
+        size_t _totalAllocatedSize = 0;
+    };
+} // namespace model
+} // namespace ell
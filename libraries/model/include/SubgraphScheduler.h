@@ -0,0 +1,39 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SubgraphScheduler.h (model)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    class Model;
+    class Node;
+
+    /// <summary> A chain of nodes that must run one after another, in order. </summary>
+    using Subgraph = std::vector<const Node*>;
+
+    /// <summary> A set of subgraphs that don't depend on each other, and so may run at the same time. </summary>
+    using SubgraphStage = std::vector<Subgraph>;
+
+    /// <summary>
+    /// Splits a model into stages of independent subgraphs, for running the subgraphs of each stage in parallel.
+    /// Each subgraph is a maximal chain of nodes where every node after the first reads only from the node before
+    /// it, which has no other readers. The first stage holds the nodes with no inputs (e.g., input and constant
+    /// nodes), in a single subgraph. Every other subgraph is placed in the stage after the last stage it reads from,
+    /// so running the stages in order, and waiting for each one to finish before starting the next, respects every
+    /// dependency in the model.
+    /// </summary>
+    ///
+    /// <param name="model"> The model to schedule. </param>
+    ///
+    /// <returns> The stages, in the order they must run. Each subgraph lists its nodes in the order they must run. </returns>
+    std::vector<SubgraphStage> ScheduleSubgraphs(const Model& model);
+} // namespace model
+} // namespace ell
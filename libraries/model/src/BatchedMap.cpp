@@ -0,0 +1,195 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BatchedMap.cpp (model)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BatchedMap.h"
+#include "InputNode.h"
+#include "InputNodeBase.h"
+#include "Model.h"
+#include "ModelTransformer.h"
+#include "OutputNodeBase.h"
+#include "SliceNode.h"
+#include "SpliceNode.h"
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ell
+{
+namespace model
+{
+    namespace
+    {
+        // Adds an input node for the whole batch, and slices each sample's input out of it
+        template <typename ValueType>
+        InputNodeBase* AddBatchedInputNode(ModelTransformer& transformer, const InputNodeBase& inputNode, int batchSize, std::vector<const OutputPortBase*>& sampleInputs)
+        {
+            const auto& layout = inputNode.GetOutputPort().GetMemoryLayout();
+            auto shape = layout.GetActiveSize();
+            const auto sampleRows = shape[0];
+            shape[0] *= batchSize;
+
+            auto batchedInputNode = transformer.AddNode<InputNode<ValueType>>(PortMemoryLayout(shape, layout.GetLogicalDimensionOrder()));
+            for (int sample = 0; sample < batchSize; ++sample)
+            {
+                auto sliceNode = transformer.AddNode<SliceNode<ValueType>>(batchedInputNode->output, sample * sampleRows, sampleRows);
+                sampleInputs.push_back(&sliceNode->output);
+            }
+            return batchedInputNode;
+        }
+
+        InputNodeBase* AddBatchedInputNode(ModelTransformer& transformer, const InputNodeBase& inputNode, int batchSize, std::vector<const OutputPortBase*>& sampleInputs)
+        {
+            switch (inputNode.GetOutputPort().GetType())
+            {
+            case Port::PortType::boolean:
+                return AddBatchedInputNode<bool>(transformer, inputNode, batchSize, sampleInputs);
+            case Port::PortType::integer:
+                return AddBatchedInputNode<int>(transformer, inputNode, batchSize, sampleInputs);
+            case Port::PortType::bigInt:
+                return AddBatchedInputNode<int64_t>(transformer, inputNode, batchSize, sampleInputs);
+            case Port::PortType::smallReal:
+                return AddBatchedInputNode<float>(transformer, inputNode, batchSize, sampleInputs);
+            case Port::PortType::real:
+                return AddBatchedInputNode<double>(transformer, inputNode, batchSize, sampleInputs);
+            default:
+                throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
+            }
+        }
+
+        // Concatenates the samples' outputs into the output of the whole batch
+        const OutputPortBase& AddBatchedOutput(Model& model, const std::vector<const OutputPortBase*>& sampleOutputs)
+        {
+            switch (sampleOutputs[0]->GetType())
+            {
+            case Port::PortType::boolean:
+                return model.AddNode<SpliceNode<bool>>(sampleOutputs)->output;
+            case Port::PortType::integer:
+                return model.AddNode<SpliceNode<int>>(sampleOutputs)->output;
+            case Port::PortType::bigInt:
+                return model.AddNode<SpliceNode<int64_t>>(sampleOutputs)->output;
+            case Port::PortType::smallReal:
+                return model.AddNode<SpliceNode<float>>(sampleOutputs)->output;
+            case Port::PortType::real:
+                return model.AddNode<SpliceNode<double>>(sampleOutputs)->output;
+            default:
+                throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
+            }
+        }
+    } // namespace
+
+    bool CanBatchMap(const Map& map)
+    {
+        if (map.NumInputs() != 1 || map.NumOutputs() != 1)
+        {
+            return false;
+        }
+
+        const auto& model = map.GetModel();
+        if (model.GetNodesByType<InputNodeBase>().size() != 1 || !model.GetNodesByType<SourceNodeBase>().empty() || !model.GetNodesByType<SinkNodeBase>().empty())
+        {
+            return false;
+        }
+
+        // The samples are sliced out of the batch's input, and spliced into the batch's output, along their largest dimension
+        return !map.GetInput(0)->GetOutputPort().GetMemoryLayout().HasPadding() && !map.GetOutput(0).GetMemoryLayout().HasPadding();
+    }
+
+    Map CreateBatchedMap(const Map& map, int batchSize)
+    {
+        if (batchSize < 1)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Batch size must be positive");
+        }
+
+        if (!CanBatchMap(map))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Only maps with a single unpadded input and output, and no source or sink nodes, can be batched");
+        }
+
+        const InputNodeBase* inputNode = map.GetInput(0);
+        InputNodeBase* batchedInputNode = nullptr;
+
+        // For each output port of the original model, the new ports holding its value for each sample
+        std::unordered_map<const OutputPortBase*, std::vector<const OutputPortBase*>> samplePorts;
+
+        // The output ports whose value is the same for every sample, because they only depend on constants
+        std::unordered_set<const OutputPortBase*> sharedPorts;
+
+        TransformContext context;
+        ModelTransformer transformer;
+        auto batchedModel = transformer.TransformModel(map.GetModel(), context, [&](const Node& node, ModelTransformer& transformer) {
+            if (&node == inputNode)
+            {
+                batchedInputNode = AddBatchedInputNode(transformer, *inputNode, batchSize, samplePorts[&inputNode->GetOutputPort()]);
+                return;
+            }
+
+            const auto& inputs = node.GetInputPorts();
+            const auto& outputs = node.GetOutputPorts();
+            auto isShared = std::all_of(inputs.begin(), inputs.end(), [&sharedPorts](const InputPortBase* input) {
+                return sharedPorts.find(&input->GetReferencedPort()) != sharedPorts.end();
+            });
+            if (isShared)
+            {
+                transformer.CopyNode(node);
+                for (auto output : outputs)
+                {
+                    sharedPorts.insert(output);
+                    samplePorts[output] = std::vector<const OutputPortBase*>(batchSize, &transformer.GetCorrespondingOutputs(*output));
+                }
+                return;
+            }
+
+            std::vector<std::vector<const OutputPortBase*>> sampleInputs(batchSize);
+            for (int sample = 0; sample < batchSize; ++sample)
+            {
+                for (auto input : inputs)
+                {
+                    sampleInputs[sample].push_back(samplePorts.at(&input->GetReferencedPort())[sample]);
+                }
+            }
+
+            std::vector<std::vector<const OutputPortBase*>> sampleOutputs;
+            if (!node.TryCopyBatched(transformer, sampleInputs, sampleOutputs))
+            {
+                // Point the node's inputs at each sample's ports in turn, and copy it
+                sampleOutputs.assign(batchSize, {});
+                for (int sample = 0; sample < batchSize; ++sample)
+                {
+                    for (size_t index = 0; index < inputs.size(); ++index)
+                    {
+                        transformer.MapNodeOutput(inputs[index]->GetReferencedPort(), *sampleInputs[sample][index]);
+                    }
+                    transformer.CopyNode(node);
+                    for (auto output : outputs)
+                    {
+                        sampleOutputs[sample].push_back(&transformer.GetCorrespondingOutputs(*output));
+                    }
+                }
+            }
+
+            for (size_t index = 0; index < outputs.size(); ++index)
+            {
+                auto& ports = samplePorts[outputs[index]];
+                for (int sample = 0; sample < batchSize; ++sample)
+                {
+                    ports.push_back(sampleOutputs[sample][index]);
+                }
+
+                // The transformer only needs each original output mapped to some port of the same size
+                transformer.MapNodeOutput(*outputs[index], *ports[0]);
+            }
+        });
+
+        const auto& batchedOutput = AddBatchedOutput(batchedModel, samplePorts.at(&map.GetOutput(0)));
+        return { std::move(batchedModel), { { map.GetInputName(0), batchedInputNode } }, { { map.GetOutputName(0), batchedOutput } } };
+    }
+} // namespace model
+} // namespace ell
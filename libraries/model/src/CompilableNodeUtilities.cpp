@@ -67,6 +67,8 @@ namespace model
             return emitters::VariableType::Float;
         case Port::PortType::real:
             return emitters::VariableType::Double;
+        case Port::PortType::smallInt:
+            return emitters::VariableType::Char8;
         default:
             throw emitters::EmitterException(emitters::EmitterError::notSupported, "Port type not supported");
         }
@@ -91,6 +93,8 @@ namespace model
             return Port::PortType::smallReal;
         case emitters::VariableType::Double:
             return Port::PortType::real;
+        case emitters::VariableType::Char8:
+            return Port::PortType::smallInt;
         default:
             throw emitters::EmitterException(emitters::EmitterError::notSupported, "Variable type not supported");
         }
@@ -45,6 +45,9 @@ namespace model
         CompiledMap(std::move(other)),
         _module(other._module),
         _moduleName(std::move(other._moduleName)),
+        _jitCacheKey(std::move(other._jitCacheKey)),
+        _loadedFromJitCache(other._loadedFromJitCache),
+        _objectCache(std::move(other._objectCache)),
         _executionEngine(std::move(other._executionEngine)),
         _verifyJittedModule(other._verifyJittedModule),
         _context(other._context),
@@ -53,10 +56,12 @@ namespace model
     }
 
     // private constructor:
-    IRCompiledMap::IRCompiledMap(Map map, const std::string& functionName, const MapCompilerOptions& options, emitters::IRModuleEmitter& module, bool verifyJittedModule) :
+    IRCompiledMap::IRCompiledMap(Map map, const std::string& functionName, const MapCompilerOptions& options, emitters::IRModuleEmitter& module, bool verifyJittedModule, const std::string& jitCacheKey, bool loadedFromJitCache) :
         CompiledMap(std::move(map), functionName, options),
         _module(module),
         _moduleName(_module.GetModuleName()),
+        _jitCacheKey(jitCacheKey),
+        _loadedFromJitCache(loadedFromJitCache),
         _verifyJittedModule(verifyJittedModule),
         _computeFunctionDefined(false)
     {
@@ -73,7 +78,7 @@ namespace model
         EnsureExecutionEngine();
 
         Map newMap(*this);
-        IRCompiledMap result(std::move(newMap), GetFunctionName(), GetMapCompilerOptions(), _module, _verifyJittedModule);
+        IRCompiledMap result(std::move(newMap), GetFunctionName(), GetMapCompilerOptions(), _module, _verifyJittedModule, _jitCacheKey, _loadedFromJitCache);
         result.SetContext(GetContext());
         result.FinishJitting();
         return result;
@@ -94,8 +99,31 @@ namespace model
     {
         if (!_executionEngine)
         {
+            const auto& options = GetMapCompilerOptions();
+            if (_loadedFromJitCache)
+            {
+                // Nothing was emitted, so the engine gets an empty module and the cached object code
+                emitters::IRObjectCache objectCache(options.jitCacheDirectory, options.jitCacheMaxSize);
+                auto objects = objectCache.GetObjects(_jitCacheKey);
+                if (objects.empty())
+                {
+                    throw emitters::EmitterException(emitters::EmitterError::unexpected, "The object code for the map was evicted from the JIT cache");
+                }
+                _executionEngine = std::make_unique<emitters::IRExecutionEngine>(std::make_unique<llvm::Module>(_moduleName, _module.GetLLVMContext()), _verifyJittedModule);
+                for (auto& object : objects)
+                {
+                    _executionEngine->AddObject(std::move(object));
+                }
+                return;
+            }
+
             auto moduleClone = std::unique_ptr<llvm::Module>(llvm::CloneModule(*_module.GetLLVMModule()));
-            _executionEngine = std::make_unique<emitters::IRExecutionEngine>(std::move(moduleClone), _verifyJittedModule);
+            if (!_jitCacheKey.empty() && !options.jitCacheDirectory.empty())
+            {
+                _objectCache = std::make_unique<emitters::IRObjectCache>(options.jitCacheDirectory, options.jitCacheMaxSize);
+                _objectCache->SetModuleKey(*moduleClone, _jitCacheKey);
+            }
+            _executionEngine = std::make_unique<emitters::IRExecutionEngine>(std::move(moduleClone), _verifyJittedModule, llvm::CodeGenOpt::Level::Default, _objectCache.get(), options.compilerSettings.compileThreads);
         }
     }
 
@@ -112,6 +140,21 @@ namespace model
         _computeDispatchFunction(InternalGetContext(), inputs.data(), outputs.data());
     }
 
+    void IRCompiledMap::ComputeLoop(const void* inputs, void* outputs, int count)
+    {
+        FinishJitting();
+        if (!_computeLoopFunction)
+        {
+            if (NumInputs() != 1 || NumOutputs() != 1)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "ComputeLoop requires a map with a single input and a single output");
+            }
+            auto functionPointer = _executionEngine->ResolveFunctionAddress(_functionName + "_loop");
+            _computeLoopFunction = reinterpret_cast<void (*)(void*, const void*, void*, int)>(functionPointer);
+        }
+        _computeLoopFunction(InternalGetContext(), inputs, outputs, count);
+    }
+
     void IRCompiledMap::Reset()
     {
         FinishJitting();
@@ -454,6 +497,49 @@ namespace model
         fn();
     }
 
+    //
+    // Reentrant state support
+    //
+
+    int IRCompiledMap::GetStateSize()
+    {
+        auto& jitter = GetJitter();
+        auto fn = reinterpret_cast<int (*)()>(jitter.ResolveFunctionAddress(_moduleName + "_GetStateSize"));
+        return fn();
+    }
+
+    void IRCompiledMap::InitState(void* state)
+    {
+        auto& jitter = GetJitter();
+        auto fn = reinterpret_cast<void (*)(char*)>(jitter.ResolveFunctionAddress(_moduleName + "_InitState"));
+        fn(static_cast<char*>(state));
+    }
+
+    void IRCompiledMap::LoadState(const void* state)
+    {
+        auto& jitter = GetJitter();
+        auto fn = reinterpret_cast<void (*)(char*)>(jitter.ResolveFunctionAddress(_moduleName + "_LoadState"));
+        fn(static_cast<char*>(const_cast<void*>(state)));
+    }
+
+    void IRCompiledMap::SaveState(void* state)
+    {
+        auto& jitter = GetJitter();
+        auto fn = reinterpret_cast<void (*)(char*)>(jitter.ResolveFunctionAddress(_moduleName + "_SaveState"));
+        fn(static_cast<char*>(state));
+    }
+
+    //
+    // Scratch memory support
+    //
+
+    int IRCompiledMap::GetScratchSize()
+    {
+        auto& jitter = GetJitter();
+        auto fn = reinterpret_cast<int (*)()>(jitter.ResolveFunctionAddress(_moduleName + "_GetScratchSize"));
+        return fn();
+    }
+
     void IRCompiledMap::ResolveCallbacks()
     {
         auto list = GetModule().GetCallbackFunctionNames();
@@ -505,10 +591,12 @@ namespace model
             IRCompiledMap* map = reinterpret_cast<IRCompiledMap*>(context);
             if (map)
             {
-                auto func = map->GetCallbackRegistry<ElementType>().GetSourceCallback(index);
+                const auto& func = map->GetCallbackRegistry<ElementType>().GetSourceCallback(index);
                 if (func)
                 {
-                    std::vector<ElementType> data(buffer, buffer + size);
+                    // Reuse the buffer from the previous call on this thread, rather than allocating one per frame
+                    thread_local std::vector<ElementType> data;
+                    data.assign(buffer, buffer + size);
                     result = func(data);
                     ::memcpy(buffer, data.data(), sizeof(ElementType) * size);
                 }
@@ -522,10 +610,11 @@ namespace model
             IRCompiledMap* map = reinterpret_cast<IRCompiledMap*>(context);
             if (map)
             {
-                auto func = map->GetCallbackRegistry<ElementType>().GetSinkCallback(index);
+                const auto& func = map->GetCallbackRegistry<ElementType>().GetSinkCallback(index);
                 if (func)
                 {
-                    std::vector<ElementType> data(buffer, buffer + size);
+                    thread_local std::vector<ElementType> data;
+                    data.assign(buffer, buffer + size);
                     func(data);
                 }
             }
@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "IRMapCompiler.h"
+#include "BatchedMap.h"
 #include "CompilableNode.h"
 #include "CompilableNodeUtilities.h"
 #include "IRModelProfiler.h"
@@ -14,22 +15,30 @@
 #include "OptimizeModelTransformation.h"
 #include "OutputNode.h"
 #include "RefineTransformation.h"
+#include "SubgraphScheduler.h"
 
 #include <emitters/include/EmitterException.h>
 #include <emitters/include/IRMetadata.h>
+#include <emitters/include/IRObjectCache.h>
 #include <emitters/include/LLVMUtilities.h>
 #include <emitters/include/Variable.h>
 
 #include <nodes/include/SinkNode.h>
 #include <nodes/include/SourceNode.h>
 
+#include <utilities/include/JsonArchiver.h>
 #include <utilities/include/Logger.h>
 #include <utilities/include/StringUtil.h>
 
 #include <value/include/LLVMContext.h>
 
+#include <llvm/Config/llvm-config.h>
+
+#include <algorithm>
 #include <memory>
+#include <sstream>
 #include <tuple>
+#include <unordered_set>
 #include <vector>
 
 namespace ell
@@ -39,14 +48,59 @@ namespace model
     using namespace logging;
     using namespace value;
 
+    namespace
+    {
+        MapCompilerOptions GetEffectiveOptions(MapCompilerOptions settings)
+        {
+            // The thread pool's task queue is shared by every caller of the module, so reentrant
+            // maps spawn and join their own threads for each parallel loop instead.
+            if (settings.reentrant)
+            {
+                settings.compilerSettings.useThreadPool = false;
+            }
+            return settings;
+        }
+
+        // Bump this when a change to the compiler makes previously cached object code stale
+        constexpr int jitCacheVersion = 1;
+
+        // Everything that determines the object code of a compiled map: the serialized map (including per-node
+        // compile options in the metadata), the compiler options, and the target. The number of compile threads
+        // is left out, since splitting the module into partitions doesn't change what the code computes.
+        std::string GetJitCacheKey(const Map& map, const MapCompilerOptions& settings, const ModelOptimizerOptions& optimizerOptions)
+        {
+            const auto& compilerSettings = settings.compilerSettings;
+            const auto& targetDevice = compilerSettings.targetDevice;
+
+            std::ostringstream content;
+            content << "version:" << jitCacheVersion << ";llvm:" << LLVM_VERSION_STRING << "\n";
+            content << "target:" << targetDevice.deviceName << ";" << targetDevice.triple << ";" << targetDevice.dataLayout << ";" << targetDevice.cpu << ";" << targetDevice.features << ";"
+                    << targetDevice.l1CacheSize << ";" << targetDevice.l2CacheSize << ";" << targetDevice.l3CacheSize << "\n";
+            content << "map:" << settings.moduleName << ";" << settings.mapFunctionName << ";" << settings.sourceFunctionName << ";" << settings.sinkFunctionName << ";"
+                    << settings.profile << ";" << settings.reentrant << ";" << settings.planMemory << ";" << settings.parallelizeSubgraphs << ";" << settings.inlineNodes << ";" << settings.batchSize << "\n";
+            content << "compiler:" << compilerSettings.optimize << ";" << ToString(compilerSettings.blasType) << ";"
+                    << compilerSettings.positionIndependentCode.HasValue() << compilerSettings.positionIndependentCode.GetValue(false) << ";" << compilerSettings.profile << ";"
+                    << compilerSettings.parallelize << ";" << compilerSettings.useThreadPool << ";" << compilerSettings.maxThreads << ";" << compilerSettings.useWorkStealing << ";"
+                    << compilerSettings.tasksPerThread << ";" << compilerSettings.useFastMath << ";" << compilerSettings.includeDiagnosticInfo << ";"
+                    << compilerSettings.useBlas << ";" << compilerSettings.unrollLoops << ";" << compilerSettings.inlineOperators << ";"
+                    << compilerSettings.allowVectorInstructions << ";" << compilerSettings.vectorWidth << ";" << compilerSettings.debug << ";"
+                    << compilerSettings.globalValueAlignment << ";" << compilerSettings.skip_ellcode << "\n";
+
+            utilities::JsonArchiver archiver(content);
+            archiver.Archive(optimizerOptions.AsPropertyBag());
+            archiver.Archive(map);
+            return emitters::IRObjectCache::GetKey(content.str());
+        }
+    } // namespace
+
     IRMapCompiler::IRMapCompiler() :
         IRMapCompiler(MapCompilerOptions{}, ModelOptimizerOptions{})
     {
     }
 
     IRMapCompiler::IRMapCompiler(const MapCompilerOptions& settings, const ModelOptimizerOptions& optimizerOptions) :
-        MapCompiler(settings, optimizerOptions),
-        _moduleEmitter(settings.moduleName, settings.compilerSettings),
+        MapCompiler(GetEffectiveOptions(settings), optimizerOptions),
+        _moduleEmitter(settings.moduleName, GetEffectiveOptions(settings).compilerSettings),
         _profiler()
     {
         Log() << "Initializing IR map compiler" << EOL;
@@ -69,10 +123,31 @@ namespace model
         return GetMapCompilerOptions().mapFunctionName;
     }
 
+    std::string IRMapCompiler::GetBatchedPredictFunctionName() const
+    {
+        return GetPredictFunctionName() + "_batched";
+    }
+
     IRCompiledMap IRMapCompiler::Compile(Map map)
     {
         Log() << "Compile called for map" << EOL;
 
+        std::string jitCacheKey;
+        const auto& options = GetMapCompilerOptions();
+        if (!options.jitCacheDirectory.empty())
+        {
+            jitCacheKey = GetJitCacheKey(map, options, GetModelOptimizerOptions());
+            Log() << "JIT cache key for map: " << jitCacheKey << EOL;
+
+            // Source and sink nodes register their callbacks while they're compiled, so those maps are always compiled
+            emitters::IRObjectCache objectCache(options.jitCacheDirectory, options.jitCacheMaxSize);
+            if (map.GetSourceNodes().empty() && map.GetSinkNodes().empty() && objectCache.HasObject(jitCacheKey))
+            {
+                Log() << "Map found in the JIT cache, skipping refinement and compilation" << EOL;
+                return IRCompiledMap(std::move(map), options.mapFunctionName, options, _moduleEmitter, options.verifyJittedModule, jitCacheKey, true);
+            }
+        }
+
         RefineAndOptimize(map);
 
         // Renaming callbacks based on map compiler parameters
@@ -90,17 +165,60 @@ namespace model
         _profiler = { GetModule(), map.GetModel(), GetMapCompilerOptions().profile };
         _profiler.EmitInitialization();
 
+        auto globalsBeforeCompile = GetMutableGlobals();
         {
             ContextGuard<LLVMContext> guard(_moduleEmitter);
 
             // Now we have the refined map, compile it
             Log() << "Compiling map..." << EOL;
             CompileMap(map, GetPredictFunctionName());
+
+            const auto batchSize = GetMapCompilerOptions().batchSize;
+            if (batchSize > 1)
+            {
+                if (GetMapCompilerOptions().profile || !CanBatchMap(map) || HasRuntimeState(globalsBeforeCompile))
+                {
+                    Log() << "Not batching predict_loop, because the map is profiled, stateful, or doesn't have a single unpadded input and output" << EOL;
+                }
+                else
+                {
+                    CompileBatchedMap(map, batchSize);
+                }
+            }
         }
 
         // Emit runtime model APIs
         EmitModelAPIFunctions(map);
 
+        if (GetMapCompilerOptions().reentrant)
+        {
+            // Port buffers are rewritten on every call, so each thread just needs its own copy of them.
+            // The state of the model is whatever other mutable globals the nodes allocated while
+            // compiling (e.g., delay lines and recurrent hidden state), and only those get saved and restored.
+            std::unordered_set<llvm::GlobalVariable*> existingGlobals(globalsBeforeCompile.begin(), globalsBeforeCompile.end());
+            std::vector<llvm::GlobalVariable*> stateVariables;
+            int numScratchVariables = 0;
+            for (auto global : GetMutableGlobals())
+            {
+                if (existingGlobals.find(global) != existingGlobals.end())
+                {
+                    continue;
+                }
+
+                if (_portGlobals.find(global) != _portGlobals.end())
+                {
+                    global->setThreadLocal(true);
+                    ++numScratchVariables;
+                }
+                else
+                {
+                    stateVariables.push_back(global);
+                }
+            }
+            Log() << "Moving " << stateVariables.size() << " state variables and " << numScratchVariables << " port buffers to thread-local storage" << EOL;
+            EmitStateFunctions(stateVariables);
+        }
+
         if (GetMapCompilerOptions().compilerSettings.optimize)
         {
             // Save callback declarations in case they get optimized away
@@ -123,7 +241,44 @@ namespace model
                 _moduleEmitter.IncludeInCallbackInterface(functionName, std::get<2>(savedCallback)[0]);
             }
         }
-        return IRCompiledMap(std::move(map), GetMapCompilerOptions().mapFunctionName, GetMapCompilerOptions(), _moduleEmitter, GetMapCompilerOptions().verifyJittedModule);
+        return IRCompiledMap(std::move(map), GetMapCompilerOptions().mapFunctionName, GetMapCompilerOptions(), _moduleEmitter, GetMapCompilerOptions().verifyJittedModule, jitCacheKey);
+    }
+
+    bool IRMapCompiler::HasRuntimeState(const std::vector<llvm::GlobalVariable*>& globalsBeforeCompile) const
+    {
+        // Port buffers are rewritten on every call, the thread pool's globals belong to the pool, and the context
+        // pointer is only kept for callbacks. Any other mutable global the nodes allocated holds state across calls.
+        std::unordered_set<const llvm::GlobalVariable*> statelessGlobals(globalsBeforeCompile.begin(), globalsBeforeCompile.end());
+        statelessGlobals.insert(_portGlobals.begin(), _portGlobals.end());
+        for (auto global : GetModule().GetThreadPoolGlobalVariables())
+        {
+            statelessGlobals.insert(global);
+        }
+        statelessGlobals.insert(GetModule().GetLLVMModule()->getNamedGlobal(GetNamespacePrefix() + "_context"));
+
+        auto globals = GetMutableGlobals();
+        return std::any_of(globals.begin(), globals.end(), [&statelessGlobals](const llvm::GlobalVariable* global) {
+            return statelessGlobals.find(global) == statelessGlobals.end();
+        });
+    }
+
+    void IRMapCompiler::CompileBatchedMap(const Map& map, int batchSize)
+    {
+        // The map has already been refined, so the batched map is compiled as is, into a function with the
+        // same arguments as predict that computes `batchSize` consecutive inputs and outputs
+        Log() << "Compiling batched map for " << batchSize << " inputs at a time..." << EOL;
+        auto batchedMap = CreateBatchedMap(map, batchSize);
+        auto arguments = AllocateMapFunctionArguments(batchedMap, _moduleEmitter);
+        auto& function = _moduleEmitter.BeginFunction(GetBatchedPredictFunctionName(), emitters::VariableType::Void, arguments);
+        function.SetAttributeForArguments(emitters::IRFunctionEmitter::Attributes::NoAlias);
+        if (function.GetCurrentRegion() == nullptr)
+        {
+            function.AddRegion(function.GetCurrentBlock());
+        }
+
+        CompileNodes(batchedMap.GetModel());
+        _moduleEmitter.EndFunction();
+        _predictBatchSize = batchSize;
     }
 
     void IRMapCompiler::RefineAndOptimize(Map& map)
@@ -205,6 +360,178 @@ namespace model
         _moduleEmitter.EndFunction();
     }
 
+    void IRMapCompiler::EmitPredictLoopFunction(const Map& map)
+    {
+        // An entry point that runs predict over a contiguous sequence of inputs. When the map was compiled with
+        // a batch size, it runs the batched predict function on full batches of inputs, and predict on the rest.
+        // It assumes contiguous input and output buffers, so it's only available for the single-input, single-output case.
+        if (map.NumInputs() != 1 || map.NumOutputs() != 1)
+        {
+            return;
+        }
+
+        auto& emitter = _moduleEmitter.GetIREmitter();
+
+        // This is the type of code we are trying to generate for the predict loop function:
+        //
+        // void predict_loop(void* context, const float* inputs, float* outputs, int count)
+        // {
+        //     int batchEnd = count / batchSize * batchSize;
+        //     for (int i = 0; i < batchEnd; i += batchSize)
+        //     {
+        //         predict_batched(context, inputs + i * inputSize, outputs + i * outputSize);
+        //     }
+        //     for (int i = batchEnd; i < count; ++i)
+        //     {
+        //         predict(context, inputs + i * inputSize, outputs + i * outputSize);
+        //     }
+        // }
+        //
+        auto predictFunction = _moduleEmitter.GetFunction(GetPredictFunctionName());
+        emitters::NamedLLVMTypeList predictArgs;
+        for (auto arg = predictFunction->arg_begin(), end = predictFunction->arg_end(); arg != end; ++arg)
+        {
+            predictArgs.push_back({ arg->getName(), arg->getType() });
+        }
+
+        emitters::NamedLLVMTypeList args;
+        args.push_back(predictArgs[0]); // the context parameter
+        args.push_back({ "inputs", predictArgs[1].second });
+        args.push_back({ "outputs", predictArgs[2].second });
+        args.push_back({ "count", emitter.Type(emitters::VariableType::Int32) });
+
+        emitters::LLVMType returnType = emitter.Type(emitters::VariableType::Void);
+        auto function = _moduleEmitter.BeginFunction(GetPredictFunctionName() + "_loop", returnType, args);
+        function.IncludeInHeader();
+
+        // stops it from getting optimized away so it will always be in the JIT'd module.
+        function.GetFunction()->setLinkage(llvm::GlobalValue::LinkageTypes::ExternalLinkage);
+
+        auto context = function.GetFunctionArgument("context");
+        auto inputs = function.GetFunctionArgument("inputs");
+        auto outputs = function.GetFunctionArgument("outputs");
+        auto count = function.GetFunctionArgument("count");
+
+        const int inputSize = static_cast<int>(map.GetInputSize(0));
+        const int outputSize = static_cast<int>(map.GetOutputSize(0));
+        emitters::LLVMValue batchEnd = function.Literal(0);
+        if (_predictBatchSize > 1)
+        {
+            auto batchedPredictFunction = _moduleEmitter.GetFunction(GetBatchedPredictFunctionName());
+            batchEnd = function.LocalScalar(count) / _predictBatchSize * _predictBatchSize;
+            function.For(function.Literal(0), batchEnd, function.Literal(_predictBatchSize), [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar i) {
+                auto input = fn.PointerOffset(inputs, i * inputSize);
+                auto output = fn.PointerOffset(outputs, i * outputSize);
+                fn.Call(batchedPredictFunction, { context, input, output });
+            });
+        }
+
+        function.For(batchEnd, count, [=](emitters::IRFunctionEmitter& fn, emitters::IRLocalScalar i) {
+            auto input = fn.PointerOffset(inputs, i * inputSize);
+            auto output = fn.PointerOffset(outputs, i * outputSize);
+            fn.Call(predictFunction, { context, input, output });
+        });
+        function.Return();
+        _moduleEmitter.EndFunction();
+    }
+
+    std::vector<llvm::GlobalVariable*> IRMapCompiler::GetMutableGlobals() const
+    {
+        std::vector<llvm::GlobalVariable*> result;
+        for (auto& global : GetModule().GetLLVMModule()->globals())
+        {
+            if (!global.isConstant() && !global.isThreadLocal() && global.hasInitializer())
+            {
+                result.push_back(&global);
+            }
+        }
+        return result;
+    }
+
+    void IRMapCompiler::EmitStateFunctions(const std::vector<llvm::GlobalVariable*>& stateVariables)
+    {
+        // This is the type of code we are trying to generate for the state functions:
+        //
+        // thread_local float model_DelayNode_1234[10];
+        // thread_local int model_BufferNode_5678[40];
+        //
+        // int model_GetStateSize() { return 192; }
+        // void model_InitState(char* state) { memcpy(state + 0, <initial values of DelayNode_1234>, 40); ... }
+        // void model_LoadState(char* state) { memcpy(model_DelayNode_1234, state + 0, 40); ... }
+        // void model_SaveState(char* state) { memcpy(state + 0, model_DelayNode_1234, 40); ... }
+        //
+        // Each thread calling predict sees its own copy of the state, and callers that keep several
+        // independent streams in flight can swap their own state buffers in and out around predict.
+        const auto& dataLayout = _moduleEmitter.GetTargetDataLayout();
+        const int alignment = std::max(GetMapCompilerOptions().compilerSettings.globalValueAlignment, 1);
+
+        struct StateEntry
+        {
+            llvm::GlobalVariable* variable;
+            llvm::GlobalVariable* initialValue;
+            int offset;
+            int size;
+        };
+        std::vector<StateEntry> entries;
+        int stateSize = 0;
+        for (auto variable : stateVariables)
+        {
+            variable->setThreadLocal(true);
+            auto type = variable->getValueType();
+            auto size = static_cast<int>(dataLayout.getTypeAllocSize(type));
+            auto initialValue = new llvm::GlobalVariable(*_moduleEmitter.GetLLVMModule(), type, true, llvm::GlobalValue::LinkageTypes::InternalLinkage, variable->getInitializer(), variable->getName() + "_initialState");
+            entries.push_back({ variable, initialValue, stateSize, size });
+            stateSize += ((size + alignment - 1) / alignment) * alignment;
+        }
+
+        {
+            auto function = _moduleEmitter.BeginFunction(GetNamespacePrefix() + "_GetStateSize", emitters::VariableType::Int32);
+            function.IncludeInHeader();
+            function.GetFunction()->setLinkage(llvm::GlobalValue::LinkageTypes::ExternalLinkage);
+            function.Return(function.Literal(stateSize));
+            _moduleEmitter.EndFunction();
+        }
+
+        enum class CopyDirection
+        {
+            initialToState,
+            stateToVariable,
+            variableToState
+        };
+
+        auto emitCopyFunction = [&](const std::string& name, CopyDirection direction) {
+            const emitters::NamedVariableTypeList parameters = { { "state", emitters::VariableType::Char8Pointer } };
+            auto function = _moduleEmitter.BeginFunction(GetNamespacePrefix() + name, emitters::VariableType::Void, parameters);
+            function.IncludeInHeader();
+            function.GetFunction()->setLinkage(llvm::GlobalValue::LinkageTypes::ExternalLinkage);
+
+            auto state = function.GetFunctionArgument("state");
+            for (const auto& entry : entries)
+            {
+                auto statePtr = function.PointerOffset(state, entry.offset);
+                auto size = function.Literal(entry.size);
+                switch (direction)
+                {
+                case CopyDirection::initialToState:
+                    function.GetEmitter().MemoryCopy(entry.initialValue, statePtr, size);
+                    break;
+                case CopyDirection::stateToVariable:
+                    function.GetEmitter().MemoryCopy(statePtr, entry.variable, size);
+                    break;
+                case CopyDirection::variableToState:
+                    function.GetEmitter().MemoryCopy(entry.variable, statePtr, size);
+                    break;
+                }
+            }
+            function.Return();
+            _moduleEmitter.EndFunction();
+        };
+
+        emitCopyFunction("_InitState", CopyDirection::initialToState);
+        emitCopyFunction("_LoadState", CopyDirection::stateToVariable);
+        emitCopyFunction("_SaveState", CopyDirection::variableToState);
+    }
+
     void IRMapCompiler::EmitModelAPIFunctions(const Map& map)
     {
         EmitGetInputSizeFunction(map);
@@ -217,6 +544,11 @@ namespace model
         EmitGetSinkOutputShapeFunction(map);
         EmitGetMetadataFunction(map);
         EmitPredictDispatchFunction(map);
+        EmitPredictLoopFunction(map);
+        if (GetMapCompilerOptions().planMemory)
+        {
+            EmitGetScratchSizeFunction();
+        }
 
         // Finish any profiling stuff we need to do and emit functions
         _profiler.EmitModelProfilerFunctions();
@@ -645,13 +977,23 @@ namespace model
             throw emitters::EmitterException(emitters::EmitterError::unexpected,
                                              utilities::FormatString("Error: missing port variable for '%s' port on node %s(%s)", port.GetName().c_str(), node->GetRuntimeTypeName().c_str(), node->GetId().ToString().c_str()));
         }
-        return GetModule().EnsureEmitted(*pVar);
+        return EnsurePortVariableEmitted(*pVar);
     }
 
     emitters::LLVMValue IRMapCompiler::EnsurePortEmitted(const OutputPortBase& port)
     {
         auto pVar = GetOrAllocatePortVariable(port);
-        return GetModule().EnsureEmitted(*pVar);
+        return EnsurePortVariableEmitted(*pVar);
+    }
+
+    emitters::LLVMValue IRMapCompiler::EnsurePortVariableEmitted(emitters::Variable& variable)
+    {
+        auto value = GetModule().EnsureEmitted(variable);
+        if (auto global = llvm::dyn_cast<llvm::GlobalVariable>(value->stripPointerCasts()))
+        {
+            _portGlobals.insert(global);
+        }
+        return value;
     }
 
     void IRMapCompiler::OnBeginCompileModel(const Model& model)
@@ -667,6 +1009,11 @@ namespace model
         currentFunction.IncludeInHeader();
         currentFunction.IncludeInPredictInterface();
 
+        if (GetMapCompilerOptions().planMemory)
+        {
+            PlanPortLifetimes(model);
+        }
+
         _profiler.StartModel(currentFunction);
     }
 
@@ -674,6 +1021,264 @@ namespace model
     {
         auto& currentFunction = GetModule().GetCurrentFunction();
         _profiler.EndModel(currentFunction);
+
+        if (GetMapCompilerOptions().planMemory)
+        {
+            EmitScratchMemory();
+        }
+    }
+
+    void IRMapCompiler::CompileNodes(Model& model)
+    {
+        const auto& options = GetMapCompilerOptions();
+        if (!options.parallelizeSubgraphs)
+        {
+            MapCompiler::CompileNodes(model);
+            return;
+        }
+
+        // Scratch memory is planned for nodes running one at a time, the profiler's counters aren't atomic,
+        // and reentrant maps don't use the thread pool
+        if (options.planMemory || options.profile || options.reentrant)
+        {
+            Log() << "Not parallelizing subgraphs, because planMemory, profile or reentrant is set" << EOL;
+            MapCompiler::CompileNodes(model);
+            return;
+        }
+
+        for (const auto& stage : ScheduleSubgraphs(model))
+        {
+            if (stage.size() > 1)
+            {
+                EmitParallelStage(stage);
+            }
+            else
+            {
+                for (const auto& subgraph : stage)
+                {
+                    for (auto node : subgraph)
+                    {
+                        CompileNode(*node);
+                    }
+                }
+            }
+        }
+    }
+
+    void IRMapCompiler::EmitParallelStage(const SubgraphStage& stage)
+    {
+        // Subgraphs that call back into user code stay on the calling thread, as the callbacks may not be thread-safe.
+        // Otherwise, the calling thread runs one of the subgraphs itself instead of just waiting for the others.
+        std::vector<const Subgraph*> taskSubgraphs;
+        std::vector<const Subgraph*> localSubgraphs;
+        for (const auto& subgraph : stage)
+        {
+            auto hasCallbacks = std::any_of(subgraph.begin(), subgraph.end(), [](const Node* node) {
+                return dynamic_cast<const SourceNodeBase*>(node) != nullptr || dynamic_cast<const SinkNodeBase*>(node) != nullptr;
+            });
+            (hasCallbacks ? localSubgraphs : taskSubgraphs).push_back(&subgraph);
+        }
+        if (localSubgraphs.empty())
+        {
+            localSubgraphs.push_back(taskSubgraphs.back());
+            taskSubgraphs.pop_back();
+        }
+
+        if (!taskSubgraphs.empty())
+        {
+            auto& module = GetModule();
+            auto predictArguments = module.GetFunctionDeclaration(module.GetCurrentFunction().GetFunctionName()).GetArguments();
+
+            // Each subgraph becomes a function that takes the same arguments as the predict function, and a dispatch
+            // function picks one of them by index, so that all of the subgraphs can be started as one array of tasks
+            std::vector<emitters::LLVMFunction> subgraphFunctions;
+            for (auto subgraph : taskSubgraphs)
+            {
+                auto& subgraphFunction = module.BeginFunction(GetNamespacePrefix() + "_subgraph_" + std::to_string(_numSubgraphFunctions++), emitters::VariableType::Void, predictArguments);
+                _nodeRegions.emplace_back();
+                for (auto node : *subgraph)
+                {
+                    CompileNode(*node);
+                }
+                _nodeRegions.pop_back();
+                subgraphFunctions.push_back(subgraphFunction.GetFunction());
+                module.EndFunction();
+            }
+
+            auto dispatchArguments = predictArguments;
+            dispatchArguments.insert(dispatchArguments.begin(), { "subgraphIndex", emitters::VariableType::Int32, emitters::ArgumentFlags::Input });
+            auto& dispatchFunction = module.BeginFunction(GetNamespacePrefix() + "_subgraphTask_" + std::to_string(_numSubgraphFunctions++), emitters::VariableType::Void, dispatchArguments);
+            {
+                auto subgraphIndex = dispatchFunction.GetFunctionArgument("subgraphIndex");
+                emitters::IRValueList arguments;
+                for (const auto& argument : predictArguments)
+                {
+                    arguments.push_back(dispatchFunction.GetFunctionArgument(argument.GetName()));
+                }
+                for (size_t index = 0; index < subgraphFunctions.size(); ++index)
+                {
+                    auto subgraphFunction = subgraphFunctions[index];
+                    dispatchFunction.If(emitters::TypedComparison::equals, subgraphIndex, dispatchFunction.Literal<int>(static_cast<int>(index)), [subgraphFunction, &arguments](emitters::IRFunctionEmitter& function) {
+                        function.Call(subgraphFunction, arguments);
+                    });
+                }
+            }
+            auto taskFunction = dispatchFunction.GetFunction();
+            module.EndFunction();
+
+            auto& function = module.GetCurrentFunction();
+            std::vector<std::vector<emitters::LLVMValue>> taskArguments;
+            for (size_t index = 0; index < subgraphFunctions.size(); ++index)
+            {
+                std::vector<emitters::LLVMValue> arguments{ function.Literal<int>(static_cast<int>(index)) };
+                for (const auto& argument : predictArguments)
+                {
+                    arguments.push_back(function.GetFunctionArgument(argument.GetName()));
+                }
+                taskArguments.push_back(arguments);
+            }
+            auto tasks = function.StartTasks(taskFunction, taskArguments);
+
+            // While the pool is busy with this stage, parallel loops in the local subgraphs run on this thread. The node
+            // regions emitted so far are forgotten, so the local nodes' code isn't merged into them, ahead of the tasks.
+            const auto& compilerSettings = function.GetCompilerOptions();
+            auto usesThreadPool = compilerSettings.parallelize && compilerSettings.useThreadPool && !compilerSettings.targetDevice.IsWindows();
+            emitters::LLVMValue runTasksInline = nullptr;
+            if (usesThreadPool)
+            {
+                runTasksInline = function.SetRunTasksInline(function.TrueBit());
+            }
+            GetCurrentNodeBlocks().Clear();
+            for (auto subgraph : localSubgraphs)
+            {
+                for (auto node : *subgraph)
+                {
+                    CompileNode(*node);
+                }
+            }
+            if (usesThreadPool)
+            {
+                function.SetRunTasksInline(runTasksInline);
+            }
+            tasks.WaitAll(function);
+            GetCurrentNodeBlocks().Clear();
+        }
+        else
+        {
+            for (auto subgraph : localSubgraphs)
+            {
+                for (auto node : *subgraph)
+                {
+                    CompileNode(*node);
+                }
+            }
+        }
+    }
+
+    void IRMapCompiler::PlanPortLifetimes(const Model& model)
+    {
+        // Steps follow the order in which CompileNodes visits the model. An output port is live from the
+        // step of the node that produces it until the step of the last node that reads it.
+        const int alignment = std::max(GetMapCompilerOptions().compilerSettings.globalValueAlignment, 1);
+        _scratchPlanner = ScratchMemoryPlanner(static_cast<size_t>(alignment));
+        _nodeSteps.clear();
+        _portLastUses.clear();
+        _scratchOffsets.clear();
+        _nodesWithScratch.clear();
+        _scratchPlaceholder = nullptr;
+        _scratchSize = 0;
+
+        size_t step = 0;
+        model.Visit([this, &step](const Node& node) {
+            _nodeSteps[&node] = step;
+            for (auto outputPort : node.GetOutputPorts())
+            {
+                _portLastUses[outputPort] = step;
+            }
+            for (auto inputPort : node.GetInputPorts())
+            {
+                auto& lastUse = _portLastUses[&inputPort->GetReferencedPort()];
+                lastUse = std::max(lastUse, step);
+            }
+            ++step;
+        });
+    }
+
+    void IRMapCompiler::OnAllocatePortVariable(const OutputPortBase& port, emitters::Variable& var)
+    {
+        if (!GetMapCompilerOptions().planMemory || _currentNode == nullptr)
+        {
+            return;
+        }
+
+        auto lastUse = _portLastUses.find(&port);
+        if (lastUse == _portLastUses.end())
+        {
+            return;
+        }
+
+        // Give the variable a constant address inside a placeholder global, which is replaced by the
+        // real arena once its size is known
+        auto& emitter = GetModule().GetIREmitter();
+        auto varType = PortTypeToVariableType(port.GetType());
+        auto size = port.Size() * emitter.SizeOf(varType);
+        auto offset = _scratchPlanner.Allocate(size, lastUse->second);
+
+        auto byteType = emitter.Type(emitters::VariableType::Byte);
+        if (_scratchPlaceholder == nullptr)
+        {
+            _scratchPlaceholder = new llvm::GlobalVariable(*GetModule().GetLLVMModule(), byteType, false, llvm::GlobalValue::LinkageTypes::ExternalLinkage, nullptr, GetNamespacePrefix() + "_scratchPlaceholder");
+        }
+        auto offsetValue = llvm::ConstantInt::get(llvm::Type::getInt64Ty(GetModule().GetLLVMContext()), offset);
+        auto bytePointer = llvm::ConstantExpr::getInBoundsGetElementPtr(byteType, _scratchPlaceholder, offsetValue);
+        auto pointer = llvm::ConstantExpr::getBitCast(bytePointer, emitter.Type(varType)->getPointerTo());
+        GetModule().SetEmittedVariable(var, pointer);
+        _scratchOffsets[&var] = offset;
+        _nodesWithScratch.insert(_currentNode);
+
+        // Nodes only write the active area of their outputs and expect the padding to stay zero, as it is in a
+        // freshly allocated global, so padded buffers are cleared before the node runs
+        if (port.GetMemoryLayout().HasPadding())
+        {
+            auto& currentFunction = GetModule().GetCurrentFunction();
+            auto pRegion = GetCurrentNodeBlocks().Get(*_currentNode);
+            auto& irBuilder = emitter.GetIRBuilder();
+            auto savedInsertPoint = irBuilder.saveIP();
+            if (pRegion != nullptr)
+            {
+                auto pStart = pRegion->Start();
+                irBuilder.SetInsertPoint(pStart, pStart->getFirstInsertionPt());
+            }
+            emitter.MemorySet(pointer, currentFunction.Literal<uint8_t>(0), currentFunction.Literal(static_cast<int>(size)));
+            irBuilder.restoreIP(savedInsertPoint);
+        }
+    }
+
+    void IRMapCompiler::EmitScratchMemory()
+    {
+        Log() << "Planned " << _scratchPlanner.GetSize() << " bytes of scratch memory for " << _scratchPlanner.GetTotalAllocatedSize() << " bytes of port buffers" << EOL;
+        _scratchSize = _scratchPlanner.GetSize();
+        if (_scratchPlaceholder == nullptr)
+        {
+            return;
+        }
+
+        // The arena holds no state between calls, so reentrant maps give each thread its own copy
+        // instead of making it part of the model state
+        auto arena = GetModule().GlobalArray(emitters::VariableType::Byte, GetNamespacePrefix() + "_scratch", std::max<size_t>(_scratchSize, 1), GetMapCompilerOptions().reentrant);
+        _portGlobals.insert(arena);
+        _scratchPlaceholder->replaceAllUsesWith(llvm::ConstantExpr::getBitCast(arena, _scratchPlaceholder->getType()));
+        _scratchPlaceholder->eraseFromParent();
+        _scratchPlaceholder = nullptr;
+    }
+
+    void IRMapCompiler::EmitGetScratchSizeFunction()
+    {
+        auto function = _moduleEmitter.BeginFunction(GetNamespacePrefix() + "_GetScratchSize", emitters::VariableType::Int32);
+        function.IncludeInHeader();
+        function.GetFunction()->setLinkage(llvm::GlobalValue::LinkageTypes::ExternalLinkage);
+        function.Return(function.Literal(static_cast<int>(_scratchSize)));
+        _moduleEmitter.EndFunction();
     }
 
     void IRMapCompiler::OnBeginCompileNode(const Node& node)
@@ -687,6 +1292,7 @@ namespace model
 
         _profiler.InitNode(currentFunction, node);
         _profiler.StartNode(currentFunction, node);
+        _currentNode = IsInOutermostScope() && _nodeSteps.find(&node) != _nodeSteps.end() ? &node : nullptr;
     }
 
     void IRMapCompiler::OnEndCompileNode(const Node& node)
@@ -704,6 +1310,23 @@ namespace model
             currentFunction.GetCurrentRegion()->SetEnd(pCurBlock);
         }
 
+        if (_currentNode == &node)
+        {
+            // An output that aliases a buffer (e.g., a no-op cast) keeps that buffer live for its own readers
+            auto step = _nodeSteps[&node];
+            for (auto outputPort : node.GetOutputPorts())
+            {
+                auto pVar = GetVariableForPort(*outputPort);
+                auto offset = _scratchOffsets.find(pVar);
+                if (offset != _scratchOffsets.end())
+                {
+                    _scratchPlanner.ExtendLifetime(offset->second, _portLastUses[outputPort]);
+                }
+            }
+            _scratchPlanner.Release(step);
+            _currentNode = nullptr;
+        }
+
         Log() << "Finished compiling node " << DiagnosticString(node) << EOL;
     }
 
@@ -836,6 +1459,13 @@ namespace model
             return false;
         }
 
+        if (_nodesWithScratch.find(&src) != _nodesWithScratch.end())
+        {
+            // Moving the code would run it before nodes whose scratch buffers it reuses
+            Log() << "Node " << DiagnosticString(src) << " writes to scratch memory, not merging" << EOL;
+            return false;
+        }
+
         Log() << "Setting end of current region to current block" << EOL;
         GetModule().GetCurrentRegion()->SetEnd(currentFunction.GetCurrentBlock());
         currentFunction.ConcatRegions(pDestRegion, pSrcRegion);
@@ -879,7 +1509,7 @@ namespace model
             throw emitters::EmitterException(emitters::EmitterError::indexOutOfRange);
         }
 
-        emitters::LLVMValue pVal = GetModule().EnsureEmitted(*pVar);
+        emitters::LLVMValue pVal = EnsurePortVariableEmitted(*pVar);
         auto valType = pVal->getType();
         bool needsDereference = valType->isPointerTy(); // TODO: Maybe this should be `isPtrOrPtrVectorTy()` or even `isPtrOrPtrVectorTy() || isArrayTy()`
         if (needsDereference)
@@ -33,6 +33,12 @@ namespace model
         sinkFunctionName = properties.GetOrParseEntry("sinkFunctionName", sinkFunctionName);
         verifyJittedModule = properties.GetOrParseEntry("verifyJittedModule", verifyJittedModule);
         profile = properties.GetOrParseEntry("profile", profile);
+        reentrant = properties.GetOrParseEntry("reentrant", reentrant);
+        planMemory = properties.GetOrParseEntry("planMemory", planMemory);
+        parallelizeSubgraphs = properties.GetOrParseEntry("parallelizeSubgraphs", parallelizeSubgraphs);
+        batchSize = properties.GetOrParseEntry("batchSize", batchSize);
+        jitCacheDirectory = properties.GetOrParseEntry("jitCacheDirectory", jitCacheDirectory);
+        jitCacheMaxSize = properties.GetOrParseEntry("jitCacheMaxSize", jitCacheMaxSize);
         inlineNodes = properties.GetOrParseEntry("inlineNodes", inlineNodes);
     }
 } // namespace model
@@ -30,6 +30,7 @@ namespace model
             ADD_TO_STRING_ENTRY(PreferredConvolutionMethod, simple);
             ADD_TO_STRING_ENTRY(PreferredConvolutionMethod, winograd);
             ADD_TO_STRING_ENTRY(PreferredConvolutionMethod, unrolled);
+            ADD_TO_STRING_ENTRY(PreferredConvolutionMethod, autotune);
         default:
             throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Unknown PreferredConvolutionMethod");
         };
@@ -83,6 +84,7 @@ namespace utilities
         ADD_FROM_STRING_ENTRY(model::PreferredConvolutionMethod, simple);
         ADD_FROM_STRING_ENTRY(model::PreferredConvolutionMethod, winograd);
         ADD_FROM_STRING_ENTRY(model::PreferredConvolutionMethod, unrolled);
+        ADD_FROM_STRING_ENTRY(model::PreferredConvolutionMethod, autotune);
 
         throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "Unknown PreferredConvolutionMethod");
     }
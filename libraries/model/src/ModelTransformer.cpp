@@ -537,6 +537,12 @@ namespace model
                 MapNodeOutput(*static_cast<const OutputPort<double>*>(outputPort), outputNode->output);
                 break;
             }
+            case PortType::smallInt:
+            {
+                auto outputNode = AddNode<NullNode<int8_t>>(outputPort->Size());
+                MapNodeOutput(*static_cast<const OutputPort<int8_t>*>(outputPort), outputNode->output);
+                break;
+            }
             default:
                 throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Unknown port type");
             }
@@ -133,6 +133,11 @@ namespace model
         return true;
     }
 
+    bool Node::TryCopyBatched(ModelTransformer& /*transformer*/, const std::vector<std::vector<const OutputPortBase*>>& /*sampleInputs*/, std::vector<std::vector<const OutputPortBase*>>& /*sampleOutputs*/) const
+    {
+        return false;
+    }
+
     Port* Node::GetPort(const std::string& portName)
     {
         auto inputPort = GetInputPort(portName);
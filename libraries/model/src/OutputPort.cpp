@@ -159,6 +159,9 @@ namespace model
         case PortType::smallReal:
             _cachedOutput = std::vector<float>{};
             break;
+        case PortType::smallInt:
+            _cachedOutput = std::vector<int8_t>{};
+            break;
         case PortType::categorical:
             [[fallthrough]];
         case PortType::none:
@@ -54,6 +54,12 @@ namespace model
         return Port::PortType::bigInt;
     }
 
+    template <>
+    Port::PortType Port::GetPortType<int8_t>()
+    {
+        return Port::PortType::smallInt;
+    }
+
     template <>
     Port::PortType Port::GetPortType<bool>()
     {
@@ -155,6 +161,8 @@ namespace model
             return "int";
         case ell::model::Port::PortType::boolean:
             return "bool"; // ???
+        case ell::model::Port::PortType::smallInt:
+            return "int8_t";
         default:
             return "Unknown";
         };
@@ -0,0 +1,71 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ScratchMemoryPlanner.cpp (model)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ScratchMemoryPlanner.h"
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace ell
+{
+namespace model
+{
+    ScratchMemoryPlanner::ScratchMemoryPlanner(size_t alignment) :
+        _alignment(std::max<size_t>(alignment, 1))
+    {
+    }
+
+    size_t ScratchMemoryPlanner::Allocate(size_t size, size_t lastUse)
+    {
+        auto alignedSize = ((std::max<size_t>(size, 1) + _alignment - 1) / _alignment) * _alignment;
+        _totalAllocatedSize += alignedSize;
+
+        // find the smallest gap between live buffers that fits, or else place the buffer after the last one
+        auto bestPosition = _liveBuffers.end();
+        size_t bestOffset = 0;
+        size_t bestGap = std::numeric_limits<size_t>::max();
+        size_t gapBegin = 0;
+        for (auto it = _liveBuffers.begin(); it != _liveBuffers.end(); ++it)
+        {
+            auto gap = it->offset - gapBegin;
+            if (gap >= alignedSize && gap < bestGap)
+            {
+                bestPosition = it;
+                bestOffset = gapBegin;
+                bestGap = gap;
+            }
+            gapBegin = it->offset + it->size;
+        }
+        if (bestGap == std::numeric_limits<size_t>::max())
+        {
+            bestPosition = _liveBuffers.end();
+            bestOffset = gapBegin;
+        }
+
+        _liveBuffers.insert(bestPosition, { bestOffset, alignedSize, lastUse });
+        _size = std::max(_size, bestOffset + alignedSize);
+        return bestOffset;
+    }
+
+    void ScratchMemoryPlanner::ExtendLifetime(size_t offset, size_t lastUse)
+    {
+        auto it = std::find_if(_liveBuffers.begin(), _liveBuffers.end(), [offset](const Buffer& buffer) { return buffer.offset == offset; });
+        if (it == _liveBuffers.end())
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "No live scratch buffer at the given offset");
+        }
+        it->lastUse = std::max(it->lastUse, lastUse);
+    }
+
+    void ScratchMemoryPlanner::Release(size_t step)
+    {
+        _liveBuffers.erase(std::remove_if(_liveBuffers.begin(), _liveBuffers.end(), [step](const Buffer& buffer) { return buffer.lastUse <= step; }), _liveBuffers.end());
+    }
+} // namespace model
+} // namespace ell
@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SubgraphScheduler.cpp (model)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SubgraphScheduler.h"
+#include "Model.h"
+#include "Node.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace ell
+{
+namespace model
+{
+    std::vector<SubgraphStage> ScheduleSubgraphs(const Model& model)
+    {
+        Subgraph freeNodes;
+        std::vector<Subgraph> chains;
+        std::vector<size_t> chainLevels;
+        std::unordered_map<const Node*, size_t> nodeChains;
+
+        model.Visit([&](const Node& node) {
+            if (node.NumInputPorts() == 0)
+            {
+                freeNodes.push_back(&node);
+                return;
+            }
+
+            // the nodes and chains this node reads from, not counting the nodes with no inputs, which all run first
+            std::vector<const Node*> parents;
+            std::vector<size_t> parentChains;
+            for (auto parent : node.GetParentNodes())
+            {
+                auto it = nodeChains.find(parent);
+                if (it == nodeChains.end())
+                {
+                    continue;
+                }
+                parents.push_back(parent);
+                if (std::find(parentChains.begin(), parentChains.end(), it->second) == parentChains.end())
+                {
+                    parentChains.push_back(it->second);
+                }
+            }
+
+            // extend the parent's chain if this node is the only thing reading from the end of it
+            if (parents.size() == 1)
+            {
+                auto chainIndex = parentChains[0];
+                auto tail = chains[chainIndex].back();
+                if (parents[0] == tail && tail->GetDependentNodes().size() == 1)
+                {
+                    chains[chainIndex].push_back(&node);
+                    nodeChains[&node] = chainIndex;
+                    return;
+                }
+            }
+
+            size_t level = 0;
+            for (auto chainIndex : parentChains)
+            {
+                level = std::max(level, chainLevels[chainIndex] + 1);
+            }
+            nodeChains[&node] = chains.size();
+            chains.push_back({ &node });
+            chainLevels.push_back(level);
+        });
+
+        std::vector<SubgraphStage> stages;
+        if (!freeNodes.empty())
+        {
+            stages.push_back({ freeNodes });
+        }
+
+        auto firstLevelStage = stages.size();
+        for (size_t chainIndex = 0; chainIndex < chains.size(); ++chainIndex)
+        {
+            auto stageIndex = firstLevelStage + chainLevels[chainIndex];
+            if (stages.size() <= stageIndex)
+            {
+                stages.resize(stageIndex + 1);
+            }
+            stages[stageIndex].push_back(std::move(chains[chainIndex]));
+        }
+        return stages;
+    }
+} // namespace model
+} // namespace ell
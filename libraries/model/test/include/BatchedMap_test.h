@@ -0,0 +1,9 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BatchedMap_test.h (model_test)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+void TestBatchedMapFusesMatrixVectorProducts();
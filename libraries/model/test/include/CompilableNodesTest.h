@@ -73,6 +73,7 @@ void TestBufferNode();
 // mathy nodes
 //
 void TestMatrixVectorMultiplyNode(int m, int n, bool useBlas);
+void TestQuantizedConvolutionNode(int numRows, int numColumns, int numChannels, int numFilters, int filterSize, int stride);
 void TestMatrixMatrixMultiplyNode(int m, int n, int k, bool useBlas);
 void TestOrderedMatrixMatrixMultiplyNode(int m, int n, int k, bool transposeA, bool transposeB, bool transposeC, bool useBlas);
 void TestMatrixMatrixMultiplyCodeNode(int m, int n, int k, int panelM, int panelN, int panelK, int kernelM, int kernelN, int kernelK, nodes::MatrixMatrixMultiplyImplementation gemmImpl);
@@ -108,6 +109,7 @@ void TestBroadcastLinearFunctionNode();
 void TestConvolutionalLayerNode(ConvolutionMethod convolutionMethod, size_t inputPadding = 1, size_t outputPadding = 0);
 void TestConvolutionalLayerNode2(ConvolutionMethod convolutionMethod, size_t inputPadding = 1, size_t outputPadding = 0);
 void TestConvolutionalLayerNode3(ConvolutionMethod convolutionMethod, size_t inputPadding = 1, size_t outputPadding = 0);
+void TestConvolutionalLayerNodeWithPackedGemm();
 void TestFullyConnectedLayerNode(size_t inputPadding = 0, size_t outputPadding = 0);
 void TestMaxPoolingLayerNode(size_t inRows, size_t inCols, size_t numChannels, size_t outRows, size_t outCols, size_t poolingSize, size_t poolingStride, size_t inputPadding = 0, size_t outputPadding = 0);
 void TestMeanPoolingLayerNode(size_t inRows, size_t inCols, size_t numChannels, size_t outRows, size_t outCols, size_t poolingSize, size_t poolingStride, size_t inputPadding = 0, size_t outputPadding = 0);
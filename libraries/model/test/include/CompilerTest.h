@@ -53,9 +53,18 @@ void TestProtoNNPredictorMap();
 void TestCombineOutputMap();
 void TestMultiOutputMap();
 void TestMultiSourceSinkMap();
+void TestPipelinedSourceSinkMap();
 void TestCompiledMapMove();
 void TestCompiledMapClone();
 void TestCompiledMapParallelClone();
+void TestCompiledMapComputeLoop();
+void TestBatchedCompiledMapComputeLoop();
+void TestReentrantCompiledMapState();
+void TestReentrantCompiledMapConcurrentStates();
+void TestPlannedMemoryCompiledMap();
+void TestJitCacheCompiledMap();
+void TestPartitionedOptimizationCompiledMap();
+void TestParallelSubgraphsCompiledMap();
 
 #pragma region implementation
 
@@ -0,0 +1,11 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ScratchMemoryPlanner_test.h (model_test)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+void TestScratchMemoryPlannerReusesMemory();
+void TestScratchMemoryPlannerOverlappingLifetimes();
+void TestScratchMemoryPlannerExtendLifetime();
@@ -0,0 +1,10 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SubgraphScheduler_test.h (model_test)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+void TestScheduleSubgraphsChain();
+void TestScheduleSubgraphsBranches();
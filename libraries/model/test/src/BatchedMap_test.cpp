@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BatchedMap_test.cpp (model_test)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BatchedMap_test.h"
+
+#include <model/include/BatchedMap.h>
+#include <model/include/InputNode.h>
+#include <model/include/Map.h>
+#include <model/include/Model.h>
+
+#include <nodes/include/BinaryOperationNode.h>
+#include <nodes/include/ConstantNode.h>
+#include <nodes/include/MatrixMatrixMultiplyNode.h>
+#include <nodes/include/MatrixVectorMultiplyNode.h>
+
+#include <testing/include/testing.h>
+
+using namespace ell;
+using namespace ell::model;
+using namespace ell::testing;
+
+void TestBatchedMapFusesMatrixVectorProducts()
+{
+    // output = M * input + bias, with a 2x3 matrix M
+    Model model;
+    auto inputNode = model.AddNode<InputNode<double>>(3);
+    const auto& matrix = nodes::Constant(model, std::vector<double>{ 1, 2, 3, 4, 5, 6 });
+    const auto& bias = nodes::Constant(model, std::vector<double>{ 0.5, -0.5 });
+    const auto& product = nodes::MatrixVectorMultiply(matrix, 2, 3, 3, inputNode->output);
+    const auto& sum = nodes::Add(product, bias);
+    Map map(model, { { "input", inputNode } }, { { "output", sum } });
+
+    const int batchSize = 4;
+    std::vector<std::vector<double>> inputs = { { 1, 0, 0 }, { 0, 1, 0 }, { 1, 2, 3 }, { -1, 0.5, 2 } };
+    std::vector<double> batchInput;
+    std::vector<double> expectedOutput;
+    for (const auto& input : inputs)
+    {
+        batchInput.insert(batchInput.end(), input.begin(), input.end());
+        auto output = map.Compute<double>(input);
+        expectedOutput.insert(expectedOutput.end(), output.begin(), output.end());
+    }
+
+    ProcessTest("Testing CanBatchMap", CanBatchMap(map));
+    auto batchedMap = CreateBatchedMap(map, batchSize);
+    const auto& batchedModel = batchedMap.GetModel();
+    ProcessTest("Testing CreateBatchedMap input and output sizes", batchedMap.GetInputSize(0) == 3 * batchSize && batchedMap.GetOutputSize(0) == 2 * batchSize);
+    ProcessTest("Testing CreateBatchedMap fuses the matrix-vector products", batchedModel.GetNodesByType<nodes::MatrixMatrixMultiplyNode<double>>().size() == 1 && batchedModel.GetNodesByType<nodes::MatrixVectorMultiplyNode<double>>().empty());
+    ProcessTest("Testing CreateBatchedMap shares the constants", batchedModel.GetNodesByType<nodes::ConstantNode<double>>().size() == 2);
+
+    auto batchOutput = batchedMap.Compute<double>(batchInput);
+    ProcessTest("Testing CreateBatchedMap output", IsEqual(batchOutput, expectedOutput));
+}
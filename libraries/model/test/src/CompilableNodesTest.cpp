@@ -57,6 +57,7 @@
 #include <nodes/include/NeuralNetworkPredictorNode.h>
 #include <nodes/include/NodeOperations.h>
 #include <nodes/include/PoolingLayerNode.h>
+#include <nodes/include/QuantizedConvolutionNode.h>
 #include <nodes/include/ReceptiveFieldMatrixNode.h>
 #include <nodes/include/RegionDetectionLayerNode.h>
 #include <nodes/include/ReinterpretLayoutNode.h>
@@ -1721,6 +1722,63 @@ void TestMatrixVectorMultiplyNode(int m, int n, bool useBlas)
     });
 }
 
+void TestQuantizedConvolutionNode(int numRows, int numColumns, int numChannels, int numFilters, int filterSize, int stride)
+{
+    using ValueType = float;
+
+    // a padded convolution that writes int8 values into a padded output, followed by a fully connected layer
+    // that reads them, padding included
+    const int padding = filterSize / 2;
+    const int outputRows = (numRows + 2 * padding - filterSize) / stride + 1;
+    const int outputColumns = (numColumns + 2 * padding - filterSize) / stride + 1;
+    const int numOutputs = 7;
+    model::PortMemoryLayout inputLayout(model::MemoryShape{ numRows, numColumns, numChannels }, model::MemoryShape{ padding, padding, 0 });
+    model::PortMemoryLayout convolutionOutputLayout(model::MemoryShape{ outputRows, outputColumns, numFilters }, model::MemoryShape{ 1, 1, 0 });
+    model::PortMemoryLayout outputLayout(model::MemoryShape{ 1, 1, numOutputs });
+
+    auto getWeights = [](int numFilters, int fieldSize) {
+        nodes::QuantizedWeights<ValueType> weights;
+        for (int index = 0; index < numFilters * fieldSize; ++index)
+        {
+            weights.weights.push_back(static_cast<int8_t>((index * 37) % 255 - 127));
+        }
+        weights.outputScales.resize(numFilters);
+        FillVector(weights.outputScales, 0.001f, 0.0005f);
+        weights.bias.resize(numFilters);
+        FillVector(weights.bias, -2.0f, 0.5f);
+        return weights;
+    };
+
+    auto convolutionWeights = getWeights(numFilters, filterSize * filterSize * numChannels);
+    convolutionWeights.inputScale = 0.05f;
+    convolutionWeights.negativeSlope = 0.1f;
+    convolutionWeights.outputQuantizationScale = 0.02f;
+    auto fullyConnectedWeights = getWeights(numOutputs, static_cast<int>(convolutionOutputLayout.GetMemorySize()));
+    fullyConnectedWeights.inputScale = convolutionWeights.outputQuantizationScale;
+    fullyConnectedWeights.negativeSlope = 0;
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(inputLayout);
+    auto convolutionNode = model.AddNode<QuantizedConvolutionNode<ValueType, ValueType, int8_t>>(inputNode->output, inputLayout, convolutionOutputLayout, filterSize, filterSize, stride, padding, convolutionWeights);
+    auto fullyConnectedNode = model.AddNode<QuantizedConvolutionNode<ValueType, int8_t, ValueType>>(convolutionNode->output, convolutionOutputLayout, outputLayout, outputRows + 2, outputColumns + 2, 1, 1, fullyConnectedWeights);
+
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", fullyConnectedNode->output } });
+
+    std::string name = "QuantizedConvolutionNode";
+    TestWithSerialization(map, name, [&](model::Map& map, int iteration) {
+        model::MapCompilerOptions settings;
+        model::ModelOptimizerOptions optimizerOptions;
+        model::IRMapCompiler compiler(settings, optimizerOptions);
+        auto compiledMap = compiler.Compile(map);
+
+        // compare output, including inputs that are clamped to the quantized range
+        std::vector<ValueType> inputVals(inputLayout.GetMemorySize());
+        FillVector(inputVals, -10.0f, 0.25f);
+        std::vector<std::vector<ValueType>> signal = { inputVals };
+        VerifyCompiledOutput(map, compiledMap, signal, utilities::FormatString("%s iteration %d", name.c_str(), iteration));
+    });
+}
+
 void TestMatrixMatrixMultiplyNode(int m, int n, int k, bool useBlas)
 {
     using ValueType = float;
@@ -3295,6 +3353,61 @@ void TestConvolutionalLayerNode3(ConvolutionMethod convolutionMethod, size_t inp
     VerifyArchiveAndUnarchivingMap<ElementType>(map, computeNode, inputWithPadding, output, info);
 }
 
+void TestConvolutionalLayerNodeWithPackedGemm()
+{
+    using ElementType = double;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using Shape = typename Layer<ElementType>::Shape;
+
+    // An odd number of filters and columns, so the packed panels have ragged edges
+    const size_t numRows = 6;
+    const size_t numCols = 5;
+    const size_t numChannels = 4;
+    const size_t numFilters = 9;
+    const size_t inputPaddingSize = 1;
+
+    auto rng = utilities::GetRandomEngine("123");
+    auto rand = [&rng]() { return (double)rng() / (double)(rng.max() - rng.min()) - 0.5; };
+
+    TensorType inputWithPadding(numRows + 2 * inputPaddingSize, numCols + 2 * inputPaddingSize, numChannels);
+    inputWithPadding.Fill(0);
+    auto input = inputWithPadding.GetSubTensor({ inputPaddingSize, inputPaddingSize, 0 }, { numRows, numCols, numChannels });
+    input.Generate(rand);
+
+    Shape outputShape = { numRows, numCols, numFilters };
+    LayerParameters parameters{ inputWithPadding, ZeroPadding(inputPaddingSize), outputShape, NoPadding() };
+    ConvolutionalParameters convolutionalParams{ 3, 1, ConvolutionMethod::unrolled, 1 };
+    TensorType weights(convolutionalParams.receptiveField * numFilters, convolutionalParams.receptiveField, numChannels);
+    weights.Generate(rand);
+
+    ConvolutionalLayer<ElementType> layer(parameters, convolutionalParams, weights);
+    layer.Compute();
+    auto output = layer.GetOutput();
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(inputWithPadding.Size());
+    auto computeNode = model.AddNode<ConvolutionalLayerNode<ElementType>>(inputNode->output, layer);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", computeNode->output } });
+
+    model::MapCompilerOptions settings;
+    model::ModelOptimizerOptions optimizerOptions;
+    optimizerOptions["usePackedGemm"] = true;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+
+    bool usesPackedGemm = false;
+    compiledMap.GetModel().Visit([&usesPackedGemm](const model::Node& node) {
+        usesPackedGemm = usesPackedGemm || dynamic_cast<const MatrixMatrixMultiplyCodeNode<ElementType>*>(&node) != nullptr;
+    });
+    testing::ProcessTest("Testing usePackedGemm option selects MatrixMatrixMultiplyCodeNode for unrolled convolution", usesPackedGemm);
+
+    std::vector<std::vector<ElementType>> signal = { inputWithPadding.ToArray() };
+    std::vector<std::vector<ElementType>> expectedOutput = { output.ToArray() };
+    VerifyMapOutput(map, signal, expectedOutput, computeNode->GetRuntimeTypeName(), "(packed GEMM)");
+    VerifyCompiledOutput(map, compiledMap, signal, computeNode->GetRuntimeTypeName(), "(packed GEMM)");
+}
+
 void TestFullyConnectedLayerNode(size_t inputPaddingSize, size_t outputPaddingSize)
 {
     using ElementType = double;
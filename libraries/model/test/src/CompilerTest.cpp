@@ -11,6 +11,7 @@
 #include <model_testing/include/ModelTestUtilities.h>
 
 #include <model/include/CompilableNode.h>
+#include <model/include/CompiledMapPipeline.h>
 #include <model/include/IRCompiledMap.h>
 #include <model/include/IRMapCompiler.h>
 #include <model/include/InputNode.h>
@@ -25,6 +26,7 @@
 #include <nodes/include/ForestPredictorNode.h>
 #include <nodes/include/L2NormSquaredNode.h>
 #include <nodes/include/LinearPredictorNode.h>
+#include <nodes/include/MatrixVectorMultiplyNode.h>
 #include <nodes/include/MatrixVectorProductNode.h>
 #include <nodes/include/ProtoNNPredictorNode.h>
 #include <nodes/include/SinkNode.h>
@@ -37,6 +39,7 @@
 #include <emitters/include/IREmitter.h>
 #include <emitters/include/IRFunctionEmitter.h>
 #include <emitters/include/IRModuleEmitter.h>
+#include <emitters/include/IRObjectCache.h>
 #include <emitters/include/ScalarVariable.h>
 #include <emitters/include/VectorVariable.h>
 
@@ -50,6 +53,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <filesystem>
 #include <future>
 #include <iostream>
 #include <memory>
@@ -187,6 +191,23 @@ void TestSqEuclideanDistanceMap()
     VerifyCompiledOutput(map, compiledMap, signal, " map");
 }
 
+void TestForestMap()
+{
+    auto map = MakeForestMap();
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+
+    testing::ProcessTest("Testing IsValid of forest map", testing::IsEqual(compiledMap.IsValid(), true));
+
+    // include inputs that land exactly on the thresholds
+    std::vector<std::vector<double>> signal = { { 0.2, 0.5, 0.0 }, { 0.3, 0.6, 0.9 }, { 0.31, 0.61, 0.91 }, { 0.0, 0.0, 0.0 }, { 1.0, 1.0, 1.0 }, { 0.25, 0.21, 0.5 }, { 0.1, 0.7, 0.2 }, { 0.5, 0.4, 1.5 } };
+    VerifyCompiledOutput(map, compiledMap, signal, " forest map");
+}
+
 void TestProtoNNPredictorMap()
 {
     // the values of dim, gamma, and matrices come from the result of running protoNNTrainer with the following command line
@@ -421,8 +442,315 @@ void TestCompiledMapParallelClone()
     }
 }
 
+void TestCompiledMapComputeLoop()
+{
+    std::vector<double> data = { 5, 10, 15 };
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(3);
+    const auto& c1 = nodes::Constant(model, data);
+    const auto& product = nodes::Multiply(c1, inputNode->output);
+    const auto& sum = nodes::Sum(product);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", sum } });
+
+    model::IRMapCompiler compiler;
+    auto compiledMap = compiler.Compile(map);
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 3, 4, 5 }, { 2, 3, 2 } };
+    std::vector<double> inputs;
+    std::vector<double> expected;
+    for (const auto& input : signal)
+    {
+        inputs.insert(inputs.end(), input.begin(), input.end());
+        auto output = map.Compute<double>(input);
+        expected.insert(expected.end(), output.begin(), output.end());
+    }
+
+    std::vector<double> outputs(expected.size());
+    compiledMap.ComputeLoop(inputs.data(), outputs.data(), static_cast<int>(signal.size()));
+    testing::ProcessTest("Testing IRCompiledMap::ComputeLoop", testing::IsEqual(outputs, expected));
+}
+
+void TestBatchedCompiledMapComputeLoop()
+{
+    // output = M * input + bias, with a 2x3 matrix M
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<float>>(3);
+    const auto& matrix = nodes::Constant(model, std::vector<float>{ 1, 2, 3, 4, 5, 6 });
+    const auto& bias = nodes::Constant(model, std::vector<float>{ 0.5f, -0.5f });
+    const auto& product = nodes::MatrixVectorMultiply(matrix, 2, 3, 3, inputNode->output);
+    const auto& sum = nodes::Add(product, bias);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", sum } });
+
+    model::MapCompilerOptions settings;
+    settings.batchSize = 4;
+    model::IRMapCompiler compiler(settings, {});
+    auto compiledMap = compiler.Compile(map);
+
+    // Two full batches, and two inputs left over for the unbatched predict function
+    std::vector<float> inputs;
+    std::vector<float> expected;
+    for (int index = 0; index < 10; ++index)
+    {
+        std::vector<float> input = { static_cast<float>(index), 1.0f - index, 0.5f * index };
+        inputs.insert(inputs.end(), input.begin(), input.end());
+        auto output = map.Compute<float>(input);
+        expected.insert(expected.end(), output.begin(), output.end());
+    }
+
+    std::vector<float> outputs(expected.size());
+    compiledMap.ComputeLoop(inputs.data(), outputs.data(), 10);
+    testing::ProcessTest("Testing batched IRCompiledMap::ComputeLoop", testing::IsEqual(outputs, expected, 1e-5f));
+}
+
+void TestReentrantCompiledMapState()
+{
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(3);
+    auto accumNode = model.AddNode<nodes::AccumulatorNode<double>>(inputNode->output);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", accumNode->output } });
+
+    model::MapCompilerOptions settings;
+    settings.reentrant = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+
+    auto stateSize = compiledMap.GetStateSize();
+    testing::ProcessTest("Testing reentrant map state size", stateSize >= static_cast<int>(3 * sizeof(double)));
+
+    std::vector<char> state1(stateSize);
+    std::vector<char> state2(stateSize);
+    compiledMap.InitState(state1.data());
+    compiledMap.InitState(state2.data());
+
+    std::vector<double> input1 = { 1, 2, 3 };
+    std::vector<double> input2 = { 10, 20, 30 };
+    std::vector<double> output(3);
+    auto compute = [&](std::vector<char>& state, std::vector<double>& input) {
+        compiledMap.LoadState(state.data());
+        compiledMap.ComputeMultiple({ input.data() }, { output.data() });
+        compiledMap.SaveState(state.data());
+        return output;
+    };
+
+    compute(state1, input1);
+    compute(state2, input2);
+    auto result1 = compute(state1, input1);
+    auto result2 = compute(state2, input2);
+    testing::ProcessTest("Testing reentrant map keeps independent states", testing::IsEqual(result1, std::vector<double>{ 2, 4, 6 }) && testing::IsEqual(result2, std::vector<double>{ 20, 40, 60 }));
+}
+
 typedef void (*MapPredictFunction)(void* context, double*, double*);
 
+void TestReentrantCompiledMapConcurrentStates()
+{
+    const int size = 64;
+    const int numIterations = 200;
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(size);
+    auto accumNode = model.AddNode<nodes::AccumulatorNode<double>>(inputNode->output);
+    const auto& scales = nodes::Constant(model, std::vector<double>(size, 3.0));
+    const auto& product = nodes::Multiply(accumNode->output, scales);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", product } });
+
+    model::MapCompilerOptions settings;
+    settings.reentrant = true;
+    settings.mapFunctionName = "TestReentrantConcurrent";
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+
+    // Only the accumulator is state, the intermediate and output buffers aren't
+    auto stateSize = compiledMap.GetStateSize();
+    testing::ProcessTest("Testing reentrant map state excludes activations", stateSize >= static_cast<int>(size * sizeof(double)) && stateSize < static_cast<int>(2 * size * sizeof(double)));
+
+    // Resolve the raw functions up front, since jitting isn't thread-safe
+    auto& jitter = compiledMap.GetJitter();
+    using StateFunction = void (*)(char*);
+    auto predict = reinterpret_cast<MapPredictFunction>(jitter.ResolveFunctionAddress(settings.mapFunctionName));
+    auto initState = reinterpret_cast<StateFunction>(jitter.ResolveFunctionAddress(settings.moduleName + "_InitState"));
+    auto loadState = reinterpret_cast<StateFunction>(jitter.ResolveFunctionAddress(settings.moduleName + "_LoadState"));
+    auto saveState = reinterpret_cast<StateFunction>(jitter.ResolveFunctionAddress(settings.moduleName + "_SaveState"));
+
+    auto run = [&](double value) {
+        std::vector<char> state(stateSize);
+        initState(state.data());
+        std::vector<double> input(size, value);
+        std::vector<double> output(size);
+        bool ok = true;
+        for (int iteration = 1; iteration <= numIterations; ++iteration)
+        {
+            loadState(state.data());
+            predict(nullptr, input.data(), output.data());
+            saveState(state.data());
+            ok = ok && testing::IsEqual(output, std::vector<double>(size, 3.0 * value * iteration));
+        }
+        return ok;
+    };
+
+    auto result1 = std::async(std::launch::async, run, 1.0);
+    auto result2 = std::async(std::launch::async, run, 2.0);
+    auto ok1 = result1.get();
+    auto ok2 = result2.get();
+    testing::ProcessTest("Testing reentrant map on concurrent threads with independent states", ok1 && ok2);
+}
+
+void TestPlannedMemoryCompiledMap()
+{
+    const int size = 100;
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(size);
+    const auto& offsets = nodes::Constant(model, std::vector<double>(size, 1.0));
+    const auto& scales = nodes::Constant(model, std::vector<double>(size, 0.5));
+    const model::OutputPort<double>* current = &inputNode->output;
+    for (int layer = 0; layer < 3; ++layer)
+    {
+        current = &nodes::Multiply(nodes::Add(*current, offsets), scales);
+    }
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", *current } });
+
+    model::MapCompilerOptions settings;
+    settings.planMemory = true;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+
+    // in a chain, at most the input and output of one node are live at the same time
+    auto scratchSize = compiledMap.GetScratchSize();
+    testing::ProcessTest("Testing planned memory scratch size", scratchSize <= static_cast<int>(2 * size * sizeof(double)));
+
+    std::vector<double> input(size);
+    for (int i = 0; i < size; ++i)
+    {
+        input[i] = i;
+    }
+    map.SetInputValue(0, input);
+    auto expected = map.ComputeOutput<double>(0);
+    compiledMap.SetInputValue(0, input);
+    auto result = compiledMap.ComputeOutput<double>(0);
+    testing::ProcessTest("Testing planned memory compiled map output", testing::IsEqual(result, expected));
+}
+
+void TestJitCacheCompiledMap()
+{
+    const std::string cacheDirectory = "jit_cache_test";
+    std::error_code ec;
+    std::filesystem::remove_all(cacheDirectory, ec);
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(3);
+    auto accumNode = model.AddNode<nodes::AccumulatorNode<double>>(inputNode->output);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", accumNode->output } });
+
+    model::MapCompilerOptions settings;
+    settings.jitCacheDirectory = cacheDirectory;
+    model::ModelOptimizerOptions optimizerOptions;
+    std::vector<std::vector<double>> signal = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 3, 4, 5 }, { 2, 3, 2 } };
+
+    model::IRMapCompiler compiler1(settings, optimizerOptions);
+    auto compiledMap1 = compiler1.Compile(map);
+    VerifyCompiledOutput(map, compiledMap1, signal, " JIT cache miss");
+    emitters::IRObjectCache cache(cacheDirectory, settings.jitCacheMaxSize);
+    testing::ProcessTest("Testing JIT cache stores compiled map", !compiledMap1.IsLoadedFromJitCache() && cache.HasObject(compiledMap1.GetJitCacheKey()));
+
+    // compiling the same map again loads it from the cache
+    auto map2 = model::Map(model, { { "input", inputNode } }, { { "output", accumNode->output } });
+    model::IRMapCompiler compiler2(settings, optimizerOptions);
+    auto compiledMap2 = compiler2.Compile(map2);
+    testing::ProcessTest("Testing JIT cache key is stable", testing::IsEqual(compiledMap2.GetJitCacheKey(), compiledMap1.GetJitCacheKey()));
+    testing::ProcessTest("Testing JIT cache hit skips compiling", compiledMap2.IsLoadedFromJitCache());
+    VerifyCompiledOutput(map2, compiledMap2, signal, " JIT cache hit");
+
+    // different options give a different key
+    auto settings3 = settings;
+    settings3.compilerSettings.optimize = false;
+    model::IRMapCompiler compiler3(settings3, optimizerOptions);
+    auto compiledMap3 = compiler3.Compile(map2);
+    testing::ProcessTest("Testing JIT cache key depends on options", compiledMap3.GetJitCacheKey() != compiledMap1.GetJitCacheKey());
+
+    // a map compiled in partitions is cached one partition at a time, and can be loaded with any number of compile threads
+    const auto& sum = nodes::Add(inputNode->output, nodes::Constant(model, std::vector<double>{ 5, 10, 15 }));
+    auto sumAccumNode = model.AddNode<nodes::AccumulatorNode<double>>(sum);
+    const auto& product = nodes::Multiply(sumAccumNode->output, sum);
+    auto partitionedSettings = settings;
+    partitionedSettings.inlineNodes = false;
+    partitionedSettings.compilerSettings.compileThreads = 4;
+    auto map4 = model::Map(model, { { "input", inputNode } }, { { "output", product } });
+    model::IRMapCompiler compiler4(partitionedSettings, optimizerOptions);
+    auto compiledMap4 = compiler4.Compile(map4);
+    VerifyCompiledOutput(map4, compiledMap4, signal, " partitioned JIT cache miss");
+    testing::ProcessTest("Testing JIT cache stores partitioned map", cache.HasObject(compiledMap4.GetJitCacheKey()));
+
+    auto singleThreadSettings = partitionedSettings;
+    singleThreadSettings.compilerSettings.compileThreads = 1;
+    auto map5 = model::Map(model, { { "input", inputNode } }, { { "output", product } });
+    model::IRMapCompiler compiler5(singleThreadSettings, optimizerOptions);
+    auto compiledMap5 = compiler5.Compile(map5);
+    testing::ProcessTest("Testing JIT cache key doesn't depend on compile threads", testing::IsEqual(compiledMap5.GetJitCacheKey(), compiledMap4.GetJitCacheKey()) && compiledMap5.IsLoadedFromJitCache());
+    VerifyCompiledOutput(map5, compiledMap5, signal, " partitioned JIT cache hit");
+
+    emitters::IRObjectCache emptyCache(cacheDirectory, 0);
+    emptyCache.Trim();
+    testing::ProcessTest("Testing JIT cache eviction", !emptyCache.HasObject(compiledMap1.GetJitCacheKey()) && !emptyCache.HasObject(compiledMap4.GetJitCacheKey()));
+    std::filesystem::remove_all(cacheDirectory, ec);
+}
+
+void TestPartitionedOptimizationCompiledMap()
+{
+    std::vector<double> data = { 5, 10, 15 };
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(3);
+    const auto& sum = nodes::Add(inputNode->output, nodes::Constant(model, data));
+    auto accumNode = model.AddNode<nodes::AccumulatorNode<double>>(sum);
+    const auto& product = nodes::Multiply(accumNode->output, sum);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", product } });
+
+    // keep the nodes in functions of their own, so there's more than one function to partition
+    model::MapCompilerOptions settings;
+    settings.inlineNodes = false;
+    settings.compilerSettings.compileThreads = 4;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+    testing::ProcessTest("Testing partitioned optimization uses more than one partition", compiledMap.GetModule().GetNumOptimizationPartitions() > 1);
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 3, 4, 5 }, { 2, 3, 2 } };
+    VerifyCompiledOutput(map, compiledMap, signal, " partitioned optimization");
+}
+
+void TestParallelSubgraphsCompiledMap()
+{
+    // three independent branches, joined at the end
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(3);
+    std::vector<const model::OutputPort<double>*> branches;
+    for (int branch = 0; branch < 3; ++branch)
+    {
+        const auto& offset = nodes::Constant(model, std::vector<double>(3, branch + 1.0));
+        const auto& scale = nodes::Constant(model, std::vector<double>(3, 0.5 * (branch + 1)));
+        const auto& sum = nodes::Add(inputNode->output, offset);
+        auto accumNode = model.AddNode<nodes::AccumulatorNode<double>>(nodes::Multiply(sum, scale));
+        branches.push_back(&accumNode->output);
+    }
+    const auto& output = nodes::Add(nodes::Add(*branches[0], *branches[1]), *branches[2]);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", output } });
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 3, 4, 5 }, { 2, 3, 2 } };
+    for (auto useThreadPool : { true, false })
+    {
+        model::MapCompilerOptions settings;
+        settings.parallelizeSubgraphs = true;
+        settings.compilerSettings.parallelize = true;
+        settings.compilerSettings.useThreadPool = useThreadPool;
+        model::ModelOptimizerOptions optimizerOptions;
+        model::IRMapCompiler compiler(settings, optimizerOptions);
+        auto compiledMap = compiler.Compile(map);
+        map.Reset();
+        VerifyCompiledOutput(map, compiledMap, signal, std::string(" parallel subgraphs") + (useThreadPool ? " (thread pool)" : " (threads)"));
+    }
+}
+
 void TestBinaryVector(bool expanded, bool runJit)
 {
     std::vector<double> data = { 5, 10, 15, 20 };
@@ -872,3 +1200,58 @@ void TestMultiSourceSinkMap()
     TestMultiSourceSinkMap(false, true);
     TestMultiSourceSinkMap(false, false);
 }
+
+void TestPipelinedSourceSinkMap()
+{
+    // A source that produces `numFrames` frames { i, i, i } and a sink that records the results of adding 1 to them
+    constexpr int numFrames = 100;
+    int nextFrame = 0;
+    std::vector<std::vector<double>> results;
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<nodes::TimeTickType>>(2);
+    auto sourceNode = model.AddNode<nodes::SourceNode<double>>(inputNode->output, 3, "PipelineSource", [&nextFrame](auto& v) {
+        if (nextFrame == numFrames)
+        {
+            return false;
+        }
+        v.assign(3, static_cast<double>(nextFrame++));
+        return true;
+    });
+    const auto& sum = nodes::Add(sourceNode->output, nodes::Constant(model, std::vector<double>(3, 1.0)));
+    auto conditionNode = model.AddNode<nodes::ConstantNode<bool>>(true);
+    auto sinkNode = model.AddNode<nodes::SinkNode<double>>(sum, conditionNode->output, "PipelineSink", [&results](const auto& v) {
+        results.push_back(v);
+    });
+    auto map = model::Map(model, { { "time", inputNode } }, { { "output", sinkNode->output } });
+
+    model::MapCompilerOptions settings;
+    settings.moduleName = "TestPipeline";
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+    compiledMap.FinishJitting();
+
+    model::CompiledMapPipelineOptions options;
+    options.queueDepth = 2;
+    options.dropFramesWhenFull = false;
+    model::CompiledMapPipeline<double> pipeline(compiledMap, options);
+    std::vector<nodes::TimeTickType> time = { 0, 0 };
+    pipeline.Start([&time](model::IRCompiledMap& map) { map.Compute<double>(time); });
+
+    auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (pipeline.GetStatistics().framesDelivered < numFrames && std::chrono::steady_clock::now() < timeout)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    pipeline.Stop();
+
+    std::vector<std::vector<double>> expected;
+    for (int i = 0; i < numFrames; ++i)
+    {
+        expected.push_back(std::vector<double>(3, i + 1.0));
+    }
+    // The call to the map that Stop() interrupts has no source frame, so it mustn't deliver a copy of the last result
+    auto statistics = pipeline.GetStatistics();
+    testing::ProcessTest("Testing pipelined source and sink callbacks", testing::IsEqual(results, expected));
+    testing::ProcessTest("Testing pipeline statistics", statistics.framesCaptured == numFrames && statistics.framesDelivered == numFrames && statistics.sourceFramesDropped == 0 && statistics.sinkFramesDropped == 0 && statistics.sourceQueueDepth == 0 && statistics.sinkQueueDepth == 0);
+}
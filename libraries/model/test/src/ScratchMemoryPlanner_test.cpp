@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ScratchMemoryPlanner_test.cpp (model_test)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ScratchMemoryPlanner_test.h"
+
+#include <model/include/ScratchMemoryPlanner.h>
+
+#include <testing/include/testing.h>
+
+#include <utilities/include/Exception.h>
+
+using namespace ell;
+using namespace ell::model;
+using namespace ell::testing;
+
+void TestScratchMemoryPlannerReusesMemory()
+{
+    // a chain a -> b -> c -> d, where each buffer is read by the next step
+    ScratchMemoryPlanner planner(16);
+    auto a = planner.Allocate(100, 1);
+    planner.Release(0);
+    auto b = planner.Allocate(100, 2);
+    planner.Release(1);
+    auto c = planner.Allocate(100, 3);
+    planner.Release(2);
+    auto d = planner.Allocate(100, 4);
+    planner.Release(3);
+
+    ProcessTest("Testing ScratchMemoryPlanner keeps live buffers apart", a != b && b != c && c != d);
+    ProcessTest("Testing ScratchMemoryPlanner reuses released buffers", a == c && b == d);
+    ProcessTest("Testing ScratchMemoryPlanner aligns offsets", a % 16 == 0 && b % 16 == 0);
+    ProcessTest("Testing ScratchMemoryPlanner size", planner.GetSize() == 224 && planner.GetTotalAllocatedSize() == 448);
+}
+
+void TestScratchMemoryPlannerOverlappingLifetimes()
+{
+    ScratchMemoryPlanner planner;
+    auto a = planner.Allocate(10, 3);
+    auto b = planner.Allocate(20, 1);
+    auto c = planner.Allocate(30, 3);
+    planner.Release(1);
+
+    // the gap left by b is the smallest one that fits
+    auto d = planner.Allocate(15, 3);
+    auto e = planner.Allocate(5, 3);
+
+    ProcessTest("Testing ScratchMemoryPlanner places buffers in order", a == 0 && b == 10 && c == 30);
+    ProcessTest("Testing ScratchMemoryPlanner fills gaps", d == 10 && e == 25);
+    ProcessTest("Testing ScratchMemoryPlanner peak size", planner.GetSize() == 60);
+}
+
+void TestScratchMemoryPlannerExtendLifetime()
+{
+    ScratchMemoryPlanner planner;
+    auto a = planner.Allocate(10, 1);
+    planner.ExtendLifetime(a, 3);
+    planner.Release(1);
+    auto b = planner.Allocate(10, 4);
+
+    bool threw = false;
+    try
+    {
+        planner.ExtendLifetime(100, 5);
+    }
+    catch (const utilities::LogicException&)
+    {
+        threw = true;
+    }
+
+    ProcessTest("Testing ScratchMemoryPlanner extended buffers stay live", a != b);
+    ProcessTest("Testing ScratchMemoryPlanner rejects unknown buffers", threw);
+}
@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SubgraphScheduler_test.cpp (model_test)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SubgraphScheduler_test.h"
+
+#include <model/include/InputNode.h>
+#include <model/include/Model.h>
+#include <model/include/SubgraphScheduler.h>
+
+#include <nodes/include/BinaryOperationNode.h>
+#include <nodes/include/ConstantNode.h>
+
+#include <testing/include/testing.h>
+
+using namespace ell;
+using namespace ell::model;
+using namespace ell::testing;
+
+void TestScheduleSubgraphsChain()
+{
+    Model model;
+    auto inputNode = model.AddNode<InputNode<double>>(3);
+    const auto& offset = nodes::Constant(model, std::vector<double>{ 1, 2, 3 });
+    const auto& sum = nodes::Add(inputNode->output, offset);
+    const auto& product = nodes::Multiply(sum, offset);
+
+    auto stages = ScheduleSubgraphs(model);
+    ProcessTest("Testing ScheduleSubgraphs chain stage count", stages.size() == 2);
+    ProcessTest("Testing ScheduleSubgraphs puts nodes with no inputs first", stages[0].size() == 1 && stages[0][0].size() == 2);
+    ProcessTest("Testing ScheduleSubgraphs keeps a chain together", stages[1].size() == 1 && stages[1][0] == Subgraph{ sum.GetNode(), product.GetNode() });
+}
+
+void TestScheduleSubgraphsBranches()
+{
+    // input -> a1 -> a2, input -> b1 -> b2, then a2 + b2
+    Model model;
+    auto inputNode = model.AddNode<InputNode<double>>(3);
+    const auto& offset = nodes::Constant(model, std::vector<double>{ 1, 2, 3 });
+    const auto& a1 = nodes::Add(inputNode->output, offset);
+    const auto& a2 = nodes::Multiply(a1, offset);
+    const auto& b1 = nodes::Subtract(inputNode->output, offset);
+    const auto& b2 = nodes::Multiply(b1, b1);
+    const auto& join = nodes::Add(a2, b2);
+    const auto& tail = nodes::Multiply(join, offset);
+
+    auto stages = ScheduleSubgraphs(model);
+    ProcessTest("Testing ScheduleSubgraphs branches stage count", stages.size() == 3);
+    if (stages.size() != 3)
+    {
+        return;
+    }
+
+    auto& branches = stages[1];
+    bool foundA = false;
+    bool foundB = false;
+    for (const auto& subgraph : branches)
+    {
+        foundA = foundA || subgraph == Subgraph{ a1.GetNode(), a2.GetNode() };
+        foundB = foundB || subgraph == Subgraph{ b1.GetNode(), b2.GetNode() };
+    }
+    ProcessTest("Testing ScheduleSubgraphs puts independent branches in the same stage", branches.size() == 2 && foundA && foundB);
+    ProcessTest("Testing ScheduleSubgraphs runs the join after the branches", stages[2].size() == 1 && stages[2][0] == Subgraph{ join.GetNode(), tail.GetNode() });
+}
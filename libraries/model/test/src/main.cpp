@@ -10,6 +10,7 @@
 // Model tests
 //
 
+#include "BatchedMap_test.h"
 #include "Map_test.h"
 #include "Metadata_test.h"
 #include "ModelBuilder_test.h"
@@ -17,6 +18,8 @@
 #include "ModelTransformerTest.h"
 #include "Model_test.h"
 #include "PortElements_test.h"
+#include "ScratchMemoryPlanner_test.h"
+#include "SubgraphScheduler_test.h"
 #include "Submodel_test.h"
 
 #include <testing/include/testing.h>
@@ -96,6 +99,18 @@ int main()
 
         // ModelOptimizerOptions tests
         TestModelOptimizerOptions();
+
+        // ScratchMemoryPlanner tests
+        TestScratchMemoryPlannerReusesMemory();
+        TestScratchMemoryPlannerOverlappingLifetimes();
+        TestScratchMemoryPlannerExtendLifetime();
+
+        // SubgraphScheduler tests
+        TestScheduleSubgraphsChain();
+        TestScheduleSubgraphsBranches();
+
+        // BatchedMap tests
+        TestBatchedMapFusesMatrixVectorProducts();
     }
     catch (const utilities::Exception& exception)
     {
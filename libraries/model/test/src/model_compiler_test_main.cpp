@@ -36,6 +36,11 @@ void TestMatrixMatrixMultiplyCodeNodeImplementations()
     TestMatrixMatrixMultiplyCodeNode(4, 4, 4, fallbackPanelM, fallbackPanelN, fallbackPanelK, fallbackKernelM, fallbackKernelN, fallbackKernelK, nodes::MatrixMatrixMultiplyImplementation::SimpleForLoops);
     TestMatrixMatrixMultiplyCodeNode(4, 8, 8, fallbackPanelM, fallbackPanelN, fallbackPanelK, fallbackKernelM, fallbackKernelN, fallbackKernelK, nodes::MatrixMatrixMultiplyImplementation::SimpleForLoops);
     TestMatrixMatrixMultiplyCodeNode(4, 4, 8, fallbackPanelM, fallbackPanelN, fallbackPanelK, fallbackKernelM, fallbackKernelN, fallbackKernelK, nodes::MatrixMatrixMultiplyImplementation::SimpleForLoops);
+
+    // Packed, cache-blocked implementation (block sizes come from the target, not the panel and kernel sizes)
+    TestMatrixMatrixMultiplyCodeNode(4, 4, 4, fallbackPanelM, fallbackPanelN, fallbackPanelK, fallbackKernelM, fallbackKernelN, fallbackKernelK, nodes::MatrixMatrixMultiplyImplementation::Packed_Loopnest_Value);
+    TestMatrixMatrixMultiplyCodeNode(16, 32, 24, fallbackPanelM, fallbackPanelN, fallbackPanelK, fallbackKernelM, fallbackKernelN, fallbackKernelK, nodes::MatrixMatrixMultiplyImplementation::Packed_Loopnest_Value);
+    TestMatrixMatrixMultiplyCodeNode(31, 17, 300, fallbackPanelM, fallbackPanelN, fallbackPanelK, fallbackKernelM, fallbackKernelN, fallbackKernelK, nodes::MatrixMatrixMultiplyImplementation::Packed_Loopnest_Value);
 }
 
 void TestIRCompiler()
@@ -71,6 +76,14 @@ void TestIRCompiler()
     TestCompiledMapMove();
     TestCompiledMapClone();
     TestCompiledMapParallelClone();
+    TestCompiledMapComputeLoop();
+    TestBatchedCompiledMapComputeLoop();
+    TestReentrantCompiledMapState();
+    TestReentrantCompiledMapConcurrentStates();
+    TestPlannedMemoryCompiledMap();
+    TestJitCacheCompiledMap();
+    TestPartitionedOptimizationCompiledMap();
+    TestParallelSubgraphsCompiledMap();
 
     TestBinaryScalar();
     TestBinaryVector(true);
@@ -94,6 +107,9 @@ void TestIRCompiler()
     TestMatrixVectorMultiplyNode(10, 5, true);
 #endif
     TestMatrixVectorMultiplyNode(10, 5, false);
+    TestQuantizedConvolutionNode(5, 6, 3, 4, 3, 1);
+    TestQuantizedConvolutionNode(8, 8, 16, 8, 3, 2);
+    TestQuantizedConvolutionNode(4, 3, 1, 2, 1, 1);
 
 #ifdef USE_BLAS
     TestMatrixMatrixMultiplyNode(4, 5, 6, true);
@@ -256,6 +272,7 @@ void TestIRCompiler()
 
     TestConvolutionalLayerNode2(ConvolutionMethod::unrolled, 1, 0);
     TestConvolutionalLayerNode3(ConvolutionMethod::unrolled, 1, 0);
+    TestConvolutionalLayerNodeWithPackedGemm();
     // TestConvolutionalLayerNode(ConvolutionMethod::unrolled, 2, 0);
     // TestConvolutionalLayerNode(ConvolutionMethod::unrolled, 1, 1); // Convolutional layer output padding not supported
 
@@ -279,7 +296,9 @@ void TestIRCompiler()
     // TestFullyConnectedLayerNode(1, 1); // Fully-connected layer nodes can't have padding (yet)
 
     TestProtoNNPredictorMap();
+    TestForestMap();
     TestMultiSourceSinkMap();
+    TestPipelinedSourceSinkMap();
 
     TestRegionDetectionNode();
 
@@ -0,0 +1,250 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BiasActivationNode.h (nodes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ActivationFunctions.h"
+#include "BroadcastFunctionNode.h"
+
+#include <emitters/include/IRFunctionEmitter.h>
+#include <emitters/include/LLVMUtilities.h>
+
+#include <model/include/IRMapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/OutputPort.h>
+#include <model/include/PortMemoryLayout.h>
+
+#include <predictors/neural/include/Activation.h>
+
+#include <utilities/include/Archiver.h>
+#include <utilities/include/TypeName.h>
+
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary> The binary function f(x, b) = activation(x + b), for adding a bias and applying an activation function in one pass. </summary>
+    template <typename ValueType, typename ActivationFunctionType>
+    class BiasActivationFunction : public BroadcastBinaryFunctionType<ValueType>
+    {
+    public:
+        BiasActivationFunction() = default;
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="activation"> The activation function to apply after adding the bias. </param>
+        BiasActivationFunction(ActivationFunctionType activation) :
+            _activation(activation) {}
+
+        /// <summary> Computes the function (on the host machine) </summary>
+        ///
+        /// <param name="x"> The primary value </param>
+        /// <param name="b"> The bias </param>
+        /// <returns> The value activation(x + b) </returns>
+        ValueType Compute(ValueType x, ValueType b) const override { return _activation.Compute(x + b); }
+        using BroadcastBinaryFunctionType<ValueType>::Compute;
+
+        /// <summary> Emits IR to compute the function </summary>
+        ///
+        /// <param name="x"> The primary value </param>
+        /// <param name="b"> The bias </param>
+        /// <returns> The value activation(x + b) </returns>
+        emitters::LLVMValue Compile(emitters::IRFunctionEmitter& function, emitters::LLVMValue x, emitters::LLVMValue b) const override
+        {
+            return _activation.Compile(function, function.Operator(emitters::GetAddForValueType<ValueType>(), x, b));
+        }
+        using BroadcastBinaryFunctionType<ValueType>::Compile;
+
+        /// <summary> Gets the activation function. </summary>
+        const ActivationFunctionType& GetActivationFunction() const { return _activation; }
+
+        /// <summary> Adds the parameters of the activation function to an archive. </summary>
+        ///
+        /// <param name="archiver"> The archiver. </param>
+        void WriteToArchive(utilities::Archiver& archiver) const
+        {
+            if constexpr (std::is_same_v<ActivationFunctionType, LeakyReLUActivationFunction<ValueType>>)
+            {
+                archiver["leakyFactor"] << _activation.GetLeakyFactor();
+            }
+        }
+
+        /// <summary> Reads the parameters of the activation function from an archive. </summary>
+        ///
+        /// <param name="archiver"> The unarchiver. </param>
+        void ReadFromArchive(utilities::Unarchiver& archiver)
+        {
+            if constexpr (std::is_same_v<ActivationFunctionType, LeakyReLUActivationFunction<ValueType>>)
+            {
+                ValueType leakyFactor = 0;
+                archiver["leakyFactor"] >> leakyFactor;
+                _activation = LeakyReLUActivationFunction<ValueType>(leakyFactor);
+            }
+        }
+
+    private:
+        ActivationFunctionType _activation;
+    };
+
+    /// <summary>
+    /// A node that adds a per-channel bias to its input and applies an activation function to the result, so that
+    /// the bias and activation of a layer take a single pass over its output instead of one pass each. Layers that
+    /// can apply a `BiasActivationEpilogue` as they write their output don't need this node at all.
+    /// </summary>
+    template <typename ValueType, typename ActivationFunctionType>
+    class BiasActivationNode : public BroadcastBinaryFunctionNode<ValueType, BiasActivationFunction<ValueType, ActivationFunctionType>>
+    {
+        using BaseType = BroadcastBinaryFunctionNode<ValueType, BiasActivationFunction<ValueType, ActivationFunctionType>>;
+
+    public:
+        using BaseType::output;
+        using BaseType::primaryInput;
+        using BaseType::secondaryInput;
+
+        /// <summary> Default constructor. </summary>
+        BiasActivationNode() = default;
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="input"> The input. </param>
+        /// <param name="inputLayout"> The memory layout of the input. </param>
+        /// <param name="bias"> The bias, with one entry per channel. </param>
+        /// <param name="outputLayout"> The memory layout of the output. </param>
+        /// <param name="activation"> The activation function. </param>
+        BiasActivationNode(const model::OutputPort<ValueType>& input,
+                           const model::PortMemoryLayout& inputLayout,
+                           const model::OutputPort<ValueType>& bias,
+                           const model::PortMemoryLayout& outputLayout,
+                           ActivationFunctionType activation) :
+            BaseType(input, inputLayout, bias, channelDimension, outputLayout, BiasActivationFunction<ValueType, ActivationFunctionType>(activation))
+        {
+        }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType, ActivationFunctionType>("BiasActivationNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void WriteToArchive(utilities::Archiver& archiver) const override
+        {
+            BaseType::WriteToArchive(archiver);
+            this->GetFunction().WriteToArchive(archiver);
+        }
+
+        void ReadFromArchive(utilities::Unarchiver& archiver) override
+        {
+            BaseType::ReadFromArchive(archiver);
+            auto function = this->GetFunction();
+            function.ReadFromArchive(archiver);
+            this->SetFunction(function);
+        }
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override
+        {
+            const auto& newInput = transformer.GetCorrespondingInputs(primaryInput);
+            const auto& newBias = transformer.GetCorrespondingInputs(secondaryInput);
+            auto newNode = transformer.AddNode<BiasActivationNode<ValueType, ActivationFunctionType>>(newInput,
+                                                                                                    this->GetInputMemoryLayout(),
+                                                                                                    newBias,
+                                                                                                    this->GetOutputMemoryLayout(),
+                                                                                                    this->GetFunction().GetActivationFunction());
+            transformer.MapNodeOutput(output, newNode->output);
+        }
+
+        static constexpr size_t channelDimension = 2;
+    };
+
+    /// <summary>
+    /// A per-channel bias and an activation function that a layer applies to its values as it writes them, so
+    /// that y = activation(x + bias) takes no pass over the output of its own. The output must be unpadded, with
+    /// the channels in its innermost dimension, so the bias of an entry is `bias[index % bias.size()]`.
+    /// </summary>
+    template <typename ValueType>
+    class BiasActivationEpilogue
+    {
+    public:
+        /// <summary> Default constructor, for an epilogue that does nothing. </summary>
+        BiasActivationEpilogue() = default;
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="bias"> The bias of each channel, or empty if there is no bias. </param>
+        /// <param name="activation"> The activation function, or null if there is none. It's copied. </param>
+        BiasActivationEpilogue(const std::vector<ValueType>& bias, const predictors::neural::ActivationImpl<ValueType>* activation);
+
+        /// <summary> Indicates if the epilogue does nothing. </summary>
+        bool IsEmpty() const { return _bias.empty() && !_activation; }
+
+        /// <summary> Gets the bias of each channel, which is empty if there is no bias. </summary>
+        const std::vector<ValueType>& GetBias() const { return _bias; }
+
+        /// <summary> Gets the activation function, or null if there is none. </summary>
+        const predictors::neural::ActivationImpl<ValueType>* GetActivation() const { return _activation ? _activation->GetImpl() : nullptr; }
+
+        /// <summary> Applies the epilogue to values on the host machine. </summary>
+        ///
+        /// <param name="values"> The values, which are updated in place. </param>
+        void Compute(std::vector<ValueType>& values) const;
+
+        /// <summary> Emits the loop that applies the epilogue to the output of a node. </summary>
+        ///
+        /// <param name="compiler"> The compiler. </param>
+        /// <param name="node"> The node whose output the epilogue is applied to, for naming its globals. </param>
+        /// <param name="function"> The function being emitted. </param>
+        /// <param name="values"> A pointer to the values, which are updated in place. </param>
+        /// <param name="size"> The number of values. </param>
+        void Compile(model::IRMapCompiler& compiler, const model::Node& node, emitters::IRFunctionEmitter& function, emitters::LLVMValue values, int size) const;
+
+        /// <summary> Adds the epilogue's properties to the archive of the node that applies it. </summary>
+        ///
+        /// <param name="archiver"> The archiver. </param>
+        void WriteToArchive(utilities::Archiver& archiver) const;
+
+        /// <summary> Reads the epilogue's properties from the archive of the node that applies it, if it has them. </summary>
+        ///
+        /// <param name="archiver"> The unarchiver. </param>
+        void ReadFromArchive(utilities::Unarchiver& archiver);
+
+    private:
+        std::vector<ValueType> _bias;
+        std::optional<predictors::neural::Activation<ValueType>> _activation;
+    };
+
+    /// <summary>
+    /// Adds the node that applies a per-channel bias and an activation function to the output of a layer that
+    /// can't apply them itself: a `BiasActivationNode`, or a `BroadcastLinearFunctionNode` if there's no activation.
+    /// </summary>
+    ///
+    /// <param name="transformer"> The transformer to add the nodes with. </param>
+    /// <param name="input"> The output of the layer. </param>
+    /// <param name="inputLayout"> The memory layout of the layer's output, whose last logical dimension holds the channels. </param>
+    /// <param name="outputLayout"> The memory layout of the new node's output. </param>
+    /// <param name="bias"> The bias of each channel, or empty if there is no bias. </param>
+    /// <param name="activation"> The activation function, or null if there is none. </param>
+    ///
+    /// <returns> The output of the new node. </returns>
+    template <typename ValueType>
+    const model::OutputPort<ValueType>& AddBiasActivationNode(model::ModelTransformer& transformer,
+                                                              const model::OutputPort<ValueType>& input,
+                                                              const model::PortMemoryLayout& inputLayout,
+                                                              const model::PortMemoryLayout& outputLayout,
+                                                              const std::vector<ValueType>& bias,
+                                                              const predictors::neural::ActivationImpl<ValueType>* activation);
+} // namespace nodes
+} // namespace ell
@@ -78,6 +78,12 @@ namespace nodes
         /// <summary> Gets information about the input memory layout </summary>
         model::PortMemoryLayout GetOutputMemoryLayout() const { return _output.GetMemoryLayout(); }
 
+        /// <summary> Gets the function applied coordinate-wise </summary>
+        FunctionType GetFunction() const { return _function; }
+
+        /// <summary> Gets the padding value </summary>
+        ValueType GetPaddingValue() const { return _paddingValue; }
+
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
         /// <returns> The name of this type. </returns>
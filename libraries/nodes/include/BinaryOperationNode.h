@@ -107,6 +107,18 @@ namespace nodes
         /// <returns> The operation </returns>
         BinaryOperationType GetOperation() const { return _operation; }
 
+        /// <summary> Gets the memory layout of the left-hand input. </summary>
+        const model::PortMemoryLayout& GetInputMemoryLayout1() const { return _inputLayout1; }
+
+        /// <summary> Gets the memory layout of the right-hand input. </summary>
+        const model::PortMemoryLayout& GetInputMemoryLayout2() const { return _inputLayout2; }
+
+        /// <summary> Gets the memory layout of the output. </summary>
+        model::PortMemoryLayout GetOutputMemoryLayout() const { return _output.GetMemoryLayout(); }
+
+        /// <summary> Gets the padding value used for the output. </summary>
+        ValueType GetPaddingValue() const { return _paddingValue; }
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
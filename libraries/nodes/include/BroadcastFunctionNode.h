@@ -248,6 +248,12 @@ namespace nodes
         size_t GetBroadcastDimension() const { return _broadcastDimension; }
         size_t NumPrimaryInputDimensions() const { return GetInputMemoryLayout().NumDimensions(); }
 
+        /// <summary> Returns the function applied to each entry. </summary>
+        FunctionType GetFunction() const { return _function; }
+
+        /// <summary> Returns the value written to the padding of the output. </summary>
+        ValueType GetOutputPadding() const { return _paddingValue; }
+
     protected:
         BroadcastFunctionNode(const std::vector<model::InputPortBase*>& inputs, const std::vector<model::OutputPortBase*>& outputs);
 
@@ -265,7 +271,6 @@ namespace nodes
         virtual const model::InputPort<ValueType>* GetSecondaryInput(int index) const = 0;
         virtual const model::OutputPort<ValueType>& GetOutput() const = 0;
         bool IsSecondaryInputPresent(int index) const;
-        FunctionType GetFunction() const { return _function; }
 
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
@@ -278,7 +283,8 @@ namespace nodes
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
 
-        ValueType GetOutputPadding() const { return _paddingValue; }
+        // For subclasses whose function has parameters that are archived
+        void SetFunction(FunctionType function) { _function = function; }
 
     private:
         model::PortMemoryLayout _inputLayout;
@@ -334,10 +340,9 @@ namespace nodes
         using BroadcastFunctionNode<ValueType, FunctionType>::GetOutputMemoryLayout;
         using BroadcastFunctionNode<ValueType, FunctionType>::GetBroadcastDimension;
         using BroadcastFunctionNode<ValueType, FunctionType>::NumPrimaryInputDimensions;
-
-    protected:
         using BroadcastFunctionNode<ValueType, FunctionType>::GetFunction;
 
+    protected:
         utilities::ArchiveVersion GetArchiveVersion() const override;
         bool CanReadArchiveVersion(const utilities::ArchiveVersion& version) const override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
@@ -408,11 +413,9 @@ namespace nodes
         using BroadcastFunctionNode<ValueType, FunctionType>::GetOutputMemoryLayout;
         using BroadcastFunctionNode<ValueType, FunctionType>::GetBroadcastDimension;
         using BroadcastFunctionNode<ValueType, FunctionType>::NumPrimaryInputDimensions;
-
-    protected:
         using BroadcastFunctionNode<ValueType, FunctionType>::GetFunction;
-        using BroadcastFunctionNode<ValueType, FunctionType>::NumElements;
 
+    protected:
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
 
@@ -484,10 +487,9 @@ namespace nodes
         using BroadcastFunctionNode<ValueType, FunctionType>::GetOutputMemoryLayout;
         using BroadcastFunctionNode<ValueType, FunctionType>::GetBroadcastDimension;
         using BroadcastFunctionNode<ValueType, FunctionType>::NumPrimaryInputDimensions;
-
-    protected:
         using BroadcastFunctionNode<ValueType, FunctionType>::GetFunction;
 
+    protected:
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
 
@@ -20,6 +20,7 @@
 
 #include <predictors/include/ConstantPredictor.h>
 
+#include <utilities/include/BinaryArchiver.h>
 #include <utilities/include/IArchivable.h>
 #include <utilities/include/TypeName.h>
 #include <utilities/include/TypeTraits.h>
@@ -67,10 +68,21 @@ namespace nodes
         /// <param name="layout"> The memory layout of the output data </param>
         ConstantNode(const std::vector<ValueType>& value, const model::PortMemoryLayout& layout);
 
-        /// <summary> Gets the values contained in this node </summary>
+        /// Constructor for an arbitrary-shaped array constant whose values stay in a memory-mapped archive
+        ///
+        /// <param name="value"> The values in the mapping </param>
+        /// <param name="layout"> The memory layout of the output data </param>
+        ConstantNode(const utilities::MappedArray<ValueType>& value, const model::PortMemoryLayout& layout);
+
+        /// <summary> Gets the values contained in this node. If they're in a memory-mapped archive, the first call copies them out. </summary>
         ///
         /// <returns> The values contained in this node </returns>
-        const std::vector<ValueType>& GetValues() const { return _values; }
+        const std::vector<ValueType>& GetValues() const;
+
+        /// <summary> Gets the number of values contained in this node </summary>
+        ///
+        /// <returns> The number of values contained in this node </returns>
+        size_t GetNumValues() const { return _mappedValues.IsMapped() ? _mappedValues.Size() : _values.size(); }
 
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
@@ -98,8 +110,10 @@ namespace nodes
         // Output
         model::OutputPort<ValueType> _output;
 
-        // Constant value
-        std::vector<ValueType> _values;
+        // Constant value, which either lives in `_mappedValues` when read from a memory-mapped binary archive, or
+        // in `_values`
+        utilities::MappedArray<ValueType> _mappedValues;
+        mutable std::vector<ValueType> _values;
     };
 
     /// <summary> Convenience function for adding a ConstantNode to a model. </summary>
@@ -191,23 +205,49 @@ namespace nodes
         _output(this, defaultOutputPortName, layout),
         _values(values){};
 
+    template <typename ValueType>
+    ConstantNode<ValueType>::ConstantNode(const utilities::MappedArray<ValueType>& values, const model::PortMemoryLayout& layout) :
+        CompilableNode({}, { &_output }),
+        _output(this, defaultOutputPortName, layout),
+        _mappedValues(values){};
+
+    template <typename ValueType>
+    const std::vector<ValueType>& ConstantNode<ValueType>::GetValues() const
+    {
+        if (_mappedValues.IsMapped() && _values.size() != _mappedValues.Size())
+        {
+            _values = _mappedValues.ToArray();
+        }
+        return _values;
+    }
+
     template <typename ValueType>
     void ConstantNode<ValueType>::Compute() const
     {
-        _output.SetOutput(_values);
+        if (_mappedValues.IsMapped())
+        {
+            _output.SetOutput(_mappedValues.begin(), _mappedValues.end());
+        }
+        else
+        {
+            _output.SetOutput(_values);
+        }
     }
 
     template <typename ValueType>
     void ConstantNode<ValueType>::Copy(model::ModelTransformer& transformer) const
     {
-        auto newNode = transformer.AddNode<ConstantNode<ValueType>>(_values, _output.GetMemoryLayout());
+        // the copy refers to the same mapping, rather than copying the values out of it
+        auto newNode = _mappedValues.IsMapped() ? transformer.AddNode<ConstantNode<ValueType>>(_mappedValues, _output.GetMemoryLayout())
+                                                : transformer.AddNode<ConstantNode<ValueType>>(_values, _output.GetMemoryLayout());
         transformer.MapNodeOutput(output, newNode->output);
     }
 
     template <typename ValueType>
     void ConstantNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
-        auto values = this->GetValues();
+        // the module keeps its own copy of the values, so don't keep another one in the node
+        auto values = _mappedValues.IsMapped() ? _mappedValues.ToArray() : _values;
         emitters::Variable* pVar = nullptr;
         pVar = function.GetModule().Variables().AddVariable<emitters::LiteralVectorVariable<ValueType>>(values);
         compiler.SetVariableForPort(output, pVar); // Just set the variable corresponding to the output port to be the global variable we created
@@ -229,7 +269,14 @@ namespace nodes
     void ConstantNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
     {
         Node::WriteToArchive(archiver);
-        archiver["values"] << _values;
+        if (_mappedValues.IsMapped())
+        {
+            archiver["values"] << _mappedValues.ToArray();
+        }
+        else
+        {
+            archiver["values"] << _values;
+        }
         archiver["layout"] << _output.GetMemoryLayout();
     }
 
@@ -237,10 +284,16 @@ namespace nodes
     void ConstantNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
     {
         Node::ReadFromArchive(archiver);
-        archiver["values"] >> _values;
+        _mappedValues = {};
+        _values.clear();
+        auto binaryArchiver = dynamic_cast<utilities::BinaryUnarchiver*>(&archiver);
+        if (binaryArchiver == nullptr || !binaryArchiver->TryUnarchiveMappedArray("values", _mappedValues))
+        {
+            archiver["values"] >> _values;
+        }
         model::PortMemoryLayout layout;
         archiver["layout"] >> layout;
-        _output.SetMemoryLayout(layout);        
+        _output.SetMemoryLayout(layout);
     }
 
     template <typename ValueType, typename ModelLikeType>
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "BiasActivationNode.h"
 #include "NeuralNetworkLayerNode.h"
 
 #include <model/include/IRMapCompiler.h>
@@ -44,6 +45,13 @@ namespace nodes
         /// <param name="layer"> The convolutional layer to wrap. </param>
         ConvolutionalLayerNode(const model::OutputPort<ValueType>& input, const predictors::neural::ConvolutionalLayer<ValueType>& layer);
 
+        /// <summary> Constructor from a layer, with a bias and activation that the layer applies to its output as it's written. </summary>
+        ///
+        /// <param name="input"> </param>
+        /// <param name="layer"> The convolutional layer to wrap, whose output must not be padded. </param>
+        /// <param name="epilogue"> The bias and activation to apply to the layer's output. </param>
+        ConvolutionalLayerNode(const model::OutputPort<ValueType>& input, const predictors::neural::ConvolutionalLayer<ValueType>& layer, const BiasActivationEpilogue<ValueType>& epilogue);
+
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
         /// <returns> The name of this type. </returns>
@@ -54,14 +62,22 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Gets the bias and activation applied to the layer's output. </summary>
+        const BiasActivationEpilogue<ValueType>& GetEpilogue() const { return _epilogue; }
+
         /// <summary> Indicates if this node is able to compile itself to code. </summary>
         bool IsCompilable(const model::MapCompiler* compiler) const override { return false; }
 
     protected:
+        void Compute() const override;
         bool Refine(model::ModelTransformer& transformer) const override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
 
     private:
         void Copy(model::ModelTransformer& transformer) const override;
+
+        BiasActivationEpilogue<ValueType> _epilogue;
     };
 } // namespace nodes
 } // namespace ell
@@ -16,6 +16,8 @@
 #include "SingleElementThresholdNode.h"
 #include "SumNode.h"
 
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
 #include <model/include/Model.h>
 #include <model/include/ModelTransformer.h>
 #include <model/include/Node.h>
@@ -23,7 +25,12 @@
 #include <predictors/include/ForestPredictor.h>
 #include <predictors/include/SingleElementThresholdPredictor.h>
 
+#include <utilities/include/Exception.h>
+#include <utilities/include/Unused.h>
+
+#include <algorithm>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -36,7 +43,7 @@ namespace nodes
     /// <typeparam name="SplitRuleType"> The split rule type. </typeparam>
     /// <typeparam name="EdgePredictorType"> The edge predictor type. </typeparam>
     template <typename SplitRuleType, typename EdgePredictorType>
-    class ForestPredictorNode : public model::Node
+    class ForestPredictorNode : public model::CompilableNode
     {
     public:
         /// @name Input and Output Ports
@@ -70,11 +77,15 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Indicates if this node is able to compile itself to code. Forests that can't be flattened are refined instead. </summary>
+        bool IsCompilable(const model::MapCompiler* compiler) const override;
+
         /// <summary> Refines this node in the model being constructed by the transformer </summary>
         bool Refine(model::ModelTransformer& transformer) const override;
 
     protected:
         void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
 
@@ -117,7 +128,7 @@ namespace nodes
 {
     template <typename SplitRuleType, typename EdgePredictorType>
     ForestPredictorNode<SplitRuleType, EdgePredictorType>::ForestPredictorNode(const model::OutputPort<double>& input, const predictors::ForestPredictor<SplitRuleType, EdgePredictorType>& forest) :
-        Node({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }),
+        CompilableNode({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }),
         _input(this, input, defaultInputPortName),
         _output(this, defaultOutputPortName, 1),
         _treeOutputs(this, treeOutputsPortName, forest.NumTrees()),
@@ -128,7 +139,7 @@ namespace nodes
 
     template <typename SplitRuleType, typename EdgePredictorType>
     ForestPredictorNode<SplitRuleType, EdgePredictorType>::ForestPredictorNode() :
-        Node({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }),
+        CompilableNode({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }),
         _input(this, {}, defaultInputPortName),
         _output(this, defaultOutputPortName, 1),
         _treeOutputs(this, treeOutputsPortName, 0),
@@ -165,6 +176,17 @@ namespace nodes
         transformer.MapNodeOutput(edgeIndicatorVector, newNode->edgeIndicatorVector);
     }
 
+    template <typename SplitRuleType, typename EdgePredictorType>
+    bool ForestPredictorNode<SplitRuleType, EdgePredictorType>::IsCompilable(const model::MapCompiler* compiler) const
+    {
+        UNUSED(compiler);
+        if constexpr (predictors::IsFlattenableForest<SplitRuleType, EdgePredictorType>)
+        {
+            return _input.Size() >= _forest.GetFlattenedForest()->GetInputSize();
+        }
+        return false;
+    }
+
     template <typename SplitRuleType, typename EdgePredictorType>
     bool ForestPredictorNode<SplitRuleType, EdgePredictorType>::Refine(model::ModelTransformer& transformer) const
     {
@@ -269,9 +291,113 @@ namespace nodes
         return true;
     }
 
+    template <typename SplitRuleType, typename EdgePredictorType>
+    void ForestPredictorNode<SplitRuleType, EdgePredictorType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        if constexpr (predictors::IsFlattenableForest<SplitRuleType, EdgePredictorType>)
+        {
+            using namespace std::string_literals;
+
+            // emit the arrays of the flattened forest as constants, keeping the thresholds in double so that the
+            // comparisons match the ones the refined SingleElementThresholdNodes make
+            auto flattenedForest = _forest.GetFlattenedForest();
+            auto toIntVector = [](const std::vector<uint32_t>& values) { return std::vector<int>(values.begin(), values.end()); };
+
+            auto& module = function.GetModule();
+            auto featureIndices = module.ConstantArray("forestFeatureIndices_"s + GetInternalStateIdentifier(), toIntVector(flattenedForest->GetFeatureIndices()));
+            auto thresholds = module.ConstantArray("forestThresholds_"s + GetInternalStateIdentifier(), flattenedForest->GetExactThresholds());
+            auto children = module.ConstantArray("forestChildren_"s + GetInternalStateIdentifier(), toIntVector(flattenedForest->GetChildren()));
+            auto edgeValues = module.ConstantArray("forestEdgeValues_"s + GetInternalStateIdentifier(), flattenedForest->GetEdgeValues());
+            auto rootIndices = module.ConstantArray("forestRootIndices_"s + GetInternalStateIdentifier(), toIntVector(flattenedForest->GetRootIndices()));
+            const int sinkIndex = static_cast<int>(flattenedForest->NumInteriorNodes());
+
+            // trees of the same depth share a loop, so visit the trees ordered by depth
+            const auto& treeDepths = flattenedForest->GetTreeDepths();
+            std::vector<int> treeOrder(treeDepths.size());
+            std::iota(treeOrder.begin(), treeOrder.end(), 0);
+            std::stable_sort(treeOrder.begin(), treeOrder.end(), [&treeDepths](int a, int b) { return treeDepths[a] < treeDepths[b]; });
+            auto treeIndices = module.ConstantArray("forestTreeOrder_"s + GetInternalStateIdentifier(), treeOrder);
+
+            emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+            emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+            emitters::LLVMValue pTreeOutputs = compiler.EnsurePortEmitted(treeOutputs);
+            emitters::LLVMValue pEdgeIndicator = compiler.EnsurePortEmitted(edgeIndicatorVector);
+
+            // LLVM internally uses 1 bit for boolean. We use integers to store boolean results. That requires a typecast in LLVM
+            auto trueValue = function.CastBoolToByte(function.Literal(true));
+            auto falseValue = function.CastBoolToByte(function.Literal(false));
+            function.For(static_cast<int>(_forest.NumEdges()), [pEdgeIndicator, falseValue](emitters::IRFunctionEmitter& function, emitters::LLVMValue edgeIndex) {
+                function.SetValueAt(pEdgeIndicator, edgeIndex, falseValue);
+            });
+
+            // a path that is shorter than its tree's depth reaches the sink, which leads back to itself with a zero edge value;
+            // the sink's edges aren't in the edge indicator vector, so they are marked here instead
+            emitters::LLVMValue sinkEdgeIndicator = function.Variable(trueValue->getType(), "sinkEdgeIndicator");
+
+            // walk each tree with a fixed number of unrolled steps, so that there is no branch on the input values
+            for (size_t groupBegin = 0; groupBegin < treeOrder.size();)
+            {
+                auto depth = treeDepths[treeOrder[groupBegin]];
+                auto groupEnd = groupBegin;
+                while (groupEnd < treeOrder.size() && treeDepths[treeOrder[groupEnd]] == depth)
+                {
+                    ++groupEnd;
+                }
+
+                function.For(static_cast<int>(groupBegin), static_cast<int>(groupEnd), [=](emitters::IRFunctionEmitter& function, emitters::LLVMValue position) {
+                    auto treeIndex = function.ValueAt(treeIndices, position);
+                    auto node = function.LocalScalar(function.ValueAt(rootIndices, treeIndex));
+                    auto treeOutput = function.LocalScalar(0.0);
+                    for (size_t step = 0; step < depth; ++step)
+                    {
+                        auto inputValue = function.ValueAt(pInput, function.ValueAt(featureIndices, node));
+                        auto isAboveThreshold = function.Comparison(emitters::TypedComparison::greaterThanFloat, inputValue, function.ValueAt(thresholds, node));
+                        auto edge = node * 2 + function.LocalScalar(function.Select(isAboveThreshold, function.Literal(1), function.Literal(0)));
+
+                        auto edgeIndicator = function.Select(node == sinkIndex, sinkEdgeIndicator, function.PointerOffset(pEdgeIndicator, edge));
+                        function.Store(edgeIndicator, trueValue);
+                        treeOutput = treeOutput + function.ValueAt(edgeValues, edge);
+                        node = function.LocalScalar(function.ValueAt(children, edge));
+                    }
+                    function.SetValueAt(pTreeOutputs, treeIndex, treeOutput);
+                });
+                groupBegin = groupEnd;
+            }
+
+            // add up the tree outputs in their original order, as FlattenedForest::Predict does
+            emitters::LLVMValue forestOutputVar = function.Variable(emitters::VariableType::Double, "forestOutput");
+            function.Store(forestOutputVar, function.Literal(flattenedForest->GetBias()));
+            function.For(static_cast<int>(_forest.NumTrees()), [pTreeOutputs, forestOutputVar](emitters::IRFunctionEmitter& function, emitters::LLVMValue treeIndex) {
+                function.Store(forestOutputVar, function.LocalScalar(function.Load(forestOutputVar)) + function.ValueAt(pTreeOutputs, treeIndex));
+            });
+            function.SetValueAt(pOutput, function.Literal(0), function.Load(forestOutputVar));
+        }
+        else
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "only forests that can be flattened are compiled directly; other forests are refined");
+        }
+    }
+
     template <typename SplitRuleType, typename EdgePredictorType>
     void ForestPredictorNode<SplitRuleType, EdgePredictorType>::Compute() const
     {
+        if constexpr (predictors::IsFlattenableForest<SplitRuleType, EdgePredictorType>)
+        {
+            // compute all three outputs in a single pass over the flattened forest
+            auto flattenedForest = _forest.GetFlattenedForest();
+            const auto& inputValues = _input.GetValue();
+            if (inputValues.size() >= flattenedForest->GetInputSize())
+            {
+                std::vector<double> treeOutputs;
+                std::vector<bool> edgeIndicator;
+                auto output = flattenedForest->Predict(inputValues.data(), treeOutputs, edgeIndicator);
+                _output.SetOutput({ output });
+                _treeOutputs.SetOutput(std::move(treeOutputs));
+                _edgeIndicatorVector.SetOutput(std::move(edgeIndicator));
+                return;
+            }
+        }
+
         // forest output
         auto inputDataVector = typename ForestPredictor::DataVectorType(_input.GetValue());
         _output.SetOutput({ _forest.Predict(inputDataVector) });
@@ -227,6 +227,7 @@ namespace nodes
 
         void ForLoopGEMM(const value::Matrix matA, const value::Matrix matB, value::Matrix matC);
         void Gemm(const value::Matrix mat, const value::Matrix matB, value::Matrix matC);
+        void PackedGemm(const value::Matrix matA, const value::Matrix matB, value::Matrix matC);
         void GemmFn(const value::Matrix mat, const value::Matrix matB, value::Matrix matC, int thread_num = 0);
         void ParallelizeGemmCol(const value::Matrix matA, const value::Matrix matB, value::Matrix matC, int numThreads = 2);
         void ParallelizeGemmRow(const value::Matrix matA, const value::Matrix matB, value::Matrix matC, int numThreads = 2);
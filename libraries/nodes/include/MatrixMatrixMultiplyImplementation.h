@@ -16,6 +16,7 @@ namespace nodes
     {
         SimpleForLoops = 0,
         Mlas_Loopnest_Value,
+        Packed_Loopnest_Value,
         LAST,
         DEFAULT = Mlas_Loopnest_Value
     };
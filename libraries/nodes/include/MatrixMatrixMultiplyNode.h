@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "BiasActivationNode.h"
+
 #include <emitters/include/IRFunctionEmitter.h>
 
 #include <model/include/CompilableNode.h>
@@ -82,6 +84,16 @@ namespace nodes
         /// <param name="transposeOutput"> If true, transpose the output matrix. </param>
         MatrixMatrixMultiplyNode(const model::OutputPort<ValueType>& input1, int m, int n, int k, int matrix1Stride, bool transpose1, const model::OutputPort<ValueType>& input2, int matrix2Stride, bool transpose2, int outputMatrixStride, bool transposeOutput);
 
+        /// <summary> Constructor for a product that applies a bias and activation to its output as it's written. </summary>
+        ///
+        /// <param name="input1"> The left-hand input of the matrix multiplication, a row-major matrix of size m x k.  </param>
+        /// <param name="input2"> The right-hand input of the matrix multiplication, a row-major matrix of size k x n. </param>
+        /// <param name="transpose1"> If true, transpose the left-hand input matrix. </param>
+        /// <param name="transpose2"> If true, transpose the right-hand input matrix. </param>
+        /// <param name="transposeOutput"> If true, transpose the output matrix. </param>
+        /// <param name="epilogue"> The bias and activation to apply to the product, whose rows (or columns, if transposed) must be contiguous. </param>
+        MatrixMatrixMultiplyNode(const model::OutputPort<ValueType>& input1, int m, int n, int k, int matrix1Stride, bool transpose1, const model::OutputPort<ValueType>& input2, int matrix2Stride, bool transpose2, int outputMatrixStride, bool transposeOutput, const BiasActivationEpilogue<ValueType>& epilogue);
+
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
         /// <returns> The name of this type. </returns>
@@ -92,6 +104,9 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Gets the bias and activation applied to the product. </summary>
+        const BiasActivationEpilogue<ValueType>& GetEpilogue() const { return _epilogue; }
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
@@ -99,7 +114,7 @@ namespace nodes
         bool CanReadArchiveVersion(const utilities::ArchiveVersion& version) const override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
-        bool HasState() const override { return true; } // stored state:  m, n, k, lda, ldb, ldc, transpose
+        bool HasState() const override { return true; } // stored state:  m, n, k, lda, ldb, ldc, transpose, epilogue
 
     private:
         void Copy(model::ModelTransformer& transformer) const override;
@@ -116,6 +131,8 @@ namespace nodes
         int _m = 0, _n = 0, _k = 0;
         int _lda = 0, _ldb = 0, _ldc = 0;
         bool _transpose1 = false, _transpose2 = false, _transposeOutput = false;
+
+        BiasActivationEpilogue<ValueType> _epilogue;
     };
 
     /// <summary> Convenience function for adding a node to a model. </summary>
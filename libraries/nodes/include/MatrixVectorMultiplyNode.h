@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "BiasActivationNode.h"
+
 #include <model/include/CompilableNode.h>
 #include <model/include/IRMapCompiler.h>
 #include <model/include/InputPort.h>
@@ -55,6 +57,16 @@ namespace nodes
         /// <param name="inputVector"> The right-hand input of the matrix multiplication. </param>
         MatrixVectorMultiplyNode(const model::OutputPort<ValueType>& inputMatrix, size_t m, size_t n, size_t matrixStride, const model::OutputPort<ValueType>& inputVector);
 
+        /// <summary> Constructor for a product that applies a bias and activation to its output as it's written. </summary>
+        ///
+        /// <param name="inputMatrix"> The left-hand input of the matrix multiplication. </param>
+        /// <param name="m"> The number of rows in the matrix. </param>
+        /// <param name="n"> The number of columns in the matrix. </param>
+        /// <param name="matrixStride"> The stride of the matrix (the number of elements between adjacent rows). </param>
+        /// <param name="inputVector"> The right-hand input of the matrix multiplication. </param>
+        /// <param name="epilogue"> The bias and activation to apply to the product. </param>
+        MatrixVectorMultiplyNode(const model::OutputPort<ValueType>& inputMatrix, size_t m, size_t n, size_t matrixStride, const model::OutputPort<ValueType>& inputVector, const BiasActivationEpilogue<ValueType>& epilogue);
+
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
         /// <returns> The name of this type. </returns>
@@ -65,12 +77,23 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Gets the bias and activation applied to the product. </summary>
+        const BiasActivationEpilogue<ValueType>& GetEpilogue() const { return _epilogue; }
+
+        /// <summary> Multiplies the samples' vectors by the matrix with a single matrix-matrix product, if all the samples share the matrix. </summary>
+        ///
+        /// <param name="transformer"> The transformer to add the new nodes with. </param>
+        /// <param name="sampleInputs"> For each sample, the new ports that the matrix and vector inputs read from. </param>
+        /// <param name="sampleOutputs"> [out] For each sample, the new port that holds its product. </param>
+        /// <returns> If the samples share the matrix and a batched product was added, true, else false </returns>
+        bool TryCopyBatched(model::ModelTransformer& transformer, const std::vector<std::vector<const model::OutputPortBase*>>& sampleInputs, std::vector<std::vector<const model::OutputPortBase*>>& sampleOutputs) const override;
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
-        bool HasState() const override { return true; } // stored state: m, n, lda, incx
+        bool HasState() const override { return true; } // stored state: m, n, lda, incx, epilogue
 
     private:
         void Copy(model::ModelTransformer& transformer) const override;
@@ -86,6 +109,8 @@ namespace nodes
         // Matrix is MxN, vector is of length N
         size_t _m, _n;
         size_t _lda, _incx;
+
+        BiasActivationEpilogue<ValueType> _epilogue;
     };
 
     /// <summary> Convenience function for adding a node to a model. </summary>
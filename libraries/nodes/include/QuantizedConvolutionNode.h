@@ -0,0 +1,179 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizedConvolutionNode.h (nodes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/CompilableNode.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputPort.h>
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+#include <model/include/PortMemoryLayout.h>
+
+#include <emitters/include/IRFunctionEmitter.h>
+
+#include <utilities/include/IArchivable.h>
+#include <utilities/include/TypeName.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary> The int8 weights of a quantized layer, and the per-filter operations that turn its int32 sums into outputs. </summary>
+    template <typename ValueType>
+    struct QuantizedWeights
+    {
+        /// <summary> The weights of each filter, in (row, column, channel) order over its receptive field. </summary>
+        std::vector<int8_t> weights;
+
+        /// <summary> The scale that maps the quantized input back to input values. </summary>
+        ValueType inputScale = 1;
+
+        /// <summary> The scale applied to the int32 sum of each filter, which folds in the input scale and the filter's scale. </summary>
+        std::vector<ValueType> outputScales;
+
+        /// <summary> The bias added to each filter's scaled sum. </summary>
+        std::vector<ValueType> bias;
+
+        /// <summary> The slope applied to negative outputs: 1 for no activation, 0 for ReLU, and the leak for a leaky ReLU. </summary>
+        ValueType negativeSlope = 1;
+
+        /// <summary> The scale that maps int8 outputs back to output values. Only used if the node outputs int8 values. </summary>
+        ValueType outputQuantizationScale = 1;
+    };
+
+    /// <summary>
+    /// A node that computes a convolution with int8 weights and int32 accumulation, by unrolling the receptive field of
+    /// each output position into a column of int8 values and multiplying it by the weights matrix. The input is
+    /// either int8 values that are already quantized with `inputScale`, or real values that the node quantizes. Each
+    /// filter's sum is scaled back to real values, biased, and passed through a (leaky) ReLU:
+    ///
+    ///     value[f] = Activation(outputScales[f] * sum_j(weights[f][j] * quantizedInput[j]) + bias[f])
+    ///
+    /// and written either as a real value, or requantized to int8 with `outputQuantizationScale` so that the next
+    /// quantized node can read it directly. A fully connected layer is a convolution with a single position, whose
+    /// receptive field is its whole input; its outputs fill the output's active area in (row, column, channel) order.
+    /// Padding in the input is read as zero, and padding in the output is left as zero.
+    /// </summary>
+    template <typename ValueType, typename InputValueType, typename OutputValueType>
+    class QuantizedConvolutionNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<InputValueType>& input = _input;
+        const model::OutputPort<OutputValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        QuantizedConvolutionNode();
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="input"> The input image, in (row, column, channel) coordinates. </param>
+        /// <param name="inputMemoryLayout"> The memory layout of the input. </param>
+        /// <param name="outputMemoryLayout"> The memory layout of the output, whose active area is (rows, columns, filters), or holds the filters of a single position. </param>
+        /// <param name="filterRows"> The number of rows in the receptive field. </param>
+        /// <param name="filterColumns"> The number of columns in the receptive field. </param>
+        /// <param name="stride"> The distance between the receptive fields of neighboring output positions. </param>
+        /// <param name="padding"> The number of rows and columns of input padding that the receptive field of the first position starts in. </param>
+        /// <param name="weights"> The quantized weights. </param>
+        QuantizedConvolutionNode(const model::OutputPort<InputValueType>& input,
+                                 const model::PortMemoryLayout& inputMemoryLayout,
+                                 const model::PortMemoryLayout& outputMemoryLayout,
+                                 int filterRows,
+                                 int filterColumns,
+                                 int stride,
+                                 int padding,
+                                 const QuantizedWeights<ValueType>& weights);
+
+        /// <summary> Gets the quantized weights. </summary>
+        ///
+        /// <returns> The quantized weights. </returns>
+        const QuantizedWeights<ValueType>& GetWeights() const { return _weights; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType, InputValueType, OutputValueType>("QuantizedConvolutionNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: layouts, filter shape, weights, scales
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+        void Initialize();
+
+        int NumFilters() const { return static_cast<int>(_weights.outputScales.size()); }
+        int GetFieldSize() const { return static_cast<int>(_fieldOffsets.size()); }
+        int GetInputOrigin() const;
+
+        // Input
+        model::InputPort<InputValueType> _input;
+
+        // Output
+        model::OutputPort<OutputValueType> _output;
+
+        model::PortMemoryLayout _inputMemoryLayout;
+        int _filterRows = 0;
+        int _filterColumns = 0;
+        int _stride = 1;
+        int _padding = 0;
+        QuantizedWeights<ValueType> _weights;
+
+        // Derived from the above: the output positions, the input offset of each receptive field entry
+        // from the field's first entry, and the output offset of each filter from the position's first entry
+        int _outputRows = 0;
+        int _outputColumns = 0;
+        std::vector<int> _fieldOffsets;
+        std::vector<int> _filterOutputOffsets;
+    };
+
+    /// <summary> Rounds a value to the nearest integer in [-127, 127], the symmetric range used by quantized nodes. Halves round up. </summary>
+    ///
+    /// <param name="value"> The value, in units of the quantization scale. </param>
+    ///
+    /// <returns> The quantized value. </returns>
+    template <typename ValueType>
+    int8_t QuantizeToInt8(ValueType value);
+} // namespace nodes
+} // namespace ell
+
+#pragma region implementation
+
+#include <algorithm>
+
+namespace ell
+{
+namespace nodes
+{
+    template <typename ValueType>
+    int8_t QuantizeToInt8(ValueType value)
+    {
+        // shift the clamped value so that truncation rounds it, matching the compiled code
+        auto clamped = std::min(std::max(value, static_cast<ValueType>(-127)), static_cast<ValueType>(127));
+        return static_cast<int8_t>(static_cast<int>(clamped + static_cast<ValueType>(127.5)) - 127);
+    }
+} // namespace nodes
+} // namespace ell
+
+#pragma endregion implementation
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "BiasActivationNode.h"
+
 #include <math/include/Tensor.h>
 
 #include <model/include/IRMapCompiler.h>
@@ -47,11 +49,13 @@ namespace nodes
         /// <param name="inputMemoryLayout"> The layout of the input data. </param>
         /// <param name="filterWeights"> The weights for the convolutional filters. </param>
         /// <param name="outputMemoryLayout"> The layout of the output data. </param>
+        /// <param name="epilogue"> The bias and activation to apply to the output as it's written. Depthwise-separable convolutions can't have one. </param>
         UnrolledConvolutionNode(const model::OutputPort<ValueType>& input,
                                 const model::PortMemoryLayout& inputMemoryLayout,
                                 const model::PortMemoryLayout& outputMemoryLayout,
                                 const ConstTensorReferenceType& filterWeights,
-                                int stride);
+                                int stride,
+                                const BiasActivationEpilogue<ValueType>& epilogue = {});
 
         /// <summary> Constructor. </summary>
         ///
@@ -59,12 +63,14 @@ namespace nodes
         /// <param name="inputMemoryLayout"> The layout of the input data. </param>
         /// <param name="filterWeights"> The weights for the convolutional filters, expressed as a matrix. </param>
         /// <param name="outputMemoryLayout"> The layout of the output data. </param>
+        /// <param name="epilogue"> The bias and activation to apply to the output as it's written. Depthwise-separable convolutions can't have one. </param>
         UnrolledConvolutionNode(const model::OutputPort<ValueType>& input,
                                 const model::PortMemoryLayout& inputMemoryLayout,
                                 const model::PortMemoryLayout& outputMemoryLayout,
                                 ConstMatrixReferenceType filterWeights,
                                 int filterSize,
-                                int stride);
+                                int stride,
+                                const BiasActivationEpilogue<ValueType>& epilogue = {});
 
         /// <summary> Gets information about the input memory layout </summary>
         const model::PortMemoryLayout& GetInputMemoryLayout() const { return _inputMemoryLayout; }
@@ -72,6 +78,9 @@ namespace nodes
         /// <summary> Gets information about the input memory layout </summary>
         model::PortMemoryLayout GetOutputMemoryLayout() const { return _output.GetMemoryLayout(); }
 
+        /// <summary> Gets the bias and activation applied to the output. </summary>
+        const BiasActivationEpilogue<ValueType>& GetEpilogue() const { return _epilogue; }
+
         /// <summary> Returns true if the node can accept input with this memory layout order, else false </summary>
         ///
         /// <param name="order"> The memory layout order for all the input ports </summary>
@@ -107,6 +116,8 @@ namespace nodes
 
         MatrixType GetWeightsMatrix(const ConstTensorReferenceType& weightsTensor) const;
         bool IsELLCodeTarget(model::ModelTransformer& transformer) const;
+        bool UsePackedGemm(model::ModelTransformer& transformer) const;
+        void CheckEpilogue() const;
 
         // Input
         model::InputPort<ValueType> _input;
@@ -121,6 +132,8 @@ namespace nodes
         int _filterSize = 0;
         int _stride = 1;
         bool _isDepthwiseSeparable = false;
+
+        BiasActivationEpilogue<ValueType> _epilogue;
     };
 
     /// <summary> Convenience function for adding a node to a model. </summary>
@@ -0,0 +1,181 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BiasActivationNode.cpp (nodes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BiasActivationNode.h"
+#include "ConstantNode.h"
+
+#include <emitters/include/IRModuleEmitter.h>
+
+#include <predictors/neural/include/HardSigmoidActivation.h>
+#include <predictors/neural/include/HardTanhActivation.h>
+#include <predictors/neural/include/LeakyReLUActivation.h>
+#include <predictors/neural/include/ReLUActivation.h>
+#include <predictors/neural/include/SigmoidActivation.h>
+#include <predictors/neural/include/TanhActivation.h>
+
+#include <utilities/include/Exception.h>
+
+namespace ell
+{
+namespace nodes
+{
+    namespace
+    {
+        // the logical dimension that per-channel biases are broadcast along
+        constexpr size_t channelDimension = 2;
+    } // namespace
+
+    //
+    // BiasActivationEpilogue
+    //
+    template <typename ValueType>
+    BiasActivationEpilogue<ValueType>::BiasActivationEpilogue(const std::vector<ValueType>& bias, const predictors::neural::ActivationImpl<ValueType>* activation) :
+        _bias(bias)
+    {
+        if (activation != nullptr)
+        {
+            auto impl = activation->Copy();
+            _activation = predictors::neural::Activation<ValueType>(impl);
+        }
+    }
+
+    template <typename ValueType>
+    void BiasActivationEpilogue<ValueType>::Compute(std::vector<ValueType>& values) const
+    {
+        const auto numChannels = _bias.size();
+        for (size_t index = 0; index < values.size(); ++index)
+        {
+            auto value = values[index];
+            if (numChannels > 0)
+            {
+                value += _bias[index % numChannels];
+            }
+            if (_activation)
+            {
+                value = _activation->Apply(value);
+            }
+            values[index] = value;
+        }
+    }
+
+    template <typename ValueType>
+    void BiasActivationEpilogue<ValueType>::Compile(model::IRMapCompiler& compiler, const model::Node& node, emitters::IRFunctionEmitter& function, emitters::LLVMValue values, int size) const
+    {
+        if (IsEmpty())
+        {
+            return;
+        }
+
+        auto activation = _activation ? predictors::neural::GetNodeActivationFunction(*_activation) : nullptr;
+        if (_bias.empty())
+        {
+            function.For(size, [&activation, values](emitters::IRFunctionEmitter& function, auto index) {
+                function.SetValueAt(values, index, activation->Compile(function, function.ValueAt(values, index)));
+            });
+            return;
+        }
+
+        // the channels are the innermost dimension, so the bias index is the channel loop's index
+        auto& module = function.GetModule();
+        auto bias = module.ConstantArray(compiler.GetGlobalName(node, "epilogueBias"), _bias);
+        const auto numChannels = static_cast<int>(_bias.size());
+        function.For(size / numChannels, [&activation, bias, values, numChannels](emitters::IRFunctionEmitter& function, auto pixel) {
+            auto offset = pixel * function.LocalScalar(numChannels);
+            function.For(numChannels, [&activation, bias, values, offset](emitters::IRFunctionEmitter& function, auto channel) {
+                auto index = offset + channel;
+                auto value = function.Operator(emitters::GetAddForValueType<ValueType>(), function.ValueAt(values, index), function.ValueAt(bias, channel));
+                if (activation)
+                {
+                    value = activation->Compile(function, value);
+                }
+                function.SetValueAt(values, index, value);
+            });
+        });
+    }
+
+    template <typename ValueType>
+    void BiasActivationEpilogue<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        archiver["epilogueBias"] << _bias;
+        archiver["hasEpilogueActivation"] << _activation.has_value();
+        if (_activation)
+        {
+            archiver["epilogueActivation"] << *_activation;
+        }
+    }
+
+    template <typename ValueType>
+    void BiasActivationEpilogue<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        _bias.clear();
+        _activation.reset();
+        archiver.OptionalProperty("epilogueBias") >> _bias;
+        bool hasActivation = false;
+        archiver.OptionalProperty("hasEpilogueActivation", false) >> hasActivation;
+        if (hasActivation)
+        {
+            predictors::neural::Activation<ValueType> activation;
+            archiver["epilogueActivation"] >> activation;
+            _activation = activation;
+        }
+    }
+
+    //
+    // AddBiasActivationNode
+    //
+    template <typename ValueType>
+    const model::OutputPort<ValueType>& AddBiasActivationNode(model::ModelTransformer& transformer,
+                                                              const model::OutputPort<ValueType>& input,
+                                                              const model::PortMemoryLayout& inputLayout,
+                                                              const model::PortMemoryLayout& outputLayout,
+                                                              const std::vector<ValueType>& bias,
+                                                              const predictors::neural::ActivationImpl<ValueType>* activation)
+    {
+        using namespace predictors::neural;
+
+        const auto numChannels = static_cast<size_t>(inputLayout.GetActiveSize(channelDimension));
+        const auto& biasValues = Constant(transformer, bias.empty() ? std::vector<ValueType>(numChannels) : bias);
+        if (activation == nullptr)
+        {
+            const auto& noScale = Constant(transformer, std::vector<ValueType>{});
+            return transformer.AddNode<BroadcastLinearFunctionNode<ValueType>>(input, inputLayout, noScale, biasValues, channelDimension, outputLayout)->output;
+        }
+        if (dynamic_cast<const ReLUActivation<ValueType>*>(activation))
+        {
+            return transformer.AddNode<BiasActivationNode<ValueType, ReLUActivationFunction<ValueType>>>(input, inputLayout, biasValues, outputLayout, ReLUActivationFunction<ValueType>{})->output;
+        }
+        if (auto leakyReLU = dynamic_cast<const LeakyReLUActivation<ValueType>*>(activation))
+        {
+            return transformer.AddNode<BiasActivationNode<ValueType, LeakyReLUActivationFunction<ValueType>>>(input, inputLayout, biasValues, outputLayout, LeakyReLUActivationFunction<ValueType>(leakyReLU->GetLeakyFactor()))->output;
+        }
+        if (dynamic_cast<const SigmoidActivation<ValueType>*>(activation))
+        {
+            return transformer.AddNode<BiasActivationNode<ValueType, SigmoidActivationFunction<ValueType>>>(input, inputLayout, biasValues, outputLayout, SigmoidActivationFunction<ValueType>{})->output;
+        }
+        if (dynamic_cast<const HardSigmoidActivation<ValueType>*>(activation))
+        {
+            return transformer.AddNode<BiasActivationNode<ValueType, HardSigmoidActivationFunction<ValueType>>>(input, inputLayout, biasValues, outputLayout, HardSigmoidActivationFunction<ValueType>{})->output;
+        }
+        if (dynamic_cast<const TanhActivation<ValueType>*>(activation))
+        {
+            return transformer.AddNode<BiasActivationNode<ValueType, TanhActivationFunction<ValueType>>>(input, inputLayout, biasValues, outputLayout, TanhActivationFunction<ValueType>{})->output;
+        }
+        if (dynamic_cast<const HardTanhActivation<ValueType>*>(activation))
+        {
+            return transformer.AddNode<BiasActivationNode<ValueType, HardTanhActivationFunction<ValueType>>>(input, inputLayout, biasValues, outputLayout, HardTanhActivationFunction<ValueType>{})->output;
+        }
+        throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Unexpected activation function for BiasActivationNode");
+    }
+
+    // Explicit instantiations
+    template class BiasActivationEpilogue<float>;
+    template class BiasActivationEpilogue<double>;
+
+    template const model::OutputPort<float>& AddBiasActivationNode(model::ModelTransformer& transformer, const model::OutputPort<float>& input, const model::PortMemoryLayout& inputLayout, const model::PortMemoryLayout& outputLayout, const std::vector<float>& bias, const predictors::neural::ActivationImpl<float>* activation);
+    template const model::OutputPort<double>& AddBiasActivationNode(model::ModelTransformer& transformer, const model::OutputPort<double>& input, const model::PortMemoryLayout& inputLayout, const model::PortMemoryLayout& outputLayout, const std::vector<double>& bias, const predictors::neural::ActivationImpl<double>* activation);
+} // namespace nodes
+} // namespace ell
@@ -14,6 +14,8 @@
 #include "UnrolledConvolutionNode.h"
 #include "WinogradConvolutionNode.h"
 
+#include <model/include/ModelOptimizerOptions.h>
+
 using namespace ell::math;
 using namespace ell::math::Blas;
 
@@ -21,12 +23,51 @@ namespace ell
 {
 namespace nodes
 {
+    namespace
+    {
+        // the Winograd tile size can be chosen per node, e.g. by autotuning, through its "compileOptions" metadata
+        int GetWinogradTileSize(const utilities::PropertyBag& metadata)
+        {
+            const int defaultTileSize = 2;
+            if (!metadata.HasEntry("compileOptions"))
+            {
+                return defaultTileSize;
+            }
+            model::ModelOptimizerOptions options(metadata.GetEntry<utilities::PropertyBag>("compileOptions"));
+            return options.GetEntry<int>("winogradTileSize", defaultTileSize);
+        }
+    } // namespace
+
     template <typename ValueType>
     ConvolutionalLayerNode<ValueType>::ConvolutionalLayerNode(const model::OutputPort<ValueType>& input, const predictors::neural::ConvolutionalLayer<ValueType>& layer) :
         NeuralNetworkLayerNode<ConvolutionalLayerNode<ValueType>, predictors::neural::ConvolutionalLayer<ValueType>, ValueType>(input, layer)
     {
     }
 
+    template <typename ValueType>
+    ConvolutionalLayerNode<ValueType>::ConvolutionalLayerNode(const model::OutputPort<ValueType>& input, const predictors::neural::ConvolutionalLayer<ValueType>& layer, const BiasActivationEpilogue<ValueType>& epilogue) :
+        ConvolutionalLayerNode(input, layer)
+    {
+        // the epilogue finds the channel of each output value by its index
+        if (!epilogue.IsEmpty() && this->GetOutputMemoryLayout().HasPadding())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "A convolutional layer with a bias and activation epilogue must not have a padded output");
+        }
+        _epilogue = epilogue;
+    }
+
+    template <typename ValueType>
+    void ConvolutionalLayerNode<ValueType>::Compute() const
+    {
+        BaseType::Compute();
+        if (!_epilogue.IsEmpty())
+        {
+            auto values = this->_output.GetOutput();
+            _epilogue.Compute(values);
+            this->_output.SetOutput(values);
+        }
+    }
+
     template <typename ValueType>
     bool ConvolutionalLayerNode<ValueType>::Refine(model::ModelTransformer& transformer) const
     {
@@ -53,6 +94,7 @@ namespace nodes
         newInput = &preConvReorder;
 
         const model::OutputPort<ValueType>* convOutput;
+        bool hasAppliedEpilogue = false;
 
         switch (convParams.method)
         {
@@ -72,8 +114,10 @@ namespace nodes
         break;
         case ConvolutionMethod::unrolled:
         {
-            auto convNode = transformer.AddNode<UnrolledConvolutionNode<ValueType>>(*newInput, convInputLayout, convOutputLayout, weights, convParams.stride);
+            // the GEMM of a (non-depthwise) unrolled convolution applies the epilogue itself
+            auto convNode = transformer.AddNode<UnrolledConvolutionNode<ValueType>>(*newInput, convInputLayout, convOutputLayout, weights, convParams.stride, isDepthwiseSeparable ? BiasActivationEpilogue<ValueType>{} : _epilogue);
             convOutput = &convNode->output;
+            hasAppliedEpilogue = !isDepthwiseSeparable;
         }
         break;
         case ConvolutionMethod::diagonal:
@@ -84,7 +128,7 @@ namespace nodes
         break;
         case ConvolutionMethod::winograd:
         {
-            auto convNode = transformer.AddNode<WinogradConvolutionNode<ValueType>>(*newInput, convInputLayout, convOutputLayout, weights, convParams.stride);
+            auto convNode = transformer.AddNode<WinogradConvolutionNode<ValueType>>(*newInput, convInputLayout, convOutputLayout, weights, convParams.stride, GetWinogradTileSize(this->GetMetadata()));
             convOutput = &convNode->output;
         }
         break;
@@ -96,7 +140,16 @@ namespace nodes
         const_cast<model::Node*>(convOutput->GetNode())->GetMetadata() = this->GetMetadata();
 
         const auto& postConvReorder = ReorderDataWithCodeNode(*convOutput, originalOutputLayout);
-        transformer.MapNodeOutput(this->output, postConvReorder);
+        if (_epilogue.IsEmpty() || hasAppliedEpilogue)
+        {
+            transformer.MapNodeOutput(this->output, postConvReorder);
+        }
+        else
+        {
+            // the other convolution nodes can't apply the epilogue, so it gets a node of its own
+            const auto& epilogueOutput = AddBiasActivationNode(transformer, postConvReorder, originalOutputLayout, originalOutputLayout, _epilogue.GetBias(), _epilogue.GetActivation());
+            transformer.MapNodeOutput(this->output, epilogueOutput);
+        }
 
         return true;
     }
@@ -105,10 +158,24 @@ namespace nodes
     void ConvolutionalLayerNode<ValueType>::Copy(model::ModelTransformer& transformer) const
     {
         const auto& newInputs = transformer.GetCorrespondingInputs(this->_input);
-        auto newNode = transformer.AddNode<ConvolutionalLayerNode<ValueType>>(newInputs, this->_layer);
+        auto newNode = transformer.AddNode<ConvolutionalLayerNode<ValueType>>(newInputs, this->_layer, _epilogue);
         transformer.MapNodeOutput(this->_output, newNode->output);
     }
 
+    template <typename ValueType>
+    void ConvolutionalLayerNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        BaseType::WriteToArchive(archiver);
+        _epilogue.WriteToArchive(archiver);
+    }
+
+    template <typename ValueType>
+    void ConvolutionalLayerNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        BaseType::ReadFromArchive(archiver);
+        _epilogue.ReadFromArchive(archiver);
+    }
+
     // Explicit specializations
     template class ConvolutionalLayerNode<float>;
     template class ConvolutionalLayerNode<double>;
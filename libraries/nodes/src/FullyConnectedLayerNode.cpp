@@ -33,6 +33,25 @@ namespace nodes
         }
     }
 
+    template <typename ValueType>
+    FullyConnectedLayerNode<ValueType>::FullyConnectedLayerNode(const model::OutputPort<ValueType>& input, const predictors::neural::FullyConnectedLayer<ValueType>& layer, const BiasActivationEpilogue<ValueType>& epilogue) :
+        FullyConnectedLayerNode(input, layer)
+    {
+        _epilogue = epilogue;
+    }
+
+    template <typename ValueType>
+    void FullyConnectedLayerNode<ValueType>::Compute() const
+    {
+        BaseType::Compute();
+        if (!_epilogue.IsEmpty())
+        {
+            auto values = this->_output.GetOutput();
+            _epilogue.Compute(values);
+            this->_output.SetOutput(values);
+        }
+    }
+
     template <typename ValueType>
     bool FullyConnectedLayerNode<ValueType>::Refine(model::ModelTransformer& transformer) const
     {
@@ -64,7 +83,7 @@ namespace nodes
         auto lda = weights.GetIncrement();
         auto weightsValues = weights.ToArray();
         const auto& weightsOut = Constant(transformer, weightsValues);
-        const auto& result = MatrixVectorMultiply(weightsOut, m, n, lda, newInput);
+        const auto& result = transformer.AddNode<MatrixVectorMultiplyNode<ValueType>>(weightsOut, m, n, lda, newInput, _epilogue)->output;
 
         // TODO: add a reorder node here that adds padding to the output, if necessary
 
@@ -76,10 +95,24 @@ namespace nodes
     void FullyConnectedLayerNode<ValueType>::Copy(model::ModelTransformer& transformer) const
     {
         const auto& newInputs = transformer.GetCorrespondingInputs(this->_input);
-        auto newNode = transformer.AddNode<FullyConnectedLayerNode<ValueType>>(newInputs, this->_layer);
+        auto newNode = transformer.AddNode<FullyConnectedLayerNode<ValueType>>(newInputs, this->_layer, _epilogue);
         transformer.MapNodeOutput(this->_output, newNode->output);
     }
 
+    template <typename ValueType>
+    void FullyConnectedLayerNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        BaseType::WriteToArchive(archiver);
+        _epilogue.WriteToArchive(archiver);
+    }
+
+    template <typename ValueType>
+    void FullyConnectedLayerNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        BaseType::ReadFromArchive(archiver);
+        _epilogue.ReadFromArchive(archiver);
+    }
+
     // Explicit specialization
     template class FullyConnectedLayerNode<float>;
     template class FullyConnectedLayerNode<double>;
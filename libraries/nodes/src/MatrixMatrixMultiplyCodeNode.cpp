@@ -27,6 +27,10 @@
 #include <value/include/CachingStrategies.h>
 #include <value/include/LLVMContext.h>
 #include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include <algorithm>
+#include <memory>
 
 //using namespace ell::utilities;
 using namespace ell::value;
@@ -221,6 +225,12 @@ namespace nodes
     {
         using namespace value;
 
+        if (_impl == MatrixMatrixMultiplyImplementation::Packed_Loopnest_Value)
+        {
+            PackedGemm(A, B, C);
+            return;
+        }
+
         int vectorSize = 4;
         int NumRowsInKernel = 2;
 
@@ -308,6 +318,118 @@ namespace nodes
         nest.Run();
     }
 
+    template <typename ValueType>
+    void MatrixMatrixMultiplyCodeNode<ValueType>::PackedGemm(value::Matrix A, value::Matrix B, value::Matrix C)
+    {
+        using namespace value;
+
+        const int OutputRows = (int)(A.Rows());
+        const int OutputColumns = (int)(B.Columns());
+        const int InnerDimension = (int)(A.Columns());
+        const int elementSize = static_cast<int>(sizeof(ValueType));
+        const int kUnroll = 4;
+
+        // Defaults for targets we can't query: 128-bit vectors, 16 vector registers and typical cache sizes
+        int vectorSize = 16 / elementSize;
+        int numVectorRegisters = 16;
+        size_t l1CacheSize = 32 * 1024;
+        size_t l2CacheSize = 256 * 1024;
+        size_t l3CacheSize = 2 * 1024 * 1024;
+
+        InvokeForContext<LLVMContext>([&](LLVMContext& context) {
+            auto& moduleEmitter = context.GetModuleEmitter();
+            std::unique_ptr<llvm::TargetMachine> targetMachine(moduleEmitter.GetTargetMachine());
+            auto fn = context.GetFunctionEmitter().GetFunction();
+            auto info = targetMachine->getTargetTransformInfo(*fn);
+            vectorSize = std::max(1, static_cast<int>(info.getRegisterBitWidth(true)) / (8 * elementSize));
+            numVectorRegisters = std::max(4, static_cast<int>(info.getNumberOfRegisters(true)));
+
+            // Prefer the sizes the target device was described with, then what LLVM knows about the CPU
+            const auto& targetDevice = moduleEmitter.GetCompilerOptions().targetDevice;
+            l1CacheSize = targetDevice.l1CacheSize ? targetDevice.l1CacheSize : info.getCacheSize(llvm::TargetTransformInfo::CacheLevel::L1D).getValueOr(l1CacheSize);
+            l2CacheSize = targetDevice.l2CacheSize ? targetDevice.l2CacheSize : info.getCacheSize(llvm::TargetTransformInfo::CacheLevel::L2D).getValueOr(l2CacheSize);
+            l3CacheSize = targetDevice.l3CacheSize ? targetDevice.l3CacheSize : std::max(l3CacheSize, l2CacheSize);
+        });
+
+        // The microkernel keeps a NumRowsInKernel x NumColumnsInKernel block of C in vector registers, plus
+        // one row of B and a broadcast element of A, and accumulates into it with (fused) multiply-adds
+        int numColumnVectors = OutputColumns >= 2 * vectorSize ? 2 : 1;
+        int NumColumnsInKernel = numColumnVectors * vectorSize;
+        int NumRowsInKernel = std::clamp((numVectorRegisters - numColumnVectors - 1) / numColumnVectors, 1, 16);
+
+        // Block sizes, as in BLIS: a kc x nr sliver of packed B stays in L1, an mc x kc block of packed A
+        // stays in L2, and a kc x nc panel of packed B stays in L3. Each uses about half the cache.
+        // The B panel is a whole number of slivers, zero-padded past the last column of B if need be
+        auto roundDown = [](int value, int multiple) { return std::max(multiple, (value / multiple) * multiple); };
+        auto roundUp = [](int value, int multiple) { return ((value + multiple - 1) / multiple) * multiple; };
+        int innerDimensionBlock = std::min(roundDown(static_cast<int>(l1CacheSize / 2) / (elementSize * NumColumnsInKernel), kUnroll), InnerDimension);
+        int rowBlock = std::min(roundDown(static_cast<int>(l2CacheSize / 2) / (elementSize * innerDimensionBlock), NumRowsInKernel), OutputRows);
+        int columnBlock = std::min(roundDown(static_cast<int>(l3CacheSize / 2) / (elementSize * innerDimensionBlock), NumColumnsInKernel), roundUp(OutputColumns, NumColumnsInKernel));
+
+        // Declare indexes
+        loopnests::Index i("i"), j("j"), k("k");
+        // Define LoopNest
+        auto nest = Using({ A, B }, ArgumentType::Input)
+                        .Using({ C }, ArgumentType::Output)
+                        .ForAll(i, 0, OutputRows)
+                        .ForAll(j, 0, OutputColumns)
+                        .ForAll(k, 0, InnerDimension)
+                        .Do([](Matrix A_, Matrix B_, Matrix C_, Scalar i_, Scalar j_, Scalar k_) {
+                            C_(i_, j_) += B_(k_, j_) * A_(i_, k_);
+                        });
+        auto& schedule = nest.GetSchedule();
+
+        auto topLevelJ = j;
+        auto topLevelK = k;
+
+        // Declare splits
+        auto jCache = schedule.Split(j, columnBlock);
+        auto kCache = schedule.Split(k, innerDimensionBlock);
+        auto iCache = schedule.Split(i, rowBlock);
+        auto kBlock = schedule.Split(k, kUnroll);
+        auto jKernelOuter2 = schedule.Split(j, NumColumnsInKernel);
+        auto jKernelOuter = schedule.Split(j, vectorSize);
+        auto iKernelOuter = schedule.Split(i, NumRowsInKernel);
+
+        // Set the order
+        schedule.SetOrder({ jCache, kCache, iCache, iKernelOuter, jKernelOuter2, kBlock, k, i, jKernelOuter, j });
+
+        // Pack the panel of B into contiguous slivers of NumColumnsInKernel columns
+        auto extraCacheBParams = std::make_tuple(NumColumnsInKernel, jKernelOuter2, BoundaryConditionHandling::ZeroPadding);
+        schedule.template Cache<BLASTCopy>(B,
+                                           { topLevelK, topLevelJ },
+                                           { innerDimensionBlock, columnBlock },
+                                           { kCache, jCache },
+                                           std::nullopt, // Order isn't used by BLASTCopy
+                                           extraCacheBParams);
+
+        // Pack the block of A into a contiguous row-major tile, unless A is a single block already
+        if (rowBlock < OutputRows || innerDimensionBlock < InnerDimension)
+        {
+            schedule.template Cache<CopyInputNoOutput>(A,
+                                                       { iCache, kCache },
+                                                       { rowBlock, innerDimensionBlock },
+                                                       {},
+                                                       utilities::RowMajorMatrixOrder);
+        }
+
+        auto extraZeroInputReduceOutputParams = std::make_tuple(vectorSize);
+        schedule.template Cache<ZeroInputReduceOutput>(C,
+                                                       { iKernelOuter, jKernelOuter2 },
+                                                       { NumRowsInKernel, NumColumnsInKernel },
+                                                       { iKernelOuter, jKernelOuter2 },
+                                                       utilities::RowMajorMatrixOrder,
+                                                       extraZeroInputReduceOutputParams);
+
+        // Set unrolling
+        schedule.Unroll(jKernelOuter);
+        schedule.Unroll(i);
+        schedule.Unroll(k);
+
+        // Run the generator
+        nest.Run();
+    }
+
     template <typename ValueType>
     void MatrixMatrixMultiplyCodeNode<ValueType>::GemmFn(value::Matrix A, value::Matrix B, value::Matrix C, int thread_num)
     {
@@ -457,6 +579,7 @@ namespace nodes
                 ForLoopGEMM(matA, matB, matC);
                 break;
             case (MatrixMatrixMultiplyImplementation::Mlas_Loopnest_Value):
+            case (MatrixMatrixMultiplyImplementation::Packed_Loopnest_Value):
                 ELLCodeGEMM(matA, matB, matC);
                 break;
             case (MatrixMatrixMultiplyImplementation::LAST):
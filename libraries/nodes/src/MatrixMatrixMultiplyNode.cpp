@@ -200,6 +200,18 @@ namespace nodes
         }
     }
 
+    template <typename ValueType>
+    MatrixMatrixMultiplyNode<ValueType>::MatrixMatrixMultiplyNode(const model::OutputPort<ValueType>& input1, int m, int n, int k, int matrix1Stride, bool transpose1, const model::OutputPort<ValueType>& input2, int matrix2Stride, bool transpose2, int outputMatrixStride, bool transposeOutput, const BiasActivationEpilogue<ValueType>& epilogue) :
+        MatrixMatrixMultiplyNode<ValueType>(input1, m, n, k, matrix1Stride, transpose1, input2, matrix2Stride, transpose2, outputMatrixStride, transposeOutput)
+    {
+        // the epilogue runs over the output as one contiguous array
+        if (!epilogue.IsEmpty() && outputMatrixStride != (transposeOutput ? m : n))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "A product with a bias and activation epilogue must have a contiguous output");
+        }
+        _epilogue = epilogue;
+    }
+
     template <typename ValueType>
     void MatrixMatrixMultiplyNode<ValueType>::Compute() const
     {
@@ -218,6 +230,7 @@ namespace nodes
         math::RowMatrixReference<ValueType> outputMatrixRef(outputMatrixValues.data(), _m, _n);
 
         MatrixMatrixMultiply(_transpose1, _transpose2, _transposeOutput, (int)_m, (int)_n, (int)_k, inputMatrix1Values, inputMatrix2Values, outputMatrixValues);
+        _epilogue.Compute(outputMatrixValues);
 
         _output.SetOutput(outputMatrixValues);
     };
@@ -227,7 +240,7 @@ namespace nodes
     {
         const auto& newInput1 = transformer.GetCorrespondingInputs(_input1);
         const auto& newInput2 = transformer.GetCorrespondingInputs(_input2);
-        auto newNode = transformer.AddNode<MatrixMatrixMultiplyNode<ValueType>>(newInput1, _m, _n, _k, _lda, _transpose1, newInput2, _ldb, _transpose2, _ldc, _transposeOutput);
+        auto newNode = transformer.AddNode<MatrixMatrixMultiplyNode<ValueType>>(newInput1, _m, _n, _k, _lda, _transpose1, newInput2, _ldb, _transpose2, _ldc, _transposeOutput, _epilogue);
         transformer.MapNodeOutput(output, newNode->output);
     }
 
@@ -246,6 +259,9 @@ namespace nodes
         {
             function.CallGEMM<ValueType>(_transpose1, _transpose2, (int)_m, (int)_n, (int)_k, pInput1, (int)_lda, pInput2, (int)_ldb, pOutput, (int)_ldc);
         }
+
+        // the product is still in cache, so apply the bias and activation before anything else reads it
+        _epilogue.Compile(compiler, *this, function, pOutput, _m * _n);
     }
 
     template <typename ValueType>
@@ -276,6 +292,7 @@ namespace nodes
         archiver["transpose1"] << _transpose1;
         archiver["transpose2"] << _transpose2;
         archiver["transposeOutput"] << _transposeOutput;
+        _epilogue.WriteToArchive(archiver);
     }
 
     template <typename ValueType>
@@ -295,6 +312,7 @@ namespace nodes
         archiver["transpose1"] >> _transpose1;
         archiver["transpose2"] >> _transpose2;
         archiver.OptionalProperty("transposeOutput", false) >> _transposeOutput;
+        _epilogue.ReadFromArchive(archiver);
     }
 
     template <typename ValueType>
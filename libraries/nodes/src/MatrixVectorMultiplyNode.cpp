@@ -7,10 +7,16 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "MatrixVectorMultiplyNode.h"
+#include "MatrixMatrixMultiplyNode.h"
+
+#include <model/include/SliceNode.h>
+#include <model/include/SpliceNode.h>
 
 #include <math/include/Matrix.h>
 #include <math/include/MatrixOperations.h>
 
+#include <algorithm>
+
 namespace ell
 {
 namespace nodes
@@ -50,6 +56,13 @@ namespace nodes
         }
     }
 
+    template <typename ValueType>
+    MatrixVectorMultiplyNode<ValueType>::MatrixVectorMultiplyNode(const model::OutputPort<ValueType>& inputMatrix, size_t m, size_t n, size_t matrixStride, const model::OutputPort<ValueType>& inputVector, const BiasActivationEpilogue<ValueType>& epilogue) :
+        MatrixVectorMultiplyNode(inputMatrix, m, n, matrixStride, inputVector)
+    {
+        _epilogue = epilogue;
+    }
+
     template <typename ValueType>
     void MatrixVectorMultiplyNode<ValueType>::Compute() const
     {
@@ -64,6 +77,7 @@ namespace nodes
         math::ColumnVectorReference<ValueType> outputVectorRef(outputVectorValues.data(), _m);
 
         math::MultiplyScaleAddUpdate(static_cast<ValueType>(1.0), inputMatrixRef, inputVectorRef, static_cast<ValueType>(0.0), outputVectorRef);
+        _epilogue.Compute(outputVectorValues);
 
         _output.SetOutput(outputVectorValues);
     };
@@ -73,10 +87,44 @@ namespace nodes
     {
         const auto& matrixElements = transformer.GetCorrespondingInputs(_inputMatrix);
         const auto& vectorElements = transformer.GetCorrespondingInputs(_inputVector);
-        auto newNode = transformer.AddNode<MatrixVectorMultiplyNode<ValueType>>(matrixElements, _m, _n, _lda, vectorElements);
+        auto newNode = transformer.AddNode<MatrixVectorMultiplyNode<ValueType>>(matrixElements, _m, _n, _lda, vectorElements, _epilogue);
         transformer.MapNodeOutput(output, newNode->output);
     }
 
+    template <typename ValueType>
+    bool MatrixVectorMultiplyNode<ValueType>::TryCopyBatched(model::ModelTransformer& transformer, const std::vector<std::vector<const model::OutputPortBase*>>& sampleInputs, std::vector<std::vector<const model::OutputPortBase*>>& sampleOutputs) const
+    {
+        // The input ports are { matrix, vector }
+        const auto batchSize = static_cast<int>(sampleInputs.size());
+        const auto matrix = sampleInputs[0][0];
+        auto isSharedMatrix = std::all_of(sampleInputs.begin(), sampleInputs.end(), [matrix](const auto& inputs) { return inputs[0] == matrix; });
+        auto hasPaddedVector = std::any_of(sampleInputs.begin(), sampleInputs.end(), [](const auto& inputs) { return inputs[1]->GetMemoryLayout().HasPadding(); });
+        if (batchSize < 2 || !isSharedMatrix || hasPaddedVector)
+        {
+            return false;
+        }
+
+        // Stack the samples' vectors into the rows of a batchSize x n matrix X. Then the rows of X * M^T are the samples' products.
+        std::vector<const model::OutputPortBase*> vectors;
+        for (const auto& inputs : sampleInputs)
+        {
+            vectors.push_back(inputs[1]);
+        }
+        const auto& batchVectors = transformer.AddNode<model::SpliceNode<ValueType>>(vectors)->output;
+        const auto& batchMatrix = static_cast<const model::OutputPort<ValueType>&>(*matrix);
+        const auto m = static_cast<int>(_m);
+        const auto n = static_cast<int>(_n);
+        auto productNode = transformer.AddNode<MatrixMatrixMultiplyNode<ValueType>>(batchVectors, batchSize, m, n, n, false, batchMatrix, static_cast<int>(_lda), true, m, false, _epilogue);
+
+        sampleOutputs.clear();
+        for (int sample = 0; sample < batchSize; ++sample)
+        {
+            auto sliceNode = transformer.AddNode<model::SliceNode<ValueType>>(productNode->output, sample * m, m);
+            sampleOutputs.push_back({ &sliceNode->output });
+        }
+        return true;
+    }
+
     template <typename ValueType>
     void MatrixVectorMultiplyNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
@@ -85,6 +133,9 @@ namespace nodes
         emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
 
         function.CallGEMV<ValueType>((int)_m, (int)_n, pInputMatrix, (int)_lda, pInputVector, _incx, pOutput, 1);
+
+        // the product is still in cache, so apply the bias and activation before anything else reads it
+        _epilogue.Compile(compiler, *this, function, pOutput, (int)_m);
     }
 
     template <typename ValueType>
@@ -98,6 +149,7 @@ namespace nodes
         archiver["n"] << _n;
         archiver["lda"] << _lda;
         archiver["incx"] << _incx;
+        _epilogue.WriteToArchive(archiver);
     }
 
     template <typename ValueType>
@@ -111,6 +163,7 @@ namespace nodes
         archiver["n"] >> _n;
         archiver["lda"] >> _lda;
         archiver["incx"] >> _incx;
+        _epilogue.ReadFromArchive(archiver);
     }
 
     template <typename ValueType>
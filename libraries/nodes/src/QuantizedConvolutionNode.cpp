@@ -0,0 +1,414 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizedConvolutionNode.cpp (nodes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizedConvolutionNode.h"
+
+#include <emitters/include/IRMath.h>
+#include <emitters/include/IRVectorUtilities.h>
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <type_traits>
+
+namespace ell
+{
+namespace nodes
+{
+    namespace
+    {
+        // the number of int8 products computed by one vector multiply in compiled code
+        constexpr int int8VectorSize = 16;
+
+        template <typename OutputValueType>
+        constexpr bool IsQuantized = std::is_same_v<OutputValueType, int8_t>;
+
+        template <typename ValueType>
+        ValueType ApplyActivation(ValueType value, ValueType negativeSlope)
+        {
+            if (negativeSlope == 0)
+            {
+                return std::max(value, static_cast<ValueType>(0));
+            }
+            return value > 0 || negativeSlope == 1 ? value : negativeSlope * value;
+        }
+
+        // Rounds the value to int8 with the same arithmetic as `QuantizeToInt8`
+        template <typename ValueType>
+        emitters::IRLocalScalar EmitQuantizeToInt8(emitters::IRFunctionEmitter& function, emitters::IRLocalScalar value)
+        {
+            auto clamped = emitters::Min(emitters::Max(value, static_cast<ValueType>(-127)), static_cast<ValueType>(127));
+            auto rounded = function.LocalScalar(function.CastValue<int>(clamped + static_cast<ValueType>(127.5))) - 127;
+            return function.LocalScalar(function.CastValue<char>(rounded));
+        }
+    } // namespace
+
+    template <typename ValueType, typename InputValueType, typename OutputValueType>
+    QuantizedConvolutionNode<ValueType, InputValueType, OutputValueType>::QuantizedConvolutionNode() :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, {}, defaultInputPortName),
+        _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType, typename InputValueType, typename OutputValueType>
+    QuantizedConvolutionNode<ValueType, InputValueType, OutputValueType>::QuantizedConvolutionNode(const model::OutputPort<InputValueType>& input,
+                                                                                                   const model::PortMemoryLayout& inputMemoryLayout,
+                                                                                                   const model::PortMemoryLayout& outputMemoryLayout,
+                                                                                                   int filterRows,
+                                                                                                   int filterColumns,
+                                                                                                   int stride,
+                                                                                                   int padding,
+                                                                                                   const QuantizedWeights<ValueType>& weights) :
+        CompilableNode({ &_input }, { &_output }),
+        _input(this, input, defaultInputPortName),
+        _output(this, defaultOutputPortName, outputMemoryLayout),
+        _inputMemoryLayout(inputMemoryLayout),
+        _filterRows(filterRows),
+        _filterColumns(filterColumns),
+        _stride(stride),
+        _padding(padding),
+        _weights(weights)
+    {
+        if (input.Size() != inputMemoryLayout.GetMemorySize())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Input size must match the input memory layout");
+        }
+        Initialize();
+    }
+
+    template <typename ValueType, typename InputValueType, typename OutputValueType>
+    void QuantizedConvolutionNode<ValueType, InputValueType, OutputValueType>::Initialize()
+    {
+        const auto& outputLayout = _output.GetMemoryLayout();
+        if (_inputMemoryLayout.NumDimensions() != 3 || outputLayout.NumDimensions() != 3)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Input and output memory layouts must have 3 dimensions");
+        }
+
+        if (_filterRows < 1 || _filterColumns < 1 || _stride < 1 || _padding < 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Filter size and stride must be positive, and padding must not be negative");
+        }
+
+        const int numFilters = NumFilters();
+        const int inputChannels = _inputMemoryLayout.GetLogicalDimensionActiveSize(2);
+        const int fieldSize = _filterRows * _filterColumns * inputChannels;
+        if (numFilters < 1 || static_cast<int>(_weights.weights.size()) != numFilters * fieldSize || static_cast<int>(_weights.bias.size()) != numFilters)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Weights must hold a receptive field for each filter, with one output scale and bias per filter");
+        }
+
+        if (!(_weights.inputScale > 0) || !(_weights.outputQuantizationScale > 0))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Quantization scales must be positive");
+        }
+
+        // The output holds the filters at each position, or is a single position whose active area holds all the filters
+        if (outputLayout.GetLogicalDimensionActiveSize(2) == numFilters)
+        {
+            _outputRows = outputLayout.GetLogicalDimensionActiveSize(0);
+            _outputColumns = outputLayout.GetLogicalDimensionActiveSize(1);
+        }
+        else if (static_cast<int>(outputLayout.NumElements()) == numFilters)
+        {
+            _outputRows = 1;
+            _outputColumns = 1;
+        }
+        else
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Output must hold one value per filter at each position");
+        }
+
+        // Every receptive field must lie inside the input's memory, so that reading the padding around it is safe
+        for (int dimension = 0; dimension < 2; ++dimension)
+        {
+            const int firstEntry = _inputMemoryLayout.GetLogicalDimensionOffset(dimension) - _padding;
+            const int numPositions = dimension == 0 ? _outputRows : _outputColumns;
+            const int filterSize = dimension == 0 ? _filterRows : _filterColumns;
+            if (firstEntry < 0 || firstEntry + (numPositions - 1) * _stride + filterSize > _inputMemoryLayout.GetLogicalDimensionExtent(dimension))
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Receptive fields must lie inside the input's memory");
+            }
+        }
+
+        const int inputRowIncrement = static_cast<int>(_inputMemoryLayout.GetLogicalDimensionIncrement(0));
+        const int inputColumnIncrement = static_cast<int>(_inputMemoryLayout.GetLogicalDimensionIncrement(1));
+        const int inputChannelIncrement = static_cast<int>(_inputMemoryLayout.GetLogicalDimensionIncrement(2));
+        _fieldOffsets.clear();
+        for (int filterRow = 0; filterRow < _filterRows; ++filterRow)
+        {
+            for (int filterColumn = 0; filterColumn < _filterColumns; ++filterColumn)
+            {
+                for (int channel = 0; channel < inputChannels; ++channel)
+                {
+                    _fieldOffsets.push_back(filterRow * inputRowIncrement + filterColumn * inputColumnIncrement + channel * inputChannelIncrement);
+                }
+            }
+        }
+
+        // Filter f goes to the active entry f of a single position, in (row, column, channel) order
+        const int activeRows = _outputRows == 1 && _outputColumns == 1 ? outputLayout.GetLogicalDimensionActiveSize(0) : 1;
+        const int activeColumns = _outputRows == 1 && _outputColumns == 1 ? outputLayout.GetLogicalDimensionActiveSize(1) : 1;
+        const int activeChannels = numFilters / (activeRows * activeColumns);
+        _filterOutputOffsets.clear();
+        for (int row = 0; row < activeRows; ++row)
+        {
+            for (int column = 0; column < activeColumns; ++column)
+            {
+                for (int channel = 0; channel < activeChannels; ++channel)
+                {
+                    _filterOutputOffsets.push_back(static_cast<int>(outputLayout.GetEntryOffset(outputLayout.GetPhysicalCoordinates({ row, column, channel }))));
+                }
+            }
+        }
+    }
+
+    template <typename ValueType, typename InputValueType, typename OutputValueType>
+    int QuantizedConvolutionNode<ValueType, InputValueType, OutputValueType>::GetInputOrigin() const
+    {
+        return (_inputMemoryLayout.GetLogicalDimensionOffset(0) - _padding) * static_cast<int>(_inputMemoryLayout.GetLogicalDimensionIncrement(0)) +
+               (_inputMemoryLayout.GetLogicalDimensionOffset(1) - _padding) * static_cast<int>(_inputMemoryLayout.GetLogicalDimensionIncrement(1)) +
+               _inputMemoryLayout.GetLogicalDimensionOffset(2) * static_cast<int>(_inputMemoryLayout.GetLogicalDimensionIncrement(2));
+    }
+
+    template <typename ValueType, typename InputValueType, typename OutputValueType>
+    void QuantizedConvolutionNode<ValueType, InputValueType, OutputValueType>::Compute() const
+    {
+        const auto& inputValues = _input.GetValue();
+        std::vector<int8_t> quantizedInput(inputValues.size());
+        const auto inverseInputScale = 1 / _weights.inputScale;
+        for (size_t index = 0; index < inputValues.size(); ++index)
+        {
+            if constexpr (IsQuantized<InputValueType>)
+            {
+                quantizedInput[index] = inputValues[index];
+            }
+            else
+            {
+                quantizedInput[index] = QuantizeToInt8(inputValues[index] * inverseInputScale);
+            }
+        }
+
+        const auto& outputLayout = _output.GetMemoryLayout();
+        const int inputRowStep = _stride * static_cast<int>(_inputMemoryLayout.GetLogicalDimensionIncrement(0));
+        const int inputColumnStep = _stride * static_cast<int>(_inputMemoryLayout.GetLogicalDimensionIncrement(1));
+        const int outputRowIncrement = static_cast<int>(outputLayout.GetLogicalDimensionIncrement(0));
+        const int outputColumnIncrement = static_cast<int>(outputLayout.GetLogicalDimensionIncrement(1));
+        const int inputOrigin = GetInputOrigin();
+        const int fieldSize = GetFieldSize();
+        const auto inverseOutputScale = 1 / _weights.outputQuantizationScale;
+
+        std::vector<OutputValueType> outputValues(outputLayout.GetMemorySize());
+        for (int outputRow = 0; outputRow < _outputRows; ++outputRow)
+        {
+            for (int outputColumn = 0; outputColumn < _outputColumns; ++outputColumn)
+            {
+                const auto* field = quantizedInput.data() + inputOrigin + outputRow * inputRowStep + outputColumn * inputColumnStep;
+                const int outputOffset = outputRow * outputRowIncrement + outputColumn * outputColumnIncrement;
+                for (int filter = 0; filter < NumFilters(); ++filter)
+                {
+                    const auto* filterWeights = _weights.weights.data() + filter * fieldSize;
+                    int32_t accumulator = 0;
+                    for (int j = 0; j < fieldSize; ++j)
+                    {
+                        accumulator += static_cast<int32_t>(filterWeights[j]) * static_cast<int32_t>(field[_fieldOffsets[j]]);
+                    }
+
+                    auto value = ApplyActivation(static_cast<ValueType>(accumulator) * _weights.outputScales[filter] + _weights.bias[filter], _weights.negativeSlope);
+                    if constexpr (IsQuantized<OutputValueType>)
+                    {
+                        outputValues[outputOffset + _filterOutputOffsets[filter]] = QuantizeToInt8(value * inverseOutputScale);
+                    }
+                    else
+                    {
+                        outputValues[outputOffset + _filterOutputOffsets[filter]] = value;
+                    }
+                }
+            }
+        }
+        _output.SetOutput(outputValues);
+    }
+
+    template <typename ValueType, typename InputValueType, typename OutputValueType>
+    void QuantizedConvolutionNode<ValueType, InputValueType, OutputValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        auto& module = function.GetModule();
+        auto& emitter = function.GetEmitter();
+        const auto& outputLayout = _output.GetMemoryLayout();
+        const int numFilters = NumFilters();
+        const int fieldSize = GetFieldSize();
+
+        // Pad each filter's weights (and the unrolled receptive field) with zeros to a whole number of vectors, so that
+        // every vector load is aligned and the zeros take the place of an epilogue
+        const int vectorSize = int8VectorSize;
+        const int numBlocks = (fieldSize + vectorSize - 1) / vectorSize;
+        const int rowSize = numBlocks * vectorSize;
+        std::vector<char> paddedWeights(numFilters * rowSize, 0);
+        for (int filter = 0; filter < numFilters; ++filter)
+        {
+            std::copy_n(_weights.weights.begin() + filter * fieldSize, fieldSize, paddedWeights.begin() + filter * rowSize);
+        }
+
+        auto input = function.LocalArray(compiler.EnsurePortEmitted(this->input));
+        auto output = function.LocalArray(compiler.EnsurePortEmitted(this->output));
+        auto weightsVar = module.ConstantArray(compiler.GetGlobalName(*this, "weights"), paddedWeights);
+        auto pWeights = function.PointerOffset(weightsVar, 0); // convert "global variable" to a pointer
+        auto outputScales = function.LocalArray(function.PointerOffset(module.ConstantArray(compiler.GetGlobalName(*this, "outputScales"), _weights.outputScales), 0));
+        auto bias = function.LocalArray(function.PointerOffset(module.ConstantArray(compiler.GetGlobalName(*this, "bias"), _weights.bias), 0));
+        auto fieldOffsets = function.LocalArray(function.PointerOffset(module.ConstantArray(compiler.GetGlobalName(*this, "fieldOffsets"), _fieldOffsets), 0));
+        auto filterOutputOffsets = function.LocalArray(function.PointerOffset(module.ConstantArray(compiler.GetGlobalName(*this, "filterOutputOffsets"), _filterOutputOffsets), 0));
+
+        auto int8VectorType = emitter.VectorType(emitters::VariableType::Char8, vectorSize);
+        auto int32VectorType = emitter.VectorType(emitters::VariableType::Int32, vectorSize);
+
+        // Quantize the whole input once, padding included, unless the previous node already did
+        auto quantizedInput = input;
+        if constexpr (!IsQuantized<InputValueType>)
+        {
+            const int inputSize = static_cast<int>(_inputMemoryLayout.GetMemorySize());
+            quantizedInput = function.LocalArray(function.PointerOffset(module.GlobalArray(emitters::VariableType::Char8, compiler.GetGlobalName(*this, "quantizedInput"), inputSize), 0));
+            const auto inverseInputScale = 1 / _weights.inputScale;
+            function.For(inputSize, [=](emitters::IRFunctionEmitter& function, auto index) {
+                emitters::IRLocalScalar value = input[index];
+                quantizedInput[index] = EmitQuantizeToInt8<ValueType>(function, value * inverseInputScale);
+            });
+        }
+
+        // Padding in the output isn't written below
+        if (outputLayout.HasPadding())
+        {
+            function.For(static_cast<int>(outputLayout.GetMemorySize()), [=](emitters::IRFunctionEmitter& function, auto index) {
+                output[index] = function.Literal<OutputValueType>(0);
+            });
+        }
+
+        // The receptive field of the current position, unrolled into a column whose zero tail is written once
+        auto pColumn = function.CastPointer(function.Variable(int8VectorType, numBlocks), emitters::VariableType::Char8Pointer);
+        auto column = function.LocalArray(pColumn);
+        if (rowSize > fieldSize)
+        {
+            function.For(fieldSize, rowSize, [=](emitters::IRFunctionEmitter& function, auto j) {
+                column[j] = function.Literal<int8_t>(0);
+            });
+        }
+
+        const int inputRowStep = _stride * static_cast<int>(_inputMemoryLayout.GetLogicalDimensionIncrement(0));
+        const int inputColumnStep = _stride * static_cast<int>(_inputMemoryLayout.GetLogicalDimensionIncrement(1));
+        const int outputRowIncrement = static_cast<int>(outputLayout.GetLogicalDimensionIncrement(0));
+        const int outputColumnIncrement = static_cast<int>(outputLayout.GetLogicalDimensionIncrement(1));
+        const int inputOrigin = GetInputOrigin();
+        const auto negativeSlope = _weights.negativeSlope;
+        const auto inverseOutputScale = 1 / _weights.outputQuantizationScale;
+
+        auto weightVectors = function.CastPointer(pWeights, int8VectorType->getPointerTo());
+        auto columnVectors = function.CastPointer(pColumn, int8VectorType->getPointerTo());
+        emitters::LLVMValue accumulatorVar = function.Variable(int32VectorType, "accumulator");
+        function.For(_outputRows, [=](emitters::IRFunctionEmitter& function, auto outputRow) {
+            function.For(_outputColumns, [=](emitters::IRFunctionEmitter& function, auto outputColumn) {
+                auto fieldStart = outputRow * inputRowStep + outputColumn * inputColumnStep + inputOrigin;
+                function.For(fieldSize, [=](emitters::IRFunctionEmitter& function, auto j) {
+                    column[j] = quantizedInput[fieldStart + fieldOffsets[j]];
+                });
+
+                // Multiply the int8 values with 32-bit accumulation, a vector at a time, and scale each filter's sum back to real values.
+                // Sign-extending both operands before the multiply is the pattern that LLVM lowers to pmaddwd / vpdpbusd / sdot.
+                auto outputOffset = outputRow * outputRowIncrement + outputColumn * outputColumnIncrement;
+                function.For(numFilters, [=](emitters::IRFunctionEmitter& function, auto filter) {
+                    function.Store(accumulatorVar, emitters::FillVector<int>(function, int32VectorType, 0));
+                    auto rowOffset = filter * numBlocks;
+                    function.For(numBlocks, [=](emitters::IRFunctionEmitter& function, auto blockIndex) {
+                        auto& irBuilder = function.GetEmitter().GetIRBuilder();
+                        auto weight = irBuilder.CreateSExt(function.ValueAt(weightVectors, rowOffset + blockIndex), int32VectorType);
+                        auto x = irBuilder.CreateSExt(function.ValueAt(columnVectors, blockIndex), int32VectorType);
+                        auto product = function.Operator(emitters::TypedOperator::multiply, weight, x);
+                        function.OperationAndUpdate(accumulatorVar, emitters::TypedOperator::add, product);
+                    });
+                    auto sum = function.LocalScalar(emitters::HorizontalVectorSum<int>(function, function.Load(accumulatorVar)));
+                    auto value = function.LocalScalar(function.CastValue<ValueType>(sum)) * outputScales[filter] + bias[filter];
+                    if (negativeSlope == 0)
+                    {
+                        value = emitters::Max(value, static_cast<ValueType>(0));
+                    }
+                    else if (negativeSlope != 1)
+                    {
+                        value = function.LocalScalar(function.Select(value > static_cast<ValueType>(0), value, value * negativeSlope));
+                    }
+
+                    if constexpr (IsQuantized<OutputValueType>)
+                    {
+                        output[outputOffset + filterOutputOffsets[filter]] = EmitQuantizeToInt8<ValueType>(function, value * inverseOutputScale);
+                    }
+                    else
+                    {
+                        output[outputOffset + filterOutputOffsets[filter]] = value;
+                    }
+                });
+            });
+        });
+    }
+
+    template <typename ValueType, typename InputValueType, typename OutputValueType>
+    void QuantizedConvolutionNode<ValueType, InputValueType, OutputValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<QuantizedConvolutionNode<ValueType, InputValueType, OutputValueType>>(newInput, _inputMemoryLayout, _output.GetMemoryLayout(), _filterRows, _filterColumns, _stride, _padding, _weights);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType, typename InputValueType, typename OutputValueType>
+    void QuantizedConvolutionNode<ValueType, InputValueType, OutputValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver[defaultOutputPortName] << _output;
+        archiver["inputLayout"] << _inputMemoryLayout;
+        archiver["filterRows"] << _filterRows;
+        archiver["filterColumns"] << _filterColumns;
+        archiver["stride"] << _stride;
+        archiver["padding"] << _padding;
+        archiver["weights"] << std::vector<char>(_weights.weights.begin(), _weights.weights.end());
+        archiver["inputScale"] << _weights.inputScale;
+        archiver["outputScales"] << _weights.outputScales;
+        archiver["bias"] << _weights.bias;
+        archiver["negativeSlope"] << _weights.negativeSlope;
+        archiver["outputQuantizationScale"] << _weights.outputQuantizationScale;
+    }
+
+    template <typename ValueType, typename InputValueType, typename OutputValueType>
+    void QuantizedConvolutionNode<ValueType, InputValueType, OutputValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver[defaultOutputPortName] >> _output;
+        archiver["inputLayout"] >> _inputMemoryLayout;
+        archiver["filterRows"] >> _filterRows;
+        archiver["filterColumns"] >> _filterColumns;
+        archiver["stride"] >> _stride;
+        archiver["padding"] >> _padding;
+        std::vector<char> weights;
+        archiver["weights"] >> weights;
+        _weights.weights.assign(weights.begin(), weights.end());
+        archiver["inputScale"] >> _weights.inputScale;
+        archiver["outputScales"] >> _weights.outputScales;
+        archiver["bias"] >> _weights.bias;
+        archiver["negativeSlope"] >> _weights.negativeSlope;
+        archiver["outputQuantizationScale"] >> _weights.outputQuantizationScale;
+        Initialize();
+    }
+
+    // Explicitly instantiate versions
+    template class QuantizedConvolutionNode<float, float, float>;
+    template class QuantizedConvolutionNode<float, float, int8_t>;
+    template class QuantizedConvolutionNode<float, int8_t, float>;
+    template class QuantizedConvolutionNode<float, int8_t, int8_t>;
+    template class QuantizedConvolutionNode<double, double, double>;
+    template class QuantizedConvolutionNode<double, double, int8_t>;
+    template class QuantizedConvolutionNode<double, int8_t, double>;
+    template class QuantizedConvolutionNode<double, int8_t, int8_t>;
+} // namespace nodes
+} // namespace ell
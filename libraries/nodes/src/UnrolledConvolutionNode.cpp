@@ -34,17 +34,20 @@ namespace nodes
                                                                 const model::PortMemoryLayout& inputMemoryLayout,
                                                                 const model::PortMemoryLayout& outputMemoryLayout,
                                                                 const ConstTensorReferenceType& filterWeights,
-                                                                int stride) :
+                                                                int stride,
+                                                                const BiasActivationEpilogue<ValueType>& epilogue) :
         CompilableNode({ &_input }, { &_output }),
         _input(this, input, defaultInputPortName),
         _output(this, defaultOutputPortName, outputMemoryLayout),
         _inputMemoryLayout(inputMemoryLayout),
         _filterWeights(0, 0),
         _filterSize(filterWeights.NumColumns()),
-        _stride(stride)
+        _stride(stride),
+        _epilogue(epilogue)
     {
         _isDepthwiseSeparable = (filterWeights.NumChannels() == 1) && (inputMemoryLayout.GetLogicalDimensionActiveSize(2) > 1);
         _filterWeights = GetWeightsMatrix(filterWeights);
+        CheckEpilogue();
     }
 
     template <typename ValueType>
@@ -53,16 +56,29 @@ namespace nodes
                                                                 const model::PortMemoryLayout& outputMemoryLayout,
                                                                 ConstMatrixReferenceType filterWeights,
                                                                 int filterSize,
-                                                                int stride) :
+                                                                int stride,
+                                                                const BiasActivationEpilogue<ValueType>& epilogue) :
         CompilableNode({ &_input }, { &_output }),
         _input(this, input, defaultInputPortName),
         _output(this, defaultOutputPortName, outputMemoryLayout),
         _inputMemoryLayout(inputMemoryLayout),
         _filterWeights(filterWeights),
         _filterSize(filterSize),
-        _stride(stride)
+        _stride(stride),
+        _epilogue(epilogue)
     {
         _isDepthwiseSeparable = (static_cast<int>(filterWeights.NumColumns()) == (filterSize * filterSize)) && (inputMemoryLayout.GetLogicalDimensionActiveSize(2) > static_cast<int>(1));
+        CheckEpilogue();
+    }
+
+    template <typename ValueType>
+    void UnrolledConvolutionNode<ValueType>::CheckEpilogue() const
+    {
+        // depthwise-separable convolutions are compiled directly, one channel at a time
+        if (_isDepthwiseSeparable && !_epilogue.IsEmpty())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Depthwise-separable unrolled convolutions can't have a bias and activation epilogue");
+        }
     }
 
     template <typename ValueType>
@@ -109,11 +125,18 @@ namespace nodes
         return false;
     }
 
+    template <typename ValueType>
+    bool UnrolledConvolutionNode<ValueType>::UsePackedGemm(model::ModelTransformer& transformer) const
+    {
+        auto compiler = transformer.GetContext().GetCompiler();
+        return compiler != nullptr && compiler->GetModelOptimizerOptions(*this).template GetEntry<bool>("usePackedGemm", false);
+    }
+
     template <typename ValueType>
     void UnrolledConvolutionNode<ValueType>::Copy(model::ModelTransformer& transformer) const
     {
         const auto& newInput = transformer.GetCorrespondingInputs(_input);
-        auto newNode = transformer.AddNode<UnrolledConvolutionNode<ValueType>>(newInput, _inputMemoryLayout, GetOutputMemoryLayout(), _filterWeights, _filterSize, _stride);
+        auto newNode = transformer.AddNode<UnrolledConvolutionNode<ValueType>>(newInput, _inputMemoryLayout, GetOutputMemoryLayout(), _filterWeights, _filterSize, _stride, _epilogue);
         transformer.MapNodeOutput(this->output, newNode->output);
     }
 
@@ -167,7 +190,21 @@ namespace nodes
         std::array<int, 3> dataOrder = useNewMethod ? drcOrder : rcdOrder;
         assert(outputPadding == 0 && "Unrolled convolution node output padding not supported yet");
 
-        bool isELLCodeTarget = IsELLCodeTarget(transformer);
+        // The packed GEMM is only implemented by the code node, so asking for it selects that node on any target
+        bool usePackedGemm = UsePackedGemm(transformer);
+        bool useGemmCodeNode = usePackedGemm || IsELLCodeTarget(transformer);
+        auto gemmImplementation = usePackedGemm ? MatrixMatrixMultiplyImplementation::Packed_Loopnest_Value : MatrixMatrixMultiplyImplementation::DEFAULT;
+
+        // MatrixMatrixMultiplyNode applies the bias and activation right after its GEMM, but the code node can't,
+        // so its output gets a node of its own
+        auto addEpilogueNode = [&](const model::OutputPort<ValueType>& gemmOutput) -> const model::OutputPort<ValueType>& {
+            if (_epilogue.IsEmpty())
+            {
+                return gemmOutput;
+            }
+            model::PortMemoryLayout gemmOutputLayout(model::MemoryShape{ outputImageHeight, outputImageWidth, numFilters });
+            return AddBiasActivationNode(transformer, gemmOutput, gemmOutputLayout, gemmOutputLayout, _epilogue.GetBias(), _epilogue.GetActivation());
+        };
         // weights: numFilters x fieldVolumeSize == m x k
         // ShapedInput: fieldVolumeSize x outputRows == k x n
         // Matrix multiply output: numFilters x outputRows = m x n
@@ -175,25 +212,26 @@ namespace nodes
         if (dataOrder == rcdOrder) // don't reorder input -- use old method
         {
             auto receptiveFieldMatrixNode = transformer.AddNode<ReceptiveFieldMatrixNode<ValueType>>(newInput, inputLayout, filterSize, _stride, inputPadding, dataOrder, outputImageWidth, outputImageHeight);
-            if(isELLCodeTarget)
+            if (useGemmCodeNode)
             {
-                auto matrixMultNode = transformer.AddNode<MatrixMatrixMultiplyCodeNode<ValueType>>(weights, m, n, k, lda, false, receptiveFieldMatrixNode->output, ldb, false, ldc, true);
+                auto matrixMultNode = transformer.AddNode<MatrixMatrixMultiplyCodeNode<ValueType>>(weights, m, n, k, lda, false, receptiveFieldMatrixNode->output, ldb, false, ldc, true, gemmImplementation);
+                const auto& gemmOutput = addEpilogueNode(matrixMultNode->output);
                 if (outputPadding != 0)
                 {
                     // Add padding
                     model::PortMemoryLayout outputLayout(model::MemoryShape{ outputImageHeight, outputImageWidth, numFilters });
                     model::PortMemoryLayout paddedOutputLayout(model::MemoryShape{ outputImageHeight, outputImageWidth, numFilters }, model::MemoryShape{ outputPadding, outputPadding, 0 });
-                    const auto& reorderedOutput = ReorderDataWithCodeNode(matrixMultNode->output, outputLayout, paddedOutputLayout);
+                    const auto& reorderedOutput = ReorderDataWithCodeNode(gemmOutput, outputLayout, paddedOutputLayout);
                     transformer.MapNodeOutput(this->output, reorderedOutput);
                 }
                 else
                 {
-                    transformer.MapNodeOutput(this->output, matrixMultNode->output);
+                    transformer.MapNodeOutput(this->output, gemmOutput);
                 }
             }
             else
             {
-                auto matrixMultNode = transformer.AddNode<MatrixMatrixMultiplyNode<ValueType>>(weights, m, n, k, lda, false, receptiveFieldMatrixNode->output, ldb, false, ldc, true);
+                auto matrixMultNode = transformer.AddNode<MatrixMatrixMultiplyNode<ValueType>>(weights, m, n, k, lda, false, receptiveFieldMatrixNode->output, ldb, false, ldc, true, _epilogue);
                 if (outputPadding != 0)
                 {
                     // Add padding
@@ -219,25 +257,26 @@ namespace nodes
             const auto& reorderedInput = ReorderDataWithCodeNode(newInput, inputLayout, transposedInputLayout);
 
             auto receptiveFieldMatrixNode = transformer.AddNode<ReceptiveFieldMatrixNode<ValueType>>(reorderedInput, reorderedInput.GetMemoryLayout(), _filterSize, _stride, inputPadding, dataOrder, outputImageWidth, outputImageHeight);
-            if(isELLCodeTarget)
+            if (useGemmCodeNode)
             {
-                auto matrixMultNode = transformer.AddNode<MatrixMatrixMultiplyCodeNode<ValueType>>(weights, m, n, k, lda, false, receptiveFieldMatrixNode->output, ldb, false, ldc, true);
+                auto matrixMultNode = transformer.AddNode<MatrixMatrixMultiplyCodeNode<ValueType>>(weights, m, n, k, lda, false, receptiveFieldMatrixNode->output, ldb, false, ldc, true, gemmImplementation);
+                const auto& gemmOutput = addEpilogueNode(matrixMultNode->output);
                 if (outputPadding != 0)
                 {
                     // Add padding
                     model::PortMemoryLayout outputLayout(model::MemoryShape{ outputImageHeight, outputImageWidth, numFilters });
                     model::PortMemoryLayout paddedOutputLayout(model::MemoryShape{ outputImageHeight, outputImageWidth, numFilters }, model::MemoryShape{ outputPadding, outputPadding, 0 });
-                    const auto& reorderedOutput = ReorderDataWithCodeNode(matrixMultNode->output, outputLayout, paddedOutputLayout);
+                    const auto& reorderedOutput = ReorderDataWithCodeNode(gemmOutput, outputLayout, paddedOutputLayout);
                     transformer.MapNodeOutput(this->output, reorderedOutput);
                 }
                 else
                 {
-                    transformer.MapNodeOutput(this->output, matrixMultNode->output);
+                    transformer.MapNodeOutput(this->output, gemmOutput);
                 }
             }
             else
             {
-                auto matrixMultNode = transformer.AddNode<MatrixMatrixMultiplyNode<ValueType>>(weights, m, n, k, lda, false, receptiveFieldMatrixNode->output, ldb, false, ldc, true);    
+                auto matrixMultNode = transformer.AddNode<MatrixMatrixMultiplyNode<ValueType>>(weights, m, n, k, lda, false, receptiveFieldMatrixNode->output, ldb, false, ldc, true, _epilogue);    
                 if (outputPadding != 0)
                 {
                     // Add padding
@@ -345,6 +384,7 @@ namespace nodes
         archiver["filterSize"] << _filterSize;
         archiver["stride"] << _stride;
         math::MatrixArchiver::Write(_filterWeights, "weights", archiver);
+        _epilogue.WriteToArchive(archiver);
     }
 
     template <typename ValueType>
@@ -360,6 +400,7 @@ namespace nodes
         archiver["stride"] >> _stride;
         math::MatrixArchiver::Read(_filterWeights, "weights", archiver);
         _isDepthwiseSeparable = (static_cast<int>(_filterWeights.NumColumns()) == (_filterSize * _filterSize));
+        _epilogue.ReadFromArchive(archiver);
     }
 
     // Explicit specializations
@@ -0,0 +1,203 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MatrixNodesTiming.cpp (nodes_test)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MatrixNodesTiming.h"
+
+#include <model/include/IRCompiledMap.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputNode.h>
+#include <model/include/Map.h>
+#include <model/include/Model.h>
+
+#include <nodes/include/ConstantNode.h>
+#include <nodes/include/MatrixMatrixMultiplyCodeNode.h>
+#include <nodes/include/MatrixMatrixMultiplyNode.h>
+#include <nodes/include/MatrixVectorMultiplyNode.h>
+#include <nodes/include/QuantizedConvolutionNode.h>
+
+#include <utilities/include/MillisecondTimer.h>
+#include <utilities/include/RandomEngines.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <vector>
+
+using namespace ell;
+
+//
+// Helpers
+//
+namespace
+{
+template <typename ElementType>
+std::vector<ElementType> GetRandomVector(size_t size, ElementType min = -1, ElementType max = 1)
+{
+    auto randomEngine = utilities::GetRandomEngine("123");
+    std::uniform_real_distribution<ElementType> uniform(min, max);
+    std::vector<ElementType> result(size);
+    std::generate(result.begin(), result.end(), [&]() { return uniform(randomEngine); });
+    return result;
+}
+
+template <typename ValueType>
+auto TimeCompiledMap(model::Map& map, const std::vector<ValueType>& input, int numIterations, bool useBlas)
+{
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = true;
+    settings.compilerSettings.useBlas = useBlas;
+    settings.compilerSettings.parallelize = false;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+
+    // warm up the caches before timing
+    compiledMap.SetInputValue(0, input);
+    volatile auto warmupResult = compiledMap.ComputeOutput<ValueType>(0);
+
+    utilities::MillisecondTimer timer;
+    for (int iteration = 0; iteration < numIterations; ++iteration)
+    {
+        compiledMap.SetInputValue(0, input);
+        volatile auto result = compiledMap.ComputeOutput<ValueType>(0);
+    }
+    return timer.Elapsed();
+}
+} // namespace
+
+//
+// Timing functions
+//
+
+// Compares the int8 matrix-vector product with the float one it replaces in a quantized fully connected layer
+template <typename ValueType>
+static void TimeQuantizedFullyConnectedLayer(int m, int n, int numIterations)
+{
+    auto matrix = GetRandomVector<ValueType>(m * n);
+    auto input = GetRandomVector<ValueType>(n);
+
+    nodes::QuantizedWeights<ValueType> quantizedWeights;
+    quantizedWeights.weights.resize(m * n);
+    std::transform(matrix.begin(), matrix.end(), quantizedWeights.weights.begin(), [](ValueType value) { return nodes::QuantizeToInt8(value * 127); });
+    quantizedWeights.inputScale = static_cast<ValueType>(1.0 / 127);
+    quantizedWeights.outputScales.assign(m, static_cast<ValueType>(1.0 / (127 * 127)));
+    quantizedWeights.bias.assign(m, 0);
+
+    model::Model floatModel;
+    auto floatInputNode = floatModel.AddNode<model::InputNode<ValueType>>(n);
+    auto matrixNode = floatModel.AddNode<nodes::ConstantNode<ValueType>>(matrix);
+    auto floatNode = floatModel.AddNode<nodes::MatrixVectorMultiplyNode<ValueType>>(matrixNode->output, m, n, n, floatInputNode->output);
+    auto floatMap = model::Map(floatModel, { { "input", floatInputNode } }, { { "output", floatNode->output } });
+
+    model::PortMemoryLayout inputLayout(model::MemoryShape{ 1, 1, n });
+    model::PortMemoryLayout outputLayout(model::MemoryShape{ 1, 1, m });
+    model::Model quantizedModel;
+    auto quantizedInputNode = quantizedModel.AddNode<model::InputNode<ValueType>>(inputLayout);
+    auto quantizedNode = quantizedModel.AddNode<nodes::QuantizedConvolutionNode<ValueType, ValueType, ValueType>>(quantizedInputNode->output, inputLayout, outputLayout, 1, 1, 1, 0, quantizedWeights);
+    auto quantizedMap = model::Map(quantizedModel, { { "input", quantizedInputNode } }, { { "output", quantizedNode->output } });
+
+    auto floatTime = TimeCompiledMap(floatMap, input, numIterations, false);
+    auto blasTime = TimeCompiledMap(floatMap, input, numIterations, true);
+    auto quantizedTime = TimeCompiledMap(quantizedMap, input, numIterations, false);
+
+    std::cout << "Total time for " << numIterations << " iterations of " << m << " x " << n << " matrix-vector products: "
+              << quantizedTime << " ms int8\t(float: " << floatTime << " ms, float with BLAS: " << blasTime << " ms)\n";
+}
+
+// Compares an int8 3x3 convolution with the float matrix-matrix product at the core of the unrolled convolution it replaces
+template <typename ValueType>
+static void TimeQuantizedConvolution(int imageSize, int numChannels, int numFilters, int numIterations)
+{
+    const int filterSize = 3;
+    const int fieldSize = filterSize * filterSize * numChannels;
+    const int numPositions = imageSize * imageSize;
+    model::PortMemoryLayout inputLayout(model::MemoryShape{ imageSize, imageSize, numChannels }, model::MemoryShape{ 1, 1, 0 });
+    model::PortMemoryLayout outputLayout(model::MemoryShape{ imageSize, imageSize, numFilters });
+
+    auto weights = GetRandomVector<ValueType>(numFilters * fieldSize);
+    nodes::QuantizedWeights<ValueType> quantizedWeights;
+    quantizedWeights.weights.resize(weights.size());
+    std::transform(weights.begin(), weights.end(), quantizedWeights.weights.begin(), [](ValueType value) { return nodes::QuantizeToInt8(value * 127); });
+    quantizedWeights.inputScale = static_cast<ValueType>(1.0 / 127);
+    quantizedWeights.outputScales.assign(numFilters, static_cast<ValueType>(1.0 / (127 * 127)));
+    quantizedWeights.bias.assign(numFilters, 0);
+    quantizedWeights.negativeSlope = 0;
+
+    model::Model quantizedModel;
+    auto quantizedInputNode = quantizedModel.AddNode<model::InputNode<ValueType>>(inputLayout);
+    auto quantizedNode = quantizedModel.AddNode<nodes::QuantizedConvolutionNode<ValueType, ValueType, ValueType>>(quantizedInputNode->output, inputLayout, outputLayout, filterSize, filterSize, 1, 1, quantizedWeights);
+    auto quantizedMap = model::Map(quantizedModel, { { "input", quantizedInputNode } }, { { "output", quantizedNode->output } });
+
+    model::Model floatModel;
+    auto floatInputNode = floatModel.AddNode<model::InputNode<ValueType>>(fieldSize * numPositions);
+    auto matrixNode = floatModel.AddNode<nodes::ConstantNode<ValueType>>(weights);
+    auto floatNode = floatModel.AddNode<nodes::MatrixMatrixMultiplyNode<ValueType>>(matrixNode->output, numFilters, numPositions, fieldSize, fieldSize, floatInputNode->output, numPositions, numPositions);
+    auto floatMap = model::Map(floatModel, { { "input", floatInputNode } }, { { "output", floatNode->output } });
+
+    auto quantizedTime = TimeCompiledMap(quantizedMap, GetRandomVector<ValueType>(inputLayout.GetMemorySize()), numIterations, false);
+    auto blasTime = TimeCompiledMap(floatMap, GetRandomVector<ValueType>(fieldSize * numPositions), numIterations, true);
+
+    std::cout << "Total time for " << numIterations << " iterations of 3x3 convolutions with " << numFilters << " filters on a " << imageSize << "x" << imageSize << "x" << numChannels << " image: "
+              << quantizedTime << " ms int8\t(float matrix-matrix product of the unrolled image with BLAS: " << blasTime << " ms)\n";
+}
+
+// Compares the throughput of the generated matrix-matrix products with the BLAS one
+template <typename ValueType>
+static void TimeMatrixMatrixMultiply(int m, int n, int k, int numIterations)
+{
+    auto matrixA = GetRandomVector<ValueType>(m * k);
+    auto matrixB = GetRandomVector<ValueType>(k * n);
+
+    auto makeMap = [&](std::optional<nodes::MatrixMatrixMultiplyImplementation> gemmImplementation) {
+        model::Model model;
+        auto inputNode = model.AddNode<model::InputNode<ValueType>>(k * n);
+        auto matrixNode = model.AddNode<nodes::ConstantNode<ValueType>>(matrixA);
+        if (gemmImplementation)
+        {
+            auto node = model.AddNode<nodes::MatrixMatrixMultiplyCodeNode<ValueType>>(matrixNode->output, m, n, k, k, inputNode->output, n, n, *gemmImplementation);
+            return model::Map(model, { { "input", inputNode } }, { { "output", node->output } });
+        }
+        auto node = model.AddNode<nodes::MatrixMatrixMultiplyNode<ValueType>>(matrixNode->output, m, n, k, k, inputNode->output, n, n);
+        return model::Map(model, { { "input", inputNode } }, { { "output", node->output } });
+    };
+
+    auto floatMap = makeMap(std::nullopt);
+    auto defaultMap = makeMap(nodes::MatrixMatrixMultiplyImplementation::DEFAULT);
+    auto packedMap = makeMap(nodes::MatrixMatrixMultiplyImplementation::Packed_Loopnest_Value);
+
+    auto blasTime = TimeCompiledMap(floatMap, matrixB, numIterations, true);
+    auto loopsTime = TimeCompiledMap(floatMap, matrixB, numIterations, false);
+    auto defaultTime = TimeCompiledMap(defaultMap, matrixB, numIterations, false);
+    auto packedTime = TimeCompiledMap(packedMap, matrixB, numIterations, false);
+
+    auto numFlops = 2.0 * m * n * k * numIterations;
+    auto gflops = [numFlops](double milliseconds) { return milliseconds > 0 ? numFlops / (milliseconds * 1e6) : 0.0; };
+    std::cout << m << " x " << n << " x " << k << " matrix-matrix product GFLOP/s: packed " << gflops(packedTime)
+              << "\t(default code node: " << gflops(defaultTime) << ", BLAS: " << gflops(blasTime) << ", without BLAS: " << gflops(loopsTime) << ")\n";
+}
+
+//
+// Main driver function to call all the timing functions
+//
+void TimeMatrixNodes()
+{
+    TimeQuantizedFullyConnectedLayer<float>(64, 64, 100000);
+    TimeQuantizedFullyConnectedLayer<float>(256, 256, 10000);
+    TimeQuantizedFullyConnectedLayer<float>(1000, 1024, 1000);
+    TimeQuantizedFullyConnectedLayer<float>(4096, 1024, 200);
+    TimeQuantizedConvolution<float>(56, 64, 64, 10);
+    TimeQuantizedConvolution<float>(14, 256, 256, 10);
+    std::cout << std::endl;
+
+    TimeMatrixMatrixMultiply<float>(64, 64, 64, 1000);
+    TimeMatrixMatrixMultiply<float>(256, 256, 256, 50);
+    TimeMatrixMatrixMultiply<float>(64, 3136, 576, 10); // a 3x3 convolution with 64 filters on a 56x56x64 image
+    TimeMatrixMatrixMultiply<float>(1024, 1024, 1024, 5);
+    std::cout << std::endl;
+}
@@ -10,8 +10,10 @@
 
 #include <nodes/include/ActivationLayerNode.h>
 #include <nodes/include/BatchNormalizationLayerNode.h>
+#include <nodes/include/BiasActivationNode.h>
 #include <nodes/include/BiasLayerNode.h>
 #include <nodes/include/BinaryConvolutionalLayerNode.h>
+#include <nodes/include/ConstantNode.h>
 #include <nodes/include/ConvolutionalLayerNode.h>
 #include <nodes/include/FullyConnectedLayerNode.h>
 #include <nodes/include/NeuralNetworkPredictorNode.h>
@@ -33,6 +35,7 @@
 #include <predictors/neural/include/ConvolutionalLayer.h>
 #include <predictors/neural/include/FullyConnectedLayer.h>
 #include <predictors/neural/include/InputLayer.h>
+#include <predictors/neural/include/LeakyReLUActivation.h>
 #include <predictors/neural/include/PoolingLayer.h>
 #include <predictors/neural/include/ReLUActivation.h>
 #include <predictors/neural/include/RegionDetectionLayer.h>
@@ -225,6 +228,68 @@ static void TestArchiveNeuralNetworkLayerNodes()
 #endif
 }
 
+static void TestArchiveBiasActivationNodes()
+{
+    using ElementType = double;
+    using LeakyReLUBiasActivationNode = nodes::BiasActivationNode<ElementType, nodes::LeakyReLUActivationFunction<ElementType>>;
+    const ElementType leakyFactor = 0.25;
+
+    // A bias + leaky ReLU node, and a fully connected layer that applies the same bias and activation itself
+    model::PortMemoryLayout layout(model::MemoryShape{ 1, 2, 3 });
+    std::vector<ElementType> bias = { 1, -2, 0.5 };
+    std::vector<ElementType> input = { -4, 3, -1, 2, -5, 0 };
+
+    typename FullyConnectedLayer<ElementType>::TensorType layerInput(1, 2, 3);
+    typename FullyConnectedLayer<ElementType>::MatrixType weights(6, 6);
+    for (size_t index = 0; index < 6; ++index)
+    {
+        weights(index, index) = static_cast<ElementType>(index + 1);
+        weights(index, 5 - index) -= 1;
+    }
+    typename FullyConnectedLayer<ElementType>::LayerParameters parameters{ layerInput, NoPadding(), { 1, 2, 3 }, NoPadding() };
+    FullyConnectedLayer<ElementType> fullyConnectedLayer(parameters, weights);
+    LeakyReLUActivation<ElementType> activation(leakyFactor);
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(layout);
+    auto biasNode = model.AddNode<nodes::ConstantNode<ElementType>>(bias);
+    auto biasActivationNode = model.AddNode<LeakyReLUBiasActivationNode>(inputNode->output, layout, biasNode->output, layout, nodes::LeakyReLUActivationFunction<ElementType>(leakyFactor));
+    auto fullyConnectedNode = model.AddNode<nodes::FullyConnectedLayerNode<ElementType>>(inputNode->output, fullyConnectedLayer, nodes::BiasActivationEpilogue<ElementType>(bias, &activation));
+
+    inputNode->SetInput(input);
+    auto biasActivationOutput = model.ComputeOutput(biasActivationNode->output);
+    auto fullyConnectedOutput = model.ComputeOutput(fullyConnectedNode->output);
+
+    std::vector<ElementType> expectedOutput = { -0.75, 1, -0.125, 3, -1.75, 0.5 };
+    testing::ProcessTest("Testing BiasActivationNode compute", testing::IsEqual(biasActivationOutput, expectedOutput));
+
+    // Archive the model
+    utilities::SerializationContext context;
+    common::RegisterNodeTypes(context);
+    std::stringstream strstream;
+    utilities::JsonArchiver archiver(strstream);
+    archiver << model;
+
+    // Unarchive the model
+    NeuralNetworkPredictor<ElementType>::RegisterNeuralNetworkPredictorTypes(context);
+    utilities::JsonUnarchiver unarchiver(strstream, context);
+    model::Model model2;
+    unarchiver >> model2;
+
+    auto biasActivationNodes = model2.GetNodesByType<LeakyReLUBiasActivationNode>();
+    auto fullyConnectedNodes = model2.GetNodesByType<nodes::FullyConnectedLayerNode<ElementType>>();
+    testing::ProcessTest("Testing BiasActivationNode archive (nodes)", biasActivationNodes.size() == 1 && fullyConnectedNodes.size() == 1);
+    testing::ProcessTest("Testing BiasActivationNode archive (leaky factor)", testing::IsEqual(biasActivationNodes[0]->GetFunction().GetActivationFunction().GetLeakyFactor(), leakyFactor));
+
+    const auto& epilogue = fullyConnectedNodes[0]->GetEpilogue();
+    auto epilogueActivation = dynamic_cast<const LeakyReLUActivation<ElementType>*>(epilogue.GetActivation());
+    testing::ProcessTest("Testing FullyConnectedLayerNode epilogue archive", testing::IsEqual(epilogue.GetBias(), bias) && epilogueActivation != nullptr && testing::IsEqual(epilogueActivation->GetLeakyFactor(), leakyFactor));
+
+    model2.GetNodesByType<model::InputNode<ElementType>>()[0]->SetInput(input);
+    testing::ProcessTest("Testing BiasActivationNode archive (compute)", testing::IsEqual(model2.ComputeOutput(biasActivationNodes[0]->output), biasActivationOutput));
+    testing::ProcessTest("Testing FullyConnectedLayerNode epilogue archive (compute)", testing::IsEqual(model2.ComputeOutput(fullyConnectedNodes[0]->output), fullyConnectedOutput));
+}
+
 //
 // Individual layer nodes
 //
@@ -715,4 +780,5 @@ void TestNeuralNetworkLayerNodes()
 
     TestArchiveNeuralNetworkPredictorNode();
     TestArchiveNeuralNetworkLayerNodes();
+    TestArchiveBiasActivationNodes();
 }
@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "DSPNodesTiming.h"
+#include "MatrixNodesTiming.h"
 
 #include <testing/include/testing.h>
 
@@ -26,6 +27,7 @@ int main(int argc, char** argv)
     try
     {
         TimeDSPNodes();
+        TimeMatrixNodes();
     }
     catch (const utilities::Exception& exception)
     {
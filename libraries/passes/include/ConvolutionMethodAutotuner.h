@@ -0,0 +1,83 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConvolutionMethodAutotuner.h (passes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Map.h>
+#include <model/include/MapCompilerOptions.h>
+#include <model/include/ModelOptimizerOptions.h>
+#include <model/include/Node.h>
+
+#include <utilities/include/PropertyBag.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary> A convolution method chosen for a layer, and the time it took per call when it was measured. </summary>
+    struct ConvolutionMethodChoice
+    {
+        model::PreferredConvolutionMethod method = model::PreferredConvolutionMethod::automatic;
+        int winogradTileSize = 0;
+        double time = 0;
+    };
+
+    /// <summary>
+    /// Chooses the convolution method for a `ConvolutionalLayerNode` empirically: each candidate method (simple,
+    /// unrolled, diagonal, and Winograd with each supported tile size) is compiled for the layer's shape on its own,
+    /// run on the host with model profiling turned on, and the fastest one is picked. Results are cached by shape,
+    /// so layers with the same shape are only timed once.
+    /// </summary>
+    class ConvolutionMethodAutotuner
+    {
+    public:
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="numIterations"> The number of timed calls to each candidate, after one untimed call. </param>
+        ConvolutionMethodAutotuner(int numIterations = 10);
+
+        /// <summary> Finds the fastest convolution method for a node. </summary>
+        ///
+        /// <param name="node"> The node to tune. </param>
+        /// <param name="settings"> The settings to compile the candidates with. The target device must be the host. </param>
+        /// <param name="choice"> The fastest method, if any. </param>
+        ///
+        /// <returns> `true` if the node is a `ConvolutionalLayerNode` and at least one method could be timed, else `false`. </returns>
+        bool TryTune(const model::Node& node, const model::MapCompilerOptions& settings, ConvolutionMethodChoice& choice);
+
+        /// <summary> Gets the autotuner shared by every compile in this process. </summary>
+        static ConvolutionMethodAutotuner& GetGlobalAutotuner();
+
+    private:
+        int _numIterations;
+        std::mutex _mutex;
+        std::map<std::string, ConvolutionMethodChoice> _choices;
+    };
+
+    /// <summary> Stores a convolution method choice in the "compileOptions" entry of a node's metadata, where later compiles pick it up. </summary>
+    ///
+    /// <param name="choice"> The choice to store. </param>
+    /// <param name="metadata"> The metadata of the node. </param>
+    void SetConvolutionMethodChoice(const ConvolutionMethodChoice& choice, utilities::PropertyBag& metadata);
+
+    /// <summary>
+    /// Tunes every `ConvolutionalLayerNode` in a map that doesn't already have a preferred convolution method in its
+    /// metadata, and stores the results in the metadata of the nodes. Neural network predictor nodes are refined first,
+    /// so that their layers are separate nodes. Saving the map afterwards keeps the choices for later compiles.
+    /// </summary>
+    ///
+    /// <param name="map"> The map to tune. </param>
+    /// <param name="settings"> The settings to compile the candidates with. </param>
+    ///
+    /// <returns> The number of nodes that were tuned. </returns>
+    size_t TuneConvolutionMethods(model::Map& map, const model::MapCompilerOptions& settings);
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,37 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FuseLayerOperationsTransformation.h (passes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Transformation.h>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// A transformation that fuses each `ConvolutionalLayerNode` or `FullyConnectedLayerNode` with the chain of
+    /// `BatchNormalizationLayerNode`s, `ScalingLayerNode`s and `BiasLayerNode`s that follows it, and with an
+    /// `ActivationLayerNode` at the end of the chain. The per-channel scales are folded into the weights of the
+    /// producer, and the combined bias and the activation become the layer's `BiasActivationEpilogue`, which the
+    /// GEMV or GEMM that computes the layer applies to its output while it's still in cache. Convolutions that
+    /// aren't computed with a GEMM, and chains that change the output's layout, get a single `BiasActivationNode`
+    /// after the layer instead, so the output makes one pass through memory rather than one per operation.
+    /// A layer is only fused with nodes that are the sole consumers of their inputs. Fusing can be turned off
+    /// for a node with the "fuseLayerOperations" model optimizer option.
+    /// </summary>
+    class FuseLayerOperationsTransformation : public model::Transformation
+    {
+    public:
+        /// <summary> Fuse layers with the linear operations and activation that follow them. </summary>
+        model::Submodel Transform(const model::Submodel& submodel, model::ModelTransformer& transformer, const model::TransformContext& context) const override;
+
+        /// <summary> Returns the ID for this transformation </summary>
+        std::string GetRuntimeTypeName() const override { return { "FuseLayerOperationsTransformation" }; };
+    };
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     LayerEpilogue.h (passes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Node.h>
+#include <model/include/OutputPort.h>
+#include <model/include/Submodel.h>
+
+#include <predictors/neural/include/Activation.h>
+
+#include <functional>
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary> The per-channel operations following a layer that can be folded into it: y = activation(scale * x + bias). </summary>
+    template <typename ValueType>
+    struct LayerEpilogue
+    {
+        /// <summary> The scale of each channel, or empty if there is no scale. </summary>
+        std::vector<ValueType> scale;
+
+        /// <summary> The bias of each channel, or empty if there is no bias. </summary>
+        std::vector<ValueType> bias;
+
+        /// <summary> The activation at the end of the epilogue, or null if there is none. </summary>
+        const predictors::neural::ActivationImpl<ValueType>* activation = nullptr;
+
+        /// <summary> The nodes whose operations are in the epilogue, in order. </summary>
+        std::vector<const model::Node*> fusedNodes;
+
+        /// <summary> The output of the last node in the epilogue, or null if the epilogue is empty. </summary>
+        const model::OutputPort<ValueType>* output = nullptr;
+    };
+
+    /// <summary> A function that indicates if an activation can end an epilogue. </summary>
+    template <typename ValueType>
+    using ActivationPredicate = std::function<bool(const predictors::neural::ActivationImpl<ValueType>*)>;
+
+    /// <summary>
+    /// Follows the chain of `BatchNormalizationLayerNode`s, `ScalingLayerNode`s and `BiasLayerNode`s after a layer,
+    /// ending with an `ActivationLayerNode` whose activation is accepted, for as long as each node is the sole
+    /// consumer of the one before it and doesn't read a submodel output.
+    /// </summary>
+    ///
+    /// <param name="submodel"> The submodel being transformed. </param>
+    /// <param name="layerNode"> The layer node. </param>
+    /// <param name="layerOutput"> The output of the layer node, whose last logical dimension holds the channels. </param>
+    /// <param name="canFuseActivation"> Indicates if an activation can end the epilogue. </param>
+    ///
+    /// <returns> The epilogue, which is empty if no nodes can be folded into the layer. </returns>
+    template <typename ValueType>
+    LayerEpilogue<ValueType> GetLayerEpilogue(const model::Submodel& submodel, const model::Node& layerNode, const model::OutputPort<ValueType>& layerOutput, const ActivationPredicate<ValueType>& canFuseActivation);
+
+    /// <summary> Indicates if a port is one of the outputs of a submodel. </summary>
+    ///
+    /// <param name="submodel"> The submodel. </param>
+    /// <param name="port"> The port. </param>
+    ///
+    /// <returns> If the port is an output of the submodel, true, else false. </returns>
+    bool IsSubmodelOutput(const model::Submodel& submodel, const model::OutputPortBase& port);
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,47 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PropagateLayoutsTransformation.h (passes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Transformation.h>
+
+#include <atomic>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// A transformation that pushes memory layouts through the graph to remove `ReorderDataCodeNode` traffic.
+    /// Starting at each reorder node, it collects the region of layout-agnostic nodes that consume its output
+    /// (elementwise `UnaryOperationNode`s, the `BroadcastUnaryFunctionNode`s and `BroadcastLinearFunctionNode`s that
+    /// activation, bias, scaling and batch normalization layers refine into, and `BinaryOperationNode`s and
+    /// `BinaryFunctionNode`s whose other input is in the same region or is a constant) and computes the region in the
+    /// reorder's input layout instead, keeping each port's padding. The reorder nodes leaving the region are retargeted
+    /// to read that layout (or removed when they would be identity copies), and a reorder into the original layout is
+    /// only kept for consumers outside the region. A region is only rewritten if that moves fewer bytes through reorder
+    /// nodes than the original model did. Propagation can be turned off for a reorder node with the "propagateLayouts"
+    /// model optimizer option.
+    /// </summary>
+    class PropagateLayoutsTransformation : public model::Transformation
+    {
+    public:
+        /// <summary> Propagate layouts through the layout-agnostic regions of the submodel. </summary>
+        model::Submodel Transform(const model::Submodel& submodel, model::ModelTransformer& transformer, const model::TransformContext& context) const override;
+
+        /// <summary> Returns the ID for this transformation </summary>
+        std::string GetRuntimeTypeName() const override { return { "PropagateLayoutsTransformation" }; };
+
+        /// <summary> Gets the total number of bytes per evaluation that this transformation has removed from reorder nodes. </summary>
+        size_t GetReorderBytesSaved() const { return _reorderBytesSaved; }
+
+    private:
+        // The only state kept between calls to `Transform`, since the registered instance is shared
+        mutable std::atomic<size_t> _reorderBytesSaved{ 0 };
+    };
+} // namespace passes
+} // namespace ell
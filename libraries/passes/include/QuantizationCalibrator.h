@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizationCalibrator.h (passes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Map.h>
+#include <model/include/Node.h>
+
+#include <data/include/DataVector.h>
+
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// Collects the range of the values that reach each fully connected and convolutional layer of a map while it
+    /// computes a set of calibration examples, and records it in the layer's metadata so that
+    /// `QuantizeLayersTransformation` can quantize the layer.
+    /// </summary>
+    class QuantizationCalibrator
+    {
+    public:
+        /// <summary> Constructor. Refines the neural network predictor nodes of the map, so that its layers are separate nodes. </summary>
+        ///
+        /// <param name="map"> The map to calibrate. It must outlive the calibrator. </param>
+        QuantizationCalibrator(model::Map& map);
+
+        /// <summary> Computes the map on an example and updates the input range of each layer. </summary>
+        ///
+        /// <param name="example"> The input to the map. </param>
+        template <typename DataVectorType>
+        void AddExample(const DataVectorType& example);
+
+        /// <summary> Gets the number of layers that can be quantized. </summary>
+        ///
+        /// <returns> The number of fully connected and convolutional layer nodes in the map. </returns>
+        size_t NumLayers() const { return _layerNodes.size(); }
+
+        /// <summary> Gets the number of examples that have been added. </summary>
+        ///
+        /// <returns> The number of examples. </returns>
+        size_t NumExamples() const { return _numExamples; }
+
+        /// <summary> Writes the input range of each layer to its metadata. Does nothing if no examples were added. </summary>
+        void WriteRangesToMetadata();
+
+    private:
+        void UpdateRanges();
+
+        model::Map& _map;
+        std::vector<model::Node*> _layerNodes;
+        std::vector<double> _inputRanges;
+        size_t _numExamples = 0;
+    };
+} // namespace passes
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace passes
+{
+    template <typename DataVectorType>
+    void QuantizationCalibrator::AddExample(const DataVectorType& example)
+    {
+        _map.Compute<data::DoubleDataVector>(example);
+        UpdateRanges();
+    }
+} // namespace passes
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,46 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizeLayersTransformation.h (passes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <model/include/Transformation.h>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary> The name of the node metadata entry that holds the largest magnitude seen at the input of a layer, as a double. </summary>
+    constexpr char quantizationInputRangeMetadataKey[] = "quantizationInputRange";
+
+    /// <summary> The name of the model optimizer option that lets the compiler quantize calibrated layers. It defaults to false. </summary>
+    constexpr char quantizeLayersOption[] = "quantizeLayers";
+
+    /// <summary>
+    /// A transformation that replaces each `FullyConnectedLayerNode` and (non-depthwise) `ConvolutionalLayerNode`
+    /// that has a calibrated input range (see `QuantizationCalibrator`) with a `QuantizedConvolutionNode`. Weights
+    /// are quantized symmetrically to int8 with one scale per filter, and the input with one scale derived from its
+    /// calibrated range. The chain of batch normalization, scaling, bias and (leaky) ReLU nodes that follows a layer
+    /// is folded into the quantized node's output scales, biases and activation.
+    ///
+    /// When every consumer of a quantized layer's output is itself quantized, the layer writes int8 values, scaled
+    /// by the largest of its consumers' calibrated ranges, and its consumers read them without quantizing again, so
+    /// the values stay int8 between consecutive quantized layers. Layers without a calibrated range are left alone.
+    /// When the transformation is run by a compiler, as part of the standard transformations, layers are only
+    /// quantized if the `quantizeLayers` option is set for them (see the `nodes_timing` benchmark for how the
+    /// quantized node compares with the float one).
+    /// </summary>
+    class QuantizeLayersTransformation : public model::Transformation
+    {
+    public:
+        /// <summary> Replace calibrated layers with quantized ones. </summary>
+        model::Submodel Transform(const model::Submodel& submodel, model::ModelTransformer& transformer, const ell::model::TransformContext& context) const override;
+
+        /// <summary> Returns the ID for this transformation </summary>
+        std::string GetRuntimeTypeName() const override { return { "QuantizeLayersTransformation" }; };
+    };
+} // namespace passes
+} // namespace ell
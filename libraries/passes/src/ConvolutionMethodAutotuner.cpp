@@ -0,0 +1,284 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConvolutionMethodAutotuner.cpp (passes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ConvolutionMethodAutotuner.h"
+
+#include <model/include/IRCompiledMap.h>
+#include <model/include/IRMapCompiler.h>
+#include <model/include/InputNode.h>
+#include <model/include/TransformContext.h>
+
+#include <nodes/include/ConvolutionalLayerNode.h>
+
+#include <predictors/neural/include/ConvolutionalLayer.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Logger.h>
+#include <utilities/include/TypeName.h>
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    using namespace utilities::logging;
+    using utilities::logging::Log;
+
+    namespace
+    {
+        const std::vector<ConvolutionMethodChoice> candidateMethods = {
+            { model::PreferredConvolutionMethod::simple, 0 },
+            { model::PreferredConvolutionMethod::unrolled, 0 },
+            { model::PreferredConvolutionMethod::diagonal, 0 },
+            { model::PreferredConvolutionMethod::winograd, 2 },
+            { model::PreferredConvolutionMethod::winograd, 4 }
+        };
+
+        bool IsNeuralNetworkPredictorNode(const model::Node& node)
+        {
+            return (node.GetRuntimeTypeName().find("NeuralNetworkPredictorNode") == 0);
+        }
+
+        bool IsConvolutionalLayerNode(const model::Node& node)
+        {
+            return (node.GetRuntimeTypeName().find("ConvolutionalLayerNode") == 0);
+        }
+
+        bool HasPreferredConvolutionMethod(const model::Node& node)
+        {
+            const auto& metadata = node.GetMetadata();
+            return metadata.HasEntry("compileOptions") && metadata.GetEntry<utilities::PropertyBag>("compileOptions").HasEntry("preferredConvolutionMethod");
+        }
+
+        template <typename ShapeType>
+        void WriteShape(std::ostream& out, const ShapeType& shape)
+        {
+            std::vector<size_t> sizes = shape;
+            for (auto size : sizes)
+            {
+                out << size << "x";
+            }
+            out << ";";
+        }
+
+        // everything about a layer that affects the speed of its convolution, but not the weight values
+        template <typename ValueType>
+        std::string GetShapeKey(const nodes::ConvolutionalLayerNode<ValueType>& node, const model::MapCompilerOptions& settings)
+        {
+            const auto& layer = node.GetLayer();
+            const auto& layerParameters = layer.GetLayerParameters();
+            const auto& convolutionalParameters = layer.GetConvolutionalParameters();
+            const auto& weights = layer.GetWeights();
+
+            std::ostringstream key;
+            key << utilities::TypeName<ValueType>::GetName() << ";";
+            WriteShape(key, layer.GetInputShape());
+            WriteShape(key, layer.GetOutputShape());
+            key << layerParameters.inputPaddingParameters.paddingSize << ";" << layerParameters.outputPaddingParameters.paddingSize << ";";
+            key << convolutionalParameters.receptiveField << ";" << convolutionalParameters.stride << ";";
+            key << weights.NumRows() << "x" << weights.NumColumns() << "x" << weights.NumChannels() << ";";
+            key << settings.compilerSettings.parallelize << ";" << settings.compilerSettings.useBlas;
+            return key.str();
+        }
+
+        bool IsCandidateCompatible(const ConvolutionMethodChoice& candidate, const predictors::neural::ConvolutionalParameters& convolutionalParameters)
+        {
+            if (candidate.method == model::PreferredConvolutionMethod::winograd)
+            {
+                return convolutionalParameters.stride == 1 && convolutionalParameters.receptiveField == 3;
+            }
+            return true;
+        }
+
+        template <typename ValueType>
+        double TimeCandidate(const nodes::ConvolutionalLayerNode<ValueType>& node, const ConvolutionMethodChoice& candidate, const model::MapCompilerOptions& settings, int numIterations)
+        {
+            // a model with just this layer, whose metadata selects the candidate method
+            model::Model model;
+            auto inputNode = model.AddNode<model::InputNode<ValueType>>(node.input.Size());
+            auto convNode = model.AddNode<nodes::ConvolutionalLayerNode<ValueType>>(inputNode->output, node.GetLayer());
+            SetConvolutionMethodChoice(candidate, convNode->GetMetadata());
+            model::Map map(model, { { "input", inputNode } }, { { "output", convNode->output } });
+
+            auto candidateSettings = settings;
+            candidateSettings.profile = true;
+            model::ModelOptimizerOptions optimizerOptions;
+            optimizerOptions["preferredConvolutionMethod"] = candidate.method;
+            model::IRMapCompiler compiler(candidateSettings, optimizerOptions);
+            auto compiledMap = compiler.Compile(map);
+            compiledMap.FinishJitting();
+
+            std::vector<ValueType> input(node.input.Size());
+            for (size_t index = 0; index < input.size(); ++index)
+            {
+                input[index] = static_cast<ValueType>(index % 17) / 16;
+            }
+
+            // the first call pays for one-time setup, such as faulting in the weights
+            compiledMap.SetInputValue(0, input);
+            compiledMap.ComputeOutput<ValueType>(0);
+            compiledMap.ResetModelProfilingInfo();
+            for (int iteration = 0; iteration < numIterations; ++iteration)
+            {
+                compiledMap.SetInputValue(0, input);
+                compiledMap.ComputeOutput<ValueType>(0);
+            }
+            const auto counters = compiledMap.GetModelPerformanceCounters();
+            return counters->totalTime / std::max<int>(counters->count, 1);
+        }
+
+        // returns 'true' if we handled the situation, else 'false'. If we return 'false', keep trying other ValueTypes.
+        template <typename ValueType>
+        bool TryGetShapeKey(const model::Node& node, const model::MapCompilerOptions& settings, std::string& key)
+        {
+            auto thisNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node);
+            if (thisNode == nullptr)
+            {
+                return false;
+            }
+            key = GetShapeKey(*thisNode, settings);
+            return true;
+        }
+
+        template <typename ValueType>
+        bool TryTuneNode(const model::Node& node, const model::MapCompilerOptions& settings, int numIterations, ConvolutionMethodChoice& choice)
+        {
+            auto thisNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node);
+            if (thisNode == nullptr)
+            {
+                return false;
+            }
+
+            const auto& convolutionalParameters = thisNode->GetLayer().GetConvolutionalParameters();
+            bool found = false;
+            for (const auto& candidate : candidateMethods)
+            {
+                if (!IsCandidateCompatible(candidate, convolutionalParameters))
+                {
+                    continue;
+                }
+
+                try
+                {
+                    auto time = TimeCandidate(*thisNode, candidate, settings, numIterations);
+                    Log() << "Convolution method " << model::ToString(candidate.method) << " (tile size " << candidate.winogradTileSize << ") took " << time << " ms for node " << node.GetId() << EOL;
+                    if (!found || time < choice.time)
+                    {
+                        choice = candidate;
+                        choice.time = time;
+                        found = true;
+                    }
+                }
+                catch (const utilities::Exception& exception)
+                {
+                    // some methods don't support every shape
+                    Log() << "Convolution method " << model::ToString(candidate.method) << " failed for node " << node.GetId() << ": " << exception.GetMessage() << EOL;
+                }
+            }
+            return found;
+        }
+    } // namespace
+
+    //
+    // ConvolutionMethodAutotuner methods
+    //
+    ConvolutionMethodAutotuner::ConvolutionMethodAutotuner(int numIterations) :
+        _numIterations(numIterations)
+    {
+    }
+
+    bool ConvolutionMethodAutotuner::TryTune(const model::Node& node, const model::MapCompilerOptions& settings, ConvolutionMethodChoice& choice)
+    {
+        if (settings.compilerSettings.targetDevice.deviceName != "host")
+        {
+            Log() << "Not autotuning convolution methods, because the target device isn't the host" << EOL;
+            return false;
+        }
+
+        std::string key;
+        if (!TryGetShapeKey<float>(node, settings, key) && !TryGetShapeKey<double>(node, settings, key))
+        {
+            return false;
+        }
+
+        // the lock is held while timing, so that candidates don't compete for the processor
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _choices.find(key);
+        if (it != _choices.end())
+        {
+            choice = it->second;
+            return true;
+        }
+
+        if (!TryTuneNode<float>(node, settings, _numIterations, choice) && !TryTuneNode<double>(node, settings, _numIterations, choice))
+        {
+            return false;
+        }
+        _choices[key] = choice;
+        return true;
+    }
+
+    ConvolutionMethodAutotuner& ConvolutionMethodAutotuner::GetGlobalAutotuner()
+    {
+        static ConvolutionMethodAutotuner autotuner;
+        return autotuner;
+    }
+
+    void SetConvolutionMethodChoice(const ConvolutionMethodChoice& choice, utilities::PropertyBag& metadata)
+    {
+        utilities::PropertyBag options;
+        if (metadata.HasEntry("compileOptions"))
+        {
+            options = metadata.GetEntry<utilities::PropertyBag>("compileOptions");
+        }
+
+        // stored as strings, like the options set from the command line
+        options.SetEntry("preferredConvolutionMethod", model::ToString(choice.method));
+        if (choice.method == model::PreferredConvolutionMethod::winograd)
+        {
+            options.SetEntry("winogradTileSize", std::to_string(choice.winogradTileSize));
+        }
+        metadata.SetEntry("compileOptions", options);
+    }
+
+    size_t TuneConvolutionMethods(model::Map& map, const model::MapCompilerOptions& settings)
+    {
+        model::TransformContext refineNNPredictorContext{ [](const model::Node& node) {
+            return IsNeuralNetworkPredictorNode(node) ? model::NodeAction::refine : model::NodeAction::compile;
+        } };
+        map.Refine(refineNNPredictorContext);
+
+        std::vector<model::Node*> nodesToTune;
+        auto& model = map.GetModel();
+        auto iter = model.GetNodeIterator();
+        while (iter.IsValid())
+        {
+            auto node = iter.Get();
+            if (IsConvolutionalLayerNode(*node) && !HasPreferredConvolutionMethod(*node))
+            {
+                nodesToTune.push_back(model.GetNode(node->GetId()));
+            }
+            iter.Next();
+        }
+
+        size_t numTuned = 0;
+        for (auto node : nodesToTune)
+        {
+            ConvolutionMethodChoice choice;
+            if (ConvolutionMethodAutotuner::GetGlobalAutotuner().TryTune(*node, settings, choice))
+            {
+                SetConvolutionMethodChoice(choice, node->GetMetadata());
+                ++numTuned;
+            }
+        }
+        return numTuned;
+    }
+} // namespace passes
+} // namespace ell
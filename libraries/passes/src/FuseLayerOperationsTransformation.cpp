@@ -0,0 +1,223 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FuseLayerOperationsTransformation.cpp (passes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FuseLayerOperationsTransformation.h"
+#include "LayerEpilogue.h"
+
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+
+#include <nodes/include/BiasActivationNode.h>
+#include <nodes/include/ConvolutionalLayerNode.h>
+#include <nodes/include/FullyConnectedLayerNode.h>
+
+#include <predictors/neural/include/HardSigmoidActivation.h>
+#include <predictors/neural/include/HardTanhActivation.h>
+#include <predictors/neural/include/LeakyReLUActivation.h>
+#include <predictors/neural/include/ReLUActivation.h>
+#include <predictors/neural/include/SigmoidActivation.h>
+#include <predictors/neural/include/TanhActivation.h>
+
+#include <utilities/include/Logger.h>
+#include <utilities/include/StlVectorUtil.h>
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    using namespace model;
+    using namespace utilities::logging;
+    using utilities::logging::Log;
+
+    namespace
+    {
+        template <typename Container, typename Function>
+        auto Transform(const Container& container, Function fn)
+        {
+            return utilities::TransformVector(container.begin(), container.end(), fn);
+        }
+
+        std::vector<const OutputPortBase*> GetReferencedPorts(const std::vector<const InputPortBase*>& inputs)
+        {
+            return Transform(inputs, [](auto input) { return &input->GetReferencedPort(); });
+        }
+
+        template <typename ValueType>
+        bool IsFusableActivation(const predictors::neural::ActivationImpl<ValueType>* activation)
+        {
+            using namespace predictors::neural;
+            return dynamic_cast<const ReLUActivation<ValueType>*>(activation) != nullptr ||
+                   dynamic_cast<const LeakyReLUActivation<ValueType>*>(activation) != nullptr ||
+                   dynamic_cast<const SigmoidActivation<ValueType>*>(activation) != nullptr ||
+                   dynamic_cast<const HardSigmoidActivation<ValueType>*>(activation) != nullptr ||
+                   dynamic_cast<const TanhActivation<ValueType>*>(activation) != nullptr ||
+                   dynamic_cast<const HardTanhActivation<ValueType>*>(activation) != nullptr;
+        }
+
+        // The layer can apply the bias and activation as it writes its output if the epilogue ends with the layer's
+        // (unpadded, row-major) layout, so each value's channel is its index modulo the number of channels
+        template <typename ValueType>
+        bool CanApplyEpilogueInLayer(const OutputPort<ValueType>& layerOutput, const LayerEpilogue<ValueType>& epilogue)
+        {
+            const auto& layout = layerOutput.GetMemoryLayout();
+            return !layout.HasPadding() && layout.IsCanonicalOrder() && layout == epilogue.output->GetMemoryLayout();
+        }
+
+        template <typename ValueType>
+        void MapEpilogueOutput(const OutputPort<ValueType>& newLayerOutput, const LayerEpilogue<ValueType>& epilogue, bool isEpilogueInLayer, ModelTransformer& transformer)
+        {
+            const auto& outputLayout = epilogue.output->GetMemoryLayout();
+            if (isEpilogueInLayer || (epilogue.bias.empty() && epilogue.activation == nullptr && newLayerOutput.GetMemoryLayout() == outputLayout))
+            {
+                // the layer applies the rest of the epilogue, or there are only scales, which are all in the weights now
+                transformer.MapNodeOutput(*epilogue.output, newLayerOutput);
+                return;
+            }
+            const auto& output = nodes::AddBiasActivationNode(transformer, newLayerOutput, newLayerOutput.GetMemoryLayout(), outputLayout, epilogue.bias, epilogue.activation);
+            transformer.MapNodeOutput(*epilogue.output, output);
+        }
+
+        // returns 'true' if we handled the situation, else 'false'. If we return 'false', keep trying other ValueTypes.
+        template <typename ValueType>
+        bool TryFuseConvolutionalLayer(const Submodel& submodel, const Node& node, ModelTransformer& transformer, std::set<const Node*>& fusedNodes)
+        {
+            auto thisNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node);
+            if (thisNode == nullptr)
+            {
+                return false;
+            }
+
+            auto epilogue = GetLayerEpilogue<ValueType>(submodel, node, thisNode->output, IsFusableActivation<ValueType>);
+            if (epilogue.fusedNodes.empty())
+            {
+                return false;
+            }
+
+            const auto& layer = thisNode->GetLayer();
+            auto weights = layer.GetWeights();
+            if (!epilogue.scale.empty())
+            {
+                // the weights of filter f are rows [f * receptiveField, (f + 1) * receptiveField)
+                const auto numFilters = epilogue.scale.size();
+                const auto filterRows = weights.NumRows() / numFilters;
+                for (size_t row = 0; row < weights.NumRows(); ++row)
+                {
+                    const auto filterScale = epilogue.scale[row / filterRows];
+                    for (size_t column = 0; column < weights.NumColumns(); ++column)
+                    {
+                        for (size_t channel = 0; channel < weights.NumChannels(); ++channel)
+                        {
+                            weights(row, column, channel) *= filterScale;
+                        }
+                    }
+                }
+            }
+
+            predictors::neural::ConvolutionalLayer<ValueType> newLayer(layer.GetLayerParameters(), layer.GetConvolutionalParameters(), weights);
+            const auto& newInput = transformer.GetCorrespondingInputs(thisNode->input);
+            auto isEpilogueInLayer = CanApplyEpilogueInLayer(thisNode->output, epilogue);
+            auto newNode = isEpilogueInLayer ? transformer.AddNode<nodes::ConvolutionalLayerNode<ValueType>>(newInput, newLayer, nodes::BiasActivationEpilogue<ValueType>(epilogue.bias, epilogue.activation))
+                                             : transformer.AddNode<nodes::ConvolutionalLayerNode<ValueType>>(newInput, newLayer);
+            newNode->GetMetadata() = node.GetMetadata();
+
+            Log() << "Fusing convolutional layer node " << node.GetId() << " with " << epilogue.fusedNodes.size() << " following nodes" << EOL;
+            MapEpilogueOutput(newNode->output, epilogue, isEpilogueInLayer, transformer);
+            fusedNodes.insert(epilogue.fusedNodes.begin(), epilogue.fusedNodes.end());
+            return true;
+        }
+
+        template <typename ValueType>
+        bool TryFuseFullyConnectedLayer(const Submodel& submodel, const Node& node, ModelTransformer& transformer, std::set<const Node*>& fusedNodes)
+        {
+            auto thisNode = dynamic_cast<const nodes::FullyConnectedLayerNode<ValueType>*>(&node);
+            if (thisNode == nullptr)
+            {
+                return false;
+            }
+
+            auto epilogue = GetLayerEpilogue<ValueType>(submodel, node, thisNode->output, IsFusableActivation<ValueType>);
+            if (epilogue.fusedNodes.empty())
+            {
+                return false;
+            }
+
+            const auto& layer = thisNode->GetLayer();
+            auto weights = layer.GetWeights();
+            if (!epilogue.scale.empty())
+            {
+                // output i is in channel (i % numChannels)
+                const auto numChannels = epilogue.scale.size();
+                for (size_t row = 0; row < weights.NumRows(); ++row)
+                {
+                    const auto rowScale = epilogue.scale[row % numChannels];
+                    for (size_t column = 0; column < weights.NumColumns(); ++column)
+                    {
+                        weights(row, column) *= rowScale;
+                    }
+                }
+            }
+
+            predictors::neural::FullyConnectedLayer<ValueType> newLayer(layer.GetLayerParameters(), weights);
+            const auto& newInput = transformer.GetCorrespondingInputs(thisNode->input);
+            auto isEpilogueInLayer = CanApplyEpilogueInLayer(thisNode->output, epilogue);
+            auto newNode = isEpilogueInLayer ? transformer.AddNode<nodes::FullyConnectedLayerNode<ValueType>>(newInput, newLayer, nodes::BiasActivationEpilogue<ValueType>(epilogue.bias, epilogue.activation))
+                                             : transformer.AddNode<nodes::FullyConnectedLayerNode<ValueType>>(newInput, newLayer);
+            newNode->GetMetadata() = node.GetMetadata();
+
+            Log() << "Fusing fully connected layer node " << node.GetId() << " with " << epilogue.fusedNodes.size() << " following nodes" << EOL;
+            MapEpilogueOutput(newNode->output, epilogue, isEpilogueInLayer, transformer);
+            fusedNodes.insert(epilogue.fusedNodes.begin(), epilogue.fusedNodes.end());
+            return true;
+        }
+
+        void FuseLayerOperations(const Submodel& submodel, const Node& node, ModelTransformer& transformer, std::set<const Node*>& fusedNodes)
+        {
+            if (fusedNodes.find(&node) != fusedNodes.end())
+            {
+                // already folded into the layer before it
+                return;
+            }
+
+            if (TryFuseConvolutionalLayer<float>(submodel, node, transformer, fusedNodes) ||
+                TryFuseConvolutionalLayer<double>(submodel, node, transformer, fusedNodes) ||
+                TryFuseFullyConnectedLayer<float>(submodel, node, transformer, fusedNodes) ||
+                TryFuseFullyConnectedLayer<double>(submodel, node, transformer, fusedNodes))
+            {
+                return;
+            }
+
+            transformer.CopyNode(node);
+        }
+    } // namespace
+
+    //
+    // FuseLayerOperationsTransformation methods
+    //
+    Submodel FuseLayerOperationsTransformation::Transform(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context) const
+    {
+        auto compiler = context.GetCompiler();
+        std::set<const Node*> fusedNodes;
+        auto onto = GetReferencedPorts(submodel.GetInputs());
+        auto destModel = submodel.GetModel().ShallowCopy();
+        return transformer.TransformSubmodelOnto(submodel, destModel, onto, context, [&](const Node& node, ModelTransformer& transformer) {
+            bool canFuse = compiler == nullptr || compiler->GetModelOptimizerOptions(node).GetEntry<bool>("fuseLayerOperations", true);
+            if (canFuse)
+            {
+                FuseLayerOperations(submodel, node, transformer, fusedNodes);
+            }
+            else if (fusedNodes.find(&node) == fusedNodes.end())
+            {
+                transformer.CopyNode(node);
+            }
+        });
+    }
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,146 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     LayerEpilogue.cpp (passes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "LayerEpilogue.h"
+
+#include <nodes/include/ActivationLayerNode.h>
+#include <nodes/include/BatchNormalizationLayerNode.h>
+#include <nodes/include/BiasLayerNode.h>
+#include <nodes/include/ScalingLayerNode.h>
+
+#include <algorithm>
+
+namespace ell
+{
+namespace passes
+{
+    using namespace model;
+
+    namespace
+    {
+        // the logical dimension that per-channel scales and biases are broadcast along
+        constexpr size_t channelDimension = 2;
+
+        template <typename ValueType>
+        void AppendScale(LayerEpilogue<ValueType>& epilogue, const std::vector<ValueType>& scale)
+        {
+            // s' * (s * x + b) = (s' * s) * x + (s' * b)
+            if (epilogue.scale.empty())
+            {
+                epilogue.scale = scale;
+            }
+            else
+            {
+                std::transform(epilogue.scale.begin(), epilogue.scale.end(), scale.begin(), epilogue.scale.begin(), [](ValueType a, ValueType b) { return a * b; });
+            }
+            std::transform(epilogue.bias.begin(), epilogue.bias.end(), scale.begin(), epilogue.bias.begin(), [](ValueType a, ValueType b) { return a * b; });
+        }
+
+        template <typename ValueType>
+        void AppendBias(LayerEpilogue<ValueType>& epilogue, const std::vector<ValueType>& bias)
+        {
+            if (epilogue.bias.empty())
+            {
+                epilogue.bias = bias;
+            }
+            else
+            {
+                std::transform(epilogue.bias.begin(), epilogue.bias.end(), bias.begin(), epilogue.bias.begin(), [](ValueType a, ValueType b) { return a + b; });
+            }
+        }
+
+        // returns 'true' if the node was appended to the epilogue
+        template <typename ValueType>
+        bool TryAppendToEpilogue(const Node& node, size_t numChannels, const ActivationPredicate<ValueType>& canFuseActivation, LayerEpilogue<ValueType>& epilogue)
+        {
+            if (auto batchNormNode = dynamic_cast<const nodes::BatchNormalizationLayerNode<ValueType>*>(&node))
+            {
+                const auto& layer = batchNormNode->GetLayer();
+                if (layer.GetScale().Size() != numChannels)
+                {
+                    return false;
+                }
+                AppendScale(epilogue, layer.GetScale().ToArray());
+                AppendBias(epilogue, layer.GetBias().ToArray());
+                epilogue.output = &batchNormNode->output;
+            }
+            else if (auto scalingNode = dynamic_cast<const nodes::ScalingLayerNode<ValueType>*>(&node))
+            {
+                auto scale = scalingNode->GetLayer().GetScale();
+                if (scale.Size() != numChannels)
+                {
+                    return false;
+                }
+                AppendScale(epilogue, scale.ToArray());
+                epilogue.output = &scalingNode->output;
+            }
+            else if (auto biasNode = dynamic_cast<const nodes::BiasLayerNode<ValueType>*>(&node))
+            {
+                auto bias = biasNode->GetLayer().GetBias();
+                if (bias.Size() != numChannels)
+                {
+                    return false;
+                }
+                AppendBias(epilogue, bias.ToArray());
+                epilogue.output = &biasNode->output;
+            }
+            else if (auto activationNode = dynamic_cast<const nodes::ActivationLayerNode<ValueType>*>(&node))
+            {
+                auto activation = activationNode->GetLayer().GetActivationFunction().GetImpl();
+                if (!canFuseActivation(activation))
+                {
+                    return false;
+                }
+                epilogue.activation = activation;
+                epilogue.output = &activationNode->output;
+            }
+            else
+            {
+                return false;
+            }
+
+            epilogue.fusedNodes.push_back(&node);
+            return true;
+        }
+    } // namespace
+
+    template <typename ValueType>
+    LayerEpilogue<ValueType> GetLayerEpilogue(const Submodel& submodel, const Node& layerNode, const OutputPort<ValueType>& layerOutput, const ActivationPredicate<ValueType>& canFuseActivation)
+    {
+        LayerEpilogue<ValueType> epilogue;
+        const auto numChannels = static_cast<size_t>(layerOutput.GetMemoryLayout().GetActiveSize(channelDimension));
+        const Node* current = &layerNode;
+        const OutputPortBase* currentOutput = &layerOutput;
+        while (epilogue.activation == nullptr)
+        {
+            auto dependents = current->GetDependentNodes();
+            if (dependents.size() != 1 || IsSubmodelOutput(submodel, *currentOutput))
+            {
+                break;
+            }
+
+            if (!TryAppendToEpilogue(*dependents[0], numChannels, canFuseActivation, epilogue))
+            {
+                break;
+            }
+            current = dependents[0];
+            currentOutput = epilogue.output;
+        }
+        return epilogue;
+    }
+
+    bool IsSubmodelOutput(const Submodel& submodel, const OutputPortBase& port)
+    {
+        const auto& outputs = submodel.GetOutputs();
+        return std::find(outputs.begin(), outputs.end(), &port) != outputs.end();
+    }
+
+    // Explicitly instantiate versions
+    template LayerEpilogue<float> GetLayerEpilogue(const Submodel& submodel, const Node& layerNode, const OutputPort<float>& layerOutput, const ActivationPredicate<float>& canFuseActivation);
+    template LayerEpilogue<double> GetLayerEpilogue(const Submodel& submodel, const Node& layerNode, const OutputPort<double>& layerOutput, const ActivationPredicate<double>& canFuseActivation);
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,536 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PropagateLayoutsTransformation.cpp (passes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PropagateLayoutsTransformation.h"
+
+#include <model/include/ModelTransformer.h>
+
+#include <nodes/include/ActivationFunctions.h>
+#include <nodes/include/BinaryFunctionNode.h>
+#include <nodes/include/BinaryOperationNode.h>
+#include <nodes/include/BroadcastFunctionNode.h>
+#include <nodes/include/ConstantNode.h>
+#include <nodes/include/ReorderDataCodeNode.h>
+#include <nodes/include/UnaryOperationNode.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Logger.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ell
+{
+
+using namespace model;
+using namespace nodes;
+using namespace utilities;
+using namespace utilities::logging;
+
+namespace passes
+{
+    namespace
+    {
+        template <typename Container, typename Function>
+        auto Transform(const Container& container, Function fn)
+        {
+            return TransformVector(container.begin(), container.end(), fn);
+        }
+
+        std::vector<const OutputPortBase*> GetReferencedPorts(const std::vector<const InputPortBase*>& inputs)
+        {
+            return Transform(inputs, [](auto input) { return &input->GetReferencedPort(); });
+        }
+
+        // The nodes a transformation pass has decided to rewrite, and the rewritten versions of their outputs
+        struct PropagationPlan
+        {
+            std::unordered_set<const Node*> sourceNodes;
+            std::unordered_set<const Node*> regionNodes;
+            std::unordered_set<const Node*> exitNodes;
+            std::unordered_set<const OutputPortBase*> externalPorts;
+            std::unordered_map<const OutputPortBase*, const OutputPortBase*> propagatedPorts;
+        };
+
+        // Returns the layout a region port computes in once the region is moved to the dimension order of `newLayout`
+        PortMemoryLayout GetPropagatedLayout(const PortMemoryLayout& layout, const PortMemoryLayout& newLayout)
+        {
+            return layout.ReorderedCopy(newLayout.GetLogicalDimensionOrder());
+        }
+
+        bool IsInLayout(const MemoryCoordinates& logicalCoordinates, const PortMemoryLayout& layout)
+        {
+            for (int dimension = 0; dimension < logicalCoordinates.NumDimensions(); ++dimension)
+            {
+                auto offset = layout.GetLogicalDimensionOffset(dimension);
+                if (logicalCoordinates[dimension] < -offset || logicalCoordinates[dimension] >= layout.GetLogicalDimensionExtent(dimension) - offset)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <typename ValueType>
+        const ConstantNode<ValueType>* GetConstantNode(const OutputPortBase& port, const PortMemoryLayout& layout)
+        {
+            // The consuming node reads the constant through its own input layout, whatever the constant's port says
+            auto constantNode = dynamic_cast<const ConstantNode<ValueType>*>(port.GetNode());
+            if (constantNode == nullptr || constantNode->GetNumValues() != layout.GetMemorySize())
+            {
+                return nullptr;
+            }
+            return constantNode;
+        }
+
+        template <typename ValueType>
+        bool IsRegionInput(const InputPort<ValueType>& input, const PortMemoryLayout& layout, const std::unordered_set<const OutputPortBase*>& regionPorts)
+        {
+            const auto& port = input.GetReferencedPort();
+            return regionPorts.count(&port) != 0 && port.GetMemoryLayout() == layout;
+        }
+
+        template <typename ValueType>
+        bool IsRegionOrConstantInput(const InputPort<ValueType>& input, const PortMemoryLayout& layout, const std::unordered_set<const OutputPortBase*>& regionPorts)
+        {
+            return IsRegionInput(input, layout, regionPorts) ||
+                   (regionPorts.count(&input.GetReferencedPort()) == 0 && GetConstantNode<ValueType>(input.GetReferencedPort(), layout) != nullptr);
+        }
+
+        // The broadcast nodes loop over the input and output in the same dimension order
+        bool HasSameDimensionOrder(const PortMemoryLayout& inputLayout, const PortMemoryLayout& outputLayout)
+        {
+            return inputLayout.GetLogicalDimensionOrder() == outputLayout.GetLogicalDimensionOrder();
+        }
+
+        // Calls `fn` with each of the function types that `ActivationLayerNode` refines into a `BroadcastUnaryFunctionNode`,
+        // until one of the calls returns true
+        template <typename ValueType, typename Function>
+        bool ForAnyActivationFunction(Function&& fn)
+        {
+            return fn(ReLUActivationFunction<ValueType>{}) ||
+                   fn(LeakyReLUActivationFunction<ValueType>{}) ||
+                   fn(SigmoidActivationFunction<ValueType>{}) ||
+                   fn(HardSigmoidActivationFunction<ValueType>{}) ||
+                   fn(TanhActivationFunction<ValueType>{}) ||
+                   fn(HardTanhActivationFunction<ValueType>{});
+        }
+
+        template <typename ValueType>
+        bool CanJoinRegion(const Node& node, const std::unordered_set<const OutputPortBase*>& regionPorts)
+        {
+            if (auto unaryNode = dynamic_cast<const UnaryOperationNode<ValueType>*>(&node))
+            {
+                // softmax, min and max look at the whole input, not just one entry
+                switch (unaryNode->GetOperation())
+                {
+                case UnaryOperationType::min:
+                case UnaryOperationType::max:
+                case UnaryOperationType::softmax:
+                    return false;
+                default:
+                    return true;
+                }
+            }
+
+            if (auto binaryNode = dynamic_cast<const BinaryOperationNode<ValueType>*>(&node))
+            {
+                const auto& layout = binaryNode->GetOutputMemoryLayout();
+                return binaryNode->GetInputMemoryLayout1() == layout && binaryNode->GetInputMemoryLayout2() == layout &&
+                       IsRegionOrConstantInput(binaryNode->input1, layout, regionPorts) &&
+                       IsRegionOrConstantInput(binaryNode->input2, layout, regionPorts);
+            }
+
+            if (auto linearNode = dynamic_cast<const BroadcastLinearFunctionNode<ValueType>*>(&node))
+            {
+                // the scale and bias are indexed by channel, so they must not be reordered
+                const auto& inputLayout = linearNode->GetInputMemoryLayout();
+                return HasSameDimensionOrder(inputLayout, linearNode->GetOutputMemoryLayout()) &&
+                       IsRegionInput(linearNode->primaryInput, inputLayout, regionPorts) &&
+                       regionPorts.count(&linearNode->secondaryInput1.GetReferencedPort()) == 0 &&
+                       regionPorts.count(&linearNode->secondaryInput2.GetReferencedPort()) == 0;
+            }
+
+            if (auto preluNode = dynamic_cast<const BinaryFunctionNode<ValueType, ParametricReLUActivationFunction<ValueType>>*>(&node))
+            {
+                const auto& inputLayout = preluNode->GetInputMemoryLayout();
+                return HasSameDimensionOrder(inputLayout, preluNode->GetOutputMemoryLayout()) &&
+                       IsRegionOrConstantInput(preluNode->input1, inputLayout, regionPorts) &&
+                       IsRegionOrConstantInput(preluNode->input2, inputLayout, regionPorts);
+            }
+
+            return ForAnyActivationFunction<ValueType>([&](auto function) {
+                using FunctionType = decltype(function);
+                auto activationNode = dynamic_cast<const BroadcastUnaryFunctionNode<ValueType, FunctionType>*>(&node);
+                return activationNode != nullptr &&
+                       HasSameDimensionOrder(activationNode->GetInputMemoryLayout(), activationNode->GetOutputMemoryLayout()) &&
+                       IsRegionInput(activationNode->primaryInput, activationNode->GetInputMemoryLayout(), regionPorts);
+            });
+        }
+
+        template <typename ValueType>
+        const OutputPort<ValueType>* GetPropagatedPort(const PropagationPlan& plan, const OutputPortBase& port)
+        {
+            auto it = plan.propagatedPorts.find(&port);
+            return it == plan.propagatedPorts.end() ? nullptr : static_cast<const OutputPort<ValueType>*>(it->second);
+        }
+
+        // Returns a copy of a constant read through `oldLayout`, with its values rearranged into `newLayout`
+        template <typename ValueType>
+        const OutputPort<ValueType>& AddReorderedConstant(const ConstantNode<ValueType>& constantNode, const PortMemoryLayout& oldLayout, const PortMemoryLayout& newLayout, ModelTransformer& transformer)
+        {
+            const auto& oldValues = constantNode.GetValues();
+            std::vector<ValueType> values(newLayout.GetMemorySize());
+            for (size_t index = 0; index < values.size(); ++index)
+            {
+                auto coordinates = newLayout.GetLogicalCoordinatesFromOffset(index);
+                if (IsInLayout(coordinates, oldLayout))
+                {
+                    values[index] = oldValues[oldLayout.GetLogicalEntryOffset(coordinates)];
+                }
+            }
+            auto newNode = transformer.AddNode<ConstantNode<ValueType>>(values, newLayout);
+            return newNode->output;
+        }
+
+        // Returns the input of a propagated node: the propagated version of a region port, or a reordered constant
+        template <typename ValueType>
+        const OutputPort<ValueType>& GetPropagatedInput(const PropagationPlan& plan, const InputPort<ValueType>& input, const PortMemoryLayout& oldLayout, const PortMemoryLayout& newLayout, ModelTransformer& transformer)
+        {
+            const auto& port = input.GetReferencedPort();
+            if (auto newPort = GetPropagatedPort<ValueType>(plan, port))
+            {
+                return *newPort;
+            }
+            return AddReorderedConstant(*GetConstantNode<ValueType>(port, oldLayout), oldLayout, newLayout, transformer);
+        }
+
+        // Returns the layout of whichever of a node's inputs is in the region, once propagated
+        template <typename ValueType>
+        PortMemoryLayout GetPropagatedInputLayout(const PropagationPlan& plan, const InputPort<ValueType>& input1, const InputPort<ValueType>& input2)
+        {
+            auto newInput = GetPropagatedPort<ValueType>(plan, input1.GetReferencedPort());
+            if (newInput == nullptr)
+            {
+                newInput = GetPropagatedPort<ValueType>(plan, input2.GetReferencedPort());
+            }
+            return newInput->GetMemoryLayout();
+        }
+
+        // Plans and rewrites the layout-agnostic regions of one call to `Transform`
+        class LayoutPropagator
+        {
+        public:
+            // Finds the region of layout-agnostic nodes below a reorder node, and adds it to the plan if computing
+            // the region in the reorder's input layout moves fewer bytes through reorder nodes
+            template <typename ValueType>
+            bool TryPlanRegion(const Node& node, const std::unordered_set<const OutputPortBase*>& submodelOutputs, PropagationPlan& plan)
+            {
+                auto reorderNode = dynamic_cast<const ReorderDataCodeNode<ValueType>*>(&node);
+                if (reorderNode == nullptr)
+                {
+                    return false;
+                }
+
+                // Only reorders that permute the dimensions (and their padding) can be undone by propagating the layout
+                const auto& sourceLayout = reorderNode->GetInputMemoryLayout();
+                auto regionLayout = reorderNode->GetOutputMemoryLayout();
+                if (sourceLayout == regionLayout || !(GetPropagatedLayout(regionLayout, sourceLayout) == sourceLayout) ||
+                    !(reorderNode->input.GetReferencedPort().GetMemoryLayout() == sourceLayout))
+                {
+                    return true;
+                }
+
+                // Grow the region through the consumers of its ports
+                std::unordered_set<const OutputPortBase*> regionPorts = { &reorderNode->output };
+                std::vector<const OutputPortBase*> portsToVisit = { &reorderNode->output };
+                std::vector<const Node*> regionNodes;
+                while (!portsToVisit.empty())
+                {
+                    auto port = portsToVisit.back();
+                    portsToVisit.pop_back();
+                    for (auto input : port->GetReferences())
+                    {
+                        auto consumer = input->GetNode();
+                        if (IsClaimed(*consumer) || std::find(regionNodes.begin(), regionNodes.end(), consumer) != regionNodes.end())
+                        {
+                            continue;
+                        }
+
+                        if (CanJoinRegion<ValueType>(*consumer, regionPorts))
+                        {
+                            regionNodes.push_back(consumer);
+                            auto output = consumer->GetOutputPorts()[0];
+                            regionPorts.insert(output);
+                            portsToVisit.push_back(output);
+                        }
+                    }
+                }
+
+                // Find the reorder nodes that leave the region, and the ports that still need their original layout
+                std::vector<const ReorderDataCodeNode<ValueType>*> exitNodes;
+                std::vector<const OutputPortBase*> externalPorts;
+                for (auto port : regionPorts)
+                {
+                    bool isExternal = submodelOutputs.count(port) != 0;
+                    for (auto input : port->GetReferences())
+                    {
+                        auto consumer = input->GetNode();
+                        if (std::find(regionNodes.begin(), regionNodes.end(), consumer) != regionNodes.end())
+                        {
+                            continue;
+                        }
+
+                        auto exitNode = dynamic_cast<const ReorderDataCodeNode<ValueType>*>(consumer);
+                        if (exitNode != nullptr && !IsClaimed(*exitNode) && exitNode->GetInputMemoryLayout() == port->GetMemoryLayout())
+                        {
+                            exitNodes.push_back(exitNode);
+                        }
+                        else
+                        {
+                            isExternal = true;
+                        }
+                    }
+
+                    if (isExternal)
+                    {
+                        externalPorts.push_back(port);
+                    }
+                }
+
+                // Compare the bytes written by reorder nodes before and after propagating the layout
+                size_t bytesBefore = regionLayout.GetMemorySize() * sizeof(ValueType);
+                size_t bytesAfter = 0;
+                for (auto port : externalPorts)
+                {
+                    bytesAfter += port->GetMemoryLayout().GetMemorySize() * sizeof(ValueType);
+                }
+                for (auto exitNode : exitNodes)
+                {
+                    auto exitBytes = exitNode->GetOutputMemoryLayout().GetMemorySize() * sizeof(ValueType);
+                    bytesBefore += exitBytes;
+                    if (!(exitNode->GetOutputMemoryLayout() == GetPropagatedLayout(exitNode->GetInputMemoryLayout(), sourceLayout)))
+                    {
+                        bytesAfter += exitBytes;
+                    }
+                }
+
+                if (bytesAfter >= bytesBefore)
+                {
+                    Log() << "Not propagating the layout of ReorderDataNode [id = " << node.GetId().ToString() << "], since it would not remove any reorder traffic" << EOL;
+                    return true;
+                }
+
+                Log() << "Propagating the layout of ReorderDataNode [id = " << node.GetId().ToString() << "] through " << regionNodes.size()
+                      << " nodes, removing " << (bytesBefore - bytesAfter) << " bytes of reorder traffic" << EOL;
+
+                plan.sourceNodes.insert(&node);
+                _claimedNodes.insert(&node);
+                for (auto regionNode : regionNodes)
+                {
+                    plan.regionNodes.insert(regionNode);
+                    _claimedNodes.insert(regionNode);
+                }
+                for (auto exitNode : exitNodes)
+                {
+                    plan.exitNodes.insert(exitNode);
+                    _claimedNodes.insert(exitNode);
+                }
+                plan.externalPorts.insert(externalPorts.begin(), externalPorts.end());
+                _reorderBytesSaved += bytesBefore - bytesAfter;
+                return true;
+            }
+
+            // Adds the version of a source or region node that computes in the propagated layout
+            template <typename ValueType>
+            bool TryPropagateNode(const Node& node, PropagationPlan& plan, ModelTransformer& transformer)
+            {
+                const OutputPort<ValueType>* oldOutput = nullptr;
+                const OutputPort<ValueType>* newOutput = nullptr;
+                if (auto reorderNode = dynamic_cast<const ReorderDataCodeNode<ValueType>*>(&node))
+                {
+                    oldOutput = &reorderNode->output;
+                    newOutput = &transformer.GetCorrespondingInputs(reorderNode->input);
+                }
+                else if (auto unaryNode = dynamic_cast<const UnaryOperationNode<ValueType>*>(&node))
+                {
+                    const auto& newInput = *GetPropagatedPort<ValueType>(plan, unaryNode->input.GetReferencedPort());
+                    auto newNode = transformer.AddNode<UnaryOperationNode<ValueType>>(newInput, unaryNode->GetOperation());
+                    oldOutput = &unaryNode->output;
+                    newOutput = &newNode->output;
+                }
+                else if (auto binaryNode = dynamic_cast<const BinaryOperationNode<ValueType>*>(&node))
+                {
+                    auto layout = GetPropagatedInputLayout(plan, binaryNode->input1, binaryNode->input2);
+                    const auto& newInput1 = GetPropagatedInput(plan, binaryNode->input1, binaryNode->GetInputMemoryLayout1(), layout, transformer);
+                    const auto& newInput2 = GetPropagatedInput(plan, binaryNode->input2, binaryNode->GetInputMemoryLayout2(), layout, transformer);
+                    auto newNode = transformer.AddNode<BinaryOperationNode<ValueType>>(newInput1, layout, newInput2, layout, layout, binaryNode->GetOperation(), binaryNode->GetPaddingValue());
+                    oldOutput = &binaryNode->output;
+                    newOutput = &newNode->output;
+                }
+                else if (auto linearNode = dynamic_cast<const BroadcastLinearFunctionNode<ValueType>*>(&node))
+                {
+                    const auto& oldInputLayout = linearNode->GetInputMemoryLayout();
+                    const auto& newInput = *GetPropagatedPort<ValueType>(plan, linearNode->primaryInput.GetReferencedPort());
+                    auto inputLayout = newInput.GetMemoryLayout();
+                    auto broadcastDimension = inputLayout.GetPhysicalDimension(oldInputLayout.GetLogicalDimension(static_cast<int>(linearNode->GetBroadcastDimension())));
+                    auto newNode = transformer.AddNode<BroadcastLinearFunctionNode<ValueType>>(newInput,
+                                                                                               inputLayout,
+                                                                                               transformer.GetCorrespondingInputs(linearNode->secondaryInput1),
+                                                                                               transformer.GetCorrespondingInputs(linearNode->secondaryInput2),
+                                                                                               broadcastDimension,
+                                                                                               GetPropagatedLayout(linearNode->GetOutputMemoryLayout(), inputLayout),
+                                                                                               linearNode->GetOutputPadding());
+                    oldOutput = &linearNode->output;
+                    newOutput = &newNode->output;
+                }
+                else if (auto preluNode = dynamic_cast<const BinaryFunctionNode<ValueType, ParametricReLUActivationFunction<ValueType>>*>(&node))
+                {
+                    const auto& oldInputLayout = preluNode->GetInputMemoryLayout();
+                    auto inputLayout = GetPropagatedInputLayout(plan, preluNode->input1, preluNode->input2);
+                    const auto& newInput1 = GetPropagatedInput(plan, preluNode->input1, oldInputLayout, inputLayout, transformer);
+                    const auto& newInput2 = GetPropagatedInput(plan, preluNode->input2, oldInputLayout, inputLayout, transformer);
+                    auto newNode = transformer.AddNode<BinaryFunctionNode<ValueType, ParametricReLUActivationFunction<ValueType>>>(newInput1,
+                                                                                                                                  newInput2,
+                                                                                                                                  inputLayout,
+                                                                                                                                  GetPropagatedLayout(preluNode->GetOutputMemoryLayout(), inputLayout),
+                                                                                                                                  preluNode->GetFunction(),
+                                                                                                                                  preluNode->GetPaddingValue());
+                    oldOutput = &preluNode->output;
+                    newOutput = &newNode->output;
+                }
+                else
+                {
+                    ForAnyActivationFunction<ValueType>([&](auto function) {
+                        using FunctionType = decltype(function);
+                        auto activationNode = dynamic_cast<const BroadcastUnaryFunctionNode<ValueType, FunctionType>*>(&node);
+                        if (activationNode == nullptr)
+                        {
+                            return false;
+                        }
+
+                        const auto& newInput = *GetPropagatedPort<ValueType>(plan, activationNode->primaryInput.GetReferencedPort());
+                        auto inputLayout = newInput.GetMemoryLayout();
+                        auto newNode = transformer.AddNode<BroadcastUnaryFunctionNode<ValueType, FunctionType>>(newInput,
+                                                                                                                inputLayout,
+                                                                                                                GetPropagatedLayout(activationNode->GetOutputMemoryLayout(), inputLayout),
+                                                                                                                activationNode->GetFunction(),
+                                                                                                                activationNode->GetOutputPadding());
+                        oldOutput = &activationNode->output;
+                        newOutput = &newNode->output;
+                        return true;
+                    });
+                }
+
+                if (oldOutput == nullptr)
+                {
+                    return false;
+                }
+
+                plan.propagatedPorts[oldOutput] = newOutput;
+                if (plan.externalPorts.count(oldOutput) != 0)
+                {
+                    // consumers outside of the region still get the original layout
+                    const auto& restoredOutput = nodes::ReorderDataWithCodeNode(*newOutput, newOutput->GetMemoryLayout(), oldOutput->GetMemoryLayout());
+                    transformer.MapNodeOutput(*oldOutput, restoredOutput);
+                }
+                else
+                {
+                    transformer.MapNodeOutput(*oldOutput, *newOutput);
+                }
+                return true;
+            }
+
+            // Replaces a reorder node leaving a region with one that reads the propagated layout
+            template <typename ValueType>
+            bool TryRetargetExitNode(const Node& node, PropagationPlan& plan, ModelTransformer& transformer)
+            {
+                auto reorderNode = dynamic_cast<const ReorderDataCodeNode<ValueType>*>(&node);
+                if (reorderNode == nullptr)
+                {
+                    return false;
+                }
+
+                const auto& newInput = *GetPropagatedPort<ValueType>(plan, reorderNode->input.GetReferencedPort());
+                auto inputLayout = newInput.GetMemoryLayout();
+                auto outputLayout = reorderNode->GetOutputMemoryLayout();
+                if (inputLayout == outputLayout)
+                {
+                    transformer.MapNodeOutput(reorderNode->output, newInput);
+                }
+                else
+                {
+                    const auto& reorderedInput = nodes::ReorderDataWithCodeNode(newInput, inputLayout, outputLayout, reorderNode->GetPaddingValue());
+                    transformer.MapNodeOutput(reorderNode->output, reorderedInput);
+                }
+                return true;
+            }
+
+            bool IsClaimed(const Node& node) const
+            {
+                return _claimedNodes.count(&node) != 0;
+            }
+
+            size_t GetReorderBytesSaved() const { return _reorderBytesSaved; }
+
+        private:
+            std::unordered_set<const Node*> _claimedNodes;
+            size_t _reorderBytesSaved = 0;
+        };
+    } // namespace
+
+    model::Submodel PropagateLayoutsTransformation::Transform(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context) const
+    {
+        const model::MapCompiler* compiler = context.GetCompiler();
+        std::unordered_set<const OutputPortBase*> submodelOutputs(submodel.GetOutputs().begin(), submodel.GetOutputs().end());
+
+        // Plan all the regions before rewriting anything, so each node knows its role when the transformer visits it
+        LayoutPropagator propagator;
+        PropagationPlan plan;
+        submodel.Visit([&](const Node& node) {
+            if (propagator.IsClaimed(node))
+            {
+                return;
+            }
+            if (compiler && !compiler->GetModelOptimizerOptions(node).GetEntry<bool>("propagateLayouts", true))
+            {
+                return;
+            }
+            if (!propagator.TryPlanRegion<float>(node, submodelOutputs, plan))
+            {
+                propagator.TryPlanRegion<double>(node, submodelOutputs, plan);
+            }
+        });
+
+        auto onto = GetReferencedPorts(submodel.GetInputs());
+        auto destModel = submodel.GetModel().ShallowCopy();
+        auto result = transformer.TransformSubmodelOnto(submodel, destModel, onto, context, [&propagator, &plan](const Node& node, ModelTransformer& transformer) {
+            if (plan.sourceNodes.count(&node) != 0 || plan.regionNodes.count(&node) != 0)
+            {
+                if (propagator.TryPropagateNode<float>(node, plan, transformer) || propagator.TryPropagateNode<double>(node, plan, transformer))
+                {
+                    return;
+                }
+            }
+            else if (plan.exitNodes.count(&node) != 0)
+            {
+                if (propagator.TryRetargetExitNode<float>(node, plan, transformer) || propagator.TryRetargetExitNode<double>(node, plan, transformer))
+                {
+                    return;
+                }
+            }
+
+            transformer.CopyNode(node);
+        });
+
+        _reorderBytesSaved += propagator.GetReorderBytesSaved();
+        return result;
+    }
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizationCalibrator.cpp (passes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizationCalibrator.h"
+#include "QuantizeLayersTransformation.h"
+
+#include <model/include/TransformContext.h>
+
+#include <nodes/include/ConvolutionalLayerNode.h>
+#include <nodes/include/FullyConnectedLayerNode.h>
+#include <nodes/include/NeuralNetworkLayerNode.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ell
+{
+namespace passes
+{
+    namespace
+    {
+        bool IsNeuralNetworkPredictorNode(const model::Node& node)
+        {
+            return (node.GetRuntimeTypeName().find("NeuralNetworkPredictorNode") == 0);
+        }
+
+        template <typename ValueType>
+        bool IsQuantizableLayerNode(const model::Node& node)
+        {
+            return dynamic_cast<const nodes::FullyConnectedLayerNode<ValueType>*>(&node) != nullptr || dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node) != nullptr;
+        }
+
+        bool IsQuantizableLayerNode(const model::Node& node)
+        {
+            return IsQuantizableLayerNode<float>(node) || IsQuantizableLayerNode<double>(node);
+        }
+
+        template <typename ValueType>
+        bool TryGetInputRange(const model::Node& node, double& range)
+        {
+            auto thisNode = dynamic_cast<const nodes::NeuralNetworkLayerNodeBase<ValueType>*>(&node);
+            if (thisNode == nullptr)
+            {
+                return false;
+            }
+
+            for (auto value : thisNode->input.GetValue())
+            {
+                range = std::max(range, std::abs(static_cast<double>(value)));
+            }
+            return true;
+        }
+    } // namespace
+
+    QuantizationCalibrator::QuantizationCalibrator(model::Map& map) :
+        _map(map)
+    {
+        model::TransformContext refineNNPredictorContext{ [](const model::Node& node) {
+            return IsNeuralNetworkPredictorNode(node) ? model::NodeAction::refine : model::NodeAction::compile;
+        } };
+        _map.Refine(refineNNPredictorContext);
+
+        auto& model = _map.GetModel();
+        auto iter = model.GetNodeIterator();
+        while (iter.IsValid())
+        {
+            auto node = iter.Get();
+            if (IsQuantizableLayerNode(*node))
+            {
+                _layerNodes.push_back(model.GetNode(node->GetId()));
+            }
+            iter.Next();
+        }
+        _inputRanges.assign(_layerNodes.size(), 0.0);
+    }
+
+    void QuantizationCalibrator::UpdateRanges()
+    {
+        // after computing the map, each layer's input port still refers to the values it last saw
+        for (size_t index = 0; index < _layerNodes.size(); ++index)
+        {
+            TryGetInputRange<float>(*_layerNodes[index], _inputRanges[index]) || TryGetInputRange<double>(*_layerNodes[index], _inputRanges[index]);
+        }
+        ++_numExamples;
+    }
+
+    void QuantizationCalibrator::WriteRangesToMetadata()
+    {
+        if (_numExamples == 0)
+        {
+            return;
+        }
+
+        for (size_t index = 0; index < _layerNodes.size(); ++index)
+        {
+            _layerNodes[index]->GetMetadata().SetEntry(quantizationInputRangeMetadataKey, _inputRanges[index]);
+        }
+    }
+} // namespace passes
+} // namespace ell
@@ -0,0 +1,365 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizeLayersTransformation.cpp (passes)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizeLayersTransformation.h"
+#include "LayerEpilogue.h"
+
+#include <model/include/MapCompiler.h>
+#include <model/include/ModelTransformer.h>
+
+#include <nodes/include/ConvolutionalLayerNode.h>
+#include <nodes/include/FullyConnectedLayerNode.h>
+#include <nodes/include/NeuralNetworkLayerNode.h>
+#include <nodes/include/QuantizedConvolutionNode.h>
+
+#include <predictors/neural/include/LeakyReLUActivation.h>
+#include <predictors/neural/include/ReLUActivation.h>
+
+#include <utilities/include/Logger.h>
+#include <utilities/include/StlVectorUtil.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace ell
+{
+namespace passes
+{
+    using namespace model;
+    using namespace utilities::logging;
+    using utilities::logging::Log;
+
+    namespace
+    {
+        // the value that the largest magnitude in a filter (or in an input range) maps to
+        constexpr double maxQuantizedValue = 127.0;
+
+        template <typename Container, typename Function>
+        auto Transform(const Container& container, Function fn)
+        {
+            return utilities::TransformVector(container.begin(), container.end(), fn);
+        }
+
+        std::vector<const OutputPortBase*> GetReferencedPorts(const std::vector<const InputPortBase*>& inputs)
+        {
+            return Transform(inputs, [](auto input) { return &input->GetReferencedPort(); });
+        }
+
+        double GetQuantizationScale(double range)
+        {
+            return range > 0 ? range / maxQuantizedValue : 1.0;
+        }
+
+        double GetInputRange(const Node& node)
+        {
+            return node.GetMetadata().GetEntry<double>(quantizationInputRangeMetadataKey);
+        }
+
+        // A layer seen as a convolution, along with the operations after it that the quantized node computes
+        template <typename ValueType>
+        struct QuantizableLayer
+        {
+            const InputPort<ValueType>* input = nullptr;
+            PortMemoryLayout inputLayout;
+            int filterRows = 0;
+            int filterColumns = 0;
+            int stride = 1;
+            int padding = 0;
+            int numFilters = 0;
+            std::vector<double> weights; // the weights of each filter, in (row, column, channel) order over its receptive field
+            LayerEpilogue<ValueType> epilogue;
+            const OutputPort<ValueType>* output = nullptr; // the output of the layer, or of its epilogue
+        };
+
+        template <typename ValueType>
+        bool IsQuantizableActivation(const predictors::neural::ActivationImpl<ValueType>* activation)
+        {
+            using namespace predictors::neural;
+            return dynamic_cast<const ReLUActivation<ValueType>*>(activation) != nullptr ||
+                   dynamic_cast<const LeakyReLUActivation<ValueType>*>(activation) != nullptr;
+        }
+
+        template <typename ValueType>
+        bool TryGetConvolutionalLayer(const Node& node, QuantizableLayer<ValueType>& quantizableLayer)
+        {
+            auto thisNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node);
+            if (thisNode == nullptr)
+            {
+                return false;
+            }
+
+            const auto& layer = thisNode->GetLayer();
+            const auto& inputLayout = thisNode->GetInputMemoryLayout();
+            const auto& weights = layer.GetWeights();
+            const auto receptiveField = layer.GetConvolutionalParameters().receptiveField;
+            if (layer.IsDepthwiseSeparable() || static_cast<int>(weights.NumChannels()) != inputLayout.GetLogicalDimensionActiveSize(2))
+            {
+                return false;
+            }
+
+            quantizableLayer.input = &thisNode->input;
+            quantizableLayer.inputLayout = inputLayout;
+            quantizableLayer.filterRows = static_cast<int>(receptiveField);
+            quantizableLayer.filterColumns = static_cast<int>(receptiveField);
+            quantizableLayer.stride = static_cast<int>(layer.GetConvolutionalParameters().stride);
+            quantizableLayer.padding = static_cast<int>(layer.GetLayerParameters().inputPaddingParameters.paddingSize);
+            quantizableLayer.numFilters = static_cast<int>(weights.NumRows() / receptiveField);
+            quantizableLayer.output = &thisNode->output;
+
+            // the weights of filter f are rows [f * receptiveField, (f + 1) * receptiveField)
+            quantizableLayer.weights.clear();
+            for (size_t row = 0; row < weights.NumRows(); ++row)
+            {
+                for (size_t column = 0; column < weights.NumColumns(); ++column)
+                {
+                    for (size_t channel = 0; channel < weights.NumChannels(); ++channel)
+                    {
+                        quantizableLayer.weights.push_back(static_cast<double>(weights(row, column, channel)));
+                    }
+                }
+            }
+            return true;
+        }
+
+        template <typename ValueType>
+        bool TryGetFullyConnectedLayer(const Node& node, QuantizableLayer<ValueType>& quantizableLayer)
+        {
+            auto thisNode = dynamic_cast<const nodes::FullyConnectedLayerNode<ValueType>*>(&node);
+            if (thisNode == nullptr)
+            {
+                return false;
+            }
+
+            // The receptive field is the input's active area, or its whole memory if the weights cover the padding too
+            const auto& inputLayout = thisNode->GetInputMemoryLayout();
+            const auto& weights = thisNode->GetLayer().GetWeights();
+            const auto numColumns = weights.NumColumns();
+            if (numColumns == inputLayout.NumElements())
+            {
+                quantizableLayer.filterRows = inputLayout.GetLogicalDimensionActiveSize(0);
+                quantizableLayer.filterColumns = inputLayout.GetLogicalDimensionActiveSize(1);
+                quantizableLayer.padding = 0;
+            }
+            else if (numColumns == inputLayout.GetMemorySize() &&
+                     inputLayout.GetLogicalDimensionOffset(0) == inputLayout.GetLogicalDimensionOffset(1) &&
+                     inputLayout.GetLogicalDimensionExtent(2) == inputLayout.GetLogicalDimensionActiveSize(2))
+            {
+                quantizableLayer.filterRows = inputLayout.GetLogicalDimensionExtent(0);
+                quantizableLayer.filterColumns = inputLayout.GetLogicalDimensionExtent(1);
+                quantizableLayer.padding = inputLayout.GetLogicalDimensionOffset(0);
+            }
+            else
+            {
+                return false;
+            }
+
+            quantizableLayer.input = &thisNode->input;
+            quantizableLayer.inputLayout = inputLayout;
+            quantizableLayer.stride = 1;
+            quantizableLayer.numFilters = static_cast<int>(weights.NumRows());
+            quantizableLayer.output = &thisNode->output;
+
+            quantizableLayer.weights.clear();
+            for (size_t row = 0; row < weights.NumRows(); ++row)
+            {
+                for (size_t column = 0; column < numColumns; ++column)
+                {
+                    quantizableLayer.weights.push_back(static_cast<double>(weights(row, column)));
+                }
+            }
+            return true;
+        }
+
+        // The quantized node leaves padding in its output at zero
+        template <typename ValueType>
+        bool HasZeroPadding(const OutputPort<ValueType>& output)
+        {
+            if (!output.GetMemoryLayout().HasPadding())
+            {
+                return true;
+            }
+            auto layerNode = dynamic_cast<const nodes::NeuralNetworkLayerNodeBase<ValueType>*>(output.GetNode());
+            return layerNode != nullptr && layerNode->GetRequestedOutputPadding().paddingScheme == predictors::neural::PaddingScheme::zeros;
+        }
+
+        // returns 'true' if the node is a layer that can be quantized, along with the nodes after it
+        template <typename ValueType>
+        bool TryGetQuantizableLayer(const Submodel& submodel, const Node& node, const MapCompiler* compiler, QuantizableLayer<ValueType>& quantizableLayer)
+        {
+            bool isEnabled = compiler == nullptr || compiler->GetModelOptimizerOptions(node).GetEntry<bool>(quantizeLayersOption, false);
+            if (!isEnabled || !node.GetMetadata().HasEntry(quantizationInputRangeMetadataKey))
+            {
+                return false;
+            }
+
+            if (!TryGetConvolutionalLayer(node, quantizableLayer) && !TryGetFullyConnectedLayer(node, quantizableLayer))
+            {
+                return false;
+            }
+
+            if (quantizableLayer.numFilters < 1 || quantizableLayer.input->Size() != quantizableLayer.inputLayout.GetMemorySize())
+            {
+                return false;
+            }
+
+            quantizableLayer.epilogue = GetLayerEpilogue<ValueType>(submodel, node, *quantizableLayer.output, IsQuantizableActivation<ValueType>);
+            if (quantizableLayer.epilogue.output != nullptr)
+            {
+                quantizableLayer.output = quantizableLayer.epilogue.output;
+            }
+            return HasZeroPadding(*quantizableLayer.output);
+        }
+
+        bool CanQuantizeLayer(const Submodel& submodel, const Node& node, const MapCompiler* compiler)
+        {
+            QuantizableLayer<float> floatLayer;
+            QuantizableLayer<double> doubleLayer;
+            return TryGetQuantizableLayer(submodel, node, compiler, floatLayer) || TryGetQuantizableLayer(submodel, node, compiler, doubleLayer);
+        }
+
+        template <typename ValueType>
+        nodes::QuantizedWeights<ValueType> GetQuantizedWeights(const QuantizableLayer<ValueType>& layer, double inputScale, double outputScale)
+        {
+            using namespace predictors::neural;
+
+            const auto& epilogue = layer.epilogue;
+            const int numFilters = layer.numFilters;
+            const int fieldSize = static_cast<int>(layer.weights.size()) / numFilters;
+            const auto numChannels = static_cast<int>(std::max(epilogue.scale.size(), epilogue.bias.size()));
+
+            nodes::QuantizedWeights<ValueType> result;
+            result.weights.resize(layer.weights.size());
+            result.inputScale = static_cast<ValueType>(inputScale);
+            result.outputScales.resize(numFilters);
+            result.bias.resize(numFilters);
+            for (int filter = 0; filter < numFilters; ++filter)
+            {
+                auto filterWeights = layer.weights.begin() + filter * fieldSize;
+                double filterRange = 0;
+                std::for_each(filterWeights, filterWeights + fieldSize, [&filterRange](double weight) { filterRange = std::max(filterRange, std::abs(weight)); });
+
+                auto filterScale = GetQuantizationScale(filterRange);
+                std::transform(filterWeights, filterWeights + fieldSize, result.weights.begin() + filter * fieldSize, [filterScale](double weight) { return nodes::QuantizeToInt8(weight / filterScale); });
+
+                // fold the dequantization of both operands and the epilogue's scale into a single multiply per output;
+                // output f is in channel (f % numChannels)
+                const auto channel = numChannels > 0 ? filter % numChannels : 0;
+                const auto epilogueScale = epilogue.scale.empty() ? 1.0 : static_cast<double>(epilogue.scale[channel]);
+                result.outputScales[filter] = static_cast<ValueType>(inputScale * filterScale * epilogueScale);
+                result.bias[filter] = epilogue.bias.empty() ? 0 : epilogue.bias[channel];
+            }
+
+            if (dynamic_cast<const ReLUActivation<ValueType>*>(epilogue.activation) != nullptr)
+            {
+                result.negativeSlope = 0;
+            }
+            else if (auto leakyReLU = dynamic_cast<const LeakyReLUActivation<ValueType>*>(epilogue.activation))
+            {
+                result.negativeSlope = leakyReLU->GetLeakyFactor();
+            }
+            result.outputQuantizationScale = static_cast<ValueType>(outputScale);
+            return result;
+        }
+
+        template <typename ValueType, typename InputValueType>
+        Node* AddQuantizedConvolutionNode(const OutputPortBase& newInput, const QuantizableLayer<ValueType>& layer, bool quantizeOutput, const nodes::QuantizedWeights<ValueType>& weights, ModelTransformer& transformer)
+        {
+            const auto& input = static_cast<const OutputPort<InputValueType>&>(newInput);
+            const auto& outputLayout = layer.output->GetMemoryLayout();
+            if (quantizeOutput)
+            {
+                return transformer.AddNode<nodes::QuantizedConvolutionNode<ValueType, InputValueType, int8_t>>(input, layer.inputLayout, outputLayout, layer.filterRows, layer.filterColumns, layer.stride, layer.padding, weights);
+            }
+            return transformer.AddNode<nodes::QuantizedConvolutionNode<ValueType, InputValueType, ValueType>>(input, layer.inputLayout, outputLayout, layer.filterRows, layer.filterColumns, layer.stride, layer.padding, weights);
+        }
+
+        // returns 'true' if we handled the situation, else 'false'. If we return 'false', keep trying other ValueTypes.
+        template <typename ValueType>
+        bool TryQuantizeLayer(const Submodel& submodel, const Node& node, const MapCompiler* compiler, ModelTransformer& transformer, std::unordered_map<const OutputPortBase*, double>& quantizedOutputScales, std::set<const Node*>& fusedNodes)
+        {
+            QuantizableLayer<ValueType> layer;
+            if (!TryGetQuantizableLayer(submodel, node, compiler, layer))
+            {
+                return false;
+            }
+
+            // Read int8 values if the layer before this one writes them, else quantize the input with its calibrated range
+            const auto& inputPort = layer.input->GetReferencedPort();
+            auto quantizedInput = quantizedOutputScales.find(&inputPort);
+            const bool isInputQuantized = quantizedInput != quantizedOutputScales.end();
+            const double inputScale = isInputQuantized ? quantizedInput->second : GetQuantizationScale(GetInputRange(node));
+
+            // Write int8 values if every layer that reads them is quantized, scaled so that they hold all of those layers' inputs
+            const auto& output = *layer.output;
+            const auto& references = output.GetReferences();
+            const bool quantizeOutput = !references.empty() && !IsSubmodelOutput(submodel, output) && std::all_of(references.begin(), references.end(), [&](const InputPortBase* reference) {
+                return CanQuantizeLayer(submodel, *reference->GetNode(), compiler);
+            });
+            double outputRange = 0;
+            if (quantizeOutput)
+            {
+                for (auto reference : references)
+                {
+                    outputRange = std::max(outputRange, GetInputRange(*reference->GetNode()));
+                }
+            }
+            const double outputScale = GetQuantizationScale(outputRange);
+
+            auto weights = GetQuantizedWeights(layer, inputScale, outputScale);
+            const auto& newInput = transformer.GetCorrespondingOutputs(inputPort);
+            auto newNode = isInputQuantized ? AddQuantizedConvolutionNode<ValueType, int8_t>(newInput, layer, quantizeOutput, weights, transformer) : AddQuantizedConvolutionNode<ValueType, ValueType>(newInput, layer, quantizeOutput, weights, transformer);
+            newNode->GetMetadata() = node.GetMetadata();
+
+            Log() << "Quantizing layer node " << node.GetId() << " with " << layer.epilogue.fusedNodes.size() << " following nodes, input range " << inputScale * maxQuantizedValue << (isInputQuantized ? " (int8)" : "") << (quantizeOutput ? ", int8 output" : "") << EOL;
+            transformer.MapNodeOutput(output, *newNode->GetOutputPort(0));
+            if (quantizeOutput)
+            {
+                quantizedOutputScales[&output] = outputScale;
+            }
+            fusedNodes.insert(layer.epilogue.fusedNodes.begin(), layer.epilogue.fusedNodes.end());
+            return true;
+        }
+
+        void QuantizeLayer(const Submodel& submodel, const Node& node, const MapCompiler* compiler, ModelTransformer& transformer, std::unordered_map<const OutputPortBase*, double>& quantizedOutputScales, std::set<const Node*>& fusedNodes)
+        {
+            if (fusedNodes.find(&node) != fusedNodes.end())
+            {
+                // already folded into the layer before it
+                return;
+            }
+
+            if (TryQuantizeLayer<float>(submodel, node, compiler, transformer, quantizedOutputScales, fusedNodes) ||
+                TryQuantizeLayer<double>(submodel, node, compiler, transformer, quantizedOutputScales, fusedNodes))
+            {
+                return;
+            }
+
+            transformer.CopyNode(node);
+        }
+    } // namespace
+
+    //
+    // QuantizeLayersTransformation methods
+    //
+    Submodel QuantizeLayersTransformation::Transform(const Submodel& submodel, ModelTransformer& transformer, const TransformContext& context) const
+    {
+        // when run by the compiler, only quantize layers whose options ask for it
+        auto compiler = context.GetCompiler();
+        std::unordered_map<const OutputPortBase*, double> quantizedOutputScales;
+        std::set<const Node*> fusedNodes;
+        auto onto = transformer.GetCorrespondingOutputs(GetReferencedPorts(submodel.GetInputs()));
+        model::Model destModel = submodel.GetModel().ShallowCopy();
+        return transformer.TransformSubmodelOnto(submodel, destModel, onto, context, [&](const Node& node, ModelTransformer& transformer) {
+            QuantizeLayer(submodel, node, compiler, transformer, quantizedOutputScales, fusedNodes);
+        });
+    }
+} // namespace passes
+} // namespace ell
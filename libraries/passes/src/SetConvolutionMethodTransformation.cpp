@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "SetConvolutionMethodTransformation.h"
+#include "ConvolutionMethodAutotuner.h"
 
 #include <model/include/ModelTransformer.h>
 #include <model/include/RefineTransformation.h>
@@ -87,7 +88,7 @@ namespace passes
 
         // returns 'true' if we handled the situation, else 'false'. If we return 'false', keep trying other ValueTypes.
         template <typename ValueType>
-        bool TrySetConvolutionMethod(const model::Node& node, model::ModelTransformer& transformer, model::PreferredConvolutionMethod preferredMethod)
+        bool TrySetConvolutionMethod(const model::Node& node, model::ModelTransformer& transformer, model::PreferredConvolutionMethod preferredMethod, const utilities::PropertyBag& metadata)
         {
             auto thisNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node);
             if (thisNode == nullptr)
@@ -112,22 +113,38 @@ namespace passes
 
             // TODO: just copy the node and modify its layer
             auto newNode = transformer.AddNode<nodes::ConvolutionalLayerNode<ValueType>>(newInput, newLayer);
-            newNode->GetMetadata() = node.GetMetadata();
+            newNode->GetMetadata() = metadata;
 
             Log() << "Setting convolution method to " << static_cast<int>(method) << " for node " << thisNode->GetId() << std::endl;
             transformer.MapNodeOutput(thisNode->output, newNode->output);
             return true;
         }
 
-        void SetConvolutionMethod(const model::Node& node, model::ModelTransformer& transformer, model::PreferredConvolutionMethod preferredMethod)
+        void SetConvolutionMethod(const model::Node& node, model::ModelTransformer& transformer, model::PreferredConvolutionMethod preferredMethod, const model::MapCompiler* compiler)
         {
+            auto metadata = node.GetMetadata();
+            if (preferredMethod == model::PreferredConvolutionMethod::autotune)
+            {
+                // record the choice on the new node, so that it is reused if the node is saved and compiled again
+                ConvolutionMethodChoice choice;
+                if (IsConvolutionalLayerNode(node) && ConvolutionMethodAutotuner::GetGlobalAutotuner().TryTune(node, compiler->GetMapCompilerOptions(node), choice))
+                {
+                    preferredMethod = choice.method;
+                    SetConvolutionMethodChoice(choice, metadata);
+                }
+                else
+                {
+                    preferredMethod = model::PreferredConvolutionMethod::automatic;
+                }
+            }
+
             if (preferredMethod != model::PreferredConvolutionMethod::automatic)
             {
-                if (TrySetConvolutionMethod<float>(node, transformer, preferredMethod))
+                if (TrySetConvolutionMethod<float>(node, transformer, preferredMethod, metadata))
                 {
                     return;
                 }
-                if (TrySetConvolutionMethod<double>(node, transformer, preferredMethod))
+                if (TrySetConvolutionMethod<double>(node, transformer, preferredMethod, metadata))
                 {
                     return;
                 }
@@ -165,7 +182,7 @@ namespace passes
                 preferredMethod = compiler->GetModelOptimizerOptions(node).GetEntry<PreferredConvolutionMethod>("preferredConvolutionMethod", PreferredConvolutionMethod::automatic);
             }
 
-            SetConvolutionMethod(node, transformer, preferredMethod);
+            SetConvolutionMethod(node, transformer, preferredMethod, compiler);
         });
 
         // Finally, refine any ConvolutionalLayerNodes
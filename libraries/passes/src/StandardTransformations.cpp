@@ -8,8 +8,11 @@
 
 #include "DetectLowPrecisionConvolutionTransformation.h"
 #include "StandardTransformations.h"
+#include "FuseLayerOperationsTransformation.h"
 #include "FuseLinearOperationsTransformation.h"
 #include "OptimizeReorderDataNodesTransformation.h"
+#include "PropagateLayoutsTransformation.h"
+#include "QuantizeLayersTransformation.h"
 #include "SetConvolutionMethodTransformation.h"
 
 #include <model/include/RefineTransformation.h>
@@ -34,10 +37,15 @@ namespace passes
         if (!done)
         {
             registry.AddTransformation<DetectLowPrecisionConvolutionTransformation>();
+            // quantizing and fusing have to see the layer nodes before SetConvolutionMethodTransformation refines them,
+            // and quantizing folds the operations after a layer into it before fusing can
+            registry.AddTransformation<QuantizeLayersTransformation>();
+            registry.AddTransformation<FuseLayerOperationsTransformation>();
             registry.AddTransformation<SetConvolutionMethodTransformation>();
             registry.AddTransformation<model::RefineTransformation>();
             registry.AddTransformation<FuseLinearOperationsTransformation>();
             registry.AddTransformation<OptimizeReorderDataNodesTransformation>();
+            registry.AddTransformation<PropagateLayoutsTransformation>();
             done = true;
         }
     }
@@ -16,3 +16,4 @@ void TestOptimizeReorderDataNodes3();
 void TestOptimizeReorderDataNodes4();
 
 void TestSetConvolutionMethodPass();
+void TestFuseLayerOperationsPass();
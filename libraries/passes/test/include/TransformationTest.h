@@ -16,4 +16,8 @@ void TestTransformations();
 
 void TestFuseLinearOperationsTransformation();
 void TestSetConvolutionMethodTransformation();
+void TestAutotuneConvolutionMethods();
 void TestOptimizeReorderDataNodesTransformation();
+void TestPropagateLayoutsTransformation();
+void TestQuantizeLayersTransformation();
+void TestFuseLayerOperationsTransformation();
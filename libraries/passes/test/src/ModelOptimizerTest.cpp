@@ -13,6 +13,8 @@
 #include <model/include/OptimizeModelTransformation.h>
 #include <model/include/PortMemoryLayout.h>
 
+#include <nodes/include/ActivationLayerNode.h>
+#include <nodes/include/BatchNormalizationLayerNode.h>
 #include <nodes/include/BroadcastFunctionNode.h>
 #include <nodes/include/ConstantNode.h>
 #include <nodes/include/ConvolutionalLayerNode.h>
@@ -21,9 +23,10 @@
 
 #include <passes/include/StandardTransformations.h>
 
+#include <predictors/neural/include/ActivationLayer.h>
+#include <predictors/neural/include/BatchNormalizationLayer.h>
 #include <predictors/neural/include/ConvolutionalLayer.h>
-
-#include <predictors/neural/include/ConvolutionalLayer.h>
+#include <predictors/neural/include/ReLUActivation.h>
 
 #include <testing/include/testing.h>
 
@@ -490,3 +493,79 @@ void TestSetConvolutionMethodPass()
     TestSetConvolutionMethodPass(model::PreferredConvolutionMethod::winograd, "WinogradConvolutionComputeNode<float>");
     TestSetConvolutionMethodPass(model::PreferredConvolutionMethod::unrolled, "ReceptiveFieldMatrixNode<float>");
 }
+
+void TestFuseLayerOperationsPass()
+{
+    using namespace predictors::neural;
+
+    using ElementType = float;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using VectorType = typename Layer<ElementType>::VectorType;
+    using Shape = typename Layer<ElementType>::Shape;
+
+    const size_t numRows = 4;
+    const size_t numColumns = 4;
+    const size_t numChannels = 2;
+    const size_t numFilters = 3;
+    const size_t inputPaddingSize = 1;
+    TensorType inputWithPadding(numRows + 2 * inputPaddingSize, numColumns + 2 * inputPaddingSize, numChannels);
+    Shape outputShape = { numRows, numColumns, numFilters };
+
+    // convolution -> batch normalization -> ReLU
+    LayerParameters convolutionParameters{ inputWithPadding, ZeroPadding(inputPaddingSize), outputShape, NoPadding() };
+    ConvolutionalParameters convolutionalParams{ 3, 1, ConvolutionMethod::automatic, 2 };
+    TensorType weights(convolutionalParams.receptiveField * numFilters, convolutionalParams.receptiveField, numChannels);
+    weights.Generate(Increment<ElementType>(-1.0f, 0.0625f));
+    ConvolutionalLayer<ElementType> convolutionalLayer(convolutionParameters, convolutionalParams, weights);
+
+    LayerParameters batchNormParameters{ convolutionalLayer.GetOutput(), NoPadding(), outputShape, NoPadding() };
+    VectorType mean({ 0.5f, -1.0f, 2.0f });
+    VectorType variance({ 1.0f, 4.0f, 0.25f });
+    BatchNormalizationLayer<ElementType> batchNormLayer(batchNormParameters, mean, variance, 1.0e-6f, EpsilonSummand::SqrtVariance);
+
+    LayerParameters activationParameters{ batchNormLayer.GetOutput(), NoPadding(), outputShape, NoPadding() };
+    ActivationLayer<ElementType> activationLayer(activationParameters, Activation<ElementType>(new ReLUActivation<ElementType>()));
+
+    // Create model
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(inputWithPadding.Size());
+    auto convolutionNode = model.AddNode<nodes::ConvolutionalLayerNode<ElementType>>(inputNode->output, convolutionalLayer);
+    auto batchNormNode = model.AddNode<nodes::BatchNormalizationLayerNode<ElementType>>(convolutionNode->output, batchNormLayer);
+    auto activationNode = model.AddNode<nodes::ActivationLayerNode<ElementType>>(batchNormNode->output, activationLayer);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", activationNode->output } });
+
+    // Generate test data, with zeros in the padding
+    TensorType testInputTensor(numRows + 2 * inputPaddingSize, numColumns + 2 * inputPaddingSize, numChannels);
+    testInputTensor.GetSubTensor({ inputPaddingSize, inputPaddingSize, 0 }, { numRows, numColumns, numChannels }).Generate(Increment<ElementType>(-2.0f, 0.125f));
+    auto testInput = testInputTensor.ToArray();
+
+    map.SetInputValue("input", testInput);
+    auto referenceOutput = map.ComputeOutput<ElementType>("output");
+
+    // Initialize transformation registry
+    passes::AddStandardTransformationsToRegistry();
+
+    // Compile it through the standard transformations, with and without fusing the layers
+    model::MapCompilerOptions settings;
+    model::ModelOptimizerOptions optimizerOptions;
+    model::IRMapCompiler compiler(settings, optimizerOptions);
+    auto compiledMap = compiler.Compile(map);
+
+    model::ModelOptimizerOptions unfusedOptimizerOptions;
+    unfusedOptimizerOptions["fuseLayerOperations"] = false;
+    model::IRMapCompiler unfusedCompiler(settings, unfusedOptimizerOptions);
+    auto unfusedCompiledMap = unfusedCompiler.Compile(map);
+
+#if PRINT_MODELS
+    PrintModel(compiledMap.GetModel());
+    PrintModel(unfusedCompiledMap.GetModel());
+#endif
+
+    testing::ProcessTest("Testing FuseLayerOperationsPass fuses the layers before the convolution is refined", compiledMap.GetModel().Size() < unfusedCompiledMap.GetModel().Size());
+
+    // Evaluate the compiled model
+    compiledMap.SetInputValue("input", testInput);
+    auto compiledOutput = compiledMap.ComputeOutput<ElementType>("output");
+    testing::ProcessTest("Testing FuseLayerOperationsPass compiled result", testing::IsEqual(referenceOutput, compiledOutput, 1.0e-4f));
+}
@@ -8,26 +8,50 @@
 
 #include "TransformationTest.h"
 
+#include <passes/include/ConvolutionMethodAutotuner.h>
+#include <passes/include/FuseLayerOperationsTransformation.h>
 #include <passes/include/FuseLinearOperationsTransformation.h>
 #include <passes/include/OptimizeReorderDataNodesTransformation.h>
+#include <passes/include/PropagateLayoutsTransformation.h>
+#include <passes/include/QuantizationCalibrator.h>
+#include <passes/include/QuantizeLayersTransformation.h>
 #include <passes/include/SetConvolutionMethodTransformation.h>
 
+#include <data/include/DenseDataVector.h>
+
+#include <model/include/IRCompiledMap.h>
+#include <model/include/IRMapCompiler.h>
 #include <model/include/InputNode.h>
 #include <model/include/TransformContext.h>
 #include <model/include/Transformation.h>
 
+#include <nodes/include/ActivationLayerNode.h>
+#include <nodes/include/BatchNormalizationLayerNode.h>
+#include <nodes/include/BiasActivationNode.h>
+#include <nodes/include/BinaryOperationNode.h>
+#include <nodes/include/BiasLayerNode.h>
 #include <nodes/include/BroadcastFunctionNode.h>
 #include <nodes/include/ConstantNode.h>
 #include <nodes/include/ConvolutionalLayerNode.h>
+#include <nodes/include/FullyConnectedLayerNode.h>
 #include <nodes/include/MatrixMatrixMultiplyNode.h>
+#include <nodes/include/QuantizedConvolutionNode.h>
 #include <nodes/include/ReorderDataCodeNode.h>
+#include <nodes/include/UnaryOperationNode.h>
 
+#include <predictors/neural/include/ActivationLayer.h>
+#include <predictors/neural/include/BatchNormalizationLayer.h>
+#include <predictors/neural/include/BiasLayer.h>
 #include <predictors/neural/include/ConvolutionalLayer.h>
+#include <predictors/neural/include/FullyConnectedLayer.h>
+#include <predictors/neural/include/ReLUActivation.h>
 
 #include <testing/include/testing.h>
 
 #include <utilities/include/JsonArchiver.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 #define PRINT_MODELS 0
@@ -62,6 +86,21 @@ bool HasNodeWithTypeName(const model::Model& model, std::string typeName)
     return false;
 }
 
+int CountNodesWithTypeName(const model::Model& model, std::string typeName)
+{
+    int count = 0;
+    auto iter = model.GetNodeIterator();
+    while (iter.IsValid())
+    {
+        if (iter.Get()->GetRuntimeTypeName() == typeName)
+        {
+            ++count;
+        }
+        iter.Next();
+    }
+    return count;
+}
+
 template <typename ValueType>
 auto Increment(ValueType start, ValueType inc = static_cast<ValueType>(1))
 {
@@ -129,7 +168,11 @@ void TestTransformations()
 {
     TestFuseLinearOperationsTransformation();
     TestSetConvolutionMethodTransformation();
+    TestAutotuneConvolutionMethods();
     TestOptimizeReorderDataNodesTransformation();
+    TestPropagateLayoutsTransformation();
+    TestQuantizeLayersTransformation();
+    TestFuseLayerOperationsTransformation();
 }
 
 void TestFuseLinearOperationsTransformation(std::vector<std::pair<bool, bool>> functionInfos)
@@ -291,6 +334,75 @@ void TestSetConvolutionMethodTransformation()
     TestSetConvolutionMethodTransformation(model::PreferredConvolutionMethod::unrolled, "UnrolledConvolutionNode<float>");
 }
 
+void TestAutotuneConvolutionMethods()
+{
+    using namespace predictors::neural;
+
+    using ElementType = float;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using TensorReferenceType = typename Layer<ElementType>::TensorReferenceType;
+    using Shape = typename Layer<ElementType>::Shape;
+
+    const size_t numRows = 8;
+    const size_t numColumns = 8;
+    const size_t numChannels = 4;
+    const size_t numFilters = 4;
+    const size_t inputPaddingSize = 1;
+    TensorType inputWithPadding(numRows + 2 * inputPaddingSize, numColumns + 2 * inputPaddingSize, numChannels);
+    TensorReferenceType input = inputWithPadding.GetSubTensor({ inputPaddingSize, inputPaddingSize, 0 }, { numRows, numColumns, numChannels });
+    Shape outputShape = { numRows, numColumns, numFilters };
+
+    LayerParameters parameters{ input, ZeroPadding(inputPaddingSize), outputShape, NoPadding() };
+    ConvolutionalParameters convolutionalParams{ 3, 1, ConvolutionMethod::automatic, 2 };
+
+    TensorType weights(convolutionalParams.receptiveField * numFilters, convolutionalParams.receptiveField, numChannels);
+    weights.Generate(Increment<ElementType>(-1.0f, 0.01f));
+    ConvolutionalLayer<ElementType> layer(parameters, convolutionalParams, weights);
+
+    // Create model
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(inputWithPadding.Size());
+    auto computeNode = model.AddNode<nodes::ConvolutionalLayerNode<ElementType>>(inputNode->output, layer);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", computeNode->output } });
+    auto untunedMap = map;
+
+    inputWithPadding.Fill(0);
+    input.Generate(Increment<ElementType>(0.0f, 0.01f));
+    auto testInput = inputWithPadding.ToArray();
+    map.SetInputValue("input", testInput);
+    auto referenceOutput = map.ComputeOutput<ElementType>("output");
+
+    // Tune the layer, and check that the choice is kept in its metadata
+    model::MapCompilerOptions settings;
+    auto numTuned = passes::TuneConvolutionMethods(map, settings);
+    auto numTunedAgain = passes::TuneConvolutionMethods(map, settings);
+    std::string chosenMethod;
+    auto iter = map.GetModel().GetNodeIterator();
+    while (iter.IsValid())
+    {
+        const auto& metadata = iter.Get()->GetMetadata();
+        if (metadata.HasEntry("compileOptions"))
+        {
+            chosenMethod = metadata.GetEntry<utilities::PropertyBag>("compileOptions").GetEntry<std::string>("preferredConvolutionMethod");
+        }
+        iter.Next();
+    }
+    testing::ProcessTest("Testing TuneConvolutionMethods", numTuned == 1 && numTunedAgain == 0 && !chosenMethod.empty() && chosenMethod != "autotune");
+
+    // The tuned map compiles with the chosen method, and so does an untuned one in autotune mode
+    model::ModelOptimizerOptions optimizerOptions;
+    optimizerOptions["preferredConvolutionMethod"] = model::PreferredConvolutionMethod::autotune;
+    for (const auto& mapToCompile : { map, untunedMap })
+    {
+        model::IRMapCompiler compiler(settings, optimizerOptions);
+        auto compiledMap = compiler.Compile(mapToCompile);
+        compiledMap.SetInputValue("input", testInput);
+        auto compiledOutput = compiledMap.ComputeOutput<ElementType>("output");
+        testing::ProcessTest("Testing autotuned convolution result", testing::IsEqual(referenceOutput, compiledOutput, 1.0e-2f));
+    }
+}
+
 void TestOptimizeReorderDataNodesTransformation1()
 {
     using ValueType = float;
@@ -470,3 +582,400 @@ void TestOptimizeReorderDataNodesTransformation()
     TestOptimizeReorderDataNodesTransformation3();
     TestOptimizeReorderDataNodesTransformation4();
 }
+
+void TestPropagateLayoutsTransformation1()
+{
+    using ValueType = float;
+    constexpr int m = 4, n = 6;
+
+    auto rowMajorLayout = model::PortMemoryLayout(model::MemoryShape{ m, n });
+    auto colMajorLayout = rowMajorLayout.ReorderedCopy(model::DimensionOrder{ 1, 0 });
+
+    // input -> (to column-major) -> abs -> add constant -> (to row-major) -> output
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(rowMajorLayout.GetActiveSize());
+    auto toColMajorNode = model.AddNode<nodes::ReorderDataCodeNode<ValueType>>(inputNode->output, rowMajorLayout, colMajorLayout);
+    auto absNode = model.AddNode<nodes::UnaryOperationNode<ValueType>>(toColMajorNode->output, nodes::UnaryOperationType::abs);
+    std::vector<ValueType> constantValues(m * n);
+    std::generate(constantValues.begin(), constantValues.end(), Increment<ValueType>(0.0f, 0.5f));
+    auto constantNode = model.AddNode<nodes::ConstantNode<ValueType>>(constantValues, colMajorLayout);
+    auto addNode = model.AddNode<nodes::BinaryOperationNode<ValueType>>(absNode->output, colMajorLayout, constantNode->output, colMajorLayout, colMajorLayout, nodes::BinaryOperationType::add);
+    auto toRowMajorNode = model.AddNode<nodes::ReorderDataCodeNode<ValueType>>(addNode->output, colMajorLayout, rowMajorLayout);
+
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", toRowMajorNode->output } });
+    auto oldSize = map.GetModel().Size();
+
+    passes::PropagateLayoutsTransformation propagateLayouts;
+    map.Transform(propagateLayouts);
+    map.Refine();
+    auto newSize = map.GetModel().Size();
+
+    std::vector<ValueType> input(m * n);
+    std::generate(input.begin(), input.end(), Increment<ValueType>(-5.0f, 0.75f));
+    std::vector<ValueType> expectedOutput(m * n);
+    for (int i = 0; i < m; ++i)
+    {
+        for (int j = 0; j < n; ++j)
+        {
+            expectedOutput[i * n + j] = std::abs(input[i * n + j]) + constantValues[j * m + i];
+        }
+    }
+    auto output = map.Compute<ValueType>(input);
+
+#if PRINT_MODELS
+    PrintModel(map.GetModel());
+#endif
+
+    testing::ProcessTest("Testing PropagateLayoutsTransformation removes reorders", oldSize == 6 && newSize == 4 && !HasNodeWithTypeName(map.GetModel(), nodes::ReorderDataCodeNode<ValueType>::GetTypeName()));
+    testing::ProcessTest("Testing PropagateLayoutsTransformation reports saved bytes", propagateLayouts.GetReorderBytesSaved() == 2 * m * n * sizeof(ValueType));
+    testing::ProcessTest("Testing PropagateLayoutsTransformation output", testing::IsEqual(output, expectedOutput));
+}
+
+void TestPropagateLayoutsTransformation2()
+{
+    using namespace predictors::neural;
+
+    using ElementType = float;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using VectorType = typename Layer<ElementType>::VectorType;
+    using Shape = typename Layer<ElementType>::Shape;
+
+    // depthwise convolution -> bias -> ReLU -> depthwise convolution, with padding between the layers
+    const size_t numRows = 4, numColumns = 5, numChannels = 3;
+    const size_t paddingSize = 1;
+    TensorType input(numRows + 2 * paddingSize, numColumns + 2 * paddingSize, numChannels);
+    Shape paddedShape = { numRows + 2 * paddingSize, numColumns + 2 * paddingSize, numChannels };
+    Shape outputShape = { numRows, numColumns, numChannels };
+    ConvolutionalParameters convolutionalParams{ 3, 1, ConvolutionMethod::simple, 1 };
+
+    TensorType weights(convolutionalParams.receptiveField * numChannels, convolutionalParams.receptiveField, 1);
+    weights.Generate(Increment<ElementType>(-1.0f, 0.125f));
+    LayerParameters conv1Parameters{ input, ZeroPadding(paddingSize), paddedShape, ZeroPadding(paddingSize) };
+    ConvolutionalLayer<ElementType> conv1Layer(conv1Parameters, convolutionalParams, weights);
+
+    LayerParameters biasParameters{ conv1Layer.GetOutput(), ZeroPadding(paddingSize), paddedShape, ZeroPadding(paddingSize) };
+    BiasLayer<ElementType> biasLayer(biasParameters, VectorType({ 1.0f, -2.0f, 0.5f }));
+
+    LayerParameters activationParameters{ biasLayer.GetOutput(), ZeroPadding(paddingSize), paddedShape, ZeroPadding(paddingSize) };
+    ActivationLayer<ElementType> activationLayer(activationParameters, Activation<ElementType>(new ReLUActivation<ElementType>()));
+
+    LayerParameters conv2Parameters{ activationLayer.GetOutput(), ZeroPadding(paddingSize), outputShape, NoPadding() };
+    ConvolutionalLayer<ElementType> conv2Layer(conv2Parameters, convolutionalParams, weights);
+
+    // Create model
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(input.Size());
+    auto conv1Node = model.AddNode<nodes::ConvolutionalLayerNode<ElementType>>(inputNode->output, conv1Layer);
+    auto biasNode = model.AddNode<nodes::BiasLayerNode<ElementType>>(conv1Node->output, biasLayer);
+    auto activationNode = model.AddNode<nodes::ActivationLayerNode<ElementType>>(biasNode->output, activationLayer);
+    auto conv2Node = model.AddNode<nodes::ConvolutionalLayerNode<ElementType>>(activationNode->output, conv2Layer);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", conv2Node->output } });
+
+    // The depthwise convolutions compute in channel-major order, so refining them leaves the bias and activation
+    // between a reorder to row-major and a reorder back to channel-major
+    map.Refine();
+    const auto reorderTypeName = nodes::ReorderDataCodeNode<ElementType>::GetTypeName();
+    auto oldReorderCount = CountNodesWithTypeName(map.GetModel(), reorderTypeName);
+
+    std::vector<ElementType> example(input.Size());
+    std::generate(example.begin(), example.end(), Increment<ElementType>(-2.0f, 0.0625f));
+    auto referenceOutput = map.Compute<ElementType>(example);
+
+    passes::PropagateLayoutsTransformation propagateLayouts;
+    map.Transform(propagateLayouts);
+    map.Prune();
+    auto newReorderCount = CountNodesWithTypeName(map.GetModel(), reorderTypeName);
+    auto output = map.Compute<ElementType>(example);
+
+#if PRINT_MODELS
+    PrintModel(map.GetModel());
+#endif
+
+    const size_t paddedBytes = paddedShape.NumRows() * paddedShape.NumColumns() * paddedShape.NumChannels() * sizeof(ElementType);
+    testing::ProcessTest("Testing PropagateLayoutsTransformation removes reorders around a refined convolution", oldReorderCount == 4 && newReorderCount == 2);
+    testing::ProcessTest("Testing PropagateLayoutsTransformation reports saved bytes for padded layouts", propagateLayouts.GetReorderBytesSaved() == 2 * paddedBytes);
+    testing::ProcessTest("Testing PropagateLayoutsTransformation output for a refined convolution", testing::IsEqual(output, referenceOutput, 1.0e-5f));
+}
+
+void TestPropagateLayoutsTransformation()
+{
+    TestPropagateLayoutsTransformation1();
+    TestPropagateLayoutsTransformation2();
+}
+
+void TestQuantizeLayersTransformation1()
+{
+    using namespace predictors::neural;
+
+    using ElementType = float;
+    using LayerType = FullyConnectedLayer<ElementType>;
+    using LayerParameters = typename LayerType::LayerParameters;
+    using TensorType = typename LayerType::TensorType;
+    using MatrixType = typename LayerType::MatrixType;
+    using Shape = typename LayerType::Shape;
+
+    const size_t numInputs = 16;
+    const size_t numOutputs = 4;
+    TensorType input(numInputs, 1, 1);
+    Shape outputShape = { numOutputs, 1, 1 };
+    LayerParameters parameters{ input, NoPadding(), outputShape, NoPadding() };
+
+    MatrixType weights(numOutputs, numInputs);
+    for (size_t i = 0; i < numOutputs; ++i)
+    {
+        for (size_t j = 0; j < numInputs; ++j)
+        {
+            weights(i, j) = static_cast<ElementType>(((i + 1) * (j + 3)) % 7) - 3.0f;
+        }
+    }
+    LayerType layer(parameters, weights);
+
+    // Create model
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(numInputs);
+    auto computeNode = model.AddNode<nodes::FullyConnectedLayerNode<ElementType>>(inputNode->output, layer);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", computeNode->output } });
+
+    std::vector<std::vector<ElementType>> examples;
+    for (int exampleIndex = 0; exampleIndex < 4; ++exampleIndex)
+    {
+        std::vector<ElementType> example(numInputs);
+        std::generate(example.begin(), example.end(), Increment<ElementType>(-1.0f + 0.1f * exampleIndex, 0.125f));
+        examples.push_back(example);
+    }
+
+    // Calibrate the input range of the layer
+    passes::QuantizationCalibrator calibrator(map);
+    for (const auto& example : examples)
+    {
+        calibrator.AddExample(data::FloatDataVector(example));
+    }
+    calibrator.WriteRangesToMetadata();
+
+    std::vector<std::vector<ElementType>> referenceOutputs;
+    for (const auto& example : examples)
+    {
+        referenceOutputs.push_back(map.Compute<ElementType>(example));
+    }
+
+    model::TransformContext context;
+    passes::QuantizeLayersTransformation quantize;
+    map.Transform(quantize, context);
+    map.Prune();
+
+#if PRINT_MODELS
+    PrintModel(map.GetModel());
+#endif
+
+    bool ok = calibrator.NumLayers() == 1 && HasNodeWithTypeName(map.GetModel(), nodes::QuantizedConvolutionNode<ElementType, ElementType, ElementType>::GetTypeName());
+    for (size_t index = 0; index < examples.size(); ++index)
+    {
+        // the rounding errors of the weights and inputs only add up to a few hundredths here
+        auto quantizedOutput = map.Compute<ElementType>(examples[index]);
+        ok = ok && testing::IsEqual(referenceOutputs[index], quantizedOutput, 0.1f);
+    }
+    testing::ProcessTest("Testing QuantizeLayersTransformation on a fully connected layer", ok);
+}
+
+void TestQuantizeLayersTransformation2()
+{
+    using namespace predictors::neural;
+
+    using ElementType = float;
+    using LayerParameters = typename Layer<ElementType>::LayerParameters;
+    using TensorType = typename Layer<ElementType>::TensorType;
+    using MatrixType = typename Layer<ElementType>::MatrixType;
+    using VectorType = typename Layer<ElementType>::VectorType;
+    using Shape = typename Layer<ElementType>::Shape;
+
+    // padded convolution -> bias -> ReLU -> fully connected
+    const size_t numRows = 4, numColumns = 5, numChannels = 3, numFilters = 4, numOutputs = 3;
+    const size_t paddingSize = 1;
+    TensorType input(numRows + 2 * paddingSize, numColumns + 2 * paddingSize, numChannels);
+    Shape convolutionOutputShape = { numRows, numColumns, numFilters };
+    ConvolutionalParameters convolutionalParams{ 3, 1, ConvolutionMethod::simple, 1 };
+
+    TensorType convolutionWeights(convolutionalParams.receptiveField * numFilters, convolutionalParams.receptiveField, numChannels);
+    convolutionWeights.Generate(Increment<ElementType>(-1.0f, 0.0625f));
+    LayerParameters convolutionParameters{ input, ZeroPadding(paddingSize), convolutionOutputShape, NoPadding() };
+    ConvolutionalLayer<ElementType> convolutionLayer(convolutionParameters, convolutionalParams, convolutionWeights);
+
+    LayerParameters biasParameters{ convolutionLayer.GetOutput(), NoPadding(), convolutionOutputShape, NoPadding() };
+    BiasLayer<ElementType> biasLayer(biasParameters, VectorType({ 1.0f, -2.0f, 0.5f, 0.0f }));
+
+    LayerParameters activationParameters{ biasLayer.GetOutput(), NoPadding(), convolutionOutputShape, NoPadding() };
+    ActivationLayer<ElementType> activationLayer(activationParameters, Activation<ElementType>(new ReLUActivation<ElementType>()));
+
+    const size_t numFullyConnectedInputs = numRows * numColumns * numFilters;
+    MatrixType fullyConnectedWeights(numOutputs, numFullyConnectedInputs);
+    for (size_t i = 0; i < numOutputs; ++i)
+    {
+        for (size_t j = 0; j < numFullyConnectedInputs; ++j)
+        {
+            fullyConnectedWeights(i, j) = static_cast<ElementType>(((i + 1) * (j + 3)) % 7) / 16 - 0.1875f;
+        }
+    }
+    LayerParameters fullyConnectedParameters{ activationLayer.GetOutput(), NoPadding(), Shape{ numOutputs, 1, 1 }, NoPadding() };
+    FullyConnectedLayer<ElementType> fullyConnectedLayer(fullyConnectedParameters, fullyConnectedWeights);
+
+    // Create model
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(input.Size());
+    auto convolutionNode = model.AddNode<nodes::ConvolutionalLayerNode<ElementType>>(inputNode->output, convolutionLayer);
+    auto biasNode = model.AddNode<nodes::BiasLayerNode<ElementType>>(convolutionNode->output, biasLayer);
+    auto activationNode = model.AddNode<nodes::ActivationLayerNode<ElementType>>(biasNode->output, activationLayer);
+    auto fullyConnectedNode = model.AddNode<nodes::FullyConnectedLayerNode<ElementType>>(activationNode->output, fullyConnectedLayer);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", fullyConnectedNode->output } });
+
+    std::vector<std::vector<ElementType>> examples;
+    for (int exampleIndex = 0; exampleIndex < 4; ++exampleIndex)
+    {
+        // the padding of the input is zero, as the layer before the convolution would leave it
+        std::vector<ElementType> example(input.Size());
+        auto value = Increment<ElementType>(-1.0f + 0.1f * exampleIndex, 0.0625f);
+        for (size_t row = 0; row < numRows; ++row)
+        {
+            for (size_t column = 0; column < numColumns; ++column)
+            {
+                for (size_t channel = 0; channel < numChannels; ++channel)
+                {
+                    example[((row + paddingSize) * (numColumns + 2 * paddingSize) + column + paddingSize) * numChannels + channel] = value();
+                }
+            }
+        }
+        examples.push_back(example);
+    }
+
+    // Calibrate the input range of both layers
+    passes::QuantizationCalibrator calibrator(map);
+    for (const auto& example : examples)
+    {
+        calibrator.AddExample(data::FloatDataVector(example));
+    }
+    calibrator.WriteRangesToMetadata();
+
+    std::vector<std::vector<ElementType>> referenceOutputs;
+    ElementType outputRange = 0;
+    for (const auto& example : examples)
+    {
+        referenceOutputs.push_back(map.Compute<ElementType>(example));
+        for (auto value : referenceOutputs.back())
+        {
+            outputRange = std::max(outputRange, std::abs(value));
+        }
+    }
+
+    model::TransformContext context;
+    passes::QuantizeLayersTransformation quantize;
+    map.Transform(quantize, context);
+    map.Prune();
+
+#if PRINT_MODELS
+    PrintModel(map.GetModel());
+#endif
+
+    // the convolution folds in the bias and ReLU, and hands int8 values to the fully connected layer
+    bool ok = calibrator.NumLayers() == 2 &&
+              HasNodeWithTypeName(map.GetModel(), nodes::QuantizedConvolutionNode<ElementType, ElementType, int8_t>::GetTypeName()) &&
+              HasNodeWithTypeName(map.GetModel(), nodes::QuantizedConvolutionNode<ElementType, int8_t, ElementType>::GetTypeName()) &&
+              !HasNodeWithTypeName(map.GetModel(), nodes::BiasLayerNode<ElementType>::GetTypeName()) &&
+              !HasNodeWithTypeName(map.GetModel(), nodes::ActivationLayerNode<ElementType>::GetTypeName());
+    for (size_t index = 0; index < examples.size(); ++index)
+    {
+        // the rounding errors of two quantized layers stay within a few percent of the outputs' range
+        auto quantizedOutput = map.Compute<ElementType>(examples[index]);
+        ok = ok && testing::IsEqual(referenceOutputs[index], quantizedOutput, 0.05f * outputRange);
+    }
+    testing::ProcessTest("Testing QuantizeLayersTransformation on a convolution followed by a fully connected layer", ok);
+}
+
+void TestQuantizeLayersTransformation()
+{
+    TestQuantizeLayersTransformation1();
+    TestQuantizeLayersTransformation2();
+}
+
+void TestFuseLayerOperationsTransformation()
+{
+    using namespace predictors::neural;
+
+    using ElementType = float;
+    using LayerType = FullyConnectedLayer<ElementType>;
+    using LayerParameters = typename LayerType::LayerParameters;
+    using TensorType = typename LayerType::TensorType;
+    using MatrixType = typename LayerType::MatrixType;
+    using VectorType = typename LayerType::VectorType;
+    using Shape = typename LayerType::Shape;
+
+    const size_t numInputs = 16;
+    const size_t numOutputs = 4;
+    TensorType input(1, 1, numInputs);
+    Shape outputShape = { 1, 1, numOutputs };
+    LayerParameters parameters{ input, NoPadding(), outputShape, NoPadding() };
+
+    MatrixType weights(numOutputs, numInputs);
+    for (size_t i = 0; i < numOutputs; ++i)
+    {
+        for (size_t j = 0; j < numInputs; ++j)
+        {
+            weights(i, j) = static_cast<ElementType>(((i + 1) * (j + 3)) % 7) - 3.0f;
+        }
+    }
+    LayerType fullyConnectedLayer(parameters, weights);
+
+    // fully connected -> batch normalization -> bias -> ReLU
+    LayerParameters batchNormParameters{ fullyConnectedLayer.GetOutput(), NoPadding(), outputShape, NoPadding() };
+    VectorType mean({ 0.5f, -1.0f, 2.0f, 0.0f });
+    VectorType variance({ 1.0f, 4.0f, 0.25f, 2.0f });
+    BatchNormalizationLayer<ElementType> batchNormLayer(batchNormParameters, mean, variance, 1.0e-6f, EpsilonSummand::SqrtVariance);
+
+    LayerParameters biasParameters{ batchNormLayer.GetOutput(), NoPadding(), outputShape, NoPadding() };
+    BiasLayer<ElementType> biasLayer(biasParameters, VectorType({ 1.0f, -2.0f, 0.5f, -0.25f }));
+
+    LayerParameters activationParameters{ biasLayer.GetOutput(), NoPadding(), outputShape, NoPadding() };
+    ActivationLayer<ElementType> activationLayer(activationParameters, Activation<ElementType>(new ReLUActivation<ElementType>()));
+
+    // Create model
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(numInputs);
+    auto fullyConnectedNode = model.AddNode<nodes::FullyConnectedLayerNode<ElementType>>(inputNode->output, fullyConnectedLayer);
+    auto batchNormNode = model.AddNode<nodes::BatchNormalizationLayerNode<ElementType>>(fullyConnectedNode->output, batchNormLayer);
+    auto biasNode = model.AddNode<nodes::BiasLayerNode<ElementType>>(batchNormNode->output, biasLayer);
+    auto activationNode = model.AddNode<nodes::ActivationLayerNode<ElementType>>(biasNode->output, activationLayer);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", activationNode->output } });
+
+    std::vector<std::vector<ElementType>> examples;
+    std::vector<std::vector<ElementType>> referenceOutputs;
+    for (int exampleIndex = 0; exampleIndex < 4; ++exampleIndex)
+    {
+        std::vector<ElementType> example(numInputs);
+        std::generate(example.begin(), example.end(), Increment<ElementType>(-1.0f + 0.1f * exampleIndex, 0.125f));
+        examples.push_back(example);
+        referenceOutputs.push_back(map.Compute<ElementType>(example));
+    }
+
+    auto originalNodeCount = map.GetModel().Size();
+    model::TransformContext context;
+    passes::FuseLayerOperationsTransformation fuse;
+    map.Transform(fuse, context);
+    map.Prune();
+
+#if PRINT_MODELS
+    PrintModel(map.GetModel());
+#endif
+
+    // the bias and ReLU are applied by the fully connected layer itself, not by a node after it
+    auto fusedLayerNodes = map.GetModel().GetNodesByType<nodes::FullyConnectedLayerNode<ElementType>>();
+    bool ok = map.GetModel().Size() < originalNodeCount &&
+              !HasNodeWithTypeName(map.GetModel(), "BatchNormalizationLayerNode<float>") &&
+              !HasNodeWithTypeName(map.GetModel(), "ActivationLayerNode<float>") &&
+              !HasNodeWithTypeName(map.GetModel(), nodes::BiasActivationNode<ElementType, nodes::ReLUActivationFunction<ElementType>>::GetTypeName()) &&
+              fusedLayerNodes.size() == 1 && !fusedLayerNodes[0]->GetEpilogue().IsEmpty();
+    for (size_t index = 0; index < examples.size(); ++index)
+    {
+        auto fusedOutput = map.Compute<ElementType>(examples[index]);
+        ok = ok && testing::IsEqual(referenceOutputs[index], fusedOutput, 1.0e-4f);
+    }
+    testing::ProcessTest("Testing FuseLayerOperationsTransformation", ok);
+}
@@ -33,6 +33,7 @@ int main()
         TestOptimizeReorderDataNodes4();
 
         TestSetConvolutionMethodPass();
+        TestFuseLayerOperationsPass();
 
         // Test Transformations
         TestTransformations();
@@ -0,0 +1,214 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FlattenedForest.h (predictors)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ell
+{
+namespace predictors
+{
+    /// <summary>
+    /// A read-only copy of a forest of binary threshold trees (such as SimpleForestPredictor), laid out for fast
+    /// evaluation. The interior nodes are stored as parallel arrays of feature indices, thresholds, child indices,
+    /// and edge outputs, and keep the indices that they have in the original forest, so the two outgoing edges of
+    /// node i are edges 2i and 2i+1. All leaves point to a single sink node whose threshold is +infinity and whose
+    /// edges loop back to itself with zero output. This lets every tree be evaluated with a fixed number of
+    /// branch-free steps, `edge = 2 * node + (x[feature[node]] > threshold[node])`, and lets the batch functions
+    /// step several inputs through a tree in lockstep. The results are identical to ForestPredictor::Predict.
+    /// Float inputs are compared to thresholds rounded down to floats, which gives the same answers as comparing
+    /// them to the original thresholds; double inputs are compared to the original thresholds.
+    /// </summary>
+    class FlattenedForest
+    {
+    public:
+        /// <summary> Constructs an empty forest. </summary>
+        FlattenedForest() = default;
+
+        /// <summary> Constructs a flattened copy of a forest. </summary>
+        ///
+        /// <typeparam name="ForestType"> A ForestPredictor with SingleElementThresholdPredictor split rules and ConstantPredictor edges. </typeparam>
+        /// <param name="forest"> The forest. </param>
+        template <typename ForestType>
+        explicit FlattenedForest(const ForestType& forest);
+
+        /// <summary> Gets the number of trees. </summary>
+        ///
+        /// <returns> The number of trees. </returns>
+        size_t NumTrees() const { return _rootIndices.size(); }
+
+        /// <summary> Gets the number of edges. </summary>
+        ///
+        /// <returns> The number of edges. </returns>
+        size_t NumEdges() const { return 2 * NumInteriorNodes(); }
+
+        /// <summary> Gets the number of interior nodes. </summary>
+        ///
+        /// <returns> The number of interior nodes. </returns>
+        size_t NumInteriorNodes() const { return _featureIndices.empty() ? 0 : _featureIndices.size() - 1; }
+
+        /// <summary> Gets the minimal input size, which is one plus the largest feature index used by a split rule. </summary>
+        ///
+        /// <returns> The input size. </returns>
+        size_t GetInputSize() const { return _inputSize; }
+
+        /// <summary> Gets the bias term. </summary>
+        ///
+        /// <returns> The bias. </returns>
+        double GetBias() const { return _bias; }
+
+        /// <summary> Gets the feature index of each interior node, followed by the sink. </summary>
+        ///
+        /// <returns> The feature indices. </returns>
+        const std::vector<uint32_t>& GetFeatureIndices() const { return _featureIndices; }
+
+        /// <summary> Gets the threshold of each interior node, followed by the sink. </summary>
+        ///
+        /// <returns> The thresholds. </returns>
+        const std::vector<float>& GetThresholds() const { return _thresholds; }
+
+        /// <summary> Gets the original, double precision threshold of each interior node, followed by the sink. </summary>
+        ///
+        /// <returns> The thresholds. </returns>
+        const std::vector<double>& GetExactThresholds() const { return _exactThresholds; }
+
+        /// <summary> Gets the target node of each edge, followed by the two edges of the sink. </summary>
+        ///
+        /// <returns> The target node indices. </returns>
+        const std::vector<uint32_t>& GetChildren() const { return _children; }
+
+        /// <summary> Gets the output of each edge, followed by the two edges of the sink. </summary>
+        ///
+        /// <returns> The edge outputs. </returns>
+        const std::vector<double>& GetEdgeValues() const { return _edgeValues; }
+
+        /// <summary> Gets the index of the root node of each tree. </summary>
+        ///
+        /// <returns> The root indices. </returns>
+        const std::vector<uint32_t>& GetRootIndices() const { return _rootIndices; }
+
+        /// <summary> Gets the depth of each tree, which is the number of steps that evaluate it. </summary>
+        ///
+        /// <returns> The tree depths. </returns>
+        const std::vector<uint32_t>& GetTreeDepths() const { return _treeDepths; }
+
+        /// <summary> Returns the output of the forest, including the bias term. </summary>
+        ///
+        /// <param name="input"> The input, with at least GetInputSize() elements. </param>
+        ///
+        /// <returns> The prediction. </returns>
+        double Predict(const float* input) const;
+
+        /// <summary> Returns the output of the forest, and also computes the output of each tree and the edge path indicator vector. </summary>
+        ///
+        /// <param name="input"> The input, with at least GetInputSize() elements. </param>
+        /// <param name="treeOutputs"> Gets the NumTrees() tree outputs. </param>
+        /// <param name="edgeIndicator"> Gets the NumEdges() edge indicators. </param>
+        ///
+        /// <returns> The prediction. </returns>
+        double Predict(const float* input, std::vector<double>& treeOutputs, std::vector<bool>& edgeIndicator) const;
+
+        /// <summary> Returns the output of the forest on a double precision input, and also computes the output of each tree and the edge path indicator vector. </summary>
+        ///
+        /// <param name="input"> The input, with at least GetInputSize() elements. </param>
+        /// <param name="treeOutputs"> Gets the NumTrees() tree outputs. </param>
+        /// <param name="edgeIndicator"> Gets the NumEdges() edge indicators. </param>
+        ///
+        /// <returns> The prediction. </returns>
+        double Predict(const double* input, std::vector<double>& treeOutputs, std::vector<bool>& edgeIndicator) const;
+
+        /// <summary> Returns the output of a single tree. </summary>
+        ///
+        /// <param name="input"> The input, with at least GetInputSize() elements. </param>
+        /// <param name="treeIndex"> The index of the tree. </param>
+        ///
+        /// <returns> The output of the tree. </returns>
+        double PredictTree(const float* input, size_t treeIndex) const;
+
+        /// <summary> Computes the output of the forest on a batch of inputs. </summary>
+        ///
+        /// <param name="inputs"> The inputs, stored one after another. </param>
+        /// <param name="numInputs"> The number of inputs. </param>
+        /// <param name="inputStride"> The distance between consecutive inputs, at least GetInputSize(). </param>
+        /// <param name="outputs"> Gets the numInputs predictions. </param>
+        void Predict(const float* inputs, size_t numInputs, size_t inputStride, double* outputs) const;
+
+        /// <summary> Computes the output of the forest on a batch of inputs, splitting the batch between the threads of a pool. </summary>
+        ///
+        /// <param name="inputs"> The inputs, stored one after another. </param>
+        /// <param name="numInputs"> The number of inputs. </param>
+        /// <param name="inputStride"> The distance between consecutive inputs, at least GetInputSize(). </param>
+        /// <param name="outputs"> Gets the numInputs predictions. </param>
+        /// <param name="threadPool"> The thread pool. </param>
+        void Predict(const float* inputs, size_t numInputs, size_t inputStride, double* outputs, utilities::ThreadPool& threadPool) const;
+
+    private:
+        void AddInteriorNode(size_t featureIndex, double threshold);
+        void AddEdge(bool isTargetInterior, size_t targetNodeIndex, double value);
+        void Finish(const std::vector<size_t>& rootIndices);
+        void PredictBlock(const float* inputs, size_t numInputs, size_t inputStride, double* outputs) const;
+
+        template <typename ValueType, typename ThresholdType>
+        double PredictPaths(const ValueType* input, const std::vector<ThresholdType>& thresholds, std::vector<double>& treeOutputs, std::vector<bool>& edgeIndicator) const;
+
+        // one entry per interior node, plus the sink
+        std::vector<uint32_t> _featureIndices;
+        std::vector<float> _thresholds;
+        std::vector<double> _exactThresholds;
+
+        // one entry per edge, plus the two edges of the sink
+        std::vector<uint32_t> _children;
+        std::vector<double> _edgeValues;
+
+        // one entry per tree
+        std::vector<uint32_t> _rootIndices;
+        std::vector<uint32_t> _treeDepths;
+
+        double _bias = 0.0;
+        size_t _inputSize = 0;
+    };
+} // namespace predictors
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace predictors
+{
+    template <typename ForestType>
+    FlattenedForest::FlattenedForest(const ForestType& forest) :
+        _bias(forest.GetBias())
+    {
+        const auto& interiorNodes = forest.GetInteriorNodes();
+        for (const auto& interiorNode : interiorNodes)
+        {
+            const auto& edges = interiorNode.GetOutgoingEdges();
+            if (edges.size() != 2)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "FlattenedForest only supports binary split rules");
+            }
+
+            const auto& splitRule = interiorNode.GetSplitRule();
+            AddInteriorNode(splitRule.GetElementIndex(), splitRule.GetThreshold());
+            for (const auto& edge : edges)
+            {
+                AddEdge(edge.IsTargetInterior(), edge.GetTargetNodeIndex(), edge.GetPredictor().GetValue());
+            }
+        }
+        Finish(forest.GetRootIndices());
+    }
+} // namespace predictors
+} // namespace ell
+
+#pragma endregion implementation
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "ConstantPredictor.h"
+#include "FlattenedForest.h"
 #include "IPredictor.h"
 #include "SingleElementThresholdPredictor.h"
 
@@ -19,6 +20,8 @@
 #include <algorithm>
 #include <functional>
 #include <iterator>
+#include <memory>
+#include <type_traits>
 #include <vector>
 
 namespace ell
@@ -313,6 +316,12 @@ namespace predictors
         /// <returns> The vector of tree root indices. </returns>
         const std::vector<size_t>& GetRootIndices() const { return _rootIndices; }
 
+        /// <summary> Gets a flattened copy of the forest, which is built on first use and rebuilt after the forest changes. Only
+        /// available for forests of binary threshold trees, such as SimpleForestPredictor, which use it in Predict. </summary>
+        ///
+        /// <returns> The flattened forest. </returns>
+        std::shared_ptr<const FlattenedForest> GetFlattenedForest() const;
+
         /// <summary> Prints a representation of the forest to an output stream. </summary>
         ///
         /// <param name="os"> [in,out] The output stream. </param>
@@ -339,6 +348,8 @@ namespace predictors
 
         void VisitEdgePathToLeaf(const DataVectorType& input, size_t interiorNodeIndex, std::function<void(const InteriorNode&, size_t edgePosition)> operation) const;
 
+        void InvalidateFlattenedForest();
+
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
 
@@ -349,8 +360,15 @@ namespace predictors
         std::vector<size_t> _rootIndices;
         double _bias = 0.0;
         size_t _numEdges = 0;
+
+        // built lazily by GetFlattenedForest, and accessed atomically because Predict may be called concurrently
+        mutable std::shared_ptr<const FlattenedForest> _flattenedForest;
     };
 
+    /// <summary> Query if a forest type can be flattened into a FlattenedForest. </summary>
+    template <typename SplitRuleType, typename EdgePredictorType>
+    constexpr bool IsFlattenableForest = std::is_same<SplitRuleType, SingleElementThresholdPredictor>::value && std::is_same<EdgePredictorType, ConstantPredictor>::value;
+
     /// <summary> A simple binary tree with single-input threshold rules and constant predictors in its edges. </summary>
     typedef ForestPredictor<SingleElementThresholdPredictor, ConstantPredictor> SimpleForestPredictor;
 } // namespace predictors
@@ -453,6 +471,16 @@ namespace predictors
     template <typename SplitRuleType, typename EdgePredictorType>
     double ForestPredictor<SplitRuleType, EdgePredictorType>::Predict(const DataVectorType& input) const
     {
+        if constexpr (IsFlattenableForest<SplitRuleType, EdgePredictorType>)
+        {
+            // inputs that are too short take the slow path, which throws only if it actually reaches a missing feature
+            auto flattenedForest = GetFlattenedForest();
+            if (input.PrefixLength() >= flattenedForest->GetInputSize())
+            {
+                return flattenedForest->Predict(input.GetDataPointer());
+            }
+        }
+
         double output = _bias;
         for (auto treeRootIndex : _rootIndices)
         {
@@ -530,6 +558,7 @@ namespace predictors
         {
             // add interior Node
             size_t interiorNodeIndex = AddInteriorNode(splitAction);
+            InvalidateFlattenedForest();
 
             // add new tree
             _rootIndices.push_back(interiorNodeIndex);
@@ -548,6 +577,7 @@ namespace predictors
 
             // add interior Node
             size_t interiorNodeIndex = AddInteriorNode(splitAction);
+            InvalidateFlattenedForest();
 
             // update the parent about the new interior node
             incomingEdge.SetTargetNodeIndex(interiorNodeIndex);
@@ -561,6 +591,28 @@ namespace predictors
     void ForestPredictor<SplitRuleType, EdgePredictorType>::AddToBias(double value)
     {
         _bias += value;
+        InvalidateFlattenedForest();
+    }
+
+    template <typename SplitRuleType, typename EdgePredictorType>
+    std::shared_ptr<const FlattenedForest> ForestPredictor<SplitRuleType, EdgePredictorType>::GetFlattenedForest() const
+    {
+        static_assert(IsFlattenableForest<SplitRuleType, EdgePredictorType>, "only forests of SingleElementThresholdPredictor split rules and ConstantPredictor edges can be flattened");
+
+        // concurrent callers may each build a copy, but they all build the same one
+        auto flattenedForest = std::atomic_load(&_flattenedForest);
+        if (flattenedForest == nullptr)
+        {
+            flattenedForest = std::make_shared<const FlattenedForest>(*this);
+            std::atomic_store(&_flattenedForest, flattenedForest);
+        }
+        return flattenedForest;
+    }
+
+    template <typename SplitRuleType, typename EdgePredictorType>
+    void ForestPredictor<SplitRuleType, EdgePredictorType>::InvalidateFlattenedForest()
+    {
+        std::atomic_store(&_flattenedForest, std::shared_ptr<const FlattenedForest>());
     }
 
     template <typename SplitRuleType, typename EdgePredictorType>
@@ -579,6 +631,7 @@ namespace predictors
         archiver["rootIndices"] >> _rootIndices;
         archiver["bias"] >> _bias;
         archiver["numEdges"] >> _numEdges;
+        InvalidateFlattenedForest();
     }
 
     template <typename SplitRuleType, typename EdgePredictorType>
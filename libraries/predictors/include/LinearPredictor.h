@@ -18,6 +18,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <vector>
 
 namespace ell
 {
@@ -96,6 +97,16 @@ namespace predictors
         /// <returns> The prediction. </returns>
         ElementType Predict(const DataVectorType& dataVector) const;
 
+        /// <summary>
+        /// Returns the outputs of the predictor for a block of examples. If the examples are all stored densely, they
+        /// are copied into the rows of a matrix and predicted with a single matrix-vector product.
+        /// </summary>
+        ///
+        /// <param name="dataVectors"> The data vectors. </param>
+        ///
+        /// <returns> The predictions, one per data vector. </returns>
+        std::vector<ElementType> PredictBatch(const std::vector<const DataVectorType*>& dataVectors) const;
+
         /// <summary> Returns a vector of dataVector elements weighted by the predictor weights. </summary>
         ///
         /// <param name="example"> The data vector. </param>
@@ -136,9 +147,13 @@ namespace predictors
 
 #include <data/include/DataVectorOperations.h>
 
+#include <math/include/Matrix.h>
+#include <math/include/MatrixOperations.h>
 #include <math/include/VectorOperations.h>
 
+#include <algorithm>
 #include <memory>
+#include <type_traits>
 
 namespace ell
 {
@@ -190,6 +205,64 @@ namespace predictors
         return _w * dataVector + _b;
     }
 
+    template <typename ElementType>
+    std::vector<ElementType> LinearPredictor<ElementType>::PredictBatch(const std::vector<const DataVectorType*>& dataVectors) const
+    {
+        const auto numRows = dataVectors.size();
+        const auto numColumns = _w.Size();
+        auto isDense = [](const DataVectorType* dataVector) {
+            switch (dataVector->GetInternalType())
+            {
+            case data::IDataVector::Type::DoubleDataVector:
+            case data::IDataVector::Type::FloatDataVector:
+            case data::IDataVector::Type::ShortDataVector:
+            case data::IDataVector::Type::ByteDataVector:
+                return true;
+            default:
+                return false;
+            }
+        };
+
+        // densifying sparse examples would cost more than the matrix-vector product saves
+        std::vector<ElementType> predictions(numRows);
+        if (numColumns == 0 || !std::all_of(dataVectors.begin(), dataVectors.end(), isDense))
+        {
+            for (size_t i = 0; i < numRows; ++i)
+            {
+                predictions[i] = Predict(*dataVectors[i]);
+            }
+            return predictions;
+        }
+
+        // entries beyond the size of the weight vector are ignored, as in Predict
+        math::RowMatrix<double> inputs(numRows, numColumns);
+        for (size_t i = 0; i < numRows; ++i)
+        {
+            dataVectors[i]->AddTo(inputs.GetRow(i));
+        }
+
+        math::ColumnVector<double> outputs(numRows);
+        if constexpr (std::is_same_v<ElementType, double>)
+        {
+            math::MultiplyScaleAddUpdate(1.0, inputs, _w, 0.0, outputs);
+        }
+        else
+        {
+            math::ColumnVector<double> weights(numColumns);
+            for (size_t j = 0; j < numColumns; ++j)
+            {
+                weights[j] = _w[j];
+            }
+            math::MultiplyScaleAddUpdate(1.0, inputs, weights, 0.0, outputs);
+        }
+
+        for (size_t i = 0; i < numRows; ++i)
+        {
+            predictions[i] = static_cast<ElementType>(outputs[i]) + _b;
+        }
+        return predictions;
+    }
+
     template <typename ElementType>
     auto LinearPredictor<ElementType>::GetWeightedElements(const DataVectorType& dataVector) const -> DataVectorType
     {
@@ -0,0 +1,199 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FlattenedForest.cpp (predictors)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FlattenedForest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ell
+{
+namespace predictors
+{
+    namespace
+    {
+        constexpr uint32_t leafIndex = std::numeric_limits<uint32_t>::max();
+
+        // the number of inputs that step through a tree together
+        constexpr size_t blockSize = 8;
+
+        uint32_t ToNodeIndex(size_t index)
+        {
+            if (index >= leafIndex)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "FlattenedForest supports up to 2^32 - 2 interior nodes and features");
+            }
+            return static_cast<uint32_t>(index);
+        }
+
+        // for every float x, (x > result) equals (x > threshold)
+        float ToFloatThreshold(double threshold)
+        {
+            auto result = static_cast<float>(threshold);
+            if (static_cast<double>(result) > threshold)
+            {
+                result = std::nextafter(result, -std::numeric_limits<float>::infinity());
+            }
+            return result;
+        }
+    } // namespace
+
+    double FlattenedForest::Predict(const float* input) const
+    {
+        double output = _bias;
+        for (size_t treeIndex = 0; treeIndex < _rootIndices.size(); ++treeIndex)
+        {
+            output += PredictTree(input, treeIndex);
+        }
+        return output;
+    }
+
+    double FlattenedForest::Predict(const float* input, std::vector<double>& treeOutputs, std::vector<bool>& edgeIndicator) const
+    {
+        return PredictPaths(input, _thresholds, treeOutputs, edgeIndicator);
+    }
+
+    double FlattenedForest::Predict(const double* input, std::vector<double>& treeOutputs, std::vector<bool>& edgeIndicator) const
+    {
+        return PredictPaths(input, _exactThresholds, treeOutputs, edgeIndicator);
+    }
+
+    template <typename ValueType, typename ThresholdType>
+    double FlattenedForest::PredictPaths(const ValueType* input, const std::vector<ThresholdType>& thresholds, std::vector<double>& treeOutputs, std::vector<bool>& edgeIndicator) const
+    {
+        const auto sinkIndex = static_cast<uint32_t>(NumInteriorNodes());
+        treeOutputs.assign(NumTrees(), 0.0);
+        edgeIndicator.assign(NumEdges(), false);
+
+        double output = _bias;
+        for (size_t treeIndex = 0; treeIndex < _rootIndices.size(); ++treeIndex)
+        {
+            double treeOutput = 0.0;
+            for (auto node = _rootIndices[treeIndex]; node != sinkIndex;)
+            {
+                auto edge = 2 * node + (input[_featureIndices[node]] > thresholds[node]);
+                edgeIndicator[edge] = true;
+                treeOutput += _edgeValues[edge];
+                node = _children[edge];
+            }
+            treeOutputs[treeIndex] = treeOutput;
+            output += treeOutput;
+        }
+        return output;
+    }
+
+    double FlattenedForest::PredictTree(const float* input, size_t treeIndex) const
+    {
+        // leaves lead to the sink, which loops to itself with zero output, so there's no need to check for them
+        auto node = _rootIndices[treeIndex];
+        double output = 0.0;
+        for (uint32_t step = 0; step < _treeDepths[treeIndex]; ++step)
+        {
+            auto edge = 2 * node + (input[_featureIndices[node]] > _thresholds[node]);
+            output += _edgeValues[edge];
+            node = _children[edge];
+        }
+        return output;
+    }
+
+    void FlattenedForest::Predict(const float* inputs, size_t numInputs, size_t inputStride, double* outputs) const
+    {
+        for (size_t begin = 0; begin < numInputs; begin += blockSize)
+        {
+            PredictBlock(inputs + begin * inputStride, std::min(blockSize, numInputs - begin), inputStride, outputs + begin);
+        }
+    }
+
+    void FlattenedForest::Predict(const float* inputs, size_t numInputs, size_t inputStride, double* outputs, utilities::ThreadPool& threadPool) const
+    {
+        // give each thread a contiguous range of whole blocks
+        auto numBlocks = (numInputs + blockSize - 1) / blockSize;
+        auto numTasks = std::min(threadPool.NumThreads(), numBlocks);
+        threadPool.ParallelFor(numTasks, [&](size_t taskIndex) {
+            auto begin = std::min(numInputs, numBlocks * taskIndex / numTasks * blockSize);
+            auto end = std::min(numInputs, numBlocks * (taskIndex + 1) / numTasks * blockSize);
+            Predict(inputs + begin * inputStride, end - begin, inputStride, outputs + begin);
+        });
+    }
+
+    void FlattenedForest::PredictBlock(const float* inputs, size_t numInputs, size_t inputStride, double* outputs) const
+    {
+        double forestOutputs[blockSize];
+        std::fill_n(forestOutputs, numInputs, _bias);
+
+        for (size_t treeIndex = 0; treeIndex < _rootIndices.size(); ++treeIndex)
+        {
+            uint32_t nodes[blockSize];
+            double treeOutputs[blockSize];
+            std::fill_n(nodes, numInputs, _rootIndices[treeIndex]);
+            std::fill_n(treeOutputs, numInputs, 0.0);
+
+            // the inputs are independent, so their loads overlap instead of waiting on each other
+            for (uint32_t step = 0; step < _treeDepths[treeIndex]; ++step)
+            {
+                for (size_t i = 0; i < numInputs; ++i)
+                {
+                    auto node = nodes[i];
+                    auto edge = 2 * node + (inputs[i * inputStride + _featureIndices[node]] > _thresholds[node]);
+                    treeOutputs[i] += _edgeValues[edge];
+                    nodes[i] = _children[edge];
+                }
+            }
+
+            for (size_t i = 0; i < numInputs; ++i)
+            {
+                forestOutputs[i] += treeOutputs[i];
+            }
+        }
+        std::copy_n(forestOutputs, numInputs, outputs);
+    }
+
+    void FlattenedForest::AddInteriorNode(size_t featureIndex, double threshold)
+    {
+        ToNodeIndex(_featureIndices.size());
+        _featureIndices.push_back(ToNodeIndex(featureIndex));
+        _thresholds.push_back(ToFloatThreshold(threshold));
+        _exactThresholds.push_back(threshold);
+        _inputSize = std::max(_inputSize, featureIndex + 1);
+    }
+
+    void FlattenedForest::AddEdge(bool isTargetInterior, size_t targetNodeIndex, double value)
+    {
+        _children.push_back(isTargetInterior ? ToNodeIndex(targetNodeIndex) : leafIndex);
+        _edgeValues.push_back(value);
+    }
+
+    void FlattenedForest::Finish(const std::vector<size_t>& rootIndices)
+    {
+        auto numInteriorNodes = _featureIndices.size();
+        auto sinkIndex = ToNodeIndex(numInteriorNodes);
+
+        // point the leaves to the sink, and add the sink
+        std::replace(_children.begin(), _children.end(), leafIndex, sinkIndex);
+        _featureIndices.push_back(0);
+        _thresholds.push_back(std::numeric_limits<float>::infinity());
+        _exactThresholds.push_back(std::numeric_limits<double>::infinity());
+        _children.insert(_children.end(), { sinkIndex, sinkIndex });
+        _edgeValues.insert(_edgeValues.end(), { 0.0, 0.0 });
+
+        // interior nodes are stored in topological order, so the height of each subtree can be computed bottom-up
+        std::vector<uint32_t> heights(numInteriorNodes + 1, 0);
+        for (auto nodeIndex = numInteriorNodes; nodeIndex > 0; --nodeIndex)
+        {
+            auto node = nodeIndex - 1;
+            heights[node] = 1 + std::max(heights[_children[2 * node]], heights[_children[2 * node + 1]]);
+        }
+
+        for (auto rootIndex : rootIndices)
+        {
+            _rootIndices.push_back(ToNodeIndex(rootIndex));
+            _treeDepths.push_back(heights[rootIndex]);
+        }
+    }
+} // namespace predictors
+} // namespace ell
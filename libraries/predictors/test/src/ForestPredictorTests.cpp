@@ -10,6 +10,12 @@
 
 #include <testing/include/testing.h>
 
+#include <utilities/include/ThreadPool.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
 using namespace ell;
 
 void ForestPredictorTest()
@@ -65,3 +71,142 @@ void ForestPredictorTest()
     auto edgeIndicator = forest.GetEdgeIndicatorVector(ExampleType{ 0.25, 0.7, 0.0 });
     testing::ProcessTest("Testing ForestPredictor, SetEdgeIndicatorVector()", testing::IsEqual(edgeIndicator, std::vector<bool>{ 1, 0, 0, 1, 0, 0, 0, 1 }));
 }
+
+void FlattenedForestTest()
+{
+    using SplitAction = predictors::SimpleForestPredictor::SplitAction;
+    using SplitRule = predictors::SingleElementThresholdPredictor;
+    using EdgePredictorVector = std::vector<predictors::ConstantPredictor>;
+    using ExampleType = predictors::SimpleForestPredictor::DataVectorType;
+
+    const size_t numFeatures = 20;
+    const size_t numInputs = 37;
+    std::default_random_engine engine(1234);
+    std::uniform_real_distribution<double> valueDistribution(-1.0, 1.0);
+    std::uniform_int_distribution<size_t> featureDistribution(0, numFeatures - 1);
+
+    // grow a forest of unbalanced trees by splitting random leaves
+    predictors::SimpleForestPredictor forest;
+    std::vector<double> thresholds;
+    for (size_t tree = 0; tree < 10; ++tree)
+    {
+        std::vector<std::pair<size_t, size_t>> leaves;
+        auto addNode = [&](predictors::SimpleForestPredictor::SplittableNodeId nodeId) {
+            auto threshold = valueDistribution(engine);
+            thresholds.push_back(threshold);
+            auto nodeIndex = forest.Split(SplitAction{ nodeId, SplitRule{ featureDistribution(engine), threshold }, EdgePredictorVector{ valueDistribution(engine), valueDistribution(engine) } });
+            leaves.push_back({ nodeIndex, 0 });
+            leaves.push_back({ nodeIndex, 1 });
+        };
+
+        addNode(forest.GetNewRootId());
+        for (size_t split = 0; split < tree; ++split)
+        {
+            auto leafPosition = std::uniform_int_distribution<size_t>(0, leaves.size() - 1)(engine);
+            auto leaf = leaves[leafPosition];
+            leaves.erase(leaves.begin() + leafPosition);
+            addNode(forest.GetChildId(leaf.first, leaf.second));
+        }
+    }
+    forest.AddToBias(0.5);
+
+    // random inputs, some of which hit the thresholds (rounded to float) exactly
+    std::vector<float> inputs(numInputs * numFeatures);
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        inputs[i] = static_cast<float>(i % 3 == 0 ? thresholds[i % thresholds.size()] : valueDistribution(engine));
+    }
+
+    auto flattenedForest = forest.GetFlattenedForest();
+    testing::ProcessTest("Testing FlattenedForest, NumTrees()", flattenedForest->NumTrees() == forest.NumTrees());
+    testing::ProcessTest("Testing FlattenedForest, NumEdges()", flattenedForest->NumEdges() == forest.NumEdges());
+
+    bool predictionsMatch = true;
+    bool treeOutputsMatch = true;
+    bool edgeIndicatorsMatch = true;
+    std::vector<double> expectedOutputs(numInputs);
+    for (size_t i = 0; i < numInputs; ++i)
+    {
+        ExampleType input(std::vector<float>(inputs.begin() + i * numFeatures, inputs.begin() + (i + 1) * numFeatures));
+
+        // predicting one tree at a time follows the original nodes
+        double expected = forest.GetBias();
+        std::vector<double> expectedTreeOutputs;
+        for (size_t tree = 0; tree < forest.NumTrees(); ++tree)
+        {
+            expectedTreeOutputs.push_back(forest.Predict(input, forest.GetRootIndex(tree)));
+            expected += expectedTreeOutputs.back();
+        }
+        expectedOutputs[i] = expected;
+
+        std::vector<double> treeOutputs;
+        std::vector<bool> edgeIndicator;
+        auto output = flattenedForest->Predict(&inputs[i * numFeatures], treeOutputs, edgeIndicator);
+        predictionsMatch = predictionsMatch && forest.Predict(input) == expected && output == expected;
+        treeOutputsMatch = treeOutputsMatch && treeOutputs == expectedTreeOutputs;
+        edgeIndicatorsMatch = edgeIndicatorsMatch && edgeIndicator == forest.GetEdgeIndicatorVector(input);
+    }
+    testing::ProcessTest("Testing FlattenedForest, Predict()", predictionsMatch);
+    testing::ProcessTest("Testing FlattenedForest, tree outputs", treeOutputsMatch);
+    testing::ProcessTest("Testing FlattenedForest, edge indicator vector", edgeIndicatorsMatch);
+
+    std::vector<double> outputs(numInputs);
+    flattenedForest->Predict(inputs.data(), numInputs, numFeatures, outputs.data());
+    testing::ProcessTest("Testing FlattenedForest, batch Predict()", outputs == expectedOutputs);
+
+    utilities::ThreadPool threadPool(3);
+    std::vector<double> parallelOutputs(numInputs);
+    flattenedForest->Predict(inputs.data(), numInputs, numFeatures, parallelOutputs.data(), threadPool);
+    testing::ProcessTest("Testing FlattenedForest, parallel batch Predict()", parallelOutputs == expectedOutputs);
+
+    // double inputs that hit the thresholds, or fall between a threshold and its float rounding, follow the original nodes
+    bool doublePredictionsMatch = true;
+    for (size_t i = 0; i < numInputs; ++i)
+    {
+        std::vector<double> doubleInput(numFeatures);
+        for (size_t j = 0; j < numFeatures; ++j)
+        {
+            auto threshold = thresholds[(i * numFeatures + j) % thresholds.size()];
+            doubleInput[j] = j % 2 == 0 ? threshold : std::nextafter(threshold, 2.0);
+        }
+
+        // walk the original nodes, comparing in double as the refined SingleElementThresholdNodes do
+        const auto& interiorNodes = forest.GetInteriorNodes();
+        double expected = forest.GetBias();
+        std::vector<bool> expectedEdgeIndicator(forest.NumEdges());
+        for (size_t tree = 0; tree < forest.NumTrees(); ++tree)
+        {
+            double expectedTreeOutput = 0.0;
+            for (auto node = forest.GetRootIndex(tree);;)
+            {
+                const auto& splitRule = interiorNodes[node].GetSplitRule();
+                size_t position = doubleInput[splitRule.GetElementIndex()] > splitRule.GetThreshold() ? 1 : 0;
+                const auto& edge = interiorNodes[node].GetOutgoingEdges()[position];
+                expectedEdgeIndicator[interiorNodes[node].GetFirstEdgeIndex() + position] = true;
+                expectedTreeOutput += edge.GetPredictor().GetValue();
+                if (!edge.IsTargetInterior())
+                {
+                    break;
+                }
+                node = edge.GetTargetNodeIndex();
+            }
+            expected += expectedTreeOutput;
+        }
+
+        std::vector<double> treeOutputs;
+        std::vector<bool> edgeIndicator;
+        auto output = flattenedForest->Predict(doubleInput.data(), treeOutputs, edgeIndicator);
+        doublePredictionsMatch = doublePredictionsMatch && output == expected && edgeIndicator == expectedEdgeIndicator;
+    }
+    testing::ProcessTest("Testing FlattenedForest, double Predict()", doublePredictionsMatch);
+
+    // changing the forest rebuilds the flattened copy
+    forest.AddToBias(1.0);
+    testing::ProcessTest("Testing FlattenedForest, rebuilt after change", forest.GetFlattenedForest() != flattenedForest && testing::IsEqual(forest.GetFlattenedForest()->Predict(inputs.data()), expectedOutputs[0] + 1.0, 1.0e-12));
+
+    // inputs that are too short for the flattened forest still throw only when a missing feature is reached
+    predictors::SimpleForestPredictor shallowForest;
+    shallowForest.Split(SplitAction{ shallowForest.GetNewRootId(), SplitRule{ 0, 0.0 }, EdgePredictorVector{ -1.0, 1.0 } });
+    shallowForest.Split(SplitAction{ shallowForest.GetChildId(0, 1), SplitRule{ 5, 0.0 }, EdgePredictorVector{ -1.0, 1.0 } });
+    testing::ProcessTest("Testing FlattenedForest, short input", shallowForest.Predict(ExampleType{ -1.0 }) == -1.0);
+}
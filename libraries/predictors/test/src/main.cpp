@@ -19,6 +19,7 @@ int main()
 {
     // ForestPredictor
     ForestPredictorTest();
+    FlattenedForestTest();
 
     // LinearPredictor
     LinearPredictorTest<double>();
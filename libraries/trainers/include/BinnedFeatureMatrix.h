@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinnedFeatureMatrix.h (trainers)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ell
+{
+namespace trainers
+{
+    /// <summary>
+    /// A column-major matrix of quantized feature values. Each feature's values are replaced by the index of the bin
+    /// that contains them, where bins are separated by thresholds chosen once, from the whole column. Bin indices
+    /// are stored in 8 bits when there are at most 256 bins per feature, and in 16 bits otherwise.
+    /// </summary>
+    class BinnedFeatureMatrix
+    {
+    public:
+        /// <summary> The largest supported number of bins per feature. </summary>
+        static constexpr size_t maxNumBins = 65536;
+
+        BinnedFeatureMatrix() = default;
+
+        /// <summary> Constructs an empty matrix; the columns are filled in with SetColumn. </summary>
+        ///
+        /// <param name="numRows"> The number of rows (examples). </param>
+        /// <param name="numFeatures"> The number of columns (features). </param>
+        /// <param name="maxBinsPerFeature"> The maximum number of bins per feature, between 2 and maxNumBins. </param>
+        BinnedFeatureMatrix(size_t numRows, size_t numFeatures, size_t maxBinsPerFeature);
+
+        /// <summary> Chooses the bin thresholds for a feature and quantizes its values. Different columns can be set concurrently. </summary>
+        ///
+        /// <param name="featureIndex"> The feature index. </param>
+        /// <param name="values"> The value of the feature in each row. </param>
+        void SetColumn(size_t featureIndex, const std::vector<double>& values);
+
+        /// <summary> Gets the number of rows. </summary>
+        size_t NumRows() const { return _numRows; }
+
+        /// <summary> Gets the number of features. </summary>
+        size_t NumFeatures() const { return _thresholds.size(); }
+
+        /// <summary> Gets the maximum number of bins per feature. </summary>
+        size_t MaxBinsPerFeature() const { return _maxBinsPerFeature; }
+
+        /// <summary> Gets the number of bins actually used by a feature. </summary>
+        size_t NumBins(size_t featureIndex) const { return _thresholds[featureIndex].size() + 1; }
+
+        /// <summary> Gets the threshold that separates a bin from the next one: a value is in bin `binIndex` or lower iff it is less than or equal to the threshold. </summary>
+        ///
+        /// <param name="featureIndex"> The feature index. </param>
+        /// <param name="binIndex"> The bin index, less than NumBins(featureIndex) - 1. </param>
+        double GetThreshold(size_t featureIndex, size_t binIndex) const { return _thresholds[featureIndex][binIndex]; }
+
+        /// <summary> Returns true if bin indices are stored in 16 bits. </summary>
+        bool HasWideBins() const { return _maxBinsPerFeature > 256; }
+
+        /// <summary> Gets the bin indices of a feature, when stored in 8 bits. </summary>
+        const uint8_t* GetNarrowColumn(size_t featureIndex) const { return _narrowBins.data() + featureIndex * _numRows; }
+
+        /// <summary> Gets the bin indices of a feature, when stored in 16 bits. </summary>
+        const uint16_t* GetWideColumn(size_t featureIndex) const { return _wideBins.data() + featureIndex * _numRows; }
+
+        /// <summary> Gets the bin of a given entry. </summary>
+        size_t GetBin(size_t rowIndex, size_t featureIndex) const;
+
+        /// <summary> Gets the bin that a value of a feature falls into. </summary>
+        ///
+        /// <param name="featureIndex"> The feature index. </param>
+        /// <param name="value"> The value. </param>
+        size_t FindBin(size_t featureIndex, double value) const;
+
+    private:
+        size_t _numRows = 0;
+        size_t _maxBinsPerFeature = 0;
+        std::vector<std::vector<double>> _thresholds;
+        std::vector<uint8_t> _narrowBins;
+        std::vector<uint16_t> _wideBins;
+    };
+} // namespace trainers
+} // namespace ell
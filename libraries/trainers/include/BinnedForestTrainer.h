@@ -0,0 +1,346 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinnedForestTrainer.h (trainers)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "BinnedFeatureMatrix.h"
+#include "ForestTrainer.h"
+#include "LogitBooster.h"
+
+#include <predictors/include/ConstantPredictor.h>
+#include <predictors/include/SingleElementThresholdPredictor.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace ell
+{
+namespace trainers
+{
+    /// <summary> Parameters for the binned forest trainer. </summary>
+    struct BinnedForestTrainerParameters : public virtual ForestTrainerParameters
+    {
+        size_t maxBinsPerFeature = 255;
+    };
+
+    /// <summary>
+    /// A trainer for binary decision forests with threshold split rules and constant outputs that quantizes each
+    /// feature into a small number of bins once, when the dataset is set, and then finds splits by building per-node
+    /// histograms of the bins. Only the smaller child of each split is histogrammed; the sibling's histogram is the
+    /// parent's minus the smaller child's. The bin matrix is the only copy of the features the trainer keeps: the data
+    /// vectors of the examples are released once they are quantized.
+    /// </summary>
+    ///
+    /// <typeparam name="LossFunctionType"> Loss function type. </typeparam>
+    /// <typeparam name="BoosterType"> Booster type. </typeparam>
+    template <typename LossFunctionType, typename BoosterType>
+    class BinnedForestTrainer : public ForestTrainer<predictors::SingleElementThresholdPredictor, predictors::ConstantPredictor, BoosterType>
+    {
+    public:
+        /// <summary> Constructs an instance of BinnedForestTrainer. </summary>
+        ///
+        /// <param name="lossFunction"> The loss function. </param>
+        /// <param name="booster"> The booster. </param>
+        /// <param name="parameters"> Training Parameters. </param>
+        BinnedForestTrainer(const LossFunctionType& lossFunction, const BoosterType& booster, const BinnedForestTrainerParameters& parameters);
+
+        /// <summary> Sets the trainer's dataset, and quantizes its features. </summary>
+        ///
+        /// <param name="anyDataset"> A dataset. </param>
+        void SetDataset(const data::AnyDataset& anyDataset) override;
+
+        using SplitRuleType = predictors::SingleElementThresholdPredictor;
+        using EdgePredictorType = predictors::ConstantPredictor;
+        using BaseType = ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>;
+        using typename BaseType::SplitCandidate;
+        using typename BaseType::SplittableNodeId;
+        using typename BaseType::NodeStats;
+        using typename BaseType::Range;
+        using typename BaseType::Sums;
+        using typename BaseType::TrainerExampleType;
+
+    protected:
+        using BaseType::_dataset;
+        using BaseType::_forest;
+        using BaseType::_parameters;
+        using BaseType::_threadPool;
+
+        SplitCandidate GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) override;
+        std::vector<SplitCandidate> GetBestSplitRulesAtChildren(const SplitCandidate& parent, size_t interiorNodeIndex) override;
+        std::vector<EdgePredictorType> GetEdgePredictors(const NodeStats& nodeStats) override;
+        void GetChildPositions(Range block, const SplitRuleType& splitRule, size_t* childPositions) const override;
+
+    private:
+        struct HistogramBin
+        {
+            Sums sums;
+            size_t count = 0;
+        };
+
+        // one bin per feature per possible bin index, feature-major
+        using Histogram = std::vector<HistogramBin>;
+
+        Histogram BuildHistogram(Range range);
+        template <typename BinType>
+        void BuildFeatureHistogram(const BinType* column, const std::vector<size_t>& exampleIndices, const std::vector<data::WeightLabel>& weightLabels, HistogramBin* featureHistogram) const;
+        SplitCandidate GetBestSplitRule(SplittableNodeId nodeId, Range range, Sums sums, const Histogram& histogram) const;
+        double CalculateGain(const Sums& sums, const Sums& sums0, const Sums& sums1) const;
+
+        // member variables
+        LossFunctionType _lossFunction;
+        size_t _maxBinsPerFeature;
+        BinnedFeatureMatrix _bins;
+
+        // histograms of the nodes that may still be split, by the first row of the node's range
+        std::unordered_map<size_t, Histogram> _histograms;
+    };
+
+    /// <summary> Makes a binned forest trainer. </summary>
+    ///
+    /// <typeparam name="LossFunctionType"> Type of loss function to use. </typeparam>
+    /// <typeparam name="BoosterType"> Type of booster to use. </typeparam>
+    /// <param name="lossFunction"> The loss function. </param>
+    /// <param name="booster"> The booster. </param>
+    /// <param name="parameters"> The trainer parameters. </param>
+    ///
+    /// <returns> A unique_ptr to a binned forest trainer. </returns>
+    template <typename LossFunctionType, typename BoosterType>
+    std::unique_ptr<ITrainer<predictors::SimpleForestPredictor>> MakeBinnedForestTrainer(const LossFunctionType& lossFunction, const BoosterType& booster, const BinnedForestTrainerParameters& parameters);
+} // namespace trainers
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace trainers
+{
+    template <typename LossFunctionType, typename BoosterType>
+    BinnedForestTrainer<LossFunctionType, BoosterType>::BinnedForestTrainer(const LossFunctionType& lossFunction, const BoosterType& booster, const BinnedForestTrainerParameters& parameters) :
+        BaseType(booster, parameters),
+        _lossFunction(lossFunction),
+        _maxBinsPerFeature(parameters.maxBinsPerFeature)
+    {
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    void BinnedForestTrainer<LossFunctionType, BoosterType>::SetDataset(const data::AnyDataset& anyDataset)
+    {
+        BaseType::SetDataset(anyDataset);
+
+        // quantize each feature, in parallel. The examples are still in their original order here, so the rows of the
+        // bin matrix are indexed by TrainerMetadata::exampleIndex
+        auto numExamples = _dataset.NumExamples();
+        _bins = BinnedFeatureMatrix(numExamples, _dataset.NumFeatures(), _maxBinsPerFeature);
+        _threadPool.ParallelFor(_dataset.NumFeatures(), [this, numExamples](size_t featureIndex) {
+            std::vector<double> values(numExamples);
+            for (size_t rowIndex = 0; rowIndex < numExamples; ++rowIndex)
+            {
+                values[rowIndex] = _dataset[rowIndex].GetDataVector()[featureIndex];
+            }
+            _bins.SetColumn(featureIndex, values);
+        });
+
+        // the splits are found and applied from the bins from now on, so the examples don't need their own copy of the features.
+        // The constant edge predictors still get a (now empty) data vector
+        auto emptyDataVector = std::make_shared<const typename TrainerExampleType::DataVectorType>();
+        for (size_t rowIndex = 0; rowIndex < numExamples; ++rowIndex)
+        {
+            _dataset[rowIndex] = TrainerExampleType(emptyDataVector, _dataset[rowIndex].GetMetadata());
+        }
+        _histograms.clear();
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    auto BinnedForestTrainer<LossFunctionType, BoosterType>::GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) -> SplitCandidate
+    {
+        // this is called directly only for the root of each new tree, so any histograms left over from the last tree are stale
+        _histograms.clear();
+
+        auto histogram = BuildHistogram(range);
+        auto splitCandidate = GetBestSplitRule(nodeId, range, sums, histogram);
+        _histograms[range.firstIndex] = std::move(histogram);
+        return splitCandidate;
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    auto BinnedForestTrainer<LossFunctionType, BoosterType>::GetBestSplitRulesAtChildren(const SplitCandidate& parent, size_t interiorNodeIndex) -> std::vector<SplitCandidate>
+    {
+        auto parentRange = parent.ranges.GetTotalRange();
+        Histogram parentHistogram;
+        auto parentIterator = _histograms.find(parentRange.firstIndex);
+        if (parentIterator != _histograms.end())
+        {
+            parentHistogram = std::move(parentIterator->second);
+            _histograms.erase(parentIterator);
+        }
+        else
+        {
+            parentHistogram = BuildHistogram(parentRange);
+        }
+
+        // build the smaller child's histogram from the data, and get the larger child's by subtraction
+        Range ranges[2] = { parent.ranges.GetChildRange(0), parent.ranges.GetChildRange(1) };
+        size_t smallerChild = ranges[0].size <= ranges[1].size ? 0 : 1;
+        Histogram histograms[2];
+        histograms[smallerChild] = BuildHistogram(ranges[smallerChild]);
+        histograms[1 - smallerChild] = std::move(parentHistogram);
+        for (size_t index = 0; index < histograms[smallerChild].size(); ++index)
+        {
+            auto& bin = histograms[1 - smallerChild][index];
+            const auto& smallerBin = histograms[smallerChild][index];
+            bin.sums = bin.sums - smallerBin.sums;
+            bin.count -= smallerBin.count;
+        }
+
+        std::vector<SplitCandidate> childSplitCandidates;
+        for (size_t i = 0; i < 2; ++i)
+        {
+            childSplitCandidates.push_back(GetBestSplitRule(_forest.GetChildId(interiorNodeIndex, i), ranges[i], parent.stats.GetChildSums(i), histograms[i]));
+
+            // only keep the histograms of nodes that will be queued for splitting
+            if (childSplitCandidates.back().gain > _parameters.minSplitGain)
+            {
+                _histograms[ranges[i].firstIndex] = std::move(histograms[i]);
+            }
+        }
+        return childSplitCandidates;
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    auto BinnedForestTrainer<LossFunctionType, BoosterType>::GetEdgePredictors(const NodeStats& nodeStats) -> std::vector<EdgePredictorType>
+    {
+        double output = nodeStats.GetTotalSums().GetMeanLabel();
+        double output0 = nodeStats.GetChildSums(0).GetMeanLabel() - output;
+        double output1 = nodeStats.GetChildSums(1).GetMeanLabel() - output;
+        return std::vector<EdgePredictorType>{ output0, output1 };
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    void BinnedForestTrainer<LossFunctionType, BoosterType>::GetChildPositions(Range block, const SplitRuleType& splitRule, size_t* childPositions) const
+    {
+        // a value goes to child 1 iff it is greater than the threshold, that is, iff its bin is after the threshold's bin
+        auto featureIndex = splitRule.GetElementIndex();
+        auto thresholdBin = _bins.FindBin(featureIndex, splitRule.GetThreshold());
+        for (size_t index = 0; index < block.size; ++index)
+        {
+            auto exampleIndex = _dataset[block.firstIndex + index].GetMetadata().exampleIndex;
+            childPositions[index] = _bins.GetBin(exampleIndex, featureIndex) > thresholdBin ? 1 : 0;
+        }
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    auto BinnedForestTrainer<LossFunctionType, BoosterType>::BuildHistogram(Range range) -> Histogram
+    {
+        // gather the node's examples into contiguous arrays, so that each feature's pass only streams through them
+        std::vector<size_t> exampleIndices(range.size);
+        std::vector<data::WeightLabel> weightLabels(range.size);
+        for (size_t index = 0; index < range.size; ++index)
+        {
+            const auto& metadata = _dataset[range.firstIndex + index].GetMetadata();
+            exampleIndices[index] = metadata.exampleIndex;
+            weightLabels[index] = metadata.weak;
+        }
+
+        Histogram histogram(_bins.NumFeatures() * _maxBinsPerFeature);
+        _threadPool.ParallelFor(_bins.NumFeatures(), [this, &exampleIndices, &weightLabels, &histogram](size_t featureIndex) {
+            auto featureHistogram = histogram.data() + featureIndex * _maxBinsPerFeature;
+            if (_bins.HasWideBins())
+            {
+                BuildFeatureHistogram(_bins.GetWideColumn(featureIndex), exampleIndices, weightLabels, featureHistogram);
+            }
+            else
+            {
+                BuildFeatureHistogram(_bins.GetNarrowColumn(featureIndex), exampleIndices, weightLabels, featureHistogram);
+            }
+        });
+        return histogram;
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    template <typename BinType>
+    void BinnedForestTrainer<LossFunctionType, BoosterType>::BuildFeatureHistogram(const BinType* column, const std::vector<size_t>& exampleIndices, const std::vector<data::WeightLabel>& weightLabels, HistogramBin* featureHistogram) const
+    {
+        for (size_t index = 0; index < exampleIndices.size(); ++index)
+        {
+            auto& bin = featureHistogram[column[exampleIndices[index]]];
+            bin.sums.Increment(weightLabels[index]);
+            ++bin.count;
+        }
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    auto BinnedForestTrainer<LossFunctionType, BoosterType>::GetBestSplitRule(SplittableNodeId nodeId, Range range, Sums sums, const Histogram& histogram) const -> SplitCandidate
+    {
+        SplitCandidate bestSplitCandidate(nodeId, range, sums);
+
+        // consider splitting each feature between each pair of consecutive bins, breaking ties in favor of the lowest feature and bin
+        size_t bestFeatureIndex = 0;
+        size_t bestBinIndex = 0;
+        size_t bestSize0 = 0;
+        Sums bestSums0;
+        for (size_t featureIndex = 0; featureIndex < _bins.NumFeatures(); ++featureIndex)
+        {
+            auto featureHistogram = histogram.data() + featureIndex * _maxBinsPerFeature;
+            Sums sums0;
+            size_t size0 = 0;
+            for (size_t binIndex = 0; binIndex + 1 < _bins.NumBins(featureIndex); ++binIndex)
+            {
+                sums0.sumWeights += featureHistogram[binIndex].sums.sumWeights;
+                sums0.sumWeightedLabels += featureHistogram[binIndex].sums.sumWeightedLabels;
+                size0 += featureHistogram[binIndex].count;
+
+                // only split between nonempty sides
+                if (size0 == 0 || size0 == range.size)
+                {
+                    continue;
+                }
+
+                double gain = CalculateGain(sums, sums0, sums - sums0);
+                if (gain > bestSplitCandidate.gain)
+                {
+                    bestSplitCandidate.gain = gain;
+                    bestFeatureIndex = featureIndex;
+                    bestBinIndex = binIndex;
+                    bestSize0 = size0;
+                    bestSums0 = sums0;
+                }
+            }
+        }
+
+        if (bestSize0 > 0)
+        {
+            bestSplitCandidate.splitRule = SplitRuleType{ bestFeatureIndex, _bins.GetThreshold(bestFeatureIndex, bestBinIndex) };
+            bestSplitCandidate.ranges.SplitChildRange(0, bestSize0);
+            bestSplitCandidate.stats.SetChildSums({ bestSums0, sums - bestSums0 });
+        }
+
+        return bestSplitCandidate;
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    double BinnedForestTrainer<LossFunctionType, BoosterType>::CalculateGain(const Sums& sums, const Sums& sums0, const Sums& sums1) const
+    {
+        if (sums0.sumWeights == 0 || sums1.sumWeights == 0)
+        {
+            return 0;
+        }
+
+        return sums0.sumWeights * _lossFunction.BregmanGenerator(sums0.sumWeightedLabels / sums0.sumWeights) +
+               sums1.sumWeights * _lossFunction.BregmanGenerator(sums1.sumWeightedLabels / sums1.sumWeights) -
+               sums.sumWeights * _lossFunction.BregmanGenerator(sums.sumWeightedLabels / sums.sumWeights);
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    std::unique_ptr<ITrainer<predictors::SimpleForestPredictor>> MakeBinnedForestTrainer(const LossFunctionType& lossFunction, const BoosterType& booster, const BinnedForestTrainerParameters& parameters)
+    {
+        return std::make_unique<BinnedForestTrainer<LossFunctionType, BoosterType>>(lossFunction, booster, parameters);
+    }
+} // namespace trainers
+} // namespace ell
+
+#pragma endregion implementation
@@ -16,7 +16,9 @@
 #include <predictors/include/ForestPredictor.h>
 
 #include <utilities/include/OutputStreamImpostor.h>
+#include <utilities/include/ThreadPool.h>
 
+#include <algorithm>
 #include <iostream> // For std::cout in VERBOSE_MODE
 #include <memory>
 #include <queue>
@@ -32,6 +34,7 @@ namespace trainers
         double minSplitGain = 0.0;
         size_t maxSplitsPerRound = 0;
         size_t numRounds = 0;
+        size_t numThreads = 1; // zero means one thread per hardware thread; the trained forest doesn't depend on this
     };
 
     /// <summary> Nontemplated base class for forest trainers, provides some reusable internal classes. </summary>
@@ -50,6 +53,9 @@ namespace trainers
             void Print(std::ostream& os) const;
         };
 
+        // number of rows processed by each parallel task in loops over the data set
+        static constexpr size_t rowBlockSize = 4096;
+
         // represents a range in an array
         struct Range
         {
@@ -84,6 +90,9 @@ namespace trainers
 
             // the output of the forest on this example
             double currentOutput = 0;
+
+            // the position of this example in the data set given to SetDataset (the trainer reorders the examples as it splits nodes)
+            size_t exampleIndex = 0;
         };
 
         // keeps statistics about tree nodes
@@ -180,6 +189,12 @@ namespace trainers
         // after performing a split, we rearrange the data set to ensure that each node's examples occupy contiguous rows in the dataset
         void SortNodeDataset(Range range, const SplitRuleType& splitRule);
 
+        // calls function(blockRange, blockIndex) on consecutive blocks of rows, in parallel. The blocks don't depend on the number
+        // of threads, so per-block results that are combined in block order give the same answer for any number of threads.
+        template <typename FunctionType>
+        void ParallelForEachBlock(Range range, FunctionType function);
+        size_t NumBlocks(Range range) const;
+
         //
         // implementation specific functions that must be implemented by a derived class
         //
@@ -187,6 +202,14 @@ namespace trainers
         virtual SplitCandidate GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) = 0;
         virtual std::vector<EdgePredictorType> GetEdgePredictors(const NodeStats& nodeStats) = 0;
 
+        // finds the best split of each child of a node that was just split; the default calls GetBestSplitRuleAtNode on each child,
+        // derived classes can override this to share work between siblings
+        virtual std::vector<SplitCandidate> GetBestSplitRulesAtChildren(const SplitCandidate& parent, size_t interiorNodeIndex);
+
+        // writes the child each example in a block of rows goes to under a split rule; the default evaluates the rule on the
+        // examples' data vectors, derived classes that keep the features in another form (and drop the data vectors) override it
+        virtual void GetChildPositions(Range block, const SplitRuleType& splitRule, size_t* childPositions) const;
+
         //
         // member variables
         //
@@ -203,6 +226,9 @@ namespace trainers
 
         // the data set
         data::Dataset<TrainerExampleType> _dataset;
+
+        // threads used to search for splits and to update the data set
+        utilities::ThreadPool _threadPool;
     };
 } // namespace trainers
 } // namespace ell
@@ -220,7 +246,8 @@ namespace trainers
     ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::ForestTrainer(const BoosterType& booster, const ForestTrainerParameters& parameters) :
         _booster(booster),
         _parameters(parameters),
-        _forest()
+        _forest(),
+        _threadPool(parameters.numThreads)
     {
     }
 
@@ -231,14 +258,17 @@ namespace trainers
         _dataset = data::Dataset<TrainerExampleType>(anyDataset);
 
         // initalizes the special fields in the dataset metadata: weak weight and label, currentOutput
-        for (size_t rowIndex = 0; rowIndex < _dataset.NumExamples(); ++rowIndex)
-        {
-            auto& example = _dataset[rowIndex];
-            auto prediction = _forest.Predict(example.GetDataVector());
-            auto& metadata = example.GetMetadata();
-            metadata.currentOutput = prediction;
-            metadata.weak = _booster.GetWeakWeightLabel(metadata.strong, prediction);
-        }
+        ParallelForEachBlock(Range{ 0, _dataset.NumExamples() }, [this](Range block, size_t) {
+            for (size_t rowIndex = block.firstIndex; rowIndex < block.firstIndex + block.size; ++rowIndex)
+            {
+                auto& example = _dataset[rowIndex];
+                auto prediction = _forest.Predict(example.GetDataVector());
+                auto& metadata = example.GetMetadata();
+                metadata.exampleIndex = rowIndex;
+                metadata.currentOutput = prediction;
+                metadata.weak = _booster.GetWeakWeightLabel(metadata.strong, prediction);
+            }
+        });
     }
 
     template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
@@ -292,13 +322,22 @@ namespace trainers
     template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
     auto ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SetWeakWeightsLabels() -> Sums
     {
-        Sums sums;
+        Range range{ 0, _dataset.NumExamples() };
+        std::vector<Sums> blockSums(NumBlocks(range));
+        ParallelForEachBlock(range, [this, &blockSums](Range block, size_t blockIndex) {
+            for (size_t rowIndex = block.firstIndex; rowIndex < block.firstIndex + block.size; ++rowIndex)
+            {
+                auto& metadata = _dataset[rowIndex].GetMetadata();
+                metadata.weak = _booster.GetWeakWeightLabel(metadata.strong, metadata.currentOutput);
+                blockSums[blockIndex].Increment(metadata.weak);
+            }
+        });
 
-        for (size_t rowIndex = 0; rowIndex < _dataset.NumExamples(); ++rowIndex)
+        Sums sums;
+        for (const auto& blockSum : blockSums)
         {
-            auto& metadata = _dataset[rowIndex].GetMetadata();
-            metadata.weak = _booster.GetWeakWeightLabel(metadata.strong, metadata.currentOutput);
-            sums.Increment(metadata.weak);
+            sums.sumWeights += blockSum.sumWeights;
+            sums.sumWeightedLabels += blockSum.sumWeightedLabels;
         }
 
         if (sums.sumWeights == 0.0)
@@ -312,21 +351,24 @@ namespace trainers
     template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
     void ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::UpdateCurrentOutputs(double value)
     {
-        for (size_t rowIndex = 0; rowIndex < _dataset.NumExamples(); ++rowIndex)
-        {
-            auto& example = _dataset[rowIndex];
-            example.GetMetadata().currentOutput += value;
-        }
+        ParallelForEachBlock(Range{ 0, _dataset.NumExamples() }, [this, value](Range block, size_t) {
+            for (size_t rowIndex = block.firstIndex; rowIndex < block.firstIndex + block.size; ++rowIndex)
+            {
+                _dataset[rowIndex].GetMetadata().currentOutput += value;
+            }
+        });
     }
 
     template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
     void ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::UpdateCurrentOutputs(Range range, const EdgePredictorType& edgePredictor)
     {
-        for (size_t rowIndex = range.firstIndex; rowIndex < range.firstIndex + range.size; ++rowIndex)
-        {
-            auto& example = _dataset[rowIndex];
-            example.GetMetadata().currentOutput += edgePredictor.Predict(example.GetDataVector());
-        }
+        ParallelForEachBlock(range, [this, &edgePredictor](Range block, size_t) {
+            for (size_t rowIndex = block.firstIndex; rowIndex < block.firstIndex + block.size; ++rowIndex)
+            {
+                auto& example = _dataset[rowIndex];
+                example.GetMetadata().currentOutput += edgePredictor.Predict(example.GetDataVector());
+            }
+        });
     }
 
     template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
@@ -373,34 +415,81 @@ namespace trainers
             }
 
             // queue new split candidates
-            for (size_t i = 0; i < splitCandidate.splitRule.NumOutputs(); ++i)
+            for (auto& childSplitCandidate : GetBestSplitRulesAtChildren(splitCandidate, interiorNodeIndex))
             {
-                auto splitCandidate = GetBestSplitRuleAtNode(_forest.GetChildId(interiorNodeIndex, i), ranges.GetChildRange(i), stats.GetChildSums(i));
-                if (splitCandidate.gain > _parameters.minSplitGain)
+                if (childSplitCandidate.gain > _parameters.minSplitGain)
                 {
-                    _queue.push(std::move(splitCandidate));
+                    _queue.push(std::move(childSplitCandidate));
                 }
             }
         }
     }
 
+    template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
+    auto ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::GetBestSplitRulesAtChildren(const SplitCandidate& parent, size_t interiorNodeIndex) -> std::vector<SplitCandidate>
+    {
+        std::vector<SplitCandidate> childSplitCandidates;
+        for (size_t i = 0; i < parent.splitRule.NumOutputs(); ++i)
+        {
+            childSplitCandidates.push_back(GetBestSplitRuleAtNode(_forest.GetChildId(interiorNodeIndex, i), parent.ranges.GetChildRange(i), parent.stats.GetChildSums(i)));
+        }
+        return childSplitCandidates;
+    }
+
     template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
     void ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SortNodeDataset(Range range, const SplitRuleType& splitRule)
     {
-        if (splitRule.NumOutputs() == 2)
+        // evaluate the split rule on each example in parallel, then move the examples to their child's range, keeping their relative order
+        // (a stable partition, so that the order of the examples, and hence the trained forest, doesn't depend on the number of threads)
+        std::vector<size_t> childPositions(range.size);
+        ParallelForEachBlock(range, [this, &splitRule, &childPositions, range](Range block, size_t) {
+            GetChildPositions(block, splitRule, childPositions.data() + (block.firstIndex - range.firstIndex));
+        });
+
+        std::vector<TrainerExampleType> examples;
+        examples.reserve(range.size);
+        for (size_t childPosition = 0; childPosition < splitRule.NumOutputs(); ++childPosition)
+        {
+            for (size_t index = 0; index < range.size; ++index)
+            {
+                if (childPositions[index] == childPosition)
+                {
+                    examples.push_back(std::move(_dataset[range.firstIndex + index]));
+                }
+            }
+        }
+
+        for (size_t index = 0; index < range.size; ++index)
         {
-            _dataset.Partition([splitRule](const data::Example<DataVectorType, TrainerMetadata>& example) { return splitRule.Predict(example.GetDataVector()) == 0; },
-                               range.firstIndex,
-                               range.size);
+            _dataset[range.firstIndex + index] = std::move(examples[index]);
         }
-        else
+    }
+
+    template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
+    void ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::GetChildPositions(Range block, const SplitRuleType& splitRule, size_t* childPositions) const
+    {
+        for (size_t index = 0; index < block.size; ++index)
         {
-            _dataset.Sort([splitRule](const data::Example<DataVectorType, TrainerMetadata>& example) { return splitRule.Predict(example.GetDataVector()); },
-                          range.firstIndex,
-                          range.size);
+            childPositions[index] = splitRule.Predict(_dataset[block.firstIndex + index].GetDataVector());
         }
     }
 
+    template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
+    template <typename FunctionType>
+    void ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::ParallelForEachBlock(Range range, FunctionType function)
+    {
+        _threadPool.ParallelFor(NumBlocks(range), [range, &function](size_t blockIndex) {
+            auto blockOffset = blockIndex * rowBlockSize;
+            function(Range{ range.firstIndex + blockOffset, std::min(rowBlockSize, range.size - blockOffset) }, blockIndex);
+        });
+    }
+
+    template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
+    size_t ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::NumBlocks(Range range) const
+    {
+        return (range.size + rowBlockSize - 1) / rowBlockSize;
+    }
+
     //
     // debugging code
     //
@@ -16,6 +16,7 @@
 
 #include <random>
 #include <tuple>
+#include <vector>
 
 namespace ell
 {
@@ -56,6 +57,7 @@ namespace trainers
 
     protected:
         using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_dataset;
+        using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_threadPool;
         SplitCandidate GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) override;
         std::vector<EdgePredictorType> GetEdgePredictors(const NodeStats& nodeStats) override;
 
@@ -116,26 +118,39 @@ namespace trainers
 
         auto splitRuleCandidates = CallThresholdFinder(range);
 
-        for (const auto& splitRuleCandidate : splitRuleCandidates)
+        // evaluate the candidates in parallel
+        std::vector<std::tuple<Sums, size_t>> evaluations(splitRuleCandidates.size());
+        _threadPool.ParallelFor(splitRuleCandidates.size(), [this, range, &splitRuleCandidates, &evaluations](size_t index) {
+            evaluations[index] = EvaluateSplitRule(splitRuleCandidates[index], range);
+        });
+
+        // find the gain maximizer in candidate order, so the result doesn't depend on the number of threads
+        size_t bestIndex = splitRuleCandidates.size();
+        for (size_t index = 0; index < splitRuleCandidates.size(); ++index)
         {
             Sums sums0;
             size_t size0;
+            std::tie(sums0, size0) = evaluations[index];
 
-            std::tie(sums0, size0) = EvaluateSplitRule(splitRuleCandidate, range);
-
-            Sums sums1 = sums - sums0;
-            double gain = CalculateGain(sums, sums0, sums1);
-
-            // find gain maximizer
+            double gain = CalculateGain(sums, sums0, sums - sums0);
             if (gain > bestSplitCandidate.gain)
             {
                 bestSplitCandidate.gain = gain;
-                bestSplitCandidate.splitRule = splitRuleCandidate;
-                bestSplitCandidate.ranges.SplitChildRange(0, size0);
-                bestSplitCandidate.stats.SetChildSums({ sums0, sums1 });
+                bestIndex = index;
             }
         }
 
+        if (bestIndex < splitRuleCandidates.size())
+        {
+            Sums sums0;
+            size_t size0;
+            std::tie(sums0, size0) = evaluations[bestIndex];
+
+            bestSplitCandidate.splitRule = splitRuleCandidates[bestIndex];
+            bestSplitCandidate.ranges.SplitChildRange(0, size0);
+            bestSplitCandidate.stats.SetChildSums({ sums0, sums - sums0 });
+        }
+
         return bestSplitCandidate;
     }
 
@@ -0,0 +1,271 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     HogwildSGDTrainer.h (trainers)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ITrainer.h"
+#include "SGDTrainer.h"
+
+#include <predictors/include/LinearPredictor.h>
+
+#include <data/include/Dataset.h>
+#include <data/include/Example.h>
+#include <data/include/PermutedDataset.h>
+
+#include <math/include/Vector.h>
+
+#include <utilities/include/ThreadPool.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace ell
+{
+namespace trainers
+{
+    /// <summary> Parameters for the Hogwild stochastic gradient descent trainer. </summary>
+    struct HogwildSGDTrainerParameters : public SGDTrainerParameters
+    {
+        size_t numThreads = 0; // zero means one thread per hardware thread
+    };
+
+    /// <summary>
+    /// Base class for Hogwild trainers (Niu et al., 2011). Each epoch, the permuted dataset is split into one
+    /// contiguous range per thread, and the threads update shared state without locks. Sparse examples touch
+    /// few coordinates, so concurrent updates rarely collide, and an occasional lost update doesn't hurt
+    /// convergence. Unlike the other trainers, the result depends on thread timing, so it is only
+    /// reproducible when run on a single thread.
+    /// </summary>
+    class HogwildSGDTrainerBase : public ITrainer<predictors::LinearPredictor<double>>
+    {
+    public:
+        using PredictorType = predictors::LinearPredictor<double>;
+
+        /// <summary> Sets the trainer's dataset. </summary>
+        ///
+        /// <param name="anyDataset"> A dataset. </param>
+        void SetDataset(const data::AnyDataset& anyDataset) override;
+
+        /// <summary> Updates the state of the trainer by performing a learning epoch. </summary>
+        void Update() override;
+
+        /// <summary> Returns The averaged predictor. </summary>
+        ///
+        /// <returns> A const reference to the averaged predictor. </returns>
+        const PredictorType& GetPredictor() const override { return GetAveragedPredictor(); }
+
+    protected:
+        // Instances of the base class cannot be created directly
+        HogwildSGDTrainerBase(const HogwildSGDTrainerParameters& parameters);
+
+        // called concurrently from several threads; stepIndex is the global 1-based index of the step
+        virtual void DoStep(const data::AutoDataVector& x, double y, double weight, size_t stepIndex) = 0;
+        virtual void ResizeTo(size_t size) = 0;
+        virtual const PredictorType& GetAveragedPredictor() const = 0;
+
+        // returns 1 + 1/2 + ... + 1/n
+        static double GetHarmonicNumber(size_t n);
+
+        // lock-free addition to a shared double
+        static void AtomicAdd(std::atomic<double>& target, double value);
+
+        // a vector that several threads read and update without locks. Its elements are atomics accessed with relaxed
+        // ordering, so no read or write is torn; concurrent updates of the same element can overwrite each other, which Hogwild tolerates
+        class SharedVector
+        {
+        public:
+            size_t Size() const { return _size; }
+
+            // not thread safe, keeps the current values
+            void Resize(size_t size);
+
+            double operator[](size_t index) const { return _values[index].load(std::memory_order_relaxed); }
+
+            double Dot(const data::AutoDataVector& x) const;
+
+            // adds scale * x, but not atomically as a whole or per element
+            void AddScaled(double scale, const data::AutoDataVector& x);
+
+        private:
+            std::unique_ptr<std::atomic<double>[]> _values;
+            size_t _size = 0;
+        };
+
+        size_t GetNumSteps() const { return _numSteps; }
+
+    private:
+        data::PermutedDataset _dataset;
+        std::default_random_engine _random;
+        utilities::ThreadPool _threadPool;
+        std::atomic<size_t> _numSteps{ 0 };
+    };
+
+    /// <summary>
+    /// A Hogwild version of SparseDataSGDTrainer. The shared state is the gradient sums of the sparse SGD
+    /// formulation, so each step only writes to the coordinates where the example is nonzero. With one
+    /// thread, it trains the same predictor as SparseDataSGDTrainer (up to rounding).
+    /// </summary>
+    ///
+    /// <typeparam name="LossFunctionType"> Loss function type. </typeparam>
+    template <typename LossFunctionType>
+    class HogwildSGDTrainer : public HogwildSGDTrainerBase
+    {
+    public:
+        using HogwildSGDTrainerBase::PredictorType;
+
+        /// <summary> Constructs an instance of HogwildSGDTrainer. </summary>
+        ///
+        /// <param name="lossFunction"> The loss function. </param>
+        /// <param name="parameters"> The training parameters. </param>
+        HogwildSGDTrainer(const LossFunctionType& lossFunction, const HogwildSGDTrainerParameters& parameters);
+
+        /// <summary> Returns a const reference to the last predictor. </summary>
+        ///
+        /// <returns> A const reference to the last predictor. </returns>
+        const PredictorType& GetLastPredictor() const;
+
+        /// <summary> Returns a const reference to the averaged predictor. </summary>
+        ///
+        /// <returns> A const reference to the averaged predictor. </returns>
+        const PredictorType& GetAveragedPredictor() const override;
+
+    protected:
+        void DoStep(const data::AutoDataVector& x, double y, double weight, size_t stepIndex) override;
+        void ResizeTo(size_t size) override;
+
+    private:
+        LossFunctionType _lossFunction;
+        HogwildSGDTrainerParameters _parameters;
+
+        // these variables follow the notation in https://arxiv.org/abs/1612.09147, except that the harmonic-weighted
+        // bias sum _b replaces the running sum _c, because _c can't be updated out of order
+        SharedVector _v; // gradient sum - weights
+        SharedVector _u; // harmonic-weighted gradient sum - weights
+        std::atomic<double> _a{ 0 }; // gradient sum - bias
+        std::atomic<double> _b{ 0 }; // harmonic-weighted gradient sum - bias
+
+        // these variables are mutable because we calculate them in a lazy manner (only when `GetPredictor() const` is called)
+        mutable PredictorType _lastPredictor;
+        mutable PredictorType _averagedPredictor;
+    };
+
+    /// <summary> Makes a Hogwild SGD linear trainer. </summary>
+    ///
+    /// <typeparam name="LossFunctionType"> Type of loss function to use. </typeparam>
+    /// <param name="lossFunction"> The loss function. </param>
+    /// <param name="parameters"> The trainer parameters. </param>
+    ///
+    /// <returns> A linear trainer </returns>
+    template <typename LossFunctionType>
+    std::unique_ptr<trainers::ITrainer<predictors::LinearPredictor<double>>> MakeHogwildSGDTrainer(const LossFunctionType& lossFunction, const HogwildSGDTrainerParameters& parameters);
+} // namespace trainers
+} // namespace ell
+
+#pragma region implementation
+
+#include <data/include/DataVector.h>
+#include <data/include/DataVectorOperations.h>
+
+#include <math/include/VectorOperations.h>
+
+namespace ell
+{
+namespace trainers
+{
+    template <typename LossFunctionType>
+    HogwildSGDTrainer<LossFunctionType>::HogwildSGDTrainer(const LossFunctionType& lossFunction, const HogwildSGDTrainerParameters& parameters) :
+        HogwildSGDTrainerBase(parameters),
+        _lossFunction(lossFunction),
+        _parameters(parameters)
+    {
+    }
+
+    template <typename LossFunctionType>
+    void HogwildSGDTrainer<LossFunctionType>::DoStep(const data::AutoDataVector& x, double y, double weight, size_t stepIndex)
+    {
+        // apply the predictor; the reads of _v may miss other threads' concurrent writes, which Hogwild tolerates
+        const double lambda = _parameters.regularization;
+        double p = 0;
+        if (stepIndex > 1)
+        {
+            double d = _v.Dot(x);
+            p = -(d + _a.load(std::memory_order_relaxed)) / (lambda * (stepIndex - 1.0));
+        }
+
+        // get the derivative
+        double g = weight * _lossFunction.GetDerivative(p, y);
+        if (g == 0)
+        {
+            return;
+        }
+
+        // update
+        double h = GetHarmonicNumber(stepIndex - 1);
+        _v.AddScaled(g, x);
+        AtomicAdd(_a, g);
+        _u.AddScaled(h * g, x);
+        AtomicAdd(_b, h * g);
+    }
+
+    template <typename LossFunctionType>
+    void HogwildSGDTrainer<LossFunctionType>::ResizeTo(size_t size)
+    {
+        if (size > _v.Size())
+        {
+            _v.Resize(size);
+            _u.Resize(size);
+        }
+    }
+
+    template <typename LossFunctionType>
+    auto HogwildSGDTrainer<LossFunctionType>::GetLastPredictor() const -> const PredictorType&
+    {
+        const double lambda = _parameters.regularization;
+        const double t = static_cast<double>(GetNumSteps());
+        _lastPredictor.Resize(_v.Size());
+        auto& w = _lastPredictor.GetWeights();
+
+        // define last predictor based on _v, _a, t
+        for (size_t i = 0; i < _v.Size(); ++i)
+        {
+            w[i] = -_v[i] / (lambda * t);
+        }
+        _lastPredictor.GetBias() = -_a / (lambda * t);
+        return _lastPredictor;
+    }
+
+    template <typename LossFunctionType>
+    auto HogwildSGDTrainer<LossFunctionType>::GetAveragedPredictor() const -> const PredictorType&
+    {
+        const double lambda = _parameters.regularization;
+        const double t = static_cast<double>(GetNumSteps());
+        const double h = GetHarmonicNumber(GetNumSteps());
+        _averagedPredictor.Resize(_v.Size());
+        auto& w = _averagedPredictor.GetWeights();
+
+        // define averaged predictor based on _v, _u, _a, _b, t
+        for (size_t i = 0; i < _v.Size(); ++i)
+        {
+            w[i] = (_u[i] - h * _v[i]) / (lambda * t);
+        }
+
+        _averagedPredictor.GetBias() = -(h * _a - _b) / (lambda * t);
+        return _averagedPredictor;
+    }
+
+    template <typename LossFunctionType>
+    std::unique_ptr<ITrainer<predictors::LinearPredictor<double>>> MakeHogwildSGDTrainer(const LossFunctionType& lossFunction, const HogwildSGDTrainerParameters& parameters)
+    {
+        return std::make_unique<HogwildSGDTrainer<LossFunctionType>>(lossFunction, parameters);
+    }
+} // namespace trainers
+} // namespace ell
+
+#pragma endregion implementation
@@ -10,16 +10,35 @@
 
 #include <math/include/Matrix.h>
 
+#include <utilities/include/ThreadPool.h>
+
 #include <cstddef>
 #include <map>
 #include <memory>
+#include <random>
+#include <string>
+#include <vector>
 
 namespace ell
 {
 namespace trainers
 {
-    /// <summary> Impements KMeansTrainer++ algorithm </summary>
-    ///
+    /// <summary> Parameters for the k-means trainer. </summary>
+    struct KMeansTrainerParameters
+    {
+        size_t numThreads = 1; // zero means one thread per hardware thread; the result doesn't depend on this
+        size_t blockSize = 256; // number of points whose distances to the means are computed together
+        size_t miniBatchSize = 0; // zero means full-batch (Lloyd) iterations
+        std::string randomSeedString = "ABCDEFG";
+    };
+
+    /// <summary>
+    /// Impements the k-means algorithm with k-means++ seeding (Arthur and Vassilvitskii, 2007). Distances are
+    /// computed as ||x||^2 - 2 x.mu + ||mu||^2 one block of points at a time, so the cross terms are a matrix
+    /// product and no n x k matrix is ever allocated. Blocks are spread over a thread pool. When miniBatchSize is
+    /// nonzero, each iteration instead moves the means toward a random batch of points with a per-mean learning
+    /// rate (Sculley, 2010).
+    /// </summary>
     class KMeansTrainer
     {
     public:
@@ -29,16 +48,18 @@ namespace trainers
         /// <param name="dimension"> The input dimension. </param>
         /// <param name="numClusters"> The number of clusters. </param>
         /// <param name="iterations"> The number of iterations. </param>
+        /// <param name="parameters"> The trainer parameters. </param>
         ///
-        KMeansTrainer(size_t dimension, size_t numClusters, size_t iterations);
+        KMeansTrainer(size_t dimension, size_t numClusters, size_t iterations, const KMeansTrainerParameters& parameters = {});
 
         /// <summary> Constructs an instance of KMeansTrainer trainer </summary>
         ///
         /// <param name="numClusters"> The number of clusters. </param>
         /// <param name="iterations"> The number of iterations. </param>
         /// <param name="means"> The cluster means. </param>
+        /// <param name="parameters"> The trainer parameters. </param>
         ///
-        KMeansTrainer(size_t numClusters, size_t iters, math::ColumnMatrix<double> means);
+        KMeansTrainer(size_t numClusters, size_t iters, math::ColumnMatrix<double> means, const KMeansTrainerParameters& parameters = {});
 
         /// <summary> Runs the KMeansTrainer algorithm. </summary>
         ///
@@ -56,21 +77,35 @@ namespace trainers
         /// <returns> The underlying cluster assignment matrix. </returns>
         const math::ColumnVector<double>& GetClusterAssignment() const { return _clusterAssignment; }
 
+        /// <summary> Returns the sum of squared distances from each point to its closest mean, after the last call to RunKMeans. </summary>
+        ///
+        /// <returns> The k-means objective. </returns>
+        double GetTotalDistance() const { return _totalDistance; }
+
     private:
+        using ConstColumnMatrixReference = math::ConstMatrixReference<double, math::MatrixLayout::columnMajor>;
+
         // Initializes the cluster means using the KMeansTrainer++ strategy.
-        void initializeMeans(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X);
+        void initializeMeans(ConstColumnMatrixReference X, const std::vector<double>& xSqNorms);
 
-        // Distance of points to all the cluster means.
-        math::RowMatrix<double> pairwiseDistance(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> mu);
+        // Squared norm of each column.
+        std::vector<double> columnSquaredNorms(ConstColumnMatrixReference X);
 
-        // Assign each point to the closest mean.
-        double assignClosestCenter(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, math::VectorReference<size_t, math::VectorOrientation::column> clusterAssignment);
+        // Assign each point to the closest mean, one block of points at a time. Returns the sum of squared distances.
+        double assignClosestCenter(ConstColumnMatrixReference X, const std::vector<double>& xSqNorms, std::vector<size_t>& clusterAssignment);
 
         // Recompute the cluster means.
-        void recomputeMeans(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, const math::ColumnVector<size_t> clusterAssignment);
+        void recomputeMeans(ConstColumnMatrixReference X, const std::vector<size_t>& clusterAssignment);
+
+        // Move the means toward a random batch of points.
+        void updateMeansMiniBatch(ConstColumnMatrixReference X, const std::vector<double>& xSqNorms, std::vector<size_t>& numPointsPerCluster);
 
         // Weighted sampling.
-        size_t weightedSample(math::ColumnVector<double> weights);
+        size_t weightedSample(const std::vector<double>& weights);
+
+        KMeansTrainerParameters _parameters;
+        utilities::ThreadPool _threadPool;
+        std::default_random_engine _random;
 
         // Cluster means.
         math::ColumnMatrix<double> _means;
@@ -81,6 +116,9 @@ namespace trainers
         // Cluster assignment for each data point.
         math::ColumnVector<double> _clusterAssignment;
 
+        // Sum of squared distances to the closest mean.
+        double _totalDistance = 0;
+
         // Number of iterations of KMeansTrainer algorithm.
         size_t _iterations = 0;
 
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "KMeansTrainer.h"
+
 #include <math/include/Matrix.h>
 
 #include <cstddef>
@@ -21,10 +23,13 @@ namespace trainers
     class ProtoNNInit
     {
     public:
-        /// <summary> Returns the underlying projection matrix. </summary>
+        /// <summary> Constructs the initializer for the prototypes of a ProtoNN model. </summary>
         ///
-        /// <returns> The underlying projection matrix. </returns>
-        ProtoNNInit(size_t dim, size_t numLabels, size_t numPrototypesPerLabel);
+        /// <param name="dim"> The projected dimension. </param>
+        /// <param name="numLabels"> The number of labels. </param>
+        /// <param name="numPrototypesPerLabel"> The number of prototypes per label. </param>
+        /// <param name="kMeansParameters"> The parameters of the k-means runs that find each label's prototypes. </param>
+        ProtoNNInit(size_t dim, size_t numLabels, size_t numPrototypesPerLabel, const KMeansTrainerParameters& kMeansParameters = {});
 
         /// <summary> Returns the underlying projection matrix. </summary>
         ///
@@ -51,6 +56,8 @@ namespace trainers
 
         size_t _numPrototypesPerLabel;
 
+        KMeansTrainerParameters _kMeansParameters;
+
         // Returns the underlying projection matrix.
         math::ColumnMatrix<double> _B;
 
@@ -68,6 +68,12 @@ namespace trainers
 
         ///<summary>Whether to output diagnostic information to std::cout.</summary>
         bool verbose;
+
+        ///<summary>The number of threads to compute kernels and gradients on (zero means one per hardware thread)</summary>
+        size_t numThreads = 1;
+
+        ///<summary>The number of examples in each stochastic gradient step (zero means full-batch gradient steps)</summary>
+        size_t batchSize = 256;
     };
 
 } // namespace trainers
@@ -20,6 +20,8 @@
 #include <data/include/Dataset.h>
 #include <data/include/Example.h>
 
+#include <utilities/include/ThreadPool.h>
+
 #include <cstddef>
 #include <map>
 #include <memory>
@@ -42,7 +44,9 @@ namespace trainers
     using ProtoNNModelMap = std::map<ProtoNNParameterIndex, std::shared_ptr<ProtoNNModelParameter>>;
 
     /// <summary>
-    /// Implements the ProtoNN trainer
+    /// Implements the ProtoNN trainer. The similarity kernel and the gradients of each batch are computed on a thread
+    /// pool, one contiguous range of examples per thread, and the per-range gradients are added in range order. The
+    /// projected inputs WX are kept between updates and only recomputed after the projection W changes.
     /// </summary>
     class ProtoNNTrainer : public ITrainer<predictors::ProtoNNPredictor>
     {
@@ -81,6 +85,12 @@ namespace trainers
         // The Training Loss.
         double Loss(ConstColumnMatrixReference Y, ConstColumnMatrixReference D);
 
+        // Projects the inputs, one block of examples at a time: WX = W * X.
+        void ComputeWX(ConstColumnMatrixReference W, ConstColumnMatrixReference X, math::ColumnMatrixReference<double> WX);
+
+        // The gradient w.r.t. the given parameter over the examples [begin, end), computed in parallel.
+        math::ColumnMatrix<double> Gradient(ProtoNNParameterIndex parameterIndex, ConstColumnMatrixReference X, ConstColumnMatrixReference Y, math::ColumnMatrixReference<double> WX, double gamma, size_t begin, size_t end, bool recomputeWX);
+
         // The Objective function value.
         double ComputeObjective(ConstColumnMatrixReference X, ConstColumnMatrixReference Y, math::ColumnMatrixReference<double> WX, double gamma, bool recomputeWX = false);
 
@@ -117,6 +127,11 @@ namespace trainers
 
         math::ColumnMatrix<double> _X;
         math::ColumnMatrix<double> _Y;
+
+        // The projected inputs, consistent with the current projection matrix between updates
+        math::ColumnMatrix<double> _WX;
+
+        utilities::ThreadPool _threadPool;
     };
 
     /// <summary>
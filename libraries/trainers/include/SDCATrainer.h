@@ -14,10 +14,14 @@
 
 #include <data/include/Dataset.h>
 #include <data/include/Example.h>
+#include <data/include/PermutedDataset.h>
 
 #include <math/include/Vector.h>
 
+#include <utilities/include/ThreadPool.h>
+
 #include <random>
+#include <vector>
 
 namespace ell
 {
@@ -31,6 +35,8 @@ namespace trainers
         size_t maxEpochs;
         bool permute;
         std::string randomSeedString;
+        size_t batchSize = 1; // the number of dual variables updated together; 1 means sequential SDCA
+        size_t numThreads = 1; // zero means one thread per hardware thread; the trained predictor doesn't depend on this
     };
 
     /// <summary> Information about the result of an SDCA training session. </summary>
@@ -41,7 +47,13 @@ namespace trainers
         size_t numEpochsPerformed = 0;
     };
 
-    /// <summary> Implements the stochastic dual coordinate ascent linear trainer. </summary>
+    /// <summary>
+    /// Implements the stochastic dual coordinate ascent linear trainer. When the batch size is greater than one,
+    /// the trainer runs mini-batch SDCA: the dual updates of a batch are computed in parallel against the same
+    /// predictor, each with its step size divided by the batch size (which makes adding them all up safe, see
+    /// Ma et al., "Adding vs. Averaging in Distributed Primal-Dual Optimization", 2015), and the predictor is
+    /// updated once per batch.
+    /// </summary>
     ///
     /// <typeparam name="LossFunctionType"> Loss function type. </typeparam>
     /// <typeparam name="RegularizerType"> Regularizer type. </typeparam>
@@ -90,19 +102,22 @@ namespace trainers
         };
 
         using DataVectorType = typename predictors::LinearPredictor<double>::DataVectorType;
-        using TrainerExampleType = data::Example<DataVectorType, TrainerMetadata>;
 
-        void Step(TrainerExampleType& x);
+        void Step(size_t position);
+        void BatchStep(size_t fromPosition, size_t size);
+        double GetNewDual(const DataVectorType& dataVector, const TrainerMetadata& metadata, double stepScale) const;
         void ComputeObjectives();
-        void ResizeTo(const data::AutoDataVector& x);
+        void ResizeTo(size_t size);
 
         LossFunctionType _lossFunction;
         RegularizerType _regularizer;
         SDCATrainerParameters _parameters;
         std::default_random_engine _random;
+        utilities::ThreadPool _threadPool;
         double _inverseScaledRegularization;
 
-        data::Dataset<TrainerExampleType> _dataset;
+        data::PermutedDataset _dataset;
+        std::vector<TrainerMetadata> _metadata; // indexed by the examples' original order
 
         predictors::LinearPredictor<double> _predictor;
         SDCAPredictorInfo _predictorInfo;
@@ -110,6 +125,7 @@ namespace trainers
         math::ColumnVector<double> _v;
         double _d = 0;
         math::RowVector<double> _a;
+        std::vector<double> _batchDuals;
     };
 
     //
@@ -134,6 +150,8 @@ namespace trainers
 
 #include <utilities/include/RandomEngines.h>
 
+#include <algorithm>
+
 namespace ell
 {
 namespace trainers
@@ -142,7 +160,8 @@ namespace trainers
     SDCATrainer<LossFunctionType, RegularizerType>::SDCATrainer(const LossFunctionType& lossFunction, const RegularizerType& regularizer, const SDCATrainerParameters& parameters) :
         _lossFunction(lossFunction),
         _regularizer(regularizer),
-        _parameters(parameters)
+        _parameters(parameters),
+        _threadPool(parameters.numThreads)
     {
         _random = utilities::GetRandomEngine(parameters.randomSeedString);
     }
@@ -152,22 +171,29 @@ namespace trainers
     {
         DEBUG_THROW(_v.Norm0() != 0, utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "can only call SetDataset before updates"));
 
-        _dataset = data::Dataset<TrainerExampleType>(anyDataset);
+        _dataset = data::PermutedDataset(anyDataset);
         auto numExamples = _dataset.NumExamples();
         _inverseScaledRegularization = 1.0 / (numExamples * _parameters.regularization);
 
         _predictorInfo.primalObjective = 0;
         _predictorInfo.dualObjective = 0;
 
-        // precompute the norm of each example
+        // precompute the norm of each example, and size the predictor for the whole dataset
+        _metadata.clear();
+        _metadata.reserve(numExamples);
+        size_t size = 0;
         for (size_t rowIndex = 0; rowIndex < numExamples; ++rowIndex)
         {
-            auto& example = _dataset[rowIndex];
-            example.GetMetadata().norm2Squared = example.GetDataVector().Norm2Squared();
-
-            auto label = example.GetMetadata().weightLabel.label;
-            _predictorInfo.primalObjective += _lossFunction(0, label) / numExamples;
+            _dataset.VisitExample(rowIndex, [&](const data::AutoSupervisedExample& example) {
+                TrainerMetadata metadata(example.GetMetadata());
+                metadata.norm2Squared = example.GetDataVector().Norm2Squared();
+                _metadata.push_back(metadata);
+                size = std::max(size, example.GetDataVector().PrefixLength());
+
+                _predictorInfo.primalObjective += _lossFunction(0, metadata.weightLabel.label) / numExamples;
+            });
         }
+        ResizeTo(size);
     }
 
     template <typename LossFunctionType, typename RegularizerType>
@@ -179,9 +205,20 @@ namespace trainers
         }
 
         // Iterate
-        for (size_t i = 0; i < _dataset.NumExamples(); ++i)
+        auto numExamples = _dataset.NumExamples();
+        if (_parameters.batchSize <= 1)
         {
-            Step(_dataset[i]);
+            for (size_t i = 0; i < numExamples; ++i)
+            {
+                Step(i);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < numExamples; i += _parameters.batchSize)
+            {
+                BatchStep(i, std::min(_parameters.batchSize, numExamples - i));
+            }
         }
 
         // Finish
@@ -194,21 +231,13 @@ namespace trainers
     {}
 
     template <typename LossFunctionType, typename RegularizerType>
-    void SDCATrainer<LossFunctionType, RegularizerType>::Step(TrainerExampleType& example)
+    void SDCATrainer<LossFunctionType, RegularizerType>::Step(size_t position)
     {
-        const auto& dataVector = example.GetDataVector();
-        ResizeTo(dataVector);
-
-        auto weightLabel = example.GetMetadata().weightLabel;
-        auto norm2Squared = example.GetMetadata().norm2Squared + 1; // add one because of bias term
-        auto lipschitz = norm2Squared * _inverseScaledRegularization;
-        auto dual = example.GetMetadata().dualVariable;
-
-        if (lipschitz > 0)
-        {
-            auto prediction = _predictor.Predict(dataVector);
-
-            auto newDual = _lossFunction.ConjugateProx(1.0 / lipschitz, dual + prediction / lipschitz, weightLabel.label);
+        auto& metadata = _metadata[_dataset.GetExampleIndex(position)];
+        _dataset.VisitExample(position, [&](const data::AutoSupervisedExample& example) {
+            const auto& dataVector = example.GetDataVector();
+            auto dual = metadata.dualVariable;
+            auto newDual = GetNewDual(dataVector, metadata, 1.0);
             auto dualDiff = newDual - dual;
 
             if (dualDiff != 0)
@@ -216,9 +245,61 @@ namespace trainers
                 _v.Transpose() += (-dualDiff * _inverseScaledRegularization) * dataVector;
                 _d += (-dualDiff * _inverseScaledRegularization);
                 _regularizer.ConjugateGradient(_v, _d, _predictor.GetWeights(), _predictor.GetBias());
-                example.GetMetadata().dualVariable = newDual;
+                metadata.dualVariable = newDual;
+            }
+        });
+    }
+
+    template <typename LossFunctionType, typename RegularizerType>
+    void SDCATrainer<LossFunctionType, RegularizerType>::BatchStep(size_t fromPosition, size_t size)
+    {
+        // compute the new dual variables in parallel, all against the current predictor
+        _batchDuals.resize(size);
+        auto stepScale = 1.0 / static_cast<double>(_parameters.batchSize);
+        _threadPool.ParallelFor(size, [&](size_t i) {
+            const auto& metadata = _metadata[_dataset.GetExampleIndex(fromPosition + i)];
+            _dataset.VisitExample(fromPosition + i, [&](const data::AutoSupervisedExample& example) {
+                _batchDuals[i] = GetNewDual(example.GetDataVector(), metadata, stepScale);
+            });
+        });
+
+        // apply them in order, so that the result doesn't depend on the number of threads
+        bool isChanged = false;
+        for (size_t i = 0; i < size; ++i)
+        {
+            auto& metadata = _metadata[_dataset.GetExampleIndex(fromPosition + i)];
+            auto dualDiff = _batchDuals[i] - metadata.dualVariable;
+            if (dualDiff != 0)
+            {
+                _dataset.VisitExample(fromPosition + i, [&](const data::AutoSupervisedExample& example) {
+                    _v.Transpose() += (-dualDiff * _inverseScaledRegularization) * example.GetDataVector();
+                });
+                _d += (-dualDiff * _inverseScaledRegularization);
+                metadata.dualVariable = _batchDuals[i];
+                isChanged = true;
             }
         }
+
+        if (isChanged)
+        {
+            _regularizer.ConjugateGradient(_v, _d, _predictor.GetWeights(), _predictor.GetBias());
+        }
+    }
+
+    template <typename LossFunctionType, typename RegularizerType>
+    double SDCATrainer<LossFunctionType, RegularizerType>::GetNewDual(const DataVectorType& dataVector, const TrainerMetadata& metadata, double stepScale) const
+    {
+        auto weightLabel = metadata.weightLabel;
+        auto norm2Squared = metadata.norm2Squared + 1; // add one because of bias term
+        auto lipschitz = norm2Squared * _inverseScaledRegularization / stepScale;
+        auto dual = metadata.dualVariable;
+
+        if (lipschitz > 0)
+        {
+            auto prediction = _predictor.Predict(dataVector);
+            return _lossFunction.ConjugateProx(1.0 / lipschitz, dual + prediction / lipschitz, weightLabel.label);
+        }
+        return dual;
     }
 
     template <typename LossFunctionType, typename RegularizerType>
@@ -231,13 +312,15 @@ namespace trainers
 
         for (size_t i = 0; i < _dataset.NumExamples(); ++i)
         {
-            const auto& example = _dataset.GetExample(i);
-            auto label = example.GetMetadata().weightLabel.label;
-            auto prediction = _predictor.Predict(example.GetDataVector());
-            auto dualVariable = example.GetMetadata().dualVariable;
-
-            _predictorInfo.primalObjective += invSize * _lossFunction(prediction, label);
-            _predictorInfo.dualObjective -= invSize * _lossFunction.Conjugate(dualVariable, label);
+            const auto& metadata = _metadata[_dataset.GetExampleIndex(i)];
+            _dataset.VisitExample(i, [&](const data::AutoSupervisedExample& example) {
+                auto label = metadata.weightLabel.label;
+                auto prediction = _predictor.Predict(example.GetDataVector());
+                auto dualVariable = metadata.dualVariable;
+
+                _predictorInfo.primalObjective += invSize * _lossFunction(prediction, label);
+                _predictorInfo.dualObjective -= invSize * _lossFunction.Conjugate(dualVariable, label);
+            });
         }
 
         _predictorInfo.primalObjective += _parameters.regularization * _regularizer(_predictor.GetWeights(), _predictor.GetBias());
@@ -245,13 +328,12 @@ namespace trainers
     }
 
     template <typename LossFunctionType, typename RegularizerType>
-    void SDCATrainer<LossFunctionType, RegularizerType>::ResizeTo(const data::AutoDataVector& x)
+    void SDCATrainer<LossFunctionType, RegularizerType>::ResizeTo(size_t size)
     {
-        auto xSize = x.PrefixLength();
-        if (xSize > _predictor.Size())
+        if (size > _predictor.Size())
         {
-            _predictor.Resize(xSize);
-            _v.Resize(xSize);
+            _predictor.Resize(size);
+            _v.Resize(size);
         }
     }
 
@@ -14,6 +14,7 @@
 
 #include <data/include/Dataset.h>
 #include <data/include/Example.h>
+#include <data/include/PermutedDataset.h>
 
 #include <cstddef>
 #include <memory>
@@ -60,7 +61,7 @@ namespace trainers
         virtual void DoNextStep(const data::AutoDataVector& x, double y, double weight) = 0;
         virtual const PredictorType& GetAveragedPredictor() const = 0;
 
-        data::AutoSupervisedDataset _dataset;
+        data::PermutedDataset _dataset;
         std::default_random_engine _random;
         bool _firstIteration = true;
     };
@@ -14,6 +14,10 @@
 #include <predictors/include/ConstantPredictor.h>
 #include <predictors/include/SingleElementThresholdPredictor.h>
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 namespace ell
 {
 namespace trainers
@@ -53,11 +57,22 @@ namespace trainers
 
     protected:
         using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_dataset;
+        using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_threadPool;
         SplitCandidate GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) override;
         std::vector<EdgePredictorType> GetEdgePredictors(const NodeStats& nodeStats) override;
 
     private:
-        void SortNodeDataset(Range range, size_t featureIndex);
+        // the best split on a single feature
+        struct FeatureSplit
+        {
+            double gain = 0;
+            double threshold = 0;
+            size_t size0 = 0;
+            Sums sums0;
+            Sums sums1;
+        };
+
+        FeatureSplit GetBestSplitOnFeature(Range range, const Sums& sums, size_t inputIndex) const;
         double CalculateGain(const Sums& sums, const Sums& sums0, const Sums& sums1) const;
 
         // member variables
@@ -93,48 +108,84 @@ namespace trainers
     auto SortingForestTrainer<LossFunctionType, BoosterType>::GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) -> SplitCandidate
     {
         auto numFeatures = _dataset.NumFeatures();
-
         SplitCandidate bestSplitCandidate(nodeId, range, sums);
 
+        // search each feature in parallel
+        std::vector<FeatureSplit> featureSplits(numFeatures);
+        _threadPool.ParallelFor(numFeatures, [this, range, &sums, &featureSplits](size_t inputIndex) {
+            featureSplits[inputIndex] = GetBestSplitOnFeature(range, sums, inputIndex);
+        });
+
+        // find gain maximizer, breaking ties in favor of the lowest feature index
+        size_t bestInputIndex = numFeatures;
         for (size_t inputIndex = 0; inputIndex < numFeatures; ++inputIndex)
         {
-            // sort the relevant rows of data set in ascending order by inputIndex
-            SortNodeDataset(range, inputIndex);
+            if (featureSplits[inputIndex].gain > bestSplitCandidate.gain)
+            {
+                bestSplitCandidate.gain = featureSplits[inputIndex].gain;
+                bestInputIndex = inputIndex;
+            }
+        }
+
+        if (bestInputIndex < numFeatures)
+        {
+            const auto& featureSplit = featureSplits[bestInputIndex];
+            bestSplitCandidate.splitRule = SplitRuleType{ bestInputIndex, featureSplit.threshold };
+            bestSplitCandidate.ranges.SplitChildRange(0, featureSplit.size0);
+            bestSplitCandidate.stats.SetChildSums({ featureSplit.sums0, featureSplit.sums1 });
+        }
 
-            Sums sums0;
+        return bestSplitCandidate;
+    }
+
+    template <typename LossFunctionType, typename BoosterType>
+    auto SortingForestTrainer<LossFunctionType, BoosterType>::GetBestSplitOnFeature(Range range, const Sums& sums, size_t inputIndex) const -> FeatureSplit
+    {
+        FeatureSplit bestSplit;
 
-            // consider all thresholds
-            double nextFeatureValue = _dataset[range.firstIndex].GetDataVector()[inputIndex];
-            for (size_t rowIndex = range.firstIndex; rowIndex < range.firstIndex + range.size - 1; ++rowIndex)
+        // sort the relevant rows in ascending order by inputIndex, without modifying the data set (it is shared by all the features)
+        std::vector<std::pair<double, size_t>> sortedRows;
+        sortedRows.reserve(range.size);
+        for (size_t rowIndex = range.firstIndex; rowIndex < range.firstIndex + range.size; ++rowIndex)
+        {
+            sortedRows.emplace_back(_dataset[rowIndex].GetDataVector()[inputIndex], rowIndex);
+        }
+        std::sort(sortedRows.begin(), sortedRows.end());
+
+        Sums sums0;
+
+        // consider all thresholds
+        for (size_t index = 0; index + 1 < sortedRows.size(); ++index)
+        {
+            // get friendly names
+            double currentFeatureValue = sortedRows[index].first;
+            double nextFeatureValue = sortedRows[index + 1].first;
+
+            // increment sums
+            sums0.Increment(_dataset[sortedRows[index].second].GetMetadata().weak);
+
+            // only split between rows with different feature values
+            if (currentFeatureValue == nextFeatureValue)
             {
-                // get friendly names
-                double currentFeatureValue = nextFeatureValue;
-                nextFeatureValue = _dataset[rowIndex + 1].GetDataVector()[inputIndex];
-
-                // increment sums
-                sums0.Increment(_dataset[rowIndex].GetMetadata().weak);
-
-                // only split between rows with different feature values
-                if (currentFeatureValue == nextFeatureValue)
-                {
-                    continue;
-                }
-
-                // compute sums1 and gain
-                auto sums1 = sums - sums0;
-                double gain = CalculateGain(sums, sums0, sums1);
-
-                // find gain maximizer
-                if (gain > bestSplitCandidate.gain)
-                {
-                    bestSplitCandidate.gain = gain;
-                    bestSplitCandidate.splitRule = SplitRuleType{ inputIndex, 0.5 * (currentFeatureValue + nextFeatureValue) };
-                    bestSplitCandidate.ranges.SplitChildRange(0, rowIndex - range.firstIndex + 1);
-                    bestSplitCandidate.stats.SetChildSums({ sums0, sums1 });
-                }
+                continue;
+            }
+
+            // compute sums1 and gain
+            auto sums1 = sums - sums0;
+            double gain = CalculateGain(sums, sums0, sums1);
+
+            // find gain maximizer
+            if (gain > bestSplit.gain)
+            {
+                bestSplit.gain = gain;
+                bestSplit.threshold = 0.5 * (currentFeatureValue + nextFeatureValue);
+                bestSplit.size0 = index + 1;
+                bestSplit.sums0 = sums0;
+                bestSplit.sums1 = sums1;
             }
         }
-        return bestSplitCandidate;
+
+        return bestSplit;
     }
 
     template <typename LossFunctionType, typename BoosterType>
@@ -146,14 +197,6 @@ namespace trainers
         return std::vector<EdgePredictorType>{ output0, output1 };
     }
 
-    template <typename LossFunctionType, typename BoosterType>
-    void SortingForestTrainer<LossFunctionType, BoosterType>::SortNodeDataset(Range range, size_t inputIndex)
-    {
-        _dataset.Sort([inputIndex](const data::Example<DataVectorType, TrainerMetadata>& example) { return example.GetDataVector()[inputIndex]; },
-                      range.firstIndex,
-                      range.size);
-    }
-
     template <typename LossFunctionType, typename BoosterType>
     double SortingForestTrainer<LossFunctionType, BoosterType>::CalculateGain(const Sums& sums, const Sums& sums0, const Sums& sums1) const
     {
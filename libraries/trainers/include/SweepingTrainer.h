@@ -15,6 +15,11 @@
 
 #include <evaluators/include/Evaluator.h>
 
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <random>
 #include <string>
@@ -25,7 +30,19 @@ namespace ell
 {
 namespace trainers
 {
-    /// <summary> A class that runs multiple internal trainers and chooses the best performing predictor. </summary>
+    /// <summary> Parameters for the sweeping trainer. </summary>
+    struct SweepingTrainerParameters
+    {
+        size_t numThreads = 0; // zero means one thread per hardware thread
+        double keepFraction = 1.0; // fraction of the active trainers kept after each update; 0.5 gives successive halving
+    };
+
+    /// <summary>
+    /// A class that runs multiple internal trainers and chooses the best performing predictor. The internal trainers
+    /// are independent, so each update runs them concurrently on a thread pool. After each update, only the best
+    /// `keepFraction` of the active trainers (by evaluator goodness) stay active, so clearly losing configurations
+    /// stop consuming time.
+    /// </summary>
     ///
     /// <typeparam name="PredictorType"> The type of predictor returned by this trainer. </typeparam>
     template <typename PredictorType>
@@ -38,7 +55,8 @@ namespace trainers
         /// <summary> Constructs an instance of SweepingTrainer. </summary>
         ///
         /// <param name="evaluatingTrainers"> A vector of evaluating trainers. </param>
-        SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers);
+        /// <param name="parameters"> The sweeping trainer parameters. </param>
+        SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers, const SweepingTrainerParameters& parameters = {});
 
         /// <summary> Sets the trainer's dataset. </summary>
         ///
@@ -53,19 +71,30 @@ namespace trainers
         /// <returns> A const reference to the current predictor. </returns>
         const PredictorType& GetPredictor() const override;
 
+        /// <summary> Gets the number of internal trainers that are still being updated. </summary>
+        ///
+        /// <returns> The number of active trainers. </returns>
+        size_t NumActiveTrainers() const { return _activeTrainers.size(); }
+
     private:
+        void DropLosingTrainers();
+
         data::Dataset<ExampleType> _dataset;
         std::vector<EvaluatingTrainerType> _evaluatingTrainers;
+        std::vector<size_t> _activeTrainers;
+        SweepingTrainerParameters _parameters;
+        utilities::ThreadPool _threadPool;
     };
 
     /// <summary> Makes an incremental trainer that runs multiple internal trainers and chooses the best performing predictor. </summary>
     ///
     /// <typeparam name="PredictorType"> Type of the predictor returned by this trainer. </typeparam>
     /// <param name="evaluatingTrainers"> A vector of evaluating trainers. </param>
+    /// <param name="parameters"> The sweeping trainer parameters. </param>
     ///
     /// <returns> A unique_ptr to a sweeping trainer. </returns>
     template <typename PredictorType>
-    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers);
+    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers, const SweepingTrainerParameters& parameters = {});
 } // namespace trainers
 } // namespace ell
 
@@ -76,33 +105,47 @@ namespace ell
 namespace trainers
 {
     template <typename PredictorType>
-    SweepingTrainer<PredictorType>::SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers) :
-        _evaluatingTrainers(std::move(evaluatingTrainers))
+    SweepingTrainer<PredictorType>::SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers, const SweepingTrainerParameters& parameters) :
+        _evaluatingTrainers(std::move(evaluatingTrainers)),
+        _parameters(parameters),
+        _threadPool(std::min(parameters.numThreads == 0 ? utilities::GetDefaultNumThreads() : parameters.numThreads, _evaluatingTrainers.size()))
     {
         assert(_evaluatingTrainers.size() > 0);
+        if (!(_parameters.keepFraction > 0.0 && _parameters.keepFraction <= 1.0))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "keepFraction must be in the range (0, 1]");
+        }
+        for (size_t i = 0; i < _evaluatingTrainers.size(); ++i)
+        {
+            _activeTrainers.push_back(i);
+        }
     }
 
     template <typename PredictorType>
     void SweepingTrainer<PredictorType>::SetDataset(const data::AnyDataset& anyDataset)
     {
         _dataset = data::Dataset<ExampleType>(anyDataset);
+        _threadPool.ParallelFor(_evaluatingTrainers.size(), [&](size_t i) {
+            _evaluatingTrainers[i].SetDataset(anyDataset);
+        });
     }
 
     template <typename PredictorType>
     void SweepingTrainer<PredictorType>::Update()
     {
-        for (size_t i = 0; i < _evaluatingTrainers.size(); ++i)
-        {
-            _evaluatingTrainers[i].Update();
-        }
+        // the trainers only share the read-only dataset, so they can be updated concurrently
+        _threadPool.ParallelFor(_activeTrainers.size(), [this](size_t i) {
+            _evaluatingTrainers[_activeTrainers[i]].Update();
+        });
+        DropLosingTrainers();
     }
 
     template <typename PredictorType>
     const PredictorType& SweepingTrainer<PredictorType>::GetPredictor() const
     {
-        double bestGoodness = _evaluatingTrainers[0].GetEvaluator()->GetGoodness();
-        size_t bestIndex = 0;
-        for (size_t i = 1; i < _evaluatingTrainers.size(); ++i)
+        size_t bestIndex = _activeTrainers[0];
+        double bestGoodness = _evaluatingTrainers[bestIndex].GetEvaluator()->GetGoodness();
+        for (auto i : _activeTrainers)
         {
             double goodness = _evaluatingTrainers[i].GetEvaluator()->GetGoodness();
             if (goodness > bestGoodness)
@@ -116,9 +159,30 @@ namespace trainers
     }
 
     template <typename PredictorType>
-    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers)
+    void SweepingTrainer<PredictorType>::DropLosingTrainers()
+    {
+        auto numToKeep = static_cast<size_t>(std::ceil(_parameters.keepFraction * _activeTrainers.size()));
+        numToKeep = std::max<size_t>(numToKeep, 1);
+        if (numToKeep >= _activeTrainers.size())
+        {
+            return;
+        }
+
+        // stable, so ties keep the trainers in their original order
+        std::vector<double> goodness(_evaluatingTrainers.size());
+        for (auto i : _activeTrainers)
+        {
+            goodness[i] = _evaluatingTrainers[i].GetEvaluator()->GetGoodness();
+        }
+        std::stable_sort(_activeTrainers.begin(), _activeTrainers.end(), [&](size_t a, size_t b) { return goodness[a] > goodness[b]; });
+        _activeTrainers.resize(numToKeep);
+        std::sort(_activeTrainers.begin(), _activeTrainers.end());
+    }
+
+    template <typename PredictorType>
+    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers, const SweepingTrainerParameters& parameters)
     {
-        return std::make_unique<SweepingTrainer<PredictorType>>(std::move(evaluatingTrainers));
+        return std::make_unique<SweepingTrainer<PredictorType>>(std::move(evaluatingTrainers), parameters);
     }
 } // namespace trainers
 } // namespace ell
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinnedFeatureMatrix.cpp (trainers)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BinnedFeatureMatrix.h"
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace ell
+{
+namespace trainers
+{
+    namespace
+    {
+        // chooses up to maxBins - 1 thresholds, each halfway between two consecutive distinct values. If there are few enough
+        // distinct values, each one gets its own bin; otherwise the thresholds are placed at evenly spaced quantiles.
+        std::vector<double> GetThresholds(const std::vector<double>& sortedValues, size_t maxBins)
+        {
+            std::vector<double> distinctValues;
+            std::unique_copy(sortedValues.begin(), sortedValues.end(), std::back_inserter(distinctValues));
+
+            std::vector<double> thresholds;
+            if (distinctValues.size() <= maxBins)
+            {
+                for (size_t index = 0; index + 1 < distinctValues.size(); ++index)
+                {
+                    thresholds.push_back(0.5 * (distinctValues[index] + distinctValues[index + 1]));
+                }
+                return thresholds;
+            }
+
+            auto numValues = sortedValues.size();
+            for (size_t binIndex = 1; binIndex < maxBins; ++binIndex)
+            {
+                auto value = sortedValues[binIndex * numValues / maxBins - 1];
+                auto next = std::upper_bound(distinctValues.begin(), distinctValues.end(), value);
+                if (next == distinctValues.end())
+                {
+                    break;
+                }
+
+                auto threshold = 0.5 * (value + *next);
+                if (thresholds.empty() || threshold > thresholds.back())
+                {
+                    thresholds.push_back(threshold);
+                }
+            }
+            return thresholds;
+        }
+
+        size_t GetBinIndex(const std::vector<double>& thresholds, double value)
+        {
+            return static_cast<size_t>(std::lower_bound(thresholds.begin(), thresholds.end(), value) - thresholds.begin());
+        }
+    } // namespace
+
+    BinnedFeatureMatrix::BinnedFeatureMatrix(size_t numRows, size_t numFeatures, size_t maxBinsPerFeature) :
+        _numRows(numRows),
+        _maxBinsPerFeature(maxBinsPerFeature),
+        _thresholds(numFeatures)
+    {
+        if (maxBinsPerFeature < 2 || maxBinsPerFeature > maxNumBins)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "maxBinsPerFeature must be between 2 and 65536");
+        }
+
+        if (HasWideBins())
+        {
+            _wideBins.resize(numRows * numFeatures);
+        }
+        else
+        {
+            _narrowBins.resize(numRows * numFeatures);
+        }
+    }
+
+    void BinnedFeatureMatrix::SetColumn(size_t featureIndex, const std::vector<double>& values)
+    {
+        if (featureIndex >= NumFeatures() || values.size() != _numRows)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch);
+        }
+
+        auto sortedValues = values;
+        std::sort(sortedValues.begin(), sortedValues.end());
+        auto& thresholds = _thresholds[featureIndex];
+        thresholds = GetThresholds(sortedValues, _maxBinsPerFeature);
+
+        for (size_t rowIndex = 0; rowIndex < _numRows; ++rowIndex)
+        {
+            auto binIndex = GetBinIndex(thresholds, values[rowIndex]);
+            if (HasWideBins())
+            {
+                _wideBins[featureIndex * _numRows + rowIndex] = static_cast<uint16_t>(binIndex);
+            }
+            else
+            {
+                _narrowBins[featureIndex * _numRows + rowIndex] = static_cast<uint8_t>(binIndex);
+            }
+        }
+    }
+
+    size_t BinnedFeatureMatrix::GetBin(size_t rowIndex, size_t featureIndex) const
+    {
+        return HasWideBins() ? GetWideColumn(featureIndex)[rowIndex] : GetNarrowColumn(featureIndex)[rowIndex];
+    }
+
+    size_t BinnedFeatureMatrix::FindBin(size_t featureIndex, double value) const
+    {
+        return GetBinIndex(_thresholds[featureIndex], value);
+    }
+} // namespace trainers
+} // namespace ell
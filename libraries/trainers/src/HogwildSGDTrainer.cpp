@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     HogwildSGDTrainer.cpp (trainers)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "HogwildSGDTrainer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ell
+{
+namespace trainers
+{
+    void HogwildSGDTrainerBase::SetDataset(const data::AnyDataset& anyDataset)
+    {
+        _dataset = data::PermutedDataset(anyDataset);
+
+        // the shared vectors can't be resized while the threads are running, so size them for the whole dataset
+        size_t size = 0;
+        for (size_t i = 0; i < _dataset.NumExamples(); ++i)
+        {
+            _dataset.VisitExample(i, [&size](const data::AutoSupervisedExample& example) {
+                size = std::max(size, example.GetDataVector().PrefixLength());
+            });
+        }
+        ResizeTo(size);
+    }
+
+    void HogwildSGDTrainerBase::Update()
+    {
+        // permute the data
+        _dataset.RandomPermute(_random);
+
+        // each thread steps through its own range of the permuted data
+        auto numExamples = _dataset.NumExamples();
+        auto numThreads = _threadPool.NumThreads();
+        _threadPool.ParallelFor(numThreads, [&](size_t threadIndex) {
+            auto begin = numExamples * threadIndex / numThreads;
+            auto end = numExamples * (threadIndex + 1) / numThreads;
+            for (size_t i = begin; i < end; ++i)
+            {
+                _dataset.VisitExample(i, [this](const data::AutoSupervisedExample& example) {
+                    auto stepIndex = ++_numSteps;
+                    DoStep(example.GetDataVector(), example.GetMetadata().label, example.GetMetadata().weight, stepIndex);
+                });
+            }
+        });
+    }
+
+    HogwildSGDTrainerBase::HogwildSGDTrainerBase(const HogwildSGDTrainerParameters& parameters) :
+        _threadPool(parameters.numThreads)
+    {
+        std::seed_seq seed(parameters.randomSeedString.begin(), parameters.randomSeedString.end());
+        _random = std::default_random_engine(seed);
+    }
+
+    double HogwildSGDTrainerBase::GetHarmonicNumber(size_t n)
+    {
+        // sum small values exactly, and use the asymptotic expansion (accurate to about 1e-14) for large ones
+        constexpr size_t maxExact = 64;
+        if (n <= maxExact)
+        {
+            double sum = 0;
+            for (size_t k = n; k > 0; --k)
+            {
+                sum += 1.0 / static_cast<double>(k);
+            }
+            return sum;
+        }
+
+        constexpr double eulerGamma = 0.57721566490153286061;
+        double x = static_cast<double>(n);
+        double inverseSquare = 1.0 / (x * x);
+        return std::log(x) + eulerGamma + 0.5 / x - inverseSquare / 12.0 + inverseSquare * inverseSquare / 120.0;
+    }
+
+    void HogwildSGDTrainerBase::AtomicAdd(std::atomic<double>& target, double value)
+    {
+        auto current = target.load(std::memory_order_relaxed);
+        while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void HogwildSGDTrainerBase::SharedVector::Resize(size_t size)
+    {
+        auto values = std::make_unique<std::atomic<double>[]>(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            values[i].store(i < _size ? (*this)[i] : 0.0, std::memory_order_relaxed);
+        }
+        _values = std::move(values);
+        _size = size;
+    }
+
+    double HogwildSGDTrainerBase::SharedVector::Dot(const data::AutoDataVector& x) const
+    {
+        double result = 0;
+        x.ForEach<data::IterationPolicy::skipZeros>([this, &result](data::IndexValue entry) {
+            if (entry.index < _size)
+            {
+                result += entry.value * (*this)[entry.index];
+            }
+        });
+        return result;
+    }
+
+    void HogwildSGDTrainerBase::SharedVector::AddScaled(double scale, const data::AutoDataVector& x)
+    {
+        x.ForEach<data::IterationPolicy::skipZeros>([this, scale](data::IndexValue entry) {
+            if (entry.index < _size)
+            {
+                auto& value = _values[entry.index];
+                value.store(value.load(std::memory_order_relaxed) + scale * entry.value, std::memory_order_relaxed);
+            }
+        });
+    }
+} // namespace trainers
+} // namespace ell
@@ -10,161 +10,239 @@
 #include <math/include/MatrixOperations.h>
 #include <math/include/VectorOperations.h>
 
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <numeric>
 
 namespace ell
 {
 namespace trainers
 {
-    KMeansTrainer::KMeansTrainer(size_t dim, size_t numClusters, size_t iterations) :
+    KMeansTrainer::KMeansTrainer(size_t dim, size_t numClusters, size_t iterations, const KMeansTrainerParameters& parameters) :
+        _parameters(parameters),
+        _threadPool(parameters.numThreads),
         _means(dim, numClusters),
         _isInitialized(false),
         _iterations(iterations),
-        _numClusters(numClusters) {}
+        _numClusters(numClusters)
+    {
+        std::seed_seq seed(parameters.randomSeedString.begin(), parameters.randomSeedString.end());
+        _random = std::default_random_engine(seed);
+    }
 
-    KMeansTrainer::KMeansTrainer(size_t numClusters, size_t iters, math::ColumnMatrix<double> means) :
+    KMeansTrainer::KMeansTrainer(size_t numClusters, size_t iters, math::ColumnMatrix<double> means, const KMeansTrainerParameters& parameters) :
+        _parameters(parameters),
+        _threadPool(parameters.numThreads),
         _means(means),
         _isInitialized(true),
         _iterations(iters),
-        _numClusters(numClusters) {}
+        _numClusters(numClusters)
+    {
+        std::seed_seq seed(parameters.randomSeedString.begin(), parameters.randomSeedString.end());
+        _random = std::default_random_engine(seed);
+    }
 
-    void KMeansTrainer::RunKMeans(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X)
+    void KMeansTrainer::RunKMeans(ConstColumnMatrixReference X)
     {
+        auto n = X.NumColumns();
+        if (n == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidSize, "KMeansTrainer needs at least one point");
+        }
+
+        auto xSqNorms = columnSquaredNorms(X);
         if (false == _isInitialized)
-            initializeMeans(X);
+            initializeMeans(X, xSqNorms);
+
+        std::vector<size_t> clusterAssignment(n);
+        if (_parameters.miniBatchSize == 0)
+        {
+            double prevDistance = 0.0;
+            for (size_t i = 0; i < _iterations; ++i)
+            {
+                auto totalDistance = assignClosestCenter(X, xSqNorms, clusterAssignment);
+                if (totalDistance == prevDistance)
+                    break;
+                recomputeMeans(X, clusterAssignment);
+                prevDistance = totalDistance;
+            }
+        }
+        else
+        {
+            std::vector<size_t> numPointsPerCluster(_numClusters);
+            for (size_t i = 0; i < _iterations; ++i)
+            {
+                updateMeansMiniBatch(X, xSqNorms, numPointsPerCluster);
+            }
+        }
 
-        math::ColumnVector<size_t> clusterAssignment(X.NumColumns());
-        double prevDistance = 0.0;
-        for (size_t i = 0; i < _iterations; ++i)
+        _totalDistance = assignClosestCenter(X, xSqNorms, clusterAssignment);
+        _clusterAssignment.Resize(n);
+        for (size_t i = 0; i < n; ++i)
         {
-            auto totalDistance = assignClosestCenter(X, clusterAssignment);
-            if (totalDistance == prevDistance)
-                break;
-            recomputeMeans(X, clusterAssignment);
-            prevDistance = totalDistance;
+            _clusterAssignment[i] = static_cast<double>(clusterAssignment[i]);
         }
     }
 
-    void KMeansTrainer::initializeMeans(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X)
+    void KMeansTrainer::initializeMeans(ConstColumnMatrixReference X, const std::vector<double>& xSqNorms)
     {
         size_t N = X.NumColumns();
-        size_t choice = rand() % N;
+        size_t choice = std::uniform_int_distribution<size_t>(0, N - 1)(_random);
 
         _means.GetColumn(0).CopyFrom(X.GetColumn(choice));
 
-        math::ColumnVector<double> minimumDistance(X.NumColumns());
+        auto blockSize = std::max(_parameters.blockSize, size_t{ 1 });
+        auto numBlocks = (N + blockSize - 1) / blockSize;
+        std::vector<double> minimumDistance(N, std::numeric_limits<double>::max());
         for (size_t k = 1; k < _numClusters; ++k)
         {
-            // distance to previously selected mean
-            auto D = pairwiseDistance(X, _means.GetSubMatrix(0, k - 1, _means.NumRows(), 1));
-            auto distanceToPreviousMean = D.GetColumn(0);
-
-            if (k == 1)
-            {
-                minimumDistance.CopyFrom(distanceToPreviousMean);
-            }
-            else
-            {
-                // distance to closest center
-                for (size_t i = 0; i < minimumDistance.Size(); ++i)
+            // distance to closest center, updated with the distance to the previously selected mean
+            auto previousMean = _means.GetColumn(k - 1);
+            auto muSqNorm = previousMean.Norm2Squared();
+            _threadPool.ParallelFor(numBlocks, [&](size_t block) {
+                auto end = std::min(N, (block + 1) * blockSize);
+                for (size_t i = block * blockSize; i < end; ++i)
                 {
-                    minimumDistance[i] = std::min(minimumDistance[i], distanceToPreviousMean[i]);
+                    auto distance = std::max(xSqNorms[i] - 2.0 * math::Dot(X.GetColumn(i), previousMean) + muSqNorm, 0.0);
+                    minimumDistance[i] = std::min(minimumDistance[i], distance);
                 }
-            }
+            });
 
             choice = weightedSample(minimumDistance);
             _means.GetColumn(k).CopyFrom(X.GetColumn(choice));
         }
     }
 
+    std::vector<double> KMeansTrainer::columnSquaredNorms(ConstColumnMatrixReference X)
+    {
+        auto n = X.NumColumns();
+        auto blockSize = std::max(_parameters.blockSize, size_t{ 1 });
+        std::vector<double> sqNorms(n);
+        _threadPool.ParallelFor((n + blockSize - 1) / blockSize, [&](size_t block) {
+            auto end = std::min(n, (block + 1) * blockSize);
+            for (size_t i = block * blockSize; i < end; ++i)
+            {
+                sqNorms[i] = X.GetColumn(i).Norm2Squared();
+            }
+        });
+        return sqNorms;
+    }
+
     /// D_ij = || X_i - mu_j || ^ 2   (Distance of ith point to jth cluster)
     /// distance = ||X||^2 + ||means||^2 - 2 *  means * X'
-    math::RowMatrix<double> KMeansTrainer::pairwiseDistance(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> means)
+    /// The cross term is computed for one block of points at a time, so only a blockSize x k matrix is live per thread.
+    double KMeansTrainer::assignClosestCenter(ConstColumnMatrixReference X, const std::vector<double>& xSqNorms, std::vector<size_t>& clusterAssignment)
     {
         auto n = X.NumColumns();
-        auto k = means.NumColumns();
-
-        math::ColumnMatrix<double> xSq(X.NumRows(), n);
-        math::ElementwiseMultiplySet(X, X, xSq);
-
-        math::ColumnMatrix<double> muSq(means.NumRows(), k);
-        math::ElementwiseMultiplySet(means, means, muSq);
-
-        math::ColumnMatrix<double> xSqNorm(1, xSq.NumColumns());
-        math::ColumnwiseSum(xSq, xSqNorm.GetRow(0));
-
-        math::ColumnMatrix<double> muSqNorm(1, muSq.NumColumns());
-        math::ColumnwiseSum(muSq, muSqNorm.GetRow(0));
-
-        math::RowMatrix<double> onesMultiplier(k, 1);
-        onesMultiplier.Fill(1.0);
-        math::RowMatrix<double> distFactor1(k, n);
-        math::MultiplyScaleAddUpdate(1.0, onesMultiplier, xSqNorm, 0.0, distFactor1);
-
-        math::ColumnMatrix<double> onesMultiplier1 = math::ColumnMatrix<double>(n, 1);
-        onesMultiplier1.Fill(1.0);
-        math::ColumnMatrix<double> distFactor2(n, k);
-        math::MultiplyScaleAddUpdate(1.0, onesMultiplier1, muSqNorm, 0.0, distFactor2);
-
-        math::RowMatrix<double> muX(n, k);
-        math::MultiplyScaleAddUpdate(1.0, X.Transpose(), means, 1.0, muX);
-
-        math::ColumnMatrix<double> tempD(n, k);
-        math::ScaleAddSet(1.0, distFactor1.Transpose(), -2.0, muX, tempD);
-
-        math::ColumnMatrix<double> distance(n, k);
-        math::ScaleAddSet(1.0, tempD, 1.0, distFactor2, distance);
+        auto k = _means.NumColumns();
+        auto blockSize = std::max(_parameters.blockSize, size_t{ 1 });
+        auto muSqNorms = columnSquaredNorms(_means);
+
+        std::vector<double> minimumDistance(n);
+        _threadPool.ParallelFor((n + blockSize - 1) / blockSize, [&](size_t block) {
+            auto begin = block * blockSize;
+            auto size = std::min(blockSize, n - begin);
+            math::RowMatrix<double> muX(size, k);
+            math::MultiplyScaleAddUpdate(1.0, X.GetSubMatrix(0, begin, X.NumRows(), size).Transpose(), _means, 0.0, muX);
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                auto dist = muX.GetRow(i);
+                size_t closest = 0;
+                double closestDistance = std::numeric_limits<double>::max();
+                for (size_t j = 0; j < k; ++j)
+                {
+                    auto distance = xSqNorms[begin + i] - 2.0 * dist[j] + muSqNorms[j];
+                    if (distance < closestDistance)
+                    {
+                        closest = j;
+                        closestDistance = distance;
+                    }
+                }
+                clusterAssignment[begin + i] = closest;
+                minimumDistance[begin + i] = std::max(closestDistance, 0.0);
+            }
+        });
 
-        return distance;
+        return std::accumulate(minimumDistance.begin(), minimumDistance.end(), 0.0);
     }
 
-    double KMeansTrainer::assignClosestCenter(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, math::VectorReference<size_t, math::VectorOrientation::column> clusterAssignment)
+    void KMeansTrainer::recomputeMeans(ConstColumnMatrixReference X, const std::vector<size_t>& clusterAssignment)
     {
-        auto D = pairwiseDistance(X, _means);
-
-        double totalDist = 0;
-        for (size_t i = 0; i < D.NumRows(); ++i)
+        auto n = X.NumColumns();
+        auto dim = X.NumRows();
+        std::vector<double> numPointsPerCluster(_numClusters);
+        for (size_t i = 0; i < n; ++i)
         {
-            auto dist = D.GetRow(i);
-            auto minElement = std::min_element(dist.GetDataPointer(), dist.GetDataPointer() + dist.Size());
-            clusterAssignment[i] = minElement - dist.GetDataPointer();
-            totalDist += *minElement;
+            numPointsPerCluster[clusterAssignment[i]] += 1;
         }
 
-        return totalDist;
+        // each thread sums a contiguous range of coordinates over all points, so the sums don't depend on the number of threads
+        math::ColumnMatrix<double> clusterSum(dim, _numClusters);
+        auto numShards = std::max(std::min(_threadPool.NumThreads(), dim), size_t{ 1 });
+        _threadPool.ParallelFor(numShards, [&](size_t shard) {
+            auto firstRow = shard * dim / numShards;
+            auto numRows = (shard + 1) * dim / numShards - firstRow;
+            for (size_t i = 0; i < n; ++i)
+            {
+                clusterSum.GetColumn(clusterAssignment[i]).GetSubVector(firstRow, numRows) += X.GetColumn(i).GetSubVector(firstRow, numRows);
+            }
+        });
+
+        // a cluster that lost all its points keeps its previous mean
+        for (size_t i = 0; i < _numClusters; i++)
+        {
+            if (numPointsPerCluster[i] > 0)
+            {
+                clusterSum.GetColumn(i) /= numPointsPerCluster[i];
+                _means.GetColumn(i).CopyFrom(clusterSum.GetColumn(i));
+            }
+        }
     }
 
-    void KMeansTrainer::recomputeMeans(math::ConstMatrixReference<double, math::MatrixLayout::columnMajor> X, const math::ColumnVector<size_t> clusterAssignment)
+    void KMeansTrainer::updateMeansMiniBatch(ConstColumnMatrixReference X, const std::vector<double>& xSqNorms, std::vector<size_t>& numPointsPerCluster)
     {
-        math::ColumnMatrix<double> clusterSum(X.NumRows(), _numClusters);
-        math::ColumnVector<double> numPointsPerCluster(_numClusters);
-        for (size_t i = 0; i < X.NumColumns(); ++i)
+        auto n = X.NumColumns();
+        auto batchSize = std::min(_parameters.miniBatchSize, n);
+        std::uniform_int_distribution<size_t> pointDistribution(0, n - 1);
+
+        math::ColumnMatrix<double> batch(X.NumRows(), batchSize);
+        std::vector<double> batchSqNorms(batchSize);
+        for (size_t i = 0; i < batchSize; ++i)
         {
-            auto idx = clusterAssignment[i];
-            clusterSum.GetColumn(idx) += X.GetColumn(i);
-            numPointsPerCluster[idx] += 1;
+            auto index = pointDistribution(_random);
+            batch.GetColumn(i).CopyFrom(X.GetColumn(index));
+            batchSqNorms[i] = xSqNorms[index];
         }
 
-        for (size_t i = 0; i < _numClusters; i++)
+        std::vector<size_t> batchAssignment(batchSize);
+        assignClosestCenter(batch, batchSqNorms, batchAssignment);
+
+        // move each mean toward its points, with a step size that decays with the number of points it has seen
+        for (size_t i = 0; i < batchSize; ++i)
         {
-            clusterSum.GetColumn(i) /= numPointsPerCluster[i];
+            auto idx = batchAssignment[i];
+            numPointsPerCluster[idx] += 1;
+            auto eta = 1.0 / static_cast<double>(numPointsPerCluster[idx]);
+            math::ScaleAddUpdate(eta, batch.GetColumn(i), 1.0 - eta, _means.GetColumn(idx));
         }
-
-        _means.CopyFrom(clusterSum);
     }
 
-    size_t KMeansTrainer::weightedSample(math::ColumnVector<double> weights)
+    size_t KMeansTrainer::weightedSample(const std::vector<double>& weights)
     {
-        double sum = weights.Aggregate([](double x) { return x; });
+        double sum = std::accumulate(weights.begin(), weights.end(), 0.0);
 
-        auto threshold = ((double)rand() / (RAND_MAX));
+        auto threshold = std::uniform_real_distribution<double>(0.0, 1.0)(_random);
         threshold = sum * threshold;
         double cummulativeSum = 0;
 
         int choice = -1;
 
         // Select choice to be the smallest index i such that ( sum_{ j <= i } weights[j] ) >= threshold
-        while (cummulativeSum < threshold)
+        while (cummulativeSum < threshold && choice + 1 < static_cast<int>(weights.size()))
         {
             choice += 1;
             cummulativeSum += weights[choice];
@@ -172,7 +250,7 @@ namespace trainers
 
         // Select an index uniformly at random if all the weights are 0
         if (-1 == choice)
-            choice = rand() % weights.Size();
+            choice = static_cast<int>(std::uniform_int_distribution<size_t>(0, weights.size() - 1)(_random));
 
         return choice;
     }
@@ -17,10 +17,12 @@
 
 #include <utilities/include/Unused.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <ctime>
 #include <iostream>
+#include <numeric>
 
 namespace ell
 {
@@ -31,6 +33,8 @@ namespace trainers
         constexpr double ArmijoStepTolerance = 0.02;
 
         constexpr double DefaultStepSize = 0.2;
+
+        constexpr size_t ProjectionBlockSize = 1024;
     } // namespace
 
     double safe_div(const double& num, const double& den)
@@ -46,7 +50,9 @@ namespace trainers
         _parameters(parameters),
         _protoNNPredictor(parameters.numFeatures, parameters.projectedDimension, parameters.numPrototypesPerLabel * parameters.numLabels, parameters.numLabels, parameters.gamma),
         _X(0, 0),
-        _Y(0, 0)
+        _Y(0, 0),
+        _WX(0, 0),
+        _threadPool(parameters.numThreads)
     {
     }
 
@@ -91,11 +97,18 @@ namespace trainers
         auto generator = [&]() { return normal(rng); };
         W.Generate(generator);
 
-        math::ColumnMatrix<double> WX(W.NumRows(), n);
-        math::MultiplyScaleAddUpdate(1.0, W, _X, 0.0, WX);
+        _WX = math::ColumnMatrix<double>(W.NumRows(), n);
+        ComputeWX(W, _X, _WX);
 
-        ProtoNNInit protonnInit(d, _parameters.numLabels, _parameters.numPrototypesPerLabel);
-        protonnInit.Initialize(WX, _Y);
+        // k-means runs on the trainer's threads, and computes distances for a gradient batch's worth of points at a time
+        KMeansTrainerParameters kMeansParameters;
+        kMeansParameters.numThreads = _parameters.numThreads;
+        if (_parameters.batchSize > 0)
+        {
+            kMeansParameters.blockSize = _parameters.batchSize;
+        }
+        ProtoNNInit protonnInit(d, _parameters.numLabels, _parameters.numPrototypesPerLabel, kMeansParameters);
+        protonnInit.Initialize(_WX, _Y);
 
         math::ColumnMatrix<double> B = protonnInit.GetPrototypeMatrix();
         math::ColumnMatrix<double> Z = protonnInit.GetLabelMatrix();
@@ -112,9 +125,7 @@ namespace trainers
         if (-1.0 == _parameters.gamma)
         {
             auto gammaInit = 0.01;
-            math::ColumnMatrix<double> WXupdate(W.NumRows(), n);
-            math::MultiplyScaleAddUpdate(1.0, W, _X, 0.0, WXupdate);
-            _parameters.gamma = protonnInit.InitializeGamma(SimilarityKernel(_X, WXupdate, gammaInit), gammaInit);
+            _parameters.gamma = protonnInit.InitializeGamma(SimilarityKernel(_X, _WX, gammaInit), gammaInit);
         }
 
         _stepSize[ProtoNNParameterIndex::W] = DefaultStepSize;
@@ -140,8 +151,8 @@ namespace trainers
     math::ColumnMatrix<double> ProtoNNTrainer::SimilarityKernel(ConstColumnMatrixReference X, math::ColumnMatrixReference<double> WX, const double gamma, const size_t begin, const size_t end, bool recomputeWX)
     {
         assert(begin < end);
-        auto B = (_modelMap[ProtoNNParameterIndex::B])->GetData();
-        auto W = (_modelMap[ProtoNNParameterIndex::W])->GetData();
+        const auto& B = _modelMap.at(ProtoNNParameterIndex::B)->GetData();
+        const auto& W = _modelMap.at(ProtoNNParameterIndex::W)->GetData();
 
         auto wx = WX.GetSubMatrix(0, begin, WX.NumRows(), end - begin);
 
@@ -209,7 +220,7 @@ namespace trainers
     {
         assert(end - begin == D.NumRows());
 
-        auto Z = (_modelMap[ProtoNNParameterIndex::Z])->GetData();
+        const auto& Z = _modelMap.at(ProtoNNParameterIndex::Z)->GetData();
 
         // residual = y - ZD'
         math::ColumnMatrix<double> ZD(Z.NumRows(), D.NumRows());
@@ -264,9 +275,9 @@ namespace trainers
         size_t batchSize = maxBatchSize;
         size_t numBatches = (n + batchSize - 1) / batchSize;
 
-        // Aggregate loss over the batches
-        for (size_t i = 0; i < numBatches; ++i)
-        {
+        // Compute the loss of each batch in parallel, then aggregate them in batch order
+        std::vector<double> batchLoss(numBatches);
+        _threadPool.ParallelFor(numBatches, [&](size_t i) {
             size_t idx1 = (i * batchSize) % n;
             size_t idx2 = ((i + 1) * (batchSize) % n);
             if (idx2 <= idx1) idx2 = n;
@@ -277,12 +288,49 @@ namespace trainers
             auto D = SimilarityKernel(X, WX, gamma, idx1, idx2, recomputeWX);
             auto y = Y.GetSubMatrix(0, idx1, Y.NumRows(), idx2 - idx1);
 
-            objective += Loss(y, D);
-        }
+            batchLoss[i] = Loss(y, D);
+        });
+        objective = std::accumulate(batchLoss.begin(), batchLoss.end(), objective);
 
         return objective;
     }
 
+    void ProtoNNTrainer::ComputeWX(ConstColumnMatrixReference W, ConstColumnMatrixReference X, math::ColumnMatrixReference<double> WX)
+    {
+        auto n = X.NumColumns();
+        _threadPool.ParallelFor((n + ProjectionBlockSize - 1) / ProjectionBlockSize, [&](size_t block) {
+            auto begin = block * ProjectionBlockSize;
+            auto size = std::min(ProjectionBlockSize, n - begin);
+            auto wx = WX.GetSubMatrix(0, begin, WX.NumRows(), size);
+            math::MultiplyScaleAddUpdate(1.0, W, X.GetSubMatrix(0, begin, X.NumRows(), size), 0.0, wx);
+        });
+    }
+
+    // The gradients are sums over the examples, so each thread computes the kernel and the gradient of a contiguous
+    // range of the batch and the partial gradients are added in range order.
+    math::ColumnMatrix<double> ProtoNNTrainer::Gradient(ProtoNNParameterIndex parameterIndex, ConstColumnMatrixReference X, ConstColumnMatrixReference Y, math::ColumnMatrixReference<double> WX, double gamma, size_t begin, size_t end, bool recomputeWX)
+    {
+        assert(begin < end);
+        auto& parameter = *_modelMap.at(parameterIndex);
+        auto numShards = std::min(_threadPool.NumThreads(), end - begin);
+        std::vector<math::ColumnMatrix<double>> gradients(numShards, math::ColumnMatrix<double>(0, 0));
+        _threadPool.ParallelFor(numShards, [&](size_t shard) {
+            auto shardBegin = begin + shard * (end - begin) / numShards;
+            auto shardEnd = begin + (shard + 1) * (end - begin) / numShards;
+            gradients[shard] = parameter.gradient(_modelMap, X, Y, WX, SimilarityKernel(X, WX, gamma, shardBegin, shardEnd, recomputeWX), gamma, shardBegin, shardEnd, _parameters.lossFunction);
+        });
+
+        auto& gradient = gradients[0];
+        for (size_t shard = 1; shard < numShards; ++shard)
+        {
+            for (size_t j = 0; j < gradient.NumColumns(); ++j)
+            {
+                gradient.GetColumn(j) += gradients[shard].GetColumn(j);
+            }
+        }
+        return gradient;
+    }
+
     //See https://blogs.princeton.edu/imabandit/2013/04/01/acceleratedgradientdescent/ for the accelerated gradient_paramS descent version we use
     //We use stochastic version of the above algorithm
     //paramQ_new[t+1]=paramS[t]-stepSize*gradient_paramS(paramS[t]) //gradient_paramS descent update
@@ -385,7 +433,7 @@ namespace trainers
         size_t n = X.NumColumns(); //numTrainPoints
         size_t epochs = _parameters.numInnerIterations; // number of SGD iterations(epochs) over each of the parameters
 
-        size_t sgdBatchSize = 1 << 8 < n ? 1 << 8 : n; //expose to user parameter structure, default is sqrt(n)
+        size_t sgdBatchSize = (_parameters.batchSize == 0 || _parameters.batchSize > n) ? n : _parameters.batchSize;
 
         double armijoStepTolerance = ArmijoStepTolerance;
 
@@ -396,10 +444,8 @@ namespace trainers
 
         double fOld, fCur, paramStepSize;
 
-        //Projection onto low-d space
-        auto projectionMatrix = _modelMap[m_projectionIndex]->GetData();
-        math::ColumnMatrix<double> WX(projectionMatrix.NumRows(), n);
-        math::MultiplyScaleAddUpdate(1.0, projectionMatrix, X, 0.0, WX);
+        //Projection onto low-d space, kept up to date as the projection changes
+        auto& WX = _WX;
 
         fCur = ComputeObjective(X, Y, WX, gamma, false);
 
@@ -426,7 +472,7 @@ namespace trainers
                 if (idx2 <= idx1) idx2 = n;
 
                 // gradient_paramS at current parameter
-                currentGradient = _modelMap[parameterIndex]->gradient(_modelMap, X, Y, WX, SimilarityKernel(X, WX, gamma, idx1, idx2, _recomputeWX[parameterIndex]), gamma, idx1, idx2, _parameters.lossFunction);
+                currentGradient = Gradient(parameterIndex, X, Y, WX, gamma, idx1, idx2, _recomputeWX[parameterIndex]);
 
                 math::ColumnMatrix<double> thresholdedGradient(parameterMatrix.NumRows(), parameterMatrix.NumColumns());
 
@@ -440,21 +486,21 @@ namespace trainers
                 math::ColumnMatrix<double> perturbedParameter(parameterMatrix.NumRows(), parameterMatrix.NumColumns());
                 math::ScaleAddSet(1.0, parameterMatrix, -1.0 * coeff, thresholdedGradient, perturbedParameter);
 
-                auto WX_old = WX;
+                // Only this batch's projected inputs are recomputed when the projection is perturbed, so only they need saving
+                math::ColumnMatrix<double> wxOld(WX.NumRows(), idx2 - idx1);
+                wxOld.CopyFrom(WX.GetSubMatrix(0, idx1, WX.NumRows(), idx2 - idx1));
                 _modelMap[parameterIndex]->GetData() = perturbedParameter;
 
                 // Compute gradient_paramS with updated parameter
-                math::MultiplyScaleAddUpdate(1.0, _modelMap[m_projectionIndex]->GetData(), X, 0.0, WX);
-
                 math::ColumnMatrix<double> gradientEstimate(parameterMatrix.NumRows(), parameterMatrix.NumColumns());
-                auto grad = _modelMap[parameterIndex]->gradient(_modelMap, X, Y, WX, SimilarityKernel(X, WX, gamma, idx1, idx2, _recomputeWX[parameterIndex]), gamma, idx1, idx2, _parameters.lossFunction);
+                auto grad = Gradient(parameterIndex, X, Y, WX, gamma, idx1, idx2, _recomputeWX[parameterIndex]);
                 math::ScaleAddSet(1.0, currentGradient, -1.0, grad, gradientEstimate);
 
                 currentGradient = gradientEstimate;
 
                 // revert the old parameter value and projected input
                 _modelMap[parameterIndex]->GetData() = parameterMatrix;
-                WX = WX_old;
+                WX.GetSubMatrix(0, idx1, WX.NumRows(), idx2 - idx1).CopyFrom(wxOld);
 
                 if (ProtoNNTrainerUtils::MatrixNorm(currentGradient) <= 1e-20L)
                 {
@@ -476,11 +522,15 @@ namespace trainers
             paramStepSize = _stepSize[parameterIndex] * etaVector[4];
 
             // Call the accelerated proximal gradient_paramS method for optimizing this parameter
-            AcceleratedProximalGradient(parameterIndex, [&](ConstColumnMatrixReference /*W*/, const size_t begin, const size_t end) -> math::ColumnMatrix<double> { return _modelMap[parameterIndex]->gradient(_modelMap, X, Y, WX, SimilarityKernel(X, WX, gamma, begin, end, _recomputeWX[parameterIndex]), gamma, begin, end, _parameters.lossFunction); }, [&](auto arg) { ProtoNNTrainerUtils::HardThresholding(arg, _sparsity[parameterIndex]); }, parameterMatrix, epochs, n, sgdBatchSize, paramStepSize, eta_update);
+            AcceleratedProximalGradient(parameterIndex, [&](ConstColumnMatrixReference /*W*/, const size_t begin, const size_t end) -> math::ColumnMatrix<double> { return Gradient(parameterIndex, X, Y, WX, gamma, begin, end, _recomputeWX[parameterIndex]); }, [&](auto arg) { ProtoNNTrainerUtils::HardThresholding(arg, _sparsity[parameterIndex]); }, parameterMatrix, epochs, n, sgdBatchSize, paramStepSize, eta_update);
 
-            math::MultiplyScaleAddUpdate(1.0, _modelMap[m_projectionIndex]->GetData(), X, 0.0, WX);
+            // WX only changes with the projection
+            if (_recomputeWX[parameterIndex])
+            {
+                ComputeWX(_modelMap[m_projectionIndex]->GetData(), X, WX);
+            }
             fOld = fCur;
-            fCur = ComputeObjective(X, Y, WX, gamma, _recomputeWX[parameterIndex]);
+            fCur = ComputeObjective(X, Y, WX, gamma, false);
 
             // Armijo step
             // If function value has increased, decrease the step size else increase
@@ -513,9 +563,9 @@ namespace trainers
         UNUSED(WX);
         assert(end - begin == D.NumRows());
 
-        auto W = modelMap[ProtoNNParameterIndex::W]->GetData();
-        auto B = modelMap[ProtoNNParameterIndex::B]->GetData();
-        auto Z = modelMap[ProtoNNParameterIndex::Z]->GetData();
+        const auto& W = modelMap.at(ProtoNNParameterIndex::W)->GetData();
+        const auto& B = modelMap.at(ProtoNNParameterIndex::B)->GetData();
+        const auto& Z = modelMap.at(ProtoNNParameterIndex::Z)->GetData();
 
         auto y = Y.GetSubMatrix(0, begin, Y.NumRows(), end - begin).Transpose();
 
@@ -592,7 +642,7 @@ namespace trainers
 
         assert(end - begin == Similarity.NumRows());
 
-        auto Z = modelMap[ProtoNNParameterIndex::Z]->GetData();
+        const auto& Z = modelMap.at(ProtoNNParameterIndex::Z)->GetData();
 
         auto y = Y.GetSubMatrix(0, begin, Y.NumRows(), end - begin);
 
@@ -640,8 +690,8 @@ namespace trainers
         UNUSED(X, WX);
         assert(end - begin == Similarity.NumRows());
 
-        auto B = modelMap[ProtoNNParameterIndex::B]->GetData();
-        auto Z = modelMap[ProtoNNParameterIndex::Z]->GetData();
+        const auto& B = modelMap.at(ProtoNNParameterIndex::B)->GetData();
+        const auto& Z = modelMap.at(ProtoNNParameterIndex::Z)->GetData();
 
         auto y = Y.GetSubMatrix(0, begin, Y.NumRows(), end - begin).Transpose();
         auto wx = WX.GetSubMatrix(0, begin, WX.NumRows(), end - begin);
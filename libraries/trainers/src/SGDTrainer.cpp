@@ -15,7 +15,7 @@ namespace trainers
 
     void SGDTrainerBase::SetDataset(const data::AnyDataset& anyDataset)
     {
-        _dataset = data::Dataset<data::AutoSupervisedExample>(anyDataset);
+        _dataset = data::PermutedDataset(anyDataset);
     }
 
     void SGDTrainerBase::Update()
@@ -23,36 +23,24 @@ namespace trainers
         // permute the data
         _dataset.RandomPermute(_random);
 
-        // get example iterator
-        auto exampleIterator = _dataset.GetExampleReferenceIterator();
-
-        // first iteration handled separately
-        if (_firstIteration && exampleIterator.IsValid())
-        {
-            const auto& example = exampleIterator.Get();
-
-            const auto& x = example.GetDataVector();
-            double y = example.GetMetadata().label;
-            double weight = example.GetMetadata().weight;
-
-            DoFirstStep(x, y, weight);
-
-            exampleIterator.Next();
-            _firstIteration = false;
-        }
-
-        while (exampleIterator.IsValid())
+        for (size_t i = 0; i < _dataset.NumExamples(); ++i)
         {
-            // get the Next example
-            const auto& example = exampleIterator.Get();
-
-            const auto& x = example.GetDataVector();
-            double y = example.GetMetadata().label;
-            double weight = example.GetMetadata().weight;
-
-            DoNextStep(x, y, weight);
-
-            exampleIterator.Next();
+            _dataset.VisitExample(i, [this](const data::AutoSupervisedExample& example) {
+                const auto& x = example.GetDataVector();
+                double y = example.GetMetadata().label;
+                double weight = example.GetMetadata().weight;
+
+                // first iteration handled separately
+                if (_firstIteration)
+                {
+                    DoFirstStep(x, y, weight);
+                    _firstIteration = false;
+                }
+                else
+                {
+                    DoNextStep(x, y, weight);
+                }
+            });
         }
     }
 
@@ -8,16 +8,37 @@
 
 #include <data/include/Dataset.h>
 
+#include <evaluators/include/Evaluator.h>
+#include <evaluators/include/LossAggregator.h>
+
 #include <functions/include/L2Regularizer.h>
 #include <functions/include/LogLoss.h>
 #include <functions/include/SquaredLoss.h>
 
+#include <trainers/include/BinnedFeatureMatrix.h>
+#include <trainers/include/BinnedForestTrainer.h>
+#include <trainers/include/EvaluatingTrainer.h>
+#include <trainers/include/HistogramForestTrainer.h>
+#include <trainers/include/HogwildSGDTrainer.h>
+#include <trainers/include/KMeansTrainer.h>
+#include <trainers/include/LogitBooster.h>
 #include <trainers/include/MeanCalculator.h>
+#include <trainers/include/ProtoNNTrainer.h>
 #include <trainers/include/SDCATrainer.h>
 #include <trainers/include/SGDTrainer.h>
+#include <trainers/include/SortingForestTrainer.h>
+#include <trainers/include/SweepingTrainer.h>
+#include <trainers/include/ThresholdFinder.h>
 
 #include <testing/include/testing.h>
 
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <tuple>
+
 using namespace ell;
 
 /// Runs all tests
@@ -117,6 +138,263 @@ void TestSGDTrainer()
     return;
 }
 
+void TestMiniBatchSDCATrainer()
+{
+    data::AutoSupervisedDataset dataset;
+    dataset.AddExample({ { 1.0, 0.0, 2.0, 0.0, 3.0 }, { 1.0, 1.0 } });
+    dataset.AddExample({ { 0.0, 4.0, 5.0, 6.0, 7.0 }, { 1.0, -1.0 } });
+    dataset.AddExample({ { 8.0, 0.0, 9.0 }, { 1.0, 1.0 } });
+    dataset.AddExample({ { 0.0, 10.0 }, { 1.0, -1.0 } });
+    dataset.AddExample({ { 2.0, 1.0, 0.0, 0.0, 1.0 }, { 1.0, 1.0 } });
+    dataset.AddExample({ { 0.0, 3.0, 1.0, 2.0 }, { 1.0, -1.0 } });
+
+    auto train = [&](size_t numThreads) {
+        trainers::SDCATrainerParameters parameters{ 1.0e-4, 1.0e-8, 20, true, "XYZ" };
+        parameters.batchSize = 4;
+        parameters.numThreads = numThreads;
+        auto trainer = trainers::MakeSDCATrainer(functions::LogLoss(), functions::L2Regularizer(), parameters);
+        trainer->SetDataset(dataset.GetAnyDataset());
+        for (size_t epoch = 0; epoch < 100; ++epoch)
+        {
+            trainer->Update();
+        }
+        return trainer->GetPredictor();
+    };
+
+    auto predictor = train(1);
+    functions::LogLoss lossFunction;
+    double error = 0;
+    for (size_t j = 0; j < dataset.NumExamples(); ++j)
+    {
+        const auto& example = dataset[j];
+        error += lossFunction(predictor.Predict(example.GetDataVector()), example.GetMetadata().label);
+    }
+    printf("TestMiniBatchSDCATrainer error is %f\n", error);
+    testing::ProcessTest("TestMiniBatchSDCATrainer", error < 0.05);
+
+    // the number of threads doesn't change the result
+    auto threadedPredictor = train(3);
+    testing::ProcessTest("TestMiniBatchSDCATrainer numThreads", testing::IsEqual(predictor.GetWeights().ToArray(), threadedPredictor.GetWeights().ToArray()) && predictor.GetBias() == threadedPredictor.GetBias());
+}
+
+void TestHogwildSGDTrainer()
+{
+    data::AutoSupervisedDataset dataset;
+    std::default_random_engine engine(1234);
+    std::uniform_int_distribution<size_t> indexDistribution(0, 199);
+    std::normal_distribution<double> noise(0.0, 0.1);
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        // sparse examples whose label is the sign of the sum of the even coordinates minus the odd ones
+        std::vector<data::IndexValue> entries;
+        double score = 0;
+        for (size_t j = 0; j < 5; ++j)
+        {
+            auto index = indexDistribution(engine);
+            bool isDuplicate = false;
+            for (const auto& entry : entries)
+            {
+                isDuplicate = isDuplicate || entry.index == index;
+            }
+            if (!isDuplicate)
+            {
+                entries.push_back({ index, 1.0 });
+                score += (index % 2 == 0 ? 1.0 : -1.0) + noise(engine);
+            }
+        }
+        std::sort(entries.begin(), entries.end(), [](const data::IndexValue& a, const data::IndexValue& b) { return a.index < b.index; });
+        dataset.AddExample({ data::AutoDataVector(entries), { 1.0, score > 0 ? 1.0 : -1.0 } });
+    }
+
+    auto getError = [&](const predictors::LinearPredictor<double>& predictor) {
+        size_t numErrors = 0;
+        for (size_t i = 0; i < dataset.NumExamples(); ++i)
+        {
+            const auto& example = dataset[i];
+            numErrors += predictor.Predict(example.GetDataVector()) * example.GetMetadata().label <= 0 ? 1 : 0;
+        }
+        return static_cast<double>(numErrors) / static_cast<double>(dataset.NumExamples());
+    };
+
+    // with one thread, Hogwild is SparseDataSGD
+    trainers::HogwildSGDTrainerParameters parameters{ { 1.0e-3, "XYZ" }, 1 };
+    auto hogwildTrainer = trainers::MakeHogwildSGDTrainer(functions::LogLoss(), parameters);
+    auto sparseDataTrainer = trainers::MakeSparseDataSGDTrainer(functions::LogLoss(), { 1.0e-3, "XYZ" });
+    hogwildTrainer->SetDataset(dataset.GetAnyDataset());
+    sparseDataTrainer->SetDataset(dataset.GetAnyDataset());
+    for (size_t epoch = 0; epoch < 3; ++epoch)
+    {
+        hogwildTrainer->Update();
+        sparseDataTrainer->Update();
+    }
+    const auto& hogwildPredictor = hogwildTrainer->GetPredictor();
+    const auto& sparseDataPredictor = sparseDataTrainer->GetPredictor();
+    testing::ProcessTest("TestHogwildSGDTrainer one thread", testing::IsEqual(hogwildPredictor.GetWeights().ToArray(), sparseDataPredictor.GetWeights().ToArray(), 1.0e-6) && testing::IsEqual(hogwildPredictor.GetBias(), sparseDataPredictor.GetBias(), 1.0e-6));
+
+    // with several threads, it still learns
+    parameters.numThreads = 4;
+    auto threadedTrainer = trainers::MakeHogwildSGDTrainer(functions::LogLoss(), parameters);
+    threadedTrainer->SetDataset(dataset.GetAnyDataset());
+    for (size_t epoch = 0; epoch < 3; ++epoch)
+    {
+        threadedTrainer->Update();
+    }
+    auto error = getError(threadedTrainer->GetPredictor());
+    printf("TestHogwildSGDTrainer error rate is %f\n", error);
+    testing::ProcessTest("TestHogwildSGDTrainer several threads", error < 0.1);
+}
+
+std::unique_ptr<trainers::SweepingTrainer<predictors::LinearPredictor<double>>> MakeTestSweepingTrainer(const data::AutoSupervisedDataset& dataset, const trainers::SweepingTrainerParameters& parameters)
+{
+    using PredictorType = predictors::LinearPredictor<double>;
+    std::vector<trainers::EvaluatingTrainer<PredictorType>> evaluatingTrainers;
+    for (double regularization : { 1.0e-1, 1.0e-2, 1.0e-3, 1.0e-4 })
+    {
+        auto evaluator = evaluators::MakeEvaluator<PredictorType>(dataset.GetAnyDataset(), { 1, false }, evaluators::MakeLossAggregator(functions::SquaredLoss()));
+        evaluatingTrainers.push_back(trainers::MakeEvaluatingTrainer(trainers::MakeSGDTrainer(functions::SquaredLoss(), { regularization, "XYZ" }), evaluator));
+    }
+    return std::make_unique<trainers::SweepingTrainer<PredictorType>>(std::move(evaluatingTrainers), parameters);
+}
+
+void TestSweepingTrainer()
+{
+    data::AutoSupervisedDataset dataset;
+    dataset.AddExample({ { 1.0, 0.0, 2.0 }, { 1.0, 1.0 } });
+    dataset.AddExample({ { 0.0, 4.0, 5.0 }, { 1.0, -1.0 } });
+    dataset.AddExample({ { 8.0, 0.0, 9.0 }, { 1.0, 1.0 } });
+    dataset.AddExample({ { 0.0, 10.0, 1.0 }, { 1.0, -1.0 } });
+    dataset.AddExample({ { 3.0, 1.0, 0.0 }, { 1.0, 1.0 } });
+    dataset.AddExample({ { 1.0, 6.0, 2.0 }, { 1.0, -1.0 } });
+
+    auto serialTrainer = MakeTestSweepingTrainer(dataset, { 1, 1.0 });
+    auto parallelTrainer = MakeTestSweepingTrainer(dataset, { 4, 1.0 });
+    auto halvingTrainer = MakeTestSweepingTrainer(dataset, { 4, 0.5 });
+    serialTrainer->SetDataset(dataset.GetAnyDataset());
+    parallelTrainer->SetDataset(dataset.GetAnyDataset());
+    halvingTrainer->SetDataset(dataset.GetAnyDataset());
+
+    std::vector<size_t> numActive;
+    for (int epoch = 0; epoch < 3; ++epoch)
+    {
+        serialTrainer->Update();
+        parallelTrainer->Update();
+        halvingTrainer->Update();
+        numActive.push_back(halvingTrainer->NumActiveTrainers());
+    }
+
+    const auto& serialPredictor = serialTrainer->GetPredictor();
+    const auto& parallelPredictor = parallelTrainer->GetPredictor();
+    testing::ProcessTest("TestSweepingTrainer numThreads", testing::IsEqual(serialPredictor.GetWeights().ToArray(), parallelPredictor.GetWeights().ToArray()) && serialPredictor.GetBias() == parallelPredictor.GetBias());
+    testing::ProcessTest("TestSweepingTrainer successive halving", numActive == std::vector<size_t>{ 2, 1, 1 } && parallelTrainer->NumActiveTrainers() == 4);
+
+    bool threw = false;
+    try
+    {
+        MakeTestSweepingTrainer(dataset, { 1, 0.0 });
+    }
+    catch (const utilities::InputException&)
+    {
+        threw = true;
+    }
+    testing::ProcessTest("TestSweepingTrainer invalid keepFraction", threw);
+}
+
+void TestKMeansTrainer()
+{
+    // three well-separated blobs
+    const std::vector<std::vector<double>> centers = { { 0.0, 0.0, 0.0 }, { 10.0, 0.0, 5.0 }, { 0.0, 10.0, -5.0 } };
+    const size_t pointsPerCenter = 100;
+    std::default_random_engine random;
+    std::normal_distribution<double> noise(0.0, 0.5);
+    math::ColumnMatrix<double> X(3, centers.size() * pointsPerCenter);
+    for (size_t i = 0; i < X.NumColumns(); ++i)
+    {
+        for (size_t j = 0; j < X.NumRows(); ++j)
+        {
+            X(j, i) = centers[i % centers.size()][j] + noise(random);
+        }
+    }
+
+    auto runKMeans = [&](trainers::KMeansTrainerParameters parameters) {
+        parameters.blockSize = 16;
+        trainers::KMeansTrainer kMeans(X.NumRows(), centers.size(), 20, parameters);
+        kMeans.RunKMeans(X);
+        return std::make_tuple(kMeans.GetClusterMeans(), kMeans.GetClusterAssignment().ToArray(), kMeans.GetTotalDistance());
+    };
+
+    // each blob should end up in its own cluster
+    auto isClustered = [&](const std::vector<double>& assignment) {
+        for (size_t i = 0; i < assignment.size(); ++i)
+        {
+            if (assignment[i] != assignment[i % centers.size()])
+            {
+                return false;
+            }
+        }
+        return assignment[0] != assignment[1] && assignment[1] != assignment[2] && assignment[0] != assignment[2];
+    };
+
+    auto [serialMeans, serialAssignment, serialDistance] = runKMeans({ 1 });
+    auto [parallelMeans, parallelAssignment, parallelDistance] = runKMeans({ 4 });
+    auto [miniBatchMeans, miniBatchAssignment, miniBatchDistance] = runKMeans({ 4, 0, 32 });
+
+    // the expected objective is about numPoints * dimension * variance
+    auto expectedDistance = X.NumColumns() * X.NumRows() * 0.25;
+    testing::ProcessTest("TestKMeansTrainer", isClustered(serialAssignment) && serialDistance < 1.5 * expectedDistance);
+    testing::ProcessTest("TestKMeansTrainer numThreads", serialMeans == parallelMeans && serialAssignment == parallelAssignment && serialDistance == parallelDistance);
+    testing::ProcessTest("TestKMeansTrainer mini-batch", isClustered(miniBatchAssignment) && miniBatchDistance < 1.5 * expectedDistance);
+}
+
+void TestProtoNNTrainer()
+{
+    // three well-separated classes
+    const std::vector<std::vector<double>> centers = { { 1.0, 0.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0, 0.0 }, { 0.0, 0.0, 1.0, 1.0 } };
+    std::default_random_engine random;
+    std::normal_distribution<double> noise(0.0, 0.1);
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < 150; ++i)
+    {
+        auto label = i % centers.size();
+        std::vector<double> x = centers[label];
+        for (auto& value : x)
+        {
+            value += noise(random);
+        }
+        dataset.AddExample({ x, { 1.0, static_cast<double>(label) } });
+    }
+
+    auto train = [&](size_t numThreads, size_t batchSize) {
+        trainers::ProtoNNTrainerParameters parameters{ 4, centers.size(), 2, 2, 1.0, 1.0, 1.0, -1.0, trainers::ProtoNNLossFunction::L2, 5, 1, false, numThreads, batchSize };
+        trainers::ProtoNNTrainer trainer(parameters);
+        trainer.SetDataset(dataset.GetAnyDataset(0, dataset.NumExamples()));
+        for (size_t i = 0; i < parameters.numIterations; ++i)
+        {
+            trainer.Update();
+        }
+        return trainer.GetPredictor();
+    };
+
+    auto accuracy = [&](const predictors::ProtoNNPredictor& predictor) {
+        size_t numCorrect = 0;
+        for (size_t i = 0; i < dataset.NumExamples(); ++i)
+        {
+            const auto& example = dataset.GetExample(i);
+            auto scores = predictor.Predict(example.GetDataVector().ToArray()).ToArray();
+            auto prediction = std::max_element(scores.begin(), scores.end()) - scores.begin();
+            numCorrect += prediction == static_cast<ptrdiff_t>(example.GetMetadata().label) ? 1 : 0;
+        }
+        return static_cast<double>(numCorrect) / dataset.NumExamples();
+    };
+
+    auto serialPredictor = train(1, 32);
+    auto parallelPredictor = train(4, 32);
+    auto fullBatchPredictor = train(4, 0);
+
+    testing::ProcessTest("TestProtoNNTrainer", accuracy(serialPredictor) > 0.95);
+    testing::ProcessTest("TestProtoNNTrainer numThreads", testing::IsEqual(serialPredictor.GetProjectionMatrix().ToArray(), parallelPredictor.GetProjectionMatrix().ToArray(), 1e-6) && accuracy(parallelPredictor) > 0.95);
+    testing::ProcessTest("TestProtoNNTrainer full batch", accuracy(fullBatchPredictor) > 0.95);
+}
+
 void TestMeanCalculator()
 {
     data::AutoSupervisedDataset dataset;
@@ -131,9 +409,183 @@ void TestMeanCalculator()
     testing::ProcessTest("TestMeanCalculator", mean == r);
 }
 
+data::AutoSupervisedDataset GetForestTrainerDataset(int numExamples = 4000, int numValuesX2 = 1009)
+{
+    // a noisy function of 4 features, with repeated feature values so that some rows can't be separated
+    data::AutoSupervisedDataset dataset;
+    for (int index = 0; index < numExamples; ++index)
+    {
+        double x0 = (index * 37) % 101;
+        double x1 = (index * 53) % 17;
+        double x2 = (index * 11) % numValuesX2;
+        double x3 = 1 + index % 2; // nonzero, so every data vector has all 4 elements
+        double label = (x0 > 50 ? 1.0 : -1.0) * (x3 == 1 ? 1.0 : -1.0) + (x1 > 8 ? 0.5 : -0.5) + ((index * 7919) % 13 == 0 ? 2.0 : 0.0);
+        dataset.AddExample({ { x0, x1, x2, x3 }, { 1.0, label } });
+    }
+    return dataset;
+}
+
+template <typename ForestPredictorType>
+bool HaveSamePredictions(const ForestPredictorType& forest1, const ForestPredictorType& forest2, const data::AutoSupervisedDataset& dataset)
+{
+    if (forest1.NumTrees() != forest2.NumTrees() || forest1.NumInteriorNodes() != forest2.NumInteriorNodes())
+    {
+        return false;
+    }
+
+    for (size_t index = 0; index < dataset.NumExamples(); ++index)
+    {
+        auto dataVector = dataset[index].GetDataVector().template CopyAs<typename ForestPredictorType::DataVectorType>();
+        if (forest1.Predict(dataVector) != forest2.Predict(dataVector))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TestSortingForestTrainerNumThreads(int numExamples)
+{
+    auto dataset = GetForestTrainerDataset(numExamples);
+
+    trainers::SortingForestTrainerParameters parameters;
+    parameters.minSplitGain = 0.0;
+    parameters.maxSplitsPerRound = 8;
+    parameters.numRounds = 3;
+
+    parameters.numThreads = 1;
+    auto trainer1 = trainers::MakeSortingForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), parameters);
+    trainer1->SetDataset(dataset.GetAnyDataset());
+    trainer1->Update();
+
+    parameters.numThreads = 4;
+    auto trainer4 = trainers::MakeSortingForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), parameters);
+    trainer4->SetDataset(dataset.GetAnyDataset());
+    trainer4->Update();
+
+    testing::ProcessTest("TestSortingForestTrainerNumThreads with " + std::to_string(numExamples) + " examples", trainer1->GetPredictor().NumInteriorNodes() > 0 && HaveSamePredictions(trainer1->GetPredictor(), trainer4->GetPredictor(), dataset));
+}
+
+void TestHistogramForestTrainerNumThreads(int numExamples)
+{
+    auto dataset = GetForestTrainerDataset(numExamples);
+
+    trainers::HistogramForestTrainerParameters parameters;
+    parameters.minSplitGain = 0.0;
+    parameters.maxSplitsPerRound = 8;
+    parameters.numRounds = 3;
+    parameters.randomSeed = "123456";
+    parameters.thresholdFinderSampleSize = 200;
+    parameters.candidatesPerInput = 8;
+
+    parameters.numThreads = 1;
+    auto trainer1 = trainers::MakeHistogramForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainers::ExhaustiveThresholdFinder(), parameters);
+    trainer1->SetDataset(dataset.GetAnyDataset());
+    trainer1->Update();
+
+    parameters.numThreads = 4;
+    auto trainer4 = trainers::MakeHistogramForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainers::ExhaustiveThresholdFinder(), parameters);
+    trainer4->SetDataset(dataset.GetAnyDataset());
+    trainer4->Update();
+
+    testing::ProcessTest("TestHistogramForestTrainerNumThreads with " + std::to_string(numExamples) + " examples", trainer1->GetPredictor().NumInteriorNodes() > 0 && HaveSamePredictions(trainer1->GetPredictor(), trainer4->GetPredictor(), dataset));
+}
+
+void TestBinnedFeatureMatrix()
+{
+    // few distinct values: each one gets its own bin
+    trainers::BinnedFeatureMatrix matrix(5, 2, 255);
+    matrix.SetColumn(0, { 3.0, 1.0, 2.0, 2.0, 5.0 });
+    matrix.SetColumn(1, { 7.0, 7.0, 7.0, 7.0, 7.0 });
+    std::vector<size_t> bins0;
+    for (size_t rowIndex = 0; rowIndex < 5; ++rowIndex)
+    {
+        bins0.push_back(matrix.GetBin(rowIndex, 0));
+    }
+    bool ok = !matrix.HasWideBins() && bins0 == std::vector<size_t>{ 2, 0, 1, 1, 3 } && matrix.NumBins(0) == 4 && matrix.NumBins(1) == 1;
+    ok = ok && matrix.GetThreshold(0, 0) == 1.5 && matrix.GetThreshold(0, 1) == 2.5 && matrix.GetThreshold(0, 2) == 4.0;
+    testing::ProcessTest("TestBinnedFeatureMatrix distinct values", ok);
+
+    // many distinct values: quantile bins, each value lands in the bin its threshold says
+    const size_t numRows = 1000;
+    trainers::BinnedFeatureMatrix wideMatrix(numRows, 1, 300);
+    std::vector<double> values;
+    for (size_t rowIndex = 0; rowIndex < numRows; ++rowIndex)
+    {
+        values.push_back(static_cast<double>((rowIndex * 7) % numRows));
+    }
+    wideMatrix.SetColumn(0, values);
+    ok = wideMatrix.HasWideBins() && wideMatrix.NumBins(0) == 300;
+    for (size_t rowIndex = 0; rowIndex < numRows; ++rowIndex)
+    {
+        auto bin = wideMatrix.GetBin(rowIndex, 0);
+        ok = ok && (bin + 1 == wideMatrix.NumBins(0) || values[rowIndex] <= wideMatrix.GetThreshold(0, bin));
+        ok = ok && (bin == 0 || values[rowIndex] > wideMatrix.GetThreshold(0, bin - 1));
+    }
+    testing::ProcessTest("TestBinnedFeatureMatrix quantile bins", ok);
+}
+
+void TestBinnedForestTrainer()
+{
+    // keep every feature under 256 distinct values, so that binning is exact
+    auto dataset = GetForestTrainerDataset(4000, 199);
+
+    trainers::BinnedForestTrainerParameters parameters;
+    parameters.minSplitGain = 0.0;
+    parameters.maxSplitsPerRound = 8;
+    parameters.numRounds = 3;
+
+    // all features have fewer than 256 distinct values, so 8-bit and 16-bit bins should give the same forest
+    parameters.maxBinsPerFeature = 255;
+    parameters.numThreads = 1;
+    auto trainer = trainers::MakeBinnedForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), parameters);
+    trainer->SetDataset(dataset.GetAnyDataset());
+    trainer->Update();
+
+    parameters.maxBinsPerFeature = 2000;
+    parameters.numThreads = 4;
+    auto wideTrainer = trainers::MakeBinnedForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), parameters);
+    wideTrainer->SetDataset(dataset.GetAnyDataset());
+    wideTrainer->Update();
+
+    testing::ProcessTest("TestBinnedForestTrainer bin width and threads", trainer->GetPredictor().NumInteriorNodes() == 24 && HaveSamePredictions(trainer->GetPredictor(), wideTrainer->GetPredictor(), dataset));
+
+    // with only 8 bins per feature the trainer still reduces the loss
+    parameters.maxBinsPerFeature = 8;
+    auto coarseTrainer = trainers::MakeBinnedForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), parameters);
+    coarseTrainer->SetDataset(dataset.GetAnyDataset());
+    coarseTrainer->Update();
+
+    functions::SquaredLoss lossFunction;
+    double initialLoss = 0;
+    double loss = 0;
+    for (size_t index = 0; index < dataset.NumExamples(); ++index)
+    {
+        auto label = dataset[index].GetMetadata().label;
+        auto dataVector = dataset[index].GetDataVector().CopyAs<data::FloatDataVector>();
+        initialLoss += lossFunction(0.0, label);
+        loss += lossFunction(coarseTrainer->GetPredictor().Predict(dataVector), label);
+    }
+    printf("TestBinnedForestTrainer loss with 8 bins per feature: %f -> %f\n", initialLoss, loss);
+    testing::ProcessTest("TestBinnedForestTrainer coarse bins", loss < 0.75 * initialLoss);
+}
+
 int main()
 {
     TestSDCATrainer();
     TestSGDTrainer();
+    TestMiniBatchSDCATrainer();
+    TestHogwildSGDTrainer();
+    TestSweepingTrainer();
+    TestKMeansTrainer();
+    TestProtoNNTrainer();
     TestMeanCalculator();
+    TestSortingForestTrainerNumThreads(4000);
+    TestHistogramForestTrainerNumThreads(4000);
+
+    // more rows than two of the trainers' 4096-row blocks, so the block sums are combined across blocks
+    TestSortingForestTrainerNumThreads(10000);
+    TestHistogramForestTrainerNumThreads(10000);
+    TestBinnedFeatureMatrix();
+    TestBinnedForestTrainer();
 }
@@ -0,0 +1,454 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryArchiver.h (utilities)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Archiver.h"
+#include "Exception.h"
+#include "MemoryMappedFile.h"
+#include "TypeFactory.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary> The kinds of records in a binary archive. Every record starts with its kind and its (possibly empty) name. </summary>
+    enum class BinaryArchiveRecordType : uint8_t
+    {
+        scalar = 1,
+        string,
+        null,
+        array,
+        stringArray,
+        objectArrayBegin,
+        objectArrayEnd,
+        objectBegin,
+        objectEnd,
+        primitiveObject
+    };
+
+    /// <summary> How a fundamental value is encoded. Together with the value's size, this lets values be read back as a different fundamental type. </summary>
+    enum class BinaryArchiveValueKind : uint8_t
+    {
+        boolean = 1,
+        signedInteger,
+        unsignedInteger,
+        floatingPoint
+    };
+
+    /// <summary>
+    /// An archiver that encodes data in a binary format. Fundamental values are written in native byte order, and
+    /// the elements of arrays of fundamental types are written as one raw block, aligned to `arrayAlignment` bytes
+    /// from the start of the archive. Reading such an array back is a single copy, and a memory-mapped archive
+    /// keeps the blocks aligned in memory. The archive must start at the beginning of the stream for the alignment
+    /// to hold in the file.
+    /// </summary>
+    class BinaryArchiver : public Archiver
+    {
+    public:
+        /// <summary> The alignment of array data, in bytes from the start of the archive. </summary>
+        static constexpr size_t arrayAlignment = 64;
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="outputStream"> The stream to write data to. Must be opened in binary mode. </summary>
+        BinaryArchiver(std::ostream& outputStream);
+
+    protected:
+#define ARCHIVE_TYPE_OP(t) DECLARE_ARCHIVE_VALUE_OVERRIDE(t);
+        ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+        void ArchiveValue(const char* name, const std::string& value) override;
+
+#define ARCHIVE_TYPE_OP(t) DECLARE_ARCHIVE_ARRAY_OVERRIDE(t);
+        ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+        void ArchiveNull(const char* name) override;
+
+        void ArchiveArray(const char* name, const std::vector<std::string>& array) override;
+        void ArchiveArray(const char* name, const std::string& baseTypeName, const std::vector<const IArchivable*>& array) override;
+
+        void BeginArchiveObject(const char* name, const IArchivable& value) override;
+        void EndArchiveObject(const char* name, const IArchivable& value) override;
+
+        void EndArchiving() override;
+
+    private:
+        // Serialization
+        void WriteFileHeader();
+
+        template <typename ValueType, IsFundamental<ValueType> concept = 0>
+        void WriteScalar(const char* name, const ValueType& value);
+
+        template <typename ValueType>
+        void WriteArray(const char* name, const std::vector<ValueType>& array);
+
+        void WriteRecordHeader(BinaryArchiveRecordType type, const char* name);
+        void WriteString(const std::string& value);
+        void WritePadding(size_t alignment);
+        void WriteBytes(const void* data, size_t size);
+
+        template <typename ValueType>
+        void WriteRaw(const ValueType& value);
+
+        std::ostream& _out;
+        size_t _position = 0;
+    };
+
+    /// <summary>
+    /// A read-only array of fundamental values that is stored in a memory-mapped binary archive. It shares ownership
+    /// of the mapping, so its values stay valid after the unarchiver that read it is gone.
+    /// </summary>
+    template <typename ValueType>
+    class MappedArray
+    {
+    public:
+        MappedArray() = default;
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="file"> The mapped file that holds the values. </param>
+        /// <param name="data"> A pointer to the first value in the mapping. </param>
+        /// <param name="size"> The number of values. </param>
+        MappedArray(std::shared_ptr<const MemoryMappedFile> file, const ValueType* data, size_t size) :
+            _file(std::move(file)),
+            _data(data),
+            _size(size) {}
+
+        /// <summary> Indicates if the array refers to a mapped file. </summary>
+        bool IsMapped() const { return _file != nullptr; }
+
+        /// <summary> Gets the number of values. </summary>
+        size_t Size() const { return _size; }
+
+        /// <summary> Gets a pointer to the first value. </summary>
+        const ValueType* GetData() const { return _data; }
+
+        const ValueType* begin() const { return _data; }
+        const ValueType* end() const { return _data + _size; }
+
+        /// <summary> Copies the values out of the mapping. </summary>
+        std::vector<ValueType> ToArray() const { return { begin(), end() }; }
+
+    private:
+        std::shared_ptr<const MemoryMappedFile> _file;
+        const ValueType* _data = nullptr;
+        size_t _size = 0;
+    };
+
+    /// <summary>
+    /// An unarchiver that reads data encoded by `BinaryArchiver`. It reads from a memory-mapped file when given a
+    /// path, so the archive itself takes no heap memory and arrays are copied straight out of the page cache.
+    /// </summary>
+    class BinaryUnarchiver : public Unarchiver
+    {
+    public:
+        /// <summary> Constructor that reads the whole stream into memory. </summary>
+        ///
+        /// <param name="inputStream"> The stream to read data from. Must be opened in binary mode. </summary>
+        /// <param name="context"> The `SerializationContext` to use. </summary>
+        BinaryUnarchiver(std::istream& inputStream, SerializationContext context);
+
+        /// <summary> Constructor that maps a file into memory. </summary>
+        ///
+        /// <param name="filepath"> The path of the archive file. </summary>
+        /// <param name="context"> The `SerializationContext` to use. </summary>
+        BinaryUnarchiver(const std::string& filepath, SerializationContext context);
+
+        /// <summary> Indicates if a property with the given name is available to be read next </summary>
+        ///
+        /// <param name="name"> The name of the property </param>
+        ///
+        /// <returns> true if a property with the given name can be read next </returns>
+        bool HasNextPropertyName(const std::string& name) override;
+
+        /// <summary>
+        /// Reads an array of fundamental values without copying it, if the archive is a memory-mapped file and the
+        /// values are stored as `ValueType`. Otherwise nothing is read, and the array can be read as usual.
+        /// </summary>
+        ///
+        /// <param name="name"> The name of the array. </param>
+        /// <param name="array"> The array that refers to the values in the mapping. </param>
+        ///
+        /// <returns> true if the array was read. </returns>
+        template <typename ValueType, IsFundamental<ValueType> concept = 0>
+        bool TryUnarchiveMappedArray(const char* name, MappedArray<ValueType>& array);
+
+    protected:
+#define ARCHIVE_TYPE_OP(t) DECLARE_UNARCHIVE_VALUE_OVERRIDE(t);
+        ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+        void UnarchiveValue(const char* name, std::string& value) override;
+
+        bool UnarchiveNull(const char* name) override;
+
+#define ARCHIVE_TYPE_OP(t) DECLARE_UNARCHIVE_ARRAY_OVERRIDE(t);
+        ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+        void UnarchiveArray(const char* name, std::vector<std::string>& array) override;
+        void BeginUnarchiveArray(const char* name, const std::string& typeName) override;
+        bool BeginUnarchiveArrayItem(const std::string& typeName) override;
+        void EndUnarchiveArrayItem(const std::string& typeName) override;
+        void EndUnarchiveArray(const char* name, const std::string& typeName) override;
+
+        ArchivedObjectInfo BeginUnarchiveObject(const char* name, const std::string& typeName) override;
+        void UnarchiveObject(const char* name, IArchivable& value) override;
+        void EndUnarchiveObject(const char* name, const std::string& typeName) override;
+        void UnarchiveObjectAsPrimitive(const char* name, IArchivable& value) override;
+
+    private:
+        // Deserialization
+        void ReadFileHeader();
+
+        template <typename ValueType, IsFundamental<ValueType> concept = 0>
+        void ReadScalar(const char* name, ValueType& value);
+
+        template <typename ValueType, IsFundamental<ValueType> concept = 0>
+        void ReadArray(const char* name, std::vector<ValueType>& array);
+
+        const char* TryReadMappedArray(const char* name, BinaryArchiveValueKind kind, size_t size, size_t& count);
+
+        template <typename ValueType>
+        static ValueType ConvertValue(BinaryArchiveValueKind kind, size_t size, const char* data);
+
+        BinaryArchiveRecordType PeekRecordHeader(std::string& name) const;
+        void MatchRecordHeader(BinaryArchiveRecordType type, const char* name);
+        std::string ReadString();
+        void SkipPadding(size_t alignment);
+        const char* ReadBytes(size_t size);
+
+        template <typename ValueType>
+        ValueType ReadRaw();
+
+        std::shared_ptr<MemoryMappedFile> _file;
+        std::vector<char> _buffer;
+        const char* _data = nullptr;
+        size_t _size = 0;
+        size_t _position = 0;
+    };
+} // namespace utilities
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace utilities
+{
+    namespace BinaryArchiverImpl
+    {
+        template <typename ValueType>
+        constexpr BinaryArchiveValueKind GetValueKind()
+        {
+            if constexpr (std::is_same_v<ValueType, bool>)
+            {
+                return BinaryArchiveValueKind::boolean;
+            }
+            else if constexpr (std::is_floating_point_v<ValueType>)
+            {
+                return BinaryArchiveValueKind::floatingPoint;
+            }
+            else if constexpr (std::is_signed_v<ValueType>)
+            {
+                return BinaryArchiveValueKind::signedInteger;
+            }
+            else
+            {
+                return BinaryArchiveValueKind::unsignedInteger;
+            }
+        }
+
+        template <typename ValueType>
+        ValueType Load(const char* data)
+        {
+            ValueType value;
+            std::memcpy(&value, data, sizeof(ValueType));
+            return value;
+        }
+    } // namespace BinaryArchiverImpl
+
+    //
+    // Serialization
+    //
+    template <typename ValueType>
+    void BinaryArchiver::WriteRaw(const ValueType& value)
+    {
+        WriteBytes(&value, sizeof(ValueType));
+    }
+
+    template <typename ValueType, IsFundamental<ValueType> concept>
+    void BinaryArchiver::WriteScalar(const char* name, const ValueType& value)
+    {
+        WriteRecordHeader(BinaryArchiveRecordType::scalar, name);
+        WriteRaw(BinaryArchiverImpl::GetValueKind<ValueType>());
+        if constexpr (std::is_same_v<ValueType, bool>)
+        {
+            WriteRaw(static_cast<uint8_t>(1));
+            WriteRaw(static_cast<uint8_t>(value ? 1 : 0));
+        }
+        else
+        {
+            WriteRaw(static_cast<uint8_t>(sizeof(ValueType)));
+            WriteRaw(value);
+        }
+    }
+
+    template <typename ValueType>
+    void BinaryArchiver::WriteArray(const char* name, const std::vector<ValueType>& array)
+    {
+        WriteRecordHeader(BinaryArchiveRecordType::array, name);
+        WriteRaw(BinaryArchiverImpl::GetValueKind<ValueType>());
+        if constexpr (std::is_same_v<ValueType, bool>)
+        {
+            // std::vector<bool> has no contiguous storage, so write one byte per element
+            WriteRaw(static_cast<uint8_t>(1));
+            WriteRaw(static_cast<uint64_t>(array.size()));
+            WritePadding(arrayAlignment);
+            std::vector<uint8_t> bytes(array.begin(), array.end());
+            WriteBytes(bytes.data(), bytes.size());
+        }
+        else
+        {
+            WriteRaw(static_cast<uint8_t>(sizeof(ValueType)));
+            WriteRaw(static_cast<uint64_t>(array.size()));
+            WritePadding(arrayAlignment);
+            WriteBytes(array.data(), array.size() * sizeof(ValueType));
+        }
+    }
+
+    //
+    // Deserialization
+    //
+    template <typename ValueType>
+    ValueType BinaryUnarchiver::ReadRaw()
+    {
+        return BinaryArchiverImpl::Load<ValueType>(ReadBytes(sizeof(ValueType)));
+    }
+
+    template <typename ValueType>
+    ValueType BinaryUnarchiver::ConvertValue(BinaryArchiveValueKind kind, size_t size, const char* data)
+    {
+        using BinaryArchiverImpl::Load;
+        switch (kind)
+        {
+        case BinaryArchiveValueKind::boolean:
+            return static_cast<ValueType>(Load<uint8_t>(data) != 0);
+        case BinaryArchiveValueKind::signedInteger:
+            switch (size)
+            {
+            case 1:
+                return static_cast<ValueType>(Load<int8_t>(data));
+            case 2:
+                return static_cast<ValueType>(Load<int16_t>(data));
+            case 4:
+                return static_cast<ValueType>(Load<int32_t>(data));
+            case 8:
+                return static_cast<ValueType>(Load<int64_t>(data));
+            }
+            break;
+        case BinaryArchiveValueKind::unsignedInteger:
+            switch (size)
+            {
+            case 1:
+                return static_cast<ValueType>(Load<uint8_t>(data));
+            case 2:
+                return static_cast<ValueType>(Load<uint16_t>(data));
+            case 4:
+                return static_cast<ValueType>(Load<uint32_t>(data));
+            case 8:
+                return static_cast<ValueType>(Load<uint64_t>(data));
+            }
+            break;
+        case BinaryArchiveValueKind::floatingPoint:
+            switch (size)
+            {
+            case sizeof(float):
+                return static_cast<ValueType>(Load<float>(data));
+            case sizeof(double):
+                return static_cast<ValueType>(Load<double>(data));
+            }
+            break;
+        }
+        throw DataFormatException(DataFormatErrors::badFormat, "Binary archive has a value of unknown type");
+    }
+
+    template <typename ValueType, IsFundamental<ValueType> concept>
+    void BinaryUnarchiver::ReadScalar(const char* name, ValueType& value)
+    {
+        MatchRecordHeader(BinaryArchiveRecordType::scalar, name);
+        auto kind = ReadRaw<BinaryArchiveValueKind>();
+        auto size = ReadRaw<uint8_t>();
+        value = ConvertValue<ValueType>(kind, size, ReadBytes(size));
+    }
+
+    template <typename ValueType, IsFundamental<ValueType> concept>
+    void BinaryUnarchiver::ReadArray(const char* name, std::vector<ValueType>& array)
+    {
+        MatchRecordHeader(BinaryArchiveRecordType::array, name);
+        auto kind = ReadRaw<BinaryArchiveValueKind>();
+        auto size = ReadRaw<uint8_t>();
+        auto count = ReadRaw<uint64_t>();
+        SkipPadding(BinaryArchiver::arrayAlignment);
+        auto data = ReadBytes(count * size);
+
+        if constexpr (!std::is_same_v<ValueType, bool>)
+        {
+            if (kind == BinaryArchiverImpl::GetValueKind<ValueType>() && size == sizeof(ValueType))
+            {
+                array.resize(count);
+                std::memcpy(array.data(), data, count * size);
+                return;
+            }
+        }
+
+        array.clear();
+        array.reserve(count);
+        for (size_t index = 0; index < count; ++index)
+        {
+            array.push_back(ConvertValue<ValueType>(kind, size, data + index * size));
+        }
+    }
+
+    template <typename ValueType, IsFundamental<ValueType> concept>
+    bool BinaryUnarchiver::TryUnarchiveMappedArray(const char* name, MappedArray<ValueType>& array)
+    {
+        // vector<bool> arrays are stored one byte per element, which isn't a bool array in memory
+        if constexpr (std::is_same_v<ValueType, bool>)
+        {
+            return false;
+        }
+        else
+        {
+            size_t count = 0;
+            auto data = TryReadMappedArray(name, BinaryArchiverImpl::GetValueKind<ValueType>(), sizeof(ValueType), count);
+            if (data == nullptr)
+            {
+                return false;
+            }
+            array = MappedArray<ValueType>(_file, reinterpret_cast<const ValueType*>(data), count);
+            return true;
+        }
+    }
+} // namespace utilities
+} // namespace ell
+
+#pragma endregion implementation
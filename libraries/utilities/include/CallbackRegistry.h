@@ -9,6 +9,7 @@
 #pragma once
 #include <functional>
 #include <map>
+#include <string>
 #include <vector>
 
 namespace ell
@@ -23,12 +24,16 @@ namespace utilities
         std::vector<std::string> GetSourceFunctionNames();
         void RegisterSourceCallback(std::string name, std::function<bool(std::vector<ElementType>&)> func);
         int GetSourceCallbackIndex(std::string name);
-        std::function<bool(std::vector<ElementType>&)> GetSourceCallback(int index);
+        const std::function<bool(std::vector<ElementType>&)>& GetSourceCallback(int index) const;
+        void SetSourceCallback(int index, std::function<bool(std::vector<ElementType>&)> func);
+        bool HasSourceCallback(const std::string& name) const;
 
         std::vector<std::string> GetSinkFunctionNames();
         void RegisterSinkCallback(std::string name, std::function<void(const std::vector<ElementType>&)> func);
         int GetSinkCallbackIndex(std::string name);
-        std::function<void(const std::vector<ElementType>&)> GetSinkCallback(int index);
+        const std::function<void(const std::vector<ElementType>&)>& GetSinkCallback(int index) const;
+        void SetSinkCallback(int index, std::function<void(const std::vector<ElementType>&)> func);
+        bool HasSinkCallback(const std::string& name) const;
 
         bool HasCallbackFunctions() const;
 
@@ -63,11 +68,23 @@ namespace utilities
     }
 
     template <typename ElementType>
-    std::function<bool(std::vector<ElementType>&)> CallbackRegistry<ElementType>::GetSourceCallback(int index)
+    const std::function<bool(std::vector<ElementType>&)>& CallbackRegistry<ElementType>::GetSourceCallback(int index) const
     {
         return _sourceCallbacks[index];
     }
 
+    template <typename ElementType>
+    void CallbackRegistry<ElementType>::SetSourceCallback(int index, std::function<bool(std::vector<ElementType>&)> func)
+    {
+        _sourceCallbacks[index] = func;
+    }
+
+    template <typename ElementType>
+    bool CallbackRegistry<ElementType>::HasSourceCallback(const std::string& name) const
+    {
+        return _sourceCallbackMap.find(name) != _sourceCallbackMap.end();
+    }
+
     template <typename ElementType>
     void CallbackRegistry<ElementType>::RegisterSinkCallback(std::string name, std::function<void(const std::vector<ElementType>&)> func)
     {
@@ -82,11 +99,23 @@ namespace utilities
     }
 
     template <typename ElementType>
-    std::function<void(const std::vector<ElementType>&)> CallbackRegistry<ElementType>::GetSinkCallback(int index)
+    const std::function<void(const std::vector<ElementType>&)>& CallbackRegistry<ElementType>::GetSinkCallback(int index) const
     {
         return _sinkCallbacks[index];
     }
 
+    template <typename ElementType>
+    void CallbackRegistry<ElementType>::SetSinkCallback(int index, std::function<void(const std::vector<ElementType>&)> func)
+    {
+        _sinkCallbacks[index] = func;
+    }
+
+    template <typename ElementType>
+    bool CallbackRegistry<ElementType>::HasSinkCallback(const std::string& name) const
+    {
+        return _sinkCallbackMap.find(name) != _sinkCallbackMap.end();
+    }
+
     template <typename ElementType>
     std::vector<std::string> CallbackRegistry<ElementType>::GetSourceFunctionNames()
     {
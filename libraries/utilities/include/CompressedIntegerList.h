@@ -44,6 +44,17 @@ namespace utilities
             /// <returns> An size_t. </returns>
             size_t Get() const { return _value; }
 
+            /// <summary>
+            /// Copies the current value and the ones that follow it to a buffer, and advances past them. Decoding
+            /// a block at a time is much faster than calling Get and Next for each value.
+            /// </summary>
+            ///
+            /// <param name="buffer"> The buffer to write to. </param>
+            /// <param name="maxCount"> The size of the buffer. </param>
+            ///
+            /// <returns> The number of values written, which is less than maxCount only when the end of the list is reached. </returns>
+            size_t GetBlock(size_t* buffer, size_t maxCount);
+
         private:
             // private ctor, can only be called from CompressedIntegerList class
             Iterator(const uint8_t* iter, const uint8_t* end);
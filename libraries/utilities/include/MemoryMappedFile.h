@@ -0,0 +1,61 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MemoryMappedFile.h (utilities)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary>
+    /// A read-only view of a whole file, mapped into the address space of the process. Pages are loaded
+    /// on demand and live in the OS page cache, so they are shared between processes that map the same file.
+    /// </summary>
+    class MemoryMappedFile
+    {
+    public:
+        MemoryMappedFile() = default;
+
+        /// <summary> Maps a file. Throws an InputException if the file can't be opened or mapped. </summary>
+        ///
+        /// <param name="filepath"> The file path. </param>
+        explicit MemoryMappedFile(const std::string& filepath);
+
+        MemoryMappedFile(MemoryMappedFile&& other) noexcept;
+        MemoryMappedFile& operator=(MemoryMappedFile&& other) noexcept;
+
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+        /// <summary> Unmaps the file. </summary>
+        ~MemoryMappedFile();
+
+        /// <summary> Gets a pointer to the first byte of the file. </summary>
+        ///
+        /// <returns> Pointer to the mapped bytes, or nullptr if the file is empty. </returns>
+        const char* GetData() const { return _data; }
+
+        /// <summary> Gets the size of the file in bytes. </summary>
+        ///
+        /// <returns> The size of the file. </returns>
+        size_t GetSize() const { return _size; }
+
+    private:
+        void Unmap();
+
+        const char* _data = nullptr;
+        size_t _size = 0;
+#ifdef WIN32
+        void* _fileHandle = nullptr;
+        void* _mappingHandle = nullptr;
+#endif
+    };
+} // namespace utilities
+} // namespace ell
@@ -8,7 +8,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring> // for size_t
+#include <utility>
 #include <vector>
 
 namespace ell
@@ -66,6 +68,55 @@ namespace utilities
         std::vector<T> _buffer;
         size_t _currentPos = 0;
     };
+
+    /// <summary> A fixed-capacity ring buffer used as a lock-free queue between exactly one producer thread and
+    /// exactly one consumer thread. Items are swapped in and out of the slots of the buffer rather than copied,
+    /// so that containers like `std::vector` are recycled between the two threads instead of being reallocated. </summary>
+    template <typename T>
+    class ConcurrentRingBuffer
+    {
+    public:
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="capacity"> The maximum number of items the buffer can hold. </param>
+        ConcurrentRingBuffer(size_t capacity);
+
+        ConcurrentRingBuffer(const ConcurrentRingBuffer&) = delete;
+        ConcurrentRingBuffer& operator=(const ConcurrentRingBuffer&) = delete;
+
+        /// <summary> Get the maximum number of items the buffer can hold. </summary>
+        ///
+        /// <returns> The capacity of the buffer. </returns>
+        size_t Capacity() const;
+
+        /// <summary> Get the number of items in the buffer. If the other thread is pushing or popping at the same time,
+        /// this is only a snapshot. </summary>
+        ///
+        /// <returns> The number of items in the buffer. </returns>
+        size_t Size() const;
+
+        /// <summary> Add an item to the end of the buffer, unless it is full. Must only be called from the producer thread. </summary>
+        ///
+        /// <param name="value"> The item to add. On success, it is swapped with an item previously popped from the buffer
+        /// (or a default-constructed one), which the caller may reuse. </param>
+        ///
+        /// <returns> `true` if the item was added, `false` if the buffer was full. </returns>
+        bool TryPush(T& value);
+
+        /// <summary> Remove the item at the front of the buffer, unless it is empty. Must only be called from the consumer thread. </summary>
+        ///
+        /// <param name="value"> Receives the item. Its previous contents are swapped into the buffer for the producer to reuse. </param>
+        ///
+        /// <returns> `true` if an item was removed, `false` if the buffer was empty. </returns>
+        bool TryPop(T& value);
+
+    private:
+        size_t Next(size_t index) const { return index + 1 == _buffer.size() ? 0 : index + 1; }
+
+        std::vector<T> _buffer; // one slot more than the capacity, so a full buffer can be told apart from an empty one
+        std::atomic<size_t> _head; // the next slot to pop, only written by the consumer
+        std::atomic<size_t> _tail; // the next slot to push, only written by the producer
+    };
 } // namespace utilities
 } // namespace ell
 
@@ -130,6 +181,60 @@ namespace utilities
     {
         std::fill(_buffer.begin(), _buffer.end(), val);
     }
+
+    //
+    // ConcurrentRingBuffer class
+    //
+    template <typename T>
+    ConcurrentRingBuffer<T>::ConcurrentRingBuffer(size_t capacity) :
+        _buffer(capacity + 1),
+        _head(0),
+        _tail(0)
+    {
+    }
+
+    template <typename T>
+    size_t ConcurrentRingBuffer<T>::Capacity() const
+    {
+        return _buffer.size() - 1;
+    }
+
+    template <typename T>
+    size_t ConcurrentRingBuffer<T>::Size() const
+    {
+        auto head = _head.load(std::memory_order_acquire);
+        auto tail = _tail.load(std::memory_order_acquire);
+        return tail >= head ? tail - head : tail + _buffer.size() - head;
+    }
+
+    template <typename T>
+    bool ConcurrentRingBuffer<T>::TryPush(T& value)
+    {
+        auto tail = _tail.load(std::memory_order_relaxed);
+        auto next = Next(tail);
+        if (next == _head.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        std::swap(_buffer[tail], value);
+        _tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    template <typename T>
+    bool ConcurrentRingBuffer<T>::TryPop(T& value)
+    {
+        auto head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        std::swap(_buffer[head], value);
+        _head.store(Next(head), std::memory_order_release);
+        return true;
+    }
 } // namespace utilities
 } // namespace ell
 
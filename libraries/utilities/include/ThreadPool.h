@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ThreadPool.h (utilities)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary> Returns the number of threads to use when the user asks for "as many as the hardware supports". </summary>
+    ///
+    /// <returns> The number of hardware threads, or 1 if it can't be determined. </returns>
+    size_t GetDefaultNumThreads();
+
+    /// <summary>
+    /// A fixed set of worker threads that run parallel loops. The thread calling ParallelFor also does work,
+    /// so a pool with numThreads == 1 starts no threads and runs everything inline.
+    /// </summary>
+    class ThreadPool
+    {
+    public:
+        /// <summary> Constructs a thread pool. </summary>
+        ///
+        /// <param name="numThreads"> The total number of threads to run loops on, including the calling thread. Zero means GetDefaultNumThreads(). </param>
+        explicit ThreadPool(size_t numThreads = 1);
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /// <summary> Stops and joins the worker threads. </summary>
+        ~ThreadPool();
+
+        /// <summary> Gets the number of threads that run loops, including the calling thread. </summary>
+        ///
+        /// <returns> The number of threads. </returns>
+        size_t NumThreads() const { return _workers.size() + 1; }
+
+        /// <summary>
+        /// Calls body(index) for each index in [0, count), spread over the pool, and returns when all calls are done.
+        /// Indices are handed out dynamically, so the order in which they run is unspecified; callers that need
+        /// deterministic results should write each result to its own slot and combine them in index order.
+        /// If a call throws, the remaining indices still run and the first exception is rethrown to the caller.
+        /// Calls made while the pool is already busy (e.g., from inside a body) run serially on the calling thread.
+        /// </summary>
+        ///
+        /// <param name="count"> The number of indices. </param>
+        /// <param name="body"> The function to call for each index. </param>
+        void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+    private:
+        struct Job;
+
+        void WorkerThread();
+        static void RunJob(Job& job);
+
+        std::vector<std::thread> _workers;
+        std::mutex _mutex;
+        std::condition_variable _jobAvailable;
+        std::condition_variable _jobFinished;
+        std::shared_ptr<Job> _job;
+        size_t _jobGeneration = 0;
+        bool _shutDown = false;
+        std::atomic<bool> _busy{ false }; // set while a loop is running on the workers
+    };
+} // namespace utilities
+} // namespace ell
@@ -0,0 +1,391 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryArchiver.cpp (utilities)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BinaryArchiver.h"
+#include "Archiver.h"
+#include "IArchivable.h"
+#include "Unused.h"
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+
+namespace ell
+{
+namespace utilities
+{
+    namespace
+    {
+        const char fileMagic[8] = { 'E', 'L', 'L', 'B', 'A', 'R', 'C', 'H' };
+        constexpr uint32_t fileFormatVersion = 1;
+        constexpr uint32_t byteOrderMarker = 0x01020304;
+
+        std::string GetRecordName(const char* name)
+        {
+            return name == nullptr ? std::string{} : std::string{ name };
+        }
+    } // namespace
+
+    //
+    // Serialization
+    //
+    BinaryArchiver::BinaryArchiver(std::ostream& outputStream) :
+        _out(outputStream)
+    {
+        WriteFileHeader();
+    }
+
+#define ARCHIVE_TYPE_OP(t) IMPLEMENT_ARCHIVE_VALUE(BinaryArchiver, t);
+    ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+    // strings
+    void BinaryArchiver::ArchiveValue(const char* name, const std::string& value)
+    {
+        WriteRecordHeader(BinaryArchiveRecordType::string, name);
+        WriteString(value);
+    }
+
+    void BinaryArchiver::ArchiveNull(const char* name)
+    {
+        WriteRecordHeader(BinaryArchiveRecordType::null, name);
+    }
+
+    // IArchivable
+    void BinaryArchiver::BeginArchiveObject(const char* name, const IArchivable& value)
+    {
+        if (value.ArchiveAsPrimitive())
+        {
+            // The object writes a single unnamed value, so this record just carries the name
+            WriteRecordHeader(BinaryArchiveRecordType::primitiveObject, name);
+            return;
+        }
+
+        WriteRecordHeader(BinaryArchiveRecordType::objectBegin, name);
+        WriteString(GetArchivedTypeName(value));
+        WriteRaw(static_cast<int32_t>(GetArchiveVersion(value).versionNumber));
+    }
+
+    void BinaryArchiver::EndArchiveObject(const char* name, const IArchivable& value)
+    {
+        if (!value.ArchiveAsPrimitive())
+        {
+            WriteRecordHeader(BinaryArchiveRecordType::objectEnd, name);
+        }
+    }
+
+    void BinaryArchiver::EndArchiving()
+    {
+        _out.flush();
+    }
+
+//
+// Arrays
+//
+#define ARCHIVE_TYPE_OP(t) IMPLEMENT_ARCHIVE_ARRAY(BinaryArchiver, t);
+    ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+    void BinaryArchiver::ArchiveArray(const char* name, const std::vector<std::string>& array)
+    {
+        WriteRecordHeader(BinaryArchiveRecordType::stringArray, name);
+        WriteRaw(static_cast<uint64_t>(array.size()));
+        for (const auto& item : array)
+        {
+            WriteString(item);
+        }
+    }
+
+    void BinaryArchiver::ArchiveArray(const char* name, const std::string& baseTypeName, const std::vector<const IArchivable*>& array)
+    {
+        WriteRecordHeader(BinaryArchiveRecordType::objectArrayBegin, name);
+        WriteString(baseTypeName);
+        for (const auto& item : array)
+        {
+            Archive(*item);
+        }
+        WriteRecordHeader(BinaryArchiveRecordType::objectArrayEnd, "");
+    }
+
+    void BinaryArchiver::WriteFileHeader()
+    {
+        WriteBytes(fileMagic, sizeof(fileMagic));
+        WriteRaw(fileFormatVersion);
+        WriteRaw(byteOrderMarker);
+    }
+
+    void BinaryArchiver::WriteRecordHeader(BinaryArchiveRecordType type, const char* name)
+    {
+        auto recordName = GetRecordName(name);
+        WriteRaw(type);
+        WriteRaw(static_cast<uint32_t>(recordName.size()));
+        WriteBytes(recordName.data(), recordName.size());
+    }
+
+    void BinaryArchiver::WriteString(const std::string& value)
+    {
+        WriteRaw(static_cast<uint64_t>(value.size()));
+        WriteBytes(value.data(), value.size());
+    }
+
+    void BinaryArchiver::WritePadding(size_t alignment)
+    {
+        static const char zeros[arrayAlignment] = {};
+        auto remainder = _position % alignment;
+        if (remainder != 0)
+        {
+            WriteBytes(zeros, alignment - remainder);
+        }
+    }
+
+    void BinaryArchiver::WriteBytes(const void* data, size_t size)
+    {
+        _out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        _position += size;
+    }
+
+    //
+    // Deserialization
+    //
+    BinaryUnarchiver::BinaryUnarchiver(std::istream& inputStream, SerializationContext context) :
+        Unarchiver(std::move(context)),
+        _buffer(std::istreambuf_iterator<char>(inputStream), std::istreambuf_iterator<char>())
+    {
+        _data = _buffer.data();
+        _size = _buffer.size();
+        ReadFileHeader();
+    }
+
+    BinaryUnarchiver::BinaryUnarchiver(const std::string& filepath, SerializationContext context) :
+        Unarchiver(std::move(context)),
+        _file(std::make_shared<MemoryMappedFile>(filepath))
+    {
+        _data = _file->GetData();
+        _size = _file->GetSize();
+        ReadFileHeader();
+    }
+
+#define ARCHIVE_TYPE_OP(t) IMPLEMENT_UNARCHIVE_VALUE(BinaryUnarchiver, t);
+    ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+    // strings
+    void BinaryUnarchiver::UnarchiveValue(const char* name, std::string& value)
+    {
+        MatchRecordHeader(BinaryArchiveRecordType::string, name);
+        value = ReadString();
+    }
+
+    bool BinaryUnarchiver::UnarchiveNull(const char* name)
+    {
+        std::string nextName;
+        if (PeekRecordHeader(nextName) == BinaryArchiveRecordType::null && nextName == GetRecordName(name))
+        {
+            MatchRecordHeader(BinaryArchiveRecordType::null, name);
+            return true;
+        }
+        return false;
+    }
+
+    bool BinaryUnarchiver::HasNextPropertyName(const std::string& name)
+    {
+        if (_position >= _size)
+        {
+            return false;
+        }
+
+        std::string nextName;
+        auto type = PeekRecordHeader(nextName);
+        return type != BinaryArchiveRecordType::objectEnd && type != BinaryArchiveRecordType::objectArrayEnd && nextName == name;
+    }
+
+    // IArchivable
+    ArchivedObjectInfo BinaryUnarchiver::BeginUnarchiveObject(const char* name, const std::string& typeName)
+    {
+        UNUSED(typeName);
+        MatchRecordHeader(BinaryArchiveRecordType::objectBegin, name);
+        auto encodedTypeName = ReadString();
+        if (encodedTypeName == "")
+        {
+            throw DataFormatException(DataFormatErrors::badFormat, "Binary archive is invalid, expecting a non empty object type name");
+        }
+        auto version = ReadRaw<int32_t>();
+        return { encodedTypeName, version };
+    }
+
+    void BinaryUnarchiver::UnarchiveObject(const char* name, IArchivable& value)
+    {
+        if (value.ArchiveAsPrimitive())
+        {
+            MatchRecordHeader(BinaryArchiveRecordType::primitiveObject, name);
+        }
+        Unarchiver::UnarchiveObject(name, value);
+    }
+
+    void BinaryUnarchiver::EndUnarchiveObject(const char* name, const std::string& typeName)
+    {
+        UNUSED(typeName);
+        MatchRecordHeader(BinaryArchiveRecordType::objectEnd, name);
+    }
+
+    void BinaryUnarchiver::UnarchiveObjectAsPrimitive(const char* name, IArchivable& value)
+    {
+        UnarchiveObject(name, value);
+    }
+
+//
+// Arrays
+//
+#define ARCHIVE_TYPE_OP(t) IMPLEMENT_UNARCHIVE_ARRAY(BinaryUnarchiver, t);
+    ARCHIVABLE_TYPES_LIST
+#undef ARCHIVE_TYPE_OP
+
+    void BinaryUnarchiver::UnarchiveArray(const char* name, std::vector<std::string>& array)
+    {
+        MatchRecordHeader(BinaryArchiveRecordType::stringArray, name);
+        auto count = ReadRaw<uint64_t>();
+        array.clear();
+        for (uint64_t index = 0; index < count; ++index)
+        {
+            array.push_back(ReadString());
+        }
+    }
+
+    void BinaryUnarchiver::BeginUnarchiveArray(const char* name, const std::string& typeName)
+    {
+        UNUSED(typeName);
+        MatchRecordHeader(BinaryArchiveRecordType::objectArrayBegin, name);
+        ReadString(); // base type name
+    }
+
+    bool BinaryUnarchiver::BeginUnarchiveArrayItem(const std::string& typeName)
+    {
+        UNUSED(typeName);
+        std::string nextName;
+        return PeekRecordHeader(nextName) != BinaryArchiveRecordType::objectArrayEnd;
+    }
+
+    void BinaryUnarchiver::EndUnarchiveArrayItem(const std::string& typeName)
+    {
+        UNUSED(typeName);
+    }
+
+    void BinaryUnarchiver::EndUnarchiveArray(const char* name, const std::string& typeName)
+    {
+        UNUSED(name, typeName);
+        MatchRecordHeader(BinaryArchiveRecordType::objectArrayEnd, "");
+    }
+
+    const char* BinaryUnarchiver::TryReadMappedArray(const char* name, BinaryArchiveValueKind kind, size_t size, size_t& count)
+    {
+        std::string nextName;
+        if (_file == nullptr || PeekRecordHeader(nextName) != BinaryArchiveRecordType::array)
+        {
+            return nullptr;
+        }
+
+        auto start = _position;
+        MatchRecordHeader(BinaryArchiveRecordType::array, name);
+        auto storedKind = ReadRaw<BinaryArchiveValueKind>();
+        auto storedSize = ReadRaw<uint8_t>();
+        auto storedCount = ReadRaw<uint64_t>();
+        if (storedKind != kind || storedSize != size)
+        {
+            _position = start;
+            return nullptr;
+        }
+
+        // the mapping is page-aligned and the array data is aligned within the file, so the values are aligned in memory
+        SkipPadding(BinaryArchiver::arrayAlignment);
+        count = static_cast<size_t>(storedCount);
+        return ReadBytes(count * size);
+    }
+
+    void BinaryUnarchiver::ReadFileHeader()
+    {
+        auto magic = ReadBytes(sizeof(fileMagic));
+        if (!std::equal(magic, magic + sizeof(fileMagic), std::begin(fileMagic)))
+        {
+            throw DataFormatException(DataFormatErrors::badFormat, "Not a binary archive");
+        }
+
+        auto version = ReadRaw<uint32_t>();
+        if (version != fileFormatVersion)
+        {
+            throw DataFormatException(DataFormatErrors::badFormat, "Unsupported binary archive version " + std::to_string(version));
+        }
+
+        auto marker = ReadRaw<uint32_t>();
+        if (marker != byteOrderMarker)
+        {
+            throw DataFormatException(DataFormatErrors::badFormat, "Binary archive was written with a different byte order");
+        }
+    }
+
+    BinaryArchiveRecordType BinaryUnarchiver::PeekRecordHeader(std::string& name) const
+    {
+        constexpr size_t headerSize = sizeof(BinaryArchiveRecordType) + sizeof(uint32_t);
+        if (_position + headerSize > _size)
+        {
+            throw DataFormatException(DataFormatErrors::abruptEnd, "Unexpected end of binary archive");
+        }
+
+        auto type = BinaryArchiverImpl::Load<BinaryArchiveRecordType>(_data + _position);
+        auto nameLength = BinaryArchiverImpl::Load<uint32_t>(_data + _position + sizeof(BinaryArchiveRecordType));
+        if (_position + headerSize + nameLength > _size)
+        {
+            throw DataFormatException(DataFormatErrors::abruptEnd, "Unexpected end of binary archive");
+        }
+        name.assign(_data + _position + headerSize, nameLength);
+        return type;
+    }
+
+    void BinaryUnarchiver::MatchRecordHeader(BinaryArchiveRecordType type, const char* name)
+    {
+        std::string nextName;
+        auto nextType = PeekRecordHeader(nextName);
+        if (nextType != type)
+        {
+            throw DataFormatException(DataFormatErrors::badFormat, "Binary archive has an unexpected record type for '" + nextName + "'");
+        }
+
+        auto expectedName = GetRecordName(name);
+        if (expectedName != "" && nextName != expectedName)
+        {
+            throw DataFormatException(DataFormatErrors::badFormat, "Binary archive is missing expected field '" + expectedName + "', found '" + nextName + "' instead");
+        }
+        _position += sizeof(BinaryArchiveRecordType) + sizeof(uint32_t) + nextName.size();
+    }
+
+    std::string BinaryUnarchiver::ReadString()
+    {
+        auto length = ReadRaw<uint64_t>();
+        auto data = ReadBytes(length);
+        return { data, static_cast<size_t>(length) };
+    }
+
+    void BinaryUnarchiver::SkipPadding(size_t alignment)
+    {
+        auto remainder = _position % alignment;
+        if (remainder != 0)
+        {
+            ReadBytes(alignment - remainder);
+        }
+    }
+
+    const char* BinaryUnarchiver::ReadBytes(size_t size)
+    {
+        if (size > _size - _position)
+        {
+            throw DataFormatException(DataFormatErrors::abruptEnd, "Unexpected end of binary archive");
+        }
+        auto data = _data + _position;
+        _position += size;
+        return data;
+    }
+} // namespace utilities
+} // namespace ell
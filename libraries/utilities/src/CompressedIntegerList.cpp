@@ -44,6 +44,34 @@ namespace utilities
         _value += delta;
     }
 
+    size_t CompressedIntegerList::Iterator::GetBlock(size_t* buffer, size_t maxCount)
+    {
+        size_t count = 0;
+        while (count < maxCount && IsValid())
+        {
+            buffer[count++] = _value;
+            _iter += _iter_increment;
+            if (_iter >= _end)
+            {
+                return count;
+            }
+
+            // most deltas fit in a single byte; leave the rest to Next
+            uint8_t first_val = *_iter;
+            if ((first_val & 0xc0) == 0)
+            {
+                _value += first_val;
+                _iter_increment = 1;
+            }
+            else
+            {
+                _iter_increment = 0;
+                Next();
+            }
+        }
+        return count;
+    }
+
     CompressedIntegerList::Iterator::Iterator(const uint8_t* iter, const uint8_t* end) :
         _iter(iter),
         _end(end),
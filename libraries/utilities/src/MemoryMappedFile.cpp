@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MemoryMappedFile.cpp (utilities)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MemoryMappedFile.h"
+#include "Exception.h"
+#include "Files.h"
+
+#include <utility>
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <filesystem>
+#endif // WIN32
+
+namespace ell
+{
+namespace utilities
+{
+    MemoryMappedFile::MemoryMappedFile(const std::string& filepath)
+    {
+        if (!FileExists(filepath))
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "file " + filepath + " doesn't exist");
+        }
+
+#ifdef WIN32
+        auto path = std::filesystem::u8path(filepath);
+        auto fileHandle = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "error opening file " + filepath);
+        }
+        _fileHandle = fileHandle;
+
+        LARGE_INTEGER fileSize;
+        if (!::GetFileSizeEx(fileHandle, &fileSize))
+        {
+            Unmap();
+            throw InputException(InputExceptionErrors::invalidArgument, "error reading the size of file " + filepath);
+        }
+        _size = static_cast<size_t>(fileSize.QuadPart);
+        if (_size == 0)
+        {
+            return;
+        }
+
+        _mappingHandle = ::CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (_mappingHandle == nullptr)
+        {
+            Unmap();
+            throw InputException(InputExceptionErrors::invalidArgument, "error mapping file " + filepath);
+        }
+
+        _data = static_cast<const char*>(::MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        if (_data == nullptr)
+        {
+            Unmap();
+            throw InputException(InputExceptionErrors::invalidArgument, "error mapping file " + filepath);
+        }
+#else
+        int fileDescriptor = ::open(filepath.c_str(), O_RDONLY);
+        if (fileDescriptor < 0)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "error opening file " + filepath);
+        }
+
+        struct stat fileStatus;
+        if (::fstat(fileDescriptor, &fileStatus) != 0)
+        {
+            ::close(fileDescriptor);
+            throw InputException(InputExceptionErrors::invalidArgument, "error reading the size of file " + filepath);
+        }
+
+        _size = static_cast<size_t>(fileStatus.st_size);
+        if (_size > 0)
+        {
+            void* data = ::mmap(nullptr, _size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+            if (data == MAP_FAILED)
+            {
+                ::close(fileDescriptor);
+                throw InputException(InputExceptionErrors::invalidArgument, "error mapping file " + filepath);
+            }
+            _data = static_cast<const char*>(data);
+        }
+
+        // the mapping stays valid after the descriptor is closed
+        ::close(fileDescriptor);
+#endif // WIN32
+    }
+
+    MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Unmap();
+            std::swap(_data, other._data);
+            std::swap(_size, other._size);
+#ifdef WIN32
+            std::swap(_fileHandle, other._fileHandle);
+            std::swap(_mappingHandle, other._mappingHandle);
+#endif
+        }
+        return *this;
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        Unmap();
+    }
+
+    void MemoryMappedFile::Unmap()
+    {
+#ifdef WIN32
+        if (_data != nullptr)
+        {
+            ::UnmapViewOfFile(_data);
+        }
+        if (_mappingHandle != nullptr)
+        {
+            ::CloseHandle(_mappingHandle);
+        }
+        if (_fileHandle != nullptr)
+        {
+            ::CloseHandle(_fileHandle);
+        }
+        _fileHandle = nullptr;
+        _mappingHandle = nullptr;
+#else
+        if (_data != nullptr)
+        {
+            ::munmap(const_cast<char*>(_data), _size);
+        }
+#endif // WIN32
+        _data = nullptr;
+        _size = 0;
+    }
+} // namespace utilities
+} // namespace ell
@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ThreadPool.cpp (utilities)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <exception>
+
+namespace ell
+{
+namespace utilities
+{
+    size_t GetDefaultNumThreads()
+    {
+        auto numThreads = std::thread::hardware_concurrency();
+        return numThreads == 0 ? 1 : numThreads;
+    }
+
+    // One call to ParallelFor. Workers that wake up late may still hold a reference after ParallelFor has
+    // returned, but by then every index has been claimed, so they never touch the (now dead) body.
+    struct ThreadPool::Job
+    {
+        Job(size_t count, const std::function<void(size_t)>& body) :
+            count(count),
+            body(&body) {}
+
+        const size_t count;
+        const std::function<void(size_t)>* body;
+        std::atomic<size_t> nextIndex{ 0 };
+        std::atomic<size_t> numFinished{ 0 };
+        std::mutex errorMutex;
+        std::exception_ptr error;
+    };
+
+    ThreadPool::ThreadPool(size_t numThreads)
+    {
+        if (numThreads == 0)
+        {
+            numThreads = GetDefaultNumThreads();
+        }
+
+        for (size_t index = 1; index < numThreads; ++index)
+        {
+            _workers.emplace_back(&ThreadPool::WorkerThread, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _shutDown = true;
+        }
+        _jobAvailable.notify_all();
+        for (auto& worker : _workers)
+        {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& body)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        // run inline if there's nothing to parallelize, or if the pool is already running a loop
+        // (e.g., this is a nested call from inside a body, possibly on the thread that started the outer loop)
+        bool wasBusy = false;
+        if (_workers.empty() || count == 1 || !_busy.compare_exchange_strong(wasBusy, true))
+        {
+            for (size_t index = 0; index < count; ++index)
+            {
+                body(index);
+            }
+            return;
+        }
+
+        struct BusyGuard
+        {
+            ~BusyGuard() { busy = false; }
+            std::atomic<bool>& busy;
+        } busyGuard{ _busy };
+
+        auto job = std::make_shared<Job>(count, body);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _job = job;
+            ++_jobGeneration;
+        }
+        _jobAvailable.notify_all();
+
+        RunJob(*job);
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _jobFinished.wait(lock, [&job] { return job->numFinished == job->count; });
+            _job.reset();
+        }
+
+        if (job->error)
+        {
+            std::rethrow_exception(job->error);
+        }
+    }
+
+    void ThreadPool::WorkerThread()
+    {
+        size_t seenGeneration = 0;
+        while (true)
+        {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _jobAvailable.wait(lock, [this, seenGeneration] { return _shutDown || (_job && _jobGeneration != seenGeneration); });
+                if (_shutDown)
+                {
+                    return;
+                }
+                job = _job;
+                seenGeneration = _jobGeneration;
+            }
+
+            RunJob(*job);
+            if (job->numFinished == job->count)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _jobFinished.notify_all();
+            }
+        }
+    }
+
+    void ThreadPool::RunJob(Job& job)
+    {
+        while (true)
+        {
+            auto index = job.nextIndex++;
+            if (index >= job.count)
+            {
+                return;
+            }
+
+            try
+            {
+                (*job.body)(index);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(job.errorMutex);
+                if (!job.error)
+                {
+                    job.error = std::current_exception();
+                }
+            }
+            ++job.numFinished;
+        }
+    }
+} // namespace utilities
+} // namespace ell
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <string>
+
 namespace ell
 {
 void TestArchivedObjectInfo();
@@ -18,4 +20,8 @@ void TestJsonUnarchiver();
 
 void TestXmlArchiver();
 void TestXmlUnarchiver();
+
+void TestBinaryArchiver();
+void TestBinaryUnarchiver();
+void TestBinaryUnarchiverMappedFile(const std::string& basePath);
 } // namespace ell
@@ -11,4 +11,5 @@
 namespace ell
 {
     void TestRingBuffer();
+    void TestConcurrentRingBuffer();
 }
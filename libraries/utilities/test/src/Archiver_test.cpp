@@ -9,13 +9,18 @@
 #include "Archiver_test.h"
 
 #include <utilities/include/Archiver.h>
+#include <utilities/include/BinaryArchiver.h>
+#include <utilities/include/Files.h>
 #include <utilities/include/IArchivable.h>
 #include <utilities/include/JsonArchiver.h>
+#include <utilities/include/MemoryMappedFile.h>
 #include <utilities/include/UniqueId.h>
 #include <utilities/include/XmlArchiver.h>
 
 #include <testing/include/testing.h>
 
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <sstream>
@@ -370,4 +375,123 @@ void TestXmlUnarchiver()
 {
     TestUnarchiver<utilities::XmlArchiver, utilities::XmlUnarchiver>();
 }
+
+void TestBinaryArchiver()
+{
+    TestArchiver<utilities::BinaryArchiver>();
+}
+
+void TestBinaryUnarchiver()
+{
+    TestUnarchiver<utilities::BinaryArchiver, utilities::BinaryUnarchiver>();
+
+    utilities::SerializationContext context;
+    {
+        // values and arrays can be read back as a different fundamental type
+        std::stringstream strstream;
+        {
+            utilities::BinaryArchiver archiver(strstream);
+            archiver.Archive("x", 7);
+            archiver.Archive("arr", std::vector<float>{ 1.5f, -2.0f, 4.25f });
+            archiver.Archive("bools", std::vector<bool>{ true, false, true });
+        }
+
+        utilities::BinaryUnarchiver unarchiver(strstream, context);
+        double x = 0;
+        std::vector<double> arr;
+        std::vector<bool> bools;
+        unarchiver.Unarchive("x", x);
+        unarchiver.Unarchive("arr", arr);
+        unarchiver.Unarchive("bools", bools);
+        testing::ProcessTest("BinaryUnarchiver converts scalar types", x == 7.0);
+        testing::ProcessTest("BinaryUnarchiver converts array types", testing::IsEqual(arr, std::vector<double>{ 1.5, -2.0, 4.25 }));
+        testing::ProcessTest("BinaryUnarchiver reads vector<bool>", bools == std::vector<bool>{ true, false, true });
+    }
+
+    {
+        // primitive objects, null pointers, and a truncated archive
+        std::stringstream strstream;
+        utilities::UniqueId id;
+        {
+            utilities::BinaryArchiver archiver(strstream);
+            archiver.Archive("id", id);
+            archiver.Archive("s", OptionalValueStruct(3, 4));
+        }
+        auto archive = strstream.str();
+
+        std::stringstream instream(archive);
+        utilities::BinaryUnarchiver unarchiver(instream, context);
+        utilities::UniqueId newId;
+        OptionalValueStruct val;
+        unarchiver.Unarchive("id", newId);
+        unarchiver.Unarchive("s", val);
+        testing::ProcessTest("BinaryUnarchiver reads primitive objects", newId == id);
+        testing::ProcessTest("BinaryUnarchiver reads null pointers", val._a == 3 && val._b == 4 && val._x.get() == nullptr);
+
+        bool threw = false;
+        try
+        {
+            std::stringstream truncated(archive.substr(0, archive.size() - 4));
+            utilities::BinaryUnarchiver truncatedUnarchiver(truncated, context);
+            truncatedUnarchiver.Unarchive("id", newId);
+            truncatedUnarchiver.Unarchive("s", val);
+        }
+        catch (const utilities::DataFormatException&)
+        {
+            threw = true;
+        }
+        testing::ProcessTest("BinaryUnarchiver detects truncated archives", threw);
+    }
+}
+
+void TestBinaryUnarchiverMappedFile(const std::string& basePath)
+{
+    auto filepath = utilities::JoinPaths(basePath, "binary_archive_test.ellb");
+    std::vector<double> weights(1000);
+    for (size_t index = 0; index < weights.size(); ++index)
+    {
+        weights[index] = 0.5 * static_cast<double>(index);
+    }
+
+    {
+        auto stream = utilities::OpenBinaryOfstream(filepath);
+        utilities::BinaryArchiver archiver(stream);
+        archiver.Archive("name", std::string{ "weights" });
+        archiver.Archive("weights", weights);
+    }
+
+    // array data starts on an aligned boundary in the file, and so in the mapping
+    utilities::MemoryMappedFile file(filepath);
+    auto payloadSize = weights.size() * sizeof(double);
+    auto payloadOffset = file.GetSize() - payloadSize;
+    testing::ProcessTest("BinaryArchiver aligns array data", payloadOffset % utilities::BinaryArchiver::arrayAlignment == 0);
+    testing::ProcessTest("BinaryArchiver writes raw array data", std::memcmp(file.GetData() + payloadOffset, weights.data(), payloadSize) == 0);
+
+    utilities::SerializationContext context;
+    utilities::BinaryUnarchiver unarchiver(filepath, context);
+    std::string name;
+    std::vector<double> newWeights;
+    unarchiver.Unarchive("name", name);
+    unarchiver.Unarchive("weights", newWeights);
+    testing::ProcessTest("BinaryUnarchiver reads memory-mapped file", name == "weights" && newWeights == weights);
+
+    // arrays stored with the requested type can be read in place, and keep the mapping alive
+    utilities::MappedArray<double> mappedWeights;
+    utilities::MappedArray<float> mappedFloatWeights;
+    {
+        utilities::BinaryUnarchiver mappedUnarchiver(filepath, context);
+        mappedUnarchiver.Unarchive("name", name);
+        auto readFloats = mappedUnarchiver.TryUnarchiveMappedArray("weights", mappedFloatWeights);
+        auto readDoubles = mappedUnarchiver.TryUnarchiveMappedArray("weights", mappedWeights);
+        testing::ProcessTest("BinaryUnarchiver doesn't map arrays of a different type", !readFloats && !mappedFloatWeights.IsMapped());
+        testing::ProcessTest("BinaryUnarchiver maps arrays in place", readDoubles && mappedWeights.IsMapped() && reinterpret_cast<uintptr_t>(mappedWeights.GetData()) % utilities::BinaryArchiver::arrayAlignment == 0);
+    }
+    testing::ProcessTest("MappedArray outlives its unarchiver", mappedWeights.ToArray() == weights);
+
+    // an archive read from a stream has no mapping to refer to
+    auto instream = utilities::OpenBinaryIfstream(filepath);
+    utilities::BinaryUnarchiver streamUnarchiver(instream, context);
+    streamUnarchiver.Unarchive("name", name);
+    testing::ProcessTest("BinaryUnarchiver doesn't map arrays read from a stream", !streamUnarchiver.TryUnarchiveMappedArray("weights", mappedWeights));
+}
 } // namespace ell
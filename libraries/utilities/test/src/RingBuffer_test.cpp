@@ -13,6 +13,7 @@
 
 #include <testing/include/testing.h>
 
+#include <thread>
 
 namespace ell
 {
@@ -51,4 +52,56 @@ namespace ell
         testing::ProcessTest("TestRingBuffer is empty", testing::IsEqual(ToArray(buffer), std::vector<float>({ 6, 5, 4, 3, 2 })));
 
     }
+
+    void TestConcurrentRingBuffer()
+    {
+        ConcurrentRingBuffer<int> buffer(3);
+        int value = 0;
+        testing::ProcessTest("TestConcurrentRingBuffer starts empty", buffer.Size() == 0 && !buffer.TryPop(value));
+
+        bool ok = true;
+        for (int i = 1; i <= 3; ++i)
+        {
+            value = i;
+            ok = ok && buffer.TryPush(value);
+        }
+        value = 4;
+        ok = ok && !buffer.TryPush(value) && buffer.Size() == 3;
+        testing::ProcessTest("TestConcurrentRingBuffer fills to capacity", ok);
+
+        std::vector<int> popped;
+        while (buffer.TryPop(value))
+        {
+            popped.push_back(value);
+        }
+        testing::ProcessTest("TestConcurrentRingBuffer pops in order", testing::IsEqual(popped, std::vector<int>({ 1, 2, 3 })));
+
+        // One producer and one consumer thread
+        const int numItems = 100000;
+        ConcurrentRingBuffer<std::vector<int>> queue(4);
+        std::thread producer([&queue]() {
+            std::vector<int> item;
+            for (int i = 0; i < numItems; ++i)
+            {
+                item.assign(1, i);
+                while (!queue.TryPush(item))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        bool inOrder = true;
+        std::vector<int> item;
+        for (int i = 0; i < numItems; ++i)
+        {
+            while (!queue.TryPop(item))
+            {
+                std::this_thread::yield();
+            }
+            inOrder = inOrder && item.size() == 1 && item[0] == i;
+        }
+        producer.join();
+        testing::ProcessTest("TestConcurrentRingBuffer between threads", inOrder && queue.Size() == 0);
+    }
 } // namespace ell
@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ThreadPool_test.cpp (utilities)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ThreadPool_test.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <testing/include/testing.h>
+
+#include <numeric>
+#include <vector>
+
+namespace ell
+{
+using namespace utilities;
+
+void TestThreadPoolParallelFor()
+{
+    for (size_t numThreads : { 1, 2, 4, 7 })
+    {
+        ThreadPool pool(numThreads);
+        bool ok = pool.NumThreads() == numThreads;
+        for (size_t count : { 0, 1, 5, 1000 })
+        {
+            // run several loops on the same pool, to exercise waking up the workers more than once
+            for (int repeat = 0; repeat < 3; ++repeat)
+            {
+                std::vector<int> visits(count, 0);
+                pool.ParallelFor(count, [&visits](size_t index) { visits[index] += static_cast<int>(index) + 1; });
+
+                std::vector<int> expected(count);
+                std::iota(expected.begin(), expected.end(), 1);
+                ok = ok && visits == expected;
+            }
+        }
+        testing::ProcessTest("ThreadPool::ParallelFor with " + std::to_string(numThreads) + " threads", ok);
+    }
+}
+
+void TestThreadPoolNested()
+{
+    ThreadPool pool(4);
+    std::vector<std::vector<int>> results(8, std::vector<int>(16, 0));
+    pool.ParallelFor(results.size(), [&pool, &results](size_t outer) {
+        pool.ParallelFor(results[outer].size(), [&results, outer](size_t inner) { results[outer][inner] = static_cast<int>(outer * inner); });
+    });
+
+    bool ok = true;
+    for (size_t outer = 0; outer < results.size(); ++outer)
+    {
+        for (size_t inner = 0; inner < results[outer].size(); ++inner)
+        {
+            ok = ok && results[outer][inner] == static_cast<int>(outer * inner);
+        }
+    }
+    testing::ProcessTest("ThreadPool::ParallelFor nested", ok);
+}
+
+void TestThreadPoolException()
+{
+    ThreadPool pool(4);
+    std::vector<int> visits(100, 0);
+    bool threw = false;
+    try
+    {
+        pool.ParallelFor(visits.size(), [&visits](size_t index) {
+            visits[index] = 1;
+            if (index == 17)
+            {
+                throw InputException(InputExceptionErrors::badData, "test");
+            }
+        });
+    }
+    catch (const InputException&)
+    {
+        threw = true;
+    }
+    testing::ProcessTest("ThreadPool::ParallelFor rethrows exceptions", threw && std::accumulate(visits.begin(), visits.end(), 0) == 100);
+
+    // the pool is still usable afterwards
+    int sum = 0;
+    pool.ParallelFor(1, [&sum](size_t) { sum = 1; });
+    testing::ProcessTest("ThreadPool usable after exception", sum == 1);
+}
+} // namespace ell
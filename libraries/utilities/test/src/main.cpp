@@ -16,6 +16,7 @@
 #include "ObjectArchive_test.h"
 #include "PropertyBag_test.h"
 #include "RingBuffer_test.h"
+#include "ThreadPool_test.h"
 #include "TunableParameters_test.h"
 #include "TypeFactory_test.h"
 #include "TypeName_test.h"
@@ -45,6 +46,12 @@ int main(int argc, char* argv[])
         std::string basePath = ell::utilities::GetDirectoryPath(argv[0]);
 
         TestRingBuffer();
+        TestConcurrentRingBuffer();
+
+        // ThreadPool tests
+        TestThreadPoolParallelFor();
+        TestThreadPoolNested();
+        TestThreadPoolException();
 
         // Format tests
         TestMatchFormat();
@@ -92,6 +99,10 @@ int main(int argc, char* argv[])
         TestXmlArchiver();
         TestXmlUnarchiver();
 
+        TestBinaryArchiver();
+        TestBinaryUnarchiver();
+        TestBinaryUnarchiverMappedFile(basePath);
+
         // ObjectArchive tests
         TestGetTypeDescription();
         TestGetObjectArchive();
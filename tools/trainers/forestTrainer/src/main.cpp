@@ -73,20 +73,27 @@ int main(int argc, char* argv[])
 
         // load dataset
         if (trainerArguments.verbose) std::cout << "Loading data ..." << std::endl;
-        auto stream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
-        auto parsedDataset = common::GetDataset(stream);
-        auto mappedDataset = common::TransformDataset(parsedDataset, map);
+        common::FileDataset inputDataset(dataLoadArguments.inputDataFilename, dataLoadArguments.numParsingThreads);
+
+        // without a map file the map is the identity, so if it covers every feature the trainer reads the loaded examples in place
+        data::AutoSupervisedDataset mappedDataset;
+        auto trainingDataset = inputDataset.GetAnyDataset();
+        if (mapLoadArguments.HasInputFilename() || inputDataset.NumFeatures() > map.GetInputSize())
+        {
+            mappedDataset = common::TransformDataset(trainingDataset, map);
+            trainingDataset = mappedDataset.GetAnyDataset();
+        }
 
         // predictor type
         using PredictorType = predictors::SimpleForestPredictor;
 
         // create trainer and evaluator
         auto trainer = common::MakeForestTrainer(trainerArguments.lossFunctionArguments, forestTrainerArguments);
-        auto evaluator = common::MakeEvaluator<PredictorType>(mappedDataset.GetAnyDataset(), evaluatorArguments, trainerArguments.lossFunctionArguments);
+        auto evaluator = common::MakeEvaluator<PredictorType>(trainingDataset, evaluatorArguments, trainerArguments.lossFunctionArguments);
 
         // train
         if (trainerArguments.verbose) std::cout << "Training ..." << std::endl;
-        trainer->SetDataset(mappedDataset.GetAnyDataset());
+        trainer->SetDataset(trainingDataset);
 
         for (size_t epoch = 0; epoch < trainerArguments.numEpochs; ++epoch)
         {
@@ -19,6 +19,7 @@ struct LinearTrainerArguments
         SGD,
         SparseDataSGD,
         SparseDataCenteredSGD,
+        HogwildSGD,
         SDCA
     };
 
@@ -29,6 +30,8 @@ struct LinearTrainerArguments
     size_t maxEpochs;
     bool permute;
     std::string randomSeedString;
+    size_t batchSize;
+    size_t numThreads;
 };
 
 /// <summary> Parsed version of LinearTrainerArguments. </summary>
@@ -17,7 +17,7 @@ void ParsedLinearTrainerArguments::AddArgs(utilities::CommandLineParser& parser)
         "algorithm",
         "a",
         "Choice of linear training algorithm",
-        { { "SGD", Algorithm::SGD }, { "SparseDataSGD", Algorithm::SparseDataSGD }, { "SparseDataCenteredSGD", Algorithm::SparseDataCenteredSGD }, { "SDCA", Algorithm::SDCA } },
+        { { "SGD", Algorithm::SGD }, { "SparseDataSGD", Algorithm::SparseDataSGD }, { "SparseDataCenteredSGD", Algorithm::SparseDataCenteredSGD }, { "HogwildSGD", Algorithm::HogwildSGD }, { "SDCA", Algorithm::SDCA } },
         "SDCA");
 
     parser.AddOption(normalize,
@@ -55,5 +55,17 @@ void ParsedLinearTrainerArguments::AddArgs(utilities::CommandLineParser& parser)
                      "seed",
                      "The random seed string",
                      "ABCDEFG");
+
+    parser.AddOption(batchSize,
+                     "batchSize",
+                     "bs",
+                     "The number of examples whose dual variables SDCA updates together (1 = sequential SDCA)",
+                     1);
+
+    parser.AddOption(numThreads,
+                     "numThreads",
+                     "nt",
+                     "The number of threads used by HogwildSGD and by SDCA with batchSize > 1 (0 = one per hardware thread)",
+                     1);
 }
 } // namespace ell
@@ -110,9 +110,16 @@ int main(int argc, char* argv[])
 
         // load dataset
         if (trainerArguments.verbose) std::cout << "Loading data ..." << std::endl;
-        auto stream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
-        auto parsedDataset = common::GetDataset(stream);
-        auto mappedDataset = common::TransformDataset(parsedDataset, map);
+        common::FileDataset inputDataset(dataLoadArguments.inputDataFilename, dataLoadArguments.numParsingThreads);
+
+        // without a map file the map is the identity, so if it covers every feature the trainer reads the loaded examples in place
+        data::AutoSupervisedDataset mappedDataset;
+        auto trainingDataset = inputDataset.GetAnyDataset();
+        if (mapLoadArguments.HasInputFilename() || inputDataset.NumFeatures() > map.GetInputSize())
+        {
+            mappedDataset = common::TransformDataset(trainingDataset, map);
+            trainingDataset = mappedDataset.GetAnyDataset();
+        }
         auto mappedDatasetDimension = map.GetOutput(0).Size();
 
         // normalize data
@@ -121,7 +128,7 @@ int main(int argc, char* argv[])
             if (trainerArguments.verbose) std::cout << "Sparisty-preserving data normalization ..." << std::endl;
 
             // find inverse absolute mean
-            auto scaleVector = trainers::CalculateSparseTransformedMean(mappedDataset.GetAnyDataset(), [](data::IndexValue x) { return std::abs(x.value); });
+            auto scaleVector = trainers::CalculateSparseTransformedMean(trainingDataset, [](data::IndexValue x) { return std::abs(x.value); });
             scaleVector.Transform([](double x) { return x > 0.0 ? 1.0 / x : 0.0; });
 
             // create normalizer
@@ -129,9 +136,10 @@ int main(int argc, char* argv[])
             auto normalizer = predictors::MakeTransformationNormalizer<data::IterationPolicy::skipZeros>(coordinateTransformation);
 
             // apply normalizer to data
-            auto normalizedDataset = common::TransformDataset(mappedDataset, normalizer);
+            auto normalizedDataset = common::TransformDataset(trainingDataset, normalizer);
 
             mappedDataset.Swap(normalizedDataset);
+            trainingDataset = mappedDataset.GetAnyDataset();
         }
 
         // predictor type
@@ -149,13 +157,16 @@ int main(int argc, char* argv[])
             break;
         case LinearTrainerArguments::Algorithm::SparseDataCenteredSGD:
         {
-            auto mean = trainers::CalculateMean(mappedDataset.GetAnyDataset());
+            auto mean = trainers::CalculateMean(trainingDataset);
             trainer = common::MakeSparseDataCenteredSGDTrainer(trainerArguments.lossFunctionArguments, mean, { linearTrainerArguments.regularization, linearTrainerArguments.randomSeedString });
             break;
         }
+        case LinearTrainerArguments::Algorithm::HogwildSGD:
+            trainer = common::MakeHogwildSGDTrainer(trainerArguments.lossFunctionArguments, { { linearTrainerArguments.regularization, linearTrainerArguments.randomSeedString }, linearTrainerArguments.numThreads });
+            break;
         case LinearTrainerArguments::Algorithm::SDCA:
         {
-            trainer = common::MakeSDCATrainer(trainerArguments.lossFunctionArguments, { linearTrainerArguments.regularization, linearTrainerArguments.desiredPrecision, linearTrainerArguments.maxEpochs, linearTrainerArguments.permute, linearTrainerArguments.randomSeedString });
+            trainer = common::MakeSDCATrainer(trainerArguments.lossFunctionArguments, { linearTrainerArguments.regularization, linearTrainerArguments.desiredPrecision, linearTrainerArguments.maxEpochs, linearTrainerArguments.permute, linearTrainerArguments.randomSeedString, linearTrainerArguments.batchSize, linearTrainerArguments.numThreads });
             break;
         }
         default:
@@ -163,11 +174,11 @@ int main(int argc, char* argv[])
         }
 
         // create an evaluator
-        auto evaluator = common::MakeEvaluator<PredictorType>(mappedDataset.GetAnyDataset(), evaluatorArguments, trainerArguments.lossFunctionArguments);
+        auto evaluator = common::MakeEvaluator<PredictorType>(trainingDataset, evaluatorArguments, trainerArguments.lossFunctionArguments);
 
         // Train the predictor
         if (trainerArguments.verbose) std::cout << "Training ..." << std::endl;
-        trainer->SetDataset(mappedDataset.GetAnyDataset());
+        trainer->SetDataset(trainingDataset);
 
         for (size_t epoch = 0; epoch < trainerArguments.numEpochs; ++epoch)
         {
@@ -103,9 +103,16 @@ int main(int argc, char* argv[])
 
         mapLoadArguments.defaultInputSize = dataLoadArguments.parsedDataDimension;
         auto map = common::LoadMap(mapLoadArguments);
-        auto stream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
-        auto parsedDataset = common::GetDataset(stream);
-        auto mappedDataset = common::TransformDataset(parsedDataset, map);
+        common::FileDataset inputDataset(dataLoadArguments.inputDataFilename, dataLoadArguments.numParsingThreads);
+
+        // without a map file the map is the identity, so if it covers every feature the trainer reads the loaded examples in place
+        data::AutoSupervisedDataset mappedDataset;
+        auto trainingDataset = inputDataset.GetAnyDataset(0, inputDataset.NumExamples());
+        if (mapLoadArguments.HasInputFilename() || inputDataset.NumFeatures() > map.GetInputSize())
+        {
+            mappedDataset = common::TransformDataset(trainingDataset, map);
+            trainingDataset = mappedDataset.GetAnyDataset(0, mappedDataset.NumExamples());
+        }
 
         // The problem is NumFeatures returns a random number from sparse dataset depending on the number of trailing zeros it
         // has skipped.Is if the user did NOT specify - dd auto and instead provided a real input size like - dd 784 then we use
@@ -118,7 +125,7 @@ int main(int argc, char* argv[])
 
         // Train the predictor
         if (protoNNTrainerArguments.verbose) std::cout << "Training ..." << std::endl;
-        trainer->SetDataset(mappedDataset.GetAnyDataset(0, mappedDataset.NumExamples()));
+        trainer->SetDataset(trainingDataset);
 
         for (size_t i = 0; i < protoNNTrainerArguments.numIterations; i++)
             trainer->Update();
@@ -134,7 +141,7 @@ int main(int argc, char* argv[])
             {
                 auto accuracy = 0.0;
                 auto truePositive = 0.0;
-                auto exampleIterator = mappedDataset.GetExampleIterator();
+                auto exampleIterator = trainingDataset.GetExampleIterator<data::AutoSupervisedExample>();
                 while (exampleIterator.IsValid())
                 {
                     // get the Next example
@@ -158,7 +165,7 @@ int main(int argc, char* argv[])
                     test_index++;
                 }
 
-                accuracy = 100 * (truePositive / mappedDataset.NumExamples());
+                accuracy = 100 * (truePositive / trainingDataset.NumExamples());
                 std::cout << "Training Accuracy: " << accuracy << " %" << std::endl;
             }
 
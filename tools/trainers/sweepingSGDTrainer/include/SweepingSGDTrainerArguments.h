@@ -0,0 +1,37 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SweepingSGDTrainerArguments.h (sweepingSGDTrainer)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <utilities/include/CommandLineParser.h>
+
+namespace ell
+{
+struct SweepingSGDTrainerArguments
+{
+    enum class Algorithm
+    {
+        SGD,
+        HogwildSGD
+    };
+
+    Algorithm algorithm = Algorithm::SGD;
+    size_t numThreads;
+    size_t numSweepThreads;
+    double keepFraction;
+};
+
+/// <summary> Parsed version of SweepingSGDTrainerArguments. </summary>
+struct ParsedSweepingSGDTrainerArguments : public SweepingSGDTrainerArguments
+    , public utilities::ParsedArgSet
+{
+    /// <summary> Adds the arguments to the command line parser. </summary>
+    ///
+    /// <param name="parser"> [in,out] The command line parser. </param>
+    void AddArgs(utilities::CommandLineParser& parser) override;
+};
+} // namespace ell
@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SweepingSGDTrainerArguments.cpp (sweepingSGDTrainer)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SweepingSGDTrainerArguments.h"
+
+namespace ell
+{
+void ParsedSweepingSGDTrainerArguments::AddArgs(utilities::CommandLineParser& parser)
+{
+    parser.AddOption(
+        algorithm,
+        "algorithm",
+        "a",
+        "Choice of SGD algorithm",
+        { { "SGD", Algorithm::SGD }, { "HogwildSGD", Algorithm::HogwildSGD } },
+        "SGD");
+
+    parser.AddOption(numThreads,
+                     "numThreads",
+                     "nt",
+                     "The number of threads used by each HogwildSGD trainer (0 = one per hardware thread)",
+                     1);
+
+    parser.AddOption(numSweepThreads,
+                     "numSweepThreads",
+                     "nst",
+                     "The number of trainers in the sweep to run concurrently (0 = one per hardware thread)",
+                     0);
+
+    parser.AddOption(keepFraction,
+                     "keepFraction",
+                     "kf",
+                     "The fraction of the sweep's trainers to keep after each epoch (0.5 = successive halving, 1 = keep all)",
+                     1.0);
+}
+} // namespace ell
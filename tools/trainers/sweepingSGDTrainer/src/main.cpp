@@ -6,6 +6,8 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "SweepingSGDTrainerArguments.h"
+
 #include <utilities/include/CommandLineParser.h>
 #include <utilities/include/Exception.h>
 #include <utilities/include/Files.h>
@@ -49,11 +51,13 @@ int main(int argc, char* argv[])
         utilities::CommandLineParser commandLineParser(argc, argv);
 
         // add arguments to the command line parser
+        ParsedSweepingSGDTrainerArguments sweepingSGDTrainerArguments;
         common::ParsedTrainerArguments trainerArguments;
         common::ParsedDataLoadArguments dataLoadArguments;
         common::ParsedMapLoadArguments mapLoadArguments;
         common::ParsedModelSaveArguments modelSaveArguments;
 
+        commandLineParser.AddOptionSet(sweepingSGDTrainerArguments);
         commandLineParser.AddOptionSet(trainerArguments);
         commandLineParser.AddOptionSet(dataLoadArguments);
         commandLineParser.AddOptionSet(mapLoadArguments);
@@ -81,9 +85,16 @@ int main(int argc, char* argv[])
 
         // load dataset
         if (trainerArguments.verbose) std::cout << "Loading data ..." << std::endl;
-        auto stream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
-        auto parsedDataset = common::GetDataset(stream);
-        auto mappedDataset = common::TransformDataset(parsedDataset, map);
+        common::FileDataset inputDataset(dataLoadArguments.inputDataFilename, dataLoadArguments.numParsingThreads);
+
+        // without a map file the map is the identity, so if it covers every feature the trainer reads the loaded examples in place
+        data::AutoSupervisedDataset mappedDataset;
+        auto trainingDataset = inputDataset.GetAnyDataset();
+        if (mapLoadArguments.HasInputFilename() || inputDataset.NumFeatures() > map.GetInputSize())
+        {
+            mappedDataset = common::TransformDataset(trainingDataset, map);
+            trainingDataset = mappedDataset.GetAnyDataset();
+        }
         auto mappedDatasetDimension = map.GetOutput(0).Size();
 
         // get predictor type
@@ -99,18 +110,29 @@ int main(int argc, char* argv[])
         std::vector<std::shared_ptr<evaluators::IEvaluator<PredictorType>>> evaluators;
         for (size_t i = 0; i < regularization.size(); ++i)
         {
-            auto SGDTrainer = common::MakeSGDTrainer(trainerArguments.lossFunctionArguments, generator.GenerateParameters(i));
-            evaluators.push_back(common::MakeEvaluator<PredictorType>(mappedDataset.GetAnyDataset(), evaluatorParameters, trainerArguments.lossFunctionArguments));
+            std::unique_ptr<trainers::ITrainer<PredictorType>> SGDTrainer;
+            if (sweepingSGDTrainerArguments.algorithm == SweepingSGDTrainerArguments::Algorithm::HogwildSGD)
+            {
+                SGDTrainer = common::MakeHogwildSGDTrainer(trainerArguments.lossFunctionArguments, { generator.GenerateParameters(i), sweepingSGDTrainerArguments.numThreads });
+            }
+            else
+            {
+                SGDTrainer = common::MakeSGDTrainer(trainerArguments.lossFunctionArguments, generator.GenerateParameters(i));
+            }
+            evaluators.push_back(common::MakeEvaluator<PredictorType>(trainingDataset, evaluatorParameters, trainerArguments.lossFunctionArguments));
             evaluatingTrainers.push_back(trainers::MakeEvaluatingTrainer(std::move(SGDTrainer), evaluators.back()));
         }
 
         // create meta trainer
-        auto trainer = trainers::MakeSweepingTrainer(std::move(evaluatingTrainers));
+        auto trainer = trainers::MakeSweepingTrainer(std::move(evaluatingTrainers), { sweepingSGDTrainerArguments.numSweepThreads, sweepingSGDTrainerArguments.keepFraction });
 
         // train
         if (trainerArguments.verbose) std::cout << "Training ..." << std::endl;
-        trainer->SetDataset(mappedDataset.GetAnyDataset());
-        trainer->Update();
+        trainer->SetDataset(trainingDataset);
+        for (size_t epoch = 0; epoch < trainerArguments.numEpochs; ++epoch)
+        {
+            trainer->Update();
+        }
         PredictorType predictor(trainer->GetPredictor());
         predictor.Resize(mappedDatasetDimension);
 
@@ -39,6 +39,7 @@ struct CompileArguments
 
     // model-generation options
     int maxRefinementIterations = 0;
+    int jobs = 1;
 };
 
 /// <summary> Parsed command line arguments for the compile executable. </summary>
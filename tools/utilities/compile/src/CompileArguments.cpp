@@ -100,6 +100,13 @@ void ParsedCompileArguments::AddArgs(utilities::CommandLineParser& parser)
         "The maximal number of refinement iterations (only valid if outputType is 'refinedMap')",
         10);
 
+    parser.AddOption(
+        jobs,
+        "jobs",
+        "j",
+        "The number of threads to optimize the compiled module on (0 means one per hardware thread)",
+        1);
+
     parser.AddOption(
         verbose,
         "verbose",
@@ -20,12 +20,14 @@
 #include <model/include/OutputNode.h>
 #include <model/include/SetCompilerOptionsTransformation.h>
 
+#include <passes/include/ConvolutionMethodAutotuner.h>
 #include <passes/include/StandardTransformations.h>
 
 #include <utilities/include/CommandLineParser.h>
 #include <utilities/include/Exception.h>
 #include <utilities/include/Logger.h>
 #include <utilities/include/MillisecondTimer.h>
+#include <utilities/include/ThreadPool.h>
 
 #include <iostream>
 #include <sstream>
@@ -113,6 +115,7 @@ void ProduceMapOutput(ParsedCompileArguments& compileArguments, common::ParsedMa
 
     model::MapCompilerOptions settings = mapCompilerArguments.GetMapCompilerOptions(baseFilename);
     settings.compilerSettings.modelFile = ell::utilities::GetFileName(inputFilename);
+    settings.compilerSettings.compileThreads = compileArguments.jobs > 0 ? compileArguments.jobs : static_cast<int>(utilities::GetDefaultNumThreads());
 
     // Add model/node-specific parameters to metadata
     if (mapCompilerArguments.HasOptionsMetadata())
@@ -122,6 +125,15 @@ void ProduceMapOutput(ParsedCompileArguments& compileArguments, common::ParsedMa
         map.Transform(setOptionsTranformation);
     }
 
+    // Time the convolution methods here rather than during compilation, so the choices are kept in the saved maps
+    if (mapCompilerArguments.convolutionMethod == model::PreferredConvolutionMethod::autotune)
+    {
+        TimingOutputCollector timer(timingOutput, "Time to autotune convolutions", compileArguments.verbose);
+        auto numTuned = passes::TuneConvolutionMethods(map, settings);
+        timer.Stop();
+        Log() << "Autotuned " << numTuned << " convolutional layers" << EOL;
+    }
+
     if (compileArguments.outputMapWithOptions)
     {
         common::SaveMap(map, baseFilename + "_options.ell");
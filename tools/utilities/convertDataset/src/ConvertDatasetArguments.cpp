@@ -0,0 +1,34 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConvertDatasetArguments.cpp (convertDataset)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ConvertDatasetArguments.h"
+
+#include <string>
+#include <vector>
+
+namespace ell
+{
+void ParsedConvertDatasetArguments::AddArgs(utilities::CommandLineParser& parser)
+{
+    parser.AddOption(
+        outputDataFilename,
+        "outputDataFilename",
+        "odf",
+        "Path to the output binary dataset file (.ellbd)",
+        "");
+}
+
+utilities::CommandLineParseResult ParsedConvertDatasetArguments::PostProcess(const utilities::CommandLineParser& parser)
+{
+    std::vector<std::string> errors;
+    if (outputDataFilename.empty())
+    {
+        errors.push_back("An output data filename is required");
+    }
+    return errors;
+}
+} // namespace ell
@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     main.cpp (convertDataset)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ConvertDatasetArguments.h"
+
+#include <utilities/include/CommandLineParser.h>
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+
+#include <data/include/BinaryDataset.h>
+
+#include <common/include/DataLoadArguments.h>
+#include <common/include/DataLoaders.h>
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace ell;
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        // create a command line parser
+        utilities::CommandLineParser commandLineParser(argc, argv);
+
+        // add arguments to the command line parser
+        common::ParsedDataLoadArguments dataLoadArguments;
+        ParsedConvertDatasetArguments convertDatasetArguments;
+
+        commandLineParser.AddOptionSet(dataLoadArguments);
+        commandLineParser.AddOptionSet(convertDatasetArguments);
+
+        // parse command line
+        commandLineParser.Parse();
+
+        if (dataLoadArguments.inputDataFilename.empty())
+        {
+            throw utilities::CommandLineParserPrintHelpException(commandLineParser.GetHelpString());
+        }
+
+        // convert the text dataset, one example at a time
+        auto inputStream = utilities::OpenIfstream(dataLoadArguments.GetDataFilePath());
+        auto exampleIterator = common::GetAutoSupervisedExampleIterator(inputStream);
+        auto outputStream = utilities::OpenBinaryOfstream(convertDatasetArguments.outputDataFilename);
+        data::WriteBinaryDataset(std::move(exampleIterator), outputStream);
+    }
+    catch (const utilities::CommandLineParserPrintHelpException& exception)
+    {
+        std::cout << exception.GetHelpText() << std::endl;
+        return 0;
+    }
+    catch (const utilities::CommandLineParserErrorException& exception)
+    {
+        std::cerr << "Command line parse error:" << std::endl;
+        for (const auto& error : exception.GetParseErrors())
+        {
+            std::cerr << error.GetMessage() << std::endl;
+        }
+        return 1;
+    }
+    catch (const utilities::Exception& exception)
+    {
+        std::cerr << "exception: " << exception.GetMessage() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
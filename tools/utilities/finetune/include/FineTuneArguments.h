@@ -118,8 +118,8 @@ struct FineTuneArguments
     ell::utilities::OutputStreamImpostor GetReportStream() const;
 
     FineTuneArguments() :
-        trainDataArguments(ell::common::OptionName{ "trainDataFilename" }, ell::common::OptionName{ "trainDataDirectory" }, ell::common::OptionName{ "trainDataDimension" }),
-        testDataArguments(ell::common::OptionName{ "testDataFilename" }, ell::common::OptionName{ "testDataDirectory" }, ell::common::OptionName{ "testDataDimension" })
+        trainDataArguments(ell::common::OptionName{ "trainDataFilename" }, ell::common::OptionName{ "trainDataDirectory" }, ell::common::OptionName{ "trainDataDimension" }, ell::common::OptionName{ "trainDataParsingThreads" }),
+        testDataArguments(ell::common::OptionName{ "testDataFilename" }, ell::common::OptionName{ "testDataDirectory" }, ell::common::OptionName{ "testDataDimension" }, ell::common::OptionName{ "testDataParsingThreads" })
     {}
 
 private:
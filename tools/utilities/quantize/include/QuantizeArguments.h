@@ -0,0 +1,39 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizeArguments.h (quantize)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <utilities/include/CommandLineParser.h>
+
+#include <cstddef>
+
+namespace ell
+{
+/// <summary> Command line arguments for the quantize executable. </summary>
+struct QuantizeArguments
+{
+    /// <summary> The maximum number of calibration examples to read from the dataset, or 0 to read all of them. </summary>
+    size_t maxExamples = 0;
+};
+
+/// <summary> Parsed command line arguments for the quantize executable. </summary>
+struct ParsedQuantizeArguments : public QuantizeArguments
+    , public utilities::ParsedArgSet
+{
+    /// <summary> Adds the arguments to the command line parser. </summary>
+    ///
+    /// <param name="parser"> [in,out] The parser. </param>
+    void AddArgs(utilities::CommandLineParser& parser) override;
+
+    /// <summary> Check the parsed arguments. </summary>
+    ///
+    /// <param name="parser"> The parser. </param>
+    ///
+    /// <returns> An utilities::CommandLineParseResult. </returns>
+    utilities::CommandLineParseResult PostProcess(const utilities::CommandLineParser& parser) override;
+};
+} // namespace ell
@@ -0,0 +1,27 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizeArguments.cpp (quantize)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizeArguments.h"
+
+namespace ell
+{
+void ParsedQuantizeArguments::AddArgs(utilities::CommandLineParser& parser)
+{
+    parser.AddOption(
+        maxExamples,
+        "maxExamples",
+        "me",
+        "Maximum number of calibration examples to read from the input data file (0 for all).",
+        0);
+}
+
+utilities::CommandLineParseResult ParsedQuantizeArguments::PostProcess(const utilities::CommandLineParser& parser)
+{
+    std::vector<std::string> errors;
+    return errors;
+}
+} // namespace ell
@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     main.cpp (quantize)
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizeArguments.h"
+
+#include <utilities/include/CommandLineParser.h>
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+#include <utilities/include/PropertyBag.h>
+
+#include <data/include/Dataset.h>
+#include <data/include/Example.h>
+
+#include <common/include/DataLoadArguments.h>
+#include <common/include/DataLoaders.h>
+#include <common/include/LoadModel.h>
+#include <common/include/MapLoadArguments.h>
+#include <common/include/MapSaveArguments.h>
+
+#include <model/include/Map.h>
+
+#include <passes/include/QuantizationCalibrator.h>
+#include <passes/include/QuantizeLayersTransformation.h>
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace ell;
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        // create a command line parser
+        utilities::CommandLineParser commandLineParser(argc, argv);
+
+        // add arguments to the command line parser
+        common::ParsedDataLoadArguments dataLoadArguments;
+        common::ParsedMapLoadArguments mapLoadArguments;
+        common::ParsedMapSaveArguments mapSaveArguments;
+        ParsedQuantizeArguments quantizeArguments;
+
+        commandLineParser.AddOptionSet(dataLoadArguments);
+        commandLineParser.AddOptionSet(mapLoadArguments);
+        commandLineParser.AddOptionSet(mapSaveArguments);
+        commandLineParser.AddOptionSet(quantizeArguments);
+
+        // parse command line
+        commandLineParser.Parse();
+
+        // load map
+        auto map = common::LoadMap(mapLoadArguments);
+
+        // get data iterator
+        auto stream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
+        auto exampleIterator = common::GetAutoSupervisedExampleIterator(stream);
+
+        // run the calibration examples through the map
+        passes::QuantizationCalibrator calibrator(map);
+        while (exampleIterator.IsValid() && (quantizeArguments.maxExamples == 0 || calibrator.NumExamples() < quantizeArguments.maxExamples))
+        {
+            calibrator.AddExample(exampleIterator.Get().GetDataVector());
+            exampleIterator.Next();
+        }
+        calibrator.WriteRangesToMetadata();
+
+        // the compiler leaves calibrated layers in floating point unless the model asks for them to be quantized
+        auto& modelMetadata = map.GetModel().GetMetadata();
+        auto compileOptions = modelMetadata.HasEntry("compileOptions") ? modelMetadata.GetEntry<utilities::PropertyBag>("compileOptions") : utilities::PropertyBag{};
+        compileOptions[passes::quantizeLayersOption] = true;
+        modelMetadata["compileOptions"] = compileOptions;
+
+        std::cerr << "Calibrated " << calibrator.NumLayers() << " layers on " << calibrator.NumExamples() << " examples" << std::endl;
+
+        // save the calibrated map, which is quantized when it is compiled
+        if (mapSaveArguments.hasOutputStream)
+        {
+            if (common::GetArchiveFormat(mapSaveArguments.outputMapFilename) == common::ArchiveFormat::binary)
+            {
+                // binary archives need a stream opened in binary mode
+                common::SaveMap(map, mapSaveArguments.outputMapFilename);
+            }
+            else
+            {
+                common::SaveMap(map, mapSaveArguments.outputMapStream);
+            }
+        }
+    }
+    catch (const utilities::CommandLineParserPrintHelpException& exception)
+    {
+        std::cout << exception.GetHelpText() << std::endl;
+        return 0;
+    }
+    catch (const utilities::CommandLineParserErrorException& exception)
+    {
+        std::cerr << "Command line parse error:" << std::endl;
+        for (const auto& error : exception.GetParseErrors())
+        {
+            std::cerr << error.GetMessage() << std::endl;
+        }
+        return 1;
+    }
+    catch (const utilities::Exception& exception)
+    {
+        std::cerr << "exception: " << exception.GetMessage() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}